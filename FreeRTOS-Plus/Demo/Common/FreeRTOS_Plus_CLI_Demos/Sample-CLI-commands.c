@@ -45,6 +45,13 @@
 /* FreeRTOS+CLI includes. */
 #include "FreeRTOS_CLI.h"
 
+#if ( configUSE_HEAP_PROFILER == 1 )
+    #include "heap_profiler.h"
+
+/* The number of call sites or tasks listed by the heap-profile command. */
+    #define cliHEAP_PROFILE_ENTRIES    16
+#endif
+
 #ifndef  configINCLUDE_TRACE_RELATED_CLI_COMMANDS
     #define configINCLUDE_TRACE_RELATED_CLI_COMMANDS    0
 #endif
@@ -97,6 +104,15 @@ static BaseType_t prvParameterEchoCommand( char * pcWriteBuffer,
                                            const char * pcCommandString );
 #endif
 
+/*
+ * Implements the "heap-profile" command.
+ */
+#if ( configUSE_HEAP_PROFILER == 1 )
+    static BaseType_t prvHeapProfileCommand( char * pcWriteBuffer,
+                                             size_t xWriteBufferLen,
+                                             const char * pcCommandString );
+#endif
+
 /*
  * Implements the "trace start" and "trace stop" commands;
  */
@@ -162,6 +178,19 @@ static const CLI_Command_Definition_t xParameterEcho =
     };
 #endif /* configQUERY_HEAP_COMMAND */
 
+#if ( configUSE_HEAP_PROFILER == 1 )
+
+/* Structure that defines the "heap-profile" command line command.  This takes
+ * a single parameter, which can be either "sites" or "tasks". */
+    static const CLI_Command_Definition_t xHeapProfile =
+    {
+        "heap-profile",
+        "\r\nheap-profile [sites | tasks]:\r\n Displays the heap bytes held by each call site of pvPortMalloc(), or by each task\r\n",
+        prvHeapProfileCommand, /* The function to run. */
+        1                      /* One parameter is expected.  Valid values are "sites" and "tasks". */
+    };
+#endif /* configUSE_HEAP_PROFILER */
+
 #if configINCLUDE_TRACE_RELATED_CLI_COMMANDS == 1
 
 /* Structure that defines the "trace" command line command.  This takes a single
@@ -196,6 +225,12 @@ void vRegisterSampleCLICommands( void )
     }
     #endif
 
+    #if ( configUSE_HEAP_PROFILER == 1 )
+    {
+        FreeRTOS_CLIRegisterCommand( &xHeapProfile );
+    }
+    #endif
+
     #if ( configINCLUDE_TRACE_RELATED_CLI_COMMANDS == 1 )
     {
         FreeRTOS_CLIRegisterCommand( &xStartStopTrace );
@@ -268,6 +303,108 @@ static BaseType_t prvTaskStatsCommand( char * pcWriteBuffer,
 #endif /* configINCLUDE_QUERY_HEAP */
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_HEAP_PROFILER == 1 )
+
+    static BaseType_t prvHeapProfileCommand( char * pcWriteBuffer,
+                                             size_t xWriteBufferLen,
+                                             const char * pcCommandString )
+    {
+        static HeapProfile_t xProfile[ cliHEAP_PROFILE_ENTRIES ];
+        static char cTaskNames[ cliHEAP_PROFILE_ENTRIES ][ configMAX_TASK_NAME_LEN ];
+        static UBaseType_t uxEntries = 0, uxNextEntry = 0;
+        static BaseType_t xByTask = pdFALSE, xHeaderWritten = pdFALSE;
+        TaskStatus_t * pxTaskStatusArray;
+        UBaseType_t uxTasks, x, y;
+        const char * pcParameter;
+        BaseType_t xParameterStringLength, xReturn = pdTRUE;
+
+        /* Check the write buffer is not NULL.  Every string written is
+         * truncated to xWriteBufferLen, so a short buffer cuts lines short
+         * rather than overflowing. */
+        configASSERT( pcWriteBuffer );
+
+        if( xHeaderWritten == pdFALSE )
+        {
+            /* The first time the function is called after the command has been
+             * entered the profile is taken and a header string is returned. */
+            pcParameter = FreeRTOS_CLIGetParameter( pcCommandString, 1, &xParameterStringLength );
+            xByTask = ( ( pcParameter != NULL ) && ( strncmp( pcParameter, "tasks", strlen( "tasks" ) ) == 0 ) ) ? pdTRUE : pdFALSE;
+
+            uxEntries = uxPortGetHeapProfile( xProfile, cliHEAP_PROFILE_ENTRIES, ( xByTask != pdFALSE ) ? eHeapProfileByTask : eHeapProfileByCallSite );
+            uxNextEntry = 0;
+
+            if( xByTask != pdFALSE )
+            {
+                /* A task that allocated a block may since have been deleted, so
+                 * names are only taken from tasks that still exist. */
+                uxTasks = uxTaskGetNumberOfTasks();
+                pxTaskStatusArray = pvPortMalloc( uxTasks * sizeof( TaskStatus_t ) );
+
+                if( pxTaskStatusArray != NULL )
+                {
+                    uxTasks = uxTaskGetSystemState( pxTaskStatusArray, uxTasks, NULL );
+                }
+                else
+                {
+                    uxTasks = 0;
+                }
+
+                for( x = 0; x < uxEntries; x++ )
+                {
+                    strncpy( cTaskNames[ x ], ( xProfile[ x ].xTask == NULL ) ? "(none)" : "(deleted)", configMAX_TASK_NAME_LEN - 1 );
+                    cTaskNames[ x ][ configMAX_TASK_NAME_LEN - 1 ] = 0x00;
+
+                    for( y = 0; y < uxTasks; y++ )
+                    {
+                        if( pxTaskStatusArray[ y ].xHandle == xProfile[ x ].xTask )
+                        {
+                            strncpy( cTaskNames[ x ], pxTaskStatusArray[ y ].pcTaskName, configMAX_TASK_NAME_LEN - 1 );
+                            cTaskNames[ x ][ configMAX_TASK_NAME_LEN - 1 ] = 0x00;
+                        }
+                    }
+                }
+
+                vPortFree( pxTaskStatusArray );
+                snprintf( pcWriteBuffer, xWriteBufferLen, "Task            Live bytes  Blocks  Oldest tick\r\n************************************************\r\n" );
+            }
+            else
+            {
+                snprintf( pcWriteBuffer, xWriteBufferLen, "Call site           Live bytes  Blocks  Oldest tick\r\n****************************************************\r\n" );
+            }
+
+            xHeaderWritten = pdTRUE;
+        }
+        else if( uxNextEntry < uxEntries )
+        {
+            /* Return the next call site or task. */
+            if( xByTask != pdFALSE )
+            {
+                snprintf( pcWriteBuffer, xWriteBufferLen, "%-15s %10u  %6u  %11u\r\n", cTaskNames[ uxNextEntry ], ( unsigned int ) xProfile[ uxNextEntry ].xLiveBytes, ( unsigned int ) xProfile[ uxNextEntry ].xLiveBlocks, ( unsigned int ) xProfile[ uxNextEntry ].xOldestTimeStamp );
+            }
+            else
+            {
+                snprintf( pcWriteBuffer, xWriteBufferLen, "%-18p %11u  %6u  %11u\r\n", xProfile[ uxNextEntry ].pvCallSite, ( unsigned int ) xProfile[ uxNextEntry ].xLiveBytes, ( unsigned int ) xProfile[ uxNextEntry ].xLiveBlocks, ( unsigned int ) xProfile[ uxNextEntry ].xOldestTimeStamp );
+            }
+
+            uxNextEntry++;
+        }
+        else
+        {
+            /* The blocks the profiler had no room to record come last. */
+            snprintf( pcWriteBuffer, xWriteBufferLen, "Untracked bytes %u\r\n", ( unsigned int ) xPortGetHeapProfileUntrackedBytes() );
+
+            /* No more data to return, so start over the next time this command
+             * is executed. */
+            xHeaderWritten = pdFALSE;
+            xReturn = pdFALSE;
+        }
+
+        return xReturn;
+    }
+
+#endif /* configUSE_HEAP_PROFILER */
+/*-----------------------------------------------------------*/
+
 #if ( configGENERATE_RUN_TIME_STATS == 1 )
 
     static BaseType_t prvRunTimeStatsCommand( char * pcWriteBuffer,
@@ -147,10 +147,6 @@ void main_blinky(void)
 
     pvParameter_t param[4];
     
-    param[0].uxWeight = 5;
-    param[1].uxWeight = 10;
-    param[2].uxWeight = 1;
-    param[3].uxWeight = 3;
     param[0].uxDeadLine = 700;
     param[1].uxDeadLine = 400;
     param[2].uxDeadLine = 2000;
@@ -162,6 +158,13 @@ void main_blinky(void)
         //xTaskCreate(T3, "task3", configMINIMAL_STACK_SIZE, &param[2], configMAX_PRIORITIES-3, &(xT[2]));
         xTaskCreate(T3_soft, "task3_soft", configMINIMAL_STACK_SIZE, &param[2], 1, &(xT[4]));
         xTaskCreate(T4, "task4", configMINIMAL_STACK_SIZE, &param[3], 2, &(xT[3]));
+
+        #if ( configUSE_WEIGHTED_ROUND_ROBIN == 1 )
+            vTaskSetWeight(xT[0], 5);
+            vTaskSetWeight(xT[1], 10);
+            vTaskSetWeight(xT[4], 1);
+            vTaskSetWeight(xT[3], 3);
+        #endif
     }
 
     vTaskStartScheduler();
@@ -260,10 +263,12 @@ static void T3_soft(void *pvParameters)
             printf("[iter:%d] task3_soft pass the soft deadline\n", iterNum);
             T_punish_runtime = endTime - startTime - T3_soft_deadline;
             pvParameter_t param_soft;
-            param_soft.uxWeight = ((pvParameter_t *)pvParameters)->uxWeight;
             param_soft.uxDeadLine = runtime;
             printf("[iter:%d] task3_soft create a punished task, name:T_punish, deadline:%d, runtime:%d\n", iterNum, param_soft.uxDeadLine, T_punish_runtime);
             xTaskCreate(T_punish, (signed char *)"T_punish", 512, (void *)&param_soft, 1, &xT[5]);
+            #if ( configUSE_WEIGHTED_ROUND_ROBIN == 1 )
+                vTaskSetWeight(xT[5], uxTaskGetWeight(NULL));
+            #endif
         }
         iterNum++;
         xTaskDelayUntil(&previousTime, period);
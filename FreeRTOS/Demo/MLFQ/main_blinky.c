@@ -121,10 +121,10 @@ void main_blinky(void)
     if (xQueue != NULL)
     {
         printf("Starting MLFQ Scheduler\n");
-        xTaskCreate(T1, (signed char *)"T1", 1000, NULL, 0, &xT1);
-        xTaskCreate(T2, (signed char *)"T2", 1000, NULL, 0, &xT2);
-        xTaskCreate(T3, (signed char *)"T3", 1000, NULL, 0, &xT3);
-        xTaskCreate(T4, (signed char *)"T4", 1000, NULL, 0, &xT4);
+        xTaskCreateMLFQ(T1, (signed char *)"T1", 1000, NULL, &xT1);
+        xTaskCreateMLFQ(T2, (signed char *)"T2", 1000, NULL, &xT2);
+        xTaskCreateMLFQ(T3, (signed char *)"T3", 1000, NULL, &xT3);
+        xTaskCreateMLFQ(T4, (signed char *)"T4", 1000, NULL, &xT4);
         /* Start the tasks running. */
         vTaskStartScheduler();
     }
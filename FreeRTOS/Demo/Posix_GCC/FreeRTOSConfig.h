@@ -100,8 +100,13 @@ void vConfigureTimerForRunTimeStats( void );    /* Prototype of function that in
 /* This demo can use of one or more example stats formatting functions.  These
  * format the raw data provided by the uxTaskGetSystemState() function in to human
  * readable ASCII form.  See the notes in the implementation of vTaskList() within
- * FreeRTOS/Source/tasks.c for limitations. */
-#define configUSE_STATS_FORMATTING_FUNCTIONS      0
+ * FreeRTOS/Source/tasks.c for limitations.  The heap profiler test builds the
+ * sample CLI commands, which use them. */
+#if defined( USER_DEMO ) && ( USER_DEMO == 30 )
+    #define configUSE_STATS_FORMATTING_FUNCTIONS    1
+#else
+    #define configUSE_STATS_FORMATTING_FUNCTIONS    0
+#endif
 
 /* Enables the test whereby a stack larger than the total heap size is
  * requested. */
@@ -128,6 +133,241 @@ void vConfigureTimerForRunTimeStats( void );    /* Prototype of function that in
 #define INCLUDE_xTimerPendFunctionCall            1
 #define INCLUDE_xTaskAbortDelay                   1
 
+/* The scheduler benchmarks select the scheduling policy they measure.  USER_DEMO
+ * is set on the command line, see main.c for the values. */
+#if defined( USER_DEMO ) && ( USER_DEMO == 2 )
+    #define configUSE_EDF_SCHEDULER     1
+    #define configKERNEL_DEBUG_PRINT    0
+#endif
+
+/* The EDF wrap test starts the tick count a few seconds before it wraps. */
+#if defined( USER_DEMO ) && ( USER_DEMO == 3 )
+    #define configUSE_EDF_SCHEDULER     1
+    #define configKERNEL_DEBUG_PRINT    0
+    #define configINITIAL_TICK_COUNT    ( portMAX_DELAY - ( TickType_t ) 2000 )
+#endif
+
+/* The MLFQ flood test uses short time slices and boost periods so that tasks
+ * move between levels many times during the test. */
+#if defined( USER_DEMO ) && ( USER_DEMO == 4 )
+    #define configUSE_MLFQ_SCHEDULER      1
+    #define configMLFQ_UNIT_TIME_SLICE    ( ( TickType_t ) 2 )
+    #define configMLFQ_LOOP_TIME_SLICE    ( ( TickType_t ) 200 )
+    #define configKERNEL_DEBUG_PRINT      0
+#endif
+
+/* The MLFQ boost benchmark times every call to xTaskIncrementTick(). */
+#if defined( USER_DEMO ) && ( USER_DEMO == 5 )
+    #define configUSE_MLFQ_SCHEDULER      1
+    #define configMLFQ_UNIT_TIME_SLICE    ( ( TickType_t ) 1 )
+    #define configMLFQ_LOOP_TIME_SLICE    ( ( TickType_t ) 500 )
+    #define configKERNEL_DEBUG_PRINT      0
+
+    extern void vBoostBenchmarkTickEnter( void );
+    extern void vBoostBenchmarkTickExit( void );
+    #define traceENTER_xTaskIncrementTick()                      vBoostBenchmarkTickEnter()
+    #define traceRETURN_xTaskIncrementTick( xSwitchRequired )    vBoostBenchmarkTickExit()
+#endif
+
+/* The MLFQ gaming test charges time slices from the run time counter.  The
+ * port's counter only has the resolution of times(), so the counter in
+ * run-time-stats-utils.c is used instead, converted to microseconds. */
+#if defined( USER_DEMO ) && ( USER_DEMO == 6 )
+    #define configUSE_MLFQ_SCHEDULER               1
+    #define configMLFQ_UNIT_TIME_SLICE             ( ( TickType_t ) 2 )
+    #define configMLFQ_LOOP_TIME_SLICE             ( ( TickType_t ) 500 )
+    #define configMLFQ_USE_RUN_TIME_ACCOUNTING     1
+    #define configMLFQ_RUN_TIME_COUNTS_PER_TICK    ( 1000000UL / configTICK_RATE_HZ )
+    #define configKERNEL_DEBUG_PRINT               0
+
+    extern unsigned long ulGetRunTimeCounterValue( void );
+    #define portALT_GET_RUN_TIME_COUNTER_VALUE( ulCountValue )    ( ulCountValue ) = ( uint32_t ) ( ulGetRunTimeCounterValue() / 1000UL )
+#endif
+
+/* The MLFQ policy test sets its own MLFQ policies at run time, so these only
+ * set the policy that is in use before the first call to vTaskSetMLFQPolicy(). */
+#if defined( USER_DEMO ) && ( USER_DEMO == 7 )
+    #define configUSE_MLFQ_SCHEDULER      1
+    #define configMLFQ_UNIT_TIME_SLICE    ( ( TickType_t ) 1 )
+    #define configMLFQ_LOOP_TIME_SLICE    ( ( TickType_t ) 500 )
+    #define configKERNEL_DEBUG_PRINT      0
+#endif
+
+/* The WRR fairness test runs each task for two ticks each time it is
+ * selected, and counts the ticks each task is running for. */
+#if defined( USER_DEMO ) && ( USER_DEMO == 8 )
+    #define configUSE_WEIGHTED_ROUND_ROBIN    1
+    #define configSLICE_INTERVAL              ( ( TickType_t ) 2 )
+    #define configKERNEL_DEBUG_PRINT          0
+
+    extern void vWRRFairnessTestTickHook( void );
+    #define traceTASK_INCREMENT_TICK( xTickCount )    vWRRFairnessTestTickHook()
+#endif
+
+/* The scheduling class test gives each class a band of priorities.  Priority
+ * 0, used by the idle task, and priorities 5 and 6 are scheduled by fixed
+ * priority. */
+#if defined( USER_DEMO ) && ( USER_DEMO == 9 )
+    #define configUSE_EDF_SCHEDULER           1
+    #define configEDF_LOWEST_PRIORITY         4
+    #define configEDF_HIGHEST_PRIORITY        4
+    #define configUSE_WEIGHTED_ROUND_ROBIN    1
+    #define configWRR_LOWEST_PRIORITY         1
+    #define configWRR_HIGHEST_PRIORITY        1
+    #define configSLICE_INTERVAL              ( ( TickType_t ) 2 )
+    #define configUSE_MLFQ_SCHEDULER          1
+    #define configMLFQ_LOWEST_PRIORITY        2
+    #define configMLFQ_HIGHEST_PRIORITY       3
+    #define configMLFQ_UNIT_TIME_SLICE        ( ( TickType_t ) 2 )
+    #define configMLFQ_LOOP_TIME_SLICE        ( ( TickType_t ) 10000 )
+    #define configKERNEL_DEBUG_PRINT          0
+
+    extern void vSchedClassTestTickHook( void );
+    #define traceTASK_INCREMENT_TICK( xTickCount )    vSchedClassTestTickHook()
+#endif
+
+/* The scheduler benchmarks time stamp every tick, and each selects the policy
+ * it measures.  The MLFQ levels are below the priority of the task that
+ * releases the sporadic tasks. */
+#if defined( USER_DEMO ) && ( USER_DEMO >= 10 ) && ( USER_DEMO <= 13 )
+    #define configKERNEL_DEBUG_PRINT    0
+
+    extern void vSchedBenchmarkTickHook( void );
+    #define traceTASK_INCREMENT_TICK( xTickCount )    vSchedBenchmarkTickHook()
+#endif
+
+#if defined( USER_DEMO ) && ( USER_DEMO == 11 )
+    #define configUSE_EDF_SCHEDULER    1
+#endif
+
+#if defined( USER_DEMO ) && ( USER_DEMO == 12 )
+    #define configUSE_MLFQ_SCHEDULER       1
+    #define configMLFQ_LOWEST_PRIORITY     2
+    #define configMLFQ_HIGHEST_PRIORITY    4
+    #define configMLFQ_UNIT_TIME_SLICE     ( ( TickType_t ) 2 )
+    #define configMLFQ_LOOP_TIME_SLICE     ( ( TickType_t ) 200 )
+#endif
+
+#if defined( USER_DEMO ) && ( USER_DEMO == 13 )
+    #define configUSE_WEIGHTED_ROUND_ROBIN    1
+    #define configSLICE_INTERVAL              ( ( TickType_t ) 2 )
+#endif
+
+/* The delay benchmarks time the blocking of each delayed task and every tick,
+ * and hold the delayed tasks in the sorted lists or in the timing wheel. */
+#if defined( USER_DEMO ) && ( USER_DEMO >= 14 ) && ( USER_DEMO <= 15 )
+    #define configKERNEL_DEBUG_PRINT    0
+
+    extern void vDelayBenchmarkBlockEnter( void );
+    extern void vDelayBenchmarkBlockExit( void );
+    extern void vDelayBenchmarkTickEnter( void );
+    extern void vDelayBenchmarkTickExit( void );
+    #define traceTASK_DELAY()                                    vDelayBenchmarkBlockEnter()
+    #define traceENTER_xTaskResumeAll()                          vDelayBenchmarkBlockExit()
+    #define traceENTER_xTaskIncrementTick()                      vDelayBenchmarkTickEnter()
+    #define traceRETURN_xTaskIncrementTick( xSwitchRequired )    vDelayBenchmarkTickExit()
+#endif
+
+#if defined( USER_DEMO ) && ( USER_DEMO == 15 )
+    #define configUSE_TIMER_WHEEL_DELAY    1
+#endif
+
+/* The timer benchmarks hold the active software timers in the sorted lists or
+ * in the timing wheel. */
+#if defined( USER_DEMO ) && ( USER_DEMO >= 16 ) && ( USER_DEMO <= 17 )
+    #define configKERNEL_DEBUG_PRINT    0
+#endif
+
+#if defined( USER_DEMO ) && ( USER_DEMO == 17 )
+    #define configUSE_TIMER_SERVICE_WHEEL    1
+#endif
+
+/* The queue benchmark compares queues with single producer single consumer
+ * queues. */
+#if defined( USER_DEMO ) && ( USER_DEMO == 18 )
+    #define configKERNEL_DEBUG_PRINT    0
+    #define configUSE_SPSC_QUEUES       1
+#endif
+
+/* The zero copy benchmark compares copying frames through a queue with
+ * passing them through a zero copy queue, with the buffer checks enabled. */
+#if defined( USER_DEMO ) && ( USER_DEMO == 19 )
+    #define configKERNEL_DEBUG_PRINT         0
+    #define configUSE_ZERO_COPY_QUEUES       1
+    #define configCHECK_ZERO_COPY_BUFFERS    1
+#endif
+
+/* The MPSC message buffer test has several tasks and the tick hook write to
+ * one message buffer at the same time. */
+#if defined( USER_DEMO ) && ( USER_DEMO == 20 )
+    #define configKERNEL_DEBUG_PRINT          0
+    #define configUSE_MPSC_MESSAGE_BUFFERS    1
+
+    extern void vMPSCMessageBufferClaimHook( void * pvMessageBuffer );
+    #define traceSTREAM_BUFFER_MPSC_CLAIM( xStreamBuffer )    vMPSCMessageBufferClaimHook( ( void * ) ( xStreamBuffer ) )
+#endif
+
+/* The stream buffer in place benchmark compares copying frames through a
+ * stream buffer with writing and reading them in place. */
+#if defined( USER_DEMO ) && ( USER_DEMO == 21 )
+    #define configKERNEL_DEBUG_PRINT    0
+#endif
+
+/* The event group benchmarks hold the tasks waiting for an event group in a
+ * single list or in lists indexed by bit. */
+#if defined( USER_DEMO ) && ( USER_DEMO >= 22 ) && ( USER_DEMO <= 23 )
+    #define configKERNEL_DEBUG_PRINT    0
+#endif
+
+#if defined( USER_DEMO ) && ( USER_DEMO == 23 )
+    #define configUSE_INDEXED_EVENT_GROUP_WAITERS    1
+#endif
+
+/* The heap benchmarks build heap_4.c or heap_6.c (see CMakeLists.txt), and
+ * count the allocations that fail rather than treating them as errors. */
+#if defined( USER_DEMO ) && ( USER_DEMO >= 24 ) && ( USER_DEMO <= 25 )
+    #define configKERNEL_DEBUG_PRINT        0
+    #define configUSE_MALLOC_FAILED_HOOK    0
+#endif
+
+/* The heap cache benchmarks build heap_4.c (see CMakeLists.txt) without or
+ * with per task heap caches. */
+#if defined( USER_DEMO ) && ( USER_DEMO >= 26 ) && ( USER_DEMO <= 27 )
+    #define configKERNEL_DEBUG_PRINT    0
+#endif
+
+#if defined( USER_DEMO ) && ( USER_DEMO == 27 )
+    #define configUSE_HEAP_CACHE    1
+#endif
+
+#if defined( USER_DEMO ) && ( USER_DEMO == 28 )
+    #define configKERNEL_DEBUG_PRINT    0
+    #define configUSE_MEMORY_POOLS      1
+#endif
+
+/* The heap regions test builds heap_5.c (see CMakeLists.txt) with a fast
+ * region 0 that holds task control blocks and stacks, and a slow region 1 that
+ * holds queues.  It fills regions on purpose, so does not use the malloc
+ * failed hook. */
+#if defined( USER_DEMO ) && ( USER_DEMO == 29 )
+    #define configKERNEL_DEBUG_PRINT          0
+    #define configUSE_MALLOC_FAILED_HOOK      0
+    #define configUSE_HEAP_REGIONS            1
+    #define configHEAP_REGIONS_FOR_TCBS       0x01U
+    #define configHEAP_REGIONS_FOR_STACKS     0x01U
+    #define configHEAP_REGIONS_FOR_QUEUES     0x02U
+#endif
+
+/* The heap profiler test builds heap_4.c (see CMakeLists.txt) with a profiler
+ * table small enough for the test to fill it, and FreeRTOS+CLI to run the
+ * heap-profile command. */
+#if defined( USER_DEMO ) && ( USER_DEMO == 30 )
+    #define configKERNEL_DEBUG_PRINT              0
+    #define configUSE_HEAP_PROFILER               1
+    #define configHEAP_PROFILER_TABLE_SIZE        64
+    #define configCOMMAND_INT_MAX_OUTPUT_SIZE     128
+#endif
+
 #define configINCLUDE_MESSAGE_BUFFER_AMP_DEMO     0
 #if ( configINCLUDE_MESSAGE_BUFFER_AMP_DEMO == 1 )
     extern void vGenerateCoreBInterrupt( void * xUpdatedMessageBuffer );
@@ -171,7 +411,9 @@ extern void vAssertCalled( const char * const pcFileName,
  * errors are present. */
     #define configASSERT( x )    if( ( x ) == 0 ) vAssertCalled( __FILE__, __LINE__ )
 
-    #define configUSE_MALLOC_FAILED_HOOK    1
+    #ifndef configUSE_MALLOC_FAILED_HOOK
+        #define configUSE_MALLOC_FAILED_HOOK    1
+    #endif
 
 /* Include the FreeRTOS+Trace FreeRTOS trace macro definitions. */
     #if( projENABLE_TRACING == 1 )
@@ -36,6 +36,118 @@
  * If mainSELECTED_APPLICATION = FULL_DEMO the more comprehensive test and demo
  * application built. This is implemented and described in main_full.c.
  *
+ * If mainSELECTED_APPLICATION = EDF_BENCHMARK_DEMO a benchmark of the EDF
+ * scheduler's ready list is built.  This is implemented and described in
+ * main_edf_benchmark.c.
+ *
+ * If mainSELECTED_APPLICATION = EDF_WRAP_TEST_DEMO a stress test of the EDF
+ * scheduler across a tick count wrap is built.  This is implemented and
+ * described in main_edf_wrap_test.c.
+ *
+ * If mainSELECTED_APPLICATION = MLFQ_FLOOD_TEST_DEMO a test of the MLFQ
+ * scheduler's level selection with every level populated is built.  This is
+ * implemented and described in main_mlfq_flood_test.c.
+ *
+ * If mainSELECTED_APPLICATION = MLFQ_BOOST_BENCHMARK_DEMO a benchmark of the
+ * tick interrupt duration while the MLFQ scheduler boosts many ready tasks is
+ * built.  This is implemented and described in main_mlfq_boost_benchmark.c.
+ *
+ * If mainSELECTED_APPLICATION = MLFQ_GAMING_TEST_DEMO a test that the MLFQ
+ * scheduler charges tasks for the processor time they use, even if they block
+ * before each tick, is built.  This is implemented and described in
+ * main_mlfq_gaming_test.c.
+ *
+ * If mainSELECTED_APPLICATION = MLFQ_POLICY_TEST_DEMO a test of the MLFQ level
+ * band, time slices and boost period set by vTaskSetMLFQPolicy() is built.
+ * This is implemented and described in main_mlfq_policy_test.c.
+ *
+ * If mainSELECTED_APPLICATION = WRR_FAIRNESS_TEST_DEMO a test that the weighted
+ * round robin scheduler shares the processor between tasks of the same
+ * priority in proportion to their weights is built.  This is implemented and
+ * described in main_wrr_fairness_test.c.
+ *
+ * If mainSELECTED_APPLICATION = SCHED_CLASS_TEST_DEMO a test that the EDF,
+ * weighted round robin, MLFQ and fixed priority scheduling classes each
+ * schedule the tasks of their own band of priorities is built.  This is
+ * implemented and described in main_sched_class_test.c.
+ *
+ * If mainSELECTED_APPLICATION = SCHED_BENCHMARK_STOCK_DEMO,
+ * SCHED_BENCHMARK_EDF_DEMO, SCHED_BENCHMARK_MLFQ_DEMO or
+ * SCHED_BENCHMARK_WRR_DEMO a benchmark of the context switch cost, wake
+ * latency, deadline miss ratio and throughput of the fixed priority, EDF, MLFQ
+ * or weighted round robin scheduler respectively is built.  This is
+ * implemented and described in main_sched_benchmark.c.
+ *
+ * If mainSELECTED_APPLICATION = DELAY_BENCHMARK_LIST_DEMO or
+ * DELAY_BENCHMARK_WHEEL_DEMO a benchmark of the cost of blocking and of the
+ * tick interrupt while a thousand tasks are delayed is built, with the delayed
+ * tasks held in the sorted delayed task lists or in the timing wheel
+ * respectively.  This is implemented and described in main_delay_benchmark.c.
+ *
+ * If mainSELECTED_APPLICATION = TIMER_BENCHMARK_LIST_DEMO or
+ * TIMER_BENCHMARK_WHEEL_DEMO a benchmark of the CPU time the timer service
+ * task uses while two thousand software timers are active is built, with the
+ * active timers held in the sorted active timer lists or in the timing wheel
+ * respectively.  This is implemented and described in main_timer_benchmark.c.
+ *
+ * If mainSELECTED_APPLICATION = QUEUE_BENCHMARK_DEMO a benchmark of the cost
+ * of sending to and receiving from a queue, and of the rate at which a
+ * producer task and a consumer task move items through a queue, is built, for
+ * a queue, for a single producer single consumer queue, and for a queue used
+ * with the batch send and receive functions.  This is implemented and
+ * described in main_queue_benchmark.c.
+ *
+ * If mainSELECTED_APPLICATION = ZERO_COPY_BENCHMARK_DEMO a benchmark of the
+ * rate at which a producer task and a consumer task move frames of several
+ * sizes through a queue that copies them and through a zero copy queue is
+ * built.  This is implemented and described in main_zero_copy_benchmark.c.
+ *
+ * If mainSELECTED_APPLICATION = MPSC_MESSAGE_BUFFER_TEST_DEMO a test of a
+ * multi-producer, single-consumer message buffer that several tasks and the
+ * tick hook write to at the same time is built, along with a comparison of its
+ * throughput with that of a message buffer whose writers share a mutex.  This
+ * is implemented and described in main_mpsc_message_buffer.c.
+ *
+ * If mainSELECTED_APPLICATION = STREAM_BUFFER_IN_PLACE_BENCHMARK_DEMO a
+ * benchmark of the rate at which a producer task and a consumer task move
+ * frames of several sizes through a stream buffer, by copying them in and out
+ * and by writing and reading them in place, is built.  This is implemented and
+ * described in main_stream_buffer_in_place_benchmark.c.
+ *
+ * If mainSELECTED_APPLICATION = EVENT_GROUP_BENCHMARK_LIST_DEMO or
+ * EVENT_GROUP_BENCHMARK_INDEXED_DEMO a benchmark of the time taken to set event
+ * bits while hundreds of tasks wait for different bits of an event group is
+ * built, with the waiting tasks held in a single list or in lists indexed by
+ * bit respectively.  This is implemented and described in
+ * main_event_group_benchmark.c.
+ *
+ * If mainSELECTED_APPLICATION = HEAP_BENCHMARK_HEAP_4_DEMO or
+ * HEAP_BENCHMARK_HEAP_6_DEMO a benchmark of the time pvPortMalloc() and
+ * vPortFree() take, and of how fragmented the heap becomes, while thousands of
+ * small blocks are allocated and freed is built, using heap_4.c or heap_6.c
+ * respectively.  This is implemented and described in main_heap_benchmark.c.
+ *
+ * If mainSELECTED_APPLICATION = HEAP_CACHE_BENCHMARK_UNCACHED_DEMO or
+ * HEAP_CACHE_BENCHMARK_CACHED_DEMO a benchmark of the time pvPortMalloc() and
+ * vPortFree() take while several tasks allocate and free small blocks is
+ * built, using heap_4.c without or with per task heap caches respectively.
+ * This is implemented and described in main_heap_cache_benchmark.c.
+ *
+ * If mainSELECTED_APPLICATION = MEMORY_POOL_TEST_DEMO a test of fixed block
+ * memory pools, used from tasks and from the tick interrupt, and a comparison
+ * with a pool built from a queue of pointers, is built.  This is implemented
+ * and described in main_memory_pool.c.
+ *
+ * If mainSELECTED_APPLICATION = HEAP_REGIONS_TEST_DEMO a test of heap_5.c with
+ * a separate free list for each heap region, and with task control blocks,
+ * stacks and queues placed in chosen regions, is built.  This is implemented
+ * and described in main_heap_regions.c.
+ *
+ * If mainSELECTED_APPLICATION = HEAP_PROFILER_TEST_DEMO a test of the heap
+ * profiler, which attributes the live blocks of heap_4.c to the code and the
+ * tasks that allocated them, is built.  This is implemented and described in
+ * main_heap_profiler.c.
+ *
  * This file implements the code that is not demo specific, including the
  * hardware setup and FreeRTOS hook functions.
  *
@@ -72,8 +184,37 @@
     #include <trcRecorder.h>
 #endif
 
-#define    BLINKY_DEMO    0
-#define    FULL_DEMO      1
+#define    BLINKY_DEMO                              0
+#define    FULL_DEMO                                1
+#define    EDF_BENCHMARK_DEMO                       2
+#define    EDF_WRAP_TEST_DEMO                       3
+#define    MLFQ_FLOOD_TEST_DEMO                     4
+#define    MLFQ_BOOST_BENCHMARK_DEMO                5
+#define    MLFQ_GAMING_TEST_DEMO                    6
+#define    MLFQ_POLICY_TEST_DEMO                    7
+#define    WRR_FAIRNESS_TEST_DEMO                   8
+#define    SCHED_CLASS_TEST_DEMO                    9
+#define    SCHED_BENCHMARK_STOCK_DEMO               10
+#define    SCHED_BENCHMARK_EDF_DEMO                 11
+#define    SCHED_BENCHMARK_MLFQ_DEMO                12
+#define    SCHED_BENCHMARK_WRR_DEMO                 13
+#define    DELAY_BENCHMARK_LIST_DEMO                14
+#define    DELAY_BENCHMARK_WHEEL_DEMO               15
+#define    TIMER_BENCHMARK_LIST_DEMO                16
+#define    TIMER_BENCHMARK_WHEEL_DEMO               17
+#define    QUEUE_BENCHMARK_DEMO                     18
+#define    ZERO_COPY_BENCHMARK_DEMO                 19
+#define    MPSC_MESSAGE_BUFFER_TEST_DEMO            20
+#define    STREAM_BUFFER_IN_PLACE_BENCHMARK_DEMO    21
+#define    EVENT_GROUP_BENCHMARK_LIST_DEMO          22
+#define    EVENT_GROUP_BENCHMARK_INDEXED_DEMO       23
+#define    HEAP_BENCHMARK_HEAP_4_DEMO               24
+#define    HEAP_BENCHMARK_HEAP_6_DEMO               25
+#define    HEAP_CACHE_BENCHMARK_UNCACHED_DEMO       26
+#define    HEAP_CACHE_BENCHMARK_CACHED_DEMO         27
+#define    MEMORY_POOL_TEST_DEMO                    28
+#define    HEAP_REGIONS_TEST_DEMO                   29
+#define    HEAP_PROFILER_TEST_DEMO                  30
 
 #ifdef BUILD_DIR
     #define BUILD         BUILD_DIR
@@ -88,12 +229,35 @@
     #define    mainSELECTED_APPLICATION     FULL_DEMO
 #endif
 
-/* This demo uses heap_3.c (the libc provided malloc() and free()). */
+/* This demo uses heap_3.c (the libc provided malloc() and free()), except for
+ * the heap benchmarks, which use heap_4.c and heap_6.c, and the heap cache
+ * benchmarks, which use heap_4.c. */
 
 /*-----------------------------------------------------------*/
 
 extern void main_blinky( void );
 extern void main_full( void );
+extern void main_edf_benchmark( void );
+extern void main_edf_wrap_test( void );
+extern void main_mlfq_flood_test( void );
+extern void main_mlfq_boost_benchmark( void );
+extern void main_mlfq_gaming_test( void );
+extern void main_mlfq_policy_test( void );
+extern void main_wrr_fairness_test( void );
+extern void main_sched_class_test( void );
+extern void main_sched_benchmark( void );
+extern void main_delay_benchmark( void );
+extern void main_timer_benchmark( void );
+extern void main_queue_benchmark( void );
+extern void main_zero_copy_benchmark( void );
+extern void main_mpsc_message_buffer( void );
+extern void main_stream_buffer_in_place_benchmark( void );
+extern void main_event_group_benchmark( void );
+extern void main_heap_benchmark( void );
+extern void main_heap_cache_benchmark( void );
+extern void main_memory_pool( void );
+extern void main_heap_regions( void );
+extern void main_heap_profiler( void );
 static void traceOnEnter( void );
 
 /*
@@ -102,6 +266,8 @@ static void traceOnEnter( void );
  */
 void vFullDemoTickHookFunction( void );
 void vFullDemoIdleFunction( void );
+void vMPSCMessageBufferTickHookFunction( void );
+void vMemoryPoolTickHookFunction( void );
 
 /*
  * Prototypes for the standard FreeRTOS application hook (callback) functions
@@ -178,6 +344,111 @@ int main( void )
         console_print( "Starting full demo\n" );
         main_full();
     }
+    #elif ( mainSELECTED_APPLICATION == EDF_BENCHMARK_DEMO )
+    {
+        console_print( "Starting EDF scheduler benchmark\n" );
+        main_edf_benchmark();
+    }
+    #elif ( mainSELECTED_APPLICATION == EDF_WRAP_TEST_DEMO )
+    {
+        console_print( "Starting EDF tick wrap test\n" );
+        main_edf_wrap_test();
+    }
+    #elif ( mainSELECTED_APPLICATION == MLFQ_FLOOD_TEST_DEMO )
+    {
+        console_print( "Starting MLFQ level flood test\n" );
+        main_mlfq_flood_test();
+    }
+    #elif ( mainSELECTED_APPLICATION == MLFQ_BOOST_BENCHMARK_DEMO )
+    {
+        console_print( "Starting MLFQ boost benchmark\n" );
+        main_mlfq_boost_benchmark();
+    }
+    #elif ( mainSELECTED_APPLICATION == MLFQ_GAMING_TEST_DEMO )
+    {
+        console_print( "Starting MLFQ gaming test\n" );
+        main_mlfq_gaming_test();
+    }
+    #elif ( mainSELECTED_APPLICATION == MLFQ_POLICY_TEST_DEMO )
+    {
+        console_print( "Starting MLFQ policy test\n" );
+        main_mlfq_policy_test();
+    }
+    #elif ( mainSELECTED_APPLICATION == WRR_FAIRNESS_TEST_DEMO )
+    {
+        console_print( "Starting WRR fairness test\n" );
+        main_wrr_fairness_test();
+    }
+    #elif ( mainSELECTED_APPLICATION == SCHED_CLASS_TEST_DEMO )
+    {
+        console_print( "Starting scheduling class test\n" );
+        main_sched_class_test();
+    }
+    #elif ( ( mainSELECTED_APPLICATION >= SCHED_BENCHMARK_STOCK_DEMO ) && ( mainSELECTED_APPLICATION <= SCHED_BENCHMARK_WRR_DEMO ) )
+    {
+        console_print( "Starting scheduler benchmark\n" );
+        main_sched_benchmark();
+    }
+    #elif ( ( mainSELECTED_APPLICATION == DELAY_BENCHMARK_LIST_DEMO ) || ( mainSELECTED_APPLICATION == DELAY_BENCHMARK_WHEEL_DEMO ) )
+    {
+        console_print( "Starting delay benchmark\n" );
+        main_delay_benchmark();
+    }
+    #elif ( ( mainSELECTED_APPLICATION == TIMER_BENCHMARK_LIST_DEMO ) || ( mainSELECTED_APPLICATION == TIMER_BENCHMARK_WHEEL_DEMO ) )
+    {
+        console_print( "Starting timer benchmark\n" );
+        main_timer_benchmark();
+    }
+    #elif ( mainSELECTED_APPLICATION == QUEUE_BENCHMARK_DEMO )
+    {
+        console_print( "Starting queue benchmark\n" );
+        main_queue_benchmark();
+    }
+    #elif ( mainSELECTED_APPLICATION == ZERO_COPY_BENCHMARK_DEMO )
+    {
+        console_print( "Starting zero copy benchmark\n" );
+        main_zero_copy_benchmark();
+    }
+    #elif ( mainSELECTED_APPLICATION == MPSC_MESSAGE_BUFFER_TEST_DEMO )
+    {
+        console_print( "Starting MPSC message buffer test\n" );
+        main_mpsc_message_buffer();
+    }
+    #elif ( mainSELECTED_APPLICATION == STREAM_BUFFER_IN_PLACE_BENCHMARK_DEMO )
+    {
+        console_print( "Starting stream buffer in place benchmark\n" );
+        main_stream_buffer_in_place_benchmark();
+    }
+    #elif ( ( mainSELECTED_APPLICATION == EVENT_GROUP_BENCHMARK_LIST_DEMO ) || ( mainSELECTED_APPLICATION == EVENT_GROUP_BENCHMARK_INDEXED_DEMO ) )
+    {
+        console_print( "Starting event group benchmark\n" );
+        main_event_group_benchmark();
+    }
+    #elif ( ( mainSELECTED_APPLICATION == HEAP_BENCHMARK_HEAP_4_DEMO ) || ( mainSELECTED_APPLICATION == HEAP_BENCHMARK_HEAP_6_DEMO ) )
+    {
+        console_print( "Starting heap benchmark\n" );
+        main_heap_benchmark();
+    }
+    #elif ( ( mainSELECTED_APPLICATION == HEAP_CACHE_BENCHMARK_UNCACHED_DEMO ) || ( mainSELECTED_APPLICATION == HEAP_CACHE_BENCHMARK_CACHED_DEMO ) )
+    {
+        console_print( "Starting heap cache benchmark\n" );
+        main_heap_cache_benchmark();
+    }
+    #elif ( mainSELECTED_APPLICATION == MEMORY_POOL_TEST_DEMO )
+    {
+        console_print( "Starting memory pool test\n" );
+        main_memory_pool();
+    }
+    #elif ( mainSELECTED_APPLICATION == HEAP_REGIONS_TEST_DEMO )
+    {
+        console_print( "Starting heap regions test\n" );
+        main_heap_regions();
+    }
+    #elif ( mainSELECTED_APPLICATION == HEAP_PROFILER_TEST_DEMO )
+    {
+        console_print( "Starting heap profiler test\n" );
+        main_heap_profiler();
+    }
     #else
     {
         #error "The selected demo is not valid"
@@ -263,6 +534,14 @@ void vApplicationTickHook( void )
     {
         vFullDemoTickHookFunction();
     }
+    #elif ( mainSELECTED_APPLICATION == MPSC_MESSAGE_BUFFER_TEST_DEMO )
+    {
+        vMPSCMessageBufferTickHookFunction();
+    }
+    #elif ( mainSELECTED_APPLICATION == MEMORY_POOL_TEST_DEMO )
+    {
+        vMemoryPoolTickHookFunction();
+    }
     #endif /* mainSELECTED_APPLICATION */
 }
 
@@ -0,0 +1,302 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/******************************************************************************
+ * NOTE 1: The FreeRTOS demo threads will not be running continuously, so
+ * do not expect to get real time behaviour from the FreeRTOS Linux port, or
+ * this demo application.  The absolute numbers reported by this benchmark
+ * include the cost of the Linux port itself, and the largest values can be
+ * inflated by the host, so only compare them with numbers taken on the same
+ * machine.
+ *
+ * NOTE 2: The way delayed tasks are held is selected when the kernel is built.
+ * USER_DEMO is set to DELAY_BENCHMARK_LIST_DEMO or DELAY_BENCHMARK_WHEEL_DEMO,
+ * which build this file with configUSE_TIMER_WHEEL_DELAY set to 0 or 1
+ * respectively, and which time the kernel through its trace macros (see
+ * FreeRTOSConfig.h).
+ ******************************************************************************
+ *
+ * main_delay_benchmark() measures the cost of blocking a task and of the tick
+ * interrupt while many tasks are delayed, so the sorted delayed task lists can
+ * be compared with the timing wheel.
+ *
+ * delayNUM_TASKS delayer tasks each call vTaskDelay() in a loop, each time for
+ * a random number of ticks between 1 and delayMAX_DELAY_TICKS, so almost all of
+ * them are blocked at any time.  After a warm up period the time taken to add
+ * the calling task to the delayed tasks (from the traceTASK_DELAY() macro to
+ * the following traceENTER_xTaskResumeAll() macro) and the duration of every
+ * call to xTaskIncrementTick() are recorded for delayMEASURED_TICKS ticks.
+ *
+ * Each delayer also checks it was not unblocked before the tick it asked to be
+ * unblocked at.  When the measurement ends the delayers are asked to stop, and
+ * each must wake and stop within delayMAX_DELAY_TICKS ticks, so a task that is
+ * never unblocked is also detected.  The number of delays, the mean and
+ * largest block and tick durations in microseconds, and the number of errors
+ * are then printed and the application exits.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Local includes. */
+#include "console.h"
+
+/* The number of delayer tasks, and the longest delay each requests. */
+#define delayNUM_TASKS            ( 1000U )
+#define delayMAX_DELAY_TICKS      ( 2000U )
+
+/* The ticks allowed for the delayers to spread their wake times before the
+ * measurement starts, and the number of ticks measured. */
+#define delayWARM_UP_TICKS        ( delayMAX_DELAY_TICKS )
+#define delayMEASURED_TICKS       ( 10000U )
+
+/* The priority of the delayers.  The controller runs above them. */
+#define delayDELAYER_PRIORITY     ( tskIDLE_PRIORITY + 1U )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The tasks as described in the comments at the top of this file.
+ */
+static void prvControllerTask( void * pvParameters );
+static void prvDelayerTask( void * pvParameters );
+
+/*
+ * Returns a monotonic time stamp in nanoseconds.
+ */
+static uint64_t prvGetTimeNs( void );
+
+/*
+ * Called by the trace macros defined in FreeRTOSConfig.h.
+ */
+void vDelayBenchmarkBlockEnter( void );
+void vDelayBenchmarkBlockExit( void );
+void vDelayBenchmarkTickEnter( void );
+void vDelayBenchmarkTickExit( void );
+
+/*-----------------------------------------------------------*/
+
+/* Set while durations are being recorded, and when the delayers should stop. */
+static volatile BaseType_t xRecording = pdFALSE;
+static volatile BaseType_t xStopDelayers = pdFALSE;
+
+/* The number of delayers that have not yet stopped. */
+static volatile UBaseType_t uxDelayersRunning = 0U;
+
+/* The results.  The block durations are written with the scheduler suspended
+ * and the tick durations from the tick interrupt. */
+static uint64_t ullBlockStartNs = 0ULL;
+static BaseType_t xBlockStarted = pdFALSE;
+static uint64_t ullBlockTotalNs = 0ULL;
+static uint64_t ullBlockLargestNs = 0ULL;
+static uint32_t ulBlocksMeasured = 0UL;
+static uint64_t ullTickStartNs = 0ULL;
+static uint64_t ullTickTotalNs = 0ULL;
+static uint64_t ullTickLargestNs = 0ULL;
+static uint32_t ulTicksMeasured = 0UL;
+static volatile uint32_t ulEarlyWakes = 0UL;
+
+/*-----------------------------------------------------------*/
+
+/*** SEE THE COMMENTS AT THE TOP OF THIS FILE ***/
+void main_delay_benchmark( void )
+{
+    UBaseType_t ux;
+
+    for( ux = 0U; ux < delayNUM_TASKS; ux++ )
+    {
+        /* The parameter seeds the random delays of each task. */
+        xTaskCreate( prvDelayerTask, "Delay", configMINIMAL_STACK_SIZE, ( void * ) ( ux + 1U ), delayDELAYER_PRIORITY, NULL );
+    }
+
+    uxDelayersRunning = delayNUM_TASKS;
+
+    xTaskCreate( prvControllerTask, "Control", configMINIMAL_STACK_SIZE * 2U, NULL, configMAX_PRIORITIES - 1U, NULL );
+
+    vTaskStartScheduler();
+}
+/*-----------------------------------------------------------*/
+
+static void prvControllerTask( void * pvParameters )
+{
+    TickType_t xWaited = 0U;
+
+    ( void ) pvParameters;
+
+    vTaskDelay( delayWARM_UP_TICKS );
+    xRecording = pdTRUE;
+    vTaskDelay( delayMEASURED_TICKS );
+    xRecording = pdFALSE;
+
+    /* Every delayer must wake within its longest delay to see the request to
+     * stop, allowing for the time the host takes to run them all. */
+    xStopDelayers = pdTRUE;
+
+    while( ( uxDelayersRunning != 0U ) && ( xWaited < ( delayMAX_DELAY_TICKS * 2U ) ) )
+    {
+        vTaskDelay( 10U );
+        xWaited += 10U;
+    }
+
+    console_print( "Delay benchmark: %u tasks, delays of 1 to %u ticks, %s\n",
+                   ( unsigned ) delayNUM_TASKS,
+                   ( unsigned ) delayMAX_DELAY_TICKS,
+                   ( configUSE_TIMER_WHEEL_DELAY == 1 ) ? "timing wheel" : "delayed task lists" );
+    console_print( "delays, block mean (us), block max (us), ticks, tick mean (us), tick max (us), early wakes, never woken\n" );
+    console_print( "%lu, %.3f, %.2f, %lu, %.3f, %.2f, %lu, %lu\n",
+                   ( unsigned long ) ulBlocksMeasured,
+                   ( ulBlocksMeasured != 0UL ) ? ( ( double ) ullBlockTotalNs / ( double ) ulBlocksMeasured ) / 1000.0 : 0.0,
+                   ( double ) ullBlockLargestNs / 1000.0,
+                   ( unsigned long ) ulTicksMeasured,
+                   ( ulTicksMeasured != 0UL ) ? ( ( double ) ullTickTotalNs / ( double ) ulTicksMeasured ) / 1000.0 : 0.0,
+                   ( double ) ullTickLargestNs / 1000.0,
+                   ( unsigned long ) ulEarlyWakes,
+                   ( unsigned long ) uxDelayersRunning );
+
+    /* Exit the process directly rather than ending the scheduler, so the
+     * threads of the delayer tasks do not have to be torn down one by one. */
+    if( ( ulEarlyWakes != 0UL ) || ( uxDelayersRunning != 0U ) )
+    {
+        exit( EXIT_FAILURE );
+    }
+
+    exit( EXIT_SUCCESS );
+}
+/*-----------------------------------------------------------*/
+
+static void prvDelayerTask( void * pvParameters )
+{
+    uint32_t ulRandom = ( uint32_t ) ( uintptr_t ) pvParameters;
+    TickType_t xDelay, xWakeTime;
+
+    for( ; ; )
+    {
+        /* A linear congruential generator is enough to spread the delays. */
+        ulRandom = ( ulRandom * 1664525UL ) + 1013904223UL;
+        xDelay = ( TickType_t ) ( ( ulRandom >> 8 ) % delayMAX_DELAY_TICKS ) + 1U;
+
+        /* The delay is relative to the tick count when vTaskDelay() is called,
+         * which can only be later than the tick count read here. */
+        xWakeTime = xTaskGetTickCount() + xDelay;
+        vTaskDelay( xDelay );
+
+        if( xTaskGetTickCount() < xWakeTime )
+        {
+            taskENTER_CRITICAL();
+            {
+                ulEarlyWakes++;
+            }
+            taskEXIT_CRITICAL();
+        }
+
+        if( xStopDelayers != pdFALSE )
+        {
+            taskENTER_CRITICAL();
+            {
+                uxDelayersRunning--;
+            }
+            taskEXIT_CRITICAL();
+
+            /* Suspend rather than delete, as the Linux port can hang when the
+             * thread of a deleted task is cancelled. */
+            vTaskSuspend( NULL );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vDelayBenchmarkBlockEnter( void )
+{
+    ullBlockStartNs = prvGetTimeNs();
+    xBlockStarted = pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+void vDelayBenchmarkBlockExit( void )
+{
+    uint64_t ullDurationNs;
+
+    /* xTaskResumeAll() is also called where no task was delayed, so only the
+     * call that follows traceTASK_DELAY() ends a measurement. */
+    if( xBlockStarted != pdFALSE )
+    {
+        xBlockStarted = pdFALSE;
+
+        if( xRecording != pdFALSE )
+        {
+            ullDurationNs = prvGetTimeNs() - ullBlockStartNs;
+            ullBlockTotalNs += ullDurationNs;
+            ulBlocksMeasured++;
+
+            if( ullDurationNs > ullBlockLargestNs )
+            {
+                ullBlockLargestNs = ullDurationNs;
+            }
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vDelayBenchmarkTickEnter( void )
+{
+    ullTickStartNs = prvGetTimeNs();
+}
+/*-----------------------------------------------------------*/
+
+void vDelayBenchmarkTickExit( void )
+{
+    uint64_t ullDurationNs;
+
+    if( xRecording != pdFALSE )
+    {
+        ullDurationNs = prvGetTimeNs() - ullTickStartNs;
+        ullTickTotalNs += ullDurationNs;
+        ulTicksMeasured++;
+
+        if( ullDurationNs > ullTickLargestNs )
+        {
+            ullTickLargestNs = ullDurationNs;
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvGetTimeNs( void )
+{
+    struct timespec xNow;
+
+    /* clock_gettime() is async-signal-safe, so can be called from the tick
+     * interrupt, which the Linux port implements as a signal handler. */
+    ( void ) clock_gettime( CLOCK_MONOTONIC, &xNow );
+
+    return ( ( uint64_t ) xNow.tv_sec * 1000000000ULL ) + ( uint64_t ) xNow.tv_nsec;
+}
+/*-----------------------------------------------------------*/
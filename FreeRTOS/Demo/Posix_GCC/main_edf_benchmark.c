@@ -0,0 +1,313 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/******************************************************************************
+ * NOTE 1: The FreeRTOS demo threads will not be running continuously, so
+ * do not expect to get real time behaviour from the FreeRTOS Linux port, or
+ * this demo application.  The absolute numbers reported by this benchmark
+ * include the cost of the Linux port itself, so only compare them with numbers
+ * taken on the same machine.
+ *
+ * NOTE 2: This file is only built into a working application when USER_DEMO is
+ * set to EDF_BENCHMARK_DEMO, which also builds the kernel with
+ * configUSE_EDF_SCHEDULER set to 1 (see FreeRTOSConfig.h).
+ ******************************************************************************
+ *
+ * main_edf_benchmark() measures how the cost of EDF scheduling grows with the
+ * number of ready tasks.  For each entry in uxReadyTaskCounts[] the controller
+ * task tops up the number of ready "load" tasks, then takes two measurements:
+ *
+ * Ready list insert + remove:
+ * With the scheduler suspended, a probe task is repeatedly resumed and
+ * suspended.  The probe has a later deadline than every load task, which is
+ * the worst case for a sorted list as every insertion walks the whole list.
+ * The time is reported in nanoseconds per resume/suspend pair.
+ *
+ * Context switch:
+ * Two ping-pong tasks that have earlier deadlines than the load tasks pass a
+ * task notification back and forth, so every hand over makes one task ready,
+ * blocks the other, and selects the task with the earliest deadline.  The
+ * time is reported in nanoseconds per switch, and includes the Linux port's
+ * own thread switching overhead.
+ *
+ * The load tasks are created at the same priority as the probe and ping-pong
+ * tasks, so they are held in the same ready list, but their deadlines are so
+ * far in the future that they never run.
+ *
+ * The results are printed as a table and the application then exits.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Local includes. */
+#include "console.h"
+
+#if ( configUSE_EDF_SCHEDULER == 1 )
+
+/* Priorities at which the tasks are created.  The controller must have a
+ * higher priority than the tasks being measured. */
+    #define benchCONTROLLER_PRIORITY       ( tskIDLE_PRIORITY + 3 )
+    #define benchMEASURED_PRIORITY         ( tskIDLE_PRIORITY + 1 )
+
+/* Relative deadlines of the measured tasks.  The load task deadlines are far
+ * enough in the future that they never become the earliest, while still being
+ * within half the tick range so the deadline comparisons remain valid. */
+    #define benchPING_PONG_DEADLINE        ( ( TickType_t ) 10 )
+    #define benchLOAD_DEADLINE_BASE        ( portMAX_DELAY >> 3 )
+    #define benchLOAD_DEADLINE_SPREAD      ( ( TickType_t ) 0xffffU )
+    #define benchPROBE_DEADLINE            ( benchLOAD_DEADLINE_BASE + benchLOAD_DEADLINE_SPREAD + 1U )
+
+/* The number of iterations timed for each measurement. */
+    #define benchLIST_ITERATIONS           ( 20000UL )
+    #define benchSWITCH_ITERATIONS         ( 2000UL )
+
+/* The largest number of load tasks that are created. */
+    #define benchMAX_LOAD_TASKS            ( 256U )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The tasks as described in the comments at the top of this file.
+ */
+    static void prvControllerTask( void * pvParameters );
+    static void prvLoadTask( void * pvParameters );
+    static void prvProbeTask( void * pvParameters );
+    static void prvPingTask( void * pvParameters );
+    static void prvPongTask( void * pvParameters );
+
+/*
+ * Returns a monotonic time stamp in nanoseconds.
+ */
+    static uint64_t prvGetTimeNs( void );
+
+/*
+ * Time benchLIST_ITERATIONS resume/suspend pairs of the probe task.
+ */
+    static uint64_t prvMeasureReadyListCost( void );
+
+/*
+ * Time benchSWITCH_ITERATIONS switches between the ping and pong tasks.
+ */
+    static uint64_t prvMeasureSwitchCost( void );
+
+/*-----------------------------------------------------------*/
+
+/* The ready task counts at which measurements are taken. */
+    static const UBaseType_t uxReadyTaskCounts[] = { 1U, 8U, 32U, 64U, 128U, 256U };
+
+/* Task parameters carry the relative deadline of each task. */
+    static pvParameter_t xLoadParameters[ benchMAX_LOAD_TASKS ];
+    static pvParameter_t xProbeParameters = { benchPROBE_DEADLINE };
+    static pvParameter_t xPingPongParameters = { benchPING_PONG_DEADLINE };
+
+    static TaskHandle_t xControllerTask = NULL;
+    static TaskHandle_t xProbeTask = NULL;
+    static TaskHandle_t xPingTask = NULL;
+    static TaskHandle_t xPongTask = NULL;
+
+/* The number of switches still to be performed by the ping-pong tasks. */
+    static volatile uint32_t ulSwitchesRemaining = 0UL;
+
+/*-----------------------------------------------------------*/
+
+/*** SEE THE COMMENTS AT THE TOP OF THIS FILE ***/
+    void main_edf_benchmark( void )
+    {
+        xTaskCreate( prvControllerTask, "Control", configMINIMAL_STACK_SIZE * 2U, NULL, benchCONTROLLER_PRIORITY, &xControllerTask );
+
+        vTaskStartScheduler();
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvControllerTask( void * pvParameters )
+    {
+        UBaseType_t uxLoadTasks = 0U, uxRow;
+        uint64_t ullListNs, ullSwitchNs;
+        uint32_t ulSeed = 0x12345678UL;
+
+        ( void ) pvParameters;
+
+        /* The measured tasks are created first so they are ready before any
+         * load is added.  The probe suspends itself as soon as it runs, which
+         * cannot happen until the controller blocks, so suspend it here too. */
+        xTaskCreate( prvProbeTask, "Probe", configMINIMAL_STACK_SIZE, &xProbeParameters, benchMEASURED_PRIORITY, &xProbeTask );
+        vTaskSuspend( xProbeTask );
+        xTaskCreate( prvPingTask, "Ping", configMINIMAL_STACK_SIZE, &xPingPongParameters, benchMEASURED_PRIORITY, &xPingTask );
+        xTaskCreate( prvPongTask, "Pong", configMINIMAL_STACK_SIZE, &xPingPongParameters, benchMEASURED_PRIORITY, &xPongTask );
+
+        console_print( "EDF benchmark: ready tasks, list insert+remove (ns), context switch (ns)\n" );
+
+        for( uxRow = 0U; uxRow < ( sizeof( uxReadyTaskCounts ) / sizeof( uxReadyTaskCounts[ 0 ] ) ); uxRow++ )
+        {
+            while( uxLoadTasks < uxReadyTaskCounts[ uxRow ] )
+            {
+                /* A simple LCG spreads the load deadlines so the ready list is
+                 * not built in deadline order. */
+                ulSeed = ( ulSeed * 1103515245UL ) + 12345UL;
+                xLoadParameters[ uxLoadTasks ].uxDeadLine = benchLOAD_DEADLINE_BASE + ( ( TickType_t ) ( ulSeed >> 8 ) & benchLOAD_DEADLINE_SPREAD );
+
+                if( xTaskCreate( prvLoadTask, "Load", configMINIMAL_STACK_SIZE, &( xLoadParameters[ uxLoadTasks ] ), benchMEASURED_PRIORITY, NULL ) != pdPASS )
+                {
+                    console_print( "EDF benchmark: could not create load task %u\n", ( unsigned ) uxLoadTasks );
+                    break;
+                }
+
+                uxLoadTasks++;
+            }
+
+            ullListNs = prvMeasureReadyListCost();
+            ullSwitchNs = prvMeasureSwitchCost();
+
+            console_print( "%u, %llu, %llu\n",
+                           ( unsigned ) uxLoadTasks,
+                           ( unsigned long long ) ( ullListNs / benchLIST_ITERATIONS ),
+                           ( unsigned long long ) ( ullSwitchNs / benchSWITCH_ITERATIONS ) );
+        }
+
+        console_print( "EDF benchmark complete\n" );
+
+        /* Exit the process directly rather than ending the scheduler, so the
+         * threads of the load tasks do not have to be torn down one by one. */
+        exit( EXIT_SUCCESS );
+    }
+/*-----------------------------------------------------------*/
+
+    static uint64_t prvMeasureReadyListCost( void )
+    {
+        uint64_t ullStart, ullEnd;
+        uint32_t ul;
+
+        /* Suspending the scheduler keeps the measurement to the ready list
+         * manipulation performed by the kernel. */
+        vTaskSuspendAll();
+        {
+            ullStart = prvGetTimeNs();
+
+            for( ul = 0; ul < benchLIST_ITERATIONS; ul++ )
+            {
+                vTaskResume( xProbeTask );
+                vTaskSuspend( xProbeTask );
+            }
+
+            ullEnd = prvGetTimeNs();
+        }
+        ( void ) xTaskResumeAll();
+
+        return ullEnd - ullStart;
+    }
+/*-----------------------------------------------------------*/
+
+    static uint64_t prvMeasureSwitchCost( void )
+    {
+        uint64_t ullStart;
+
+        ulSwitchesRemaining = benchSWITCH_ITERATIONS;
+        ullStart = prvGetTimeNs();
+
+        /* Start the exchange then wait for the pong task to report that the
+         * requested number of switches have been performed. */
+        xTaskNotifyGive( xPingTask );
+        ( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+        return prvGetTimeNs() - ullStart;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvLoadTask( void * pvParameters )
+    {
+        ( void ) pvParameters;
+
+        /* Should never run as its deadline is never the earliest. */
+        for( ; ; )
+        {
+            taskYIELD();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvProbeTask( void * pvParameters )
+    {
+        ( void ) pvParameters;
+
+        for( ; ; )
+        {
+            vTaskSuspend( NULL );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvPingTask( void * pvParameters )
+    {
+        ( void ) pvParameters;
+
+        for( ; ; )
+        {
+            ( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+            xTaskNotifyGive( xPongTask );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvPongTask( void * pvParameters )
+    {
+        ( void ) pvParameters;
+
+        for( ; ; )
+        {
+            ( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+            /* Each round trip is two switches. */
+            if( ulSwitchesRemaining > 2UL )
+            {
+                ulSwitchesRemaining -= 2UL;
+                xTaskNotifyGive( xPingTask );
+            }
+            else
+            {
+                ulSwitchesRemaining = 0UL;
+                xTaskNotifyGive( xControllerTask );
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static uint64_t prvGetTimeNs( void )
+    {
+        struct timespec xTimeSpec;
+
+        clock_gettime( CLOCK_MONOTONIC, &xTimeSpec );
+
+        return ( ( uint64_t ) xTimeSpec.tv_sec * 1000000000ULL ) + ( uint64_t ) xTimeSpec.tv_nsec;
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_EDF_SCHEDULER == 1 */
@@ -0,0 +1,456 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/******************************************************************************
+ * NOTE 1: This file is only built into a working application when USER_DEMO is
+ * set to EDF_WRAP_TEST_DEMO, which builds the kernel with
+ * configUSE_EDF_SCHEDULER set to 1 and with configINITIAL_TICK_COUNT set just
+ * below the point at which the tick count wraps (see FreeRTOSConfig.h).
+ *
+ * NOTE 2: The FreeRTOS demo threads will not be running continuously, so the
+ * number of ticks that pass during each round of the test is not fixed.  The
+ * test only relies on each round completing in fewer ticks than the shortest
+ * difference between two deadlines.
+ ******************************************************************************
+ *
+ * main_edf_wrap_test() is a stress test for the EDF scheduler's deadline
+ * arithmetic while the tick count wraps.  The test is made of repeated rounds,
+ * which run until the tick count has wrapped and then for as many rounds
+ * again.  Each round performs two checks:
+ *
+ * Dispatch order:
+ * With the scheduler suspended, the controller task resumes a set of worker
+ * tasks that have different relative deadlines.  Near the wrap some of their
+ * absolute deadlines wrap to small values while others do not.  The workers
+ * record the order in which they run, which must be the order of their
+ * relative deadlines.
+ *
+ * Preemption:
+ * A task with a late deadline resumes a task with an early deadline.  The task
+ * with the early deadline must run before the resuming task continues.
+ *
+ * None of the tasks run for long enough to miss their deadlines, so once the
+ * rounds are complete no deadline misses must have been recorded.  A task that
+ * deliberately overruns its deadline is then run to check that its miss is
+ * counted, that its lateness is recorded, and that the miss is reported by
+ * uxTaskGetDeadlineMissEvents().  Last, a task is kept ready past its deadline
+ * by the controller, then runs for less than a tick, so the tick interrupt
+ * never finds it running late.  Its miss must still be counted when it blocks.
+ *
+ * The result is printed and the application exits with EXIT_SUCCESS if every
+ * round passed, or EXIT_FAILURE otherwise.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Local includes. */
+#include "console.h"
+
+#if ( configUSE_EDF_SCHEDULER == 1 )
+
+/* Priorities at which the tasks are created.  The controller must have a
+ * higher priority than the tasks being tested. */
+    #define wrapCONTROLLER_PRIORITY    ( tskIDLE_PRIORITY + 3 )
+    #define wrapTESTED_PRIORITY        ( tskIDLE_PRIORITY + 1 )
+
+/* The number of ticks the controller blocks for while the tested tasks run. */
+    #define wrapROUND_TICKS            ( ( TickType_t ) 2 )
+
+/* The number of worker tasks used by the dispatch order check. */
+    #define wrapNUM_WORKERS            ( 8U )
+
+/* Relative deadlines of the tasks used by the preemption check. */
+    #define wrapEARLY_DEADLINE         ( ( TickType_t ) 2 )
+    #define wrapLATE_DEADLINE          ( ( TickType_t ) 40 )
+
+/* Values recorded by the tasks used by the preemption check. */
+    #define wrapEARLY_RAN              ( 1U )
+    #define wrapLATE_CONTINUED         ( 2U )
+
+/* The relative deadline of the task that overruns its deadline, and the number
+ * of ticks it runs for. */
+    #define wrapOVERRUN_DEADLINE       ( ( TickType_t ) 2 )
+    #define wrapOVERRUN_TICKS          ( ( TickType_t ) 6 )
+
+/* The relative deadline of the task kept ready past its deadline, and the
+ * number of ticks the controller keeps it ready for. */
+    #define wrapSTARVED_DEADLINE       ( ( TickType_t ) 2 )
+    #define wrapSTARVED_TICKS          ( ( TickType_t ) 6 )
+
+/* The largest number of rounds run, so the test ends even if the tick count
+ * never wraps. */
+    #define wrapMAX_ROUNDS             ( 5000UL )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The tasks as described in the comments at the top of this file.
+ */
+    static void prvControllerTask( void * pvParameters );
+    static void prvWorkerTask( void * pvParameters );
+    static void prvEarlyTask( void * pvParameters );
+    static void prvLateTask( void * pvParameters );
+    static void prvOverrunTask( void * pvParameters );
+    static void prvStarvedTask( void * pvParameters );
+
+/*
+ * Run one round of each check, returning pdFAIL if either check failed.
+ */
+    static BaseType_t prvCheckDispatchOrder( void );
+    static BaseType_t prvCheckPreemption( void );
+
+/*
+ * Check the deadline miss statistics, returning pdFAIL if they are wrong.
+ */
+    static BaseType_t prvCheckDeadlineStats( void );
+
+/*-----------------------------------------------------------*/
+
+/* Relative deadlines of the workers, deliberately not in creation order.  The
+ * workers are listed in deadline order in uxExpectedOrder[]. */
+    static pvParameter_t xWorkerParameters[ wrapNUM_WORKERS ] =
+    {
+        { 17U }, { 5U }, { 29U }, { 11U },
+        { 8U }, { 23U }, { 14U }, { 20U }
+    };
+    static const UBaseType_t uxExpectedOrder[ wrapNUM_WORKERS ] = { 1U, 4U, 3U, 6U, 0U, 7U, 5U, 2U };
+
+    static pvParameter_t xEarlyParameters = { wrapEARLY_DEADLINE };
+    static pvParameter_t xLateParameters = { wrapLATE_DEADLINE };
+    static pvParameter_t xOverrunParameters = { wrapOVERRUN_DEADLINE };
+    static pvParameter_t xStarvedParameters = { wrapSTARVED_DEADLINE };
+
+    static TaskHandle_t xWorkerTasks[ wrapNUM_WORKERS ];
+    static TaskHandle_t xEarlyTask = NULL;
+    static TaskHandle_t xLateTask = NULL;
+
+/* The order in which the tested tasks ran during the current round. */
+    static volatile UBaseType_t uxRunOrder[ wrapNUM_WORKERS ];
+    static volatile UBaseType_t uxRunCount = 0U;
+
+/*-----------------------------------------------------------*/
+
+/*** SEE THE COMMENTS AT THE TOP OF THIS FILE ***/
+    void main_edf_wrap_test( void )
+    {
+        xTaskCreate( prvControllerTask, "Control", configMINIMAL_STACK_SIZE * 2U, NULL, wrapCONTROLLER_PRIORITY, NULL );
+
+        vTaskStartScheduler();
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvControllerTask( void * pvParameters )
+    {
+        UBaseType_t ux;
+        uint32_t ulRounds = 0UL, ulRoundsAfterWrap = 0UL, ulFailures = 0UL;
+        TickType_t xStartTick, xPreviousTick, xNow;
+        BaseType_t xWrapped = pdFALSE;
+
+        ( void ) pvParameters;
+
+        /* The tested tasks suspend themselves as soon as they run, which cannot
+         * happen until the controller blocks, so suspend them here too. */
+        for( ux = 0U; ux < wrapNUM_WORKERS; ux++ )
+        {
+            xTaskCreate( prvWorkerTask, "Worker", configMINIMAL_STACK_SIZE, &( xWorkerParameters[ ux ] ), wrapTESTED_PRIORITY, &( xWorkerTasks[ ux ] ) );
+            vTaskSuspend( xWorkerTasks[ ux ] );
+        }
+
+        xTaskCreate( prvEarlyTask, "Early", configMINIMAL_STACK_SIZE, &xEarlyParameters, wrapTESTED_PRIORITY, &xEarlyTask );
+        vTaskSuspend( xEarlyTask );
+        xTaskCreate( prvLateTask, "Late", configMINIMAL_STACK_SIZE, &xLateParameters, wrapTESTED_PRIORITY, &xLateTask );
+        vTaskSuspend( xLateTask );
+
+        xStartTick = xTaskGetTickCount();
+        xPreviousTick = xStartTick;
+
+        console_print( "EDF wrap test: starting at tick 0x%lx\n", ( unsigned long ) xStartTick );
+
+        while( ( ulRoundsAfterWrap <= ulRounds ) && ( ulRounds < wrapMAX_ROUNDS ) )
+        {
+            if( prvCheckDispatchOrder() != pdPASS )
+            {
+                console_print( "EDF wrap test: dispatch order wrong near tick 0x%lx\n", ( unsigned long ) xTaskGetTickCount() );
+                ulFailures++;
+            }
+
+            if( prvCheckPreemption() != pdPASS )
+            {
+                console_print( "EDF wrap test: missed preemption near tick 0x%lx\n", ( unsigned long ) xTaskGetTickCount() );
+                ulFailures++;
+            }
+
+            xNow = xTaskGetTickCount();
+
+            if( xNow < xPreviousTick )
+            {
+                xWrapped = pdTRUE;
+            }
+
+            xPreviousTick = xNow;
+
+            if( xWrapped == pdTRUE )
+            {
+                ulRoundsAfterWrap++;
+            }
+            else
+            {
+                ulRounds++;
+            }
+        }
+
+        if( prvCheckDeadlineStats() != pdPASS )
+        {
+            console_print( "EDF wrap test: deadline miss statistics wrong\n" );
+            ulFailures++;
+        }
+
+        if( xWrapped == pdFALSE )
+        {
+            console_print( "EDF wrap test: the tick count did not wrap, check configINITIAL_TICK_COUNT\n" );
+            ulFailures++;
+        }
+
+        console_print( "EDF wrap test: %s, %lu rounds, %lu failures, tick 0x%lx to 0x%lx\n",
+                       ( ulFailures == 0UL ) ? "PASS" : "FAIL",
+                       ( unsigned long ) ( ulRounds + ulRoundsAfterWrap ),
+                       ( unsigned long ) ulFailures,
+                       ( unsigned long ) xStartTick,
+                       ( unsigned long ) xTaskGetTickCount() );
+
+        /* Exit the process directly rather than ending the scheduler. */
+        exit( ( ulFailures == 0UL ) ? EXIT_SUCCESS : EXIT_FAILURE );
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvCheckDispatchOrder( void )
+    {
+        UBaseType_t ux;
+        BaseType_t xReturn = pdPASS;
+
+        uxRunCount = 0U;
+
+        /* Resume every worker before any of them can run, so the order in
+         * which they run is decided by their deadlines alone. */
+        vTaskSuspendAll();
+        {
+            for( ux = 0U; ux < wrapNUM_WORKERS; ux++ )
+            {
+                vTaskResume( xWorkerTasks[ ux ] );
+            }
+        }
+        ( void ) xTaskResumeAll();
+
+        vTaskDelay( wrapROUND_TICKS );
+
+        if( uxRunCount != wrapNUM_WORKERS )
+        {
+            xReturn = pdFAIL;
+        }
+        else
+        {
+            for( ux = 0U; ux < wrapNUM_WORKERS; ux++ )
+            {
+                if( uxRunOrder[ ux ] != uxExpectedOrder[ ux ] )
+                {
+                    xReturn = pdFAIL;
+                }
+            }
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvCheckPreemption( void )
+    {
+        BaseType_t xReturn = pdPASS;
+
+        uxRunCount = 0U;
+
+        /* The late task resumes the early task, which must run first. */
+        vTaskResume( xLateTask );
+        vTaskDelay( wrapROUND_TICKS );
+
+        if( ( uxRunCount != 2U ) ||
+            ( uxRunOrder[ 0 ] != wrapEARLY_RAN ) ||
+            ( uxRunOrder[ 1 ] != wrapLATE_CONTINUED ) )
+        {
+            xReturn = pdFAIL;
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvCheckDeadlineStats( void )
+    {
+        BaseType_t xReturn = pdPASS;
+        UBaseType_t ux, uxNextEvent = 0U;
+        TickType_t xMaxLateness;
+        TaskHandle_t xOverrunTask, xStarvedTask;
+        TickType_t xStart;
+        DeadlineMissEvent_t xEvents[ 4 ];
+
+        /* None of the tasks have overrun their deadlines so far, even though
+         * the tick count has wrapped while they ran. */
+        for( ux = 0U; ux < wrapNUM_WORKERS; ux++ )
+        {
+            if( uxTaskGetDeadlineStats( xWorkerTasks[ ux ], NULL ) != 0U )
+            {
+                xReturn = pdFAIL;
+            }
+        }
+
+        if( ( uxTaskGetDeadlineStats( xEarlyTask, NULL ) != 0U ) ||
+            ( uxTaskGetDeadlineStats( xLateTask, NULL ) != 0U ) ||
+            ( uxTaskGetDeadlineMissEvents( xEvents, 4U, &uxNextEvent ) != 0U ) )
+        {
+            xReturn = pdFAIL;
+        }
+
+        /* The overrun task misses its deadline by wrapOVERRUN_TICKS -
+         * wrapOVERRUN_DEADLINE ticks, then blocks until it is deleted. */
+        xTaskCreate( prvOverrunTask, "Overrun", configMINIMAL_STACK_SIZE, &xOverrunParameters, wrapTESTED_PRIORITY, &xOverrunTask );
+        vTaskDelay( wrapOVERRUN_TICKS * 2U );
+
+        if( ( uxTaskGetDeadlineStats( xOverrunTask, &xMaxLateness ) != 1U ) ||
+            ( xMaxLateness < ( wrapOVERRUN_TICKS - wrapOVERRUN_DEADLINE ) ) )
+        {
+            xReturn = pdFAIL;
+        }
+
+        if( ( uxTaskGetDeadlineMissEvents( xEvents, 4U, &uxNextEvent ) != 1U ) ||
+            ( xEvents[ 0 ].xHandle != xOverrunTask ) ||
+            ( uxNextEvent != 1U ) )
+        {
+            xReturn = pdFAIL;
+        }
+
+        vTaskDelete( xOverrunTask );
+
+        /* The starved task is made ready, then kept from running past its
+         * deadline by the controller, which has a higher priority.  Once the
+         * controller blocks it runs and suspends itself at once. */
+        xTaskCreate( prvStarvedTask, "Starved", configMINIMAL_STACK_SIZE, &xStarvedParameters, wrapTESTED_PRIORITY, &xStarvedTask );
+        xStart = xTaskGetTickCount();
+
+        while( ( TickType_t ) ( xTaskGetTickCount() - xStart ) < wrapSTARVED_TICKS )
+        {
+            /* Busy wait past the starved task's deadline. */
+        }
+
+        vTaskDelay( wrapROUND_TICKS );
+
+        if( ( uxTaskGetDeadlineStats( xStarvedTask, &xMaxLateness ) != 1U ) ||
+            ( xMaxLateness < ( wrapSTARVED_TICKS - wrapSTARVED_DEADLINE ) ) )
+        {
+            xReturn = pdFAIL;
+        }
+
+        if( ( uxTaskGetDeadlineMissEvents( xEvents, 4U, &uxNextEvent ) != 1U ) ||
+            ( xEvents[ 0 ].xHandle != xStarvedTask ) ||
+            ( uxNextEvent != 2U ) )
+        {
+            xReturn = pdFAIL;
+        }
+
+        vTaskDelete( xStarvedTask );
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvWorkerTask( void * pvParameters )
+    {
+        UBaseType_t uxIndex = ( UBaseType_t ) ( ( pvParameter_t * ) pvParameters - xWorkerParameters );
+
+        for( ; ; )
+        {
+            uxRunOrder[ uxRunCount ] = uxIndex;
+            uxRunCount++;
+            vTaskSuspend( NULL );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvEarlyTask( void * pvParameters )
+    {
+        ( void ) pvParameters;
+
+        for( ; ; )
+        {
+            uxRunOrder[ uxRunCount ] = wrapEARLY_RAN;
+            uxRunCount++;
+            vTaskSuspend( NULL );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvLateTask( void * pvParameters )
+    {
+        ( void ) pvParameters;
+
+        for( ; ; )
+        {
+            vTaskResume( xEarlyTask );
+
+            uxRunOrder[ uxRunCount ] = wrapLATE_CONTINUED;
+            uxRunCount++;
+            vTaskSuspend( NULL );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvOverrunTask( void * pvParameters )
+    {
+        const TickType_t xStart = xTaskGetTickCount();
+
+        ( void ) pvParameters;
+
+        while( ( TickType_t ) ( xTaskGetTickCount() - xStart ) < wrapOVERRUN_TICKS )
+        {
+            /* Busy wait past the deadline. */
+        }
+
+        vTaskSuspend( NULL );
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvStarvedTask( void * pvParameters )
+    {
+        ( void ) pvParameters;
+
+        vTaskSuspend( NULL );
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_EDF_SCHEDULER == 1 */
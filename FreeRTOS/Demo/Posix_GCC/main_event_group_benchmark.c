@@ -0,0 +1,380 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+
+/******************************************************************************
+ * NOTE 1: The FreeRTOS demo threads will not be running continuously, so
+ * do not expect to get real time behaviour from the FreeRTOS Linux port, or
+ * this demo application.  The absolute numbers reported by this benchmark
+ * include the cost of the Linux port itself, so only compare them with numbers
+ * taken on the same machine.
+ *
+ * NOTE 2: The way tasks waiting for an event group are held is selected when
+ * the kernel is built.  USER_DEMO is set to EVENT_GROUP_BENCHMARK_LIST_DEMO or
+ * EVENT_GROUP_BENCHMARK_INDEXED_DEMO, which build this file with
+ * configUSE_INDEXED_EVENT_GROUP_WAITERS set to 0 or 1 respectively (see
+ * FreeRTOSConfig.h).
+ ******************************************************************************
+ *
+ * main_event_group_benchmark() measures the time xEventGroupSetBits() takes
+ * while many tasks are waiting for different bits of one event group, so the
+ * single list of waiting tasks can be compared with the lists indexed by bit.
+ *
+ * ebNUM_WAITERS waiter tasks each wait for the event group in a loop.  Half
+ * wait for a single bit, three eighths wait for all of two bits, and one eighth
+ * wait for either of two bits.  In each of ebNUM_ROUNDS rounds the controller
+ * task first sets and clears ebUNUSED_BIT, which no waiter waits for, then sets
+ * two of the bits the waiters wait for, clears them again, and waits until
+ * every waiter that was unblocked is waiting again.  Both calls to
+ * xEventGroupSetBits() are timed.  Setting the unused bit unblocks no task, so
+ * its time is mostly that of checking the waiting tasks.
+ *
+ * Each waiter checks the bits it was unblocked with meet its condition and
+ * counts the times it is unblocked, which the controller checks against the
+ * number of rounds that met the condition.  Finally the event group is deleted
+ * while every waiter is waiting, which must unblock them all.  The mean and
+ * largest set times in microseconds, and the number of errors, are printed and
+ * the application exits.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "event_groups.h"
+
+/* Local includes. */
+#include "console.h"
+
+/* The number of waiter tasks, the number of event bits they wait for, and the
+ * number of rounds measured. */
+#define ebNUM_WAITERS            ( 512U )
+#define ebNUM_BITS               ( 22U )
+#define ebNUM_ROUNDS             ( 1000U )
+
+/* A bit no waiter waits for.  The event group has 24 bits when
+ * configTICK_TYPE_WIDTH_IN_BITS is TICK_TYPE_WIDTH_32_BITS, as it is here. */
+#define ebUNUSED_BIT             ( ( EventBits_t ) 1 << 23 )
+
+/* The ticks the controller waits for the unblocked waiters to wait again, and
+ * the most times it waits in one round before reporting an error. */
+#define ebSETTLE_TICKS           ( 2U )
+#define ebMAX_SETTLE_WAITS       ( 500U )
+
+/* The priority of the waiters.  The controller runs above them. */
+#define ebWAITER_PRIORITY        ( tskIDLE_PRIORITY + 1U )
+#define ebCONTROLLER_PRIORITY    ( tskIDLE_PRIORITY + 2U )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The tasks as described in the comments at the top of this file.
+ */
+static void prvControllerTask( void * pvParameters );
+static void prvWaiterTask( void * pvParameters );
+
+/*
+ * The condition waiter uxWaiter waits for.
+ */
+static EventBits_t prvBitsWaitedFor( UBaseType_t uxWaiter );
+static BaseType_t prvWaitsForAllBits( UBaseType_t uxWaiter );
+
+/*
+ * Returns pdTRUE if uxBits meet the condition waiter uxWaiter waits for.
+ */
+static BaseType_t prvConditionMet( UBaseType_t uxWaiter,
+                                   EventBits_t uxBits );
+
+/*
+ * Wait until every waiter that is not blocked or suspended is blocked or
+ * suspended again.
+ */
+static void prvWaitForWaiters( eTaskState eState );
+
+/*
+ * Returns a monotonic time stamp in nanoseconds.
+ */
+static uint64_t prvGetTimeNs( void );
+
+/*-----------------------------------------------------------*/
+
+/* The event group the waiters wait for. */
+static EventGroupHandle_t xEventGroup = NULL;
+
+/* The waiters, and the number of times each has been unblocked. */
+static TaskHandle_t xWaiters[ ebNUM_WAITERS ];
+static volatile uint32_t ulWakes[ ebNUM_WAITERS ];
+
+/* The number of errors found. */
+static volatile uint32_t ulErrors = 0UL;
+
+/*-----------------------------------------------------------*/
+
+/*** SEE THE COMMENTS AT THE TOP OF THIS FILE ***/
+void main_event_group_benchmark( void )
+{
+    UBaseType_t ux;
+
+    xEventGroup = xEventGroupCreate();
+    configASSERT( xEventGroup );
+
+    for( ux = 0U; ux < ebNUM_WAITERS; ux++ )
+    {
+        xTaskCreate( prvWaiterTask, "Waiter", configMINIMAL_STACK_SIZE, ( void * ) ux, ebWAITER_PRIORITY, &( xWaiters[ ux ] ) );
+    }
+
+    xTaskCreate( prvControllerTask, "Control", configMINIMAL_STACK_SIZE * 2U, NULL, ebCONTROLLER_PRIORITY, NULL );
+
+    vTaskStartScheduler();
+}
+/*-----------------------------------------------------------*/
+
+static void prvControllerTask( void * pvParameters )
+{
+    static uint32_t ulExpectedWakes[ ebNUM_WAITERS ];
+    EventBits_t uxBitsToSet;
+    UBaseType_t uxRound, uxWaiter;
+    uint64_t ullStartNs, ullDurationNs, ullTotalNs = 0ULL, ullLargestNs = 0ULL;
+    uint64_t ullUnusedTotalNs = 0ULL, ullUnusedLargestNs = 0ULL;
+
+    ( void ) pvParameters;
+
+    /* Let every waiter start waiting. */
+    prvWaitForWaiters( eBlocked );
+
+    for( uxRound = 0U; uxRound < ebNUM_ROUNDS; uxRound++ )
+    {
+        ullStartNs = prvGetTimeNs();
+        ( void ) xEventGroupSetBits( xEventGroup, ebUNUSED_BIT );
+        ullDurationNs = prvGetTimeNs() - ullStartNs;
+
+        ( void ) xEventGroupClearBits( xEventGroup, ebUNUSED_BIT );
+
+        ullUnusedTotalNs += ullDurationNs;
+
+        if( ullDurationNs > ullUnusedLargestNs )
+        {
+            ullUnusedLargestNs = ullDurationNs;
+        }
+
+        /* Two bits that change from round to round, so every kind of waiter
+         * is unblocked in some rounds. */
+        uxBitsToSet = ( ( EventBits_t ) 1 << ( uxRound % ebNUM_BITS ) ) |
+                      ( ( EventBits_t ) 1 << ( ( ( uxRound * 7U ) + 3U ) % ebNUM_BITS ) );
+
+        for( uxWaiter = 0U; uxWaiter < ebNUM_WAITERS; uxWaiter++ )
+        {
+            if( prvConditionMet( uxWaiter, uxBitsToSet ) != pdFALSE )
+            {
+                ulExpectedWakes[ uxWaiter ]++;
+            }
+        }
+
+        /* The waiters run below the controller, so none of them runs until
+         * the bits are cleared again. */
+        ullStartNs = prvGetTimeNs();
+        ( void ) xEventGroupSetBits( xEventGroup, uxBitsToSet );
+        ullDurationNs = prvGetTimeNs() - ullStartNs;
+
+        ( void ) xEventGroupClearBits( xEventGroup, uxBitsToSet );
+
+        ullTotalNs += ullDurationNs;
+
+        if( ullDurationNs > ullLargestNs )
+        {
+            ullLargestNs = ullDurationNs;
+        }
+
+        prvWaitForWaiters( eBlocked );
+    }
+
+    for( uxWaiter = 0U; uxWaiter < ebNUM_WAITERS; uxWaiter++ )
+    {
+        if( ulWakes[ uxWaiter ] != ulExpectedWakes[ uxWaiter ] )
+        {
+            ulErrors++;
+        }
+    }
+
+    /* Deleting the event group must unblock every waiter, wherever it is
+     * held.  The waiters then suspend themselves. */
+    vEventGroupDelete( xEventGroup );
+    prvWaitForWaiters( eSuspended );
+
+    console_print( "Event group benchmark: %u waiters, %u bits, %s\n",
+                   ( unsigned ) ebNUM_WAITERS,
+                   ( unsigned ) ebNUM_BITS,
+                   ( configUSE_INDEXED_EVENT_GROUP_WAITERS == 1 ) ? "waiters indexed by bit" : "single list of waiters" );
+    console_print( "rounds, unused bit set mean (us), unused bit set max (us), set mean (us), set max (us), errors\n" );
+    console_print( "%u, %.3f, %.2f, %.3f, %.2f, %lu\n",
+                   ( unsigned ) ebNUM_ROUNDS,
+                   ( ( double ) ullUnusedTotalNs / ( double ) ebNUM_ROUNDS ) / 1000.0,
+                   ( double ) ullUnusedLargestNs / 1000.0,
+                   ( ( double ) ullTotalNs / ( double ) ebNUM_ROUNDS ) / 1000.0,
+                   ( double ) ullLargestNs / 1000.0,
+                   ( unsigned long ) ulErrors );
+
+    /* Exit the process directly rather than ending the scheduler, so the
+     * threads of the waiters do not have to be torn down one by one. */
+    if( ulErrors != 0UL )
+    {
+        exit( EXIT_FAILURE );
+    }
+
+    exit( EXIT_SUCCESS );
+}
+/*-----------------------------------------------------------*/
+
+static void prvWaitForWaiters( eTaskState eState )
+{
+    UBaseType_t uxWaiter = 0U, uxWaits = 0U;
+
+    while( uxWaiter < ebNUM_WAITERS )
+    {
+        if( eTaskGetState( xWaiters[ uxWaiter ] ) == eState )
+        {
+            uxWaiter++;
+        }
+        else if( uxWaits < ebMAX_SETTLE_WAITS )
+        {
+            vTaskDelay( ebSETTLE_TICKS );
+            uxWaits++;
+        }
+        else
+        {
+            /* The waiter is stuck. */
+            ulErrors++;
+            uxWaiter++;
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static EventBits_t prvBitsWaitedFor( UBaseType_t uxWaiter )
+{
+    EventBits_t uxBits;
+
+    switch( uxWaiter % 8U )
+    {
+        case 0:
+        case 1:
+        case 2:
+        case 3:
+            /* A single bit. */
+            uxBits = ( EventBits_t ) 1 << ( uxWaiter % ebNUM_BITS );
+            break;
+
+        case 7:
+            /* Either of two bits. */
+            uxBits = ( ( EventBits_t ) 1 << ( uxWaiter % ebNUM_BITS ) ) |
+                     ( ( EventBits_t ) 1 << ( ( uxWaiter + 5U ) % ebNUM_BITS ) );
+            break;
+
+        default:
+            /* Both of a bit in each half of the bits. */
+            uxBits = ( ( EventBits_t ) 1 << ( uxWaiter % ( ebNUM_BITS / 2U ) ) ) |
+                     ( ( EventBits_t ) 1 << ( ( ebNUM_BITS / 2U ) + ( ( uxWaiter / ( ebNUM_BITS / 2U ) ) % ( ebNUM_BITS / 2U ) ) ) );
+            break;
+    }
+
+    return uxBits;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvWaitsForAllBits( UBaseType_t uxWaiter )
+{
+    BaseType_t xReturn = pdFALSE;
+
+    /* Only the waiters that wait for both of two bits wait for all their
+     * bits. */
+    if( ( ( uxWaiter % 8U ) >= 4U ) && ( ( uxWaiter % 8U ) != 7U ) )
+    {
+        xReturn = pdTRUE;
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvConditionMet( UBaseType_t uxWaiter,
+                                   EventBits_t uxBits )
+{
+    EventBits_t uxBitsWaitedFor = prvBitsWaitedFor( uxWaiter );
+    BaseType_t xReturn;
+
+    if( prvWaitsForAllBits( uxWaiter ) != pdFALSE )
+    {
+        xReturn = ( ( uxBits & uxBitsWaitedFor ) == uxBitsWaitedFor ) ? pdTRUE : pdFALSE;
+    }
+    else
+    {
+        xReturn = ( ( uxBits & uxBitsWaitedFor ) != 0U ) ? pdTRUE : pdFALSE;
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvWaiterTask( void * pvParameters )
+{
+    UBaseType_t uxWaiter = ( UBaseType_t ) pvParameters;
+    EventBits_t uxBitsWaitedFor = prvBitsWaitedFor( uxWaiter );
+    BaseType_t xWaitForAllBits = prvWaitsForAllBits( uxWaiter );
+    EventBits_t uxBits;
+
+    for( ; ; )
+    {
+        uxBits = xEventGroupWaitBits( xEventGroup, uxBitsWaitedFor, pdFALSE, xWaitForAllBits, portMAX_DELAY );
+
+        if( uxBits == 0U )
+        {
+            /* The event group was deleted. */
+            vTaskSuspend( NULL );
+        }
+        else if( prvConditionMet( uxWaiter, uxBits ) == pdFALSE )
+        {
+            ulErrors++;
+        }
+        else
+        {
+            ulWakes[ uxWaiter ]++;
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvGetTimeNs( void )
+{
+    struct timespec xNow;
+
+    ( void ) clock_gettime( CLOCK_MONOTONIC, &xNow );
+
+    return ( ( uint64_t ) xNow.tv_sec * 1000000000ULL ) + ( uint64_t ) xNow.tv_nsec;
+}
+/*-----------------------------------------------------------*/
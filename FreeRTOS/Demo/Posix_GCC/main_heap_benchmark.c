@@ -0,0 +1,494 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+
+
+/******************************************************************************
+ * NOTE 1: The FreeRTOS demo threads will not be running continuously, so
+ * do not expect to get real time behaviour from the FreeRTOS Linux port, or
+ * this demo application.  The absolute numbers reported by this benchmark
+ * include the cost of the Linux port itself, so only compare them with numbers
+ * taken on the same machine.
+ *
+ * NOTE 2: The heap implementation is selected when the demo is built.
+ * USER_DEMO is set to HEAP_BENCHMARK_HEAP_4_DEMO or HEAP_BENCHMARK_HEAP_6_DEMO,
+ * which build this file with heap_4.c or heap_6.c respectively (see
+ * CMakeLists.txt), and with configUSE_MALLOC_FAILED_HOOK set to 0 so failed
+ * allocations can be counted (see FreeRTOSConfig.h).
+ ******************************************************************************
+ *
+ * main_heap_benchmark() measures the time pvPortMalloc() and vPortFree() take
+ * while the configTOTAL_HEAP_SIZE byte heap is fragmented by thousands of small
+ * blocks, and how fragmented the heap becomes.
+ *
+ * The only task, the controller, is created statically, so the heap only holds
+ * the blocks the benchmark allocates.  It runs two phases, each of which keeps
+ * a number of slots that either hold a block or are empty.  In each step a slot
+ * is picked at random, and its block is freed if it holds one, or a block of a
+ * random size is allocated for it if it does not.  Every call is timed.
+ *
+ * In the random phase hbNUM_SLOTS slots are used.  Most blocks are small, some
+ * are a couple of hundred bytes and a few are several hundred, so the heap is
+ * nearly full and its free space is scattered between blocks that are still
+ * allocated.  hbWARM_UP_STEPS steps are run before hbRANDOM_STEPS measured
+ * steps.  Every hbSTATS_INTERVAL measured steps vPortGetHeapStats() is used to
+ * find the fragmentation, the share of the free bytes that are not in the
+ * largest free block, and the number of free blocks.  An allocation that fails
+ * is counted, as a heap that is too fragmented fails allocations for which
+ * there are enough free bytes.
+ *
+ * In the holes phase hbNUM_HOLES small blocks are allocated one after another
+ * and every other one is freed again, leaving hbNUM_HOLES / 2 free blocks too
+ * small for any of the blocks then allocated and freed in hbNUM_HOLE_SLOTS
+ * slots over hbHOLE_STEPS steps.  This is the case in which finding a free
+ * block, or the place for a freed block, in a single list of free blocks
+ * takes longest.
+ *
+ * Each block is filled with a pattern that is checked when it is freed, and
+ * once every block has been freed the free bytes and the largest free block
+ * must both be back to their values before the first step, showing every
+ * freed block was merged with its neighbours again.  The results and the number
+ * of errors are printed and the application exits.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Local includes. */
+#include "console.h"
+
+/* The heap statistics used are only provided by the heap implementations the
+ * heap benchmarks build, see NOTE 2 above. */
+#if defined( USER_DEMO ) && ( USER_DEMO >= 24 ) && ( USER_DEMO <= 25 )
+
+/* The number of slots used in the random phase, and the number of steps run
+ * before and while the calls are timed. */
+    #define hbNUM_SLOTS              ( 1536U )
+    #define hbWARM_UP_STEPS          ( 20000UL )
+    #define hbRANDOM_STEPS           ( 200000UL )
+
+/* The number of measured steps between samples of the heap statistics. */
+    #define hbSTATS_INTERVAL         ( 1000UL )
+
+/* The number and size of the small blocks allocated in the holes phase, and
+ * the number of slots and steps used after every other one is freed. */
+    #define hbNUM_HOLES              ( 1024U )
+    #define hbHOLE_SIZE              ( 16U )
+    #define hbNUM_HOLE_SLOTS         ( 64U )
+    #define hbHOLE_STEPS             ( 200000UL )
+
+/* The controller runs above the idle task. */
+    #define hbCONTROLLER_PRIORITY    ( tskIDLE_PRIORITY + 2U )
+
+/* The heap implementation being measured, see NOTE 2 above. */
+    #if ( USER_DEMO == 24 )
+        #define hbHEAP_NAME    "heap_4.c"
+    #else
+        #define hbHEAP_NAME    "heap_6.c"
+    #endif
+
+/*-----------------------------------------------------------*/
+
+/* The number of calls timed, their total and largest times, and the number of
+ * allocations that failed. */
+typedef struct CallTimes
+{
+    uint64_t ullCalls;
+    uint64_t ullTotalNs;
+    uint64_t ullLargestNs;
+    uint32_t ulFailures;
+} CallTimes_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The task as described in the comments at the top of this file.
+ */
+static void prvControllerTask( void * pvParameters );
+
+/*
+ * Frees the block held by a random one of the uxNumSlots slots from uxFirstSlot
+ * on, or allocates a block of pxSize() bytes for it if it does not hold one.
+ */
+static void prvStep( UBaseType_t uxFirstSlot,
+                     UBaseType_t uxNumSlots,
+                     size_t ( * pxSize )( void ),
+                     CallTimes_t * pxMallocTimes,
+                     CallTimes_t * pxFreeTimes );
+
+/*
+ * Allocate a block of xSize bytes for slot uxSlot and fill it with a pattern,
+ * or check the pattern of the block held by slot uxSlot and free it.  Only the
+ * call to the heap is timed, and only if pxTimes is not NULL.
+ */
+static void * prvAllocateSlot( UBaseType_t uxSlot,
+                               size_t xSize,
+                               CallTimes_t * pxTimes );
+static void prvFreeSlot( UBaseType_t uxSlot,
+                         CallTimes_t * pxTimes );
+
+/*
+ * Record a call that took ullDurationNs in *pxTimes.
+ */
+static void prvRecordCall( CallTimes_t * pxTimes,
+                           uint64_t ullDurationNs );
+
+/*
+ * Print a line of results for one phase.
+ */
+static void prvPrintPhase( const char * pcPhase,
+                           const CallTimes_t * pxMallocTimes,
+                           const CallTimes_t * pxFreeTimes );
+
+/*
+ * Return a random block size for the random and holes phases respectively.
+ */
+static size_t prvRandomSize( void );
+static size_t prvHoleSlotSize( void );
+
+/*
+ * A small pseudo random number generator, so every run and both heap
+ * implementations see the same sequence of steps.
+ */
+static uint32_t prvRandom( void );
+
+/*
+ * Returns a monotonic time stamp in nanoseconds.
+ */
+static uint64_t prvGetTimeNs( void );
+
+/*-----------------------------------------------------------*/
+
+/* The blocks held by the slots, and their sizes.  The holes phase uses the
+ * first hbNUM_HOLES slots for the small blocks and the hbNUM_HOLE_SLOTS after
+ * them for the blocks it times. */
+static uint8_t * pucBlocks[ hbNUM_SLOTS ];
+static size_t xBlockSizes[ hbNUM_SLOTS ];
+
+/* The state of prvRandom(). */
+static uint32_t ulRandomState = 0x12345678UL;
+
+/* The number of errors found. */
+static uint32_t ulErrors = 0UL;
+
+/* The controller is created statically, see the comments at the top of this
+ * file. */
+static StaticTask_t xControllerTCB;
+static StackType_t uxControllerStack[ configMINIMAL_STACK_SIZE * 2U ];
+
+/*-----------------------------------------------------------*/
+
+/*** SEE THE COMMENTS AT THE TOP OF THIS FILE ***/
+void main_heap_benchmark( void )
+{
+    xTaskCreateStatic( prvControllerTask, "Control", configMINIMAL_STACK_SIZE * 2U, NULL, hbCONTROLLER_PRIORITY, uxControllerStack, &xControllerTCB );
+
+    vTaskStartScheduler();
+}
+/*-----------------------------------------------------------*/
+
+static void prvControllerTask( void * pvParameters )
+{
+    static CallTimes_t xRandomMallocs, xRandomFrees, xHoleMallocs, xHoleFrees;
+    HeapStats_t xStats;
+    void * pvBlock;
+    size_t xInitialFreeBytes, xInitialLargestBlock;
+    uint32_t ulStep, ulSamples = 0UL;
+    uint64_t ullFragmentationTotal = 0ULL, ullFreeBlocksTotal = 0ULL;
+    uint32_t ulFragmentation, ulWorstFragmentation = 0UL;
+    UBaseType_t uxSlot;
+
+    ( void ) pvParameters;
+
+    /* The heap is set up by the first allocation. */
+    pvBlock = pvPortMalloc( 1U );
+    vPortFree( pvBlock );
+    vPortGetHeapStats( &xStats );
+    xInitialFreeBytes = xStats.xAvailableHeapSpaceInBytes;
+    xInitialLargestBlock = xStats.xSizeOfLargestFreeBlockInBytes;
+
+    /* The random phase. */
+    for( ulStep = 0UL; ulStep < hbWARM_UP_STEPS; ulStep++ )
+    {
+        prvStep( 0U, hbNUM_SLOTS, prvRandomSize, NULL, NULL );
+    }
+
+    for( ulStep = 0UL; ulStep < hbRANDOM_STEPS; ulStep++ )
+    {
+        prvStep( 0U, hbNUM_SLOTS, prvRandomSize, &xRandomMallocs, &xRandomFrees );
+
+        if( ( ulStep % hbSTATS_INTERVAL ) == 0UL )
+        {
+            vPortGetHeapStats( &xStats );
+
+            ulFragmentation = 0UL;
+
+            if( xStats.xAvailableHeapSpaceInBytes > 0U )
+            {
+                ulFragmentation = ( uint32_t ) ( 100U - ( ( xStats.xSizeOfLargestFreeBlockInBytes * 100U ) / xStats.xAvailableHeapSpaceInBytes ) );
+            }
+
+            ullFragmentationTotal += ulFragmentation;
+            ullFreeBlocksTotal += xStats.xNumberOfFreeBlocks;
+            ulSamples++;
+
+            if( ulFragmentation > ulWorstFragmentation )
+            {
+                ulWorstFragmentation = ulFragmentation;
+            }
+        }
+    }
+
+    for( uxSlot = 0U; uxSlot < hbNUM_SLOTS; uxSlot++ )
+    {
+        prvFreeSlot( uxSlot, NULL );
+    }
+
+    /* The holes phase. */
+    for( uxSlot = 0U; uxSlot < hbNUM_HOLES; uxSlot++ )
+    {
+        if( prvAllocateSlot( uxSlot, hbHOLE_SIZE, NULL ) == NULL )
+        {
+            ulErrors++;
+        }
+    }
+
+    for( uxSlot = 0U; uxSlot < hbNUM_HOLES; uxSlot += 2U )
+    {
+        prvFreeSlot( uxSlot, NULL );
+    }
+
+    for( ulStep = 0UL; ulStep < hbHOLE_STEPS; ulStep++ )
+    {
+        prvStep( hbNUM_HOLES, hbNUM_HOLE_SLOTS, prvHoleSlotSize, &xHoleMallocs, &xHoleFrees );
+    }
+
+    vPortGetHeapStats( &xStats );
+    console_print( "Heap benchmark: %s, %u byte heap\n", hbHEAP_NAME, ( unsigned ) configTOTAL_HEAP_SIZE );
+    console_print( "holes phase: %u free blocks\n", ( unsigned ) xStats.xNumberOfFreeBlocks );
+
+    for( uxSlot = 0U; uxSlot < hbNUM_SLOTS; uxSlot++ )
+    {
+        prvFreeSlot( uxSlot, NULL );
+    }
+
+    /* Every block has been freed, so the heap must be as it was before the
+     * first step. */
+    vPortGetHeapStats( &xStats );
+
+    if( ( xStats.xAvailableHeapSpaceInBytes != xInitialFreeBytes ) ||
+        ( xStats.xSizeOfLargestFreeBlockInBytes != xInitialLargestBlock ) )
+    {
+        ulErrors++;
+    }
+
+    console_print( "phase, mallocs, malloc mean (ns), malloc max (ns), frees, free mean (ns), free max (ns), failed mallocs\n" );
+    prvPrintPhase( "random", &xRandomMallocs, &xRandomFrees );
+    prvPrintPhase( "holes", &xHoleMallocs, &xHoleFrees );
+    console_print( "random phase fragmentation mean (%%), fragmentation max (%%), free blocks mean, errors\n" );
+    console_print( "%.1f, %lu, %.1f, %lu\n",
+                   ( double ) ullFragmentationTotal / ( double ) ulSamples,
+                   ( unsigned long ) ulWorstFragmentation,
+                   ( double ) ullFreeBlocksTotal / ( double ) ulSamples,
+                   ( unsigned long ) ulErrors );
+
+    if( ulErrors != 0UL )
+    {
+        exit( EXIT_FAILURE );
+    }
+
+    exit( EXIT_SUCCESS );
+}
+/*-----------------------------------------------------------*/
+
+static void prvStep( UBaseType_t uxFirstSlot,
+                     UBaseType_t uxNumSlots,
+                     size_t ( * pxSize )( void ),
+                     CallTimes_t * pxMallocTimes,
+                     CallTimes_t * pxFreeTimes )
+{
+    UBaseType_t uxSlot = uxFirstSlot + ( UBaseType_t ) ( prvRandom() % uxNumSlots );
+
+    if( pucBlocks[ uxSlot ] != NULL )
+    {
+        prvFreeSlot( uxSlot, pxFreeTimes );
+    }
+    else
+    {
+        ( void ) prvAllocateSlot( uxSlot, pxSize(), pxMallocTimes );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void * prvAllocateSlot( UBaseType_t uxSlot,
+                               size_t xSize,
+                               CallTimes_t * pxTimes )
+{
+    uint8_t * pucBlock;
+    uint64_t ullStartNs;
+
+    ullStartNs = prvGetTimeNs();
+    pucBlock = pvPortMalloc( xSize );
+
+    if( pxTimes != NULL )
+    {
+        prvRecordCall( pxTimes, prvGetTimeNs() - ullStartNs );
+
+        if( pucBlock == NULL )
+        {
+            pxTimes->ulFailures++;
+        }
+    }
+
+    if( pucBlock != NULL )
+    {
+        ( void ) memset( pucBlock, ( int ) ( uint8_t ) uxSlot, xSize );
+        pucBlocks[ uxSlot ] = pucBlock;
+        xBlockSizes[ uxSlot ] = xSize;
+    }
+
+    return pucBlock;
+}
+/*-----------------------------------------------------------*/
+
+static void prvFreeSlot( UBaseType_t uxSlot,
+                         CallTimes_t * pxTimes )
+{
+    uint8_t * pucBlock = pucBlocks[ uxSlot ];
+    uint64_t ullStartNs;
+    size_t x;
+
+    if( pucBlock != NULL )
+    {
+        /* The block must not have been written by anything else. */
+        for( x = 0U; x < xBlockSizes[ uxSlot ]; x++ )
+        {
+            if( pucBlock[ x ] != ( uint8_t ) uxSlot )
+            {
+                ulErrors++;
+                break;
+            }
+        }
+
+        ullStartNs = prvGetTimeNs();
+        vPortFree( pucBlock );
+
+        if( pxTimes != NULL )
+        {
+            prvRecordCall( pxTimes, prvGetTimeNs() - ullStartNs );
+        }
+
+        pucBlocks[ uxSlot ] = NULL;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvRecordCall( CallTimes_t * pxTimes,
+                           uint64_t ullDurationNs )
+{
+    pxTimes->ullCalls++;
+    pxTimes->ullTotalNs += ullDurationNs;
+
+    if( ullDurationNs > pxTimes->ullLargestNs )
+    {
+        pxTimes->ullLargestNs = ullDurationNs;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvPrintPhase( const char * pcPhase,
+                           const CallTimes_t * pxMallocTimes,
+                           const CallTimes_t * pxFreeTimes )
+{
+    console_print( "%s, %llu, %.1f, %llu, %llu, %.1f, %llu, %lu\n",
+                   pcPhase,
+                   ( unsigned long long ) pxMallocTimes->ullCalls,
+                   ( double ) pxMallocTimes->ullTotalNs / ( double ) pxMallocTimes->ullCalls,
+                   ( unsigned long long ) pxMallocTimes->ullLargestNs,
+                   ( unsigned long long ) pxFreeTimes->ullCalls,
+                   ( double ) pxFreeTimes->ullTotalNs / ( double ) pxFreeTimes->ullCalls,
+                   ( unsigned long long ) pxFreeTimes->ullLargestNs,
+                   ( unsigned long ) pxMallocTimes->ulFailures );
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvRandomSize( void )
+{
+    uint32_t ulKind = prvRandom() % 100UL;
+    size_t xSize;
+
+    if( ulKind < 75UL )
+    {
+        xSize = ( size_t ) ( 1UL + ( prvRandom() % 48UL ) );
+    }
+    else if( ulKind < 97UL )
+    {
+        xSize = ( size_t ) ( 49UL + ( prvRandom() % 144UL ) );
+    }
+    else
+    {
+        xSize = ( size_t ) ( 193UL + ( prvRandom() % 576UL ) );
+    }
+
+    return xSize;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvHoleSlotSize( void )
+{
+    /* Always larger than a hole. */
+    return ( size_t ) ( ( hbHOLE_SIZE * 4U ) + ( prvRandom() % 448UL ) );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvRandom( void )
+{
+    /* xorshift32. */
+    ulRandomState ^= ulRandomState << 13;
+    ulRandomState ^= ulRandomState >> 17;
+    ulRandomState ^= ulRandomState << 5;
+
+    return ulRandomState;
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvGetTimeNs( void )
+{
+    struct timespec xNow;
+
+    ( void ) clock_gettime( CLOCK_MONOTONIC, &xNow );
+
+    return ( ( uint64_t ) xNow.tv_sec * 1000000000ULL ) + ( uint64_t ) xNow.tv_nsec;
+}
+/*-----------------------------------------------------------*/
+
+#endif /* defined( USER_DEMO ) && ( USER_DEMO >= 24 ) && ( USER_DEMO <= 25 ) */
@@ -0,0 +1,484 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+
+
+/******************************************************************************
+ * NOTE 1: The FreeRTOS demo threads will not be running continuously, so
+ * do not expect to get real time behaviour from the FreeRTOS Linux port, or
+ * this demo application.  The absolute numbers reported by this benchmark
+ * include the cost of the Linux port itself, so only compare them with numbers
+ * taken on the same machine.
+ *
+ * NOTE 2: USER_DEMO is set to HEAP_CACHE_BENCHMARK_UNCACHED_DEMO or
+ * HEAP_CACHE_BENCHMARK_CACHED_DEMO, which both build this file with heap_4.c
+ * (see CMakeLists.txt), with configUSE_HEAP_CACHE set to 0 and 1 respectively
+ * (see FreeRTOSConfig.h).
+ ******************************************************************************
+ *
+ * main_heap_cache_benchmark() measures the time pvPortMalloc() and vPortFree()
+ * take when several tasks allocate and free small blocks at the same time,
+ * and how many blocks have to be taken from and returned to the heap itself.
+ *
+ * Every task is created statically, so the heap only holds the blocks the
+ * benchmark allocates.  The controller runs two phases, in each of which it
+ * creates several tasks of equal priority below its own, so the tasks share
+ * the processor through time slicing, then waits for all of them to finish.
+ *
+ * In the churn phase each of hcNUM_CHURN_TASKS tasks frees and then allocates
+ * hcCHURN_PAIRS blocks of a random size of up to hcMAX_BLOCK_SIZE bytes,
+ * keeping hcLIVE_BLOCKS blocks allocated at a time.  Each block is freed by the
+ * task that allocated it, which is the case heap caches are designed for.
+ *
+ * In the handoff phase each of hcNUM_HANDOFF_PAIRS producer tasks allocates
+ * hcHANDOFFS blocks and sends them through a queue to a consumer task that
+ * frees them, so blocks are allocated by one task and freed by another.
+ *
+ * Each block is filled with a pattern that is checked when it is freed.  The
+ * tasks delete themselves when they finish, which returns their heap caches
+ * to the heap, so once both phases are done the free bytes and the largest
+ * free block must both be back to their values from before the first phase.
+ * The results and the number of errors are printed and the application exits.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+/* Local includes. */
+#include "console.h"
+
+/* The heap statistics used are only provided by the heap implementation the
+ * heap cache benchmarks build, see NOTE 2 above. */
+#if defined( USER_DEMO ) && ( USER_DEMO >= 26 ) && ( USER_DEMO <= 27 )
+
+/* The churn phase. */
+    #define hcNUM_CHURN_TASKS        ( 4U )
+    #define hcCHURN_PAIRS            ( 250000UL )
+    #define hcLIVE_BLOCKS            ( 16U )
+
+/* The handoff phase.  hcHANDOFF_QUEUE_LENGTH blocks can be waiting in each
+ * queue. */
+    #define hcNUM_HANDOFF_PAIRS      ( 2U )
+    #define hcHANDOFFS               ( 100000UL )
+    #define hcHANDOFF_QUEUE_LENGTH   ( 32U )
+
+/* The largest block allocated, in bytes. */
+    #define hcMAX_BLOCK_SIZE         ( 96U )
+
+/* The controller runs above the tasks it measures. */
+    #define hcCONTROLLER_PRIORITY    ( tskIDLE_PRIORITY + 2U )
+    #define hcTASK_PRIORITY          ( tskIDLE_PRIORITY + 1U )
+
+/* The size of a block the controller allocates to set up the heap, which is
+ * too large to be cached so the controller never creates a heap cache of its
+ * own. */
+    #define hcSETUP_BLOCK_SIZE       ( 1024U )
+
+/*-----------------------------------------------------------*/
+
+/* The number of calls made by one task and their total times. */
+typedef struct TaskTimes
+{
+    uint64_t ullMallocs;
+    uint64_t ullMallocNs;
+    uint64_t ullFrees;
+    uint64_t ullFreeNs;
+} TaskTimes_t;
+
+/* A block sent from a producer to a consumer. */
+typedef struct Handoff
+{
+    uint8_t * pucBlock;
+    size_t xSize;
+} Handoff_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The tasks as described in the comments at the top of this file.  The
+ * parameter of each is its index.
+ */
+static void prvControllerTask( void * pvParameters );
+static void prvChurnTask( void * pvParameters );
+static void prvProducerTask( void * pvParameters );
+static void prvConsumerTask( void * pvParameters );
+
+/*
+ * Run one phase by calling pxCreateTask() to create each of uxNumTasks tasks,
+ * then waiting for all of them to finish.  Prints a line of results.
+ */
+static void prvRunPhase( const char * pcPhase,
+                         UBaseType_t uxNumTasks,
+                         void ( * pxCreateTask )( UBaseType_t uxIndex ) );
+
+/*
+ * Create the uxIndex'th task of each phase.
+ */
+static void prvCreateChurnTask( UBaseType_t uxIndex );
+static void prvCreateHandoffTask( UBaseType_t uxIndex );
+
+/*
+ * Tell the controller the calling task has finished, then delete it.
+ */
+static void prvFinish( void );
+
+/*
+ * Allocate a block of xSize bytes and fill it with a pattern, or check the
+ * pattern of a block and free it.  Only the call to the heap is timed.
+ */
+static uint8_t * prvAllocate( size_t xSize,
+                              TaskTimes_t * pxTimes );
+static void prvFree( uint8_t * pucBlock,
+                     size_t xSize,
+                     TaskTimes_t * pxTimes );
+
+/*
+ * A small pseudo random number generator with a state per task, so every run
+ * sees the same sequence of block sizes.
+ */
+static uint32_t prvRandom( uint32_t * pulState );
+
+/*
+ * Returns a monotonic time stamp in nanoseconds.
+ */
+static uint64_t prvGetTimeNs( void );
+
+/*-----------------------------------------------------------*/
+
+/* The times of each task in the phase being run. */
+static TaskTimes_t xTimes[ hcNUM_CHURN_TASKS + ( hcNUM_HANDOFF_PAIRS * 2U ) ];
+
+/* The number of errors found. */
+static volatile uint32_t ulErrors = 0UL;
+
+static TaskHandle_t xControllerTask = NULL;
+
+/* Everything is created statically, see the comments at the top of this
+ * file. */
+static StaticTask_t xControllerTCB;
+static StackType_t uxControllerStack[ configMINIMAL_STACK_SIZE * 2U ];
+static StaticTask_t xChurnTCBs[ hcNUM_CHURN_TASKS ];
+static StackType_t uxChurnStacks[ hcNUM_CHURN_TASKS ][ configMINIMAL_STACK_SIZE ];
+static StaticTask_t xHandoffTCBs[ hcNUM_HANDOFF_PAIRS * 2U ];
+static StackType_t uxHandoffStacks[ hcNUM_HANDOFF_PAIRS * 2U ][ configMINIMAL_STACK_SIZE ];
+static QueueHandle_t xHandoffQueues[ hcNUM_HANDOFF_PAIRS ];
+static StaticQueue_t xHandoffQueueBuffers[ hcNUM_HANDOFF_PAIRS ];
+static uint8_t ucHandoffQueueStorage[ hcNUM_HANDOFF_PAIRS ][ hcHANDOFF_QUEUE_LENGTH * sizeof( Handoff_t ) ];
+
+/*-----------------------------------------------------------*/
+
+/*** SEE THE COMMENTS AT THE TOP OF THIS FILE ***/
+void main_heap_cache_benchmark( void )
+{
+    UBaseType_t uxPair;
+
+    for( uxPair = 0U; uxPair < hcNUM_HANDOFF_PAIRS; uxPair++ )
+    {
+        xHandoffQueues[ uxPair ] = xQueueCreateStatic( hcHANDOFF_QUEUE_LENGTH, sizeof( Handoff_t ), ucHandoffQueueStorage[ uxPair ], &( xHandoffQueueBuffers[ uxPair ] ) );
+    }
+
+    xControllerTask = xTaskCreateStatic( prvControllerTask, "Control", configMINIMAL_STACK_SIZE * 2U, NULL, hcCONTROLLER_PRIORITY, uxControllerStack, &xControllerTCB );
+
+    vTaskStartScheduler();
+}
+/*-----------------------------------------------------------*/
+
+static void prvControllerTask( void * pvParameters )
+{
+    HeapStats_t xStats;
+    void * pvBlock;
+    size_t xInitialFreeBytes, xInitialLargestBlock;
+
+    ( void ) pvParameters;
+
+    /* The heap is set up by the first allocation. */
+    pvBlock = pvPortMalloc( hcSETUP_BLOCK_SIZE );
+    vPortFree( pvBlock );
+    vPortGetHeapStats( &xStats );
+    xInitialFreeBytes = xStats.xAvailableHeapSpaceInBytes;
+    xInitialLargestBlock = xStats.xSizeOfLargestFreeBlockInBytes;
+
+    console_print( "Heap cache benchmark: heap_4.c, heap caches %s, %u byte heap\n",
+                   ( configUSE_HEAP_CACHE == 1 ) ? "on" : "off",
+                   ( unsigned ) configTOTAL_HEAP_SIZE );
+    console_print( "phase, tasks, mallocs, malloc mean (ns), frees, free mean (ns), blocks taken from heap, blocks returned to heap, elapsed (ms)\n" );
+
+    prvRunPhase( "churn", hcNUM_CHURN_TASKS, prvCreateChurnTask );
+    prvRunPhase( "handoff", hcNUM_HANDOFF_PAIRS * 2U, prvCreateHandoffTask );
+
+    /* The tasks have told the controller they have finished, but may not
+     * have deleted themselves yet, and the idle task cleans up after them. */
+    vTaskDelay( pdMS_TO_TICKS( 100 ) );
+
+    /* Every block has been freed and every heap cache deleted, so the heap
+     * must be as it was before the first phase. */
+    vPortGetHeapStats( &xStats );
+
+    if( ( xStats.xAvailableHeapSpaceInBytes != xInitialFreeBytes ) ||
+        ( xStats.xSizeOfLargestFreeBlockInBytes != xInitialLargestBlock ) )
+    {
+        ulErrors++;
+    }
+
+    console_print( "errors\n%lu\n", ( unsigned long ) ulErrors );
+
+    if( ulErrors != 0UL )
+    {
+        exit( EXIT_FAILURE );
+    }
+
+    exit( EXIT_SUCCESS );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunPhase( const char * pcPhase,
+                         UBaseType_t uxNumTasks,
+                         void ( * pxCreateTask )( UBaseType_t uxIndex ) )
+{
+    HeapStats_t xStatsBefore, xStatsAfter;
+    TaskTimes_t xTotal = { 0 };
+    UBaseType_t uxTask;
+    uint32_t ulFinished = 0UL;
+    uint64_t ullStartNs, ullElapsedNs;
+
+    ( void ) memset( xTimes, 0x00, sizeof( xTimes ) );
+    vPortGetHeapStats( &xStatsBefore );
+    ullStartNs = prvGetTimeNs();
+
+    /* The tasks run below the controller, so none of them starts until the
+     * controller blocks. */
+    for( uxTask = 0U; uxTask < uxNumTasks; uxTask++ )
+    {
+        pxCreateTask( uxTask );
+    }
+
+    while( ulFinished < uxNumTasks )
+    {
+        ulFinished += ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+    }
+
+    ullElapsedNs = prvGetTimeNs() - ullStartNs;
+    vPortGetHeapStats( &xStatsAfter );
+
+    for( uxTask = 0U; uxTask < uxNumTasks; uxTask++ )
+    {
+        xTotal.ullMallocs += xTimes[ uxTask ].ullMallocs;
+        xTotal.ullMallocNs += xTimes[ uxTask ].ullMallocNs;
+        xTotal.ullFrees += xTimes[ uxTask ].ullFrees;
+        xTotal.ullFreeNs += xTimes[ uxTask ].ullFreeNs;
+    }
+
+    console_print( "%s, %lu, %llu, %.1f, %llu, %.1f, %lu, %lu, %llu\n",
+                   pcPhase,
+                   ( unsigned long ) uxNumTasks,
+                   ( unsigned long long ) xTotal.ullMallocs,
+                   ( double ) xTotal.ullMallocNs / ( double ) xTotal.ullMallocs,
+                   ( unsigned long long ) xTotal.ullFrees,
+                   ( double ) xTotal.ullFreeNs / ( double ) xTotal.ullFrees,
+                   ( unsigned long ) ( xStatsAfter.xNumberOfSuccessfulAllocations - xStatsBefore.xNumberOfSuccessfulAllocations ),
+                   ( unsigned long ) ( xStatsAfter.xNumberOfSuccessfulFrees - xStatsBefore.xNumberOfSuccessfulFrees ),
+                   ( unsigned long long ) ( ullElapsedNs / 1000000ULL ) );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCreateChurnTask( UBaseType_t uxIndex )
+{
+    xTaskCreateStatic( prvChurnTask, "Churn", configMINIMAL_STACK_SIZE, ( void * ) ( uintptr_t ) uxIndex, hcTASK_PRIORITY, uxChurnStacks[ uxIndex ], &( xChurnTCBs[ uxIndex ] ) );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCreateHandoffTask( UBaseType_t uxIndex )
+{
+    /* Even indexes are producers and odd indexes are consumers, and each pair
+     * shares a queue. */
+    if( ( uxIndex & 1U ) == 0U )
+    {
+        xTaskCreateStatic( prvProducerTask, "Prod", configMINIMAL_STACK_SIZE, ( void * ) ( uintptr_t ) uxIndex, hcTASK_PRIORITY, uxHandoffStacks[ uxIndex ], &( xHandoffTCBs[ uxIndex ] ) );
+    }
+    else
+    {
+        xTaskCreateStatic( prvConsumerTask, "Cons", configMINIMAL_STACK_SIZE, ( void * ) ( uintptr_t ) uxIndex, hcTASK_PRIORITY, uxHandoffStacks[ uxIndex ], &( xHandoffTCBs[ uxIndex ] ) );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvChurnTask( void * pvParameters )
+{
+    UBaseType_t uxIndex = ( UBaseType_t ) ( uintptr_t ) pvParameters;
+    uint8_t * pucBlocks[ hcLIVE_BLOCKS ] = { NULL };
+    size_t xSizes[ hcLIVE_BLOCKS ] = { 0 };
+    uint32_t ulRandomState = 0x12345678UL + ( uint32_t ) uxIndex;
+    uint32_t ulPair;
+    UBaseType_t uxSlot;
+
+    for( ulPair = 0UL; ulPair < hcCHURN_PAIRS; ulPair++ )
+    {
+        uxSlot = ( UBaseType_t ) ( ulPair % hcLIVE_BLOCKS );
+
+        if( pucBlocks[ uxSlot ] != NULL )
+        {
+            prvFree( pucBlocks[ uxSlot ], xSizes[ uxSlot ], &( xTimes[ uxIndex ] ) );
+        }
+
+        xSizes[ uxSlot ] = ( size_t ) ( 1UL + ( prvRandom( &ulRandomState ) % hcMAX_BLOCK_SIZE ) );
+        pucBlocks[ uxSlot ] = prvAllocate( xSizes[ uxSlot ], &( xTimes[ uxIndex ] ) );
+    }
+
+    for( uxSlot = 0U; uxSlot < hcLIVE_BLOCKS; uxSlot++ )
+    {
+        prvFree( pucBlocks[ uxSlot ], xSizes[ uxSlot ], &( xTimes[ uxIndex ] ) );
+    }
+
+    prvFinish();
+}
+/*-----------------------------------------------------------*/
+
+static void prvProducerTask( void * pvParameters )
+{
+    UBaseType_t uxIndex = ( UBaseType_t ) ( uintptr_t ) pvParameters;
+    QueueHandle_t xQueue = xHandoffQueues[ uxIndex / 2U ];
+    uint32_t ulRandomState = 0x9abcdef0UL + ( uint32_t ) uxIndex;
+    Handoff_t xHandoff;
+    uint32_t ulHandoff;
+
+    for( ulHandoff = 0UL; ulHandoff < hcHANDOFFS; ulHandoff++ )
+    {
+        xHandoff.xSize = ( size_t ) ( 1UL + ( prvRandom( &ulRandomState ) % hcMAX_BLOCK_SIZE ) );
+        xHandoff.pucBlock = prvAllocate( xHandoff.xSize, &( xTimes[ uxIndex ] ) );
+        ( void ) xQueueSend( xQueue, &xHandoff, portMAX_DELAY );
+    }
+
+    prvFinish();
+}
+/*-----------------------------------------------------------*/
+
+static void prvConsumerTask( void * pvParameters )
+{
+    UBaseType_t uxIndex = ( UBaseType_t ) ( uintptr_t ) pvParameters;
+    QueueHandle_t xQueue = xHandoffQueues[ uxIndex / 2U ];
+    Handoff_t xHandoff;
+    uint32_t ulHandoff;
+
+    for( ulHandoff = 0UL; ulHandoff < hcHANDOFFS; ulHandoff++ )
+    {
+        ( void ) xQueueReceive( xQueue, &xHandoff, portMAX_DELAY );
+        prvFree( xHandoff.pucBlock, xHandoff.xSize, &( xTimes[ uxIndex ] ) );
+    }
+
+    prvFinish();
+}
+/*-----------------------------------------------------------*/
+
+static void prvFinish( void )
+{
+    xTaskNotifyGive( xControllerTask );
+
+    /* A task deleting itself is cleaned up by the idle task, which also
+     * returns its heap cache to the heap. */
+    vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static uint8_t * prvAllocate( size_t xSize,
+                              TaskTimes_t * pxTimes )
+{
+    uint8_t * pucBlock;
+    uint64_t ullStartNs;
+
+    ullStartNs = prvGetTimeNs();
+    pucBlock = pvPortMalloc( xSize );
+    pxTimes->ullMallocNs += prvGetTimeNs() - ullStartNs;
+    pxTimes->ullMallocs++;
+
+    if( pucBlock != NULL )
+    {
+        ( void ) memset( pucBlock, ( int ) ( uint8_t ) xSize, xSize );
+    }
+    else
+    {
+        ulErrors++;
+    }
+
+    return pucBlock;
+}
+/*-----------------------------------------------------------*/
+
+static void prvFree( uint8_t * pucBlock,
+                     size_t xSize,
+                     TaskTimes_t * pxTimes )
+{
+    uint64_t ullStartNs;
+    size_t x;
+
+    if( pucBlock != NULL )
+    {
+        /* The block must not have been written by anything else. */
+        for( x = 0U; x < xSize; x++ )
+        {
+            if( pucBlock[ x ] != ( uint8_t ) xSize )
+            {
+                ulErrors++;
+                break;
+            }
+        }
+
+        ullStartNs = prvGetTimeNs();
+        vPortFree( pucBlock );
+        pxTimes->ullFreeNs += prvGetTimeNs() - ullStartNs;
+        pxTimes->ullFrees++;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvRandom( uint32_t * pulState )
+{
+    /* xorshift32. */
+    *pulState ^= *pulState << 13;
+    *pulState ^= *pulState >> 17;
+    *pulState ^= *pulState << 5;
+
+    return *pulState;
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvGetTimeNs( void )
+{
+    struct timespec xNow;
+
+    ( void ) clock_gettime( CLOCK_MONOTONIC, &xNow );
+
+    return ( ( uint64_t ) xNow.tv_sec * 1000000000ULL ) + ( uint64_t ) xNow.tv_nsec;
+}
+/*-----------------------------------------------------------*/
+
+#endif /* defined( USER_DEMO ) && ( USER_DEMO >= 26 ) && ( USER_DEMO <= 27 ) */
@@ -0,0 +1,767 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+
+/******************************************************************************
+ * NOTE 1: The FreeRTOS demo threads will not be running continuously, so
+ * do not expect to get real time behaviour from the FreeRTOS Linux port, or
+ * this demo application.  The absolute numbers reported by this test include
+ * the cost of the Linux port itself, where entering a critical section is a
+ * system call, so only compare them with numbers taken on the same machine.
+ *
+ * NOTE 2: This test is built when USER_DEMO is set to HEAP_PROFILER_TEST_DEMO,
+ * which builds heap_4.c with configUSE_HEAP_PROFILER set to 1 and a small
+ * profiler table (see FreeRTOSConfig.h).
+ ******************************************************************************
+ *
+ * main_heap_profiler() tests the heap profiler.  A controller task allocates
+ * blocks from two call sites and checks uxPortGetHeapProfile() attributes the
+ * blocks, their bytes and the time the oldest was allocated to the right call
+ * site.  The blocks of the smaller call site are then placed before those of
+ * the larger in the profiler's table, and a profile with room for one group
+ * must still hold the larger.  Two worker tasks allocate blocks, and the
+ * blocks must be attributed to the right task.  Then more blocks are allocated
+ * than the profiler table can hold, and the blocks that do not fit must be
+ * counted as untracked.  Once every block is freed the profile must be empty.
+ *
+ * The heap-profile command from Sample-CLI-commands.c is then run through
+ * FreeRTOS+CLI, with a buffer large enough for its output and with one too
+ * small, and its output printed.
+ *
+ * Finally the time pvPortMalloc() and vPortFree() take with the profiler is
+ * compared with the time the profiler takes to record and forget a block on
+ * its own.  The results are printed, any error is counted, and the
+ * application exits with a failure status if there are errors.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "heap_profiler.h"
+
+/* FreeRTOS+CLI includes. */
+#include "FreeRTOS_CLI.h"
+
+/* Local includes. */
+#include "console.h"
+
+#if ( configUSE_HEAP_PROFILER == 1 )
+
+/* The blocks allocated from each call site by the call site test. */
+    #define profFIRST_SITE_BLOCKS       ( 10U )
+    #define profFIRST_SITE_SIZE         ( 100U )
+    #define profSECOND_SITE_BLOCKS      ( 3U )
+    #define profSECOND_SITE_SIZE        ( 200U )
+
+/* The blocks the table order test allocates, all from the first call site
+ * except the one placed first in the table, and the number of times the test
+ * moves the blocks to find addresses it can use. */
+    #define profORDER_BLOCKS            ( 4U )
+    #define profORDER_SIZE              ( 48U )
+    #define profORDER_ATTEMPTS          ( 8U )
+
+/* The ticks between the allocations of the call site test. */
+    #define profDELAY_TICKS             ( ( TickType_t ) 10 )
+
+/* The blocks each worker task allocates. */
+    #define profWORKERS                 ( 2U )
+    #define profWORKER_BLOCKS           ( 4U )
+
+/* More blocks than the table can hold, which is three quarters of its size. */
+    #define profOVERFLOW_BLOCKS         ( configHEAP_PROFILER_TABLE_SIZE )
+    #define profOVERFLOW_SIZE           ( 16U )
+
+/* The timing test. */
+    #define profPAIRS                   ( 1000000UL )
+    #define profLIVE_BLOCKS             ( configHEAP_PROFILER_TABLE_SIZE / 2U )
+
+/* The blocks the CLI test allocates, and the size of the small buffer it
+ * passes to the heap-profile command. */
+    #define profCLI_BLOCKS              ( 5U )
+    #define profCLI_SIZE                ( 300U )
+    #define profCLI_SHORT_BUFFER        ( 16U )
+
+/* The size of the arrays the profile is read into. */
+    #define profMAX_GROUPS              ( 8U )
+
+    #define profCONTROLLER_PRIORITY     ( tskIDLE_PRIORITY + 1U )
+    #define profWORKER_PRIORITY         ( tskIDLE_PRIORITY + 2U )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Registers the commands in Sample-CLI-commands.c.
+ */
+extern void vRegisterSampleCLICommands( void );
+
+/*
+ * The tasks as described in the comments at the top of this file.
+ */
+static void prvControllerTask( void * pvParameters );
+static void prvWorkerTask( void * pvParameters );
+
+/*
+ * The tests run by the controller.
+ */
+static void prvCallSiteTest( void );
+static void prvTableOrderTest( void );
+static void prvTaskTest( void );
+static void prvOverflowTest( void );
+static void prvTimingTest( void );
+static void prvCLITest( void );
+
+/*
+ * Two call sites of pvPortMalloc().  noipa stops them being inlined, cloned
+ * or folded into one function, so each has one return address of its own.
+ */
+static void * prvAllocateFromFirstSite( size_t xSize ) __attribute__( ( noipa ) );
+static void * prvAllocateFromSecondSite( size_t xSize ) __attribute__( ( noipa ) );
+
+/*
+ * Returns the index of the group in pxProfile with uxBlocks blocks, or
+ * uxGroups if there is no such group.
+ */
+static UBaseType_t prvFindGroup( const HeapProfile_t * pxProfile,
+                                 UBaseType_t uxGroups,
+                                 size_t uxBlocks );
+
+/*
+ * Returns the index of the record a search for pvBlock starts at in the
+ * profiler's table.  This must match heapprofilerHOME_INDEX() in
+ * heap_profiler.c.
+ */
+static UBaseType_t prvHomeIndex( const void * pvBlock );
+
+/*
+ * Runs pcCommand through FreeRTOS+CLI, printing its output, and returns the
+ * number of strings the command returned.  pcFind is set to pdTRUE if the
+ * output contains pcFind.
+ */
+static UBaseType_t prvRunCommand( const char * pcCommand,
+                                  size_t xBufferLength,
+                                  const char * pcFind,
+                                  BaseType_t * pxFound );
+
+/*
+ * Checks no blocks are live.
+ */
+static void prvCheckProfileEmpty( const char * pcTest );
+
+/*
+ * Returns a monotonic time stamp in nanoseconds.
+ */
+static uint64_t prvGetTimeNs( void );
+
+/*-----------------------------------------------------------*/
+
+/* The tasks are created statically, as their stacks are larger than the heap
+ * on the Linux port. */
+static StaticTask_t xControllerTCB;
+static StackType_t uxControllerStack[ configMINIMAL_STACK_SIZE * 2U ];
+static StaticTask_t xWorkerTCBs[ profWORKERS ];
+static StackType_t uxWorkerStacks[ profWORKERS ][ configMINIMAL_STACK_SIZE ];
+static TaskHandle_t xControllerTask = NULL;
+static TaskHandle_t xWorkerTasks[ profWORKERS ];
+
+/* The blocks allocated by each worker, which the controller frees. */
+static void * pvWorkerBlocks[ profWORKERS ][ profWORKER_BLOCKS ];
+
+/* The number of errors found. */
+static uint32_t ulErrors = 0UL;
+
+/*-----------------------------------------------------------*/
+
+/*** SEE THE COMMENTS AT THE TOP OF THIS FILE ***/
+void main_heap_profiler( void )
+{
+    xControllerTask = xTaskCreateStatic( prvControllerTask, "Control", configMINIMAL_STACK_SIZE * 2U, NULL, profCONTROLLER_PRIORITY, uxControllerStack, &xControllerTCB );
+
+    vTaskStartScheduler();
+}
+/*-----------------------------------------------------------*/
+
+static void prvControllerTask( void * pvParameters )
+{
+    ( void ) pvParameters;
+
+    prvCheckProfileEmpty( "start" );
+    prvCallSiteTest();
+    prvTableOrderTest();
+    prvTaskTest();
+    prvOverflowTest();
+    prvTimingTest();
+
+    /* Last, as registering the commands allocates blocks that are never
+     * freed. */
+    prvCLITest();
+
+    console_print( "errors\n%lu\n", ( unsigned long ) ulErrors );
+
+    if( ulErrors != 0UL )
+    {
+        exit( EXIT_FAILURE );
+    }
+
+    exit( EXIT_SUCCESS );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCallSiteTest( void )
+{
+    void * pvFirst[ profFIRST_SITE_BLOCKS ];
+    void * pvSecond[ profSECOND_SITE_BLOCKS ];
+    HeapProfile_t xProfile[ profMAX_GROUPS ];
+    UBaseType_t uxGroups, uxFirstGroup, uxSecondGroup, x;
+    TickType_t xFirstTick, xSecondTick;
+    uint32_t ulErrorsBefore = ulErrors;
+
+    /* The tick count is read before each run of allocations, so a tick
+     * interrupt between the read and the first allocation can make the time
+     * stamps one tick later than the read. */
+    xFirstTick = xTaskGetTickCount();
+
+    for( x = 0U; x < profFIRST_SITE_BLOCKS; x++ )
+    {
+        pvFirst[ x ] = prvAllocateFromFirstSite( profFIRST_SITE_SIZE );
+
+        if( x == 0U )
+        {
+            vTaskDelay( profDELAY_TICKS );
+        }
+    }
+
+    vTaskDelay( profDELAY_TICKS );
+    xSecondTick = xTaskGetTickCount();
+
+    for( x = 0U; x < profSECOND_SITE_BLOCKS; x++ )
+    {
+        pvSecond[ x ] = prvAllocateFromSecondSite( profSECOND_SITE_SIZE );
+    }
+
+    uxGroups = uxPortGetHeapProfile( xProfile, profMAX_GROUPS, eHeapProfileByCallSite );
+    uxFirstGroup = prvFindGroup( xProfile, uxGroups, profFIRST_SITE_BLOCKS );
+    uxSecondGroup = prvFindGroup( xProfile, uxGroups, profSECOND_SITE_BLOCKS );
+
+    if( ( uxGroups != 2U ) || ( uxFirstGroup == uxGroups ) || ( uxSecondGroup == uxGroups ) )
+    {
+        ulErrors++;
+    }
+    else
+    {
+        /* The groups hold the blocks, including their headers, have distinct
+         * call sites, belong to no task, and are sorted largest first. */
+        if( ( xProfile[ uxFirstGroup ].pvCallSite == NULL ) ||
+            ( xProfile[ uxFirstGroup ].pvCallSite == xProfile[ uxSecondGroup ].pvCallSite ) ||
+            ( xProfile[ uxFirstGroup ].xTask != NULL ) ||
+            ( xProfile[ uxFirstGroup ].xLiveBytes <= ( profFIRST_SITE_BLOCKS * profFIRST_SITE_SIZE ) ) ||
+            ( xProfile[ uxSecondGroup ].xLiveBytes <= ( profSECOND_SITE_BLOCKS * profSECOND_SITE_SIZE ) ) ||
+            ( xProfile[ 0 ].xLiveBytes < xProfile[ 1 ].xLiveBytes ) ||
+            ( ( xProfile[ uxFirstGroup ].xOldestTimeStamp - xFirstTick ) > ( TickType_t ) 1 ) ||
+            ( ( xProfile[ uxSecondGroup ].xOldestTimeStamp - xSecondTick ) > ( TickType_t ) 1 ) )
+        {
+            ulErrors++;
+        }
+    }
+
+    /* Freeing the oldest block of the first call site makes a later block the
+     * oldest. */
+    vPortFree( pvFirst[ 0 ] );
+    uxGroups = uxPortGetHeapProfile( xProfile, profMAX_GROUPS, eHeapProfileByCallSite );
+    uxFirstGroup = prvFindGroup( xProfile, uxGroups, profFIRST_SITE_BLOCKS - 1U );
+
+    if( ( uxFirstGroup == uxGroups ) ||
+        ( ( xProfile[ uxFirstGroup ].xOldestTimeStamp - xFirstTick ) < profDELAY_TICKS ) )
+    {
+        ulErrors++;
+    }
+
+    /* An array too small for every group holds the largest. */
+    if( ( uxPortGetHeapProfile( xProfile, 1U, eHeapProfileByCallSite ) != 1U ) ||
+        ( xProfile[ 0 ].xLiveBlocks != ( profFIRST_SITE_BLOCKS - 1U ) ) )
+    {
+        ulErrors++;
+    }
+
+    for( x = 1U; x < profFIRST_SITE_BLOCKS; x++ )
+    {
+        vPortFree( pvFirst[ x ] );
+    }
+
+    for( x = 0U; x < profSECOND_SITE_BLOCKS; x++ )
+    {
+        vPortFree( pvSecond[ x ] );
+    }
+
+    console_print( "call site test: %lu errors\n", ( unsigned long ) ( ulErrors - ulErrorsBefore ) );
+    prvCheckProfileEmpty( "call site" );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTableOrderTest( void )
+{
+    void * pvBlocks[ profORDER_BLOCKS ];
+    void * pvProbes[ profORDER_BLOCKS ];
+    void * pvPadding[ profORDER_ATTEMPTS ];
+    UBaseType_t uxHomes[ profORDER_BLOCKS + profORDER_ATTEMPTS ];
+    HeapProfile_t xProfile[ 1 ];
+    UBaseType_t uxAttempt, uxPaddingBlocks = 0U, uxHomeCount, uxFirst = 0U, x, y;
+    BaseType_t xDistinct = pdFALSE;
+    uint32_t ulErrorsBefore = ulErrors;
+
+    /* A record is only stored away from its home index when another record
+     * already holds it, so if every live block has a distinct home index each
+     * record is at its home index.  Find addresses that do, moving later
+     * allocations along with a padding block each time they do not.  heap_4.c
+     * returns the same addresses to the same allocations once the blocks it
+     * returned are freed, so the addresses can be tried before they are used. */
+    for( uxAttempt = 0U; ( uxAttempt < profORDER_ATTEMPTS ) && ( xDistinct == pdFALSE ); uxAttempt++ )
+    {
+        uxHomeCount = 0U;
+
+        for( x = 0U; x < uxPaddingBlocks; x++ )
+        {
+            uxHomes[ uxHomeCount++ ] = prvHomeIndex( pvPadding[ x ] );
+        }
+
+        for( x = 0U; x < profORDER_BLOCKS; x++ )
+        {
+            pvProbes[ x ] = pvPortMalloc( profORDER_SIZE );
+            uxHomes[ uxHomeCount++ ] = prvHomeIndex( pvProbes[ x ] );
+        }
+
+        xDistinct = pdTRUE;
+
+        for( x = 0U; x < uxHomeCount; x++ )
+        {
+            for( y = x + 1U; y < uxHomeCount; y++ )
+            {
+                if( uxHomes[ x ] == uxHomes[ y ] )
+                {
+                    xDistinct = pdFALSE;
+                }
+            }
+        }
+
+        for( x = profORDER_BLOCKS; x > 0U; x-- )
+        {
+            vPortFree( pvProbes[ x - 1U ] );
+        }
+
+        if( xDistinct == pdFALSE )
+        {
+            pvPadding[ uxPaddingBlocks ] = pvPortMalloc( 16U );
+            uxPaddingBlocks++;
+        }
+    }
+
+    if( xDistinct == pdFALSE )
+    {
+        ulErrors++;
+        console_print( "table order test: no usable addresses found\n" );
+    }
+    else
+    {
+        /* The block with the lowest home index comes first in the table, so
+         * allocate it from the second call site and the rest, which hold more
+         * bytes, from the first. */
+        for( x = 1U; x < profORDER_BLOCKS; x++ )
+        {
+            if( prvHomeIndex( pvProbes[ x ] ) < prvHomeIndex( pvProbes[ uxFirst ] ) )
+            {
+                uxFirst = x;
+            }
+        }
+
+        for( x = 0U; x < profORDER_BLOCKS; x++ )
+        {
+            if( x == uxFirst )
+            {
+                pvBlocks[ x ] = prvAllocateFromSecondSite( profORDER_SIZE );
+            }
+            else
+            {
+                pvBlocks[ x ] = prvAllocateFromFirstSite( profORDER_SIZE );
+            }
+
+            if( pvBlocks[ x ] != pvProbes[ x ] )
+            {
+                ulErrors++;
+            }
+        }
+
+        /* A profile with room for one group holds the larger, though the
+         * smaller is found first. */
+        if( ( uxPortGetHeapProfile( xProfile, 1U, eHeapProfileByCallSite ) != 1U ) ||
+            ( xProfile[ 0 ].xLiveBlocks != ( profORDER_BLOCKS - 1U ) ) )
+        {
+            ulErrors++;
+        }
+
+        for( x = 0U; x < profORDER_BLOCKS; x++ )
+        {
+            vPortFree( pvBlocks[ x ] );
+        }
+    }
+
+    for( x = 0U; x < uxPaddingBlocks; x++ )
+    {
+        vPortFree( pvPadding[ x ] );
+    }
+
+    console_print( "table order test: %lu errors\n", ( unsigned long ) ( ulErrors - ulErrorsBefore ) );
+    prvCheckProfileEmpty( "table order" );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTaskTest( void )
+{
+    HeapProfile_t xProfile[ profMAX_GROUPS ];
+    UBaseType_t uxGroups, uxWorker, uxGroup, x;
+    uint32_t ulErrorsBefore = ulErrors;
+
+    /* The workers have a higher priority than the controller, so allocate
+     * their blocks and delete themselves before xTaskCreateStatic() returns. */
+    for( uxWorker = 0U; uxWorker < profWORKERS; uxWorker++ )
+    {
+        xWorkerTasks[ uxWorker ] = xTaskCreateStatic( prvWorkerTask, "Worker", configMINIMAL_STACK_SIZE, ( void * ) ( uintptr_t ) uxWorker, profWORKER_PRIORITY, uxWorkerStacks[ uxWorker ], &( xWorkerTCBs[ uxWorker ] ) );
+    }
+
+    /* Worker n allocated n + 1 blocks per round. */
+    uxGroups = uxPortGetHeapProfile( xProfile, profMAX_GROUPS, eHeapProfileByTask );
+
+    if( uxGroups != profWORKERS )
+    {
+        ulErrors++;
+    }
+
+    for( uxWorker = 0U; uxWorker < profWORKERS; uxWorker++ )
+    {
+        uxGroup = prvFindGroup( xProfile, uxGroups, profWORKER_BLOCKS - uxWorker );
+
+        if( ( uxGroup == uxGroups ) ||
+            ( xProfile[ uxGroup ].xTask != xWorkerTasks[ uxWorker ] ) ||
+            ( xProfile[ uxGroup ].pvCallSite != NULL ) )
+        {
+            ulErrors++;
+        }
+
+        /* Blocks stay attributed to a task after it is deleted, and can be
+         * freed by another task. */
+        for( x = 0U; x < ( profWORKER_BLOCKS - uxWorker ); x++ )
+        {
+            vPortFree( pvWorkerBlocks[ uxWorker ][ x ] );
+        }
+    }
+
+    console_print( "task test: %lu errors\n", ( unsigned long ) ( ulErrors - ulErrorsBefore ) );
+    prvCheckProfileEmpty( "task" );
+}
+/*-----------------------------------------------------------*/
+
+static void prvWorkerTask( void * pvParameters )
+{
+    UBaseType_t uxWorker = ( UBaseType_t ) ( uintptr_t ) pvParameters;
+    UBaseType_t x;
+
+    /* Each worker allocates a different number of blocks so the controller
+     * can tell their groups apart. */
+    for( x = 0U; x < ( profWORKER_BLOCKS - uxWorker ); x++ )
+    {
+        pvWorkerBlocks[ uxWorker ][ x ] = pvPortMalloc( 32U );
+    }
+
+    vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvOverflowTest( void )
+{
+    static void * pvBlocks[ profOVERFLOW_BLOCKS ];
+    HeapProfile_t xProfile[ profMAX_GROUPS ];
+    UBaseType_t uxGroups, x;
+    size_t xTracked;
+    uint32_t ulErrorsBefore = ulErrors;
+
+    for( x = 0U; x < profOVERFLOW_BLOCKS; x++ )
+    {
+        pvBlocks[ x ] = prvAllocateFromFirstSite( profOVERFLOW_SIZE );
+    }
+
+    /* Three quarters of the blocks are tracked, and the rest untracked. */
+    uxGroups = uxPortGetHeapProfile( xProfile, profMAX_GROUPS, eHeapProfileByCallSite );
+    xTracked = ( uxGroups == 1U ) ? xProfile[ 0 ].xLiveBlocks : 0U;
+
+    if( ( xTracked != ( ( configHEAP_PROFILER_TABLE_SIZE / 4U ) * 3U ) ) ||
+        ( xPortGetHeapProfileUntrackedBytes() != ( ( profOVERFLOW_BLOCKS - xTracked ) * ( xProfile[ 0 ].xLiveBytes / xTracked ) ) ) )
+    {
+        ulErrors++;
+    }
+
+    /* Free the blocks in an order that removes records from the middle of runs
+     * of records that collided. */
+    for( x = 0U; x < profOVERFLOW_BLOCKS; x += 2U )
+    {
+        vPortFree( pvBlocks[ x ] );
+    }
+
+    for( x = 1U; x < profOVERFLOW_BLOCKS; x += 2U )
+    {
+        vPortFree( pvBlocks[ x ] );
+    }
+
+    console_print( "overflow test: %lu errors, %lu blocks tracked of %lu\n",
+                   ( unsigned long ) ( ulErrors - ulErrorsBefore ),
+                   ( unsigned long ) xTracked,
+                   ( unsigned long ) profOVERFLOW_BLOCKS );
+    prvCheckProfileEmpty( "overflow" );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTimingTest( void )
+{
+    static void * pvLive[ profLIVE_BLOCKS ];
+    void * pvBlock;
+    uint64_t ullStartNs, ullMallocNs, ullRecordNs;
+    uint32_t ulPair;
+    UBaseType_t x;
+
+    /* Keep the table half full, as it might be in an application. */
+    for( x = 0U; x < profLIVE_BLOCKS; x++ )
+    {
+        pvLive[ x ] = pvPortMalloc( 24U );
+    }
+
+    ullStartNs = prvGetTimeNs();
+
+    for( ulPair = 0UL; ulPair < profPAIRS; ulPair++ )
+    {
+        pvBlock = pvPortMalloc( 40U );
+        vPortFree( pvBlock );
+    }
+
+    ullMallocNs = prvGetTimeNs() - ullStartNs;
+
+    /* Record and forget a block that is not in the heap, so only the profiler
+     * is timed. */
+    ullStartNs = prvGetTimeNs();
+
+    for( ulPair = 0UL; ulPair < profPAIRS; ulPair++ )
+    {
+        vPortHeapProfilerRecordAlloc( &ulPair, 48U, NULL );
+        vPortHeapProfilerRecordFree( &ulPair, 48U );
+    }
+
+    ullRecordNs = prvGetTimeNs() - ullStartNs;
+
+    for( x = 0U; x < profLIVE_BLOCKS; x++ )
+    {
+        vPortFree( pvLive[ x ] );
+    }
+
+    console_print( "test, pairs, ns per pair\n" );
+    console_print( "pvPortMalloc() and vPortFree() with profiler, %lu, %.1f\n", ( unsigned long ) profPAIRS, ( double ) ullMallocNs / ( double ) profPAIRS );
+    console_print( "profiler record and forget, %lu, %.1f\n", ( unsigned long ) profPAIRS, ( double ) ullRecordNs / ( double ) profPAIRS );
+
+    prvCheckProfileEmpty( "timing" );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCLITest( void )
+{
+    void * pvBlocks[ profCLI_BLOCKS ];
+    HeapProfile_t xProfile[ 1 ];
+    char cCallSite[ 32 ];
+    UBaseType_t uxLines, x;
+    BaseType_t xFound;
+    uint32_t ulErrorsBefore = ulErrors;
+
+    vRegisterSampleCLICommands();
+
+    /* The largest group is the one allocated here, so heads the call sites. */
+    for( x = 0U; x < profCLI_BLOCKS; x++ )
+    {
+        pvBlocks[ x ] = prvAllocateFromSecondSite( profCLI_SIZE );
+    }
+
+    ( void ) uxPortGetHeapProfile( xProfile, 1U, eHeapProfileByCallSite );
+    ( void ) snprintf( cCallSite, sizeof( cCallSite ), "%-18p %11u  %6u", xProfile[ 0 ].pvCallSite, ( unsigned int ) xProfile[ 0 ].xLiveBytes, ( unsigned int ) profCLI_BLOCKS );
+
+    /* The header, at least the one group, and the untracked bytes. */
+    uxLines = prvRunCommand( "heap-profile sites", configCOMMAND_INT_MAX_OUTPUT_SIZE, cCallSite, &xFound );
+
+    if( ( uxLines < 3U ) || ( xFound == pdFALSE ) )
+    {
+        ulErrors++;
+    }
+
+    /* The controller allocated the blocks. */
+    uxLines = prvRunCommand( "heap-profile tasks", configCOMMAND_INT_MAX_OUTPUT_SIZE, "Control", &xFound );
+
+    if( ( uxLines < 3U ) || ( xFound == pdFALSE ) )
+    {
+        ulErrors++;
+    }
+
+    /* A buffer too small for the lines cuts them short. */
+    ( void ) prvRunCommand( "heap-profile sites", profCLI_SHORT_BUFFER, NULL, NULL );
+
+    for( x = 0U; x < profCLI_BLOCKS; x++ )
+    {
+        vPortFree( pvBlocks[ x ] );
+    }
+
+    console_print( "CLI test: %lu errors\n", ( unsigned long ) ( ulErrors - ulErrorsBefore ) );
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvRunCommand( const char * pcCommand,
+                                  size_t xBufferLength,
+                                  const char * pcFind,
+                                  BaseType_t * pxFound )
+{
+    /* Guard bytes after the buffer passed to the command catch writes past
+     * xBufferLength. */
+    static char cOutput[ configCOMMAND_INT_MAX_OUTPUT_SIZE + 4U ];
+    BaseType_t xMoreDataToFollow;
+    UBaseType_t uxStrings = 0U;
+
+    configASSERT( xBufferLength <= configCOMMAND_INT_MAX_OUTPUT_SIZE );
+
+    if( pxFound != NULL )
+    {
+        *pxFound = pdFALSE;
+    }
+
+    console_print( "> %s\n", pcCommand );
+
+    do
+    {
+        ( void ) memset( cOutput, 0x55, sizeof( cOutput ) );
+        xMoreDataToFollow = FreeRTOS_CLIProcessCommand( pcCommand, cOutput, xBufferLength );
+        uxStrings++;
+
+        if( ( memchr( cOutput, 0x00, xBufferLength ) == NULL ) || ( cOutput[ xBufferLength ] != 0x55 ) )
+        {
+            ulErrors++;
+            console_print( "%s wrote past the end of its buffer\n", pcCommand );
+            cOutput[ xBufferLength - 1U ] = 0x00;
+        }
+
+        if( ( pcFind != NULL ) && ( strstr( cOutput, pcFind ) != NULL ) )
+        {
+            *pxFound = pdTRUE;
+        }
+
+        console_print( "%s", cOutput );
+    } while( xMoreDataToFollow != pdFALSE );
+
+    console_print( "\n" );
+
+    return uxStrings;
+}
+/*-----------------------------------------------------------*/
+
+static void * prvAllocateFromFirstSite( size_t xSize )
+{
+    void * pvBlock = pvPortMalloc( xSize );
+
+    /* Stop the call being made a tail call, which would attribute the block
+     * to the caller of this function. */
+    __asm volatile ( "" ::: "memory" );
+
+    return pvBlock;
+}
+/*-----------------------------------------------------------*/
+
+static void * prvAllocateFromSecondSite( size_t xSize )
+{
+    void * pvBlock = pvPortMalloc( xSize );
+
+    /* As in prvAllocateFromFirstSite(). */
+    __asm volatile ( "" ::: "memory" );
+
+    return pvBlock;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvFindGroup( const HeapProfile_t * pxProfile,
+                                 UBaseType_t uxGroups,
+                                 size_t uxBlocks )
+{
+    UBaseType_t uxGroup;
+
+    for( uxGroup = 0U; uxGroup < uxGroups; uxGroup++ )
+    {
+        if( pxProfile[ uxGroup ].xLiveBlocks == uxBlocks )
+        {
+            break;
+        }
+    }
+
+    return uxGroup;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvHomeIndex( const void * pvBlock )
+{
+    portPOINTER_SIZE_TYPE uxAddress = ( portPOINTER_SIZE_TYPE ) pvBlock;
+
+    return ( UBaseType_t ) ( ( ( uxAddress / portBYTE_ALIGNMENT ) ^
+                               ( uxAddress / ( portBYTE_ALIGNMENT * configHEAP_PROFILER_TABLE_SIZE ) ) ) &
+                             ( configHEAP_PROFILER_TABLE_SIZE - 1U ) );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckProfileEmpty( const char * pcTest )
+{
+    HeapProfile_t xProfile[ profMAX_GROUPS ];
+
+    if( ( uxPortGetHeapProfile( xProfile, profMAX_GROUPS, eHeapProfileByCallSite ) != 0U ) ||
+        ( uxPortGetHeapProfile( xProfile, profMAX_GROUPS, eHeapProfileByTask ) != 0U ) ||
+        ( xPortGetHeapProfileUntrackedBytes() != ( size_t ) 0U ) )
+    {
+        ulErrors++;
+        console_print( "%s: blocks are still live\n", pcTest );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvGetTimeNs( void )
+{
+    struct timespec xNow;
+
+    ( void ) clock_gettime( CLOCK_MONOTONIC, &xNow );
+
+    return ( ( uint64_t ) xNow.tv_sec * 1000000000ULL ) + ( uint64_t ) xNow.tv_nsec;
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_HEAP_PROFILER == 1 */
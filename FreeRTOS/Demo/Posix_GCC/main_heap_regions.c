@@ -0,0 +1,459 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+
+/******************************************************************************
+ * NOTE 1: The FreeRTOS demo threads will not be running continuously, so
+ * do not expect to get real time behaviour from the FreeRTOS Linux port, or
+ * this demo application.  Both heap regions are ordinary Linux memory, so this
+ * test checks where blocks are placed rather than how fast the memory is.
+ *
+ * NOTE 2: This test is built when USER_DEMO is set to HEAP_REGIONS_TEST_DEMO,
+ * which builds heap_5.c with configUSE_HEAP_REGIONS set to 1, and places task
+ * control blocks and stacks in region 0 and queues in region 1 (see
+ * FreeRTOSConfig.h).
+ ******************************************************************************
+ *
+ * main_heap_regions() defines two heap regions, region 0 standing for fast
+ * internal RAM and region 1 for slow external RAM, then creates a controller
+ * task, which must be placed in region 0, that runs the following tests.
+ *
+ * The free bytes of the regions add up to the free bytes of the heap, and
+ * blocks allocated with pvPortMallocRegion() come from the selected region,
+ * or from the first selected region with space.  A task control block and
+ * stack are placed in region 0 and a queue in region 1.
+ *
+ * Region 0 is then filled.  Allocations that only select region 0 fail, while
+ * allocations that select both regions come from region 1.  Once everything is
+ * freed each region is a single free block again, and the statistics of each
+ * region show every allocation was freed.
+ *
+ * Finally blocks of random sizes are allocated from random regions and freed
+ * in a random order, checking every block comes from a selected region.  The
+ * time taken is printed, any error is counted, and the application exits with
+ * a failure status if there are errors.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+/* Local includes. */
+#include "console.h"
+
+#if ( configUSE_HEAP_REGIONS == 1 )
+
+/* The size of each region.  Task stacks are large on the Linux port, so the
+ * regions are too. */
+    #define regionSIZE                 ( 1024U * 1024U )
+
+/* The masks that select each region, or both. */
+    #define regionFAST                 ( ( UBaseType_t ) 0x01U )
+    #define regionSLOW                 ( ( UBaseType_t ) 0x02U )
+    #define regionANY                  ( regionFAST | regionSLOW )
+
+/* The size of the blocks used to fill region 0. */
+    #define regionFILL_BLOCK_SIZE      ( 256U )
+
+/* The churn test. */
+    #define regionCHURN_BLOCKS         ( 256U )
+    #define regionCHURN_OPERATIONS     ( 1000000UL )
+    #define regionCHURN_MAX_SIZE       ( 512U )
+
+    #define regionCONTROLLER_PRIORITY  ( tskIDLE_PRIORITY + 1U )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The task that runs the tests, as described at the top of this file.
+ */
+static void prvControllerTask( void * pvParameters );
+
+/*
+ * The tests run by the controller.
+ */
+static void prvPlacementTests( void );
+static void prvFillTest( void );
+static void prvChurnTest( void );
+
+/*
+ * Returns the mask of the region that contains pv, or 0 if pv is not in
+ * either region.
+ */
+static UBaseType_t prvGetRegionOf( const void * pv );
+
+/*
+ * Checks that every region is back to a single free block holding all the
+ * region's free space.
+ */
+static void prvCheckRegionsEmpty( const char * pcTest );
+
+/*
+ * Returns a monotonic time stamp in nanoseconds.
+ */
+static uint64_t prvGetTimeNs( void );
+
+/*
+ * A task that deletes itself, created to check where its control block and
+ * stack are placed.
+ */
+static void prvSelfDeletingTask( void * pvParameters );
+
+/*-----------------------------------------------------------*/
+
+/* The two regions.  They are one array so region 0 has the lower address, as
+ * vPortDefineHeapRegions() requires. */
+static uint8_t ucHeap[ 2 ][ regionSIZE ] __attribute__( ( aligned( portBYTE_ALIGNMENT ) ) );
+
+/* The free bytes of each region once the controller task has been created. */
+static size_t xInitialFreeBytes[ 2 ];
+
+/* The number of errors found. */
+static uint32_t ulErrors = 0UL;
+
+/*-----------------------------------------------------------*/
+
+/*** SEE THE COMMENTS AT THE TOP OF THIS FILE ***/
+void main_heap_regions( void )
+{
+    const HeapRegion_t xHeapRegions[] =
+    {
+        { ucHeap[ 0 ], sizeof( ucHeap[ 0 ] ) },
+        { ucHeap[ 1 ], sizeof( ucHeap[ 1 ] ) },
+        { NULL,        0                     }
+    };
+    TaskHandle_t xController = NULL;
+
+    vPortDefineHeapRegions( xHeapRegions );
+
+    xTaskCreate( prvControllerTask, "Control", configMINIMAL_STACK_SIZE * 2U, NULL, regionCONTROLLER_PRIORITY, &xController );
+    configASSERT( prvGetRegionOf( xController ) == regionFAST );
+
+    vTaskStartScheduler();
+}
+/*-----------------------------------------------------------*/
+
+static void prvControllerTask( void * pvParameters )
+{
+    HeapStats_t xStats;
+    UBaseType_t uxRegion;
+
+    ( void ) pvParameters;
+
+    for( uxRegion = 0U; uxRegion < 2U; uxRegion++ )
+    {
+        vPortGetHeapRegionStats( uxRegion, &xStats );
+        xInitialFreeBytes[ uxRegion ] = xStats.xAvailableHeapSpaceInBytes;
+    }
+
+    console_print( "region 0 free bytes, region 1 free bytes\n%lu, %lu\n",
+                   ( unsigned long ) xInitialFreeBytes[ 0 ],
+                   ( unsigned long ) xInitialFreeBytes[ 1 ] );
+
+    prvPlacementTests();
+    prvFillTest();
+    prvChurnTest();
+
+    console_print( "errors\n%lu\n", ( unsigned long ) ulErrors );
+
+    if( ulErrors != 0UL )
+    {
+        exit( EXIT_FAILURE );
+    }
+
+    exit( EXIT_SUCCESS );
+}
+/*-----------------------------------------------------------*/
+
+static void prvPlacementTests( void )
+{
+    HeapStats_t xStats[ 2 ];
+    void * pvFast;
+    void * pvSlow;
+    void * pvAny;
+    TaskHandle_t xTask = NULL;
+    TaskStatus_t xStatus;
+    QueueHandle_t xQueue;
+    UBaseType_t uxTasks;
+
+    /* The regions account for all the free space. */
+    vPortGetHeapRegionStats( 0U, &( xStats[ 0 ] ) );
+    vPortGetHeapRegionStats( 1U, &( xStats[ 1 ] ) );
+
+    if( ( xStats[ 0 ].xAvailableHeapSpaceInBytes + xStats[ 1 ].xAvailableHeapSpaceInBytes ) != xPortGetFreeHeapSize() )
+    {
+        ulErrors++;
+    }
+
+    /* Blocks come from the selected region, or the first selected region with
+     * space. */
+    pvFast = pvPortMallocRegion( 64U, regionFAST );
+    pvSlow = pvPortMallocRegion( 64U, regionSLOW );
+    pvAny = pvPortMalloc( 64U );
+
+    if( ( prvGetRegionOf( pvFast ) != regionFAST ) ||
+        ( prvGetRegionOf( pvSlow ) != regionSLOW ) ||
+        ( prvGetRegionOf( pvAny ) != regionFAST ) )
+    {
+        ulErrors++;
+    }
+
+    /* No region is selected. */
+    if( pvPortMallocRegion( 64U, 0U ) != NULL )
+    {
+        ulErrors++;
+    }
+
+    vPortGetHeapRegionStats( 1U, &( xStats[ 1 ] ) );
+
+    if( xStats[ 1 ].xNumberOfSuccessfulAllocations != 1U )
+    {
+        ulErrors++;
+    }
+
+    vPortFree( pvFast );
+    vPortFree( pvSlow );
+    vPortFree( pvAny );
+
+    /* Task control blocks and stacks are placed in region 0, and queues in
+     * region 1.  The task has a lower priority than the controller, so does not
+     * run, and delete itself, until the controller blocks. */
+    uxTasks = uxTaskGetNumberOfTasks();
+    xTaskCreate( prvSelfDeletingTask, "Delete", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY, &xTask );
+    xQueue = xQueueCreate( 8U, sizeof( uint32_t ) );
+
+    if( ( xTask == NULL ) || ( xQueue == NULL ) )
+    {
+        ulErrors++;
+    }
+    else
+    {
+        vTaskGetInfo( xTask, &xStatus, pdFALSE, eInvalid );
+
+        if( ( prvGetRegionOf( xTask ) != regionFAST ) ||
+            ( prvGetRegionOf( xStatus.pxStackBase ) != regionFAST ) ||
+            ( prvGetRegionOf( xQueue ) != regionSLOW ) )
+        {
+            ulErrors++;
+        }
+
+        vQueueDelete( xQueue );
+
+        /* Wait for the task to delete itself and the idle task to free it. */
+        while( uxTaskGetNumberOfTasks() > uxTasks )
+        {
+            vTaskDelay( 1 );
+        }
+    }
+
+    prvCheckRegionsEmpty( "placement" );
+}
+/*-----------------------------------------------------------*/
+
+static void prvFillTest( void )
+{
+    void * pvFirstBlock = NULL;
+    void * pvBlock;
+    uint32_t ulBlocks = 0UL;
+    HeapStats_t xStats;
+
+    /* Fill region 0, linking the blocks through their first word. */
+    while( ( pvBlock = pvPortMallocRegion( regionFILL_BLOCK_SIZE, regionFAST ) ) != NULL )
+    {
+        if( prvGetRegionOf( pvBlock ) != regionFAST )
+        {
+            ulErrors++;
+        }
+
+        *( ( void ** ) pvBlock ) = pvFirstBlock;
+        pvFirstBlock = pvBlock;
+        ulBlocks++;
+    }
+
+    /* Region 0 can only hold a block smaller than those it was filled with,
+     * so blocks that may come from either region come from region 1. */
+    vPortGetHeapRegionStats( 0U, &xStats );
+
+    if( xStats.xSizeOfLargestFreeBlockInBytes >= regionFILL_BLOCK_SIZE )
+    {
+        ulErrors++;
+    }
+
+    pvBlock = pvPortMallocRegion( regionFILL_BLOCK_SIZE, regionANY );
+
+    if( prvGetRegionOf( pvBlock ) != regionSLOW )
+    {
+        ulErrors++;
+    }
+
+    vPortFree( pvBlock );
+
+    while( pvFirstBlock != NULL )
+    {
+        pvBlock = pvFirstBlock;
+        pvFirstBlock = *( ( void ** ) pvBlock );
+        vPortFree( pvBlock );
+    }
+
+    console_print( "fill test: %lu blocks of %u bytes filled region 0\n", ( unsigned long ) ulBlocks, regionFILL_BLOCK_SIZE );
+
+    prvCheckRegionsEmpty( "fill" );
+}
+/*-----------------------------------------------------------*/
+
+static void prvChurnTest( void )
+{
+    static void * pvBlocks[ regionCHURN_BLOCKS ];
+    static UBaseType_t uxMasks[ regionCHURN_BLOCKS ];
+    const UBaseType_t uxChoices[] = { regionFAST, regionSLOW, regionANY };
+    uint32_t ulOperation, ulFailed = 0UL;
+    uint32_t ulSeed = 0x12345678UL;
+    uint64_t ullStartNs, ullElapsedNs;
+    size_t xIndex;
+
+    ullStartNs = prvGetTimeNs();
+
+    for( ulOperation = 0UL; ulOperation < regionCHURN_OPERATIONS; ulOperation++ )
+    {
+        ulSeed = ( ulSeed * 1103515245UL ) + 12345UL;
+        xIndex = ( size_t ) ( ( ulSeed >> 8 ) % regionCHURN_BLOCKS );
+
+        if( pvBlocks[ xIndex ] != NULL )
+        {
+            if( ( prvGetRegionOf( pvBlocks[ xIndex ] ) & uxMasks[ xIndex ] ) == 0U )
+            {
+                ulErrors++;
+            }
+
+            vPortFree( pvBlocks[ xIndex ] );
+            pvBlocks[ xIndex ] = NULL;
+        }
+        else
+        {
+            uxMasks[ xIndex ] = uxChoices[ ( ulSeed >> 20 ) % 3UL ];
+            pvBlocks[ xIndex ] = pvPortMallocRegion( 1U + ( ( ulSeed >> 4 ) % regionCHURN_MAX_SIZE ), uxMasks[ xIndex ] );
+
+            if( pvBlocks[ xIndex ] == NULL )
+            {
+                ulFailed++;
+            }
+        }
+    }
+
+    ullElapsedNs = prvGetTimeNs() - ullStartNs;
+
+    for( xIndex = 0U; xIndex < regionCHURN_BLOCKS; xIndex++ )
+    {
+        vPortFree( pvBlocks[ xIndex ] );
+        pvBlocks[ xIndex ] = NULL;
+    }
+
+    /* The regions are far larger than the blocks in use. */
+    if( ulFailed != 0UL )
+    {
+        ulErrors++;
+    }
+
+    console_print( "churn test: operations, ns per operation\n%lu, %.1f\n",
+                   ( unsigned long ) regionCHURN_OPERATIONS,
+                   ( double ) ullElapsedNs / ( double ) regionCHURN_OPERATIONS );
+
+    prvCheckRegionsEmpty( "churn" );
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvGetRegionOf( const void * pv )
+{
+    const uint8_t * puc = ( const uint8_t * ) pv;
+    UBaseType_t uxReturn = 0U;
+
+    if( ( puc >= ucHeap[ 0 ] ) && ( puc < ( ucHeap[ 0 ] + regionSIZE ) ) )
+    {
+        uxReturn = regionFAST;
+    }
+    else if( ( puc >= ucHeap[ 1 ] ) && ( puc < ( ucHeap[ 1 ] + regionSIZE ) ) )
+    {
+        uxReturn = regionSLOW;
+    }
+    else
+    {
+        /* Not in either region. */
+    }
+
+    return uxReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckRegionsEmpty( const char * pcTest )
+{
+    HeapStats_t xStats;
+    UBaseType_t uxRegion;
+    uint32_t ulErrorsBefore = ulErrors;
+
+    for( uxRegion = 0U; uxRegion < 2U; uxRegion++ )
+    {
+        vPortGetHeapRegionStats( uxRegion, &xStats );
+
+        /* Region 0 also holds the controller task, so it is not a single free
+         * block, but its free space is unchanged. */
+        if( ( xStats.xAvailableHeapSpaceInBytes != xInitialFreeBytes[ uxRegion ] ) ||
+            ( xStats.xNumberOfSuccessfulAllocations != xStats.xNumberOfSuccessfulFrees + ( ( uxRegion == 0U ) ? 2U : 0U ) ) ||
+            ( ( uxRegion == 1U ) && ( xStats.xNumberOfFreeBlocks != 1U ) ) ||
+            ( ( uxRegion == 1U ) && ( xStats.xSizeOfLargestFreeBlockInBytes != xInitialFreeBytes[ uxRegion ] ) ) )
+        {
+            ulErrors++;
+        }
+    }
+
+    console_print( "%s test: %lu errors\n", pcTest, ( unsigned long ) ( ulErrors - ulErrorsBefore ) );
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvGetTimeNs( void )
+{
+    struct timespec xNow;
+
+    ( void ) clock_gettime( CLOCK_MONOTONIC, &xNow );
+
+    return ( ( uint64_t ) xNow.tv_sec * 1000000000ULL ) + ( uint64_t ) xNow.tv_nsec;
+}
+/*-----------------------------------------------------------*/
+
+static void prvSelfDeletingTask( void * pvParameters )
+{
+    ( void ) pvParameters;
+
+    vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_HEAP_REGIONS == 1 */
@@ -0,0 +1,711 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+
+
+/******************************************************************************
+ * NOTE 1: The FreeRTOS demo threads will not be running continuously, so
+ * do not expect to get real time behaviour from the FreeRTOS Linux port, or
+ * this demo application.  The absolute numbers reported by this test include
+ * the cost of the Linux port itself, where entering a critical section is a
+ * system call, so only compare them with numbers taken on the same machine.
+ *
+ * NOTE 2: This test is built when USER_DEMO is set to MEMORY_POOL_TEST_DEMO,
+ * which also sets configUSE_MEMORY_POOLS to 1 (see FreeRTOSConfig.h).
+ ******************************************************************************
+ *
+ * main_memory_pool() tests memory pools, and compares them with the pool built
+ * from an array and a queue of pointers that freertos_command_pool.c uses.
+ *
+ * First the controller task checks the basic behaviour of a statically
+ * allocated pool: every block is distinct, aligned and inside the storage, an
+ * empty pool fails an allocation at once without a block time and after the
+ * block time with one, and freed blocks are allocated again.  A dynamically
+ * allocated pool is created and deleted.
+ *
+ * Then two tasks of different priorities block on an empty pool, and the
+ * controller frees one block at a time, checking the higher priority task
+ * gets the first block and the lower priority task the second.
+ *
+ * Then poolPRODUCERS producer tasks allocate messages from a small pool, fill
+ * them in and send pointers to them through a queue to a consumer task, which
+ * checks and frees them, so the producers often block on the empty pool.  The
+ * tick hook allocates and frees blocks of the same pool from an interrupt at
+ * the same time.  The same messages are then sent using a queue of pointers to
+ * free messages in place of the pool.  Finally a single task allocates and
+ * frees poolPAIRS blocks from each kind of pool without blocking.  The times
+ * taken are printed, any error is counted, and the application exits with a
+ * failure status if there are errors.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "memory_pool.h"
+
+/* Local includes. */
+#include "console.h"
+
+#if ( configUSE_MEMORY_POOLS == 1 )
+
+/* The pool used by the basic tests. */
+    #define poolTEST_BLOCKS             ( 4U )
+    #define poolTEST_BLOCK_SIZE         ( 20U )
+
+/* The block time used when checking an allocation times out. */
+    #define poolTEST_BLOCK_TICKS        ( ( TickType_t ) 5 )
+
+/* The message passing test.  The pool is smaller than the queue the messages
+ * are sent through, so the producers block on the pool rather than the
+ * queue. */
+    #define poolPRODUCERS               ( 2U )
+    #define poolMESSAGES                ( 100000UL )
+    #define poolMESSAGE_BLOCKS          ( 8U )
+    #define poolMESSAGE_QUEUE_LENGTH    ( 16U )
+
+/* The number of allocations and frees timed without blocking. */
+    #define poolPAIRS                   ( 1000000UL )
+
+/* The controller runs above the tasks it creates, apart from the waiter it
+ * checks is unblocked first. */
+    #define poolWORKER_PRIORITY         ( tskIDLE_PRIORITY + 1U )
+    #define poolCONTROLLER_PRIORITY     ( tskIDLE_PRIORITY + 2U )
+    #define poolLOW_WAITER_PRIORITY     ( tskIDLE_PRIORITY + 3U )
+    #define poolHIGH_WAITER_PRIORITY    ( tskIDLE_PRIORITY + 4U )
+
+/*-----------------------------------------------------------*/
+
+/* The message sent from the producers to the consumer.  The payload is derived
+ * from the producer and sequence number so the consumer can check it. */
+typedef struct Message
+{
+    uint32_t ulProducer;
+    uint32_t ulSequence;
+    uint8_t ucPayload[ 32 ];
+} Message_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The tasks as described in the comments at the top of this file.
+ */
+static void prvControllerTask( void * pvParameters );
+static void prvWaiterTask( void * pvParameters );
+static void prvProducerTask( void * pvParameters );
+static void prvConsumerTask( void * pvParameters );
+
+/*
+ * The tests run by the controller.
+ */
+static void prvBasicTests( void );
+static void prvWakeOrderTest( void );
+static void prvMessageTest( BaseType_t xUsePool );
+static void prvPairTest( BaseType_t xUsePool );
+
+/*
+ * Take a free message from, or return a message to, the pool or the queue of
+ * free messages.
+ */
+static Message_t * prvGetMessage( BaseType_t xUsePool );
+static void prvReleaseMessage( BaseType_t xUsePool,
+                               Message_t * pxMessage );
+
+/*
+ * Fill in or check the payload of a message.
+ */
+static void prvFillMessage( Message_t * pxMessage );
+static BaseType_t prvCheckMessage( const Message_t * pxMessage );
+
+/*
+ * Tell the controller the calling task has finished, then delete it.
+ */
+static void prvFinish( void );
+
+/*
+ * Returns a monotonic time stamp in nanoseconds.
+ */
+static uint64_t prvGetTimeNs( void );
+
+/*
+ * Called from the tick hook, so from an interrupt.
+ */
+void vMemoryPoolTickHookFunction( void );
+
+/*-----------------------------------------------------------*/
+
+/* The pool of messages, and the array and queue of pointers that are compared
+ * with it. */
+static PoolHandle_t xMessagePool = NULL;
+static StaticPool_t xMessagePoolBuffer;
+static uint8_t ucMessagePoolStorage[ poolMESSAGE_BLOCKS * poolBLOCK_SIZE( sizeof( Message_t ) ) ] __attribute__( ( aligned( portBYTE_ALIGNMENT ) ) );
+static Message_t xMessages[ poolMESSAGE_BLOCKS ];
+static QueueHandle_t xFreeMessageQueue = NULL;
+
+/* The queue messages are sent through. */
+static QueueHandle_t xMessageQueue = NULL;
+
+/* Whether the tasks in the message test use the pool, and whether the tick
+ * hook uses it. */
+static BaseType_t xProducersUsePool = pdFALSE;
+static volatile BaseType_t xTickHookRunning = pdFALSE;
+static volatile uint32_t ulTickHookAllocations = 0UL;
+
+/* The order in which the waiters were unblocked, and the blocks they were
+ * given, which the controller frees. */
+static volatile UBaseType_t uxWaitersUnblocked = 0U;
+static volatile UBaseType_t uxFirstWaiterPriority = 0U;
+static void * volatile pvWaiterBlocks[ 2 ];
+
+static TaskHandle_t xControllerTask = NULL;
+
+/* The number of errors found. */
+static volatile uint32_t ulErrors = 0UL;
+
+/*-----------------------------------------------------------*/
+
+/*** SEE THE COMMENTS AT THE TOP OF THIS FILE ***/
+void main_memory_pool( void )
+{
+    UBaseType_t uxMessage;
+    Message_t * pxMessage;
+
+    xMessagePool = xPoolCreateStatic( poolMESSAGE_BLOCKS, sizeof( Message_t ), ucMessagePoolStorage, &xMessagePoolBuffer );
+    xMessageQueue = xQueueCreate( poolMESSAGE_QUEUE_LENGTH, sizeof( Message_t * ) );
+    xFreeMessageQueue = xQueueCreate( poolMESSAGE_BLOCKS, sizeof( Message_t * ) );
+    configASSERT( ( xMessagePool != NULL ) && ( xMessageQueue != NULL ) && ( xFreeMessageQueue != NULL ) );
+
+    /* Fill the queue of free messages, as freertos_command_pool.c does. */
+    for( uxMessage = 0U; uxMessage < poolMESSAGE_BLOCKS; uxMessage++ )
+    {
+        pxMessage = &( xMessages[ uxMessage ] );
+        ( void ) xQueueSend( xFreeMessageQueue, &pxMessage, 0U );
+    }
+
+    xTaskCreate( prvControllerTask, "Control", configMINIMAL_STACK_SIZE * 2U, NULL, poolCONTROLLER_PRIORITY, &xControllerTask );
+
+    vTaskStartScheduler();
+}
+/*-----------------------------------------------------------*/
+
+static void prvControllerTask( void * pvParameters )
+{
+    ( void ) pvParameters;
+
+    prvBasicTests();
+    prvWakeOrderTest();
+
+    console_print( "test, messages, elapsed (ms), ns per message, tick hook allocations\n" );
+    prvMessageTest( pdTRUE );
+    prvMessageTest( pdFALSE );
+
+    console_print( "test, pairs, ns per allocate and free\n" );
+    prvPairTest( pdTRUE );
+    prvPairTest( pdFALSE );
+
+    console_print( "errors\n%lu\n", ( unsigned long ) ulErrors );
+
+    if( ulErrors != 0UL )
+    {
+        exit( EXIT_FAILURE );
+    }
+
+    exit( EXIT_SUCCESS );
+}
+/*-----------------------------------------------------------*/
+
+static void prvBasicTests( void )
+{
+    static StaticPool_t xPoolBuffer;
+    static uint8_t ucStorage[ poolTEST_BLOCKS * poolBLOCK_SIZE( poolTEST_BLOCK_SIZE ) ] __attribute__( ( aligned( portBYTE_ALIGNMENT ) ) );
+    PoolHandle_t xPool;
+    uint8_t * pucBlocks[ poolTEST_BLOCKS ];
+    UBaseType_t uxBlock, uxOther;
+    TickType_t xStartTick;
+
+    xPool = xPoolCreateStatic( poolTEST_BLOCKS, poolTEST_BLOCK_SIZE, ucStorage, &xPoolBuffer );
+
+    if( ( xPool == NULL ) || ( uxPoolGetFreeBlocks( xPool ) != poolTEST_BLOCKS ) )
+    {
+        ulErrors++;
+        return;
+    }
+
+    /* Every block is distinct, aligned and inside the storage. */
+    for( uxBlock = 0U; uxBlock < poolTEST_BLOCKS; uxBlock++ )
+    {
+        pucBlocks[ uxBlock ] = pvPoolAlloc( xPool, 0U );
+
+        if( ( pucBlocks[ uxBlock ] == NULL ) ||
+            ( pucBlocks[ uxBlock ] < ucStorage ) ||
+            ( ( pucBlocks[ uxBlock ] + poolTEST_BLOCK_SIZE ) > ( ucStorage + sizeof( ucStorage ) ) ) ||
+            ( ( ( ( uintptr_t ) pucBlocks[ uxBlock ] ) & portBYTE_ALIGNMENT_MASK ) != 0U ) )
+        {
+            ulErrors++;
+            return;
+        }
+
+        ( void ) memset( pucBlocks[ uxBlock ], ( int ) uxBlock, poolTEST_BLOCK_SIZE );
+
+        for( uxOther = 0U; uxOther < uxBlock; uxOther++ )
+        {
+            if( pucBlocks[ uxOther ] == pucBlocks[ uxBlock ] )
+            {
+                ulErrors++;
+            }
+        }
+    }
+
+    /* Writing to one block must not have changed another. */
+    for( uxBlock = 0U; uxBlock < poolTEST_BLOCKS; uxBlock++ )
+    {
+        for( uxOther = 0U; uxOther < poolTEST_BLOCK_SIZE; uxOther++ )
+        {
+            if( pucBlocks[ uxBlock ][ uxOther ] != ( uint8_t ) uxBlock )
+            {
+                ulErrors++;
+                break;
+            }
+        }
+    }
+
+    /* The pool is empty, so allocations fail at once without a block time,
+     * and after the block time with one. */
+    if( ( uxPoolGetFreeBlocks( xPool ) != 0U ) || ( pvPoolAlloc( xPool, 0U ) != NULL ) )
+    {
+        ulErrors++;
+    }
+
+    xStartTick = xTaskGetTickCount();
+
+    if( ( pvPoolAlloc( xPool, poolTEST_BLOCK_TICKS ) != NULL ) ||
+        ( ( xTaskGetTickCount() - xStartTick ) < poolTEST_BLOCK_TICKS ) )
+    {
+        ulErrors++;
+    }
+
+    /* A freed block is the next one allocated. */
+    vPoolFree( xPool, pucBlocks[ 2 ] );
+
+    if( ( uxPoolGetFreeBlocks( xPool ) != 1U ) || ( pvPoolAlloc( xPool, 0U ) != pucBlocks[ 2 ] ) )
+    {
+        ulErrors++;
+    }
+
+    for( uxBlock = 0U; uxBlock < poolTEST_BLOCKS; uxBlock++ )
+    {
+        vPoolFree( xPool, pucBlocks[ uxBlock ] );
+    }
+
+    if( uxPoolGetFreeBlocks( xPool ) != poolTEST_BLOCKS )
+    {
+        ulErrors++;
+    }
+
+    vPoolDelete( xPool );
+
+    /* A dynamically allocated pool. */
+    xPool = xPoolCreate( poolTEST_BLOCKS, poolTEST_BLOCK_SIZE );
+
+    if( xPool == NULL )
+    {
+        ulErrors++;
+    }
+    else
+    {
+        pucBlocks[ 0 ] = pvPoolAlloc( xPool, 0U );
+
+        if( ( pucBlocks[ 0 ] == NULL ) || ( ( ( ( uintptr_t ) pucBlocks[ 0 ] ) & portBYTE_ALIGNMENT_MASK ) != 0U ) )
+        {
+            ulErrors++;
+        }
+        else
+        {
+            ( void ) memset( pucBlocks[ 0 ], 0xa5, poolTEST_BLOCK_SIZE );
+            vPoolFree( xPool, pucBlocks[ 0 ] );
+        }
+
+        vPoolDelete( xPool );
+    }
+
+    console_print( "basic tests: %lu errors\n", ( unsigned long ) ulErrors );
+}
+/*-----------------------------------------------------------*/
+
+static void prvWakeOrderTest( void )
+{
+    Message_t * pxTaken[ poolMESSAGE_BLOCKS ];
+    UBaseType_t uxBlock;
+
+    /* Empty the pool, then create the waiters, which run at once as they have
+     * a higher priority than the controller, and block on the pool. */
+    for( uxBlock = 0U; uxBlock < poolMESSAGE_BLOCKS; uxBlock++ )
+    {
+        pxTaken[ uxBlock ] = pvPoolAlloc( xMessagePool, 0U );
+    }
+
+    xTaskCreate( prvWaiterTask, "LowWait", configMINIMAL_STACK_SIZE, NULL, poolLOW_WAITER_PRIORITY, NULL );
+    xTaskCreate( prvWaiterTask, "HighWait", configMINIMAL_STACK_SIZE, NULL, poolHIGH_WAITER_PRIORITY, NULL );
+
+    if( uxWaitersUnblocked != 0U )
+    {
+        ulErrors++;
+    }
+
+    /* Freeing a block unblocks the higher priority waiter, which preempts the
+     * controller. */
+    vPoolFree( xMessagePool, pxTaken[ 0 ] );
+
+    if( ( uxWaitersUnblocked != 1U ) || ( uxFirstWaiterPriority != poolHIGH_WAITER_PRIORITY ) )
+    {
+        ulErrors++;
+    }
+
+    vPoolFree( xMessagePool, pxTaken[ 1 ] );
+
+    if( uxWaitersUnblocked != 2U )
+    {
+        ulErrors++;
+    }
+
+    /* The waiters were given the blocks freed above. */
+    if( ( pvWaiterBlocks[ 0 ] != pxTaken[ 0 ] ) || ( pvWaiterBlocks[ 1 ] != pxTaken[ 1 ] ) )
+    {
+        ulErrors++;
+    }
+
+    for( uxBlock = 0U; uxBlock < 2U; uxBlock++ )
+    {
+        if( pvWaiterBlocks[ uxBlock ] != NULL )
+        {
+            vPoolFree( xMessagePool, pvWaiterBlocks[ uxBlock ] );
+        }
+    }
+
+    for( uxBlock = 2U; uxBlock < poolMESSAGE_BLOCKS; uxBlock++ )
+    {
+        vPoolFree( xMessagePool, pxTaken[ uxBlock ] );
+    }
+
+    if( uxPoolGetFreeBlocks( xMessagePool ) != poolMESSAGE_BLOCKS )
+    {
+        ulErrors++;
+    }
+
+    console_print( "wake order test: %lu errors\n", ( unsigned long ) ulErrors );
+}
+/*-----------------------------------------------------------*/
+
+static void prvWaiterTask( void * pvParameters )
+{
+    void * pvBlock;
+
+    ( void ) pvParameters;
+
+    pvBlock = pvPoolAlloc( xMessagePool, portMAX_DELAY );
+
+    if( pvBlock == NULL )
+    {
+        ulErrors++;
+    }
+    else
+    {
+        if( uxWaitersUnblocked == 0U )
+        {
+            uxFirstWaiterPriority = uxTaskPriorityGet( NULL );
+        }
+
+        /* Keep the block, so freeing it does not unblock the other waiter
+         * before the controller checks the order. */
+        pvWaiterBlocks[ uxWaitersUnblocked ] = pvBlock;
+        uxWaitersUnblocked++;
+    }
+
+    vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvMessageTest( BaseType_t xUsePool )
+{
+    uint32_t ulFinished = 0UL;
+    uint64_t ullStartNs, ullElapsedNs;
+    uint32_t ulProducer;
+
+    xProducersUsePool = xUsePool;
+    ulTickHookAllocations = 0UL;
+    xTickHookRunning = xUsePool;
+    ullStartNs = prvGetTimeNs();
+
+    /* The tasks run below the controller, so none of them starts until the
+     * controller blocks. */
+    for( ulProducer = 0UL; ulProducer < poolPRODUCERS; ulProducer++ )
+    {
+        xTaskCreate( prvProducerTask, "Prod", configMINIMAL_STACK_SIZE, ( void * ) ( uintptr_t ) ulProducer, poolWORKER_PRIORITY, NULL );
+    }
+
+    xTaskCreate( prvConsumerTask, "Cons", configMINIMAL_STACK_SIZE, NULL, poolWORKER_PRIORITY, NULL );
+
+    while( ulFinished < ( poolPRODUCERS + 1U ) )
+    {
+        ulFinished += ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+    }
+
+    ullElapsedNs = prvGetTimeNs() - ullStartNs;
+    xTickHookRunning = pdFALSE;
+
+    /* Let the tick hook return the block it may hold. */
+    vTaskDelay( 2 );
+
+    if( ( xUsePool != pdFALSE ) && ( uxPoolGetFreeBlocks( xMessagePool ) != poolMESSAGE_BLOCKS ) )
+    {
+        ulErrors++;
+    }
+
+    if( ( xUsePool == pdFALSE ) && ( uxQueueMessagesWaiting( xFreeMessageQueue ) != poolMESSAGE_BLOCKS ) )
+    {
+        ulErrors++;
+    }
+
+    console_print( "%s, %lu, %llu, %.1f, %lu\n",
+                   ( xUsePool != pdFALSE ) ? "messages from memory pool" : "messages from queue of pointers",
+                   ( unsigned long ) ( poolPRODUCERS * poolMESSAGES ),
+                   ( unsigned long long ) ( ullElapsedNs / 1000000ULL ),
+                   ( double ) ullElapsedNs / ( double ) ( poolPRODUCERS * poolMESSAGES ),
+                   ( unsigned long ) ulTickHookAllocations );
+}
+/*-----------------------------------------------------------*/
+
+static void prvProducerTask( void * pvParameters )
+{
+    uint32_t ulProducer = ( uint32_t ) ( uintptr_t ) pvParameters;
+    uint32_t ulSequence;
+    Message_t * pxMessage;
+
+    for( ulSequence = 0UL; ulSequence < poolMESSAGES; ulSequence++ )
+    {
+        pxMessage = prvGetMessage( xProducersUsePool );
+
+        if( pxMessage == NULL )
+        {
+            ulErrors++;
+            break;
+        }
+
+        pxMessage->ulProducer = ulProducer;
+        pxMessage->ulSequence = ulSequence;
+        prvFillMessage( pxMessage );
+        ( void ) xQueueSend( xMessageQueue, &pxMessage, portMAX_DELAY );
+    }
+
+    prvFinish();
+}
+/*-----------------------------------------------------------*/
+
+static void prvConsumerTask( void * pvParameters )
+{
+    uint32_t ulNextSequence[ poolPRODUCERS ] = { 0UL };
+    uint32_t ulReceived;
+    Message_t * pxMessage;
+
+    ( void ) pvParameters;
+
+    for( ulReceived = 0UL; ulReceived < ( poolPRODUCERS * poolMESSAGES ); ulReceived++ )
+    {
+        ( void ) xQueueReceive( xMessageQueue, &pxMessage, portMAX_DELAY );
+
+        /* Each producer's messages arrive intact and in order. */
+        if( ( pxMessage->ulProducer >= poolPRODUCERS ) ||
+            ( pxMessage->ulSequence != ulNextSequence[ pxMessage->ulProducer ] ) ||
+            ( prvCheckMessage( pxMessage ) == pdFALSE ) )
+        {
+            ulErrors++;
+        }
+        else
+        {
+            ulNextSequence[ pxMessage->ulProducer ]++;
+        }
+
+        prvReleaseMessage( xProducersUsePool, pxMessage );
+    }
+
+    prvFinish();
+}
+/*-----------------------------------------------------------*/
+
+static void prvPairTest( BaseType_t xUsePool )
+{
+    Message_t * pxMessage;
+    uint64_t ullStartNs, ullElapsedNs;
+    uint32_t ulPair;
+
+    ullStartNs = prvGetTimeNs();
+
+    for( ulPair = 0UL; ulPair < poolPAIRS; ulPair++ )
+    {
+        pxMessage = prvGetMessage( xUsePool );
+
+        if( pxMessage == NULL )
+        {
+            ulErrors++;
+            break;
+        }
+
+        prvReleaseMessage( xUsePool, pxMessage );
+    }
+
+    ullElapsedNs = prvGetTimeNs() - ullStartNs;
+
+    console_print( "%s, %lu, %.1f\n",
+                   ( xUsePool != pdFALSE ) ? "memory pool" : "queue of pointers",
+                   ( unsigned long ) poolPAIRS,
+                   ( double ) ullElapsedNs / ( double ) poolPAIRS );
+}
+/*-----------------------------------------------------------*/
+
+static Message_t * prvGetMessage( BaseType_t xUsePool )
+{
+    Message_t * pxMessage = NULL;
+
+    if( xUsePool != pdFALSE )
+    {
+        pxMessage = pvPoolAlloc( xMessagePool, portMAX_DELAY );
+    }
+    else
+    {
+        ( void ) xQueueReceive( xFreeMessageQueue, &pxMessage, portMAX_DELAY );
+    }
+
+    return pxMessage;
+}
+/*-----------------------------------------------------------*/
+
+static void prvReleaseMessage( BaseType_t xUsePool,
+                               Message_t * pxMessage )
+{
+    if( xUsePool != pdFALSE )
+    {
+        vPoolFree( xMessagePool, pxMessage );
+    }
+    else
+    {
+        ( void ) xQueueSend( xFreeMessageQueue, &pxMessage, 0U );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvFillMessage( Message_t * pxMessage )
+{
+    size_t x;
+
+    for( x = 0U; x < sizeof( pxMessage->ucPayload ); x++ )
+    {
+        pxMessage->ucPayload[ x ] = ( uint8_t ) ( pxMessage->ulSequence + ( pxMessage->ulProducer * 7UL ) + x );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvCheckMessage( const Message_t * pxMessage )
+{
+    BaseType_t xReturn = pdTRUE;
+    size_t x;
+
+    for( x = 0U; x < sizeof( pxMessage->ucPayload ); x++ )
+    {
+        if( pxMessage->ucPayload[ x ] != ( uint8_t ) ( pxMessage->ulSequence + ( pxMessage->ulProducer * 7UL ) + x ) )
+        {
+            xReturn = pdFALSE;
+            break;
+        }
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvFinish( void )
+{
+    xTaskNotifyGive( xControllerTask );
+    vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvGetTimeNs( void )
+{
+    struct timespec xNow;
+
+    ( void ) clock_gettime( CLOCK_MONOTONIC, &xNow );
+
+    return ( ( uint64_t ) xNow.tv_sec * 1000000000ULL ) + ( uint64_t ) xNow.tv_nsec;
+}
+/*-----------------------------------------------------------*/
+
+void vMemoryPoolTickHookFunction( void )
+{
+    static uint8_t * pucBlock = NULL;
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    size_t x;
+
+    /* Hold a block for one tick, then free it, so the pool is used from an
+     * interrupt while the tasks use it. */
+    if( pucBlock != NULL )
+    {
+        for( x = 0U; x < sizeof( Message_t ); x++ )
+        {
+            if( pucBlock[ x ] != ( uint8_t ) 0x5a )
+            {
+                ulErrors++;
+                break;
+            }
+        }
+
+        vPoolFreeFromISR( xMessagePool, pucBlock, &xHigherPriorityTaskWoken );
+        pucBlock = NULL;
+    }
+    else if( xTickHookRunning != pdFALSE )
+    {
+        pucBlock = pvPoolAllocFromISR( xMessagePool );
+
+        if( pucBlock != NULL )
+        {
+            ( void ) memset( pucBlock, 0x5a, sizeof( Message_t ) );
+            ulTickHookAllocations++;
+        }
+    }
+    else
+    {
+        /* The tick hook is not in use. */
+    }
+
+    portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_MEMORY_POOLS == 1 */
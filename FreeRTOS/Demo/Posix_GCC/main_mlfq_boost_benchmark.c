@@ -0,0 +1,253 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/******************************************************************************
+ * NOTE 1: The FreeRTOS demo threads will not be running continuously, so
+ * do not expect to get real time behaviour from the FreeRTOS Linux port, or
+ * this demo application.  The absolute numbers reported by this benchmark
+ * include the cost of the Linux port itself, and the largest values can be
+ * inflated by the host, so only compare them with numbers taken on the same
+ * machine.
+ *
+ * NOTE 2: This file is only built into a working application when USER_DEMO is
+ * set to MLFQ_BOOST_BENCHMARK_DEMO, which builds the kernel with
+ * configUSE_MLFQ_SCHEDULER set to 1 and times xTaskIncrementTick() through its
+ * trace macros (see FreeRTOSConfig.h).
+ ******************************************************************************
+ *
+ * main_mlfq_boost_benchmark() measures how long the tick interrupt takes while
+ * the MLFQ scheduler has many ready tasks, which is dominated by the periodic
+ * priority boost if the boost moves every ready task in a single tick.
+ *
+ * boostNUM_SPINNERS spinner tasks that never block are created on the top
+ * level.  They use up their time slices and are demoted, so when each boost
+ * happens almost all of them are on the lower levels.  boostNUM_SHARERS tasks
+ * that are not managed by the MLFQ scheduler are created first on the lowest
+ * level, ahead of the demoted spinners in its ready list, which shows whether
+ * the boost cost depends on how many other tasks share a level.  After a warm
+ * up period the duration of every tick is recorded for boostMEASURED_TICKS
+ * ticks, then the number of ticks, the mean, the 99th and 99.9th percentiles,
+ * and the largest duration are printed in microseconds and the application
+ * exits.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Local includes. */
+#include "console.h"
+
+#if ( configUSE_MLFQ_SCHEDULER == 1 )
+
+/* The number of spinner tasks, all of which are ready throughout the test. */
+    #define boostNUM_SPINNERS        ( 256U )
+
+/* The number of tasks created with xTaskCreate() on the lowest MLFQ level. */
+    #define boostNUM_SHARERS         ( 256U )
+
+/* The ticks allowed for the spinners to spread over the levels before the
+ * measurement starts, and the number of ticks measured. */
+    #define boostWARM_UP_TICKS       ( configMLFQ_LOOP_TIME_SLICE * 2U )
+    #define boostMEASURED_TICKS      ( configMLFQ_LOOP_TIME_SLICE * 10U )
+
+/* Tick durations are counted in buckets of one microsecond.  Longer ticks are
+ * counted in the last bucket, but still update the largest duration. */
+    #define boostHISTOGRAM_BUCKETS   ( 2000U )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The tasks as described in the comments at the top of this file.
+ */
+    static void prvControllerTask( void * pvParameters );
+    static void prvSpinnerTask( void * pvParameters );
+
+/*
+ * Returns a monotonic time stamp in nanoseconds.
+ */
+    static uint64_t prvGetTimeNs( void );
+
+/*
+ * Returns the duration in microseconds below which the given parts per
+ * thousand of the measured ticks completed.
+ */
+    static uint32_t prvPercentile( uint32_t ulPartsPerThousand );
+
+/*
+ * Called by the traceENTER_xTaskIncrementTick() and
+ * traceRETURN_xTaskIncrementTick() macros defined in FreeRTOSConfig.h.
+ */
+    void vBoostBenchmarkTickEnter( void );
+    void vBoostBenchmarkTickExit( void );
+
+/*-----------------------------------------------------------*/
+
+/* Set while tick durations are being recorded. */
+    static volatile BaseType_t xRecording = pdFALSE;
+
+/* The results, written from the tick interrupt. */
+    static uint64_t ullTickStartNs = 0ULL;
+    static uint64_t ullTotalNs = 0ULL;
+    static uint64_t ullLargestNs = 0ULL;
+    static uint32_t ulTicksMeasured = 0UL;
+    static uint32_t ulHistogram[ boostHISTOGRAM_BUCKETS ];
+
+/*-----------------------------------------------------------*/
+
+/*** SEE THE COMMENTS AT THE TOP OF THIS FILE ***/
+    void main_mlfq_boost_benchmark( void )
+    {
+        UBaseType_t ux;
+
+        for( ux = 0U; ux < boostNUM_SHARERS; ux++ )
+        {
+            xTaskCreate( prvSpinnerTask, "Share", configMINIMAL_STACK_SIZE, NULL, configMLFQ_LOWEST_PRIORITY, NULL );
+        }
+
+        for( ux = 0U; ux < boostNUM_SPINNERS; ux++ )
+        {
+            xTaskCreateMLFQ( prvSpinnerTask, "Spin", configMINIMAL_STACK_SIZE, NULL, NULL );
+        }
+
+        xTaskCreate( prvControllerTask, "Control", configMINIMAL_STACK_SIZE * 2U, NULL, configMAX_PRIORITIES - 1U, NULL );
+
+        vTaskStartScheduler();
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvControllerTask( void * pvParameters )
+    {
+        ( void ) pvParameters;
+
+        vTaskDelay( boostWARM_UP_TICKS );
+        xRecording = pdTRUE;
+        vTaskDelay( boostMEASURED_TICKS );
+        xRecording = pdFALSE;
+
+        console_print( "MLFQ boost benchmark: %u ready tasks, %u other tasks on the lowest level, %u levels, boost every %u ticks\n",
+                       ( unsigned ) boostNUM_SPINNERS,
+                       ( unsigned ) boostNUM_SHARERS,
+                       ( unsigned ) ( configMAX_PRIORITIES - 1U ),
+                       ( unsigned ) configMLFQ_LOOP_TIME_SLICE );
+        console_print( "ticks, mean (us), p99 (us), p99.9 (us), max (us)\n" );
+        console_print( "%lu, %.2f, %lu, %lu, %.2f\n",
+                       ( unsigned long ) ulTicksMeasured,
+                       ( ulTicksMeasured != 0UL ) ? ( ( double ) ullTotalNs / ( double ) ulTicksMeasured ) / 1000.0 : 0.0,
+                       ( unsigned long ) prvPercentile( 990UL ),
+                       ( unsigned long ) prvPercentile( 999UL ),
+                       ( double ) ullLargestNs / 1000.0 );
+
+        /* Exit the process directly rather than ending the scheduler, so the
+         * threads of the spinner tasks do not have to be torn down one by one. */
+        exit( EXIT_SUCCESS );
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvSpinnerTask( void * pvParameters )
+    {
+        ( void ) pvParameters;
+
+        for( ; ; )
+        {
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static uint32_t prvPercentile( uint32_t ulPartsPerThousand )
+    {
+        uint64_t ullTarget, ullCount = 0ULL;
+        uint32_t ulBucket;
+
+        /* Round up, so at least one tick is counted. */
+        ullTarget = ( ( ( uint64_t ) ulTicksMeasured * ulPartsPerThousand ) + 999ULL ) / 1000ULL;
+
+        for( ulBucket = 0U; ulBucket < boostHISTOGRAM_BUCKETS; ulBucket++ )
+        {
+            ullCount += ulHistogram[ ulBucket ];
+
+            if( ullCount >= ullTarget )
+            {
+                break;
+            }
+        }
+
+        /* Bucket n holds durations from n to n + 1 microseconds. */
+        return ulBucket + 1U;
+    }
+/*-----------------------------------------------------------*/
+
+    void vBoostBenchmarkTickEnter( void )
+    {
+        ullTickStartNs = prvGetTimeNs();
+    }
+/*-----------------------------------------------------------*/
+
+    void vBoostBenchmarkTickExit( void )
+    {
+        uint64_t ullDurationNs;
+        uint64_t ullBucket;
+
+        if( xRecording != pdFALSE )
+        {
+            ullDurationNs = prvGetTimeNs() - ullTickStartNs;
+            ullTotalNs += ullDurationNs;
+            ulTicksMeasured++;
+
+            if( ullDurationNs > ullLargestNs )
+            {
+                ullLargestNs = ullDurationNs;
+            }
+
+            ullBucket = ullDurationNs / 1000ULL;
+
+            if( ullBucket >= boostHISTOGRAM_BUCKETS )
+            {
+                ullBucket = boostHISTOGRAM_BUCKETS - 1U;
+            }
+
+            ulHistogram[ ullBucket ]++;
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static uint64_t prvGetTimeNs( void )
+    {
+        struct timespec xNow;
+
+        /* clock_gettime() is async-signal-safe, so can be called from the tick
+         * interrupt, which the Linux port implements as a signal handler. */
+        ( void ) clock_gettime( CLOCK_MONOTONIC, &xNow );
+
+        return ( ( uint64_t ) xNow.tv_sec * 1000000000ULL ) + ( uint64_t ) xNow.tv_nsec;
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_MLFQ_SCHEDULER == 1 */
@@ -0,0 +1,270 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/******************************************************************************
+ * NOTE 1: This file is only built into a working application when USER_DEMO is
+ * set to MLFQ_FLOOD_TEST_DEMO, which builds the kernel with
+ * configUSE_MLFQ_SCHEDULER set to 1 (see FreeRTOSConfig.h).
+ *
+ * NOTE 2: The FreeRTOS demo threads will not be running continuously, so the
+ * number of ticks each task runs for is not repeatable.  The checks made by
+ * this test do not depend on it.
+ ******************************************************************************
+ *
+ * main_mlfq_flood_test() is a regression test for the MLFQ scheduler's
+ * selection of the highest populated level.  Tasks are created on the top
+ * level, and spread over every level from 1 to configMAX_PRIORITIES - 1 as they
+ * are demoted:
+ *
+ * Spinner tasks never block, so they use up their time slices and are demoted
+ * level by level until the periodic boost moves them back to the top level.
+ *
+ * Sleeper tasks block for a few ticks at a time, so they are woken by the tick
+ * interrupt while spinners are running on lower levels, often in the same tick
+ * in which a spinner is demoted.
+ *
+ * Each time a spinner or sleeper runs it suspends the scheduler and checks
+ * that no task on a higher level is in the Ready state, as such a task should
+ * have been selected instead.  At the end of the test every sleeper must have
+ * run, the spinners must have been both demoted and boosted, and no check must
+ * have failed.  The result is printed and the application exits with
+ * EXIT_SUCCESS or EXIT_FAILURE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Local includes. */
+#include "console.h"
+
+#if ( configUSE_MLFQ_SCHEDULER == 1 )
+
+/* The MLFQ levels are the task priorities 1 to configMAX_PRIORITIES - 1. */
+    #define floodLOWEST_LEVEL          ( 1U )
+    #define floodNUM_LEVELS            ( configMAX_PRIORITIES - 1U )
+
+/* The number of spinner tasks created for each level. */
+    #define floodSPINNERS_PER_LEVEL    ( 2U )
+
+/* The total number of tasks that are checked. */
+    #define floodNUM_TASKS             ( floodNUM_LEVELS * ( floodSPINNERS_PER_LEVEL + 1U ) )
+
+/* The number of ticks for which the test runs. */
+    #define floodTEST_TICKS            ( pdMS_TO_TICKS( 4000 ) )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The tasks as described in the comments at the top of this file.
+ */
+    static void prvControllerTask( void * pvParameters );
+    static void prvSpinnerTask( void * pvParameters );
+    static void prvSleeperTask( void * pvParameters );
+
+/*
+ * Returns pdFAIL if a task on a higher level than the calling task is ready.
+ */
+    static BaseType_t prvCheckNoHigherLevelReady( void );
+
+/*-----------------------------------------------------------*/
+
+    static TaskHandle_t xTasks[ floodNUM_TASKS ];
+    static UBaseType_t uxNumTasks = 0U;
+
+/* The number of times each sleeper has run, indexed by the number of ticks it
+ * sleeps for. */
+    static volatile uint32_t ulSleeperRuns[ configMAX_PRIORITIES ];
+
+/* Set when a spinner sees that its level has been lowered or raised. */
+    static volatile BaseType_t xDemotionSeen = pdFALSE;
+    static volatile BaseType_t xBoostSeen = pdFALSE;
+
+/* The number of failed checks. */
+    static volatile uint32_t ulViolations = 0UL;
+
+/*-----------------------------------------------------------*/
+
+/*** SEE THE COMMENTS AT THE TOP OF THIS FILE ***/
+    void main_mlfq_flood_test( void )
+    {
+        UBaseType_t uxLevel, ux;
+
+        for( uxLevel = floodLOWEST_LEVEL; uxLevel <= floodNUM_LEVELS; uxLevel++ )
+        {
+            for( ux = 0U; ux < floodSPINNERS_PER_LEVEL; ux++ )
+            {
+                xTaskCreateMLFQ( prvSpinnerTask, "Spin", configMINIMAL_STACK_SIZE, NULL, &( xTasks[ uxNumTasks ] ) );
+                uxNumTasks++;
+            }
+
+            xTaskCreateMLFQ( prvSleeperTask, "Sleep", configMINIMAL_STACK_SIZE, ( void * ) uxLevel, &( xTasks[ uxNumTasks ] ) );
+            uxNumTasks++;
+        }
+
+        xTaskCreate( prvControllerTask, "Control", configMINIMAL_STACK_SIZE * 2U, NULL, configMAX_PRIORITIES - 1U, NULL );
+
+        vTaskStartScheduler();
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvControllerTask( void * pvParameters )
+    {
+        UBaseType_t uxLevel;
+        uint32_t ulFailures, ulRuns[ configMAX_PRIORITIES ];
+        BaseType_t xDemoted, xBoosted;
+
+        ( void ) pvParameters;
+
+        vTaskDelay( floodTEST_TICKS );
+
+        /* Stop the other tasks changing the results while they are read.  The
+         * results are printed after the scheduler is resumed, as printing
+         * takes a mutex. */
+        vTaskSuspendAll();
+        {
+            ulFailures = ulViolations;
+
+            for( uxLevel = floodLOWEST_LEVEL; uxLevel <= floodNUM_LEVELS; uxLevel++ )
+            {
+                ulRuns[ uxLevel ] = ulSleeperRuns[ uxLevel ];
+            }
+
+            xDemoted = xDemotionSeen;
+            xBoosted = xBoostSeen;
+        }
+        ( void ) xTaskResumeAll();
+
+        if( ulFailures != 0UL )
+        {
+            console_print( "MLFQ flood test: a lower level ran while a higher level was ready %lu times\n", ( unsigned long ) ulFailures );
+        }
+
+        for( uxLevel = floodLOWEST_LEVEL; uxLevel <= floodNUM_LEVELS; uxLevel++ )
+        {
+            if( ulRuns[ uxLevel ] == 0UL )
+            {
+                console_print( "MLFQ flood test: the sleeper that sleeps for %u ticks never ran\n", ( unsigned ) uxLevel );
+                ulFailures++;
+            }
+        }
+
+        if( ( xDemoted == pdFALSE ) || ( xBoosted == pdFALSE ) )
+        {
+            console_print( "MLFQ flood test: spinners were not both demoted and boosted\n" );
+            ulFailures++;
+        }
+
+        console_print( "MLFQ flood test: %s, %u tasks on %u levels, %lu failures\n",
+                       ( ulFailures == 0UL ) ? "PASS" : "FAIL",
+                       ( unsigned ) uxNumTasks,
+                       ( unsigned ) floodNUM_LEVELS,
+                       ( unsigned long ) ulFailures );
+
+        /* Exit the process directly rather than ending the scheduler. */
+        exit( ( ulFailures == 0UL ) ? EXIT_SUCCESS : EXIT_FAILURE );
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvCheckNoHigherLevelReady( void )
+    {
+        BaseType_t xReturn = pdPASS;
+        UBaseType_t ux, uxOwnLevel;
+
+        /* With the scheduler suspended the levels cannot change during the
+         * check. */
+        vTaskSuspendAll();
+        {
+            uxOwnLevel = uxTaskPriorityGet( NULL );
+
+            for( ux = 0U; ux < uxNumTasks; ux++ )
+            {
+                if( ( eTaskGetState( xTasks[ ux ] ) == eReady ) &&
+                    ( uxTaskPriorityGet( xTasks[ ux ] ) > uxOwnLevel ) )
+                {
+                    xReturn = pdFAIL;
+                }
+            }
+        }
+        ( void ) xTaskResumeAll();
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvSpinnerTask( void * pvParameters )
+    {
+        UBaseType_t uxLevel, uxLastLevel = uxTaskPriorityGet( NULL );
+
+        ( void ) pvParameters;
+
+        for( ; ; )
+        {
+            if( prvCheckNoHigherLevelReady() != pdPASS )
+            {
+                ulViolations++;
+            }
+
+            uxLevel = uxTaskPriorityGet( NULL );
+
+            if( uxLevel < uxLastLevel )
+            {
+                xDemotionSeen = pdTRUE;
+            }
+            else if( uxLevel > uxLastLevel )
+            {
+                xBoostSeen = pdTRUE;
+            }
+
+            uxLastLevel = uxLevel;
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvSleeperTask( void * pvParameters )
+    {
+        const UBaseType_t uxSleepTicks = ( UBaseType_t ) pvParameters;
+
+        for( ; ; )
+        {
+            /* Each sleeper sleeps for a different number of ticks, so the
+             * sleepers wake at different times. */
+            vTaskDelay( ( TickType_t ) uxSleepTicks );
+
+            if( prvCheckNoHigherLevelReady() != pdPASS )
+            {
+                ulViolations++;
+            }
+
+            ulSleeperRuns[ uxSleepTicks ]++;
+        }
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_MLFQ_SCHEDULER == 1 */
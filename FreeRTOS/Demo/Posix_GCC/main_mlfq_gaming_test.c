@@ -0,0 +1,249 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/******************************************************************************
+ * NOTE 1: This file is only built into a working application when USER_DEMO is
+ * set to MLFQ_GAMING_TEST_DEMO, which builds the kernel with
+ * configUSE_MLFQ_SCHEDULER and configMLFQ_USE_RUN_TIME_ACCOUNTING set to 1 (see
+ * FreeRTOSConfig.h).
+ *
+ * NOTE 2: The FreeRTOS demo threads will not be running continuously, so the
+ * time each task runs for is not exactly repeatable.  The checks made by this
+ * test allow for that.
+ ******************************************************************************
+ *
+ * main_mlfq_gaming_test() checks that the MLFQ scheduler charges tasks for the
+ * processor time they use, rather than for the tick interrupts that happen to
+ * occur while they are running.
+ *
+ * The "gamer" task wakes at each tick, spins for a fifth of the tick period,
+ * then blocks until the next tick.  It is rarely running when a tick interrupt
+ * occurs, so if it were only charged at tick interrupts it would stay near the
+ * top level however much processor time it used.
+ *
+ * The "interactive" task wakes every gamingINTERACTIVE_PERIOD ticks and runs
+ * for a few microseconds.
+ *
+ * The "fixed" task is created by xTaskCreate() at the idle priority rather
+ * than by xTaskCreateMLFQ(), so the MLFQ scheduler must leave its priority
+ * alone.
+ *
+ * A controller task, which is also not an MLFQ task, samples the level of each
+ * task at every tick.  The gamer must reach the lowest level and be boosted
+ * back up again, the interactive task must always be on a higher level than
+ * the lowest level reached by the gamer, and the fixed task must stay at the
+ * idle priority.  The result is printed and the application exits with
+ * EXIT_SUCCESS or EXIT_FAILURE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Local includes. */
+#include "console.h"
+
+#if ( configUSE_MLFQ_SCHEDULER == 1 ) && ( configMLFQ_USE_RUN_TIME_ACCOUNTING == 1 )
+
+/* The time the gamer spins for after each tick.  This leaves enough of the
+ * tick period for the gamer to block before the next tick, even though the
+ * Linux port does not switch to the gamer as soon as the tick occurs. */
+    #define gamingGAMER_SPIN_US             ( ( 200UL * 1000UL ) / configTICK_RATE_HZ )
+
+/* The interactive task runs once in this many ticks. */
+    #define gamingINTERACTIVE_PERIOD        ( ( TickType_t ) 10 )
+    #define gamingINTERACTIVE_SPIN_US       ( 20UL )
+
+/* The number of ticks for which the test runs, which covers several boosts. */
+    #define gamingTEST_TICKS                ( configMLFQ_LOOP_TIME_SLICE * 4U )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The tasks as described in the comments at the top of this file.
+ */
+    static void prvControllerTask( void * pvParameters );
+    static void prvGamerTask( void * pvParameters );
+    static void prvInteractiveTask( void * pvParameters );
+    static void prvFixedTask( void * pvParameters );
+
+/*
+ * Spin for the given number of microseconds of wall clock time.
+ */
+    static void prvSpin( uint32_t ulMicroseconds );
+
+/*-----------------------------------------------------------*/
+
+    static TaskHandle_t xGamerTask = NULL;
+    static TaskHandle_t xInteractiveTask = NULL;
+    static TaskHandle_t xFixedTask = NULL;
+
+/*-----------------------------------------------------------*/
+
+/*** SEE THE COMMENTS AT THE TOP OF THIS FILE ***/
+    void main_mlfq_gaming_test( void )
+    {
+        xTaskCreateMLFQ( prvGamerTask, "Gamer", configMINIMAL_STACK_SIZE, NULL, &xGamerTask );
+        xTaskCreateMLFQ( prvInteractiveTask, "Interact", configMINIMAL_STACK_SIZE, NULL, &xInteractiveTask );
+        xTaskCreate( prvFixedTask, "Fixed", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY, &xFixedTask );
+        xTaskCreate( prvControllerTask, "Control", configMINIMAL_STACK_SIZE * 2U, NULL, configMAX_PRIORITIES - 1U, NULL );
+
+        vTaskStartScheduler();
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvControllerTask( void * pvParameters )
+    {
+        UBaseType_t uxGamerLevel, uxGamerLowest = configMAX_PRIORITIES;
+        UBaseType_t uxInteractiveLowest = configMAX_PRIORITIES;
+        UBaseType_t uxLastGamerLevel = configMAX_PRIORITIES - 1U;
+        BaseType_t xGamerBoosted = pdFALSE, xFixedMoved = pdFALSE;
+        uint32_t ulFailures = 0UL;
+        TickType_t xTick;
+
+        ( void ) pvParameters;
+
+        for( xTick = 0; xTick < gamingTEST_TICKS; xTick++ )
+        {
+            vTaskDelay( 1 );
+
+            uxGamerLevel = uxTaskPriorityGet( xGamerTask );
+
+            if( uxGamerLevel < uxGamerLowest )
+            {
+                uxGamerLowest = uxGamerLevel;
+            }
+
+            if( uxGamerLevel > uxLastGamerLevel )
+            {
+                xGamerBoosted = pdTRUE;
+            }
+
+            uxLastGamerLevel = uxGamerLevel;
+
+            if( uxTaskPriorityGet( xInteractiveTask ) < uxInteractiveLowest )
+            {
+                uxInteractiveLowest = uxTaskPriorityGet( xInteractiveTask );
+            }
+
+            if( uxTaskPriorityGet( xFixedTask ) != tskIDLE_PRIORITY )
+            {
+                xFixedMoved = pdTRUE;
+            }
+        }
+
+        if( uxGamerLowest != 1U )
+        {
+            console_print( "MLFQ gaming test: the gamer only reached level %u\n", ( unsigned ) uxGamerLowest );
+            ulFailures++;
+        }
+
+        if( xGamerBoosted == pdFALSE )
+        {
+            console_print( "MLFQ gaming test: the gamer was never boosted\n" );
+            ulFailures++;
+        }
+
+        if( uxInteractiveLowest <= uxGamerLowest )
+        {
+            console_print( "MLFQ gaming test: the interactive task reached level %u\n", ( unsigned ) uxInteractiveLowest );
+            ulFailures++;
+        }
+
+        if( xFixedMoved != pdFALSE )
+        {
+            console_print( "MLFQ gaming test: the priority of a task not created by xTaskCreateMLFQ() changed\n" );
+            ulFailures++;
+        }
+
+        console_print( "MLFQ gaming test: %s, gamer lowest level %u, interactive lowest level %u, %lu failures\n",
+                       ( ulFailures == 0UL ) ? "PASS" : "FAIL",
+                       ( unsigned ) uxGamerLowest,
+                       ( unsigned ) uxInteractiveLowest,
+                       ( unsigned long ) ulFailures );
+
+        /* Exit the process directly rather than ending the scheduler. */
+        exit( ( ulFailures == 0UL ) ? EXIT_SUCCESS : EXIT_FAILURE );
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvGamerTask( void * pvParameters )
+    {
+        ( void ) pvParameters;
+
+        for( ; ; )
+        {
+            /* Block until the next tick, then use most of the tick period. */
+            vTaskDelay( 1 );
+            prvSpin( gamingGAMER_SPIN_US );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvInteractiveTask( void * pvParameters )
+    {
+        ( void ) pvParameters;
+
+        for( ; ; )
+        {
+            vTaskDelay( gamingINTERACTIVE_PERIOD );
+            prvSpin( gamingINTERACTIVE_SPIN_US );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvFixedTask( void * pvParameters )
+    {
+        ( void ) pvParameters;
+
+        /* Runs whenever no other task is ready. */
+        for( ; ; )
+        {
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvSpin( uint32_t ulMicroseconds )
+    {
+        struct timespec xStart, xNow;
+        uint64_t ullElapsedUs;
+
+        ( void ) clock_gettime( CLOCK_MONOTONIC, &xStart );
+
+        do
+        {
+            ( void ) clock_gettime( CLOCK_MONOTONIC, &xNow );
+            ullElapsedUs = ( ( uint64_t ) ( xNow.tv_sec - xStart.tv_sec ) * 1000000ULL ) +
+                           ( uint64_t ) ( ( xNow.tv_nsec - xStart.tv_nsec ) / 1000L );
+        } while( ullElapsedUs < ulMicroseconds );
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* ( configUSE_MLFQ_SCHEDULER == 1 ) && ( configMLFQ_USE_RUN_TIME_ACCOUNTING == 1 ) */
@@ -0,0 +1,391 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/******************************************************************************
+ * NOTE 1: This file is only built into a working application when USER_DEMO is
+ * set to MLFQ_POLICY_TEST_DEMO, which builds the kernel with
+ * configUSE_MLFQ_SCHEDULER set to 1 (see FreeRTOSConfig.h).
+ *
+ * NOTE 2: The FreeRTOS demo threads will not be running continuously, so the
+ * number of ticks a task spends on each level is not exactly repeatable.  The
+ * checks made by this test allow for that.
+ ******************************************************************************
+ *
+ * main_mlfq_policy_test() checks that the MLFQ scheduler uses the level band,
+ * time slices and boost period set by vTaskSetMLFQPolicy(), and that the
+ * policy can be changed while MLFQ tasks are running.
+ *
+ * A single MLFQ "spinner" task never blocks, so it uses up the time slice of
+ * every level in turn until it reaches the lowest level, then waits there for
+ * the next boost.  A controller task, created by xTaskCreate() at the priority
+ * above the MLFQ band, samples the spinner's level at every tick.
+ *
+ * The test runs two phases, each with its own policy.  In each phase the
+ * spinner must stay within the band, must reach the lowest level and be
+ * boosted back to the top level, and must spend each level's time slice on
+ * that level.  The second policy moves the band down, so the spinner must be
+ * on the top level of the new band as soon as the policy has been changed.
+ * The controller's own priority must not be changed by the MLFQ scheduler.
+ *
+ * Last, an MLFQ "holder" task takes a mutex the controller then waits for, so
+ * the holder inherits the controller's priority.  The holder runs for several
+ * time slices while it holds the mutex, and must keep the inherited priority
+ * throughout.  Once it gives the mutex back it must be on a lower level than
+ * the one it started on, as its time slices were still charged.
+ * The result is printed and the application exits with EXIT_SUCCESS or
+ * EXIT_FAILURE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+/* Local includes. */
+#include "console.h"
+
+#if ( configUSE_MLFQ_SCHEDULER == 1 )
+
+/* The priority of the controller, which is above both MLFQ bands. */
+    #define policyCONTROLLER_PRIORITY    ( configMAX_PRIORITIES - 1U )
+
+/* The number of boost periods for which each phase runs. */
+    #define policyBOOSTS_PER_PHASE       ( 3U )
+
+/* The number of ticks by which the time spent on a level may differ from the
+ * level's time slice, as the spinner is not always running when the Linux
+ * port processes a tick. */
+    #define policyTIME_SLICE_TOLERANCE    ( ( TickType_t ) 2 )
+
+/* The number of ticks the holder runs for while it holds the mutex and has
+ * inherited the controller's priority. */
+    #define policyHOLD_TICKS              ( ( TickType_t ) 10 )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The tasks as described in the comments at the top of this file.
+ */
+    static void prvControllerTask( void * pvParameters );
+    static void prvSpinnerTask( void * pvParameters );
+    static void prvHolderTask( void * pvParameters );
+
+/*
+ * Set xPolicy, then sample the spinner's level at every tick for
+ * policyBOOSTS_PER_PHASE boost periods.  Returns the number of failed checks.
+ */
+    static uint32_t prvRunPhase( const char * pcPhaseName,
+                                 const MLFQPolicy_t * pxPolicy );
+
+/*
+ * Check the holder keeps the priority it inherits from the controller while
+ * its time slices run out.  Returns the number of failed checks.
+ */
+    static uint32_t prvCheckInheritance( const MLFQPolicy_t * pxPolicy );
+
+/*-----------------------------------------------------------*/
+
+    static TaskHandle_t xSpinnerTask = NULL;
+
+/* The mutex the holder takes, and what the holder records while it holds it. */
+    static SemaphoreHandle_t xMutex = NULL;
+    static volatile BaseType_t xHolderHasMutex = pdFALSE;
+    static volatile UBaseType_t uxHolderLowestPriority = 0U;
+
+/* The first policy leaves the priority above the band for the controller and
+ * the priority below it free.  The second moves the band down to priority 1
+ * and has fewer levels. */
+    static const TickType_t xFirstTimeSlices[] = { 3, 6, 9, 12 };
+    static const TickType_t xSecondTimeSlices[] = { 2, 5, 3 };
+
+    static const MLFQPolicy_t xFirstPolicy =
+    {
+        policyCONTROLLER_PRIORITY - 1U,
+        sizeof( xFirstTimeSlices ) / sizeof( xFirstTimeSlices[ 0 ] ),
+        xFirstTimeSlices,
+        60U
+    };
+
+    static const MLFQPolicy_t xSecondPolicy =
+    {
+        sizeof( xSecondTimeSlices ) / sizeof( xSecondTimeSlices[ 0 ] ),
+        sizeof( xSecondTimeSlices ) / sizeof( xSecondTimeSlices[ 0 ] ),
+        xSecondTimeSlices,
+        30U
+    };
+
+/*-----------------------------------------------------------*/
+
+/*** SEE THE COMMENTS AT THE TOP OF THIS FILE ***/
+    void main_mlfq_policy_test( void )
+    {
+        xTaskCreate( prvControllerTask, "Control", configMINIMAL_STACK_SIZE * 2U, NULL, policyCONTROLLER_PRIORITY, NULL );
+
+        vTaskStartScheduler();
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvControllerTask( void * pvParameters )
+    {
+        uint32_t ulFailures;
+
+        ( void ) pvParameters;
+
+        /* Set the first policy before the spinner is created, so the spinner
+         * starts on the top level of the first band. */
+        vTaskSetMLFQPolicy( &xFirstPolicy );
+        xTaskCreateMLFQ( prvSpinnerTask, "Spinner", configMINIMAL_STACK_SIZE, NULL, &xSpinnerTask );
+
+        ulFailures = prvRunPhase( "first policy", &xFirstPolicy );
+
+        /* Change the policy while the spinner is on one of the levels of the
+         * first band. */
+        vTaskSetMLFQPolicy( &xSecondPolicy );
+
+        if( uxTaskPriorityGet( xSpinnerTask ) != xSecondPolicy.uxHighestPriority )
+        {
+            console_print( "MLFQ policy test: the spinner was on level %u after the policy changed\n",
+                           ( unsigned ) uxTaskPriorityGet( xSpinnerTask ) );
+            ulFailures++;
+        }
+
+        ulFailures += prvRunPhase( "second policy", &xSecondPolicy );
+        ulFailures += prvCheckInheritance( &xSecondPolicy );
+
+        if( uxTaskPriorityGet( NULL ) != policyCONTROLLER_PRIORITY )
+        {
+            console_print( "MLFQ policy test: the priority of a task not created by xTaskCreateMLFQ() changed\n" );
+            ulFailures++;
+        }
+
+        console_print( "MLFQ policy test: %s, %lu failures\n",
+                       ( ulFailures == 0UL ) ? "PASS" : "FAIL",
+                       ( unsigned long ) ulFailures );
+
+        /* Exit the process directly rather than ending the scheduler. */
+        exit( ( ulFailures == 0UL ) ? EXIT_SUCCESS : EXIT_FAILURE );
+    }
+/*-----------------------------------------------------------*/
+
+    static uint32_t prvRunPhase( const char * pcPhaseName,
+                                 const MLFQPolicy_t * pxPolicy )
+    {
+        const UBaseType_t uxTop = pxPolicy->uxHighestPriority;
+        const UBaseType_t uxBottom = ( pxPolicy->uxHighestPriority - pxPolicy->uxNumberOfLevels ) + 1U;
+        const TickType_t xEnd = xTaskGetTickCount() + ( pxPolicy->xBoostPeriod * policyBOOSTS_PER_PHASE );
+        UBaseType_t uxLevel, uxLastLevel, uxLowest = uxTop;
+        BaseType_t xBoosted = pdFALSE, xOutsideBand = pdFALSE;
+        BaseType_t xLevelTimed;
+        TickType_t xNow, xEnteredLevel, xTimeOnLevel, xTimeSlice;
+        uint32_t ulFailures = 0UL, ulLevelsTimed = 0UL;
+
+        uxLastLevel = uxTaskPriorityGet( xSpinnerTask );
+        xEnteredLevel = xTaskGetTickCount();
+
+        /* The time spent on the level the spinner starts on is unknown. */
+        xLevelTimed = pdFALSE;
+
+        while( xTaskGetTickCount() < xEnd )
+        {
+            vTaskDelay( 1 );
+
+            uxLevel = uxTaskPriorityGet( xSpinnerTask );
+            xNow = xTaskGetTickCount();
+
+            if( ( uxLevel < uxBottom ) || ( uxLevel > uxTop ) )
+            {
+                xOutsideBand = pdTRUE;
+            }
+
+            if( uxLevel < uxLowest )
+            {
+                uxLowest = uxLevel;
+            }
+
+            if( uxLevel == uxLastLevel )
+            {
+                continue;
+            }
+
+            if( uxLevel > uxLastLevel )
+            {
+                xBoosted = pdTRUE;
+            }
+            else if( ( xLevelTimed != pdFALSE ) && ( uxLastLevel <= uxTop ) && ( uxLastLevel >= uxBottom ) )
+            {
+                /* The spinner used up the time slice of the level it left. */
+                xTimeOnLevel = xNow - xEnteredLevel;
+                xTimeSlice = pxPolicy->pxLevelTimeSlices[ uxTop - uxLastLevel ];
+                ulLevelsTimed++;
+
+                if( ( xTimeOnLevel + policyTIME_SLICE_TOLERANCE < xTimeSlice ) ||
+                    ( xTimeOnLevel > xTimeSlice + policyTIME_SLICE_TOLERANCE ) )
+                {
+                    console_print( "MLFQ policy test: %s, the spinner spent %lu ticks on level %u, expected %lu\n",
+                                   pcPhaseName,
+                                   ( unsigned long ) xTimeOnLevel,
+                                   ( unsigned ) uxLastLevel,
+                                   ( unsigned long ) xTimeSlice );
+                    ulFailures++;
+                }
+            }
+
+            uxLastLevel = uxLevel;
+            xEnteredLevel = xNow;
+            xLevelTimed = pdTRUE;
+        }
+
+        if( xOutsideBand != pdFALSE )
+        {
+            console_print( "MLFQ policy test: %s, the spinner left the levels %u to %u\n",
+                           pcPhaseName, ( unsigned ) uxBottom, ( unsigned ) uxTop );
+            ulFailures++;
+        }
+
+        if( uxLowest != uxBottom )
+        {
+            console_print( "MLFQ policy test: %s, the spinner only reached level %u\n",
+                           pcPhaseName, ( unsigned ) uxLowest );
+            ulFailures++;
+        }
+
+        if( xBoosted == pdFALSE )
+        {
+            console_print( "MLFQ policy test: %s, the spinner was never boosted\n", pcPhaseName );
+            ulFailures++;
+        }
+
+        if( ulLevelsTimed == 0UL )
+        {
+            console_print( "MLFQ policy test: %s, no time slice was measured\n", pcPhaseName );
+            ulFailures++;
+        }
+
+        console_print( "MLFQ policy test: %s, lowest level %u, %lu time slices measured\n",
+                       pcPhaseName, ( unsigned ) uxLowest, ( unsigned long ) ulLevelsTimed );
+
+        return ulFailures;
+    }
+/*-----------------------------------------------------------*/
+
+    static uint32_t prvCheckInheritance( const MLFQPolicy_t * pxPolicy )
+    {
+        TaskHandle_t xHolderTask = NULL;
+        UBaseType_t uxHolderLevel;
+        uint32_t ulFailures = 0UL;
+
+        xMutex = xSemaphoreCreateMutex();
+        configASSERT( xMutex != NULL );
+
+        xTaskCreateMLFQ( prvHolderTask, "Holder", configMINIMAL_STACK_SIZE, NULL, &xHolderTask );
+
+        while( xHolderHasMutex == pdFALSE )
+        {
+            vTaskDelay( 1 );
+        }
+
+        /* The holder inherits the controller's priority while the controller
+         * waits for the mutex. */
+        ( void ) xSemaphoreTake( xMutex, portMAX_DELAY );
+        ( void ) xSemaphoreGive( xMutex );
+
+        if( uxHolderLowestPriority != policyCONTROLLER_PRIORITY )
+        {
+            console_print( "MLFQ policy test: the holder fell to priority %u while it held a mutex\n",
+                           ( unsigned ) uxHolderLowestPriority );
+            ulFailures++;
+        }
+
+        /* The holder has suspended itself on its base priority, which must
+         * have been lowered as its time slices ran out. */
+        uxHolderLevel = uxTaskPriorityGet( xHolderTask );
+
+        if( ( uxHolderLevel >= pxPolicy->uxHighestPriority ) ||
+            ( uxHolderLevel < ( ( pxPolicy->uxHighestPriority - pxPolicy->uxNumberOfLevels ) + 1U ) ) )
+        {
+            console_print( "MLFQ policy test: the holder was on level %u after it gave the mutex\n",
+                           ( unsigned ) uxHolderLevel );
+            ulFailures++;
+        }
+
+        console_print( "MLFQ policy test: inheritance, level %u after the mutex was given\n",
+                       ( unsigned ) uxHolderLevel );
+
+        return ulFailures;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvHolderTask( void * pvParameters )
+    {
+        TickType_t xStart;
+        UBaseType_t uxPriority, uxLowest;
+
+        ( void ) pvParameters;
+
+        ( void ) xSemaphoreTake( xMutex, portMAX_DELAY );
+        xHolderHasMutex = pdTRUE;
+
+        /* Wait for the controller to block on the mutex. */
+        while( uxTaskPriorityGet( NULL ) != policyCONTROLLER_PRIORITY )
+        {
+        }
+
+        /* Run for several time slices with the inherited priority. */
+        uxLowest = policyCONTROLLER_PRIORITY;
+        xStart = xTaskGetTickCount();
+
+        while( ( TickType_t ) ( xTaskGetTickCount() - xStart ) < policyHOLD_TICKS )
+        {
+            uxPriority = uxTaskPriorityGet( NULL );
+
+            if( uxPriority < uxLowest )
+            {
+                uxLowest = uxPriority;
+            }
+        }
+
+        uxHolderLowestPriority = uxLowest;
+        ( void ) xSemaphoreGive( xMutex );
+
+        vTaskSuspend( NULL );
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvSpinnerTask( void * pvParameters )
+    {
+        ( void ) pvParameters;
+
+        /* Never blocks, so uses up the time slice of every level. */
+        for( ; ; )
+        {
+        }
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_MLFQ_SCHEDULER == 1 */
@@ -0,0 +1,694 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/******************************************************************************
+ * NOTE 1: The FreeRTOS demo threads will not be running continuously, so
+ * do not expect to get real time behaviour from the FreeRTOS Linux port, or
+ * this demo application.  The absolute numbers reported by this test include
+ * the cost of the Linux port itself, where entering a critical section is a
+ * system call, so only compare them with numbers taken on the same machine.
+ *
+ * NOTE 2: This test is built when USER_DEMO is set to
+ * MPSC_MESSAGE_BUFFER_TEST_DEMO, which also sets configUSE_MPSC_MESSAGE_BUFFERS
+ * to 1 (see FreeRTOSConfig.h).
+ ******************************************************************************
+ *
+ * main_mpsc_message_buffer() tests message buffers created with
+ * xMessageBufferCreateMPSC(), which any number of tasks and interrupts can
+ * write to at the same time without a lock.
+ *
+ * First a single task checks the basic behaviour of a statically allocated
+ * MPSC message buffer: the largest message that fits, a full buffer, a receive
+ * into a buffer that is too small, messages that wrap around the end of the
+ * buffer, and a reset.  It then uses the traceSTREAM_BUFFER_MPSC_CLAIM() hook
+ * to have other messages sent and received between a writer reading the write
+ * index and claiming space with its compare-and-swap, until the write index is
+ * back where that writer read it.  The writer must then find the space it was
+ * about to claim is no longer free, rather than overwrite the last message.
+ *
+ * Then mpscWRITER_TASKS writer tasks and the tick hook all write to one small
+ * MPSC message buffer while a reader task at the same priority as the writers
+ * reads from it.  Time slicing preempts the writer tasks part way through a
+ * send, and the tick hook interrupts them part way through a send, so writers
+ * commit their messages in a different order to the order in which they
+ * reserved space.  Each message carries the number of its writer, a sequence
+ * number and a variable length payload derived from both, and the reader
+ * checks every message is received intact, once, and in the order its writer
+ * sent it.
+ *
+ * Finally the rate at which the writer tasks move messages to the reader is
+ * measured for the MPSC message buffer, and for a message buffer created with
+ * xMessageBufferCreate() where each writer has to hold a mutex while it
+ * sends.  Any error is counted, and the application exits with a failure
+ * status if there are errors.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "message_buffer.h"
+#include "semphr.h"
+
+/* Local includes. */
+#include "console.h"
+
+#if ( configUSE_MPSC_MESSAGE_BUFFERS == 1 )
+
+/* The writers, and the number the tick hook writes under. */
+    #define mpscWRITER_TASKS            ( 3U )
+    #define mpscTICK_WRITER             ( mpscWRITER_TASKS )
+    #define mpscWRITERS                 ( mpscWRITER_TASKS + 1U )
+
+/* The messages written by each writer task in the concurrent test, and the
+ * size of the buffer they are written to.  The buffer is kept small so it is
+ * often full and messages often wrap around its end. */
+    #define mpscTEST_MESSAGES           ( 50000UL )
+    #define mpscTEST_BUFFER_BYTES       ( 512U )
+    #define mpscMAX_PAYLOAD_BYTES       ( 40U )
+
+/* The messages written by each writer task when measuring throughput. */
+    #define mpscTHROUGHPUT_MESSAGES     ( 100000UL )
+    #define mpscTHROUGHPUT_BYTES        ( 32U )
+    #define mpscTHROUGHPUT_BUFFER_BYTES ( 1024U )
+
+/* The words of storage of the statically allocated buffer. */
+    #define mpscSTATIC_BUFFER_WORDS     ( 8U )
+
+/* How long the reader waits for a message before deciding one was lost. */
+    #define mpscRECEIVE_TIMEOUT_TICKS   ( pdMS_TO_TICKS( 1000U ) )
+
+/* The writers and the reader share a priority, below that of the
+ * controller. */
+    #define mpscWORKER_PRIORITY         ( tskIDLE_PRIORITY + 1U )
+    #define mpscCONTROLLER_PRIORITY     ( tskIDLE_PRIORITY + 2U )
+
+/*-----------------------------------------------------------*/
+
+/* The start of every message. */
+typedef struct MessageHeader
+{
+    uint32_t ulWriter;
+    uint32_t ulSequence;
+} MessageHeader_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The tasks as described in the comments at the top of this file.
+ */
+static void prvControllerTask( void * pvParameters );
+static void prvWriterTask( void * pvParameters );
+static void prvReaderTask( void * pvParameters );
+
+/*
+ * Check the behaviour of a statically allocated MPSC message buffer from a
+ * single task.
+ */
+static void prvCheckSingleTask( void );
+
+/*
+ * Have the writer tasks and the tick hook write to xMessageBuffer, and check
+ * every message the reader receives.
+ */
+static void prvCheckConcurrentWriters( MessageBufferHandle_t xMessageBuffer );
+
+/*
+ * Time the writer tasks moving messages to the reader through xMessageBuffer
+ * and return the number of messages moved per second.  If xLocked is pdTRUE
+ * each writer holds xWriterMutex while it sends.
+ */
+static double prvMeasure( MessageBufferHandle_t xMessageBuffer,
+                          BaseType_t xLocked );
+
+/*
+ * Build message ulSequence of writer ulWriter in pucMessage, and return its
+ * length.  Or check the message received in pucMessage is that message.
+ */
+static size_t prvBuildMessage( uint8_t * pucMessage,
+                               uint32_t ulWriter,
+                               uint32_t ulSequence );
+static BaseType_t prvCheckMessage( const uint8_t * pucMessage,
+                                   size_t xLength,
+                                   uint32_t ulWriter,
+                                   uint32_t ulSequence );
+
+/*
+ * Returns a monotonic time stamp in nanoseconds.
+ */
+static uint64_t prvGetTimeNs( void );
+
+/*
+ * Called from the tick hook, so from an interrupt.
+ */
+void vMPSCMessageBufferTickHookFunction( void );
+
+/*
+ * Called from traceSTREAM_BUFFER_MPSC_CLAIM() each time a writer is about to
+ * claim space in an MPSC message buffer.
+ */
+void vMPSCMessageBufferClaimHook( void * pvMessageBuffer );
+
+/*-----------------------------------------------------------*/
+
+/* The message buffer the writers and the reader are to use next, and how. */
+static MessageBufferHandle_t xWorkerBuffer = NULL;
+static BaseType_t xWorkerLocked = pdFALSE;
+static BaseType_t xWorkerChecked = pdFALSE;
+static uint32_t ulWorkerMessages = 0UL;
+
+/* Held by a writer while it sends to a message buffer that is not an MPSC
+ * message buffer. */
+static SemaphoreHandle_t xWriterMutex = NULL;
+
+/* Set while the tick hook is to write to xWorkerBuffer, and the number of
+ * messages it has written. */
+static volatile BaseType_t xTickWriterRunning = pdFALSE;
+static volatile uint32_t ulTickMessagesSent = 0UL;
+
+/* The number of times a writer found the buffer full. */
+static volatile uint32_t ulBufferFull = 0UL;
+
+/* The tasks, so they can be notified. */
+static TaskHandle_t xControllerTask = NULL;
+static TaskHandle_t xReaderTask = NULL;
+static TaskHandle_t xWriterTasks[ mpscWRITER_TASKS ];
+
+/* The storage of the statically allocated buffer, which must be size_t
+ * aligned. */
+static size_t xStaticStorage[ mpscSTATIC_BUFFER_WORDS ];
+static StaticMessageBuffer_t xStaticMessageBuffer;
+
+/* While not NULL, the next writer about to claim space in this message buffer
+ * has other messages sent and received first. */
+static MessageBufferHandle_t volatile xClaimBuffer = NULL;
+
+/* The message vMPSCMessageBufferClaimHook() leaves in the buffer. */
+static uint8_t ucClaimMessage[ 3U * sizeof( size_t ) ];
+
+/* The number of errors found. */
+static volatile uint32_t ulErrors = 0UL;
+
+/*-----------------------------------------------------------*/
+
+/*** SEE THE COMMENTS AT THE TOP OF THIS FILE ***/
+void main_mpsc_message_buffer( void )
+{
+    uint32_t ulWriter;
+
+    xWriterMutex = xSemaphoreCreateMutex();
+    configASSERT( xWriterMutex );
+
+    xTaskCreate( prvControllerTask, "Control", configMINIMAL_STACK_SIZE * 2U, NULL, mpscCONTROLLER_PRIORITY, &xControllerTask );
+    xTaskCreate( prvReaderTask, "Reader", configMINIMAL_STACK_SIZE, NULL, mpscWORKER_PRIORITY, &xReaderTask );
+
+    for( ulWriter = 0UL; ulWriter < mpscWRITER_TASKS; ulWriter++ )
+    {
+        xTaskCreate( prvWriterTask, "Writer", configMINIMAL_STACK_SIZE, ( void * ) ( uintptr_t ) ulWriter, mpscWORKER_PRIORITY, &( xWriterTasks[ ulWriter ] ) );
+    }
+
+    vTaskStartScheduler();
+}
+/*-----------------------------------------------------------*/
+
+static void prvControllerTask( void * pvParameters )
+{
+    MessageBufferHandle_t xMessageBuffer;
+    double dMPSCMessagesPerSecond, dLockedMessagesPerSecond;
+
+    ( void ) pvParameters;
+
+    prvCheckSingleTask();
+
+    xMessageBuffer = xMessageBufferCreateMPSC( mpscTEST_BUFFER_BYTES );
+    configASSERT( xMessageBuffer );
+    prvCheckConcurrentWriters( xMessageBuffer );
+    vMessageBufferDelete( xMessageBuffer );
+
+    console_print( "MPSC message buffer test: %u writer tasks and the tick hook, %lu messages from each task, %lu from the tick hook, buffer full %lu times\n",
+                   ( unsigned ) mpscWRITER_TASKS,
+                   ( unsigned long ) mpscTEST_MESSAGES,
+                   ( unsigned long ) ulTickMessagesSent,
+                   ( unsigned long ) ulBufferFull );
+
+    xMessageBuffer = xMessageBufferCreateMPSC( mpscTHROUGHPUT_BUFFER_BYTES );
+    configASSERT( xMessageBuffer );
+    dMPSCMessagesPerSecond = prvMeasure( xMessageBuffer, pdFALSE );
+    vMessageBufferDelete( xMessageBuffer );
+
+    xMessageBuffer = xMessageBufferCreate( mpscTHROUGHPUT_BUFFER_BYTES );
+    configASSERT( xMessageBuffer );
+    dLockedMessagesPerSecond = prvMeasure( xMessageBuffer, pdTRUE );
+    vMessageBufferDelete( xMessageBuffer );
+
+    console_print( "buffer, messages/s (%u writers, %u byte messages)\n", ( unsigned ) mpscWRITER_TASKS, ( unsigned ) mpscTHROUGHPUT_BYTES );
+    console_print( "xMessageBufferCreate with a mutex, %.0f\n", dLockedMessagesPerSecond );
+    console_print( "xMessageBufferCreateMPSC, %.0f\n", dMPSCMessagesPerSecond );
+    console_print( "errors, %lu\n", ( unsigned long ) ulErrors );
+
+    /* Exit the process directly rather than ending the scheduler, so the
+     * threads of the writers and the reader do not have to be torn down. */
+    if( ulErrors != 0UL )
+    {
+        exit( EXIT_FAILURE );
+    }
+
+    exit( EXIT_SUCCESS );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckSingleTask( void )
+{
+    const size_t xLargest = sizeof( xStaticStorage ) - ( 2U * sizeof( size_t ) );
+    uint8_t ucSent[ sizeof( xStaticStorage ) ], ucReceived[ sizeof( xStaticStorage ) ];
+    MessageBufferHandle_t xMessageBuffer;
+    size_t xLength, xIndex;
+    uint32_t ulMessage;
+
+    xMessageBuffer = xMessageBufferCreateMPSCStatic( sizeof( xStaticStorage ), ( uint8_t * ) xStaticStorage, &xStaticMessageBuffer );
+
+    if( ( xMessageBuffer == NULL ) ||
+        ( xMessageBufferIsEmpty( xMessageBuffer ) != pdTRUE ) ||
+        ( xMessageBufferNextLengthBytes( xMessageBuffer ) != 0U ) )
+    {
+        ulErrors++;
+    }
+
+    for( xIndex = 0U; xIndex < sizeof( ucSent ); xIndex++ )
+    {
+        ucSent[ xIndex ] = ( uint8_t ) ( xIndex + 1U );
+    }
+
+    /* One header is always kept free, so the largest message is two headers
+     * smaller than the buffer, and fills it. */
+    if( ( xMessageBufferSend( xMessageBuffer, ucSent, xLargest + 1U, 0U ) != 0U ) ||
+        ( xMessageBufferSend( xMessageBuffer, ucSent, xLargest, 0U ) != xLargest ) ||
+        ( xMessageBufferIsFull( xMessageBuffer ) != pdTRUE ) ||
+        ( xMessageBufferSend( xMessageBuffer, ucSent, 1U, 0U ) != 0U ) )
+    {
+        ulErrors++;
+    }
+
+    /* A message that does not fit in the receive buffer stays where it is. */
+    if( ( xMessageBufferNextLengthBytes( xMessageBuffer ) != xLargest ) ||
+        ( xMessageBufferReceive( xMessageBuffer, ucReceived, xLargest - 1U, 0U ) != 0U ) ||
+        ( xMessageBufferNextLengthBytes( xMessageBuffer ) != xLargest ) ||
+        ( xMessageBufferReceive( xMessageBuffer, ucReceived, sizeof( ucReceived ), 0U ) != xLargest ) ||
+        ( memcmp( ucSent, ucReceived, xLargest ) != 0 ) ||
+        ( xMessageBufferIsEmpty( xMessageBuffer ) != pdTRUE ) ||
+        ( xMessageBufferReceive( xMessageBuffer, ucReceived, sizeof( ucReceived ), 0U ) != 0U ) )
+    {
+        ulErrors++;
+    }
+
+    /* Messages of every length, two at a time, so they start at every header
+     * position and wrap around the end of the buffer. */
+    for( ulMessage = 0UL; ulMessage < 1000UL; ulMessage++ )
+    {
+        xLength = 1U + ( ( ulMessage * 7UL ) % ( ( xLargest / 2U ) - sizeof( size_t ) ) );
+        ucSent[ 0 ] = ( uint8_t ) ulMessage;
+
+        if( ( xMessageBufferSend( xMessageBuffer, ucSent, xLength, 0U ) != xLength ) ||
+            ( xMessageBufferSend( xMessageBuffer, ucSent, 1U, 0U ) != 1U ) ||
+            ( xMessageBufferReceive( xMessageBuffer, ucReceived, sizeof( ucReceived ), 0U ) != xLength ) ||
+            ( memcmp( ucSent, ucReceived, xLength ) != 0 ) ||
+            ( xMessageBufferReceive( xMessageBuffer, ucReceived, sizeof( ucReceived ), 0U ) != 1U ) ||
+            ( ucReceived[ 0 ] != ( uint8_t ) ulMessage ) )
+        {
+            ulErrors++;
+        }
+    }
+
+    if( ( xMessageBufferSend( xMessageBuffer, ucSent, 1U, 0U ) != 1U ) ||
+        ( xMessageBufferReset( xMessageBuffer ) != pdPASS ) ||
+        ( xMessageBufferIsEmpty( xMessageBuffer ) != pdTRUE ) ||
+        ( xMessageBufferReceive( xMessageBuffer, ucReceived, sizeof( ucReceived ), 0U ) != 0U ) )
+    {
+        ulErrors++;
+    }
+
+    /* This message takes six of the eight headers worth of space, and fits.
+     * vMPSCMessageBufferClaimHook() moves the write index all the way round
+     * to where it is now, and leaves the last four headers worth of space
+     * used, before the space is claimed, so then it no longer fits. */
+    for( xIndex = 0U; xIndex < sizeof( ucClaimMessage ); xIndex++ )
+    {
+        ucClaimMessage[ xIndex ] = ( uint8_t ) ~xIndex;
+    }
+
+    xClaimBuffer = xMessageBuffer;
+
+    if( ( xMessageBufferSend( xMessageBuffer, ucSent, 5U * sizeof( size_t ), 0U ) != 0U ) ||
+        ( xClaimBuffer != NULL ) ||
+        ( xMessageBufferReceive( xMessageBuffer, ucReceived, sizeof( ucReceived ), 0U ) != sizeof( ucClaimMessage ) ) ||
+        ( memcmp( ucClaimMessage, ucReceived, sizeof( ucClaimMessage ) ) != 0 ) ||
+        ( xMessageBufferIsEmpty( xMessageBuffer ) != pdTRUE ) )
+    {
+        ulErrors++;
+    }
+
+    vMessageBufferDelete( xMessageBuffer );
+}
+/*-----------------------------------------------------------*/
+
+void vMPSCMessageBufferClaimHook( void * pvMessageBuffer )
+{
+    uint8_t ucReceived[ sizeof( size_t ) ];
+
+    if( ( xClaimBuffer != NULL ) && ( pvMessageBuffer == ( void * ) xClaimBuffer ) )
+    {
+        /* Only once, as the sends below also claim space. */
+        xClaimBuffer = NULL;
+
+        /* Two messages of one header worth of data each take two headers
+         * worth of space, then a message of three takes four, so the write
+         * index goes once round the buffer.  The last message is left in the
+         * buffer. */
+        if( ( xMessageBufferSend( pvMessageBuffer, ucClaimMessage, sizeof( size_t ), 0U ) != sizeof( size_t ) ) ||
+            ( xMessageBufferSend( pvMessageBuffer, ucClaimMessage, sizeof( size_t ), 0U ) != sizeof( size_t ) ) ||
+            ( xMessageBufferReceive( pvMessageBuffer, ucReceived, sizeof( ucReceived ), 0U ) != sizeof( size_t ) ) ||
+            ( xMessageBufferReceive( pvMessageBuffer, ucReceived, sizeof( ucReceived ), 0U ) != sizeof( size_t ) ) ||
+            ( xMessageBufferSend( pvMessageBuffer, ucClaimMessage, sizeof( ucClaimMessage ), 0U ) != sizeof( ucClaimMessage ) ) )
+        {
+            ulErrors++;
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckConcurrentWriters( MessageBufferHandle_t xMessageBuffer )
+{
+    uint32_t ulWriter;
+
+    xWorkerBuffer = xMessageBuffer;
+    xWorkerLocked = pdFALSE;
+    xWorkerChecked = pdTRUE;
+    ulWorkerMessages = mpscTEST_MESSAGES;
+    ulTickMessagesSent = 0UL;
+    xTickWriterRunning = pdTRUE;
+
+    xTaskNotifyGive( xReaderTask );
+
+    for( ulWriter = 0UL; ulWriter < mpscWRITER_TASKS; ulWriter++ )
+    {
+        xTaskNotifyGive( xWriterTasks[ ulWriter ] );
+    }
+
+    /* The controller runs above the writers and the reader, so it only runs
+     * again once each writer task has finished.  Then stop the tick hook, and
+     * wait for the reader to receive what is left. */
+    for( ulWriter = 0UL; ulWriter < mpscWRITER_TASKS; ulWriter++ )
+    {
+        ( void ) ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+    }
+
+    xTickWriterRunning = pdFALSE;
+
+    /* The reader may already have received everything, and be waiting for
+     * more from the tick hook. */
+    ( void ) xTaskAbortDelay( xReaderTask );
+    ( void ) ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+
+    if( xMessageBufferIsEmpty( xMessageBuffer ) != pdTRUE )
+    {
+        ulErrors++;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static double prvMeasure( MessageBufferHandle_t xMessageBuffer,
+                          BaseType_t xLocked )
+{
+    uint64_t ullStartNs, ullDurationNs;
+    uint32_t ulWriter;
+
+    xWorkerBuffer = xMessageBuffer;
+    xWorkerLocked = xLocked;
+    xWorkerChecked = pdFALSE;
+    ulWorkerMessages = mpscTHROUGHPUT_MESSAGES;
+
+    ullStartNs = prvGetTimeNs();
+
+    xTaskNotifyGive( xReaderTask );
+
+    for( ulWriter = 0UL; ulWriter < mpscWRITER_TASKS; ulWriter++ )
+    {
+        xTaskNotifyGive( xWriterTasks[ ulWriter ] );
+    }
+
+    /* Wait for every writer and for the reader. */
+    for( ulWriter = 0UL; ulWriter < ( mpscWRITER_TASKS + 1U ); ulWriter++ )
+    {
+        ( void ) ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+    }
+
+    ullDurationNs = prvGetTimeNs() - ullStartNs;
+
+    return ( ( double ) ( mpscTHROUGHPUT_MESSAGES * mpscWRITER_TASKS ) * 1000000000.0 ) / ( double ) ullDurationNs;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvBuildMessage( uint8_t * pucMessage,
+                               uint32_t ulWriter,
+                               uint32_t ulSequence )
+{
+    MessageHeader_t xHeader;
+    size_t xPayload, xIndex;
+
+    xHeader.ulWriter = ulWriter;
+    xHeader.ulSequence = ulSequence;
+    ( void ) memcpy( pucMessage, &xHeader, sizeof( xHeader ) );
+
+    xPayload = ( size_t ) ( ( ( ulSequence * 7UL ) + ( ulWriter * 13UL ) ) % ( mpscMAX_PAYLOAD_BYTES + 1UL ) );
+
+    for( xIndex = 0U; xIndex < xPayload; xIndex++ )
+    {
+        pucMessage[ sizeof( xHeader ) + xIndex ] = ( uint8_t ) ( ulSequence + xIndex + ( ulWriter * 31UL ) );
+    }
+
+    return sizeof( xHeader ) + xPayload;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvCheckMessage( const uint8_t * pucMessage,
+                                   size_t xLength,
+                                   uint32_t ulWriter,
+                                   uint32_t ulSequence )
+{
+    uint8_t ucExpected[ sizeof( MessageHeader_t ) + mpscMAX_PAYLOAD_BYTES ];
+    BaseType_t xReturn = pdFALSE;
+
+    if( ( xLength == prvBuildMessage( ucExpected, ulWriter, ulSequence ) ) &&
+        ( memcmp( pucMessage, ucExpected, xLength ) == 0 ) )
+    {
+        xReturn = pdTRUE;
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vMPSCMessageBufferTickHookFunction( void )
+{
+    static uint8_t ucMessage[ sizeof( MessageHeader_t ) + mpscMAX_PAYLOAD_BYTES ];
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    size_t xLength;
+
+    if( xTickWriterRunning != pdFALSE )
+    {
+        /* Write the next message, or the same one again on the next tick if
+         * the buffer is full. */
+        xLength = prvBuildMessage( ucMessage, mpscTICK_WRITER, ulTickMessagesSent );
+
+        if( xMessageBufferSendFromISR( xWorkerBuffer, ucMessage, xLength, &xHigherPriorityTaskWoken ) == xLength )
+        {
+            ulTickMessagesSent++;
+        }
+        else
+        {
+            ulBufferFull++;
+        }
+
+        portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvWriterTask( void * pvParameters )
+{
+    const uint32_t ulWriter = ( uint32_t ) ( uintptr_t ) pvParameters;
+    uint8_t ucMessage[ sizeof( MessageHeader_t ) + mpscMAX_PAYLOAD_BYTES ];
+    uint32_t ulSequence;
+    size_t xLength, xSent;
+
+    for( ; ; )
+    {
+        ( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+        for( ulSequence = 0UL; ulSequence < ulWorkerMessages; ulSequence++ )
+        {
+            if( xWorkerChecked != pdFALSE )
+            {
+                xLength = prvBuildMessage( ucMessage, ulWriter, ulSequence );
+            }
+            else
+            {
+                xLength = mpscTHROUGHPUT_BYTES;
+            }
+
+            do
+            {
+                if( xWorkerLocked != pdFALSE )
+                {
+                    /* A message buffer that is not an MPSC message buffer
+                     * must only be written by one writer at a time. */
+                    ( void ) xSemaphoreTake( xWriterMutex, portMAX_DELAY );
+                    xSent = xMessageBufferSend( xWorkerBuffer, ucMessage, xLength, 0U );
+                    ( void ) xSemaphoreGive( xWriterMutex );
+                }
+                else
+                {
+                    xSent = xMessageBufferSend( xWorkerBuffer, ucMessage, xLength, 0U );
+                }
+
+                if( xSent != xLength )
+                {
+                    /* The buffer is full, so let the reader run. */
+                    ulBufferFull++;
+                    taskYIELD();
+                }
+            } while( xSent != xLength );
+        }
+
+        xTaskNotifyGive( xControllerTask );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvReaderTask( void * pvParameters )
+{
+    uint8_t ucMessage[ sizeof( MessageHeader_t ) + mpscMAX_PAYLOAD_BYTES ];
+    uint32_t ulNextSequence[ mpscWRITERS ];
+    uint32_t ulReceived, ulExpected, ulWriter;
+    MessageHeader_t xHeader;
+    BaseType_t xFinished, xComplete = pdFALSE;
+    size_t xLength;
+
+    ( void ) pvParameters;
+
+    for( ; ; )
+    {
+        ( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+        memset( ulNextSequence, 0x00, sizeof( ulNextSequence ) );
+        ulReceived = 0UL;
+        ulExpected = ulWorkerMessages * mpscWRITER_TASKS;
+        xFinished = pdFALSE;
+
+        while( xFinished == pdFALSE )
+        {
+            xLength = xMessageBufferReceive( xWorkerBuffer, ucMessage, sizeof( ucMessage ), mpscRECEIVE_TIMEOUT_TICKS );
+
+            if( xLength == 0U )
+            {
+                /* Nothing arrived in time, or the controller stopped the wait
+                 * after stopping the tick hook.  Every writer retries until
+                 * its message is sent, so unless everything has been received
+                 * a message has been lost. */
+                if( xComplete == pdFALSE )
+                {
+                    ulErrors++;
+                }
+
+                xFinished = pdTRUE;
+            }
+            else if( xWorkerChecked != pdFALSE )
+            {
+                ( void ) memcpy( &xHeader, ucMessage, sizeof( xHeader ) );
+                ulWriter = xHeader.ulWriter;
+
+                /* The messages from each writer arrive in the order the
+                 * writer sent them. */
+                if( ( ulWriter >= mpscWRITERS ) ||
+                    ( xHeader.ulSequence != ulNextSequence[ ulWriter ] ) ||
+                    ( prvCheckMessage( ucMessage, xLength, ulWriter, xHeader.ulSequence ) != pdTRUE ) )
+                {
+                    ulErrors++;
+                    xFinished = pdTRUE;
+                }
+                else
+                {
+                    ulNextSequence[ ulWriter ]++;
+
+                    if( ulWriter != mpscTICK_WRITER )
+                    {
+                        ulReceived++;
+                    }
+                }
+            }
+            else
+            {
+                ulReceived++;
+            }
+
+            /* Once the tick hook has stopped, everything it sent must also
+             * have been received. */
+            if( ( ulReceived == ulExpected ) &&
+                ( ( xWorkerChecked == pdFALSE ) || ( ulNextSequence[ mpscTICK_WRITER ] == ulTickMessagesSent ) ) )
+            {
+                xComplete = pdTRUE;
+
+                if( xTickWriterRunning == pdFALSE )
+                {
+                    xFinished = pdTRUE;
+                }
+            }
+            else
+            {
+                xComplete = pdFALSE;
+            }
+        }
+
+        xTaskNotifyGive( xControllerTask );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvGetTimeNs( void )
+{
+    struct timespec xNow;
+
+    ( void ) clock_gettime( CLOCK_MONOTONIC, &xNow );
+
+    return ( ( uint64_t ) xNow.tv_sec * 1000000000ULL ) + ( uint64_t ) xNow.tv_nsec;
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_MPSC_MESSAGE_BUFFERS == 1 */
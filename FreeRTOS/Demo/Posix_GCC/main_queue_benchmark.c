@@ -0,0 +1,479 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/******************************************************************************
+ * NOTE 1: The FreeRTOS demo threads will not be running continuously, so
+ * do not expect to get real time behaviour from the FreeRTOS Linux port, or
+ * this demo application.  The absolute numbers reported by this benchmark
+ * include the cost of the Linux port itself, where entering a critical section
+ * is a system call, so only compare them with numbers taken on the same
+ * machine.
+ *
+ * NOTE 2: This benchmark is built when USER_DEMO is set to
+ * QUEUE_BENCHMARK_DEMO, which also sets configUSE_SPSC_QUEUES to 1 (see
+ * FreeRTOSConfig.h).
+ ******************************************************************************
+ *
+ * main_queue_benchmark() compares a queue created with xQueueCreate() with a
+ * single producer single consumer queue created with xQueueCreateSPSC(), and
+ * with the same queue used through xQueueSendMultiple() and
+ * xQueueReceiveMultiple() to move queueBATCH_SIZE items per call.  All the
+ * queues hold queueQUEUE_LENGTH uint32_t items.  queueBATCH_SIZE does not
+ * divide queueQUEUE_LENGTH, so batches regularly wrap around the end of the
+ * queue storage area.
+ *
+ * First the controller task sends queueQUEUE_LENGTH items to a queue and
+ * receives them back, without blocking, queueSINGLE_TASK_ROUNDS times, and
+ * the mean time of a send and receive pair is reported.
+ *
+ * Then a producer task sends queueITEMS_TRANSFERRED items to the queue, and a
+ * consumer task at the same priority receives them.  Both block when the queue
+ * is full or empty, so the tasks alternate, each moving up to a queue full of
+ * items at a time.  The number of items moved per second is reported.  When
+ * batches are used the consumer receives up to a batch at a time.
+ *
+ * Every item carries a sequence number, which the receiver checks.  The
+ * single producer single consumer queue is also checked to report the number
+ * of items it holds, to fail a send when full and a receive when empty, and to
+ * time out a blocked receive after the block time.  The batch functions,
+ * including xQueueSendMultipleFromISR() and xQueueReceiveMultipleFromISR(),
+ * are checked to move only as many items as fit or are available.  Any error
+ * is counted, and the application exits with a failure status if there are
+ * errors.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+/* Local includes. */
+#include "console.h"
+
+#if ( configUSE_SPSC_QUEUES == 1 )
+
+/* The length of the queues, and the work each measurement does. */
+    #define queueQUEUE_LENGTH            ( 64U )
+    #define queueSINGLE_TASK_ROUNDS      ( 20000UL )
+    #define queueITEMS_TRANSFERRED       ( 2000000UL )
+    #define queueBATCH_SIZE              ( 24U )
+
+/* The block time used to check a blocked receive times out. */
+    #define queueBLOCK_TIME_TICKS        ( 10U )
+
+/* The producer and consumer share a priority, below that of the controller. */
+    #define queueWORKER_PRIORITY         ( tskIDLE_PRIORITY + 1U )
+    #define queueCONTROLLER_PRIORITY     ( tskIDLE_PRIORITY + 2U )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The tasks as described in the comments at the top of this file.
+ */
+static void prvControllerTask( void * pvParameters );
+static void prvProducerTask( void * pvParameters );
+static void prvConsumerTask( void * pvParameters );
+
+/*
+ * Time one task sending to and receiving from xQueue, and return the mean time
+ * of a send and receive pair in nanoseconds.  If xBatch is pdTRUE the items
+ * are moved with xQueueSendMultiple() and xQueueReceiveMultiple(), and the
+ * time is still that for each item.
+ */
+static double prvMeasureSingleTask( QueueHandle_t xQueue,
+                                    BaseType_t xBatch );
+
+/*
+ * Time the producer and consumer moving items through xQueue, and return the
+ * number of items moved per second.  xBatch is as for prvMeasureSingleTask().
+ */
+static double prvMeasureTwoTasks( QueueHandle_t xQueue,
+                                  BaseType_t xBatch );
+
+/*
+ * Check the batch functions move as many items as fit, or as are available,
+ * in order.
+ */
+static void prvCheckBatches( QueueHandle_t xQueue );
+
+/*
+ * Check the single producer single consumer queue behaves as a queue when it
+ * is full or empty.
+ */
+static void prvCheckFullAndEmpty( QueueHandle_t xQueue );
+
+/*
+ * Returns a monotonic time stamp in nanoseconds.
+ */
+static uint64_t prvGetTimeNs( void );
+
+/*-----------------------------------------------------------*/
+
+/* The queue the producer and consumer are to use next, and whether they move
+ * items in batches. */
+static QueueHandle_t xWorkerQueue = NULL;
+static BaseType_t xWorkerBatch = pdFALSE;
+
+/* The tasks, so they can be notified. */
+static TaskHandle_t xControllerTask = NULL;
+static TaskHandle_t xProducerTask = NULL;
+static TaskHandle_t xConsumerTask = NULL;
+
+/* The number of errors found. */
+static volatile uint32_t ulErrors = 0UL;
+
+/*-----------------------------------------------------------*/
+
+/*** SEE THE COMMENTS AT THE TOP OF THIS FILE ***/
+void main_queue_benchmark( void )
+{
+    xTaskCreate( prvControllerTask, "Control", configMINIMAL_STACK_SIZE * 2U, NULL, queueCONTROLLER_PRIORITY, &xControllerTask );
+    xTaskCreate( prvProducerTask, "Producer", configMINIMAL_STACK_SIZE, NULL, queueWORKER_PRIORITY, &xProducerTask );
+    xTaskCreate( prvConsumerTask, "Consumer", configMINIMAL_STACK_SIZE, NULL, queueWORKER_PRIORITY, &xConsumerTask );
+
+    vTaskStartScheduler();
+}
+/*-----------------------------------------------------------*/
+
+static void prvControllerTask( void * pvParameters )
+{
+    QueueHandle_t xQueue, xSPSCQueue;
+    double dQueuePairNs, dSPSCPairNs, dBatchPairNs, dQueueItemsPerSecond, dSPSCItemsPerSecond, dBatchItemsPerSecond;
+
+    ( void ) pvParameters;
+
+    xQueue = xQueueCreate( queueQUEUE_LENGTH, sizeof( uint32_t ) );
+    xSPSCQueue = xQueueCreateSPSC( queueQUEUE_LENGTH, sizeof( uint32_t ) );
+    configASSERT( xQueue );
+    configASSERT( xSPSCQueue );
+
+    dQueuePairNs = prvMeasureSingleTask( xQueue, pdFALSE );
+    dSPSCPairNs = prvMeasureSingleTask( xSPSCQueue, pdFALSE );
+    dBatchPairNs = prvMeasureSingleTask( xQueue, pdTRUE );
+
+    dQueueItemsPerSecond = prvMeasureTwoTasks( xQueue, pdFALSE );
+    dSPSCItemsPerSecond = prvMeasureTwoTasks( xSPSCQueue, pdFALSE );
+    dBatchItemsPerSecond = prvMeasureTwoTasks( xQueue, pdTRUE );
+
+    prvCheckFullAndEmpty( xSPSCQueue );
+    prvCheckBatches( xQueue );
+
+    console_print( "Queue benchmark: queues of %u uint32_t items\n", ( unsigned ) queueQUEUE_LENGTH );
+    console_print( "queue, send and receive pair (ns), producer to consumer (items/s)\n" );
+    console_print( "xQueueCreate, %.1f, %.0f\n", dQueuePairNs, dQueueItemsPerSecond );
+    console_print( "xQueueCreateSPSC, %.1f, %.0f\n", dSPSCPairNs, dSPSCItemsPerSecond );
+    console_print( "xQueueCreate batches of %u, %.1f, %.0f\n", ( unsigned ) queueBATCH_SIZE, dBatchPairNs, dBatchItemsPerSecond );
+    console_print( "errors, %lu\n", ( unsigned long ) ulErrors );
+
+    /* Exit the process directly rather than ending the scheduler, so the
+     * threads of the producer and consumer do not have to be torn down. */
+    if( ulErrors != 0UL )
+    {
+        exit( EXIT_FAILURE );
+    }
+
+    exit( EXIT_SUCCESS );
+}
+/*-----------------------------------------------------------*/
+
+static double prvMeasureSingleTask( QueueHandle_t xQueue,
+                                    BaseType_t xBatch )
+{
+    uint32_t ulRound, ulItem, ulReceived, ulCount;
+    uint32_t ulItems[ queueQUEUE_LENGTH ], ulReceivedItems[ queueQUEUE_LENGTH ];
+    uint64_t ullStartNs;
+
+    for( ulItem = 0UL; ulItem < queueQUEUE_LENGTH; ulItem++ )
+    {
+        ulItems[ ulItem ] = ulItem;
+    }
+
+    ullStartNs = prvGetTimeNs();
+
+    for( ulRound = 0UL; ( ulRound < queueSINGLE_TASK_ROUNDS ) && ( xBatch != pdFALSE ); ulRound++ )
+    {
+        /* Move the items a batch at a time.  The last batch of each round is
+         * short, so the batches wrap at a different place each round. */
+        for( ulItem = 0UL; ulItem < queueQUEUE_LENGTH; ulItem += queueBATCH_SIZE )
+        {
+            ulCount = ( ( queueQUEUE_LENGTH - ulItem ) < queueBATCH_SIZE ) ? ( queueQUEUE_LENGTH - ulItem ) : queueBATCH_SIZE;
+
+            if( xQueueSendMultiple( xQueue, &( ulItems[ ulItem ] ), ulCount, 0U ) != ( BaseType_t ) ulCount )
+            {
+                ulErrors++;
+            }
+        }
+
+        if( xQueueReceiveMultiple( xQueue, ulReceivedItems, queueQUEUE_LENGTH, 0U ) != ( BaseType_t ) queueQUEUE_LENGTH )
+        {
+            ulErrors++;
+        }
+
+        for( ulItem = 0UL; ulItem < queueQUEUE_LENGTH; ulItem++ )
+        {
+            if( ulReceivedItems[ ulItem ] != ulItem )
+            {
+                ulErrors++;
+            }
+        }
+    }
+
+    for( ulRound = 0UL; ( ulRound < queueSINGLE_TASK_ROUNDS ) && ( xBatch == pdFALSE ); ulRound++ )
+    {
+        for( ulItem = 0UL; ulItem < queueQUEUE_LENGTH; ulItem++ )
+        {
+            if( xQueueSend( xQueue, &ulItem, 0U ) != pdPASS )
+            {
+                ulErrors++;
+            }
+        }
+
+        for( ulItem = 0UL; ulItem < queueQUEUE_LENGTH; ulItem++ )
+        {
+            if( ( xQueueReceive( xQueue, &ulReceived, 0U ) != pdPASS ) || ( ulReceived != ulItem ) )
+            {
+                ulErrors++;
+            }
+        }
+    }
+
+    return ( double ) ( prvGetTimeNs() - ullStartNs ) / ( ( double ) queueSINGLE_TASK_ROUNDS * ( double ) queueQUEUE_LENGTH );
+}
+/*-----------------------------------------------------------*/
+
+static double prvMeasureTwoTasks( QueueHandle_t xQueue,
+                                  BaseType_t xBatch )
+{
+    uint64_t ullStartNs, ullDurationNs;
+
+    xWorkerQueue = xQueue;
+    xWorkerBatch = xBatch;
+
+    ullStartNs = prvGetTimeNs();
+
+    /* The controller runs above the producer and consumer, so it only runs
+     * again once both have finished. */
+    xTaskNotifyGive( xProducerTask );
+    xTaskNotifyGive( xConsumerTask );
+    ( void ) ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+    ( void ) ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+
+    ullDurationNs = prvGetTimeNs() - ullStartNs;
+
+    return ( ( double ) queueITEMS_TRANSFERRED * 1000000000.0 ) / ( double ) ullDurationNs;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckFullAndEmpty( QueueHandle_t xQueue )
+{
+    uint32_t ulItem;
+    TickType_t xStartTime;
+
+    /* Fill the queue, and check one more item does not fit. */
+    for( ulItem = 0UL; ulItem < queueQUEUE_LENGTH; ulItem++ )
+    {
+        ( void ) xQueueSend( xQueue, &ulItem, 0U );
+    }
+
+    if( ( uxQueueMessagesWaiting( xQueue ) != queueQUEUE_LENGTH ) ||
+        ( uxQueueSpacesAvailable( xQueue ) != 0U ) ||
+        ( xQueueSend( xQueue, &ulItem, 0U ) != errQUEUE_FULL ) )
+    {
+        ulErrors++;
+    }
+
+    /* Empty the queue, and check no more items can be received, either
+     * straight away or within the block time. */
+    while( xQueueReceive( xQueue, &ulItem, 0U ) == pdPASS )
+    {
+    }
+
+    if( ( uxQueueMessagesWaiting( xQueue ) != 0U ) ||
+        ( uxQueueSpacesAvailable( xQueue ) != queueQUEUE_LENGTH ) )
+    {
+        ulErrors++;
+    }
+
+    xStartTime = xTaskGetTickCount();
+
+    if( ( xQueueReceive( xQueue, &ulItem, queueBLOCK_TIME_TICKS ) != errQUEUE_EMPTY ) ||
+        ( ( xTaskGetTickCount() - xStartTime ) < queueBLOCK_TIME_TICKS ) )
+    {
+        ulErrors++;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckBatches( QueueHandle_t xQueue )
+{
+    uint32_t ulItems[ queueQUEUE_LENGTH + queueBATCH_SIZE ], ulReceived[ queueQUEUE_LENGTH + queueBATCH_SIZE ];
+    uint32_t ulItem;
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    TickType_t xStartTime;
+
+    for( ulItem = 0UL; ulItem < ( queueQUEUE_LENGTH + queueBATCH_SIZE ); ulItem++ )
+    {
+        ulItems[ ulItem ] = ulItem;
+    }
+
+    /* Move the read and write positions part way through the storage area, so
+     * the batches below wrap around its end. */
+    ( void ) xQueueSendMultiple( xQueue, ulItems, queueBATCH_SIZE, 0U );
+    ( void ) xQueueReceiveMultiple( xQueue, ulReceived, queueBATCH_SIZE, 0U );
+
+    /* Only the items that fit are sent, and a receive takes only the items
+     * that are available. */
+    if( ( xQueueSendMultipleFromISR( xQueue, ulItems, queueQUEUE_LENGTH + queueBATCH_SIZE, &xHigherPriorityTaskWoken ) != ( BaseType_t ) queueQUEUE_LENGTH ) ||
+        ( xQueueSendMultiple( xQueue, ulItems, queueBATCH_SIZE, 0U ) != 0 ) ||
+        ( xQueueReceiveMultipleFromISR( xQueue, ulReceived, queueBATCH_SIZE, &xHigherPriorityTaskWoken ) != ( BaseType_t ) queueBATCH_SIZE ) ||
+        ( xQueueReceiveMultiple( xQueue, &( ulReceived[ queueBATCH_SIZE ] ), queueQUEUE_LENGTH, 0U ) != ( BaseType_t ) ( queueQUEUE_LENGTH - queueBATCH_SIZE ) ) ||
+        ( xHigherPriorityTaskWoken != pdFALSE ) )
+    {
+        ulErrors++;
+    }
+
+    for( ulItem = 0UL; ulItem < queueQUEUE_LENGTH; ulItem++ )
+    {
+        if( ulReceived[ ulItem ] != ulItem )
+        {
+            ulErrors++;
+        }
+    }
+
+    /* Nothing is left, so a blocked receive times out. */
+    xStartTime = xTaskGetTickCount();
+
+    if( ( xQueueReceiveMultipleFromISR( xQueue, ulReceived, queueBATCH_SIZE, NULL ) != 0 ) ||
+        ( xQueueReceiveMultiple( xQueue, ulReceived, queueBATCH_SIZE, queueBLOCK_TIME_TICKS ) != 0 ) ||
+        ( ( xTaskGetTickCount() - xStartTime ) < queueBLOCK_TIME_TICKS ) )
+    {
+        ulErrors++;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvProducerTask( void * pvParameters )
+{
+    uint32_t ulItem, ulBatchItem;
+    uint32_t ulBatch[ queueBATCH_SIZE ];
+
+    ( void ) pvParameters;
+
+    for( ; ; )
+    {
+        ( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+        /* queueITEMS_TRANSFERRED is not a multiple of queueBATCH_SIZE, so the
+         * last batch is short. */
+        for( ulItem = 0UL; ( ulItem < queueITEMS_TRANSFERRED ) && ( xWorkerBatch != pdFALSE ); ulItem += ulBatchItem )
+        {
+            for( ulBatchItem = 0UL; ( ulBatchItem < queueBATCH_SIZE ) && ( ( ulItem + ulBatchItem ) < queueITEMS_TRANSFERRED ); ulBatchItem++ )
+            {
+                ulBatch[ ulBatchItem ] = ulItem + ulBatchItem;
+            }
+
+            if( xQueueSendMultiple( xWorkerQueue, ulBatch, ulBatchItem, portMAX_DELAY ) != ( BaseType_t ) ulBatchItem )
+            {
+                ulErrors++;
+            }
+        }
+
+        for( ulItem = 0UL; ( ulItem < queueITEMS_TRANSFERRED ) && ( xWorkerBatch == pdFALSE ); ulItem++ )
+        {
+            if( xQueueSend( xWorkerQueue, &ulItem, portMAX_DELAY ) != pdPASS )
+            {
+                ulErrors++;
+            }
+        }
+
+        xTaskNotifyGive( xControllerTask );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvConsumerTask( void * pvParameters )
+{
+    uint32_t ulExpected, ulReceived, ulItem;
+    uint32_t ulBatch[ queueBATCH_SIZE ];
+    BaseType_t xReceived;
+
+    ( void ) pvParameters;
+
+    for( ; ; )
+    {
+        ( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+        ulExpected = 0UL;
+
+        while( ( ulExpected < queueITEMS_TRANSFERRED ) && ( xWorkerBatch != pdFALSE ) )
+        {
+            xReceived = xQueueReceiveMultiple( xWorkerQueue, ulBatch, queueBATCH_SIZE, portMAX_DELAY );
+
+            if( xReceived == 0 )
+            {
+                ulErrors++;
+            }
+
+            for( ulItem = 0UL; ulItem < ( uint32_t ) xReceived; ulItem++ )
+            {
+                if( ulBatch[ ulItem ] != ulExpected )
+                {
+                    ulErrors++;
+                }
+
+                ulExpected++;
+            }
+        }
+
+        for( ulExpected = 0UL; ( ulExpected < queueITEMS_TRANSFERRED ) && ( xWorkerBatch == pdFALSE ); ulExpected++ )
+        {
+            if( ( xQueueReceive( xWorkerQueue, &ulReceived, portMAX_DELAY ) != pdPASS ) ||
+                ( ulReceived != ulExpected ) )
+            {
+                ulErrors++;
+            }
+        }
+
+        xTaskNotifyGive( xControllerTask );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvGetTimeNs( void )
+{
+    struct timespec xNow;
+
+    ( void ) clock_gettime( CLOCK_MONOTONIC, &xNow );
+
+    return ( ( uint64_t ) xNow.tv_sec * 1000000000ULL ) + ( uint64_t ) xNow.tv_nsec;
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_SPSC_QUEUES == 1 */
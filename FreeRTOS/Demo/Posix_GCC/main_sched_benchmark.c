@@ -0,0 +1,1057 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/******************************************************************************
+ * NOTE 1: The FreeRTOS demo threads will not be running continuously, so
+ * do not expect to get real time behaviour from the FreeRTOS Linux port, or
+ * this demo application.  The absolute numbers reported by this benchmark
+ * include the cost of the Linux port itself, so only compare them with numbers
+ * taken on the same machine.  Deadlines are judged in ticks, as the kernel
+ * judges them, and the tick period of the Linux port stretches when the
+ * processor is busy, so a latency longer than a deadline in milliseconds is not
+ * necessarily a missed deadline.
+ *
+ * NOTE 2: The scheduling policy that is measured is selected when the kernel is
+ * built.  USER_DEMO is set to SCHED_BENCHMARK_STOCK_DEMO,
+ * SCHED_BENCHMARK_EDF_DEMO, SCHED_BENCHMARK_MLFQ_DEMO or
+ * SCHED_BENCHMARK_WRR_DEMO, each of which builds this file with the kernel
+ * configured for that policy (see FreeRTOSConfig.h).
+ ******************************************************************************
+ *
+ * main_sched_benchmark() runs the same synthetic task sets under whichever
+ * scheduling policy the kernel was built with, so the policies can be compared
+ * by running each build in turn.  Every measured task is created at
+ * benchMEASURED_PRIORITY (or with xTaskCreateMLFQ() when the MLFQ scheduler is
+ * measured), so it is the policy, not the task priorities, that decides which
+ * of them runs.  A controller task of a higher priority runs the task sets one
+ * after the other:
+ *
+ * "switch":
+ * Two ping-pong tasks pass a task notification back and forth.  Each hand over
+ * makes one task ready and blocks the other, and the time from the notify to
+ * the other task running is recorded as the context switch cost.
+ *
+ * "periodic":
+ * Four periodic tasks, with periods of 5 to 40 ticks and a total utilisation of
+ * 60%, are released together.  The relative deadline of each job is its
+ * period.
+ *
+ * "sporadic":
+ * A releaser task of a higher priority releases one of three sporadic tasks
+ * after a random gap of 1 to benchSPORADIC_MAX_GAP ticks.  A release that
+ * finds the task still busy with its previous job is dropped, and counted as
+ * a missed deadline.
+ *
+ * "cpu_bound":
+ * Four spinner tasks never block, and a periodic probe task measures the
+ * latency seen by a short job while the processor is saturated.  The work
+ * completed by the spinners is reported as the throughput, along with Jain's
+ * fairness index of the work each spinner completed.
+ *
+ * The work done by each job is a busy loop calibrated at start up, so a job
+ * that is preempted takes longer to complete rather than completing early.
+ *
+ * Latencies are measured with CLOCK_MONOTONIC.  The wake latency of a periodic
+ * job is measured from the tick interrupt that released it, which is time
+ * stamped by the traceTASK_INCREMENT_TICK() hook, and the wake latency of a
+ * sporadic job is measured from the time the releaser notified it.  The
+ * response time is measured from the same point to the end of the job.
+ *
+ * Latencies are recorded in HDR style histograms, which have benchSUB_BUCKETS
+ * linear buckets for each power of two, so every value is recorded with a
+ * resolution of better than 1/benchSUB_BUCKETS of its magnitude.  When all the
+ * task sets have run, a summary of each set and the percentiles of each
+ * histogram are printed as CSV.  The non-empty buckets of every histogram are
+ * written as CSV to the file named by benchHISTOGRAM_FILE, and the application
+ * exits.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Local includes. */
+#include "console.h"
+
+/* The name of the policy being measured, which is used in the CSV output. */
+#if ( configUSE_EDF_SCHEDULER == 1 )
+    #define benchPOLICY_NAME               "edf"
+#elif ( configUSE_MLFQ_SCHEDULER == 1 )
+    #define benchPOLICY_NAME               "mlfq"
+#elif ( configUSE_WEIGHTED_ROUND_ROBIN == 1 )
+    #define benchPOLICY_NAME               "wrr"
+#else
+    #define benchPOLICY_NAME               "stock"
+#endif
+
+/* The file the histogram buckets are written to, relative to the directory
+ * the application is run from. */
+#define benchHISTOGRAM_FILE                "sched_benchmark_" benchPOLICY_NAME ".csv"
+
+/* Priorities at which the tasks are created.  The controller and the releaser
+ * of the sporadic task set must have higher priorities than the measured
+ * tasks.  When the MLFQ scheduler is measured the MLFQ levels must be below
+ * benchRELEASER_PRIORITY. */
+#define benchCONTROLLER_PRIORITY           ( configMAX_PRIORITIES - 1U )
+#define benchRELEASER_PRIORITY             ( configMAX_PRIORITIES - 2U )
+#define benchMEASURED_PRIORITY             ( tskIDLE_PRIORITY + 2U )
+
+/* The weights given to the tasks when the weighted round robin scheduler is
+ * measured.  Tasks that have deadlines get a larger share than the spinners. */
+#define benchREAL_TIME_WEIGHT              ( 4U )
+#define benchBACKGROUND_WEIGHT             ( 1U )
+
+/* The EDF deadline of the spinner tasks is far enough in the future that it
+ * never becomes the earliest while a task with a real deadline is ready. */
+#define benchBACKGROUND_DEADLINE           ( portMAX_DELAY >> 3 )
+#define benchPING_PONG_DEADLINE            ( ( TickType_t ) 10 )
+
+/* The number of hand overs timed by the switch task set, and the number of
+ * ticks each of the other task sets runs for. */
+#define benchSWITCH_ITERATIONS             ( 20000UL )
+#define benchSET_DURATION                  ( ( TickType_t ) 2000 )
+
+/* The sporadic task set. */
+#define benchSPORADIC_TASKS                ( 3U )
+#define benchSPORADIC_WORK_US              ( 1000UL )
+#define benchSPORADIC_DEADLINE             ( ( TickType_t ) 5 )
+#define benchSPORADIC_MAX_GAP              ( 4UL )
+
+/* The CPU-bound task set.  The spinners count the units of work they
+ * complete. */
+#define benchSPINNER_TASKS                 ( 4U )
+#define benchSPINNER_WORK_US               ( 100UL )
+#define benchPROBE_PERIOD                  ( ( TickType_t ) 10 )
+#define benchPROBE_WORK_US                 ( 500UL )
+
+/* The largest number of measured tasks in any one task set. */
+#define benchMAX_TASKS                     ( 5U )
+
+/* The number of loops timed to calibrate the busy loop. */
+#define benchCALIBRATION_LOOPS             ( 2000000ULL )
+
+/* The number of recent ticks whose time stamps are kept.  Must be a power of
+ * two. */
+#define benchTICK_HISTORY                  ( 1024U )
+
+/* The histograms have benchSUB_BUCKETS linear buckets for values below
+ * 2 * benchSUB_BUCKETS, then benchSUB_BUCKETS buckets for each further power of
+ * two, up to the largest 64-bit value. */
+#define benchSUB_BUCKET_BITS               ( 4U )
+#define benchSUB_BUCKETS                   ( 1U << benchSUB_BUCKET_BITS )
+#define benchHISTOGRAM_BUCKETS             ( ( ( 64U - benchSUB_BUCKET_BITS ) + 1U ) * benchSUB_BUCKETS )
+
+/* Percentiles are expressed in parts per 100000, so 99.9% is 99900. */
+#define benchPERCENTILE_SCALE              ( 100000ULL )
+
+/*-----------------------------------------------------------*/
+
+/* A latency histogram. */
+typedef struct BenchHistogram
+{
+    uint64_t ullCount;
+    uint64_t ullSumNs;
+    uint64_t ullMaxNs;
+    uint32_t ulBuckets[ benchHISTOGRAM_BUCKETS ];
+} BenchHistogram_t;
+
+/* A histogram, and the task set and metric it records. */
+typedef struct BenchMetric
+{
+    const char * pcTaskSet;
+    const char * pcMetric;
+    const BenchHistogram_t * pxHistogram;
+} BenchMetric_t;
+
+/* The state of one measured task.  The EDF scheduler reads the relative
+ * deadline of a task from its parameter, so xEDFParameters must be the first
+ * member. */
+typedef struct BenchTask
+{
+    pvParameter_t xEDFParameters;
+    TickType_t xPeriod;
+    TickType_t xDeadline;
+    uint32_t ulWorkUs;
+    BenchHistogram_t * pxWakeLatency;
+    BenchHistogram_t * pxResponseTime;
+    TaskHandle_t xHandle;
+    volatile uint32_t ulCompleted;
+    volatile uint32_t ulLate;
+    volatile uint32_t ulDropped;
+    volatile BaseType_t xBusy;
+    volatile TickType_t xReleaseTick;
+    volatile uint64_t ullReleaseNs;
+} BenchTask_t;
+
+/* The results of one task set. */
+typedef struct BenchSummary
+{
+    const char * pcTaskSet;
+    uint32_t ulJobs;
+    uint32_t ulMissed;
+    uint64_t ullWorkDone;
+    uint64_t ullElapsedNs;
+    uint32_t ulFairnessPerMille; /* 0 if not applicable. */
+} BenchSummary_t;
+
+/* The time stamp of a recent tick. */
+typedef struct BenchTickStamp
+{
+    volatile TickType_t xTick;
+    volatile uint64_t ullNs;
+} BenchTickStamp_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The tasks as described in the comments at the top of this file.
+ */
+static void prvControllerTask( void * pvParameters );
+static void prvPingPongTask( void * pvParameters );
+static void prvPeriodicTask( void * pvParameters );
+static void prvSporadicTask( void * pvParameters );
+static void prvReleaserTask( void * pvParameters );
+static void prvSpinnerTask( void * pvParameters );
+
+/*
+ * Run each task set, filling in its summary.
+ */
+static void prvRunSwitchSet( BenchSummary_t * pxSummary );
+static void prvRunPeriodicSet( BenchSummary_t * pxSummary );
+static void prvRunSporadicSet( BenchSummary_t * pxSummary );
+static void prvRunCPUBoundSet( BenchSummary_t * pxSummary );
+
+/*
+ * Create a measured task, at benchMEASURED_PRIORITY or as an MLFQ task, and
+ * give it uxWeight when the weighted round robin scheduler is measured.
+ */
+static void prvCreateMeasuredTask( TaskFunction_t pxTaskCode,
+                                   const char * const pcName,
+                                   BenchTask_t * pxTask,
+                                   UBaseType_t uxWeight );
+
+/*
+ * Ask the first uxNumTasks measured tasks, and the releaser if it is running,
+ * to delete themselves, wait until they have, and clear their state ready for
+ * the next task set.
+ */
+static void prvStopTasks( UBaseType_t uxNumTasks );
+
+/*
+ * Called by the measured tasks and the releaser each time they could stop.
+ * Deletes the calling task if the controller has asked it to stop.
+ */
+static void prvDeleteSelfIfStopped( void );
+
+/*
+ * Add the jobs completed and missed by a periodic task during a task set that
+ * ran for xDuration ticks to pxSummary.
+ */
+static void prvSummarisePeriodicTask( const BenchTask_t * pxTask,
+                                      TickType_t xDuration,
+                                      BenchSummary_t * pxSummary );
+
+/*
+ * Time the busy loop, then execute it for the given number of microseconds.
+ */
+static void prvCalibrateWork( void );
+static void prvDoWork( uint32_t ulMicroseconds );
+
+/*
+ * Returns a monotonic time stamp in nanoseconds.
+ */
+static uint64_t prvGetTimeNs( void );
+
+/*
+ * Returns the time stamp of the tick interrupt that set the tick count to
+ * xTick, or 0 if that tick is no longer in the history.
+ */
+static uint64_t prvGetTickTimeNs( TickType_t xTick );
+
+/*
+ * Histogram functions.
+ */
+static void prvRecordLatency( BenchHistogram_t * pxHistogram,
+                              uint64_t ullNs );
+static UBaseType_t prvBucketIndex( uint64_t ullValue );
+static uint64_t prvBucketLowestValue( UBaseType_t uxBucket );
+static uint64_t prvValueAtPercentile( const BenchHistogram_t * pxHistogram,
+                                      uint64_t ullPercentile );
+
+/*
+ * Print the results as CSV, and write the histogram buckets to
+ * benchHISTOGRAM_FILE.
+ */
+static void prvPrintResults( const BenchSummary_t * pxSummaries,
+                             UBaseType_t uxNumSummaries );
+static void prvWriteHistograms( void );
+
+/*
+ * Called from traceTASK_INCREMENT_TICK() to time stamp each tick.
+ */
+void vSchedBenchmarkTickHook( void );
+
+/*-----------------------------------------------------------*/
+
+/* The histograms, one for each metric recorded by each task set. */
+static BenchHistogram_t xSwitchCost;
+static BenchHistogram_t xPeriodicWake;
+static BenchHistogram_t xPeriodicResponse;
+static BenchHistogram_t xSporadicWake;
+static BenchHistogram_t xSporadicResponse;
+static BenchHistogram_t xCPUBoundWake;
+static BenchHistogram_t xCPUBoundResponse;
+
+static const BenchMetric_t xMetrics[] =
+{
+    { "switch",    "switch_cost",   &xSwitchCost       },
+    { "periodic",  "wake_latency",  &xPeriodicWake     },
+    { "periodic",  "response_time", &xPeriodicResponse },
+    { "sporadic",  "wake_latency",  &xSporadicWake     },
+    { "sporadic",  "response_time", &xSporadicResponse },
+    { "cpu_bound", "wake_latency",  &xCPUBoundWake     },
+    { "cpu_bound", "response_time", &xCPUBoundResponse }
+};
+
+/* The periods and work of the periodic task set, which uses 15% of the
+ * processor per task. */
+static const TickType_t xPeriodicPeriods[] = { 5U, 10U, 20U, 40U };
+static const uint32_t ulPeriodicWorkUs[] = { 750UL, 1500UL, 3000UL, 6000UL };
+
+static BenchTask_t xTasks[ benchMAX_TASKS ];
+static BenchTickStamp_t xTickStamps[ benchTICK_HISTORY ];
+
+static TaskHandle_t xControllerTask = NULL;
+
+/* Set by the controller at the end of each task set.  The tasks delete
+ * themselves rather than being deleted by the controller, as the Linux port
+ * cannot always cancel the thread of a task that is blocked.  uxTasksRunning
+ * counts the tasks that have not yet done so. */
+static volatile BaseType_t xStopRequested = pdFALSE;
+static volatile UBaseType_t uxTasksRunning = 0U;
+
+/* The tick count at which the periodic tasks of a task set are first
+ * released. */
+static TickType_t xSetStartTick = 0U;
+
+/* The state of the ping-pong tasks, which hand over to each other until
+ * ulSwitchesRemaining reaches zero. */
+static volatile uint32_t ulSwitchesRemaining = 0UL;
+static volatile uint64_t ullHandOverNs = 0ULL;
+
+/* The number of iterations of the busy loop executed per microsecond, and a
+ * variable the busy loop writes to so it is not optimised away. */
+static uint64_t ullLoopsPerUs = 1ULL;
+static volatile uint32_t ulWorkSink = 0UL;
+
+/*-----------------------------------------------------------*/
+
+/*** SEE THE COMMENTS AT THE TOP OF THIS FILE ***/
+void main_sched_benchmark( void )
+{
+    xTaskCreate( prvControllerTask, "Control", configMINIMAL_STACK_SIZE * 2U, NULL, benchCONTROLLER_PRIORITY, &xControllerTask );
+
+    vTaskStartScheduler();
+}
+/*-----------------------------------------------------------*/
+
+static void prvControllerTask( void * pvParameters )
+{
+    BenchSummary_t xSummaries[ 4 ] = { { 0 } };
+
+    ( void ) pvParameters;
+
+    prvCalibrateWork();
+
+    prvRunSwitchSet( &( xSummaries[ 0 ] ) );
+    prvRunPeriodicSet( &( xSummaries[ 1 ] ) );
+    prvRunSporadicSet( &( xSummaries[ 2 ] ) );
+    prvRunCPUBoundSet( &( xSummaries[ 3 ] ) );
+
+    prvPrintResults( xSummaries, sizeof( xSummaries ) / sizeof( xSummaries[ 0 ] ) );
+    prvWriteHistograms();
+
+    console_print( "Scheduler benchmark complete\n" );
+
+    /* Exit the process directly rather than ending the scheduler, as the
+     * other demos that measure the scheduler do. */
+    exit( EXIT_SUCCESS );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunSwitchSet( BenchSummary_t * pxSummary )
+{
+    uint64_t ullStart;
+
+    xTasks[ 0 ].xEDFParameters.uxDeadLine = benchPING_PONG_DEADLINE;
+    xTasks[ 1 ].xEDFParameters.uxDeadLine = benchPING_PONG_DEADLINE;
+    prvCreateMeasuredTask( prvPingPongTask, "Ping", &( xTasks[ 0 ] ), benchBACKGROUND_WEIGHT );
+    prvCreateMeasuredTask( prvPingPongTask, "Pong", &( xTasks[ 1 ] ), benchBACKGROUND_WEIGHT );
+
+    ulSwitchesRemaining = benchSWITCH_ITERATIONS;
+    ullHandOverNs = 0ULL;
+    ullStart = prvGetTimeNs();
+
+    /* Start the exchange then wait for the ping-pong tasks to report that the
+     * requested number of hand overs have been performed. */
+    xTaskNotifyGive( xTasks[ 0 ].xHandle );
+    ( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+    pxSummary->pcTaskSet = "switch";
+    pxSummary->ulJobs = benchSWITCH_ITERATIONS;
+    pxSummary->ullWorkDone = benchSWITCH_ITERATIONS;
+    pxSummary->ullElapsedNs = prvGetTimeNs() - ullStart;
+
+    prvStopTasks( 2U );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunPeriodicSet( BenchSummary_t * pxSummary )
+{
+    UBaseType_t uxTask;
+    const UBaseType_t uxNumTasks = sizeof( xPeriodicPeriods ) / sizeof( xPeriodicPeriods[ 0 ] );
+    uint64_t ullStart;
+
+    /* All the tasks are first released on the same tick, which is the worst
+     * case for a periodic task set. */
+    xSetStartTick = xTaskGetTickCount() + 1U;
+
+    for( uxTask = 0U; uxTask < uxNumTasks; uxTask++ )
+    {
+        xTasks[ uxTask ].xEDFParameters.uxDeadLine = xPeriodicPeriods[ uxTask ];
+        xTasks[ uxTask ].xPeriod = xPeriodicPeriods[ uxTask ];
+        xTasks[ uxTask ].xDeadline = xPeriodicPeriods[ uxTask ];
+        xTasks[ uxTask ].ulWorkUs = ulPeriodicWorkUs[ uxTask ];
+        xTasks[ uxTask ].pxWakeLatency = &xPeriodicWake;
+        xTasks[ uxTask ].pxResponseTime = &xPeriodicResponse;
+        prvCreateMeasuredTask( prvPeriodicTask, "Periodic", &( xTasks[ uxTask ] ), benchREAL_TIME_WEIGHT );
+    }
+
+    ullStart = prvGetTimeNs();
+    vTaskDelay( benchSET_DURATION + 1U );
+
+    pxSummary->pcTaskSet = "periodic";
+    pxSummary->ullElapsedNs = prvGetTimeNs() - ullStart;
+
+    for( uxTask = 0U; uxTask < uxNumTasks; uxTask++ )
+    {
+        prvSummarisePeriodicTask( &( xTasks[ uxTask ] ), benchSET_DURATION, pxSummary );
+    }
+
+    pxSummary->ullWorkDone = pxSummary->ulJobs - pxSummary->ulMissed;
+
+    prvStopTasks( uxNumTasks );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunSporadicSet( BenchSummary_t * pxSummary )
+{
+    UBaseType_t uxTask;
+    uint64_t ullStart;
+
+    for( uxTask = 0U; uxTask < benchSPORADIC_TASKS; uxTask++ )
+    {
+        xTasks[ uxTask ].xEDFParameters.uxDeadLine = benchSPORADIC_DEADLINE;
+        xTasks[ uxTask ].xDeadline = benchSPORADIC_DEADLINE;
+        xTasks[ uxTask ].ulWorkUs = benchSPORADIC_WORK_US;
+        xTasks[ uxTask ].pxWakeLatency = &xSporadicWake;
+        xTasks[ uxTask ].pxResponseTime = &xSporadicResponse;
+        prvCreateMeasuredTask( prvSporadicTask, "Sporadic", &( xTasks[ uxTask ] ), benchREAL_TIME_WEIGHT );
+    }
+
+    ullStart = prvGetTimeNs();
+    uxTasksRunning++;
+    xTaskCreate( prvReleaserTask, "Release", configMINIMAL_STACK_SIZE, NULL, benchRELEASER_PRIORITY, NULL );
+    vTaskDelay( benchSET_DURATION );
+
+    /* Jobs that are still running are neither counted as completed nor as
+     * missed. */
+    pxSummary->pcTaskSet = "sporadic";
+    pxSummary->ullElapsedNs = prvGetTimeNs() - ullStart;
+
+    for( uxTask = 0U; uxTask < benchSPORADIC_TASKS; uxTask++ )
+    {
+        pxSummary->ulJobs += xTasks[ uxTask ].ulCompleted + xTasks[ uxTask ].ulDropped;
+        pxSummary->ulMissed += xTasks[ uxTask ].ulLate + xTasks[ uxTask ].ulDropped;
+        pxSummary->ullWorkDone += xTasks[ uxTask ].ulCompleted - xTasks[ uxTask ].ulLate;
+    }
+
+    prvStopTasks( benchSPORADIC_TASKS );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunCPUBoundSet( BenchSummary_t * pxSummary )
+{
+    UBaseType_t uxTask;
+    uint64_t ullStart, ullUnits, ullSum = 0ULL, ullSumOfSquares = 0ULL;
+
+    /* The probe task is the last task, after the spinners. */
+    for( uxTask = 0U; uxTask < benchSPINNER_TASKS; uxTask++ )
+    {
+        xTasks[ uxTask ].xEDFParameters.uxDeadLine = benchBACKGROUND_DEADLINE;
+        xTasks[ uxTask ].ulWorkUs = benchSPINNER_WORK_US;
+        prvCreateMeasuredTask( prvSpinnerTask, "Spinner", &( xTasks[ uxTask ] ), benchBACKGROUND_WEIGHT );
+    }
+
+    xSetStartTick = xTaskGetTickCount() + 1U;
+    xTasks[ benchSPINNER_TASKS ].xEDFParameters.uxDeadLine = benchPROBE_PERIOD;
+    xTasks[ benchSPINNER_TASKS ].xPeriod = benchPROBE_PERIOD;
+    xTasks[ benchSPINNER_TASKS ].xDeadline = benchPROBE_PERIOD;
+    xTasks[ benchSPINNER_TASKS ].ulWorkUs = benchPROBE_WORK_US;
+    xTasks[ benchSPINNER_TASKS ].pxWakeLatency = &xCPUBoundWake;
+    xTasks[ benchSPINNER_TASKS ].pxResponseTime = &xCPUBoundResponse;
+    prvCreateMeasuredTask( prvPeriodicTask, "Probe", &( xTasks[ benchSPINNER_TASKS ] ), benchREAL_TIME_WEIGHT );
+
+    ullStart = prvGetTimeNs();
+    vTaskDelay( benchSET_DURATION + 1U );
+
+    pxSummary->pcTaskSet = "cpu_bound";
+    pxSummary->ullElapsedNs = prvGetTimeNs() - ullStart;
+
+    prvSummarisePeriodicTask( &( xTasks[ benchSPINNER_TASKS ] ), benchSET_DURATION, pxSummary );
+
+    /* Jain's fairness index is (sum x)^2 / (n * sum x^2), which is 1 when
+     * every spinner completed the same work, and 1/n when one spinner
+     * completed all of it. */
+    for( uxTask = 0U; uxTask < benchSPINNER_TASKS; uxTask++ )
+    {
+        ullUnits = xTasks[ uxTask ].ulCompleted;
+        ullSum += ullUnits;
+        ullSumOfSquares += ullUnits * ullUnits;
+    }
+
+    pxSummary->ullWorkDone = ullSum;
+
+    if( ullSumOfSquares > 0ULL )
+    {
+        pxSummary->ulFairnessPerMille = ( uint32_t ) ( ( ullSum * ullSum * 1000ULL ) / ( ( uint64_t ) benchSPINNER_TASKS * ullSumOfSquares ) );
+    }
+
+    prvStopTasks( benchSPINNER_TASKS + 1U );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCreateMeasuredTask( TaskFunction_t pxTaskCode,
+                                   const char * const pcName,
+                                   BenchTask_t * pxTask,
+                                   UBaseType_t uxWeight )
+{
+    uxTasksRunning++;
+
+    #if ( configUSE_MLFQ_SCHEDULER == 1 )
+    {
+        xTaskCreateMLFQ( pxTaskCode, pcName, configMINIMAL_STACK_SIZE, pxTask, &( pxTask->xHandle ) );
+    }
+    #else
+    {
+        xTaskCreate( pxTaskCode, pcName, configMINIMAL_STACK_SIZE, pxTask, benchMEASURED_PRIORITY, &( pxTask->xHandle ) );
+    }
+    #endif
+
+    #if ( configUSE_WEIGHTED_ROUND_ROBIN == 1 )
+    {
+        vTaskSetWeight( pxTask->xHandle, uxWeight );
+    }
+    #else
+    {
+        ( void ) uxWeight;
+    }
+    #endif
+
+    configASSERT( pxTask->xHandle );
+}
+/*-----------------------------------------------------------*/
+
+static void prvStopTasks( UBaseType_t uxNumTasks )
+{
+    UBaseType_t uxTask;
+
+    xStopRequested = pdTRUE;
+
+    /* Wake the tasks that are waiting for a notification.  The others stop
+     * at the end of their current delay or unit of work. */
+    for( uxTask = 0U; uxTask < uxNumTasks; uxTask++ )
+    {
+        xTaskNotifyGive( xTasks[ uxTask ].xHandle );
+    }
+
+    while( uxTasksRunning > 0U )
+    {
+        vTaskDelay( 1U );
+    }
+
+    xStopRequested = pdFALSE;
+    memset( xTasks, 0x00, sizeof( xTasks ) );
+
+    /* Let the idle task free the deleted tasks before the next task set. */
+    vTaskDelay( 2U );
+}
+/*-----------------------------------------------------------*/
+
+static void prvDeleteSelfIfStopped( void )
+{
+    if( xStopRequested != pdFALSE )
+    {
+        taskENTER_CRITICAL();
+        {
+            uxTasksRunning--;
+        }
+        taskEXIT_CRITICAL();
+
+        vTaskDelete( NULL );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvSummarisePeriodicTask( const BenchTask_t * pxTask,
+                                      TickType_t xDuration,
+                                      BenchSummary_t * pxSummary )
+{
+    uint32_t ulDue;
+
+    /* The number of jobs whose deadline passed within the task set, which is
+     * also the number of jobs that missed their deadline if the task never
+     * ran at all. */
+    ulDue = ( uint32_t ) ( xDuration / pxTask->xPeriod );
+
+    if( ulDue > 0UL )
+    {
+        ulDue--;
+    }
+
+    pxSummary->ulMissed += pxTask->ulLate;
+
+    if( pxTask->ulCompleted < ulDue )
+    {
+        pxSummary->ulJobs += ulDue;
+        pxSummary->ulMissed += ulDue - pxTask->ulCompleted;
+    }
+    else
+    {
+        pxSummary->ulJobs += pxTask->ulCompleted;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvPingPongTask( void * pvParameters )
+{
+    BenchTask_t * pxSelf = ( BenchTask_t * ) pvParameters;
+    TaskHandle_t xPartner;
+    uint64_t ullNow;
+
+    /* The ping task is the first task and the pong task the second. */
+    xPartner = ( pxSelf == &( xTasks[ 0 ] ) ) ? xTasks[ 1 ].xHandle : xTasks[ 0 ].xHandle;
+
+    for( ; ; )
+    {
+        ( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+        ullNow = prvGetTimeNs();
+        prvDeleteSelfIfStopped();
+
+        if( ullHandOverNs != 0ULL )
+        {
+            prvRecordLatency( &xSwitchCost, ullNow - ullHandOverNs );
+        }
+
+        if( ulSwitchesRemaining > 0UL )
+        {
+            ulSwitchesRemaining--;
+            ullHandOverNs = prvGetTimeNs();
+            xTaskNotifyGive( xPartner );
+        }
+        else
+        {
+            xTaskNotifyGive( xControllerTask );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvPeriodicTask( void * pvParameters )
+{
+    BenchTask_t * pxSelf = ( BenchTask_t * ) pvParameters;
+    TickType_t xReleaseTick = xSetStartTick - pxSelf->xPeriod;
+    uint64_t ullReleaseNs;
+
+    for( ; ; )
+    {
+        vTaskDelayUntil( &xReleaseTick, pxSelf->xPeriod );
+        prvDeleteSelfIfStopped();
+
+        /* A job that is released more than benchTICK_HISTORY ticks late is
+         * counted, but its latencies are not recorded. */
+        ullReleaseNs = prvGetTickTimeNs( xReleaseTick );
+
+        if( ullReleaseNs != 0ULL )
+        {
+            prvRecordLatency( pxSelf->pxWakeLatency, prvGetTimeNs() - ullReleaseNs );
+        }
+
+        prvDoWork( pxSelf->ulWorkUs );
+
+        if( ullReleaseNs != 0ULL )
+        {
+            prvRecordLatency( pxSelf->pxResponseTime, prvGetTimeNs() - ullReleaseNs );
+        }
+
+        if( ( xTaskGetTickCount() - xReleaseTick ) >= pxSelf->xDeadline )
+        {
+            pxSelf->ulLate++;
+        }
+
+        pxSelf->ulCompleted++;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvSporadicTask( void * pvParameters )
+{
+    BenchTask_t * pxSelf = ( BenchTask_t * ) pvParameters;
+
+    for( ; ; )
+    {
+        ( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+        prvDeleteSelfIfStopped();
+
+        prvRecordLatency( pxSelf->pxWakeLatency, prvGetTimeNs() - pxSelf->ullReleaseNs );
+        prvDoWork( pxSelf->ulWorkUs );
+        prvRecordLatency( pxSelf->pxResponseTime, prvGetTimeNs() - pxSelf->ullReleaseNs );
+
+        if( ( xTaskGetTickCount() - pxSelf->xReleaseTick ) >= pxSelf->xDeadline )
+        {
+            pxSelf->ulLate++;
+        }
+
+        pxSelf->ulCompleted++;
+        pxSelf->xBusy = pdFALSE;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvReleaserTask( void * pvParameters )
+{
+    BenchTask_t * pxTask;
+    uint32_t ulSeed = 0x12345678UL;
+
+    ( void ) pvParameters;
+
+    for( ; ; )
+    {
+        /* A simple LCG picks the gap before the next release and the task that
+         * is released, so every policy sees the same sequence of releases. */
+        ulSeed = ( ulSeed * 1103515245UL ) + 12345UL;
+        vTaskDelay( ( TickType_t ) ( 1UL + ( ( ulSeed >> 16 ) % benchSPORADIC_MAX_GAP ) ) );
+        prvDeleteSelfIfStopped();
+
+        ulSeed = ( ulSeed * 1103515245UL ) + 12345UL;
+        pxTask = &( xTasks[ ( ulSeed >> 16 ) % benchSPORADIC_TASKS ] );
+
+        if( pxTask->xBusy != pdFALSE )
+        {
+            pxTask->ulDropped++;
+        }
+        else
+        {
+            pxTask->xBusy = pdTRUE;
+            pxTask->xReleaseTick = xTaskGetTickCount();
+            pxTask->ullReleaseNs = prvGetTimeNs();
+            xTaskNotifyGive( pxTask->xHandle );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvSpinnerTask( void * pvParameters )
+{
+    BenchTask_t * pxSelf = ( BenchTask_t * ) pvParameters;
+
+    for( ; ; )
+    {
+        prvDoWork( pxSelf->ulWorkUs );
+        prvDeleteSelfIfStopped();
+        pxSelf->ulCompleted++;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvCalibrateWork( void )
+{
+    uint64_t ullStart, ullElapsedNs, ullLoop;
+
+    ullStart = prvGetTimeNs();
+
+    for( ullLoop = 0ULL; ullLoop < benchCALIBRATION_LOOPS; ullLoop++ )
+    {
+        ulWorkSink++;
+    }
+
+    ullElapsedNs = prvGetTimeNs() - ullStart;
+    ullLoopsPerUs = ( benchCALIBRATION_LOOPS * 1000ULL ) / ( ullElapsedNs + 1ULL );
+
+    if( ullLoopsPerUs == 0ULL )
+    {
+        ullLoopsPerUs = 1ULL;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvDoWork( uint32_t ulMicroseconds )
+{
+    uint64_t ullLoop;
+    const uint64_t ullLoops = ( uint64_t ) ulMicroseconds * ullLoopsPerUs;
+
+    for( ullLoop = 0ULL; ullLoop < ullLoops; ullLoop++ )
+    {
+        ulWorkSink++;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvGetTimeNs( void )
+{
+    struct timespec xTimeSpec;
+
+    clock_gettime( CLOCK_MONOTONIC, &xTimeSpec );
+
+    return ( ( uint64_t ) xTimeSpec.tv_sec * 1000000000ULL ) + ( uint64_t ) xTimeSpec.tv_nsec;
+}
+/*-----------------------------------------------------------*/
+
+void vSchedBenchmarkTickHook( void )
+{
+    /* Called before the tick count is incremented, so this is the time stamp
+     * of the tick that sets the tick count to one more than its current
+     * value. */
+    const TickType_t xTick = xTaskGetTickCount() + 1U;
+    BenchTickStamp_t * pxStamp = &( xTickStamps[ xTick & ( benchTICK_HISTORY - 1U ) ] );
+
+    pxStamp->ullNs = prvGetTimeNs();
+    pxStamp->xTick = xTick;
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvGetTickTimeNs( TickType_t xTick )
+{
+    const BenchTickStamp_t * pxStamp = &( xTickStamps[ xTick & ( benchTICK_HISTORY - 1U ) ] );
+    uint64_t ullReturn = 0ULL;
+
+    if( pxStamp->xTick == xTick )
+    {
+        ullReturn = pxStamp->ullNs;
+    }
+
+    return ullReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRecordLatency( BenchHistogram_t * pxHistogram,
+                              uint64_t ullNs )
+{
+    /* Samples taken after the end of the task set are not recorded.  The
+     * measured tasks can preempt each other, but the histograms are not
+     * accessed from interrupts, so suspending the scheduler is enough. */
+    if( xStopRequested == pdFALSE )
+    {
+        vTaskSuspendAll();
+        {
+            pxHistogram->ulBuckets[ prvBucketIndex( ullNs ) ]++;
+            pxHistogram->ullCount++;
+            pxHistogram->ullSumNs += ullNs;
+
+            if( ullNs > pxHistogram->ullMaxNs )
+            {
+                pxHistogram->ullMaxNs = ullNs;
+            }
+        }
+        ( void ) xTaskResumeAll();
+    }
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvBucketIndex( uint64_t ullValue )
+{
+    UBaseType_t uxShift = 0U;
+
+    /* Find the shift that brings the value into the range of the top half of
+     * the sub-buckets. */
+    while( ( ullValue >> uxShift ) >= ( 2U * benchSUB_BUCKETS ) )
+    {
+        uxShift++;
+    }
+
+    return ( uxShift * benchSUB_BUCKETS ) + ( UBaseType_t ) ( ullValue >> uxShift );
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvBucketLowestValue( UBaseType_t uxBucket )
+{
+    UBaseType_t uxShift = 0U;
+
+    if( uxBucket >= ( 2U * benchSUB_BUCKETS ) )
+    {
+        uxShift = ( uxBucket / benchSUB_BUCKETS ) - 1U;
+    }
+
+    return ( uint64_t ) ( uxBucket - ( uxShift * benchSUB_BUCKETS ) ) << uxShift;
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvValueAtPercentile( const BenchHistogram_t * pxHistogram,
+                                      uint64_t ullPercentile )
+{
+    UBaseType_t uxBucket;
+    uint64_t ullTarget, ullSeen = 0ULL, ullReturn = 0ULL;
+
+    /* The value reported is the highest value of the bucket that holds the
+     * sample at the percentile, capped at the largest sample. */
+    ullTarget = ( ( pxHistogram->ullCount * ullPercentile ) + benchPERCENTILE_SCALE - 1ULL ) / benchPERCENTILE_SCALE;
+
+    if( ullTarget == 0ULL )
+    {
+        ullTarget = 1ULL;
+    }
+
+    for( uxBucket = 0U; uxBucket < benchHISTOGRAM_BUCKETS; uxBucket++ )
+    {
+        ullSeen += pxHistogram->ulBuckets[ uxBucket ];
+
+        if( ullSeen >= ullTarget )
+        {
+            ullReturn = ( uxBucket + 1U < benchHISTOGRAM_BUCKETS ) ? prvBucketLowestValue( uxBucket + 1U ) - 1ULL : UINT64_MAX;
+            break;
+        }
+    }
+
+    if( ullReturn > pxHistogram->ullMaxNs )
+    {
+        ullReturn = pxHistogram->ullMaxNs;
+    }
+
+    return ullReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvPrintResults( const BenchSummary_t * pxSummaries,
+                             UBaseType_t uxNumSummaries )
+{
+    UBaseType_t ux;
+    const BenchHistogram_t * pxHistogram;
+
+    console_print( "policy,task_set,jobs,missed,miss_ratio,throughput_per_s,fairness\n" );
+
+    for( ux = 0U; ux < uxNumSummaries; ux++ )
+    {
+        console_print( "%s,%s,%lu,%lu,%.4f,%.1f,",
+                       benchPOLICY_NAME,
+                       pxSummaries[ ux ].pcTaskSet,
+                       ( unsigned long ) pxSummaries[ ux ].ulJobs,
+                       ( unsigned long ) pxSummaries[ ux ].ulMissed,
+                       ( pxSummaries[ ux ].ulJobs > 0UL ) ? ( double ) pxSummaries[ ux ].ulMissed / ( double ) pxSummaries[ ux ].ulJobs : 0.0,
+                       ( double ) pxSummaries[ ux ].ullWorkDone * 1e9 / ( double ) ( pxSummaries[ ux ].ullElapsedNs + 1ULL ) );
+
+        if( pxSummaries[ ux ].ulFairnessPerMille != 0UL )
+        {
+            console_print( "%.3f\n", ( double ) pxSummaries[ ux ].ulFairnessPerMille / 1000.0 );
+        }
+        else
+        {
+            console_print( "\n" );
+        }
+    }
+
+    console_print( "\npolicy,task_set,metric,samples,mean_ns,p50_ns,p90_ns,p99_ns,p99.9_ns,max_ns\n" );
+
+    for( ux = 0U; ux < ( sizeof( xMetrics ) / sizeof( xMetrics[ 0 ] ) ); ux++ )
+    {
+        pxHistogram = xMetrics[ ux ].pxHistogram;
+
+        console_print( "%s,%s,%s,%llu,%llu,%llu,%llu,%llu,%llu,%llu\n",
+                       benchPOLICY_NAME,
+                       xMetrics[ ux ].pcTaskSet,
+                       xMetrics[ ux ].pcMetric,
+                       ( unsigned long long ) pxHistogram->ullCount,
+                       ( unsigned long long ) ( ( pxHistogram->ullCount > 0ULL ) ? ( pxHistogram->ullSumNs / pxHistogram->ullCount ) : 0ULL ),
+                       ( unsigned long long ) prvValueAtPercentile( pxHistogram, 50000ULL ),
+                       ( unsigned long long ) prvValueAtPercentile( pxHistogram, 90000ULL ),
+                       ( unsigned long long ) prvValueAtPercentile( pxHistogram, 99000ULL ),
+                       ( unsigned long long ) prvValueAtPercentile( pxHistogram, 99900ULL ),
+                       ( unsigned long long ) pxHistogram->ullMaxNs );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvWriteHistograms( void )
+{
+    FILE * pxFile;
+    UBaseType_t ux, uxBucket;
+    const BenchHistogram_t * pxHistogram;
+    uint64_t ullCumulative;
+
+    pxFile = fopen( benchHISTOGRAM_FILE, "w" );
+
+    if( pxFile == NULL )
+    {
+        console_print( "Could not open %s\n", benchHISTOGRAM_FILE );
+    }
+    else
+    {
+        fprintf( pxFile, "policy,task_set,metric,bucket_low_ns,bucket_high_ns,count,cumulative_count,cumulative_percent\n" );
+
+        for( ux = 0U; ux < ( sizeof( xMetrics ) / sizeof( xMetrics[ 0 ] ) ); ux++ )
+        {
+            pxHistogram = xMetrics[ ux ].pxHistogram;
+            ullCumulative = 0ULL;
+
+            for( uxBucket = 0U; uxBucket < benchHISTOGRAM_BUCKETS; uxBucket++ )
+            {
+                if( pxHistogram->ulBuckets[ uxBucket ] != 0UL )
+                {
+                    ullCumulative += pxHistogram->ulBuckets[ uxBucket ];
+
+                    fprintf( pxFile, "%s,%s,%s,%llu,%llu,%lu,%llu,%.6f\n",
+                             benchPOLICY_NAME,
+                             xMetrics[ ux ].pcTaskSet,
+                             xMetrics[ ux ].pcMetric,
+                             ( unsigned long long ) prvBucketLowestValue( uxBucket ),
+                             ( unsigned long long ) ( ( uxBucket + 1U < benchHISTOGRAM_BUCKETS ) ? prvBucketLowestValue( uxBucket + 1U ) - 1ULL : UINT64_MAX ),
+                             ( unsigned long ) pxHistogram->ulBuckets[ uxBucket ],
+                             ( unsigned long long ) ullCumulative,
+                             ( double ) ullCumulative * 100.0 / ( double ) pxHistogram->ullCount );
+                }
+            }
+        }
+
+        fclose( pxFile );
+
+        console_print( "\nHistograms written to %s\n", benchHISTOGRAM_FILE );
+    }
+}
+/*-----------------------------------------------------------*/
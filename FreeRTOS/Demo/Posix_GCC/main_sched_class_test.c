@@ -0,0 +1,345 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/******************************************************************************
+ * NOTE 1: This file is only built into a working application when USER_DEMO is
+ * set to SCHED_CLASS_TEST_DEMO, which builds the kernel with the EDF, weighted
+ * round robin and MLFQ schedulers each given a band of priorities (see
+ * FreeRTOSConfig.h).
+ *
+ * NOTE 2: The FreeRTOS demo threads will not be running continuously, so the
+ * processor time each task receives is not exactly repeatable.  The checks
+ * made by this test allow for that.
+ ******************************************************************************
+ *
+ * main_sched_class_test() checks that each scheduling class only schedules the
+ * tasks of its own band of priorities:
+ *
+ * Priority 1 is the weighted round robin band, priorities 2 and 3 are the MLFQ
+ * band and priority 4 is the EDF band.  Priorities 0, 5 and 6 are scheduled by
+ * fixed priority.  A controller task at priority 6 runs the test in four
+ * phases.
+ *
+ * 1) EDF.  Three tasks are created in the EDF band with their deadlines out of
+ *    order, and must first run in deadline order.  An EDF task then creates a
+ *    task with an earlier deadline, which must preempt it, and a task with a
+ *    later deadline, which must not.
+ *
+ * 2) Weighted round robin.  Two "spinner" tasks that never block are created in
+ *    the weighted round robin band with weights 1 and 3, and must share the
+ *    processor in that proportion.  The tick hook counts the ticks that occur
+ *    while each spinner is running.
+ *
+ * 3) MLFQ.  A spinner created by xTaskCreateMLFQ() starts on the top MLFQ level
+ *    and must be moved to the lowest level once it has used its time slice.
+ *    The weighted round robin spinners are of a lower priority, so must not
+ *    run.
+ *
+ * 4) Fixed priority.  Two spinners of the same priority above the other bands
+ *    must share the processor equally.
+ *
+ * The spinners are passed a string as their parameter, which would fail the
+ * deadline assert if it were read as a pvParameter_t.  The result is printed
+ * and the application exits with EXIT_SUCCESS or EXIT_FAILURE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Local includes. */
+#include "console.h"
+
+#if ( configUSE_EDF_SCHEDULER == 1 ) && ( configUSE_WEIGHTED_ROUND_ROBIN == 1 ) && ( configUSE_MLFQ_SCHEDULER == 1 )
+
+    #define classWRR_PRIORITY           ( configWRR_LOWEST_PRIORITY )
+    #define classEDF_PRIORITY           ( configEDF_LOWEST_PRIORITY )
+    #define classFIXED_PRIORITY         ( configEDF_HIGHEST_PRIORITY + 1U )
+    #define classCONTROLLER_PRIORITY    ( configMAX_PRIORITIES - 1U )
+
+/* The spinners whose ticks are counted by the tick hook. */
+    #define classWRR_LIGHT              ( 0U )
+    #define classWRR_HEAVY              ( 1U )
+    #define classMLFQ_SPINNER           ( 2U )
+    #define classFIXED_FIRST            ( 3U )
+    #define classFIXED_SECOND           ( 4U )
+    #define classNUM_SPINNERS           ( 5U )
+
+    #define classNUM_ORDERED            ( 3U )
+
+/* The number of ticks each sharing measurement lasts, and the number of ticks
+ * by which a spinner's share may differ from its expected share. */
+    #define classWINDOW_TICKS           ( ( TickType_t ) 400 )
+    #define classTICK_TOLERANCE         ( 2UL * ( uint32_t ) configSLICE_INTERVAL )
+
+/* Long enough for the MLFQ spinner to use the time slices of both levels. */
+    #define classMLFQ_TICKS             ( ( TickType_t ) 20 )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The tasks as described in the comments at the top of this file.
+ */
+    static void prvControllerTask( void * pvParameters );
+    static void prvSpinnerTask( void * pvParameters );
+    static void prvOrderedTask( void * pvParameters );
+    static void prvPreemptedTask( void * pvParameters );
+    static void prvFlagTask( void * pvParameters );
+
+/*
+ * Delay for xTicks and return the number of ticks each spinner received in
+ * that time in pulTicks.
+ */
+    static void prvMeasure( TickType_t xTicks,
+                            uint32_t * pulTicks );
+
+/*
+ * Report a failure if ulValue is further than ulTolerance from ulExpected.
+ */
+    static uint32_t prvCheck( const char * pcName,
+                              uint32_t ulValue,
+                              uint32_t ulExpected,
+                              uint32_t ulTolerance );
+
+/*
+ * Called by the traceTASK_INCREMENT_TICK() macro defined in FreeRTOSConfig.h.
+ */
+    void vSchedClassTestTickHook( void );
+
+/*-----------------------------------------------------------*/
+
+    static pvParameter_t xOrderedParameters[ classNUM_ORDERED ] = { { 30U }, { 10U }, { 20U } };
+    static const UBaseType_t uxExpectedOrder[ classNUM_ORDERED ] = { 1U, 2U, 0U };
+    static UBaseType_t uxOrder[ classNUM_ORDERED ];
+    static volatile UBaseType_t uxOrderedRuns = 0U;
+
+    static pvParameter_t xPreemptedParameters = { 200U };
+    static pvParameter_t xEarlierParameters = { 5U };
+    static pvParameter_t xLaterParameters = { 1000U };
+    static volatile BaseType_t xEarlierRan = pdFALSE;
+    static volatile BaseType_t xLaterRan = pdFALSE;
+    static volatile BaseType_t xEarlierPreempted = pdFALSE;
+    static volatile BaseType_t xLaterPreempted = pdFALSE;
+
+    static volatile uint32_t ulTicks[ classNUM_SPINNERS ];
+    static TaskHandle_t xSpinners[ classNUM_SPINNERS ];
+
+/*-----------------------------------------------------------*/
+
+/*** SEE THE COMMENTS AT THE TOP OF THIS FILE ***/
+    void main_sched_class_test( void )
+    {
+        xTaskCreate( prvControllerTask, "Control", configMINIMAL_STACK_SIZE * 2U, NULL, classCONTROLLER_PRIORITY, NULL );
+
+        vTaskStartScheduler();
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvControllerTask( void * pvParameters )
+    {
+        UBaseType_t ux;
+        uint32_t ulFailures = 0UL;
+        uint32_t ulReceived[ classNUM_SPINNERS ];
+
+        ( void ) pvParameters;
+
+        /* Phase 1, EDF.  The tasks are created while the controller runs, so
+         * they are all ready before the first of them is selected. */
+        for( ux = 0U; ux < classNUM_ORDERED; ux++ )
+        {
+            xTaskCreate( prvOrderedTask, "Ordered", configMINIMAL_STACK_SIZE, &( xOrderedParameters[ ux ] ), classEDF_PRIORITY, NULL );
+        }
+
+        xTaskCreate( prvPreemptedTask, "Preempted", configMINIMAL_STACK_SIZE, &xPreemptedParameters, classEDF_PRIORITY, NULL );
+        vTaskDelay( 10 );
+
+        for( ux = 0U; ux < classNUM_ORDERED; ux++ )
+        {
+            if( ( ux >= uxOrderedRuns ) || ( uxOrder[ ux ] != uxExpectedOrder[ ux ] ) )
+            {
+                console_print( "Scheduling class test: EDF task %u ran out of deadline order\n", ( unsigned ) ux );
+                ulFailures++;
+            }
+        }
+
+        if( ( xEarlierPreempted == pdFALSE ) || ( xLaterPreempted != pdFALSE ) || ( xLaterRan == pdFALSE ) )
+        {
+            console_print( "Scheduling class test: EDF preemption, earlier deadline %s, later deadline %s\n",
+                           ( xEarlierPreempted != pdFALSE ) ? "preempted" : "did not preempt",
+                           ( xLaterPreempted != pdFALSE ) ? "preempted" : "did not preempt" );
+            ulFailures++;
+        }
+
+        console_print( "Scheduling class test: EDF phase complete\n" );
+
+        /* Phase 2, weighted round robin. */
+        xTaskCreate( prvSpinnerTask, "Light", configMINIMAL_STACK_SIZE, ( void * ) "not a deadline", classWRR_PRIORITY, &( xSpinners[ classWRR_LIGHT ] ) );
+        vTaskSetWeight( xSpinners[ classWRR_LIGHT ], 1U );
+        xTaskCreate( prvSpinnerTask, "Heavy", configMINIMAL_STACK_SIZE, ( void * ) "not a deadline", classWRR_PRIORITY, &( xSpinners[ classWRR_HEAVY ] ) );
+        vTaskSetWeight( xSpinners[ classWRR_HEAVY ], 3U );
+
+        prvMeasure( classWINDOW_TICKS, ulReceived );
+        ulFailures += prvCheck( "WRR weight 1", ulReceived[ classWRR_LIGHT ], ( ulReceived[ classWRR_LIGHT ] + ulReceived[ classWRR_HEAVY ] ) / 4UL, classTICK_TOLERANCE );
+        ulFailures += prvCheck( "WRR weight 3", ulReceived[ classWRR_HEAVY ], ( ( ulReceived[ classWRR_LIGHT ] + ulReceived[ classWRR_HEAVY ] ) * 3UL ) / 4UL, classTICK_TOLERANCE );
+
+        /* Phase 3, MLFQ.  The spinner must be on the top level until it runs. */
+        xTaskCreateMLFQ( prvSpinnerTask, "MLFQ", configMINIMAL_STACK_SIZE, ( void * ) "not a deadline", &( xSpinners[ classMLFQ_SPINNER ] ) );
+        ulFailures += prvCheck( "MLFQ first level", ( uint32_t ) uxTaskPriorityGet( xSpinners[ classMLFQ_SPINNER ] ), configMLFQ_HIGHEST_PRIORITY, 0UL );
+
+        prvMeasure( classMLFQ_TICKS, ulReceived );
+        ulFailures += prvCheck( "MLFQ last level", ( uint32_t ) uxTaskPriorityGet( xSpinners[ classMLFQ_SPINNER ] ), configMLFQ_LOWEST_PRIORITY, 0UL );
+        ulFailures += prvCheck( "WRR ticks below MLFQ", ulReceived[ classWRR_LIGHT ] + ulReceived[ classWRR_HEAVY ], 0UL, 0UL );
+        vTaskSuspend( xSpinners[ classMLFQ_SPINNER ] );
+
+        /* Phase 4, fixed priority. */
+        xTaskCreate( prvSpinnerTask, "First", configMINIMAL_STACK_SIZE, ( void * ) "not a deadline", classFIXED_PRIORITY, &( xSpinners[ classFIXED_FIRST ] ) );
+        xTaskCreate( prvSpinnerTask, "Second", configMINIMAL_STACK_SIZE, ( void * ) "not a deadline", classFIXED_PRIORITY, &( xSpinners[ classFIXED_SECOND ] ) );
+
+        prvMeasure( classWINDOW_TICKS, ulReceived );
+        ulFailures += prvCheck( "fixed priority first", ulReceived[ classFIXED_FIRST ], ( ulReceived[ classFIXED_FIRST ] + ulReceived[ classFIXED_SECOND ] ) / 2UL, classTICK_TOLERANCE );
+        ulFailures += prvCheck( "fixed priority second", ulReceived[ classFIXED_SECOND ], ( ulReceived[ classFIXED_FIRST ] + ulReceived[ classFIXED_SECOND ] ) / 2UL, classTICK_TOLERANCE );
+        ulFailures += prvCheck( "WRR ticks below fixed priority", ulReceived[ classWRR_LIGHT ] + ulReceived[ classWRR_HEAVY ], 0UL, 0UL );
+
+        console_print( "Scheduling class test: %s, %lu failures\n",
+                       ( ulFailures == 0UL ) ? "PASS" : "FAIL",
+                       ( unsigned long ) ulFailures );
+
+        /* Exit the process directly rather than ending the scheduler. */
+        exit( ( ulFailures == 0UL ) ? EXIT_SUCCESS : EXIT_FAILURE );
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvMeasure( TickType_t xTicks,
+                            uint32_t * pulTicks )
+    {
+        UBaseType_t ux;
+
+        for( ux = 0U; ux < classNUM_SPINNERS; ux++ )
+        {
+            pulTicks[ ux ] = ulTicks[ ux ];
+        }
+
+        vTaskDelay( xTicks );
+
+        for( ux = 0U; ux < classNUM_SPINNERS; ux++ )
+        {
+            pulTicks[ ux ] = ulTicks[ ux ] - pulTicks[ ux ];
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static uint32_t prvCheck( const char * pcName,
+                              uint32_t ulValue,
+                              uint32_t ulExpected,
+                              uint32_t ulTolerance )
+    {
+        uint32_t ulDifference = ( ulValue > ulExpected ) ? ( ulValue - ulExpected ) : ( ulExpected - ulValue );
+        uint32_t ulFailures = ( ulDifference > ulTolerance ) ? 1UL : 0UL;
+
+        console_print( "Scheduling class test: %s, received/expected %lu/%lu%s\n",
+                       pcName,
+                       ( unsigned long ) ulValue,
+                       ( unsigned long ) ulExpected,
+                       ( ulFailures == 0UL ) ? "" : " FAIL" );
+
+        return ulFailures;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvOrderedTask( void * pvParameters )
+    {
+        UBaseType_t uxIndex = ( UBaseType_t ) ( ( pvParameter_t * ) pvParameters - xOrderedParameters );
+
+        if( uxOrderedRuns < classNUM_ORDERED )
+        {
+            uxOrder[ uxOrderedRuns ] = uxIndex;
+            uxOrderedRuns++;
+        }
+
+        vTaskSuspend( NULL );
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvPreemptedTask( void * pvParameters )
+    {
+        ( void ) pvParameters;
+
+        /* Runs after the ordered tasks, as its deadline is the latest.  The
+         * flags show whether each new task ran before xTaskCreate() returned. */
+        xTaskCreate( prvFlagTask, "Earlier", configMINIMAL_STACK_SIZE, &xEarlierParameters, classEDF_PRIORITY, NULL );
+        xEarlierPreempted = xEarlierRan;
+
+        xTaskCreate( prvFlagTask, "Later", configMINIMAL_STACK_SIZE, &xLaterParameters, classEDF_PRIORITY, NULL );
+        xLaterPreempted = xLaterRan;
+
+        vTaskSuspend( NULL );
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvFlagTask( void * pvParameters )
+    {
+        if( pvParameters == ( void * ) &xEarlierParameters )
+        {
+            xEarlierRan = pdTRUE;
+        }
+        else
+        {
+            xLaterRan = pdTRUE;
+        }
+
+        vTaskSuspend( NULL );
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvSpinnerTask( void * pvParameters )
+    {
+        ( void ) pvParameters;
+
+        for( ; ; )
+        {
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    void vSchedClassTestTickHook( void )
+    {
+        TaskHandle_t xRunning = xTaskGetCurrentTaskHandle();
+        UBaseType_t ux;
+
+        for( ux = 0U; ux < classNUM_SPINNERS; ux++ )
+        {
+            if( ( xSpinners[ ux ] != NULL ) && ( xSpinners[ ux ] == xRunning ) )
+            {
+                ulTicks[ ux ]++;
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* ( configUSE_EDF_SCHEDULER == 1 ) && ( configUSE_WEIGHTED_ROUND_ROBIN == 1 ) && ( configUSE_MLFQ_SCHEDULER == 1 ) */
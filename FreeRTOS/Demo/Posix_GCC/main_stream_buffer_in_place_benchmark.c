@@ -0,0 +1,680 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+
+/******************************************************************************
+ * NOTE 1: The FreeRTOS demo threads will not be running continuously, so
+ * do not expect to get real time behaviour from the FreeRTOS Linux port, or
+ * this demo application.  The absolute numbers reported by this benchmark
+ * include the cost of the Linux port itself, where entering a critical section
+ * is a system call, so only compare them with numbers taken on the same
+ * machine.
+ *
+ * NOTE 2: This benchmark is built when USER_DEMO is set to
+ * STREAM_BUFFER_IN_PLACE_BENCHMARK_DEMO.
+ ******************************************************************************
+ *
+ * main_stream_buffer_in_place_benchmark() compares moving frames between two
+ * tasks through a stream buffer with xStreamBufferSend() and
+ * xStreamBufferReceive(), which copy each frame into and out of the stream
+ * buffer, with moving them using xStreamBufferReserve() and
+ * xStreamBufferCommit() to write each frame directly into the stream buffer,
+ * and xStreamBufferPeekContiguous() and xStreamBufferConsume() to read the
+ * frames where they are.  Frames of each size in ipFRAME_SIZES are measured.
+ *
+ * A producer task writes ipFRAMES_TRANSFERRED frames, each filled with the
+ * low byte of its sequence number, and a consumer task at the same priority
+ * checks the first and last byte of each.  When reading in place the consumer
+ * checks and consumes every whole frame in the stream buffer at once.  The
+ * number of frames moved per second is reported for each method and frame
+ * size.
+ *
+ * Before the benchmark runs, reserved space and peeked data that wrap around
+ * the end of a stream buffer's storage area are checked to be returned as two
+ * segments, and reserving, committing, peeking and consuming whole messages
+ * is checked on a message buffer, including how they mix with the functions
+ * that copy.  Any error is counted, and the application exits with a failure
+ * status if there are errors.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "stream_buffer.h"
+#include "message_buffer.h"
+
+/* Local includes. */
+#include "console.h"
+
+#if ( configUSE_STREAM_BUFFERS == 1 )
+
+/* The frame sizes measured, the stream buffer and the work each measurement
+ * does. */
+    #define ipFRAME_SIZES               { 64U, 1024U, 4096U }
+    #define ipMAX_FRAME_SIZE            ( 4096U )
+    #define ipBUFFER_SIZE               ( 16384U )
+    #define ipFRAMES_TRANSFERRED        ( 200000UL )
+
+/* The sizes of the buffers used by the checks. */
+    #define ipCHECK_BUFFER_SIZE         ( 16U )
+    #define ipCHECK_MESSAGE_BUFFER_SIZE ( 32U )
+
+/* The block time used to check blocked calls time out. */
+    #define ipBLOCK_TIME_TICKS          ( 10U )
+
+/* The producer and consumer share a priority, below that of the controller. */
+    #define ipWORKER_PRIORITY           ( tskIDLE_PRIORITY + 1U )
+    #define ipCONTROLLER_PRIORITY       ( tskIDLE_PRIORITY + 2U )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The tasks as described in the comments at the top of this file.
+ */
+static void prvControllerTask( void * pvParameters );
+static void prvProducerTask( void * pvParameters );
+static void prvConsumerTask( void * pvParameters );
+
+/*
+ * Time the producer and consumer moving frames through xStreamBuffer, and
+ * return the number of frames moved per second.  xInPlace selects whether the
+ * frames are copied or written and read in place.
+ */
+static double prvMeasure( StreamBufferHandle_t xStreamBuffer,
+                          BaseType_t xInPlace,
+                          size_t xFrameSize );
+
+/*
+ * Check reserving and peeking wrapped data in a stream buffer.
+ */
+static void prvCheckStreamBuffer( void );
+
+/*
+ * Check reserving, committing, peeking and consuming messages.
+ */
+static void prvCheckMessageBuffer( void );
+
+/*
+ * Check pxSegments describes xLength bytes that start at pucStart, wrapping
+ * after xFirstLength bytes, and that the bytes count up from ucFirstValue.
+ */
+static void prvCheckSegments( const StreamBufferSegments_t * pxSegments,
+                              size_t xLength,
+                              const uint8_t * pucStart,
+                              size_t xFirstLength,
+                              uint8_t ucFirstValue );
+
+/*
+ * Fill the xLength bytes described by pxSegments, counting up from
+ * ucFirstValue.
+ */
+static void prvFillSegments( const StreamBufferSegments_t * pxSegments,
+                             size_t xLength,
+                             uint8_t ucFirstValue );
+
+/*
+ * Returns the byte at xIndex of the bytes described by pxSegments.
+ */
+static uint8_t prvByteAt( const StreamBufferSegments_t * pxSegments,
+                          size_t xIndex );
+
+/*
+ * Returns a monotonic time stamp in nanoseconds.
+ */
+static uint64_t prvGetTimeNs( void );
+
+/*-----------------------------------------------------------*/
+
+/* The stream buffer the producer and consumer are to use next, how, and the
+ * size of each frame. */
+static StreamBufferHandle_t xWorkerStreamBuffer = NULL;
+static BaseType_t xWorkerInPlace = pdFALSE;
+static size_t xWorkerFrameSize = 0U;
+
+/* The tasks, so they can be notified. */
+static TaskHandle_t xControllerTask = NULL;
+static TaskHandle_t xProducerTask = NULL;
+static TaskHandle_t xConsumerTask = NULL;
+
+/* The frames the producer and consumer copy to and from the stream buffer. */
+static uint8_t ucProducerFrame[ ipMAX_FRAME_SIZE ];
+static uint8_t ucConsumerFrame[ ipMAX_FRAME_SIZE ];
+
+/* The number of errors found. */
+static volatile uint32_t ulErrors = 0UL;
+
+/*-----------------------------------------------------------*/
+
+/*** SEE THE COMMENTS AT THE TOP OF THIS FILE ***/
+void main_stream_buffer_in_place_benchmark( void )
+{
+    xTaskCreate( prvControllerTask, "Control", configMINIMAL_STACK_SIZE * 2U, NULL, ipCONTROLLER_PRIORITY, &xControllerTask );
+    xTaskCreate( prvProducerTask, "Producer", configMINIMAL_STACK_SIZE, NULL, ipWORKER_PRIORITY, &xProducerTask );
+    xTaskCreate( prvConsumerTask, "Consumer", configMINIMAL_STACK_SIZE, NULL, ipWORKER_PRIORITY, &xConsumerTask );
+
+    vTaskStartScheduler();
+}
+/*-----------------------------------------------------------*/
+
+static void prvControllerTask( void * pvParameters )
+{
+    static const size_t xFrameSizes[] = ipFRAME_SIZES;
+    StreamBufferHandle_t xStreamBuffer;
+    double dCopyFramesPerSecond, dInPlaceFramesPerSecond;
+    size_t xSize;
+
+    ( void ) pvParameters;
+
+    prvCheckStreamBuffer();
+    prvCheckMessageBuffer();
+
+    console_print( "Stream buffer in place benchmark: %u byte stream buffer\n", ( unsigned ) ipBUFFER_SIZE );
+    console_print( "frame size (bytes), send/receive (frames/s), reserve/commit and peek/consume (frames/s)\n" );
+
+    for( xSize = 0U; xSize < ( sizeof( xFrameSizes ) / sizeof( xFrameSizes[ 0 ] ) ); xSize++ )
+    {
+        /* The consumer is unblocked once there is a whole frame to read. */
+        xStreamBuffer = xStreamBufferCreate( ipBUFFER_SIZE, xFrameSizes[ xSize ] );
+        configASSERT( xStreamBuffer );
+
+        dCopyFramesPerSecond = prvMeasure( xStreamBuffer, pdFALSE, xFrameSizes[ xSize ] );
+        dInPlaceFramesPerSecond = prvMeasure( xStreamBuffer, pdTRUE, xFrameSizes[ xSize ] );
+
+        /* Every frame must have been consumed. */
+        if( xStreamBufferIsEmpty( xStreamBuffer ) != pdTRUE )
+        {
+            ulErrors++;
+        }
+
+        console_print( "%u, %.0f, %.0f\n", ( unsigned ) xFrameSizes[ xSize ], dCopyFramesPerSecond, dInPlaceFramesPerSecond );
+
+        vStreamBufferDelete( xStreamBuffer );
+    }
+
+    console_print( "errors, %lu\n", ( unsigned long ) ulErrors );
+
+    /* Exit the process directly rather than ending the scheduler, so the
+     * threads of the producer and consumer do not have to be torn down. */
+    if( ulErrors != 0UL )
+    {
+        exit( EXIT_FAILURE );
+    }
+
+    exit( EXIT_SUCCESS );
+}
+/*-----------------------------------------------------------*/
+
+static double prvMeasure( StreamBufferHandle_t xStreamBuffer,
+                          BaseType_t xInPlace,
+                          size_t xFrameSize )
+{
+    uint64_t ullStartNs, ullDurationNs;
+
+    xWorkerStreamBuffer = xStreamBuffer;
+    xWorkerInPlace = xInPlace;
+    xWorkerFrameSize = xFrameSize;
+
+    ullStartNs = prvGetTimeNs();
+
+    /* The controller runs above the producer and consumer, so it only runs
+     * again once both have finished. */
+    xTaskNotifyGive( xProducerTask );
+    xTaskNotifyGive( xConsumerTask );
+    ( void ) ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+    ( void ) ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+
+    ullDurationNs = prvGetTimeNs() - ullStartNs;
+
+    return ( ( double ) ipFRAMES_TRANSFERRED * 1000000000.0 ) / ( double ) ullDurationNs;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckStreamBuffer( void )
+{
+    static uint8_t ucStorage[ ipCHECK_BUFFER_SIZE + 1U ];
+    static StaticStreamBuffer_t xStaticStreamBuffer;
+    StreamBufferHandle_t xStreamBuffer;
+    StreamBufferSegments_t xSegments;
+    uint8_t ucData[ ipCHECK_BUFFER_SIZE ];
+    TickType_t xStartTime;
+    size_t xByte;
+
+    /* One byte of the storage area is always free, so the stream buffer holds
+     * ipCHECK_BUFFER_SIZE bytes. */
+    xStreamBuffer = xStreamBufferCreateStatic( sizeof( ucStorage ), 1U, ucStorage, &xStaticStreamBuffer );
+    configASSERT( xStreamBuffer );
+
+    /* Nothing to peek, and nothing changes when nothing is consumed. */
+    if( ( xStreamBufferPeekContiguous( xStreamBuffer, &xSegments, 0U ) != 0U ) ||
+        ( xSegments.pucFirst != NULL ) || ( xSegments.pucSecond != NULL ) ||
+        ( xStreamBufferConsume( xStreamBuffer, 0U ) != 0U ) )
+    {
+        ulErrors++;
+    }
+
+    /* Move the head and tail 10 bytes into the storage area, so the 12 bytes
+     * reserved next wrap after 7 bytes. */
+    memset( ucData, 0, sizeof( ucData ) );
+
+    if( ( xStreamBufferSend( xStreamBuffer, ucData, 10U, 0U ) != 10U ) ||
+        ( xStreamBufferReceive( xStreamBuffer, ucData, 10U, 0U ) != 10U ) )
+    {
+        ulErrors++;
+    }
+
+    if( xStreamBufferReserve( xStreamBuffer, 12U, &xSegments, 0U ) != 12U )
+    {
+        ulErrors++;
+    }
+    else
+    {
+        prvCheckSegments( &xSegments, 12U, &( ucStorage[ 10 ] ), 7U, 0U );
+        prvFillSegments( &xSegments, 12U, 100U );
+    }
+
+    /* Nothing is visible until it is committed, and a reservation can be
+     * made again. */
+    if( ( xStreamBufferBytesAvailable( xStreamBuffer ) != 0U ) ||
+        ( xStreamBufferCommit( xStreamBuffer, 0U ) != 0U ) ||
+        ( xStreamBufferReserve( xStreamBuffer, 20U, &xSegments, 0U ) != ipCHECK_BUFFER_SIZE ) ||
+        ( xStreamBufferCommit( xStreamBuffer, 12U ) != 12U ) ||
+        ( xStreamBufferBytesAvailable( xStreamBuffer ) != 12U ) )
+    {
+        ulErrors++;
+    }
+
+    /* Only the rest of the free space can be reserved. */
+    if( ( xStreamBufferReserve( xStreamBuffer, 20U, &xSegments, 0U ) != 4U ) ||
+        ( xSegments.pucFirst != &( ucStorage[ 5 ] ) ) || ( xSegments.pucSecond != NULL ) )
+    {
+        ulErrors++;
+    }
+
+    /* The committed bytes are peeked in two segments where they were
+     * written. */
+    if( xStreamBufferPeekContiguous( xStreamBuffer, &xSegments, 0U ) != 12U )
+    {
+        ulErrors++;
+    }
+    else
+    {
+        prvCheckSegments( &xSegments, 12U, &( ucStorage[ 10 ] ), 7U, 100U );
+    }
+
+    /* After 5 bytes are consumed the rest still wrap after 2 bytes. */
+    if( ( xStreamBufferConsume( xStreamBuffer, 5U ) != 5U ) ||
+        ( xStreamBufferPeekContiguous( xStreamBuffer, &xSegments, 0U ) != 7U ) )
+    {
+        ulErrors++;
+    }
+    else
+    {
+        prvCheckSegments( &xSegments, 7U, &( ucStorage[ 15 ] ), 2U, 105U );
+    }
+
+    /* The rest can be read by copying them out. */
+    if( xStreamBufferReceive( xStreamBuffer, ucData, sizeof( ucData ), 0U ) != 7U )
+    {
+        ulErrors++;
+    }
+
+    for( xByte = 0U; xByte < 7U; xByte++ )
+    {
+        if( ucData[ xByte ] != ( uint8_t ) ( 105U + xByte ) )
+        {
+            ulErrors++;
+        }
+    }
+
+    /* When the stream buffer is full nothing can be reserved, and a blocked
+     * reserve times out. */
+    if( xStreamBufferReserve( xStreamBuffer, ipCHECK_BUFFER_SIZE, &xSegments, 0U ) != ipCHECK_BUFFER_SIZE )
+    {
+        ulErrors++;
+    }
+    else
+    {
+        prvFillSegments( &xSegments, ipCHECK_BUFFER_SIZE, 0U );
+        ( void ) xStreamBufferCommit( xStreamBuffer, ipCHECK_BUFFER_SIZE );
+    }
+
+    xStartTime = xTaskGetTickCount();
+
+    if( ( xStreamBufferIsFull( xStreamBuffer ) != pdTRUE ) ||
+        ( xStreamBufferReserve( xStreamBuffer, 1U, &xSegments, ipBLOCK_TIME_TICKS ) != 0U ) ||
+        ( xSegments.pucFirst != NULL ) ||
+        ( ( xTaskGetTickCount() - xStartTime ) < ipBLOCK_TIME_TICKS ) )
+    {
+        ulErrors++;
+    }
+
+    /* Once everything is consumed a blocked peek times out. */
+    if( ( xStreamBufferPeekContiguous( xStreamBuffer, &xSegments, 0U ) != ipCHECK_BUFFER_SIZE ) ||
+        ( xStreamBufferConsume( xStreamBuffer, ipCHECK_BUFFER_SIZE ) != ipCHECK_BUFFER_SIZE ) )
+    {
+        ulErrors++;
+    }
+
+    xStartTime = xTaskGetTickCount();
+
+    if( ( xStreamBufferPeekContiguous( xStreamBuffer, &xSegments, ipBLOCK_TIME_TICKS ) != 0U ) ||
+        ( ( xTaskGetTickCount() - xStartTime ) < ipBLOCK_TIME_TICKS ) )
+    {
+        ulErrors++;
+    }
+
+    vStreamBufferDelete( xStreamBuffer );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckMessageBuffer( void )
+{
+    MessageBufferHandle_t xMessageBuffer;
+    StreamBufferSegments_t xSegments;
+    uint8_t ucData[ ipCHECK_MESSAGE_BUFFER_SIZE ];
+    size_t xReserved, xLength, xMessage, xByte;
+    const size_t xLengthBytes = sizeof( configMESSAGE_BUFFER_LENGTH_TYPE );
+
+    xMessageBuffer = xMessageBufferCreate( ipCHECK_MESSAGE_BUFFER_SIZE );
+    configASSERT( xMessageBuffer );
+
+    /* Space is reserved for the longest message that fits, less than is
+     * used. */
+    xReserved = xMessageBufferReserve( xMessageBuffer, ipCHECK_MESSAGE_BUFFER_SIZE, &xSegments, 0U );
+
+    if( ( xReserved != ( ipCHECK_MESSAGE_BUFFER_SIZE - xLengthBytes ) ) || ( xSegments.pucSecond != NULL ) )
+    {
+        ulErrors++;
+    }
+    else
+    {
+        prvFillSegments( &xSegments, 5U, 1U );
+    }
+
+    /* A message written in place can be received by copying it out. */
+    if( ( xMessageBufferCommit( xMessageBuffer, 5U ) != 5U ) ||
+        ( xStreamBufferNextMessageLengthBytes( xMessageBuffer ) != 5U ) ||
+        ( xMessageBufferReceive( xMessageBuffer, ucData, sizeof( ucData ), 0U ) != 5U ) ||
+        ( ucData[ 0 ] != 1U ) || ( ucData[ 4 ] != 5U ) )
+    {
+        ulErrors++;
+    }
+
+    /* Send and receive messages so the head and tail move around the storage
+     * area, and check every message written in place and peeked in place
+     * wherever it wraps. */
+    for( xMessage = 0U; xMessage < ( 3U * ipCHECK_MESSAGE_BUFFER_SIZE ); xMessage++ )
+    {
+        xLength = 1U + ( xMessage % 7U );
+
+        /* Two messages are in the message buffer, one sent by copying it in
+         * and one written in place. */
+        memset( ucData, ( int ) xMessage, xLength );
+
+        if( ( xMessageBufferSend( xMessageBuffer, ucData, xLength, 0U ) != xLength ) ||
+            ( xMessageBufferReserve( xMessageBuffer, xLength, &xSegments, 0U ) != xLength ) )
+        {
+            ulErrors++;
+            break;
+        }
+
+        prvFillSegments( &xSegments, xLength, ( uint8_t ) xMessage );
+
+        if( xMessageBufferCommit( xMessageBuffer, xLength ) != xLength )
+        {
+            ulErrors++;
+        }
+
+        /* Only the first message is peeked, and it is removed whole. */
+        if( ( xMessageBufferPeekContiguous( xMessageBuffer, &xSegments, 0U ) != xLength ) ||
+            ( prvByteAt( &xSegments, xLength - 1U ) != ( uint8_t ) xMessage ) ||
+            ( xMessageBufferConsume( xMessageBuffer, xLength ) != xLength ) )
+        {
+            ulErrors++;
+        }
+
+        /* The second message is peeked where it was written. */
+        if( xMessageBufferPeekContiguous( xMessageBuffer, &xSegments, 0U ) != xLength )
+        {
+            ulErrors++;
+        }
+        else
+        {
+            for( xByte = 0U; xByte < xLength; xByte++ )
+            {
+                if( prvByteAt( &xSegments, xByte ) != ( uint8_t ) ( xMessage + xByte ) )
+                {
+                    ulErrors++;
+                }
+            }
+
+            ( void ) xMessageBufferConsume( xMessageBuffer, xLength );
+        }
+
+        if( xMessageBufferIsEmpty( xMessageBuffer ) != pdTRUE )
+        {
+            ulErrors++;
+        }
+    }
+
+    vMessageBufferDelete( xMessageBuffer );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckSegments( const StreamBufferSegments_t * pxSegments,
+                              size_t xLength,
+                              const uint8_t * pucStart,
+                              size_t xFirstLength,
+                              uint8_t ucFirstValue )
+{
+    size_t xByte;
+
+    if( ( pxSegments->pucFirst != pucStart ) ||
+        ( pxSegments->xFirstLength != xFirstLength ) ||
+        ( pxSegments->xSecondLength != ( xLength - xFirstLength ) ) ||
+        ( ( xLength == xFirstLength ) != ( pxSegments->pucSecond == NULL ) ) )
+    {
+        ulErrors++;
+    }
+    else if( ucFirstValue != 0U )
+    {
+        for( xByte = 0U; xByte < xLength; xByte++ )
+        {
+            if( prvByteAt( pxSegments, xByte ) != ( uint8_t ) ( ucFirstValue + xByte ) )
+            {
+                ulErrors++;
+            }
+        }
+    }
+    else
+    {
+        /* The contents are not known. */
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvFillSegments( const StreamBufferSegments_t * pxSegments,
+                             size_t xLength,
+                             uint8_t ucFirstValue )
+{
+    size_t xByte;
+
+    for( xByte = 0U; xByte < xLength; xByte++ )
+    {
+        if( xByte < pxSegments->xFirstLength )
+        {
+            pxSegments->pucFirst[ xByte ] = ( uint8_t ) ( ucFirstValue + xByte );
+        }
+        else
+        {
+            pxSegments->pucSecond[ xByte - pxSegments->xFirstLength ] = ( uint8_t ) ( ucFirstValue + xByte );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static uint8_t prvByteAt( const StreamBufferSegments_t * pxSegments,
+                          size_t xIndex )
+{
+    uint8_t ucReturn;
+
+    if( xIndex < pxSegments->xFirstLength )
+    {
+        ucReturn = pxSegments->pucFirst[ xIndex ];
+    }
+    else
+    {
+        ucReturn = pxSegments->pucSecond[ xIndex - pxSegments->xFirstLength ];
+    }
+
+    return ucReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvProducerTask( void * pvParameters )
+{
+    StreamBufferSegments_t xSegments;
+    uint32_t ulFrame;
+
+    ( void ) pvParameters;
+
+    for( ; ; )
+    {
+        /* The stream buffer also notifies this task, without incrementing
+         * the notification value, so wait until the controller gives. */
+        while( ulTaskNotifyTake( pdTRUE, portMAX_DELAY ) == 0UL )
+        {
+        }
+
+        for( ulFrame = 0UL; ulFrame < ipFRAMES_TRANSFERRED; ulFrame++ )
+        {
+            if( xWorkerInPlace != pdFALSE )
+            {
+                /* Generate the frame directly into the stream buffer. */
+                if( xStreamBufferReserve( xWorkerStreamBuffer, xWorkerFrameSize, &xSegments, portMAX_DELAY ) != xWorkerFrameSize )
+                {
+                    ulErrors++;
+                }
+
+                memset( xSegments.pucFirst, ( int ) ( uint8_t ) ulFrame, xSegments.xFirstLength );
+
+                if( xSegments.pucSecond != NULL )
+                {
+                    memset( xSegments.pucSecond, ( int ) ( uint8_t ) ulFrame, xSegments.xSecondLength );
+                }
+
+                ( void ) xStreamBufferCommit( xWorkerStreamBuffer, xSegments.xFirstLength + xSegments.xSecondLength );
+            }
+            else
+            {
+                memset( ucProducerFrame, ( int ) ( uint8_t ) ulFrame, xWorkerFrameSize );
+
+                if( xStreamBufferSend( xWorkerStreamBuffer, ucProducerFrame, xWorkerFrameSize, portMAX_DELAY ) != xWorkerFrameSize )
+                {
+                    ulErrors++;
+                }
+            }
+        }
+
+        xTaskNotifyGive( xControllerTask );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvConsumerTask( void * pvParameters )
+{
+    StreamBufferSegments_t xSegments;
+    uint32_t ulExpected;
+    size_t xAvailable, xOffset;
+
+    ( void ) pvParameters;
+
+    for( ; ; )
+    {
+        /* The stream buffer also notifies this task, without incrementing
+         * the notification value, so wait until the controller gives. */
+        while( ulTaskNotifyTake( pdTRUE, portMAX_DELAY ) == 0UL )
+        {
+        }
+
+        ulExpected = 0UL;
+
+        while( ulExpected < ipFRAMES_TRANSFERRED )
+        {
+            if( xWorkerInPlace != pdFALSE )
+            {
+                /* Check every whole frame in the stream buffer where it is,
+                 * then consume them all at once. */
+                xAvailable = xStreamBufferPeekContiguous( xWorkerStreamBuffer, &xSegments, portMAX_DELAY );
+                xAvailable -= xAvailable % xWorkerFrameSize;
+
+                for( xOffset = 0U; xOffset < xAvailable; xOffset += xWorkerFrameSize )
+                {
+                    if( ( prvByteAt( &xSegments, xOffset ) != ( uint8_t ) ulExpected ) ||
+                        ( prvByteAt( &xSegments, xOffset + xWorkerFrameSize - 1U ) != ( uint8_t ) ulExpected ) )
+                    {
+                        ulErrors++;
+                    }
+
+                    ulExpected++;
+                }
+
+                ( void ) xStreamBufferConsume( xWorkerStreamBuffer, xAvailable );
+            }
+            else
+            {
+                if( ( xStreamBufferReceive( xWorkerStreamBuffer, ucConsumerFrame, xWorkerFrameSize, portMAX_DELAY ) != xWorkerFrameSize ) ||
+                    ( ucConsumerFrame[ 0 ] != ( uint8_t ) ulExpected ) ||
+                    ( ucConsumerFrame[ xWorkerFrameSize - 1U ] != ( uint8_t ) ulExpected ) )
+                {
+                    ulErrors++;
+                }
+
+                ulExpected++;
+            }
+        }
+
+        xTaskNotifyGive( xControllerTask );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvGetTimeNs( void )
+{
+    struct timespec xNow;
+
+    ( void ) clock_gettime( CLOCK_MONOTONIC, &xNow );
+
+    return ( ( uint64_t ) xNow.tv_sec * 1000000000ULL ) + ( uint64_t ) xNow.tv_nsec;
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_STREAM_BUFFERS == 1 */
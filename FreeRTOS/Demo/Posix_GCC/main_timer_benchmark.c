@@ -0,0 +1,308 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/******************************************************************************
+ * NOTE 1: The FreeRTOS demo threads will not be running continuously, so
+ * do not expect to get real time behaviour from the FreeRTOS Linux port, or
+ * this demo application.  The CPU time reported by this benchmark includes the
+ * cost of the Linux port itself, so only compare it with numbers taken on the
+ * same machine.
+ *
+ * NOTE 2: The way active timers are held is selected when the kernel is built.
+ * USER_DEMO is set to TIMER_BENCHMARK_LIST_DEMO or TIMER_BENCHMARK_WHEEL_DEMO,
+ * which build this file with configUSE_TIMER_SERVICE_WHEEL set to 0 or 1
+ * respectively (see FreeRTOSConfig.h).
+ ******************************************************************************
+ *
+ * main_timer_benchmark() measures the CPU time the timer service task uses
+ * while many software timers are active, so the sorted active timer lists can
+ * be compared with the timing wheel.
+ *
+ * timerNUM_TIMERS auto-reload timers are created, each with a random period of
+ * between timerMIN_PERIOD_TICKS and timerMAX_PERIOD_TICKS ticks, and started
+ * by a controller task that runs below the priority of the timer service task.
+ * One timer in timerCHANGING_TIMER_RATIO also changes its own period from its
+ * callback function every timerCHANGE_EVERY_N_CALLS calls, which exercises the
+ * commands timer callback functions send to the timer service task.
+ *
+ * After a warm up period the thread CPU time of the timer service task is
+ * sampled, by a function pended to the timer service task, at the start and at
+ * the end of timerMEASURED_TICKS ticks.  Every callback checks the timer did
+ * not expire before its expiry time, and records how many ticks late it was.
+ * Every timer must have expired at least once while measuring, as no period
+ * is longer than the measurement.  The number of callbacks, the CPU time used
+ * per tick and per callback, the lateness and the number of errors are then
+ * printed and the application exits.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+
+/* Local includes. */
+#include "console.h"
+
+/* The number of timers, and the range of their periods. */
+#define timerNUM_TIMERS                ( 2000U )
+#define timerMIN_PERIOD_TICKS          ( 10U )
+#define timerMAX_PERIOD_TICKS          ( 1000U )
+
+/* One timer in timerCHANGING_TIMER_RATIO changes its period every
+ * timerCHANGE_EVERY_N_CALLS calls of its callback. */
+#define timerCHANGING_TIMER_RATIO      ( 4U )
+#define timerCHANGE_EVERY_N_CALLS      ( 8U )
+
+/* The ticks allowed for the timers to spread their expiry times before the
+ * measurement starts, and the number of ticks measured. */
+#define timerWARM_UP_TICKS             ( timerMAX_PERIOD_TICKS )
+#define timerMEASURED_TICKS            ( 10000U )
+
+/* The controller runs below the timer service task, so each command it sends
+ * is processed before it sends the next. */
+#define timerCONTROLLER_PRIORITY       ( configTIMER_TASK_PRIORITY - 1U )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The task and timer callback function as described in the comments at the
+ * top of this file.
+ */
+static void prvControllerTask( void * pvParameters );
+static void prvTimerCallback( TimerHandle_t xTimer );
+
+/*
+ * Pended to the timer service task to sample the CPU time it has used.
+ */
+static void prvSampleDaemonCPUTime( void * pvParameter1,
+                                    uint32_t ulParameter2 );
+
+/*
+ * Returns a random period in the range used by the timers.
+ */
+static TickType_t prvRandomPeriod( void );
+
+/*-----------------------------------------------------------*/
+
+/* The timers, and the tick each is next expected to expire at. */
+static TimerHandle_t xTimers[ timerNUM_TIMERS ];
+static TickType_t xExpectedExpiry[ timerNUM_TIMERS ];
+static uint32_t ulCallsWhileMeasuring[ timerNUM_TIMERS ];
+static uint32_t ulCallsSinceChange[ timerNUM_TIMERS ];
+
+/* Set while callbacks are being recorded. */
+static volatile BaseType_t xRecording = pdFALSE;
+
+/* The CPU time of the timer service task at the start and end of the
+ * measurement, and the number of samples taken so far. */
+static uint64_t ullDaemonStartNs = 0ULL;
+static uint64_t ullDaemonEndNs = 0ULL;
+static volatile UBaseType_t uxSamplesTaken = 0U;
+
+/* The results.  Only the timer service task writes them. */
+static uint32_t ulCallbacks = 0UL;
+static uint32_t ulPeriodChanges = 0UL;
+static uint64_t ullLatenessTotal = 0ULL;
+static TickType_t xLatenessLargest = 0U;
+static uint32_t ulEarlyExpiries = 0UL;
+static uint32_t ulFailedChanges = 0UL;
+
+/* Seeds the random periods. */
+static uint32_t ulRandom = 1UL;
+
+/*-----------------------------------------------------------*/
+
+/*** SEE THE COMMENTS AT THE TOP OF THIS FILE ***/
+void main_timer_benchmark( void )
+{
+    UBaseType_t ux;
+
+    for( ux = 0U; ux < timerNUM_TIMERS; ux++ )
+    {
+        /* The timer ID is the index of the timer. */
+        xTimers[ ux ] = xTimerCreate( "Bench", prvRandomPeriod(), pdTRUE, ( void * ) ( uintptr_t ) ux, prvTimerCallback );
+        configASSERT( xTimers[ ux ] );
+    }
+
+    xTaskCreate( prvControllerTask, "Control", configMINIMAL_STACK_SIZE * 2U, NULL, timerCONTROLLER_PRIORITY, NULL );
+
+    vTaskStartScheduler();
+}
+/*-----------------------------------------------------------*/
+
+static void prvControllerTask( void * pvParameters )
+{
+    UBaseType_t ux;
+    UBaseType_t uxNeverExpired = 0U;
+
+    ( void ) pvParameters;
+
+    for( ux = 0U; ux < timerNUM_TIMERS; ux++ )
+    {
+        /* The expiry time is relative to the tick count when xTimerStart() is
+         * called, which can only be later than the tick count read here.  The
+         * command queue is much shorter than the number of timers, so wait
+         * for space in it. */
+        xExpectedExpiry[ ux ] = xTaskGetTickCount() + xTimerGetPeriod( xTimers[ ux ] );
+        ( void ) xTimerStart( xTimers[ ux ], portMAX_DELAY );
+    }
+
+    vTaskDelay( timerWARM_UP_TICKS );
+    ( void ) xTimerPendFunctionCall( prvSampleDaemonCPUTime, &ullDaemonStartNs, 0UL, portMAX_DELAY );
+    xRecording = pdTRUE;
+    vTaskDelay( timerMEASURED_TICKS );
+    xRecording = pdFALSE;
+    ( void ) xTimerPendFunctionCall( prvSampleDaemonCPUTime, &ullDaemonEndNs, 0UL, portMAX_DELAY );
+
+    /* The timer service task runs above this task, so has taken the second
+     * sample by now, but wait for it in case it has not. */
+    while( uxSamplesTaken < 2U )
+    {
+        vTaskDelay( 1U );
+    }
+
+    for( ux = 0U; ux < timerNUM_TIMERS; ux++ )
+    {
+        if( ulCallsWhileMeasuring[ ux ] == 0UL )
+        {
+            uxNeverExpired++;
+        }
+    }
+
+    console_print( "Timer benchmark: %u auto-reload timers, periods of %u to %u ticks, %s\n",
+                   ( unsigned ) timerNUM_TIMERS,
+                   ( unsigned ) timerMIN_PERIOD_TICKS,
+                   ( unsigned ) timerMAX_PERIOD_TICKS,
+                   ( configUSE_TIMER_SERVICE_WHEEL == 1 ) ? "timing wheel" : "active timer lists" );
+    console_print( "ticks, callbacks, period changes, daemon CPU per tick (us), daemon CPU per callback (us), lateness mean (ticks), lateness max (ticks), early expiries, failed changes, never expired\n" );
+    console_print( "%u, %lu, %lu, %.3f, %.3f, %.3f, %lu, %lu, %lu, %lu\n",
+                   ( unsigned ) timerMEASURED_TICKS,
+                   ( unsigned long ) ulCallbacks,
+                   ( unsigned long ) ulPeriodChanges,
+                   ( ( double ) ( ullDaemonEndNs - ullDaemonStartNs ) / ( double ) timerMEASURED_TICKS ) / 1000.0,
+                   ( ulCallbacks != 0UL ) ? ( ( double ) ( ullDaemonEndNs - ullDaemonStartNs ) / ( double ) ulCallbacks ) / 1000.0 : 0.0,
+                   ( ulCallbacks != 0UL ) ? ( double ) ullLatenessTotal / ( double ) ulCallbacks : 0.0,
+                   ( unsigned long ) xLatenessLargest,
+                   ( unsigned long ) ulEarlyExpiries,
+                   ( unsigned long ) ulFailedChanges,
+                   ( unsigned long ) uxNeverExpired );
+
+    /* Exit the process directly rather than ending the scheduler, so the
+     * timers do not have to be deleted one by one. */
+    if( ( ulEarlyExpiries != 0UL ) || ( ulFailedChanges != 0UL ) || ( uxNeverExpired != 0U ) )
+    {
+        exit( EXIT_FAILURE );
+    }
+
+    exit( EXIT_SUCCESS );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTimerCallback( TimerHandle_t xTimer )
+{
+    const UBaseType_t uxIndex = ( UBaseType_t ) ( uintptr_t ) pvTimerGetTimerID( xTimer );
+    const TickType_t xTimeNow = xTaskGetTickCount();
+    TickType_t xNewPeriod, xChangeTime;
+
+    /* Times are compared by how far they are after the expected expiry time,
+     * so the comparison holds when the tick count overflows.  A timer that
+     * expired early appears to be a very long way late. */
+    if( ( TickType_t ) ( xTimeNow - xExpectedExpiry[ uxIndex ] ) > ( TickType_t ) timerMEASURED_TICKS )
+    {
+        ulEarlyExpiries++;
+    }
+    else if( xRecording != pdFALSE )
+    {
+        ulCallbacks++;
+        ulCallsWhileMeasuring[ uxIndex ]++;
+        ullLatenessTotal += ( uint64_t ) ( xTimeNow - xExpectedExpiry[ uxIndex ] );
+
+        if( ( TickType_t ) ( xTimeNow - xExpectedExpiry[ uxIndex ] ) > xLatenessLargest )
+        {
+            xLatenessLargest = xTimeNow - xExpectedExpiry[ uxIndex ];
+        }
+    }
+
+    /* An auto-reload timer keeps to its period however late its callback is
+     * called. */
+    xExpectedExpiry[ uxIndex ] += xTimerGetPeriod( xTimer );
+
+    if( ( uxIndex % timerCHANGING_TIMER_RATIO ) == 0U )
+    {
+        ulCallsSinceChange[ uxIndex ]++;
+
+        if( ulCallsSinceChange[ uxIndex ] >= timerCHANGE_EVERY_N_CALLS )
+        {
+            ulCallsSinceChange[ uxIndex ] = 0UL;
+            xNewPeriod = prvRandomPeriod();
+            xChangeTime = xTaskGetTickCount();
+
+            /* The new period is relative to the tick count when the command
+             * is processed, which can only be later than the tick count read
+             * here.  A callback must not block, so the command is not
+             * retried. */
+            if( xTimerChangePeriod( xTimer, xNewPeriod, 0U ) == pdPASS )
+            {
+                xExpectedExpiry[ uxIndex ] = xChangeTime + xNewPeriod;
+                ulPeriodChanges++;
+            }
+            else
+            {
+                ulFailedChanges++;
+            }
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvSampleDaemonCPUTime( void * pvParameter1,
+                                    uint32_t ulParameter2 )
+{
+    struct timespec xNow;
+
+    ( void ) ulParameter2;
+
+    /* Each task runs in its own thread in the Linux port, so the CPU time of
+     * the calling thread is that of the timer service task. */
+    ( void ) clock_gettime( CLOCK_THREAD_CPUTIME_ID, &xNow );
+    *( ( uint64_t * ) pvParameter1 ) = ( ( uint64_t ) xNow.tv_sec * 1000000000ULL ) + ( uint64_t ) xNow.tv_nsec;
+    uxSamplesTaken++;
+}
+/*-----------------------------------------------------------*/
+
+static TickType_t prvRandomPeriod( void )
+{
+    /* A linear congruential generator is enough to spread the periods.  It is
+     * only called before the scheduler starts and by the timer service task. */
+    ulRandom = ( ulRandom * 1664525UL ) + 1013904223UL;
+
+    return ( TickType_t ) ( ( ulRandom >> 8 ) % ( timerMAX_PERIOD_TICKS - timerMIN_PERIOD_TICKS + 1U ) ) + timerMIN_PERIOD_TICKS;
+}
+/*-----------------------------------------------------------*/
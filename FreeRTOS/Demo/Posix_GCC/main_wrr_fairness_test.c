@@ -0,0 +1,249 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/******************************************************************************
+ * NOTE 1: This file is only built into a working application when USER_DEMO is
+ * set to WRR_FAIRNESS_TEST_DEMO, which builds the kernel with
+ * configUSE_WEIGHTED_ROUND_ROBIN set to 1 (see FreeRTOSConfig.h).
+ *
+ * NOTE 2: The FreeRTOS demo threads will not be running continuously, so the
+ * processor time each task receives is not exactly repeatable.  The checks
+ * made by this test allow for that.
+ ******************************************************************************
+ *
+ * main_wrr_fairness_test() checks that tasks of the same priority share the
+ * processor in proportion to the weights set by vTaskSetWeight().
+ *
+ * Several "spinner" tasks of the same priority never block.  The tick hook
+ * counts the ticks that occur while each spinner is running, which is the
+ * processor time the scheduler charges it for.  Each spinner is passed a
+ * string as its parameter, so the weights cannot come from the task
+ * parameter.
+ *
+ * A controller task of a higher priority measures the ticks each spinner
+ * receives over several windows of wrrWINDOW_TICKS ticks, in two phases.  In the
+ * first phase three spinners with weights 1, 2 and 4 are ready, and a fourth
+ * spinner with weight 4 is blocked.  At the start of the second phase the
+ * blocked spinner wakes and a fifth spinner with weight 1 is created.  Neither
+ * may receive more than its share to make up for the time it was not ready,
+ * so every window of the second phase must also be shared by weight.  A
+ * spinner's ticks in a window may differ from its share by at most
+ * wrrTICK_TOLERANCE, which covers the time slices in progress at each end of
+ * the window.  The result is printed and the application exits with EXIT_SUCCESS or
+ * EXIT_FAILURE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Local includes. */
+#include "console.h"
+
+#if ( configUSE_WEIGHTED_ROUND_ROBIN == 1 )
+
+    #define wrrSPINNER_PRIORITY      ( tskIDLE_PRIORITY + 1U )
+    #define wrrCONTROLLER_PRIORITY   ( tskIDLE_PRIORITY + 2U )
+
+    #define wrrNUM_SPINNERS          ( 5U )
+
+/* The spinner that is blocked during the first phase, and the spinner that is
+ * created at the start of the second phase. */
+    #define wrrSLEEPER               ( 3U )
+    #define wrrLATE_JOINER           ( 4U )
+
+/* The length of each measurement window and the number of windows in each
+ * phase. */
+    #define wrrWINDOW_TICKS          ( ( TickType_t ) 200 )
+    #define wrrWINDOWS_PER_PHASE     ( 5U )
+
+/* The number of ticks by which a spinner's ticks in a window may differ from
+ * its weight's share of the window. */
+    #define wrrTICK_TOLERANCE        ( 2.0 * ( double ) configSLICE_INTERVAL )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The tasks as described in the comments at the top of this file.
+ */
+    static void prvControllerTask( void * pvParameters );
+    static void prvSpinnerTask( void * pvParameters );
+
+/*
+ * Measure the ticks received by each of the first uxSpinners spinners over one
+ * window, and compare them with each spinner's share of the window.  Returns
+ * the number of spinners that were outside the tolerance.
+ */
+    static uint32_t prvMeasureWindow( UBaseType_t uxSpinners,
+                                      const char * pcPhaseName,
+                                      UBaseType_t uxWindow );
+
+/*
+ * Called by the traceTASK_INCREMENT_TICK() macro defined in FreeRTOSConfig.h.
+ */
+    void vWRRFairnessTestTickHook( void );
+
+/*-----------------------------------------------------------*/
+
+    static const UBaseType_t uxWeights[ wrrNUM_SPINNERS ] = { 1U, 2U, 4U, 4U, 1U };
+    static volatile uint32_t ulTicks[ wrrNUM_SPINNERS ];
+    static TaskHandle_t xSpinners[ wrrNUM_SPINNERS ];
+
+/*-----------------------------------------------------------*/
+
+/*** SEE THE COMMENTS AT THE TOP OF THIS FILE ***/
+    void main_wrr_fairness_test( void )
+    {
+        xTaskCreate( prvControllerTask, "Control", configMINIMAL_STACK_SIZE * 2U, NULL, wrrCONTROLLER_PRIORITY, NULL );
+
+        vTaskStartScheduler();
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvControllerTask( void * pvParameters )
+    {
+        UBaseType_t ux;
+        uint32_t ulFailures = 0UL;
+
+        ( void ) pvParameters;
+
+        for( ux = 0U; ux < wrrLATE_JOINER; ux++ )
+        {
+            xTaskCreate( prvSpinnerTask, "Spinner", configMINIMAL_STACK_SIZE, ( void * ) "not a weight", wrrSPINNER_PRIORITY, &( xSpinners[ ux ] ) );
+            vTaskSetWeight( xSpinners[ ux ], uxWeights[ ux ] );
+
+            if( uxTaskGetWeight( xSpinners[ ux ] ) != uxWeights[ ux ] )
+            {
+                console_print( "WRR fairness test: spinner %u has weight %u\n", ( unsigned ) ux, ( unsigned ) uxTaskGetWeight( xSpinners[ ux ] ) );
+                ulFailures++;
+            }
+        }
+
+        /* The sleeper accumulates no processor time during the first phase. */
+        vTaskSuspend( xSpinners[ wrrSLEEPER ] );
+
+        /* Let the spinners settle before the first window. */
+        vTaskDelay( wrrWINDOW_TICKS );
+
+        for( ux = 0U; ux < wrrWINDOWS_PER_PHASE; ux++ )
+        {
+            ulFailures += prvMeasureWindow( wrrSLEEPER, "first phase", ux );
+        }
+
+        /* Start the second phase without a settling period, so any credit the
+         * new tasks were given would show in the first window. */
+        vTaskResume( xSpinners[ wrrSLEEPER ] );
+        xTaskCreate( prvSpinnerTask, "Spinner", configMINIMAL_STACK_SIZE, ( void * ) "not a weight", wrrSPINNER_PRIORITY, &( xSpinners[ wrrLATE_JOINER ] ) );
+        vTaskSetWeight( xSpinners[ wrrLATE_JOINER ], uxWeights[ wrrLATE_JOINER ] );
+
+        for( ux = 0U; ux < wrrWINDOWS_PER_PHASE; ux++ )
+        {
+            ulFailures += prvMeasureWindow( wrrNUM_SPINNERS, "second phase", ux );
+        }
+
+        console_print( "WRR fairness test: %s, %lu failures\n",
+                       ( ulFailures == 0UL ) ? "PASS" : "FAIL",
+                       ( unsigned long ) ulFailures );
+
+        /* Exit the process directly rather than ending the scheduler. */
+        exit( ( ulFailures == 0UL ) ? EXIT_SUCCESS : EXIT_FAILURE );
+    }
+/*-----------------------------------------------------------*/
+
+    static uint32_t prvMeasureWindow( UBaseType_t uxSpinners,
+                                      const char * pcPhaseName,
+                                      UBaseType_t uxWindow )
+    {
+        uint32_t ulStart[ wrrNUM_SPINNERS ], ulTotal = 0UL;
+        UBaseType_t ux, uxTotalWeight = 0U;
+        double dExpected;
+        uint32_t ulFailures = 0UL;
+
+        for( ux = 0U; ux < uxSpinners; ux++ )
+        {
+            ulStart[ ux ] = ulTicks[ ux ];
+            uxTotalWeight += uxWeights[ ux ];
+        }
+
+        vTaskDelay( wrrWINDOW_TICKS );
+
+        for( ux = 0U; ux < uxSpinners; ux++ )
+        {
+            ulStart[ ux ] = ulTicks[ ux ] - ulStart[ ux ];
+            ulTotal += ulStart[ ux ];
+        }
+
+        console_print( "WRR fairness test: %s, window %u, ticks received/expected", pcPhaseName, ( unsigned ) uxWindow );
+
+        for( ux = 0U; ux < uxSpinners; ux++ )
+        {
+            dExpected = ( ( double ) ulTotal * ( double ) uxWeights[ ux ] ) / ( double ) uxTotalWeight;
+            console_print( " %lu/%.1f", ( unsigned long ) ulStart[ ux ], dExpected );
+
+            if( fabs( ( double ) ulStart[ ux ] - dExpected ) > wrrTICK_TOLERANCE )
+            {
+                ulFailures++;
+            }
+        }
+
+        console_print( "%s\n", ( ulFailures == 0UL ) ? "" : " FAIL" );
+
+        return ulFailures;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvSpinnerTask( void * pvParameters )
+    {
+        ( void ) pvParameters;
+
+        for( ; ; )
+        {
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    void vWRRFairnessTestTickHook( void )
+    {
+        TaskHandle_t xRunning = xTaskGetCurrentTaskHandle();
+        UBaseType_t ux;
+
+        /* Called from the tick interrupt, before the running task is charged
+         * for the tick. */
+        for( ux = 0U; ux < wrrNUM_SPINNERS; ux++ )
+        {
+            if( ( xSpinners[ ux ] != NULL ) && ( xSpinners[ ux ] == xRunning ) )
+            {
+                ulTicks[ ux ]++;
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_WEIGHTED_ROUND_ROBIN == 1 */
@@ -0,0 +1,418 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/******************************************************************************
+ * NOTE 1: The FreeRTOS demo threads will not be running continuously, so
+ * do not expect to get real time behaviour from the FreeRTOS Linux port, or
+ * this demo application.  The absolute numbers reported by this benchmark
+ * include the cost of the Linux port itself, where entering a critical section
+ * is a system call, so only compare them with numbers taken on the same
+ * machine.
+ *
+ * NOTE 2: This benchmark is built when USER_DEMO is set to
+ * ZERO_COPY_BENCHMARK_DEMO, which also sets configUSE_ZERO_COPY_QUEUES and
+ * configCHECK_ZERO_COPY_BUFFERS to 1 (see FreeRTOSConfig.h).
+ ******************************************************************************
+ *
+ * main_zero_copy_benchmark() compares moving frames between two tasks through a queue created with xQueueCreate(), which copies
+ * each frame into and out of the queue, with moving them through a queue
+ * created with xQueueCreateZeroCopy(), which only passes a pointer to a buffer
+ * from the queue's pool.  Frames of each size in zcFRAME_SIZES are measured.
+ *
+ * A producer task sends zcFRAMES_TRANSFERRED frames, and a consumer task at
+ * the same priority receives them.  Each frame carries a sequence number at
+ * its start and its end, which the consumer checks.  The number of frames
+ * moved per second is reported for each queue and frame size.  The zero copy
+ * queue makes four queue operations per frame where the copying queue makes
+ * two, so on this port, where each queue operation enters a critical section
+ * with a system call, it only overtakes the copying queue for large frames.
+ *
+ * The zero copy queue is also checked to hand out every buffer in its pool
+ * exactly once, to fail an acquire when the pool is empty, to keep a buffer
+ * with its owner when a send fails, and to time out a blocked receive after
+ * the block time.  Any error is counted, and the application exits with a
+ * failure status if there are errors.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+/* Local includes. */
+#include "console.h"
+
+#if ( configUSE_ZERO_COPY_QUEUES == 1 )
+
+/* The frame sizes measured, the queues and the work each measurement does. */
+    #define zcFRAME_SIZES               { 1024U, 4096U, 16384U }
+    #define zcMAX_FRAME_SIZE            ( 16384U )
+    #define zcQUEUE_LENGTH              ( 8U )
+    #define zcNUMBER_OF_BUFFERS         ( 12U )
+    #define zcFRAMES_TRANSFERRED        ( 500000UL )
+
+/* The block time used to check a blocked receive times out. */
+    #define zcBLOCK_TIME_TICKS          ( 10U )
+
+/* The producer and consumer share a priority, below that of the controller. */
+    #define zcWORKER_PRIORITY           ( tskIDLE_PRIORITY + 1U )
+    #define zcCONTROLLER_PRIORITY       ( tskIDLE_PRIORITY + 2U )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The tasks as described in the comments at the top of this file.
+ */
+static void prvControllerTask( void * pvParameters );
+static void prvProducerTask( void * pvParameters );
+static void prvConsumerTask( void * pvParameters );
+
+/*
+ * Time the producer and consumer moving frames through xQueue, and return the
+ * number of frames moved per second.  xZeroCopy selects whether the queue is
+ * used with xQueueSend() and xQueueReceive(), or is a zero copy queue.
+ */
+static double prvMeasure( QueueHandle_t xQueue,
+                          BaseType_t xZeroCopy,
+                          size_t xFrameSize );
+
+/*
+ * Check the pool and the ownership of the buffers of a zero copy queue.
+ */
+static void prvCheckPool( QueueHandle_t xQueue,
+                          size_t xFrameSize );
+
+/*
+ * Returns a monotonic time stamp in nanoseconds.
+ */
+static uint64_t prvGetTimeNs( void );
+
+/*-----------------------------------------------------------*/
+
+/* The queue the producer and consumer are to use next, how, and the number
+ * of 32-bit words in each frame. */
+static QueueHandle_t xWorkerQueue = NULL;
+static BaseType_t xWorkerZeroCopy = pdFALSE;
+static size_t xWorkerFrameWords = 0U;
+
+/* The tasks, so they can be notified. */
+static TaskHandle_t xControllerTask = NULL;
+static TaskHandle_t xProducerTask = NULL;
+static TaskHandle_t xConsumerTask = NULL;
+
+/* The frames the producer and consumer copy to and from the copying queue. */
+static uint32_t ulProducerFrame[ zcMAX_FRAME_SIZE / sizeof( uint32_t ) ];
+static uint32_t ulConsumerFrame[ zcMAX_FRAME_SIZE / sizeof( uint32_t ) ];
+
+/* The number of errors found. */
+static volatile uint32_t ulErrors = 0UL;
+
+/*-----------------------------------------------------------*/
+
+/*** SEE THE COMMENTS AT THE TOP OF THIS FILE ***/
+void main_zero_copy_benchmark( void )
+{
+    xTaskCreate( prvControllerTask, "Control", configMINIMAL_STACK_SIZE * 2U, NULL, zcCONTROLLER_PRIORITY, &xControllerTask );
+    xTaskCreate( prvProducerTask, "Producer", configMINIMAL_STACK_SIZE, NULL, zcWORKER_PRIORITY, &xProducerTask );
+    xTaskCreate( prvConsumerTask, "Consumer", configMINIMAL_STACK_SIZE, NULL, zcWORKER_PRIORITY, &xConsumerTask );
+
+    vTaskStartScheduler();
+}
+/*-----------------------------------------------------------*/
+
+static void prvControllerTask( void * pvParameters )
+{
+    static const size_t xFrameSizes[] = zcFRAME_SIZES;
+    QueueHandle_t xQueue, xZeroCopyQueue;
+    double dQueueFramesPerSecond, dZeroCopyFramesPerSecond;
+    size_t xSize;
+
+    ( void ) pvParameters;
+
+    console_print( "Zero copy benchmark: queues of %u frames, %u buffers in the pool\n", ( unsigned ) zcQUEUE_LENGTH, ( unsigned ) zcNUMBER_OF_BUFFERS );
+    console_print( "frame size (bytes), xQueueCreate (frames/s), xQueueCreateZeroCopy (frames/s)\n" );
+
+    for( xSize = 0U; xSize < ( sizeof( xFrameSizes ) / sizeof( xFrameSizes[ 0 ] ) ); xSize++ )
+    {
+        xQueue = xQueueCreate( zcQUEUE_LENGTH, xFrameSizes[ xSize ] );
+        xZeroCopyQueue = xQueueCreateZeroCopy( zcQUEUE_LENGTH, zcNUMBER_OF_BUFFERS, xFrameSizes[ xSize ] );
+        configASSERT( xQueue );
+        configASSERT( xZeroCopyQueue );
+
+        prvCheckPool( xZeroCopyQueue, xFrameSizes[ xSize ] );
+
+        dQueueFramesPerSecond = prvMeasure( xQueue, pdFALSE, xFrameSizes[ xSize ] );
+        dZeroCopyFramesPerSecond = prvMeasure( xZeroCopyQueue, pdTRUE, xFrameSizes[ xSize ] );
+
+        /* Every buffer must be back in the pool once the consumer is done. */
+        prvCheckPool( xZeroCopyQueue, xFrameSizes[ xSize ] );
+
+        console_print( "%u, %.0f, %.0f\n", ( unsigned ) xFrameSizes[ xSize ], dQueueFramesPerSecond, dZeroCopyFramesPerSecond );
+
+        vQueueDelete( xQueue );
+        vQueueDelete( xZeroCopyQueue );
+    }
+
+    console_print( "errors, %lu\n", ( unsigned long ) ulErrors );
+
+    /* Exit the process directly rather than ending the scheduler, so the
+     * threads of the producer and consumer do not have to be torn down. */
+    if( ulErrors != 0UL )
+    {
+        exit( EXIT_FAILURE );
+    }
+
+    exit( EXIT_SUCCESS );
+}
+/*-----------------------------------------------------------*/
+
+static double prvMeasure( QueueHandle_t xQueue,
+                          BaseType_t xZeroCopy,
+                          size_t xFrameSize )
+{
+    uint64_t ullStartNs, ullDurationNs;
+
+    xWorkerQueue = xQueue;
+    xWorkerZeroCopy = xZeroCopy;
+    xWorkerFrameWords = xFrameSize / sizeof( uint32_t );
+
+    ullStartNs = prvGetTimeNs();
+
+    /* The controller runs above the producer and consumer, so it only runs
+     * again once both have finished. */
+    xTaskNotifyGive( xProducerTask );
+    xTaskNotifyGive( xConsumerTask );
+    ( void ) ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+    ( void ) ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+
+    ullDurationNs = prvGetTimeNs() - ullStartNs;
+
+    return ( ( double ) zcFRAMES_TRANSFERRED * 1000000000.0 ) / ( double ) ullDurationNs;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckPool( QueueHandle_t xQueue,
+                          size_t xFrameSize )
+{
+    void * pvBuffers[ zcNUMBER_OF_BUFFERS ];
+    void * pvBuffer;
+    uint32_t ulBuffer, ulOther;
+    TickType_t xStartTime;
+
+    /* Take every buffer in the pool.  Each must be a different, aligned
+     * buffer that can be written in full. */
+    for( ulBuffer = 0UL; ulBuffer < zcNUMBER_OF_BUFFERS; ulBuffer++ )
+    {
+        pvBuffers[ ulBuffer ] = pvQueueAcquireBuffer( xQueue, 0U );
+
+        if( ( pvBuffers[ ulBuffer ] == NULL ) ||
+            ( ( ( portPOINTER_SIZE_TYPE ) pvBuffers[ ulBuffer ] & portBYTE_ALIGNMENT_MASK ) != 0U ) )
+        {
+            ulErrors++;
+        }
+        else
+        {
+            memset( pvBuffers[ ulBuffer ], ( int ) ulBuffer, xFrameSize );
+        }
+
+        for( ulOther = 0UL; ulOther < ulBuffer; ulOther++ )
+        {
+            if( pvBuffers[ ulOther ] == pvBuffers[ ulBuffer ] )
+            {
+                ulErrors++;
+            }
+        }
+    }
+
+    /* The pool is empty, so no buffer can be acquired. */
+    if( pvQueueAcquireBuffer( xQueue, 0U ) != NULL )
+    {
+        ulErrors++;
+    }
+
+    /* Fill the queue.  A buffer that cannot be sent stays with this task, so
+     * it can still be released. */
+    for( ulBuffer = 0UL; ulBuffer < zcQUEUE_LENGTH; ulBuffer++ )
+    {
+        if( xQueueSendBuffer( xQueue, pvBuffers[ ulBuffer ], 0U ) != pdPASS )
+        {
+            ulErrors++;
+        }
+    }
+
+    if( xQueueSendBuffer( xQueue, pvBuffers[ zcQUEUE_LENGTH ], 0U ) != errQUEUE_FULL )
+    {
+        ulErrors++;
+    }
+
+    for( ulBuffer = zcQUEUE_LENGTH; ulBuffer < zcNUMBER_OF_BUFFERS; ulBuffer++ )
+    {
+        vQueueReleaseBuffer( xQueue, pvBuffers[ ulBuffer ] );
+    }
+
+    /* The buffers come out of the queue in order and unchanged. */
+    for( ulBuffer = 0UL; ulBuffer < zcQUEUE_LENGTH; ulBuffer++ )
+    {
+        pvBuffer = pvQueueReceiveBuffer( xQueue, 0U );
+
+        if( ( pvBuffer != pvBuffers[ ulBuffer ] ) ||
+            ( ( ( uint8_t * ) pvBuffer )[ xFrameSize - 1U ] != ( uint8_t ) ulBuffer ) )
+        {
+            ulErrors++;
+        }
+
+        if( pvBuffer != NULL )
+        {
+            vQueueReleaseBuffer( xQueue, pvBuffer );
+        }
+    }
+
+    xStartTime = xTaskGetTickCount();
+
+    if( ( pvQueueReceiveBuffer( xQueue, zcBLOCK_TIME_TICKS ) != NULL ) ||
+        ( ( xTaskGetTickCount() - xStartTime ) < zcBLOCK_TIME_TICKS ) )
+    {
+        ulErrors++;
+    }
+
+    /* Every buffer is back in the pool. */
+    for( ulBuffer = 0UL; ulBuffer < zcNUMBER_OF_BUFFERS; ulBuffer++ )
+    {
+        pvBuffers[ ulBuffer ] = pvQueueAcquireBuffer( xQueue, 0U );
+
+        if( pvBuffers[ ulBuffer ] == NULL )
+        {
+            ulErrors++;
+        }
+    }
+
+    for( ulBuffer = 0UL; ulBuffer < zcNUMBER_OF_BUFFERS; ulBuffer++ )
+    {
+        if( pvBuffers[ ulBuffer ] != NULL )
+        {
+            vQueueReleaseBuffer( xQueue, pvBuffers[ ulBuffer ] );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvProducerTask( void * pvParameters )
+{
+    uint32_t ulFrame;
+    uint32_t * pulFrame;
+
+    ( void ) pvParameters;
+
+    for( ; ; )
+    {
+        ( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+        for( ulFrame = 0UL; ulFrame < zcFRAMES_TRANSFERRED; ulFrame++ )
+        {
+            if( xWorkerZeroCopy != pdFALSE )
+            {
+                pulFrame = pvQueueAcquireBuffer( xWorkerQueue, portMAX_DELAY );
+                pulFrame[ 0 ] = ulFrame;
+                pulFrame[ xWorkerFrameWords - 1U ] = ulFrame;
+
+                if( xQueueSendBuffer( xWorkerQueue, pulFrame, portMAX_DELAY ) != pdPASS )
+                {
+                    ulErrors++;
+                }
+            }
+            else
+            {
+                ulProducerFrame[ 0 ] = ulFrame;
+                ulProducerFrame[ xWorkerFrameWords - 1U ] = ulFrame;
+
+                if( xQueueSend( xWorkerQueue, ulProducerFrame, portMAX_DELAY ) != pdPASS )
+                {
+                    ulErrors++;
+                }
+            }
+        }
+
+        xTaskNotifyGive( xControllerTask );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvConsumerTask( void * pvParameters )
+{
+    uint32_t ulExpected;
+    uint32_t * pulFrame;
+
+    ( void ) pvParameters;
+
+    for( ; ; )
+    {
+        ( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+        for( ulExpected = 0UL; ulExpected < zcFRAMES_TRANSFERRED; ulExpected++ )
+        {
+            if( xWorkerZeroCopy != pdFALSE )
+            {
+                pulFrame = pvQueueReceiveBuffer( xWorkerQueue, portMAX_DELAY );
+
+                if( ( pulFrame[ 0 ] != ulExpected ) || ( pulFrame[ xWorkerFrameWords - 1U ] != ulExpected ) )
+                {
+                    ulErrors++;
+                }
+
+                vQueueReleaseBuffer( xWorkerQueue, pulFrame );
+            }
+            else
+            {
+                if( ( xQueueReceive( xWorkerQueue, ulConsumerFrame, portMAX_DELAY ) != pdPASS ) ||
+                    ( ulConsumerFrame[ 0 ] != ulExpected ) ||
+                    ( ulConsumerFrame[ xWorkerFrameWords - 1U ] != ulExpected ) )
+                {
+                    ulErrors++;
+                }
+            }
+        }
+
+        xTaskNotifyGive( xControllerTask );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvGetTimeNs( void )
+{
+    struct timespec xNow;
+
+    ( void ) clock_gettime( CLOCK_MONOTONIC, &xNow );
+
+    return ( ( uint64_t ) xNow.tv_sec * 1000000000ULL ) + ( uint64_t ) xNow.tv_nsec;
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_ZERO_COPY_QUEUES == 1 */
@@ -121,10 +121,14 @@ void main_blinky(void)
     if (xQueue != NULL)
     {
         printf("Starting round-robin-weight Scheduler\n");
-        xTaskCreate(T1, (signed char *)"T1", 1000, &wT1, 1, &xT1);
-        xTaskCreate(T2, (signed char *)"T2", 1000, &wT2, 1, &xT2);
-        xTaskCreate(T3, (signed char *)"T3", 1000, &wT3, 1, &xT3);
-        xTaskCreate(T4, (signed char *)"T4", 1000, &wT4, 1, &xT4);
+        xTaskCreate(T1, (signed char *)"T1", 1000, NULL, 1, &xT1);
+        xTaskCreate(T2, (signed char *)"T2", 1000, NULL, 1, &xT2);
+        xTaskCreate(T3, (signed char *)"T3", 1000, NULL, 1, &xT3);
+        xTaskCreate(T4, (signed char *)"T4", 1000, NULL, 1, &xT4);
+        vTaskSetWeight(xT1, wT1);
+        vTaskSetWeight(xT2, wT2);
+        vTaskSetWeight(xT3, wT3);
+        vTaskSetWeight(xT4, wT4);
         /* Start the tasks running. */
         vTaskStartScheduler();
     }
@@ -140,8 +140,6 @@ void main_blinky(void)
     xQueue = xQueueCreate(mainQUEUE_LENGTH, sizeof(uint32_t));
 
     pvParameter_t param[4];
-    for(int i = 0; i < 4; i++)
-        param[i].uxWeight = 0;
     param[0].uxDeadLine = 100;
     param[1].uxDeadLine = 1400;
     param[2].uxDeadLine = 1000;
@@ -63,6 +63,10 @@
         #if ( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
             uint8_t ucStaticallyAllocated; /**< Set to pdTRUE if the event group is statically allocated to ensure no attempt is made to free the memory. */
         #endif
+
+        #if ( configUSE_INDEXED_EVENT_GROUP_WAITERS == 1 )
+            List_t xTasksWaitingForBit[ eventNUMBER_OF_EVENT_BITS ]; /**< Lists of tasks that cannot be unblocked until the bit of the same number is set.  Tasks not in one of these lists are in xTasksWaitingForBits. */
+        #endif
     } EventGroup_t;
 
 /*-----------------------------------------------------------*/
@@ -79,6 +83,38 @@
                                             const EventBits_t uxBitsToWaitFor,
                                             const BaseType_t xWaitForAllBits ) PRIVILEGED_FUNCTION;
 
+/*
+ * Initialise the lists of tasks waiting for the event group.
+ */
+    static void prvInitialiseWaitingLists( EventGroup_t * pxEventBits ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns the list a task that is waiting for the condition described by
+ * uxBitsToWaitFor and xWaitForAllBits is placed in while the event group's bits
+ * are uxCurrentEventBits.  The condition must not already be met.  If
+ * configUSE_INDEXED_EVENT_GROUP_WAITERS is 1 this is the list of a bit the
+ * condition cannot be met without, if there is one, else it is
+ * xTasksWaitingForBits.
+ */
+    static List_t * prvGetWaitingList( EventGroup_t * pxEventBits,
+                                       const EventBits_t uxCurrentEventBits,
+                                       const EventBits_t uxBitsToWaitFor,
+                                       const BaseType_t xWaitForAllBits ) PRIVILEGED_FUNCTION;
+
+/*
+ * Unblock the tasks in pxList whose wait condition is met by the event group's
+ * bits, and return the bits those tasks asked to be cleared on exit.  If
+ * configUSE_INDEXED_EVENT_GROUP_WAITERS is 1, a task in the list of a bit that
+ * is still waiting is moved to the list of another bit it is waiting for.
+ */
+    static EventBits_t prvUnblockWaitingTasks( EventGroup_t * pxEventBits,
+                                               const List_t * pxList ) PRIVILEGED_FUNCTION;
+
+/*
+ * Unblock every task in pxList, as the event group is being deleted.
+ */
+    static void prvUnblockAllWaitingTasks( const List_t * pxList ) PRIVILEGED_FUNCTION;
+
 /*-----------------------------------------------------------*/
 
     #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
@@ -111,7 +147,7 @@
             if( pxEventBits != NULL )
             {
                 pxEventBits->uxEventBits = 0;
-                vListInitialise( &( pxEventBits->xTasksWaitingForBits ) );
+                prvInitialiseWaitingLists( pxEventBits );
 
                 #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
                 {
@@ -156,7 +192,7 @@
             if( pxEventBits != NULL )
             {
                 pxEventBits->uxEventBits = 0;
-                vListInitialise( &( pxEventBits->xTasksWaitingForBits ) );
+                prvInitialiseWaitingLists( pxEventBits );
 
                 #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
                 {
@@ -228,7 +264,7 @@
                     /* Store the bits that the calling task is waiting for in the
                      * task's event list item so the kernel knows when a match is
                      * found.  Then enter the blocked state. */
-                    vTaskPlaceOnUnorderedEventList( &( pxEventBits->xTasksWaitingForBits ), ( uxBitsToWaitFor | eventCLEAR_EVENTS_ON_EXIT_BIT | eventWAIT_FOR_ALL_BITS ), xTicksToWait );
+                    vTaskPlaceOnUnorderedEventList( prvGetWaitingList( pxEventBits, pxEventBits->uxEventBits, uxBitsToWaitFor, pdTRUE ), ( uxBitsToWaitFor | eventCLEAR_EVENTS_ON_EXIT_BIT | eventWAIT_FOR_ALL_BITS ), xTicksToWait );
 
                     /* This assignment is obsolete as uxReturn will get set after
                      * the task unblocks, but some compilers mistakenly generate a
@@ -391,7 +427,7 @@
                 /* Store the bits that the calling task is waiting for in the
                  * task's event list item so the kernel knows when a match is
                  * found.  Then enter the blocked state. */
-                vTaskPlaceOnUnorderedEventList( &( pxEventBits->xTasksWaitingForBits ), ( uxBitsToWaitFor | uxControlBits ), xTicksToWait );
+                vTaskPlaceOnUnorderedEventList( prvGetWaitingList( pxEventBits, uxCurrentEventBits, uxBitsToWaitFor, xWaitForAllBits ), ( uxBitsToWaitFor | uxControlBits ), xTicksToWait );
 
                 /* This is obsolete as it will get set after the task unblocks, but
                  * some compilers mistakenly generate a warning about the variable
@@ -547,13 +583,8 @@
     EventBits_t xEventGroupSetBits( EventGroupHandle_t xEventGroup,
                                     const EventBits_t uxBitsToSet )
     {
-        ListItem_t * pxListItem;
-        ListItem_t * pxNext;
-        ListItem_t const * pxListEnd;
-        List_t const * pxList;
-        EventBits_t uxBitsToClear = 0, uxBitsWaitedFor, uxControlBits, uxReturnBits;
+        EventBits_t uxBitsToClear = 0, uxReturnBits;
         EventGroup_t * pxEventBits = xEventGroup;
-        BaseType_t xMatchFound = pdFALSE;
 
         traceENTER_xEventGroupSetBits( xEventGroup, uxBitsToSet );
 
@@ -562,75 +593,40 @@
         configASSERT( xEventGroup );
         configASSERT( ( uxBitsToSet & eventEVENT_BITS_CONTROL_BYTES ) == 0 );
 
-        pxList = &( pxEventBits->xTasksWaitingForBits );
-        pxListEnd = listGET_END_MARKER( pxList );
         vTaskSuspendAll();
         {
             traceEVENT_GROUP_SET_BITS( xEventGroup, uxBitsToSet );
 
-            pxListItem = listGET_HEAD_ENTRY( pxList );
-
             /* Set the bits. */
             pxEventBits->uxEventBits |= uxBitsToSet;
 
-            /* See if the new bit value should unblock any tasks. */
-            while( pxListItem != pxListEnd )
+            #if ( configUSE_INDEXED_EVENT_GROUP_WAITERS == 1 )
             {
-                pxNext = listGET_NEXT( pxListItem );
-                uxBitsWaitedFor = listGET_LIST_ITEM_VALUE( pxListItem );
-                xMatchFound = pdFALSE;
-
-                /* Split the bits waited for from the control bits. */
-                uxControlBits = uxBitsWaitedFor & eventEVENT_BITS_CONTROL_BYTES;
-                uxBitsWaitedFor &= ~eventEVENT_BITS_CONTROL_BYTES;
-
-                if( ( uxControlBits & eventWAIT_FOR_ALL_BITS ) == ( EventBits_t ) 0 )
-                {
-                    /* Just looking for single bit being set. */
-                    if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) != ( EventBits_t ) 0 )
-                    {
-                        xMatchFound = pdTRUE;
-                    }
-                    else
-                    {
-                        mtCOVERAGE_TEST_MARKER();
-                    }
-                }
-                else if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) == uxBitsWaitedFor )
-                {
-                    /* All bits are set. */
-                    xMatchFound = pdTRUE;
-                }
-                else
-                {
-                    /* Need all bits to be set, but not all the bits were set. */
-                }
+                EventBits_t uxBitsToCheck = uxBitsToSet;
+                UBaseType_t uxBit = 0;
 
-                if( xMatchFound != pdFALSE )
+                /* A task in the list of a bit that was not set cannot have
+                 * been unblocked by this call, so only the lists of the bits
+                 * being set are checked. */
+                while( uxBitsToCheck != ( EventBits_t ) 0 )
                 {
-                    /* The bits match.  Should the bits be cleared on exit? */
-                    if( ( uxControlBits & eventCLEAR_EVENTS_ON_EXIT_BIT ) != ( EventBits_t ) 0 )
+                    if( ( uxBitsToCheck & ( EventBits_t ) 1 ) != ( EventBits_t ) 0 )
                     {
-                        uxBitsToClear |= uxBitsWaitedFor;
+                        uxBitsToClear |= prvUnblockWaitingTasks( pxEventBits, &( pxEventBits->xTasksWaitingForBit[ uxBit ] ) );
                     }
                     else
                     {
                         mtCOVERAGE_TEST_MARKER();
                     }
 
-                    /* Store the actual event flag value in the task's event list
-                     * item before removing the task from the event list.  The
-                     * eventUNBLOCKED_DUE_TO_BIT_SET bit is set so the task knows
-                     * that is was unblocked due to its required bits matching, rather
-                     * than because it timed out. */
-                    vTaskRemoveFromUnorderedEventList( pxListItem, pxEventBits->uxEventBits | eventUNBLOCKED_DUE_TO_BIT_SET );
+                    uxBitsToCheck >>= 1;
+                    uxBit++;
                 }
-
-                /* Move onto the next list item.  Note pxListItem->pxNext is not
-                 * used here as the list item may have been removed from the event list
-                 * and inserted into the ready/pending reading list. */
-                pxListItem = pxNext;
             }
+            #endif /* configUSE_INDEXED_EVENT_GROUP_WAITERS */
+
+            /* See if the new bit value should unblock any tasks. */
+            uxBitsToClear |= prvUnblockWaitingTasks( pxEventBits, &( pxEventBits->xTasksWaitingForBits ) );
 
             /* Clear any bits that matched when the eventCLEAR_EVENTS_ON_EXIT_BIT
              * bit was set in the control word. */
@@ -650,25 +646,27 @@
     void vEventGroupDelete( EventGroupHandle_t xEventGroup )
     {
         EventGroup_t * pxEventBits = xEventGroup;
-        const List_t * pxTasksWaitingForBits;
 
         traceENTER_vEventGroupDelete( xEventGroup );
 
         configASSERT( pxEventBits );
 
-        pxTasksWaitingForBits = &( pxEventBits->xTasksWaitingForBits );
-
         vTaskSuspendAll();
         {
             traceEVENT_GROUP_DELETE( xEventGroup );
 
-            while( listCURRENT_LIST_LENGTH( pxTasksWaitingForBits ) > ( UBaseType_t ) 0 )
+            prvUnblockAllWaitingTasks( &( pxEventBits->xTasksWaitingForBits ) );
+
+            #if ( configUSE_INDEXED_EVENT_GROUP_WAITERS == 1 )
             {
-                /* Unblock the task, returning 0 as the event list is being deleted
-                 * and cannot therefore have any bits set. */
-                configASSERT( pxTasksWaitingForBits->xListEnd.pxNext != ( const ListItem_t * ) &( pxTasksWaitingForBits->xListEnd ) );
-                vTaskRemoveFromUnorderedEventList( pxTasksWaitingForBits->xListEnd.pxNext, eventUNBLOCKED_DUE_TO_BIT_SET );
+                UBaseType_t uxBit;
+
+                for( uxBit = 0; uxBit < eventNUMBER_OF_EVENT_BITS; uxBit++ )
+                {
+                    prvUnblockAllWaitingTasks( &( pxEventBits->xTasksWaitingForBit[ uxBit ] ) );
+                }
             }
+            #endif /* configUSE_INDEXED_EVENT_GROUP_WAITERS */
         }
         ( void ) xTaskResumeAll();
 
@@ -812,6 +810,183 @@
     }
 /*-----------------------------------------------------------*/
 
+    static void prvInitialiseWaitingLists( EventGroup_t * pxEventBits )
+    {
+        vListInitialise( &( pxEventBits->xTasksWaitingForBits ) );
+
+        #if ( configUSE_INDEXED_EVENT_GROUP_WAITERS == 1 )
+        {
+            UBaseType_t uxBit;
+
+            for( uxBit = 0; uxBit < eventNUMBER_OF_EVENT_BITS; uxBit++ )
+            {
+                vListInitialise( &( pxEventBits->xTasksWaitingForBit[ uxBit ] ) );
+            }
+        }
+        #endif /* configUSE_INDEXED_EVENT_GROUP_WAITERS */
+    }
+/*-----------------------------------------------------------*/
+
+    static List_t * prvGetWaitingList( EventGroup_t * pxEventBits,
+                                       const EventBits_t uxCurrentEventBits,
+                                       const EventBits_t uxBitsToWaitFor,
+                                       const BaseType_t xWaitForAllBits )
+    {
+        List_t * pxList = &( pxEventBits->xTasksWaitingForBits );
+
+        #if ( configUSE_INDEXED_EVENT_GROUP_WAITERS == 1 )
+        {
+            EventBits_t uxKeyBits;
+            UBaseType_t uxBit = 0;
+
+            if( xWaitForAllBits != pdFALSE )
+            {
+                /* The condition cannot be met until every bit waited for is
+                 * set, so any bit waited for that is not yet set can be used. */
+                uxKeyBits = uxBitsToWaitFor & ~uxCurrentEventBits;
+            }
+            else if( ( uxBitsToWaitFor & ( uxBitsToWaitFor - ( EventBits_t ) 1 ) ) == ( EventBits_t ) 0 )
+            {
+                /* Waiting for a single bit. */
+                uxKeyBits = uxBitsToWaitFor;
+            }
+            else
+            {
+                /* Setting any one of several bits would meet the condition,
+                 * so the task has to be checked whichever bits are set. */
+                uxKeyBits = 0;
+            }
+
+            if( uxKeyBits != ( EventBits_t ) 0 )
+            {
+                /* Use the lowest of the bits. */
+                while( ( uxKeyBits & ( EventBits_t ) 1 ) == ( EventBits_t ) 0 )
+                {
+                    uxKeyBits >>= 1;
+                    uxBit++;
+                }
+
+                pxList = &( pxEventBits->xTasksWaitingForBit[ uxBit ] );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        #else /* if ( configUSE_INDEXED_EVENT_GROUP_WAITERS == 1 ) */
+        {
+            /* Only one list of waiting tasks is kept. */
+            ( void ) uxCurrentEventBits;
+            ( void ) uxBitsToWaitFor;
+            ( void ) xWaitForAllBits;
+        }
+        #endif /* configUSE_INDEXED_EVENT_GROUP_WAITERS */
+
+        return pxList;
+    }
+/*-----------------------------------------------------------*/
+
+    static EventBits_t prvUnblockWaitingTasks( EventGroup_t * pxEventBits,
+                                               const List_t * pxList )
+    {
+        ListItem_t * pxListItem;
+        ListItem_t * pxNext;
+        ListItem_t const * pxListEnd;
+        EventBits_t uxBitsToClear = 0, uxBitsWaitedFor, uxControlBits;
+        BaseType_t xMatchFound;
+
+        pxListEnd = listGET_END_MARKER( pxList );
+        pxListItem = listGET_HEAD_ENTRY( pxList );
+
+        while( pxListItem != pxListEnd )
+        {
+            pxNext = listGET_NEXT( pxListItem );
+            uxBitsWaitedFor = listGET_LIST_ITEM_VALUE( pxListItem );
+            xMatchFound = pdFALSE;
+
+            /* Split the bits waited for from the control bits. */
+            uxControlBits = uxBitsWaitedFor & eventEVENT_BITS_CONTROL_BYTES;
+            uxBitsWaitedFor &= ~eventEVENT_BITS_CONTROL_BYTES;
+
+            if( ( uxControlBits & eventWAIT_FOR_ALL_BITS ) == ( EventBits_t ) 0 )
+            {
+                /* Just looking for single bit being set. */
+                if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) != ( EventBits_t ) 0 )
+                {
+                    xMatchFound = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) == uxBitsWaitedFor )
+            {
+                /* All bits are set. */
+                xMatchFound = pdTRUE;
+            }
+            else
+            {
+                /* Need all bits to be set, but not all the bits were set. */
+                #if ( configUSE_INDEXED_EVENT_GROUP_WAITERS == 1 )
+                {
+                    if( pxList != &( pxEventBits->xTasksWaitingForBits ) )
+                    {
+                        /* The bit the task was waiting in the list of is now
+                         * set, so move it to the list of a bit that is not. */
+                        ( void ) uxListRemove( pxListItem );
+                        vListInsertEnd( prvGetWaitingList( pxEventBits, pxEventBits->uxEventBits, uxBitsWaitedFor, pdTRUE ), pxListItem );
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                #endif /* configUSE_INDEXED_EVENT_GROUP_WAITERS */
+            }
+
+            if( xMatchFound != pdFALSE )
+            {
+                /* The bits match.  Should the bits be cleared on exit? */
+                if( ( uxControlBits & eventCLEAR_EVENTS_ON_EXIT_BIT ) != ( EventBits_t ) 0 )
+                {
+                    uxBitsToClear |= uxBitsWaitedFor;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                /* Store the actual event flag value in the task's event list
+                 * item before removing the task from the event list.  The
+                 * eventUNBLOCKED_DUE_TO_BIT_SET bit is set so the task knows
+                 * that is was unblocked due to its required bits matching, rather
+                 * than because it timed out. */
+                vTaskRemoveFromUnorderedEventList( pxListItem, pxEventBits->uxEventBits | eventUNBLOCKED_DUE_TO_BIT_SET );
+            }
+
+            /* Move onto the next list item.  Note pxListItem->pxNext is not
+             * used here as the list item may have been removed from the event list
+             * and inserted into the ready/pending reading list. */
+            pxListItem = pxNext;
+        }
+
+        return uxBitsToClear;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvUnblockAllWaitingTasks( const List_t * pxList )
+    {
+        while( listCURRENT_LIST_LENGTH( pxList ) > ( UBaseType_t ) 0 )
+        {
+            /* Unblock the task, returning 0 as the event list is being deleted
+             * and cannot therefore have any bits set. */
+            configASSERT( pxList->xListEnd.pxNext != ( const ListItem_t * ) &( pxList->xListEnd ) );
+            vTaskRemoveFromUnorderedEventList( pxList->xListEnd.pxNext, eventUNBLOCKED_DUE_TO_BIT_SET );
+        }
+    }
+/*-----------------------------------------------------------*/
+
     #if ( ( configUSE_TRACE_FACILITY == 1 ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
 
         BaseType_t xEventGroupSetBitsFromISR( EventGroupHandle_t xEventGroup,
@@ -0,0 +1,466 @@
+/*
+ * FreeRTOS Kernel <DEVELOPMENT BRANCH>
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+/*
+ * The heap profiler.  heap_4.c and heap_5.c call vPortHeapProfilerRecordAlloc()
+ * for every block pvPortMalloc() returns, and vPortHeapProfilerRecordFree() for
+ * every block passed to vPortFree(), when configUSE_HEAP_PROFILER is 1.  Each
+ * live block has a record in an open addressed hash table, indexed by the
+ * block's address and searched with linear probing.  Records are removed by
+ * shifting the records that follow them back, rather than by leaving deleted
+ * markers, so searches stay short however long the application runs.  A
+ * profile is built by copying the records a few at a time and adding each copy
+ * to its group in a second open addressed hash table, indexed by call site or
+ * task.  See heap_profiler.h.
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers. That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "heap_profiler.h"
+
+/* The MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
+ * for the header files above, but not in this file, in order to generate the
+ * correct privileged Vs unprivileged linkage and placement. */
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* This entire source file will be skipped if the application is not configured
+ * to include the heap profiler. This #if is closed at the very bottom of this
+ * file. If you want to include the heap profiler then ensure
+ * configUSE_HEAP_PROFILER is set to 1 in FreeRTOSConfig.h. */
+#if ( configUSE_HEAP_PROFILER == 1 )
+
+/* Used to wrap indexes around the end of the table. */
+    #define heapprofilerINDEX_MASK     ( ( UBaseType_t ) configHEAP_PROFILER_TABLE_SIZE - 1U )
+
+/* The table is never filled beyond three quarters, so there is always an empty
+ * record close to where a search starts. */
+    #define heapprofilerMAX_RECORDS    ( ( ( UBaseType_t ) configHEAP_PROFILER_TABLE_SIZE / 4U ) * 3U )
+
+/* The record a search for pvBlock starts at.  The low bits of a block address
+ * are always zero, so are shifted out, and the higher bits folded in so blocks
+ * far apart in memory do not collide. */
+    #define heapprofilerHOME_INDEX( pvBlock )                                                                                       \
+    ( ( UBaseType_t ) ( ( ( ( portPOINTER_SIZE_TYPE ) ( pvBlock ) ) / portBYTE_ALIGNMENT ) ^                                        \
+                        ( ( ( portPOINTER_SIZE_TYPE ) ( pvBlock ) ) / ( portBYTE_ALIGNMENT * configHEAP_PROFILER_TABLE_SIZE ) ) ) & \
+      heapprofilerINDEX_MASK )
+
+/* The group a search for the group of pvKey, a call site or a task handle,
+ * starts at. */
+    #define heapprofilerGROUP_INDEX( pvKey )                                                                                          \
+    ( ( UBaseType_t ) ( ( ( portPOINTER_SIZE_TYPE ) ( pvKey ) ) ^                                                                     \
+                        ( ( ( portPOINTER_SIZE_TYPE ) ( pvKey ) ) / ( portPOINTER_SIZE_TYPE ) configHEAP_PROFILER_TABLE_SIZE ) ) & \
+      heapprofilerINDEX_MASK )
+
+/* The number of records uxPortGetHeapProfile() copies in each critical
+ * section.  The table size is a power of two of at least 4, so is a multiple of
+ * this. */
+    #define heapprofilerRECORDS_PER_COPY    ( ( UBaseType_t ) 4U )
+
+/*-----------------------------------------------------------*/
+
+/* The record of one live block.  A record with a NULL pvBlock is empty. */
+typedef struct HeapProfilerRecord
+{
+    void * pvBlock;         /**< The block returned by pvPortMalloc(). */
+    void * pvCallSite;      /**< The address pvPortMalloc() returned to. */
+    TaskHandle_t xTask;     /**< The task that allocated the block, or NULL if the scheduler had not started. */
+    size_t xBlockSize;      /**< The size of the block in the heap. */
+    TickType_t xTimeStamp;  /**< The tick count when the block was allocated. */
+} HeapProfilerRecord_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Returns the index of the record of pvBlock, or the index of the empty record
+ * a search for pvBlock stopped at if it has no record.  Must be called from a
+ * critical section.
+ */
+static UBaseType_t prvFindRecord( const void * pvBlock ) PRIVILEGED_FUNCTION;
+
+/*
+ * Empties the record at uxIndex, moving back any records that follow it that
+ * would no longer be found.  Must be called from a critical section.
+ */
+static void prvRemoveRecord( UBaseType_t uxIndex ) PRIVILEGED_FUNCTION;
+
+/*
+ * Adds the block of *pxRecord to its group in xGroups, starting the group if
+ * it is the group's first block.
+ */
+static void prvAddToGroup( const HeapProfilerRecord_t * pxRecord,
+                           eHeapProfileGroup eGroup,
+                           TickType_t xNow ) PRIVILEGED_FUNCTION;
+
+/*
+ * Inserts pxGroup into pxProfileArray, which holds uxGroups groups sorted
+ * largest first.  If pxProfileArray is full the smallest group is dropped,
+ * which might be pxGroup.  Returns the number of groups in pxProfileArray.
+ */
+static UBaseType_t prvInsertGroup( const HeapProfile_t * pxGroup,
+                                   HeapProfile_t * const pxProfileArray,
+                                   UBaseType_t uxGroups,
+                                   const UBaseType_t uxArraySize ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+/* The records of the live blocks. */
+PRIVILEGED_DATA static HeapProfilerRecord_t xRecords[ configHEAP_PROFILER_TABLE_SIZE ];
+PRIVILEGED_DATA static UBaseType_t uxRecordsInUse = 0U;
+
+/* The live bytes in blocks that were allocated while the table was full. */
+PRIVILEGED_DATA static size_t xUntrackedBytes = ( size_t ) 0U;
+
+/* The groups uxPortGetHeapProfile() adds the records up into.  A group with no
+ * live blocks is empty.  There are never more groups than records, so there
+ * is always an empty group to end a search. */
+PRIVILEGED_DATA static HeapProfile_t xGroups[ configHEAP_PROFILER_TABLE_SIZE ];
+
+/*-----------------------------------------------------------*/
+
+void vPortHeapProfilerRecordAlloc( void * pvBlock,
+                                   size_t xBlockSize,
+                                   void * pvCallSite )
+{
+    TaskHandle_t xTask = NULL;
+    TickType_t xTimeStamp;
+    UBaseType_t uxIndex;
+
+    /* Blocks allocated before the scheduler starts belong to no task. */
+    #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+    {
+        if( xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED )
+        {
+            xTask = xTaskGetCurrentTaskHandle();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    #else
+    {
+        xTask = xTaskGetCurrentTaskHandle();
+    }
+    #endif /* if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) ) */
+
+    xTimeStamp = xTaskGetTickCount();
+
+    taskENTER_CRITICAL();
+    {
+        if( uxRecordsInUse < heapprofilerMAX_RECORDS )
+        {
+            uxIndex = prvFindRecord( pvBlock );
+            configASSERT( xRecords[ uxIndex ].pvBlock == NULL );
+
+            xRecords[ uxIndex ].pvBlock = pvBlock;
+            xRecords[ uxIndex ].pvCallSite = pvCallSite;
+            xRecords[ uxIndex ].xTask = xTask;
+            xRecords[ uxIndex ].xBlockSize = xBlockSize;
+            xRecords[ uxIndex ].xTimeStamp = xTimeStamp;
+            uxRecordsInUse++;
+        }
+        else
+        {
+            xUntrackedBytes += xBlockSize;
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vPortHeapProfilerRecordFree( void * pvBlock,
+                                  size_t xBlockSize )
+{
+    UBaseType_t uxIndex;
+
+    taskENTER_CRITICAL();
+    {
+        uxIndex = prvFindRecord( pvBlock );
+
+        if( xRecords[ uxIndex ].pvBlock != NULL )
+        {
+            prvRemoveRecord( uxIndex );
+            uxRecordsInUse--;
+        }
+        else
+        {
+            /* The block was allocated while the table was full. */
+            configASSERT( xUntrackedBytes >= xBlockSize );
+            xUntrackedBytes -= xBlockSize;
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxPortGetHeapProfile( HeapProfile_t * const pxProfileArray,
+                                  const UBaseType_t uxArraySize,
+                                  eHeapProfileGroup eGroup )
+{
+    HeapProfilerRecord_t xCopies[ heapprofilerRECORDS_PER_COPY ];
+    UBaseType_t uxIndex, uxCopy, uxGroups = 0U;
+    TickType_t xNow;
+
+    configASSERT( ( pxProfileArray != NULL ) || ( uxArraySize == 0U ) );
+
+    xNow = xTaskGetTickCount();
+
+    /* Only tasks allocate and free heap blocks, so no other task can change
+     * the table, or use xGroups, while the scheduler is suspended.  A task on
+     * another core still can change the table, so the records are copied in
+     * critical sections, heapprofilerRECORDS_PER_COPY records at a time to keep
+     * interrupts masked for only a short, fixed time.  A block such a task
+     * allocates or frees while the profile is built might or might not be
+     * counted.
+     *
+     * Each copy is added to its group as it is made, then the groups are
+     * sorted into pxProfileArray once all of them have been added up, so the
+     * groups kept are the largest however the records are ordered in the
+     * table. */
+    vTaskSuspendAll();
+    {
+        ( void ) memset( xGroups, 0x00, sizeof( xGroups ) );
+
+        for( uxIndex = 0U; uxIndex < ( UBaseType_t ) configHEAP_PROFILER_TABLE_SIZE; uxIndex += heapprofilerRECORDS_PER_COPY )
+        {
+            taskENTER_CRITICAL();
+            {
+                ( void ) memcpy( xCopies, &( xRecords[ uxIndex ] ), sizeof( xCopies ) );
+            }
+            taskEXIT_CRITICAL();
+
+            for( uxCopy = 0U; uxCopy < heapprofilerRECORDS_PER_COPY; uxCopy++ )
+            {
+                if( xCopies[ uxCopy ].pvBlock != NULL )
+                {
+                    prvAddToGroup( &( xCopies[ uxCopy ] ), eGroup, xNow );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+        }
+
+        for( uxIndex = 0U; uxIndex < ( UBaseType_t ) configHEAP_PROFILER_TABLE_SIZE; uxIndex++ )
+        {
+            if( xGroups[ uxIndex ].xLiveBlocks != ( size_t ) 0U )
+            {
+                uxGroups = prvInsertGroup( &( xGroups[ uxIndex ] ), pxProfileArray, uxGroups, uxArraySize );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+    }
+    ( void ) xTaskResumeAll();
+
+    return uxGroups;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetHeapProfileUntrackedBytes( void )
+{
+    return xUntrackedBytes;
+}
+/*-----------------------------------------------------------*/
+
+void vPortHeapProfilerResetState( void )
+{
+    ( void ) memset( xRecords, 0x00, sizeof( xRecords ) );
+    uxRecordsInUse = 0U;
+    xUntrackedBytes = ( size_t ) 0U;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvFindRecord( const void * pvBlock ) /* PRIVILEGED_FUNCTION */
+{
+    UBaseType_t uxIndex = heapprofilerHOME_INDEX( pvBlock );
+
+    /* The table always has empty records, so the search ends. */
+    while( ( xRecords[ uxIndex ].pvBlock != NULL ) && ( xRecords[ uxIndex ].pvBlock != pvBlock ) )
+    {
+        uxIndex = ( uxIndex + 1U ) & heapprofilerINDEX_MASK;
+    }
+
+    return uxIndex;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRemoveRecord( UBaseType_t uxIndex ) /* PRIVILEGED_FUNCTION */
+{
+    UBaseType_t uxNext, uxHome;
+
+    uxNext = ( uxIndex + 1U ) & heapprofilerINDEX_MASK;
+
+    while( xRecords[ uxNext ].pvBlock != NULL )
+    {
+        /* A record can be moved back into the empty record at uxIndex if the
+         * search for it starts at or before uxIndex, so it would otherwise stop
+         * at uxIndex and not be found. */
+        uxHome = heapprofilerHOME_INDEX( xRecords[ uxNext ].pvBlock );
+
+        if( ( ( uxNext - uxHome ) & heapprofilerINDEX_MASK ) >= ( ( uxNext - uxIndex ) & heapprofilerINDEX_MASK ) )
+        {
+            xRecords[ uxIndex ] = xRecords[ uxNext ];
+            uxIndex = uxNext;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        uxNext = ( uxNext + 1U ) & heapprofilerINDEX_MASK;
+    }
+
+    xRecords[ uxIndex ].pvBlock = NULL;
+}
+/*-----------------------------------------------------------*/
+
+static void prvAddToGroup( const HeapProfilerRecord_t * pxRecord,
+                           eHeapProfileGroup eGroup,
+                           TickType_t xNow ) /* PRIVILEGED_FUNCTION */
+{
+    HeapProfile_t * pxGroup;
+    void * pvKey;
+    UBaseType_t uxIndex;
+
+    if( eGroup == eHeapProfileByTask )
+    {
+        pvKey = ( void * ) pxRecord->xTask;
+    }
+    else
+    {
+        pvKey = pxRecord->pvCallSite;
+    }
+
+    uxIndex = heapprofilerGROUP_INDEX( pvKey );
+
+    /* Blocks allocated before the scheduler started have a NULL task, so an
+     * empty group is marked by having no live blocks rather than by a NULL
+     * key. */
+    while( ( xGroups[ uxIndex ].xLiveBlocks != ( size_t ) 0U ) &&
+           ( ( ( eGroup == eHeapProfileByTask ) && ( ( void * ) xGroups[ uxIndex ].xTask != pvKey ) ) ||
+             ( ( eGroup != eHeapProfileByTask ) && ( xGroups[ uxIndex ].pvCallSite != pvKey ) ) ) )
+    {
+        uxIndex = ( uxIndex + 1U ) & heapprofilerINDEX_MASK;
+    }
+
+    pxGroup = &( xGroups[ uxIndex ] );
+
+    if( pxGroup->xLiveBlocks == ( size_t ) 0U )
+    {
+        /* The first block of the group.  xGroups was cleared, so the key that
+         * is not used is already NULL. */
+        if( eGroup == eHeapProfileByTask )
+        {
+            pxGroup->xTask = pxRecord->xTask;
+        }
+        else
+        {
+            pxGroup->pvCallSite = pxRecord->pvCallSite;
+        }
+
+        pxGroup->xOldestTimeStamp = pxRecord->xTimeStamp;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    pxGroup->xLiveBytes += pxRecord->xBlockSize;
+    pxGroup->xLiveBlocks++;
+
+    /* The tick count wraps, so compare ages rather than time stamps. */
+    if( ( xNow - pxRecord->xTimeStamp ) > ( xNow - pxGroup->xOldestTimeStamp ) )
+    {
+        pxGroup->xOldestTimeStamp = pxRecord->xTimeStamp;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvInsertGroup( const HeapProfile_t * pxGroup,
+                                   HeapProfile_t * const pxProfileArray,
+                                   UBaseType_t uxGroups,
+                                   const UBaseType_t uxArraySize ) /* PRIVILEGED_FUNCTION */
+{
+    UBaseType_t uxIndex;
+    BaseType_t xKeep = pdTRUE;
+
+    if( uxGroups < uxArraySize )
+    {
+        uxGroups++;
+    }
+    else if( ( uxArraySize == 0U ) || ( pxProfileArray[ uxArraySize - 1U ].xLiveBytes >= pxGroup->xLiveBytes ) )
+    {
+        /* The array is full of groups at least as large as pxGroup. */
+        xKeep = pdFALSE;
+    }
+    else
+    {
+        /* pxGroup replaces the smallest group. */
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    if( xKeep != pdFALSE )
+    {
+        /* Move the smaller groups up to make room for pxGroup, dropping the
+         * last group if the array was full. */
+        for( uxIndex = uxGroups - 1U; ( uxIndex > 0U ) && ( pxProfileArray[ uxIndex - 1U ].xLiveBytes < pxGroup->xLiveBytes ); uxIndex-- )
+        {
+            pxProfileArray[ uxIndex ] = pxProfileArray[ uxIndex - 1U ];
+        }
+
+        pxProfileArray[ uxIndex ] = *pxGroup;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    return uxGroups;
+}
+/*-----------------------------------------------------------*/
+
+/* This entire source file will be skipped if the application is not configured
+ * to include the heap profiler. If you want to include the heap profiler then
+ * ensure configUSE_HEAP_PROFILER is set to 1 in FreeRTOSConfig.h. */
+#endif /* configUSE_HEAP_PROFILER == 1 */
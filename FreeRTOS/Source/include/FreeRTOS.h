@@ -840,6 +840,10 @@
     #define traceTASK_DELAY_UNTIL( x )
 #endif
 
+#ifndef traceTASK_MISSED_DEADLINE
+    #define traceTASK_MISSED_DEADLINE( pxTCB )
+#endif
+
 #ifndef traceTASK_DELAY
     #define traceTASK_DELAY()
 #endif
@@ -936,6 +940,34 @@
     #define traceEVENT_GROUP_DELETE( xEventGroup )
 #endif
 
+#ifndef tracePOOL_CREATE
+    #define tracePOOL_CREATE( pxPool )
+#endif
+
+#ifndef tracePOOL_CREATE_FAILED
+    #define tracePOOL_CREATE_FAILED()
+#endif
+
+#ifndef tracePOOL_DELETE
+    #define tracePOOL_DELETE( pxPool )
+#endif
+
+#ifndef tracePOOL_ALLOC
+    #define tracePOOL_ALLOC( pxPool, pvBlock )
+#endif
+
+#ifndef tracePOOL_ALLOC_FAILED
+    #define tracePOOL_ALLOC_FAILED( pxPool )
+#endif
+
+#ifndef traceBLOCKING_ON_POOL_ALLOC
+    #define traceBLOCKING_ON_POOL_ALLOC( pxPool )
+#endif
+
+#ifndef tracePOOL_FREE
+    #define tracePOOL_FREE( pxPool, pvBlock )
+#endif
+
 #ifndef tracePEND_FUNC_CALL
     #define tracePEND_FUNC_CALL( xFunctionToPend, pvParameter1, ulParameter2, ret )
 #endif
@@ -1024,6 +1056,10 @@
     #define traceSTREAM_BUFFER_SEND_FAILED( xStreamBuffer )
 #endif
 
+#ifndef traceSTREAM_BUFFER_MPSC_CLAIM
+    #define traceSTREAM_BUFFER_MPSC_CLAIM( xStreamBuffer )
+#endif
+
 #ifndef traceSTREAM_BUFFER_SEND_FROM_ISR
     #define traceSTREAM_BUFFER_SEND_FROM_ISR( xStreamBuffer, xBytesSent )
 #endif
@@ -1196,6 +1232,46 @@
     #define traceRETURN_xQueueGenericCreate( pxNewQueue )
 #endif
 
+#ifndef traceENTER_xQueueCreateZeroCopy
+    #define traceENTER_xQueueCreateZeroCopy( uxQueueLength, uxNumberOfBuffers, xBufferSize )
+#endif
+
+#ifndef traceRETURN_xQueueCreateZeroCopy
+    #define traceRETURN_xQueueCreateZeroCopy( pxNewQueue )
+#endif
+
+#ifndef traceENTER_pvQueueAcquireBuffer
+    #define traceENTER_pvQueueAcquireBuffer( xQueue, xTicksToWait )
+#endif
+
+#ifndef traceRETURN_pvQueueAcquireBuffer
+    #define traceRETURN_pvQueueAcquireBuffer( pvBuffer )
+#endif
+
+#ifndef traceENTER_xQueueSendBuffer
+    #define traceENTER_xQueueSendBuffer( xQueue, pvBuffer, xTicksToWait )
+#endif
+
+#ifndef traceRETURN_xQueueSendBuffer
+    #define traceRETURN_xQueueSendBuffer( xReturn )
+#endif
+
+#ifndef traceENTER_pvQueueReceiveBuffer
+    #define traceENTER_pvQueueReceiveBuffer( xQueue, xTicksToWait )
+#endif
+
+#ifndef traceRETURN_pvQueueReceiveBuffer
+    #define traceRETURN_pvQueueReceiveBuffer( pvBuffer )
+#endif
+
+#ifndef traceENTER_vQueueReleaseBuffer
+    #define traceENTER_vQueueReleaseBuffer( xQueue, pvBuffer )
+#endif
+
+#ifndef traceRETURN_vQueueReleaseBuffer
+    #define traceRETURN_vQueueReleaseBuffer()
+#endif
+
 #ifndef traceENTER_xQueueCreateMutex
     #define traceENTER_xQueueCreateMutex( ucQueueType )
 #endif
@@ -1276,6 +1352,38 @@
     #define traceRETURN_xQueueGenericSendFromISR( xReturn )
 #endif
 
+#ifndef traceENTER_xQueueSendMultiple
+    #define traceENTER_xQueueSendMultiple( xQueue, pvItemsToQueue, uxItemCount, xTicksToWait )
+#endif
+
+#ifndef traceRETURN_xQueueSendMultiple
+    #define traceRETURN_xQueueSendMultiple( xReturn )
+#endif
+
+#ifndef traceENTER_xQueueSendMultipleFromISR
+    #define traceENTER_xQueueSendMultipleFromISR( xQueue, pvItemsToQueue, uxItemCount, pxHigherPriorityTaskWoken )
+#endif
+
+#ifndef traceRETURN_xQueueSendMultipleFromISR
+    #define traceRETURN_xQueueSendMultipleFromISR( xReturn )
+#endif
+
+#ifndef traceENTER_xQueueReceiveMultiple
+    #define traceENTER_xQueueReceiveMultiple( xQueue, pvBuffer, uxMaxItems, xTicksToWait )
+#endif
+
+#ifndef traceRETURN_xQueueReceiveMultiple
+    #define traceRETURN_xQueueReceiveMultiple( xReturn )
+#endif
+
+#ifndef traceENTER_xQueueReceiveMultipleFromISR
+    #define traceENTER_xQueueReceiveMultipleFromISR( xQueue, pvBuffer, uxMaxItems, pxHigherPriorityTaskWoken )
+#endif
+
+#ifndef traceRETURN_xQueueReceiveMultipleFromISR
+    #define traceRETURN_xQueueReceiveMultipleFromISR( xReturn )
+#endif
+
 #ifndef traceENTER_xQueueGiveFromISR
     #define traceENTER_xQueueGiveFromISR( xQueue, pxHigherPriorityTaskWoken )
 #endif
@@ -1740,6 +1848,46 @@
     #define traceRETURN_xTaskCreateAffinitySet( xReturn )
 #endif
 
+#ifndef traceENTER_xTaskCreateMLFQ
+    #define traceENTER_xTaskCreateMLFQ( pxTaskCode, pcName, uxStackDepth, pvParameters, pxCreatedTask )
+#endif
+
+#ifndef traceRETURN_xTaskCreateMLFQ
+    #define traceRETURN_xTaskCreateMLFQ( xReturn )
+#endif
+
+#ifndef traceENTER_xTaskCreateMLFQStatic
+    #define traceENTER_xTaskCreateMLFQStatic( pxTaskCode, pcName, uxStackDepth, pvParameters, puxStackBuffer, pxTaskBuffer )
+#endif
+
+#ifndef traceRETURN_xTaskCreateMLFQStatic
+    #define traceRETURN_xTaskCreateMLFQStatic( xReturn )
+#endif
+
+#ifndef traceENTER_vTaskSetMLFQPolicy
+    #define traceENTER_vTaskSetMLFQPolicy( pxPolicy )
+#endif
+
+#ifndef traceRETURN_vTaskSetMLFQPolicy
+    #define traceRETURN_vTaskSetMLFQPolicy()
+#endif
+
+#ifndef traceENTER_vTaskSetWeight
+    #define traceENTER_vTaskSetWeight( xTask, uxWeight )
+#endif
+
+#ifndef traceRETURN_vTaskSetWeight
+    #define traceRETURN_vTaskSetWeight()
+#endif
+
+#ifndef traceENTER_uxTaskGetWeight
+    #define traceENTER_uxTaskGetWeight( xTask )
+#endif
+
+#ifndef traceRETURN_uxTaskGetWeight
+    #define traceRETURN_uxTaskGetWeight( uxWeight )
+#endif
+
 #ifndef traceENTER_vTaskDelete
     #define traceENTER_vTaskDelete( xTaskToDelete )
 #endif
@@ -2312,6 +2460,14 @@
     #define traceRETURN_pvTaskIncrementMutexHeldCount( pxTCB )
 #endif
 
+#ifndef traceENTER_ppvTaskGetHeapCache
+    #define traceENTER_ppvTaskGetHeapCache()
+#endif
+
+#ifndef traceRETURN_ppvTaskGetHeapCache
+    #define traceRETURN_ppvTaskGetHeapCache( ppvHeapCache )
+#endif
+
 #ifndef traceENTER_ulTaskGenericNotifyTake
     #define traceENTER_ulTaskGenericNotifyTake( uxIndexToWaitOn, xClearCountOnExit, xTicksToWait )
 #endif
@@ -2376,6 +2532,22 @@
     #define traceRETURN_ulTaskGetRunTimeCounter( ulRunTimeCounter )
 #endif
 
+#ifndef traceENTER_uxTaskGetDeadlineStats
+    #define traceENTER_uxTaskGetDeadlineStats( xTask, pxMaxLateness )
+#endif
+
+#ifndef traceRETURN_uxTaskGetDeadlineStats
+    #define traceRETURN_uxTaskGetDeadlineStats( uxDeadlineMisses )
+#endif
+
+#ifndef traceENTER_uxTaskGetDeadlineMissEvents
+    #define traceENTER_uxTaskGetDeadlineMissEvents( pxEventArray, uxArraySize, puxNextEvent )
+#endif
+
+#ifndef traceRETURN_uxTaskGetDeadlineMissEvents
+    #define traceRETURN_uxTaskGetDeadlineMissEvents( uxCopied )
+#endif
+
 #ifndef traceENTER_ulTaskGetRunTimePercent
     #define traceENTER_ulTaskGetRunTimePercent( xTask )
 #endif
@@ -2496,6 +2668,30 @@
     #define traceRETURN_xStreamBufferSendFromISR( xReturn )
 #endif
 
+#ifndef traceENTER_xStreamBufferReserve
+    #define traceENTER_xStreamBufferReserve( xStreamBuffer, xMaxBytes, pxSegments, xTicksToWait )
+#endif
+
+#ifndef traceRETURN_xStreamBufferReserve
+    #define traceRETURN_xStreamBufferReserve( xReturn )
+#endif
+
+#ifndef traceENTER_xStreamBufferCommit
+    #define traceENTER_xStreamBufferCommit( xStreamBuffer, xBytesWritten )
+#endif
+
+#ifndef traceRETURN_xStreamBufferCommit
+    #define traceRETURN_xStreamBufferCommit( xReturn )
+#endif
+
+#ifndef traceENTER_xStreamBufferCommitFromISR
+    #define traceENTER_xStreamBufferCommitFromISR( xStreamBuffer, xBytesWritten, pxHigherPriorityTaskWoken )
+#endif
+
+#ifndef traceRETURN_xStreamBufferCommitFromISR
+    #define traceRETURN_xStreamBufferCommitFromISR( xReturn )
+#endif
+
 #ifndef traceENTER_xStreamBufferReceive
     #define traceENTER_xStreamBufferReceive( xStreamBuffer, pvRxData, xBufferLengthBytes, xTicksToWait )
 #endif
@@ -2520,6 +2716,30 @@
     #define traceRETURN_xStreamBufferReceiveFromISR( xReceivedLength )
 #endif
 
+#ifndef traceENTER_xStreamBufferPeekContiguous
+    #define traceENTER_xStreamBufferPeekContiguous( xStreamBuffer, pxSegments, xTicksToWait )
+#endif
+
+#ifndef traceRETURN_xStreamBufferPeekContiguous
+    #define traceRETURN_xStreamBufferPeekContiguous( xReturn )
+#endif
+
+#ifndef traceENTER_xStreamBufferConsume
+    #define traceENTER_xStreamBufferConsume( xStreamBuffer, xBytesRead )
+#endif
+
+#ifndef traceRETURN_xStreamBufferConsume
+    #define traceRETURN_xStreamBufferConsume( xReturn )
+#endif
+
+#ifndef traceENTER_xStreamBufferConsumeFromISR
+    #define traceENTER_xStreamBufferConsumeFromISR( xStreamBuffer, xBytesRead, pxHigherPriorityTaskWoken )
+#endif
+
+#ifndef traceRETURN_xStreamBufferConsumeFromISR
+    #define traceRETURN_xStreamBufferConsumeFromISR( xReturn )
+#endif
+
 #ifndef traceENTER_xStreamBufferIsEmpty
     #define traceENTER_xStreamBufferIsEmpty( xStreamBuffer )
 #endif
@@ -2664,6 +2884,70 @@
     #define traceRETURN_xCoRoutineRemoveFromEventList( xReturn )
 #endif
 
+#ifndef traceENTER_xPoolCreate
+    #define traceENTER_xPoolCreate( uxNumberOfBlocks, xBlockSize )
+#endif
+
+#ifndef traceRETURN_xPoolCreate
+    #define traceRETURN_xPoolCreate( pxPool )
+#endif
+
+#ifndef traceENTER_xPoolCreateStatic
+    #define traceENTER_xPoolCreateStatic( uxNumberOfBlocks, xBlockSize, pucPoolStorage, pxPoolBuffer )
+#endif
+
+#ifndef traceRETURN_xPoolCreateStatic
+    #define traceRETURN_xPoolCreateStatic( pxPool )
+#endif
+
+#ifndef traceENTER_vPoolDelete
+    #define traceENTER_vPoolDelete( xPool )
+#endif
+
+#ifndef traceRETURN_vPoolDelete
+    #define traceRETURN_vPoolDelete()
+#endif
+
+#ifndef traceENTER_pvPoolAlloc
+    #define traceENTER_pvPoolAlloc( xPool, xTicksToWait )
+#endif
+
+#ifndef traceRETURN_pvPoolAlloc
+    #define traceRETURN_pvPoolAlloc( pvBlock )
+#endif
+
+#ifndef traceENTER_pvPoolAllocFromISR
+    #define traceENTER_pvPoolAllocFromISR( xPool )
+#endif
+
+#ifndef traceRETURN_pvPoolAllocFromISR
+    #define traceRETURN_pvPoolAllocFromISR( pvBlock )
+#endif
+
+#ifndef traceENTER_vPoolFree
+    #define traceENTER_vPoolFree( xPool, pvBlock )
+#endif
+
+#ifndef traceRETURN_vPoolFree
+    #define traceRETURN_vPoolFree()
+#endif
+
+#ifndef traceENTER_vPoolFreeFromISR
+    #define traceENTER_vPoolFreeFromISR( xPool, pvBlock, pxHigherPriorityTaskWoken )
+#endif
+
+#ifndef traceRETURN_vPoolFreeFromISR
+    #define traceRETURN_vPoolFreeFromISR()
+#endif
+
+#ifndef traceENTER_uxPoolGetFreeBlocks
+    #define traceENTER_uxPoolGetFreeBlocks( xPool )
+#endif
+
+#ifndef traceRETURN_uxPoolGetFreeBlocks
+    #define traceRETURN_uxPoolGetFreeBlocks( uxFreeBlocks )
+#endif
+
 #ifndef configGENERATE_RUN_TIME_STATS
     #define configGENERATE_RUN_TIME_STATS    0
 #endif
@@ -2726,6 +3010,36 @@
     #define configUSE_QUEUE_SETS    0
 #endif
 
+/* Set configUSE_SPSC_QUEUES to 1 to allow queues to be created with
+ * xQueueCreateSPSC().  Such a queue has a single sending task and a single
+ * receiving task, and sends and receives that do not have to block do not
+ * enter a critical section. */
+#ifndef configUSE_SPSC_QUEUES
+    #define configUSE_SPSC_QUEUES    0
+#endif
+
+#if ( ( configUSE_SPSC_QUEUES == 1 ) && ( configNUMBER_OF_CORES > 1 ) )
+    #error configUSE_SPSC_QUEUES can only be set to 1 when configNUMBER_OF_CORES is 1, as the receiving task relies on the scheduler being suspended to check the queue and block atomically.
+#endif
+
+/* Set configUSE_ZERO_COPY_QUEUES to 1 to allow queues to be created with
+ * xQueueCreateZeroCopy().  Such a queue owns a pool of fixed size buffers, and
+ * passes pointers to the buffers rather than copying their contents. */
+#ifndef configUSE_ZERO_COPY_QUEUES
+    #define configUSE_ZERO_COPY_QUEUES    0
+#endif
+
+/* Set configCHECK_ZERO_COPY_BUFFERS to 1 to have configASSERT() check that
+ * each buffer passed to a zero copy queue belongs to the queue's pool, is in a
+ * state in which the operation is valid, and is owned by the calling task. */
+#ifndef configCHECK_ZERO_COPY_BUFFERS
+    #define configCHECK_ZERO_COPY_BUFFERS    0
+#endif
+
+#if ( ( configUSE_ZERO_COPY_QUEUES == 1 ) && ( INCLUDE_xTaskGetCurrentTaskHandle != 1 ) && ( configUSE_MUTEXES != 1 ) )
+    #error configUSE_ZERO_COPY_QUEUES requires INCLUDE_xTaskGetCurrentTaskHandle or configUSE_MUTEXES to be set to 1, as each buffer records the task that owns it.
+#endif
+
 #ifndef portTASK_USES_FLOATING_POINT
     #define portTASK_USES_FLOATING_POINT()
 #endif
@@ -2742,6 +3056,191 @@
     #define configUSE_TIME_SLICING    1
 #endif
 
+#ifndef configUSE_EDF_SCHEDULER
+    #define configUSE_EDF_SCHEDULER    0
+#endif
+
+#ifndef configUSE_MLFQ_SCHEDULER
+    #define configUSE_MLFQ_SCHEDULER    0
+#endif
+
+#ifndef configUSE_WEIGHTED_ROUND_ROBIN
+    #define configUSE_WEIGHTED_ROUND_ROBIN    0
+#endif
+
+#if ( ( configUSE_EDF_SCHEDULER == 1 ) && ( configNUMBER_OF_CORES > 1 ) )
+    #error The EDF scheduler is only supported when configNUMBER_OF_CORES is 1.
+#endif
+
+/* The EDF and weighted round robin schedulers each own a band of priorities.
+ * By default a band holds every priority, so only one of them can be used
+ * unless the bands are set.  Tasks at priorities outside every band, and tasks
+ * in the MLFQ band that were not created by xTaskCreateMLFQ(), are scheduled by
+ * fixed priority. */
+#ifndef configEDF_LOWEST_PRIORITY
+    #define configEDF_LOWEST_PRIORITY    0
+#endif
+
+#ifndef configEDF_HIGHEST_PRIORITY
+    #define configEDF_HIGHEST_PRIORITY    ( configMAX_PRIORITIES - 1 )
+#endif
+
+#ifndef configWRR_LOWEST_PRIORITY
+    #define configWRR_LOWEST_PRIORITY    0
+#endif
+
+#ifndef configWRR_HIGHEST_PRIORITY
+    #define configWRR_HIGHEST_PRIORITY    ( configMAX_PRIORITIES - 1 )
+#endif
+
+#if ( configUSE_EDF_SCHEDULER == 1 )
+    #if ( ( configEDF_LOWEST_PRIORITY > configEDF_HIGHEST_PRIORITY ) || ( configEDF_HIGHEST_PRIORITY >= configMAX_PRIORITIES ) )
+        #error configEDF_LOWEST_PRIORITY and configEDF_HIGHEST_PRIORITY must select a band of priorities below configMAX_PRIORITIES.
+    #endif
+#endif
+
+#if ( configUSE_WEIGHTED_ROUND_ROBIN == 1 )
+    #if ( ( configWRR_LOWEST_PRIORITY > configWRR_HIGHEST_PRIORITY ) || ( configWRR_HIGHEST_PRIORITY >= configMAX_PRIORITIES ) )
+        #error configWRR_LOWEST_PRIORITY and configWRR_HIGHEST_PRIORITY must select a band of priorities below configMAX_PRIORITIES.
+    #endif
+
+    #if ( configUSE_EDF_SCHEDULER == 1 )
+        #if ( ( configEDF_LOWEST_PRIORITY <= configWRR_HIGHEST_PRIORITY ) && ( configWRR_LOWEST_PRIORITY <= configEDF_HIGHEST_PRIORITY ) )
+            #error The EDF and weighted round robin priority bands overlap.  Set configEDF_LOWEST_PRIORITY, configEDF_HIGHEST_PRIORITY, configWRR_LOWEST_PRIORITY and configWRR_HIGHEST_PRIORITY.
+        #endif
+    #endif
+
+    #if ( configNUMBER_OF_CORES > 1 )
+        #error The weighted round robin scheduler is only supported when configNUMBER_OF_CORES is 1.
+    #endif
+
+    #if ( ( configUSE_PREEMPTION == 0 ) || ( configUSE_TIME_SLICING == 0 ) )
+        #error configUSE_WEIGHTED_ROUND_ROBIN is 1, so configUSE_PREEMPTION and configUSE_TIME_SLICING must also be 1 as tasks are charged for their time at each tick.
+    #endif
+
+    #if ( configTICK_TYPE_WIDTH_IN_BITS == TICK_TYPE_WIDTH_16_BITS )
+        #error The weighted round robin scheduler measures virtual run time in TickType_t, so requires a TickType_t of at least 32 bits.
+    #endif
+#endif
+
+/* The number of ticks a task runs for each time it is selected by the weighted
+ * round robin scheduler. */
+#ifndef configSLICE_INTERVAL
+    #define configSLICE_INTERVAL    ( ( TickType_t ) 1 )
+#endif
+
+/* The largest weight that can be passed to vTaskSetWeight(). */
+#ifndef configWRR_MAX_WEIGHT
+    #define configWRR_MAX_WEIGHT    255U
+#endif
+
+/* The EDF scheduler orders each ready list by deadline, and the weighted round
+ * robin scheduler orders each ready list by virtual run time.  Both use the
+ * pairing heap that list.c maintains over the item values of a list. */
+#if ( ( configUSE_EDF_SCHEDULER == 1 ) || ( configUSE_WEIGHTED_ROUND_ROBIN == 1 ) )
+    #define listUSE_DEADLINE_HEAP    1
+#else
+    #define listUSE_DEADLINE_HEAP    0
+#endif
+
+#if ( ( configUSE_MLFQ_SCHEDULER == 1 ) && ( configNUMBER_OF_CORES > 1 ) )
+    #error The MLFQ scheduler is only supported when configNUMBER_OF_CORES is 1.
+#endif
+
+#ifndef configMLFQ_HIGHEST_PRIORITY
+    #define configMLFQ_HIGHEST_PRIORITY    ( configMAX_PRIORITIES - 1 )
+#endif
+
+#ifndef configMLFQ_LOWEST_PRIORITY
+    #define configMLFQ_LOWEST_PRIORITY    1
+#endif
+
+#if ( configUSE_MLFQ_SCHEDULER == 1 )
+    #if ( ( configMLFQ_LOWEST_PRIORITY < 1 ) || ( configMLFQ_LOWEST_PRIORITY > configMLFQ_HIGHEST_PRIORITY ) || ( configMLFQ_HIGHEST_PRIORITY >= configMAX_PRIORITIES ) )
+        #error configMLFQ_LOWEST_PRIORITY and configMLFQ_HIGHEST_PRIORITY must select a band of priorities above the idle priority and below configMAX_PRIORITIES.
+    #endif
+
+    #if ( configUSE_EDF_SCHEDULER == 1 )
+        #if ( ( configEDF_LOWEST_PRIORITY <= configMLFQ_HIGHEST_PRIORITY ) && ( configMLFQ_LOWEST_PRIORITY <= configEDF_HIGHEST_PRIORITY ) )
+            #error The EDF and MLFQ priority bands overlap.  Set configEDF_LOWEST_PRIORITY, configEDF_HIGHEST_PRIORITY, configMLFQ_LOWEST_PRIORITY and configMLFQ_HIGHEST_PRIORITY.
+        #endif
+    #endif
+
+    #if ( configUSE_WEIGHTED_ROUND_ROBIN == 1 )
+        #if ( ( configWRR_LOWEST_PRIORITY <= configMLFQ_HIGHEST_PRIORITY ) && ( configMLFQ_LOWEST_PRIORITY <= configWRR_HIGHEST_PRIORITY ) )
+            #error The weighted round robin and MLFQ priority bands overlap.  Set configWRR_LOWEST_PRIORITY, configWRR_HIGHEST_PRIORITY, configMLFQ_LOWEST_PRIORITY and configMLFQ_HIGHEST_PRIORITY.
+        #endif
+    #endif
+#endif
+
+#ifndef configMLFQ_USE_RUN_TIME_ACCOUNTING
+    #define configMLFQ_USE_RUN_TIME_ACCOUNTING    0
+#endif
+
+#if ( ( configUSE_MLFQ_SCHEDULER == 1 ) && ( configMLFQ_USE_RUN_TIME_ACCOUNTING == 1 ) )
+    #if ( configGENERATE_RUN_TIME_STATS != 1 )
+        #error configMLFQ_USE_RUN_TIME_ACCOUNTING is 1, so configGENERATE_RUN_TIME_STATS must also be 1 as MLFQ time slices are then measured with the run time counter.
+    #endif
+
+    #ifndef configMLFQ_RUN_TIME_COUNTS_PER_TICK
+        #error configMLFQ_USE_RUN_TIME_ACCOUNTING is 1, so configMLFQ_RUN_TIME_COUNTS_PER_TICK must be defined as the number of run time counter increments in one tick period.
+    #endif
+#endif
+
+#ifndef configDEADLINE_MISS_EVENT_BUFFER_LENGTH
+    #define configDEADLINE_MISS_EVENT_BUFFER_LENGTH    16
+#endif
+
+/* Set configUSE_TIMER_WHEEL_DELAY to 1 to hold tasks that are blocked with a
+ * timeout in a hierarchical timing wheel instead of the two delayed lists that
+ * are kept in wake time order, so a task blocks and unblocks in constant time
+ * however many other tasks are delayed.  Each level of the wheel has 32 slots,
+ * and each slot of a level spans 32 times as many ticks as a slot of the level
+ * below, so configTIMER_WHEEL_DELAY_LEVELS levels cover 32 to the power of
+ * configTIMER_WHEEL_DELAY_LEVELS ticks.  Longer delays are still supported, but
+ * the task is moved through the top level more than once. */
+#ifndef configUSE_TIMER_WHEEL_DELAY
+    #define configUSE_TIMER_WHEEL_DELAY    0
+#endif
+
+#ifndef configTIMER_WHEEL_DELAY_LEVELS
+    #define configTIMER_WHEEL_DELAY_LEVELS    4
+#endif
+
+#if ( configUSE_TIMER_WHEEL_DELAY == 1 )
+    #if ( ( configTIMER_WHEEL_DELAY_LEVELS < 1 ) || ( configTIMER_WHEEL_DELAY_LEVELS > 6 ) )
+        #error configTIMER_WHEEL_DELAY_LEVELS must be between 1 and 6.
+    #endif
+
+    #if ( ( configTICK_TYPE_WIDTH_IN_BITS == TICK_TYPE_WIDTH_16_BITS ) && ( configTIMER_WHEEL_DELAY_LEVELS > 4 ) )
+        #error configTIMER_WHEEL_DELAY_LEVELS must not be more than 4 when TickType_t is 16 bits, as 4 levels already cover every delay.
+    #endif
+#endif
+
+/* Set configUSE_TIMER_SERVICE_WHEEL to 1 to hold active software timers in a
+ * hierarchical timing wheel instead of the two active timer lists that are kept
+ * in expiry time order, so the timer service task starts, stops and expires a
+ * timer in constant time however many timers are active.  The wheel has the
+ * same shape as the one selected by configUSE_TIMER_WHEEL_DELAY, with
+ * configTIMER_SERVICE_WHEEL_LEVELS levels of 32 slots. */
+#ifndef configUSE_TIMER_SERVICE_WHEEL
+    #define configUSE_TIMER_SERVICE_WHEEL    0
+#endif
+
+#ifndef configTIMER_SERVICE_WHEEL_LEVELS
+    #define configTIMER_SERVICE_WHEEL_LEVELS    4
+#endif
+
+#if ( configUSE_TIMER_SERVICE_WHEEL == 1 )
+    #if ( ( configTIMER_SERVICE_WHEEL_LEVELS < 1 ) || ( configTIMER_SERVICE_WHEEL_LEVELS > 6 ) )
+        #error configTIMER_SERVICE_WHEEL_LEVELS must be between 1 and 6.
+    #endif
+
+    #if ( ( configTICK_TYPE_WIDTH_IN_BITS == TICK_TYPE_WIDTH_16_BITS ) && ( configTIMER_SERVICE_WHEEL_LEVELS > 3 ) )
+        #error configTIMER_SERVICE_WHEEL_LEVELS must not be more than 3 when TickType_t is 16 bits, as the span of the wheel must fit in a TickType_t.
+    #endif
+#endif
+
 #ifndef configINCLUDE_APPLICATION_DEFINED_PRIVILEGED_FUNCTIONS
     #define configINCLUDE_APPLICATION_DEFINED_PRIVILEGED_FUNCTIONS    0
 #endif
@@ -2859,6 +3358,132 @@
     #define configMESSAGE_BUFFER_LENGTH_TYPE    size_t
 #endif
 
+/* Set configUSE_MPSC_MESSAGE_BUFFERS to 1 to allow message buffers to be
+ * created with xMessageBufferCreateMPSC().  Any number of tasks and interrupts
+ * can write to such a message buffer at the same time without a lock, while a
+ * single task or interrupt reads from it. */
+#ifndef configUSE_MPSC_MESSAGE_BUFFERS
+    #define configUSE_MPSC_MESSAGE_BUFFERS    0
+#endif
+
+#if ( ( configUSE_MPSC_MESSAGE_BUFFERS == 1 ) && ( configUSE_STREAM_BUFFERS != 1 ) )
+    #error configUSE_STREAM_BUFFERS must be set to 1 to use MPSC message buffers
+#endif
+
+/* Set configUSE_INDEXED_EVENT_GROUP_WAITERS to 1 to give each event group a
+ * list of waiting tasks for every event bit, so setting bits only checks the
+ * tasks that are waiting for one of those bits, rather than every task that is
+ * waiting for the event group.  Tasks waiting for any one of several bits are
+ * still checked each time bits are set.  Each event group then holds one more
+ * list per event bit, so this costs RAM. */
+#ifndef configUSE_INDEXED_EVENT_GROUP_WAITERS
+    #define configUSE_INDEXED_EVENT_GROUP_WAITERS    0
+#endif
+
+/* Set configUSE_HEAP_CACHE to 1 to give each task a cache of small blocks, so
+ * heap_4.c can allocate and free small blocks without suspending the
+ * scheduler.  Blocks move between a task's cache and the heap a batch at a
+ * time, and the cache is returned to the heap when the task is deleted.
+ * Blocks held in caches are counted as allocated by xPortGetFreeHeapSize() and
+ * vPortGetHeapStats().  Only heap_4.c provides heap caches. */
+#ifndef configUSE_HEAP_CACHE
+    #define configUSE_HEAP_CACHE    0
+#endif
+
+/* The largest number of blocks of each size a task's heap cache holds. */
+#ifndef configHEAP_CACHE_DEPTH
+    #define configHEAP_CACHE_DEPTH    8
+#endif
+
+#if ( ( configUSE_HEAP_CACHE == 1 ) && ( ( configHEAP_CACHE_DEPTH < 2 ) || ( configHEAP_CACHE_DEPTH > 255 ) ) )
+    #error configHEAP_CACHE_DEPTH must be between 2 and 255
+#endif
+
+#if ( ( configUSE_HEAP_CACHE == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION != 1 ) )
+    #error configSUPPORT_DYNAMIC_ALLOCATION must be set to 1 to use heap caches
+#endif
+
+/* Set configUSE_MEMORY_POOLS to 1 to include the memory pool functionality in
+ * the build, in which case memory_pool.c must also be built.  Memory pools
+ * hold fixed size blocks that tasks and interrupts can allocate and free in
+ * constant time. */
+#ifndef configUSE_MEMORY_POOLS
+    #define configUSE_MEMORY_POOLS    0
+#endif
+
+/* Set configUSE_HEAP_REGIONS to 1 to keep a separate free list and separate
+ * statistics for each region passed to vPortDefineHeapRegions(), and to make
+ * pvPortMallocRegion() available.  Only heap_5.c provides heap regions.  Bit n
+ * of a region mask selects the nth region in the array passed to
+ * vPortDefineHeapRegions(). */
+#ifndef configUSE_HEAP_REGIONS
+    #define configUSE_HEAP_REGIONS    0
+#endif
+
+/* The maximum number of regions that can be passed to vPortDefineHeapRegions()
+ * when configUSE_HEAP_REGIONS is 1. */
+#ifndef configHEAP_MAX_REGIONS
+    #define configHEAP_MAX_REGIONS    4
+#endif
+
+/* The regions task control blocks, task stacks and queues (including
+ * semaphores and mutexes) are allocated from when configUSE_HEAP_REGIONS is 1.
+ * For example, set configHEAP_REGIONS_FOR_STACKS to 0x01 to place stacks in the
+ * first region only.  By default any region can be used. */
+#ifndef configHEAP_REGIONS_FOR_TCBS
+    #define configHEAP_REGIONS_FOR_TCBS    ( ~( ( UBaseType_t ) 0U ) )
+#endif
+
+#ifndef configHEAP_REGIONS_FOR_STACKS
+    #define configHEAP_REGIONS_FOR_STACKS    ( ~( ( UBaseType_t ) 0U ) )
+#endif
+
+#ifndef configHEAP_REGIONS_FOR_QUEUES
+    #define configHEAP_REGIONS_FOR_QUEUES    ( ~( ( UBaseType_t ) 0U ) )
+#endif
+
+#if ( ( configUSE_HEAP_REGIONS == 1 ) && ( ( configHEAP_MAX_REGIONS < 1 ) || ( configHEAP_MAX_REGIONS > 16 ) ) )
+    #error configHEAP_MAX_REGIONS must be between 1 and 16
+#endif
+
+#if ( ( configUSE_HEAP_REGIONS == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION != 1 ) )
+    #error configSUPPORT_DYNAMIC_ALLOCATION must be set to 1 to use heap regions
+#endif
+
+/* Set configUSE_HEAP_PROFILER to 1 to record the call site, task, size and
+ * time of every live heap block, in which case heap_profiler.c must also be
+ * built.  Only heap_4.c and heap_5.c record blocks.  See heap_profiler.h. */
+#ifndef configUSE_HEAP_PROFILER
+    #define configUSE_HEAP_PROFILER    0
+#endif
+
+/* The number of records in the heap profiler's table, which must be a power of
+ * two.  The table holds up to three quarters of this number of live blocks.
+ * The profiler keeps a second table of the same number of groups to build
+ * profiles in. */
+#ifndef configHEAP_PROFILER_TABLE_SIZE
+    #define configHEAP_PROFILER_TABLE_SIZE    256
+#endif
+
+#if ( ( configUSE_HEAP_PROFILER == 1 ) && ( ( configHEAP_PROFILER_TABLE_SIZE < 4 ) || ( ( configHEAP_PROFILER_TABLE_SIZE & ( configHEAP_PROFILER_TABLE_SIZE - 1 ) ) != 0 ) ) )
+    #error configHEAP_PROFILER_TABLE_SIZE must be a power of two and at least 4
+#endif
+
+#if ( ( configUSE_HEAP_PROFILER == 1 ) && ( INCLUDE_xTaskGetCurrentTaskHandle != 1 ) )
+    #error INCLUDE_xTaskGetCurrentTaskHandle must be set to 1 to use the heap profiler
+#endif
+
+/* Used by the heap profiler to find the code that called pvPortMalloc().  Ports
+ * for compilers other than GCC and compatible compilers can define it in
+ * portmacro.h. */
+#ifndef portGET_RETURN_ADDRESS
+    #if defined( __GNUC__ )
+        #define portGET_RETURN_ADDRESS()    __builtin_return_address( 0 )
+    #else
+        #define portGET_RETURN_ADDRESS()    NULL
+    #endif
+#endif
+
 /* Sanity check the configuration. */
 #if ( ( configSUPPORT_STATIC_ALLOCATION == 0 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 0 ) )
     #error configSUPPORT_STATIC_ALLOCATION and configSUPPORT_DYNAMIC_ALLOCATION cannot both be 0, but can both be 1.
@@ -3095,6 +3720,9 @@ struct xSTATIC_LIST_ITEM
     #endif
     TickType_t xDummy2;
     void * pvDummy3[ 4 ];
+    #if ( listUSE_DEADLINE_HEAP == 1 )
+        void * pvDummy5[ 3 ];
+    #endif
     #if ( configUSE_LIST_DATA_INTEGRITY_CHECK_BYTES == 1 )
         TickType_t xDummy4;
     #endif
@@ -3125,6 +3753,9 @@ typedef struct xSTATIC_LIST
     UBaseType_t uxDummy2;
     void * pvDummy3;
     StaticMiniListItem_t xDummy4;
+    #if ( listUSE_DEADLINE_HEAP == 1 )
+        void * pvDummy6;
+    #endif
     #if ( configUSE_LIST_DATA_INTEGRITY_CHECK_BYTES == 1 )
         TickType_t xDummy5;
     #endif
@@ -3159,13 +3790,26 @@ typedef struct xSTATIC_TCB
     UBaseType_t uxDummy7;
     UBaseType_t uxDummy8;
     UBaseType_t uxDummy41;
-    
+    #if ( configUSE_EDF_SCHEDULER == 1 )
+        UBaseType_t uxDummy42;
+        TickType_t xDummy43;
+    #endif
+
     #if ( configUSE_WEIGHTED_ROUND_ROBIN == 1 )
         UBaseType_t uxDummy30;
+        TickType_t xDummy47[ 2 ];
     #endif
     #if (configUSE_WEIGHTED_ROUND_ROBIN == 1 || configUSE_MLFQ_SCHEDULER == 1)
         UBaseType_t uxDummy31;
     #endif
+    #if ( configUSE_MLFQ_SCHEDULER == 1 )
+        UBaseType_t uxDummy44;
+        BaseType_t xDummy45;
+        StaticListItem_t xDummy49;
+        #if ( configMLFQ_USE_RUN_TIME_ACCOUNTING == 1 )
+            configRUN_TIME_COUNTER_TYPE ulDummy46;
+        #endif
+    #endif
     #if ( configNUMBER_OF_CORES > 1 )
         BaseType_t xDummy23;
         UBaseType_t uxDummy24;
@@ -3212,6 +3856,9 @@ typedef struct xSTATIC_TCB
     #if ( configUSE_POSIX_ERRNO == 1 )
         int iDummy22;
     #endif
+    #if ( configUSE_HEAP_CACHE == 1 )
+        void * pvDummy48;
+    #endif
 } StaticTask_t;
 
 /*
@@ -3254,6 +3901,16 @@ typedef struct xSTATIC_QUEUE
         UBaseType_t uxDummy8;
         uint8_t ucDummy9;
     #endif
+
+    #if ( configUSE_SPSC_QUEUES == 1 )
+        UBaseType_t uxDummy10[ 2 ];
+        uint8_t ucDummy11;
+    #endif
+
+    #if ( configUSE_ZERO_COPY_QUEUES == 1 )
+        void * pvDummy12[ 2 ];
+        size_t xDummy13;
+    #endif
 } StaticQueue_t;
 typedef StaticQueue_t StaticSemaphore_t;
 
@@ -3283,6 +3940,16 @@ typedef struct xSTATIC_EVENT_GROUP
     #if ( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
         uint8_t ucDummy4;
     #endif
+
+    #if ( configUSE_INDEXED_EVENT_GROUP_WAITERS == 1 )
+        #if ( configTICK_TYPE_WIDTH_IN_BITS == TICK_TYPE_WIDTH_16_BITS )
+            StaticList_t xDummy5[ 8 ];
+        #elif ( configTICK_TYPE_WIDTH_IN_BITS == TICK_TYPE_WIDTH_32_BITS )
+            StaticList_t xDummy5[ 24 ];
+        #else
+            StaticList_t xDummy5[ 56 ];
+        #endif
+    #endif
 } StaticEventGroup_t;
 
 /*
@@ -3343,6 +4010,32 @@ typedef struct xSTATIC_STREAM_BUFFER
 /* Message buffers are built on stream buffers. */
 typedef StaticStreamBuffer_t StaticMessageBuffer_t;
 
+/*
+ * In line with software engineering best practice, especially when supplying a
+ * library that is likely to change in future versions, FreeRTOS implements a
+ * strict data hiding policy.  This means the memory pool structure used
+ * internally by FreeRTOS is not accessible to application code.  However, if
+ * the application writer wants to statically allocate the memory required to
+ * create a memory pool then the size of the memory pool object needs to be
+ * known.  The StaticPool_t structure below is provided for this purpose.  Its
+ * size and alignment requirements are guaranteed to match those of the genuine
+ * structure, no matter which architecture is being used, and no matter how the
+ * values in FreeRTOSConfig.h are set.  Its contents are somewhat obfuscated in
+ * the hope users will recognise that it would be unwise to make direct use of
+ * the structure members.
+ */
+typedef struct xSTATIC_POOL
+{
+    void * pvDummy1[ 2 ];
+    size_t xDummy2;
+    UBaseType_t uxDummy3[ 2 ];
+    StaticList_t xDummy4;
+    int8_t cDummy5;
+    #if ( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+        uint8_t ucDummy6;
+    #endif
+} StaticPool_t;
+
 /* *INDENT-OFF* */
 #ifdef __cplusplus
     }
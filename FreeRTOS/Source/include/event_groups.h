@@ -38,22 +38,27 @@
 
 /* The following bit fields convey control information in a task's event list
  * item value.  It is important they don't clash with the
- * taskEVENT_LIST_ITEM_VALUE_IN_USE definition. */
+ * taskEVENT_LIST_ITEM_VALUE_IN_USE definition.  eventNUMBER_OF_EVENT_BITS is
+ * the number of bits below them, which are the bits available to the
+ * application. */
 #if ( configTICK_TYPE_WIDTH_IN_BITS == TICK_TYPE_WIDTH_16_BITS )
     #define eventCLEAR_EVENTS_ON_EXIT_BIT    ( ( uint16_t ) 0x0100U )
     #define eventUNBLOCKED_DUE_TO_BIT_SET    ( ( uint16_t ) 0x0200U )
     #define eventWAIT_FOR_ALL_BITS           ( ( uint16_t ) 0x0400U )
     #define eventEVENT_BITS_CONTROL_BYTES    ( ( uint16_t ) 0xff00U )
+    #define eventNUMBER_OF_EVENT_BITS        ( 8U )
 #elif ( configTICK_TYPE_WIDTH_IN_BITS == TICK_TYPE_WIDTH_32_BITS )
     #define eventCLEAR_EVENTS_ON_EXIT_BIT    ( ( uint32_t ) 0x01000000U )
     #define eventUNBLOCKED_DUE_TO_BIT_SET    ( ( uint32_t ) 0x02000000U )
     #define eventWAIT_FOR_ALL_BITS           ( ( uint32_t ) 0x04000000U )
     #define eventEVENT_BITS_CONTROL_BYTES    ( ( uint32_t ) 0xff000000U )
+    #define eventNUMBER_OF_EVENT_BITS        ( 24U )
 #elif ( configTICK_TYPE_WIDTH_IN_BITS == TICK_TYPE_WIDTH_64_BITS )
     #define eventCLEAR_EVENTS_ON_EXIT_BIT    ( ( uint64_t ) 0x0100000000000000U )
     #define eventUNBLOCKED_DUE_TO_BIT_SET    ( ( uint64_t ) 0x0200000000000000U )
     #define eventWAIT_FOR_ALL_BITS           ( ( uint64_t ) 0x0400000000000000U )
     #define eventEVENT_BITS_CONTROL_BYTES    ( ( uint64_t ) 0xff00000000000000U )
+    #define eventNUMBER_OF_EVENT_BITS        ( 56U )
 #endif /* if ( configTICK_TYPE_WIDTH_IN_BITS == TICK_TYPE_WIDTH_16_BITS ) */
 
 /* *INDENT-OFF* */
@@ -0,0 +1,165 @@
+/*
+ * FreeRTOS Kernel <DEVELOPMENT BRANCH>
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+#ifndef HEAP_PROFILER_H
+#define HEAP_PROFILER_H
+
+#ifndef INC_TASK_H
+    #error "include FreeRTOS.h" and "include task.h" must appear in source files before "include heap_profiler.h"
+#endif
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/**
+ * The heap profiler records the call site, owning task, size and time of every
+ * block allocated by pvPortMalloc() that has not yet been freed, so the live
+ * heap can be attributed to the code and the tasks that hold it, for example
+ * from vApplicationMallocFailedHook().  Records are kept in a fixed size open
+ * addressed hash table indexed by block address, so recording an allocation or
+ * a free takes a short critical section and constant time on average.
+ *
+ * The configUSE_HEAP_PROFILER configuration constant must be set to 1 in
+ * FreeRTOSConfig.h, heap_4.c or heap_5.c used, and heap_profiler.c built, for
+ * the heap profiler to be available.  The table holds up to three quarters of
+ * configHEAP_PROFILER_TABLE_SIZE records, and allocations made while it is
+ * full are only counted by xPortGetHeapProfileUntrackedBytes().
+ */
+
+/**
+ * heap_profiler.h
+ *
+ * How uxPortGetHeapProfile() groups the live blocks.
+ */
+typedef enum
+{
+    eHeapProfileByCallSite = 0, /* One entry per call site. */
+    eHeapProfileByTask          /* One entry per task. */
+} eHeapProfileGroup;
+
+/**
+ * heap_profiler.h
+ *
+ * Used to pass information about a group of live blocks out of
+ * uxPortGetHeapProfile().
+ */
+typedef struct xHEAP_PROFILE
+{
+    void * pvCallSite;           /* The address pvPortMalloc() returned to, or NULL when grouping by task. */
+    TaskHandle_t xTask;          /* The task that allocated the blocks, or NULL when grouping by call site.  Also NULL for blocks allocated before the scheduler started. */
+    size_t xLiveBytes;           /* The number of heap bytes, including the heap's own block headers, the group holds. */
+    size_t xLiveBlocks;          /* The number of blocks the group holds. */
+    TickType_t xOldestTimeStamp; /* The tick count when the oldest block the group holds was allocated. */
+} HeapProfile_t;
+
+/**
+ * heap_profiler.h
+ * @code{c}
+ * UBaseType_t uxPortGetHeapProfile( HeapProfile_t * const pxProfileArray,
+ *                                   const UBaseType_t uxArraySize,
+ *                                   eHeapProfileGroup eGroup );
+ * @endcode
+ *
+ * Groups the live blocks by call site or by task, and fills pxProfileArray
+ * with one entry per group, largest number of live bytes first.  The scheduler
+ * is suspended while the table is read, which takes time proportional to
+ * configHEAP_PROFILER_TABLE_SIZE plus the number of groups times uxArraySize.
+ * Interrupts are only masked while a few records at a time are copied.
+ *
+ * @param pxProfileArray The array to fill.
+ *
+ * @param uxArraySize The number of entries in pxProfileArray.  If there are
+ * more groups than entries pxProfileArray holds the uxArraySize largest.
+ *
+ * @param eGroup eHeapProfileByCallSite or eHeapProfileByTask.
+ *
+ * @return The number of entries filled.
+ *
+ * Example usage:
+ * @code{c}
+ * void vApplicationMallocFailedHook( void )
+ * {
+ * HeapProfile_t xProfile[ 8 ];
+ * UBaseType_t uxEntries, x;
+ *
+ *  uxEntries = uxPortGetHeapProfile( xProfile, 8, eHeapProfileByCallSite );
+ *
+ *  for( x = 0; x < uxEntries; x++ )
+ *  {
+ *      printf( "%p holds %u bytes\n", xProfile[ x ].pvCallSite, ( unsigned ) xProfile[ x ].xLiveBytes );
+ *  }
+ * }
+ * @endcode
+ * \defgroup uxPortGetHeapProfile uxPortGetHeapProfile
+ * \ingroup HeapProfiler
+ */
+UBaseType_t uxPortGetHeapProfile( HeapProfile_t * const pxProfileArray,
+                                  const UBaseType_t uxArraySize,
+                                  eHeapProfileGroup eGroup ) PRIVILEGED_FUNCTION;
+
+/**
+ * heap_profiler.h
+ * @code{c}
+ * size_t xPortGetHeapProfileUntrackedBytes( void );
+ * @endcode
+ *
+ * @return The number of live heap bytes held by blocks that were allocated
+ * while the table was full, so are not included in uxPortGetHeapProfile().
+ *
+ * \defgroup xPortGetHeapProfileUntrackedBytes xPortGetHeapProfileUntrackedBytes
+ * \ingroup HeapProfiler
+ */
+size_t xPortGetHeapProfileUntrackedBytes( void ) PRIVILEGED_FUNCTION;
+
+/*
+ * Record a block allocated by, or being freed to, the heap.  xBlockSize is
+ * the size of the block in the heap, including its header.  Called by heap_4.c
+ * and heap_5.c when configUSE_HEAP_PROFILER is 1.  For internal use only.
+ */
+void vPortHeapProfilerRecordAlloc( void * pvBlock,
+                                   size_t xBlockSize,
+                                   void * pvCallSite ) PRIVILEGED_FUNCTION;
+void vPortHeapProfilerRecordFree( void * pvBlock,
+                                  size_t xBlockSize ) PRIVILEGED_FUNCTION;
+
+/*
+ * Forget every record.  Called by vPortHeapResetState().  For internal use
+ * only.
+ */
+void vPortHeapProfilerResetState( void ) PRIVILEGED_FUNCTION;
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* HEAP_PROFILER_H */
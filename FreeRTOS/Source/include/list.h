@@ -149,6 +149,11 @@ struct xLIST_ITEM
     struct xLIST_ITEM * configLIST_VOLATILE pxPrevious; /**< Pointer to the previous ListItem_t in the list. */
     void * pvOwner;                                     /**< Pointer to the object (normally a TCB) that contains the list item.  There is therefore a two way link between the object containing the list item and the list item itself. */
     struct xLIST * configLIST_VOLATILE pxContainer;     /**< Pointer to the list in which this list item is placed (if any). */
+    #if ( listUSE_DEADLINE_HEAP == 1 )
+        struct xLIST_ITEM * configLIST_VOLATILE pxHeapChild;    /**< Leftmost child of the item when it is held in a deadline heap. */
+        struct xLIST_ITEM * configLIST_VOLATILE pxHeapSibling;  /**< Next sibling of the item when it is held in a deadline heap. */
+        struct xLIST_ITEM * configLIST_VOLATILE pxHeapPrevious; /**< Parent of a leftmost child, otherwise the previous sibling.  NULL for the heap root. */
+    #endif
     listSECOND_LIST_ITEM_INTEGRITY_CHECK_VALUE          /**< Set to a known value if configUSE_LIST_DATA_INTEGRITY_CHECK_BYTES is set to 1. */
 };
 typedef struct xLIST_ITEM ListItem_t;
@@ -175,11 +180,10 @@ typedef struct xLIST
     configLIST_VOLATILE UBaseType_t uxNumberOfItems;
     ListItem_t * configLIST_VOLATILE pxIndex; /**< Used to walk through the list.  Points to the last item returned by a call to listGET_OWNER_OF_NEXT_ENTRY (). */
     MiniListItem_t xListEnd;                  /**< List item that contains the maximum possible item value meaning it is always at the end of the list and is therefore used as a marker. */
-    listSECOND_LIST_INTEGRITY_CHECK_VALUE     /**< Set to a known value if configUSE_LIST_DATA_INTEGRITY_CHECK_BYTES is set to 1. */
-    #if ( configUSE_MLFQ_SCHEDULER == 1 )
-        UBaseType_t uxPriority;
-        UBaseType_t uxTimeSlice;
+    #if ( listUSE_DEADLINE_HEAP == 1 )
+        ListItem_t * configLIST_VOLATILE pxHeapRoot; /**< Item with the earliest deadline if the list is used as a deadline heap, otherwise NULL. */
     #endif
+    listSECOND_LIST_INTEGRITY_CHECK_VALUE     /**< Set to a known value if configUSE_LIST_DATA_INTEGRITY_CHECK_BYTES is set to 1. */
 } List_t;
 
 /*
@@ -287,26 +291,18 @@ typedef struct xLIST
  * \ingroup LinkedList
  */
 #if ( configNUMBER_OF_CORES == 1 )
-    #if (configUSE_EDF_SCHEDULER == 0)
-        #define listGET_OWNER_OF_NEXT_ENTRY( pxTCB, pxList )                                       \
-            do {                                                                                       \
-                List_t * const pxConstList = ( pxList );                                               \
-                /* Increment the index to the next item and return the item, ensuring */               \
-                /* we don't return the marker used at the end of the list.  */                         \
-                ( pxConstList )->pxIndex = ( pxConstList )->pxIndex->pxNext;                           \
-                if( ( void * ) ( pxConstList )->pxIndex == ( void * ) &( ( pxConstList )->xListEnd ) ) \
-                {                                                                                      \
-                    ( pxConstList )->pxIndex = ( pxConstList )->xListEnd.pxNext;                       \
-                }                                                                                      \
-                ( pxTCB ) = ( pxConstList )->pxIndex->pvOwner;                                         \
-            } while( 0 )
-    #else
-        #define listGET_OWNER_OF_NEXT_ENTRY( pxTCB, pxList )                                       \
-            do {                                                                                   \
-                ( pxTCB ) = listGET_OWNER_OF_HEAD_ENTRY( pxList );		                           \
-            }                                                                                      \
-            while( 0 )
-    #endif
+    #define listGET_OWNER_OF_NEXT_ENTRY( pxTCB, pxList )                                       \
+    do {                                                                                       \
+        List_t * const pxConstList = ( pxList );                                               \
+        /* Increment the index to the next item and return the item, ensuring */               \
+        /* we don't return the marker used at the end of the list.  */                         \
+        ( pxConstList )->pxIndex = ( pxConstList )->pxIndex->pxNext;                           \
+        if( ( void * ) ( pxConstList )->pxIndex == ( void * ) &( ( pxConstList )->xListEnd ) ) \
+        {                                                                                      \
+            ( pxConstList )->pxIndex = ( pxConstList )->xListEnd.pxNext;                       \
+        }                                                                                      \
+        ( pxTCB ) = ( pxConstList )->pxIndex->pvOwner;                                         \
+    } while( 0 )
 #else /* #if ( configNUMBER_OF_CORES == 1 ) */
 
 /* This function is not required in SMP. FreeRTOS SMP scheduler doesn't use
@@ -337,6 +333,7 @@ typedef struct xLIST
          * item. */                                                                                 \
         List_t * const pxList = ( pxItemToRemove )->pxContainer;                                    \
                                                                                                     \
+        listREMOVE_DEADLINE_HEAP_ITEM( pxList, ( pxItemToRemove ) );                                \
         ( pxItemToRemove )->pxNext->pxPrevious = ( pxItemToRemove )->pxPrevious;                    \
         ( pxItemToRemove )->pxPrevious->pxNext = ( pxItemToRemove )->pxNext;                        \
         /* Make sure the index is left pointing to a valid item. */                                 \
@@ -397,18 +394,49 @@ typedef struct xLIST
     } while( 0 )
 
 
-#define listEDF_INSERT_END( pxList, pxNewListItem )           \
-    do {                 \
-        if((( pxNewListItem )->xItemValue = task_ADD_DEADLINE( ( pxNewListItem )->pvOwner)) > xTickCount) \
-        {                                                                                               \
-            vListInsert( pxList, pxNewListItem );                                                       \
-        }                                                                                               \
-        else                                                                                            \
-        {                                                                                               \
-           vListInsertOverFlow( pxList, pxNewListItem );                                                \
-        }                                                                                               \
+#if ( listUSE_DEADLINE_HEAP == 1 )
+
+/*
+ * Deadline comparison used to order a deadline heap.  Item values are
+ * absolute tick counts, so they are compared by their difference rather than
+ * by magnitude.  This keeps the ordering correct when the tick count wraps,
+ * provided no two deadlines held in the same heap are more than half the
+ * TickType_t range apart.
+ *
+ * @return pdTRUE if xA is strictly earlier than xB, otherwise pdFALSE.
+ *
+ * \page listDEADLINE_PRECEDES listDEADLINE_PRECEDES
+ * \ingroup LinkedList
+ */
+    #define listDEADLINE_PRECEDES( xA, xB )    ( ( ( TickType_t ) ( ( xA ) - ( xB ) ) > ( portMAX_DELAY >> 1 ) ) ? pdTRUE : pdFALSE )
+
+/*
+ * Access macro to obtain the owner of the item with the earliest deadline in a
+ * list that is used as a deadline heap.  The list must not be empty.
+ *
+ * \page listGET_OWNER_OF_DEADLINE_HEAD listGET_OWNER_OF_DEADLINE_HEAD
+ * \ingroup LinkedList
+ */
+    #define listGET_OWNER_OF_DEADLINE_HEAD( pxList )    ( ( pxList )->pxHeapRoot->pvOwner )
+
+/*
+ * Remove an item from the deadline heap of the list it is contained within,
+ * if that list is used as a deadline heap.  Lists that are not used as deadline
+ * heaps always have a NULL heap root, so only a single test is added to the
+ * removal path of ordinary lists.
+ */
+    #define listREMOVE_DEADLINE_HEAP_ITEM( pxList, pxItem ) \
+    do {                                                    \
+        if( ( pxList )->pxHeapRoot != NULL )                \
+        {                                                   \
+            vListRemoveDeadline( ( pxList ), ( pxItem ) );  \
+        }                                                   \
     } while( 0 )
 
+#else /* if ( listUSE_DEADLINE_HEAP == 1 ) */
+    #define listREMOVE_DEADLINE_HEAP_ITEM( pxList, pxItem )
+#endif /* if ( listUSE_DEADLINE_HEAP == 1 ) */
+
 /*
  * Access function to obtain the owner of the first entry in a list.  Lists
  * are normally sorted in ascending item value order.
@@ -528,7 +556,46 @@ void vListInsertEnd( List_t * const pxList,
 UBaseType_t uxListRemove( ListItem_t * const pxItemToRemove ) PRIVILEGED_FUNCTION;
 
 
-void vListInsertOverFlow( List_t * const pxList, ListItem_t * const pxNewListItem ) PRIVILEGED_FUNCTION;
+#if ( listUSE_DEADLINE_HEAP == 1 )
+
+/*
+ * Insert a list item into a list that is used as a deadline heap.  The item
+ * value must hold the absolute deadline of the item.  The item is linked into
+ * the list in constant time in the same way as vListInsertEnd(), and is also
+ * linked into an intrusive pairing heap that is ordered by deadline, so the
+ * item with the earliest deadline can be obtained in constant time using
+ * listGET_OWNER_OF_DEADLINE_HEAD().  Insertion is O(1) and removal is
+ * O(log n) amortised, where n is the number of items in the list.
+ *
+ * All the items in a list that is used as a deadline heap must be inserted
+ * using this function.
+ *
+ * The weighted round robin scheduler uses the same heap to order its ready
+ * lists, with the virtual run time of each task as the item value.
+ *
+ * @param pxList The list into which the item is to be inserted.
+ *
+ * @param pxNewListItem The item that is to be placed in the list.
+ *
+ * \page vListInsertDeadline vListInsertDeadline
+ * \ingroup LinkedList
+ */
+    void vListInsertDeadline( List_t * const pxList,
+                              ListItem_t * const pxNewListItem ) PRIVILEGED_FUNCTION;
+
+/*
+ * Unlink an item from the deadline heap of a list.  This only updates the
+ * heap, it does not remove the item from the list itself.  It is called by
+ * uxListRemove() and listREMOVE_ITEM() so does not normally need to be called
+ * directly.
+ *
+ * \page vListRemoveDeadline vListRemoveDeadline
+ * \ingroup LinkedList
+ */
+    void vListRemoveDeadline( List_t * const pxList,
+                              ListItem_t * const pxItemToRemove ) PRIVILEGED_FUNCTION;
+
+#endif /* if ( listUSE_DEADLINE_HEAP == 1 ) */
 
 
 /* *INDENT-OFF* */
@@ -0,0 +1,321 @@
+/*
+ * FreeRTOS Kernel <DEVELOPMENT BRANCH>
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+#ifndef MEMORY_POOL_H
+#define MEMORY_POOL_H
+
+#ifndef INC_FREERTOS_H
+    #error "include FreeRTOS.h" must appear in source files before "include memory_pool.h"
+#endif
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/**
+ * A memory pool holds a fixed number of blocks that are all the same size.
+ * Allocating a block from a pool, or freeing a block back to it, takes the
+ * same short time however many blocks are allocated, and never fragments
+ * memory.  The free blocks are linked through their own first bytes, so a pool
+ * needs no memory other than its blocks and a small structure.  A task that
+ * finds a pool empty can enter the Blocked state to wait for a block to be
+ * freed, and the highest priority task that is waiting is unblocked as soon as
+ * one is.  Blocks can also be allocated and freed from interrupts.
+ *
+ * The configUSE_MEMORY_POOLS configuration constant must be set to 1 in
+ * FreeRTOSConfig.h, and memory_pool.c built, for memory pools to be available.
+ */
+
+/**
+ * memory_pool.h
+ *
+ * Type by which memory pools are referenced.  For example, a call to
+ * xPoolCreate() returns a PoolHandle_t variable that can then be used as a
+ * parameter to the other memory pool functions.
+ *
+ * \defgroup PoolHandle_t PoolHandle_t
+ * \ingroup MemoryPools
+ */
+struct PoolDefinition;
+typedef struct PoolDefinition * PoolHandle_t;
+
+/**
+ * memory_pool.h
+ *
+ * The number of bytes a block of xBlockSize bytes takes in a pool.  Blocks are
+ * rounded up to a multiple of portBYTE_ALIGNMENT bytes, and must be large
+ * enough to hold a pointer while they are free.  Storage passed to
+ * xPoolCreateStatic() must be at least poolBLOCK_SIZE( xBlockSize ) times the
+ * number of blocks in size.
+ */
+#define poolBLOCK_SIZE( xBlockSize )    ( ( ( ( ( size_t ) ( xBlockSize ) > sizeof( void * ) ) ? ( size_t ) ( xBlockSize ) : sizeof( void * ) ) + ( size_t ) portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) )
+
+/**
+ * memory_pool.h
+ * @code{c}
+ * PoolHandle_t xPoolCreate( UBaseType_t uxNumberOfBlocks, size_t xBlockSize );
+ * @endcode
+ *
+ * Create a memory pool of uxNumberOfBlocks blocks of at least xBlockSize bytes
+ * each.  The pool's structure and its blocks are allocated from the FreeRTOS
+ * heap in a single allocation.  See xPoolCreateStatic() to create a pool
+ * without using the heap.
+ *
+ * @param uxNumberOfBlocks The number of blocks in the pool.
+ *
+ * @param xBlockSize The size, in bytes, of each block.  Every block is aligned
+ * to portBYTE_ALIGNMENT bytes.
+ *
+ * @return If the pool was created then a handle to the pool is returned.  If
+ * there was insufficient FreeRTOS heap available to create the pool then NULL
+ * is returned.
+ *
+ * Example usage:
+ * @code{c}
+ *  typedef struct Message { uint8_t ucId; uint8_t ucData[ 30 ]; } Message_t;
+ *  PoolHandle_t xMessagePool;
+ *
+ *  void vAFunction( void )
+ *  {
+ *      // Create a pool of 16 messages.
+ *      xMessagePool = xPoolCreate( 16, sizeof( Message_t ) );
+ *
+ *      if( xMessagePool == NULL )
+ *      {
+ *          // There was not enough heap to create the pool.
+ *      }
+ *  }
+ * @endcode
+ * \defgroup xPoolCreate xPoolCreate
+ * \ingroup MemoryPools
+ */
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+    PoolHandle_t xPoolCreate( UBaseType_t uxNumberOfBlocks,
+                              size_t xBlockSize ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * memory_pool.h
+ * @code{c}
+ * PoolHandle_t xPoolCreateStatic( UBaseType_t uxNumberOfBlocks,
+ *                                 size_t xBlockSize,
+ *                                 uint8_t * pucPoolStorage,
+ *                                 StaticPool_t * pxPoolBuffer );
+ * @endcode
+ *
+ * Create a memory pool using memory provided by the application writer.
+ *
+ * @param uxNumberOfBlocks The number of blocks in the pool.
+ *
+ * @param xBlockSize The size, in bytes, of each block.
+ *
+ * @param pucPoolStorage The memory the blocks are taken from.  It must be
+ * aligned to portBYTE_ALIGNMENT bytes and hold at least
+ * ( uxNumberOfBlocks * poolBLOCK_SIZE( xBlockSize ) ) bytes.
+ *
+ * @param pxPoolBuffer Must point to a variable of type StaticPool_t, which will
+ * be used to hold the pool's data structure.
+ *
+ * @return If the pool was created then a handle to the pool is returned.  If
+ * pucPoolStorage or pxPoolBuffer is NULL then NULL is returned.
+ *
+ * Example usage:
+ * @code{c}
+ *  #define NUMBER_OF_MESSAGES    16
+ *
+ *  static uint8_t ucStorage[ NUMBER_OF_MESSAGES * poolBLOCK_SIZE( sizeof( Message_t ) ) ] __attribute__( ( aligned( portBYTE_ALIGNMENT ) ) );
+ *  static StaticPool_t xPoolStruct;
+ *
+ *  void vAFunction( void )
+ *  {
+ *      PoolHandle_t xMessagePool;
+ *
+ *      xMessagePool = xPoolCreateStatic( NUMBER_OF_MESSAGES, sizeof( Message_t ), ucStorage, &xPoolStruct );
+ *  }
+ * @endcode
+ * \defgroup xPoolCreateStatic xPoolCreateStatic
+ * \ingroup MemoryPools
+ */
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+    PoolHandle_t xPoolCreateStatic( UBaseType_t uxNumberOfBlocks,
+                                    size_t xBlockSize,
+                                    uint8_t * pucPoolStorage,
+                                    StaticPool_t * pxPoolBuffer ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * memory_pool.h
+ * @code{c}
+ * void vPoolDelete( PoolHandle_t xPool );
+ * @endcode
+ *
+ * Delete a memory pool, freeing its memory if it was created with
+ * xPoolCreate().  No task may be blocked on the pool, and no block taken from
+ * the pool may be used, once it is deleted.
+ *
+ * @param xPool The pool being deleted.
+ *
+ * \defgroup vPoolDelete vPoolDelete
+ * \ingroup MemoryPools
+ */
+void vPoolDelete( PoolHandle_t xPool ) PRIVILEGED_FUNCTION;
+
+/**
+ * memory_pool.h
+ * @code{c}
+ * void * pvPoolAlloc( PoolHandle_t xPool, TickType_t xTicksToWait );
+ * @endcode
+ *
+ * Take a block from a memory pool.  The contents of the block are undefined.
+ *
+ * @param xPool The pool the block is taken from.
+ *
+ * @param xTicksToWait The maximum amount of time, in ticks, the calling task
+ * should remain in the Blocked state to wait for a block to be freed if the
+ * pool is empty.  If several tasks are waiting, the one with the highest
+ * priority is unblocked when a block is freed.  Setting xTicksToWait to
+ * portMAX_DELAY causes the task to wait indefinitely, provided
+ * INCLUDE_vTaskSuspend is set to 1 in FreeRTOSConfig.h.
+ *
+ * @return A pointer to the block, or NULL if no block became available before
+ * xTicksToWait ticks passed.
+ *
+ * Example usage:
+ * @code{c}
+ *  void vATask( void * pvParameters )
+ *  {
+ *      Message_t * pxMessage;
+ *
+ *      // Wait up to 10 ticks for a message to be free.
+ *      pxMessage = pvPoolAlloc( xMessagePool, 10 );
+ *
+ *      if( pxMessage != NULL )
+ *      {
+ *          // Fill in the message and send a pointer to it to another task,
+ *          // which frees it with vPoolFree() once it has been processed.
+ *      }
+ *  }
+ * @endcode
+ * \defgroup pvPoolAlloc pvPoolAlloc
+ * \ingroup MemoryPools
+ */
+void * pvPoolAlloc( PoolHandle_t xPool,
+                    TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * memory_pool.h
+ * @code{c}
+ * void * pvPoolAllocFromISR( PoolHandle_t xPool );
+ * @endcode
+ *
+ * A version of pvPoolAlloc() that can be called from an interrupt service
+ * routine.  It never blocks.
+ *
+ * @param xPool The pool the block is taken from.
+ *
+ * @return A pointer to the block, or NULL if the pool is empty.
+ *
+ * \defgroup pvPoolAllocFromISR pvPoolAllocFromISR
+ * \ingroup MemoryPools
+ */
+void * pvPoolAllocFromISR( PoolHandle_t xPool ) PRIVILEGED_FUNCTION;
+
+/**
+ * memory_pool.h
+ * @code{c}
+ * void vPoolFree( PoolHandle_t xPool, void * pvBlock );
+ * @endcode
+ *
+ * Return a block to the memory pool it was taken from.  If any tasks are
+ * blocked waiting for a block from the pool, the one with the highest priority
+ * is unblocked.
+ *
+ * @param xPool The pool the block was taken from.
+ *
+ * @param pvBlock The block, as returned by pvPoolAlloc() or
+ * pvPoolAllocFromISR().
+ *
+ * \defgroup vPoolFree vPoolFree
+ * \ingroup MemoryPools
+ */
+void vPoolFree( PoolHandle_t xPool,
+                void * pvBlock ) PRIVILEGED_FUNCTION;
+
+/**
+ * memory_pool.h
+ * @code{c}
+ * void vPoolFreeFromISR( PoolHandle_t xPool,
+ *                        void * pvBlock,
+ *                        BaseType_t * pxHigherPriorityTaskWoken );
+ * @endcode
+ *
+ * A version of vPoolFree() that can be called from an interrupt service
+ * routine.
+ *
+ * @param xPool The pool the block was taken from.
+ *
+ * @param pvBlock The block, as returned by pvPoolAlloc() or
+ * pvPoolAllocFromISR().
+ *
+ * @param pxHigherPriorityTaskWoken vPoolFreeFromISR() sets
+ * *pxHigherPriorityTaskWoken to pdTRUE if freeing the block unblocked a task
+ * with a priority higher than the task that was interrupted, in which case a
+ * context switch should be requested before the interrupt is exited.  Can be
+ * NULL.
+ *
+ * \defgroup vPoolFreeFromISR vPoolFreeFromISR
+ * \ingroup MemoryPools
+ */
+void vPoolFreeFromISR( PoolHandle_t xPool,
+                       void * pvBlock,
+                       BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * memory_pool.h
+ * @code{c}
+ * UBaseType_t uxPoolGetFreeBlocks( PoolHandle_t xPool );
+ * @endcode
+ *
+ * @param xPool The pool being queried.
+ *
+ * @return The number of blocks that are free in the pool.
+ *
+ * \defgroup uxPoolGetFreeBlocks uxPoolGetFreeBlocks
+ * \ingroup MemoryPools
+ */
+UBaseType_t uxPoolGetFreeBlocks( PoolHandle_t xPool ) PRIVILEGED_FUNCTION;
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* MEMORY_POOL_H */
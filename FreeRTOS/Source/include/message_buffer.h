@@ -250,6 +250,140 @@ typedef StreamBufferHandle_t MessageBufferHandle_t;
     xStreamBufferGenericCreateStatic( ( xBufferSizeBytes ), 0, sbTYPE_MESSAGE_BUFFER, ( pucMessageBufferStorageArea ), ( pxStaticMessageBuffer ), ( pxSendCompletedCallback ), ( pxReceiveCompletedCallback ) )
 #endif
 
+/**
+ * message_buffer.h
+ *
+ * @code{c}
+ * MessageBufferHandle_t xMessageBufferCreateMPSC( size_t xBufferSizeBytes );
+ * @endcode
+ *
+ * Creates a new multi-producer, single-consumer (MPSC) message buffer using
+ * dynamically allocated memory.  See xMessageBufferCreateMPSCStatic() for a
+ * version that uses statically allocated memory.
+ *
+ * Unlike other message buffers, any number of tasks and interrupts can call
+ * xMessageBufferSend() and xMessageBufferSendFromISR() on an MPSC message
+ * buffer at the same time without a lock or critical section.  Each writer
+ * reserves space for its message by advancing the buffer's write index with a
+ * compare-and-swap, copies the message into that space, then marks the message
+ * as committed.  Writers can commit in a different order to the order in which
+ * they reserved space.  The single reader only receives a message once it has
+ * been committed, and receives messages in the order in which their space was
+ * reserved, so a writer that is preempted between reserving space and
+ * committing its message holds up every message reserved after its own.
+ *
+ * Writers to an MPSC message buffer never block - the xTicksToWait parameter
+ * of xMessageBufferSend() must be 0 - and a zero length message cannot be
+ * sent.  The reader can block in xMessageBufferReceive() as normal.
+ * xMessageBufferIsEmpty(), xMessageBufferSpacesAvailable() and
+ * xMessageBufferReset() treat space that has been reserved, but not yet
+ * committed, as holding a message, so xMessageBufferReset() must only be
+ * called when no writer is part way through a send.
+ *
+ * The compare-and-swap uses portCOMPARE_AND_SWAP_SIZE() if the port defines
+ * it, and otherwise briefly masks interrupts.
+ *
+ * configUSE_MPSC_MESSAGE_BUFFERS must be set to 1 in FreeRTOSConfig.h for
+ * xMessageBufferCreateMPSC() to be available.
+ *
+ * @param xBufferSizeBytes The total number of bytes the message buffer will be
+ * able to hold at any one time.  Each message is stored after a sizeof( size_t )
+ * byte header, and is padded to a multiple of sizeof( size_t ) bytes, so on a
+ * 32-bit architecture a 10 byte message takes up 16 bytes of message buffer
+ * space.  The write index is held in half the bits of a size_t, so on a 32-bit
+ * architecture the buffer must be a little smaller than 64K bytes.
+ *
+ * @return If NULL is returned, then the message buffer cannot be created
+ * because there is insufficient heap memory available for FreeRTOS to allocate
+ * the message buffer data structures and storage area.  A non-NULL value being
+ * returned indicates that the message buffer has been created successfully.
+ *
+ * Example use:
+ * @code{c}
+ *
+ * MessageBufferHandle_t xLogBuffer;
+ *
+ * void vALoggingTask( void * pvParameters )
+ * {
+ * char cRecord[ 64 ];
+ * size_t xLength;
+ *
+ *  xLogBuffer = xMessageBufferCreateMPSC( 1024 );
+ *
+ *  for( ;; )
+ *  {
+ *      // Wait for the next record from any writer.
+ *      xLength = xMessageBufferReceive( xLogBuffer, cRecord, sizeof( cRecord ), portMAX_DELAY );
+ *
+ *      if( xLength > 0 )
+ *      {
+ *          // Process the record here.
+ *      }
+ *  }
+ * }
+ *
+ * void vAnInterruptHandler( void )
+ * {
+ * BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+ * static const char cRecord[] = "interrupt";
+ *
+ *  // Interrupts and tasks can write to the buffer at the same time.  The
+ *  // record is dropped if there is not enough space.
+ *  ( void ) xMessageBufferSendFromISR( xLogBuffer, cRecord, sizeof( cRecord ), &xHigherPriorityTaskWoken );
+ *  portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+ * }
+ *
+ * @endcode
+ * \defgroup xMessageBufferCreateMPSC xMessageBufferCreateMPSC
+ * \ingroup MessageBufferManagement
+ */
+#if ( configUSE_MPSC_MESSAGE_BUFFERS == 1 )
+    #define xMessageBufferCreateMPSC( xBufferSizeBytes ) \
+    xStreamBufferGenericCreate( ( xBufferSizeBytes ), ( size_t ) 0, sbTYPE_MPSC_MESSAGE_BUFFER, NULL, NULL )
+#endif
+
+/**
+ * message_buffer.h
+ *
+ * @code{c}
+ * MessageBufferHandle_t xMessageBufferCreateMPSCStatic( size_t xBufferSizeBytes,
+ *                                                       uint8_t *pucMessageBufferStorageArea,
+ *                                                       StaticMessageBuffer_t *pxStaticMessageBuffer );
+ * @endcode
+ * Creates a new multi-producer, single-consumer (MPSC) message buffer using
+ * statically allocated memory.  See xMessageBufferCreateMPSC() for a
+ * description of how MPSC message buffers differ from other message buffers.
+ *
+ * configUSE_MPSC_MESSAGE_BUFFERS must be set to 1 in FreeRTOSConfig.h for
+ * xMessageBufferCreateMPSCStatic() to be available.
+ *
+ * @param xBufferSizeBytes The size, in bytes, of the buffer pointed to by the
+ * pucMessageBufferStorageArea parameter.  Must be a multiple of sizeof( size_t )
+ * and at least three times sizeof( size_t ).  sizeof( size_t ) bytes of the
+ * buffer are always kept free, so the largest message that can be written is
+ * ( xBufferSizeBytes - ( 2 * sizeof( size_t ) ) ) bytes.  The write index is
+ * held in half the bits of a size_t, so on a 32-bit architecture
+ * xBufferSizeBytes must be smaller than 64K bytes.
+ *
+ * @param pucMessageBufferStorageArea Must point to a size_t aligned uint8_t
+ * array that is at least xBufferSizeBytes big.
+ *
+ * @param pxStaticMessageBuffer Must point to a variable of type
+ * StaticMessageBuffer_t, which will be used to hold the message buffer's data
+ * structure.
+ *
+ * @return If the message buffer is created successfully then a handle to the
+ * created message buffer is returned. If either pucMessageBufferStorageArea or
+ * pxStaticmessageBuffer are NULL then NULL is returned.
+ *
+ * \defgroup xMessageBufferCreateMPSCStatic xMessageBufferCreateMPSCStatic
+ * \ingroup MessageBufferManagement
+ */
+#if ( configUSE_MPSC_MESSAGE_BUFFERS == 1 )
+    #define xMessageBufferCreateMPSCStatic( xBufferSizeBytes, pucMessageBufferStorageArea, pxStaticMessageBuffer ) \
+    xStreamBufferGenericCreateStatic( ( xBufferSizeBytes ), 0, sbTYPE_MPSC_MESSAGE_BUFFER, ( pucMessageBufferStorageArea ), ( pxStaticMessageBuffer ), NULL, NULL )
+#endif
+
 /**
  * message_buffer.h
  *
@@ -495,6 +629,83 @@ typedef StreamBufferHandle_t MessageBufferHandle_t;
 #define xMessageBufferSendFromISR( xMessageBuffer, pvTxData, xDataLengthBytes, pxHigherPriorityTaskWoken ) \
     xStreamBufferSendFromISR( ( xMessageBuffer ), ( pvTxData ), ( xDataLengthBytes ), ( pxHigherPriorityTaskWoken ) )
 
+/**
+ * message_buffer.h
+ *
+ * @code{c}
+ * size_t xMessageBufferReserve( MessageBufferHandle_t xMessageBuffer,
+ *                               size_t xMaxBytes,
+ *                               StreamBufferSegments_t * const pxSegments,
+ *                               TickType_t xTicksToWait );
+ * @endcode
+ *
+ * Reserves space for a message so the writer can write it directly into the
+ * message buffer's storage area.  The message is sent by calling
+ * xMessageBufferCommit() or xMessageBufferCommitFromISR() with its length,
+ * which can be less than the space reserved.  See xStreamBufferReserve().
+ *
+ * Space cannot be reserved in an MPSC message buffer.
+ *
+ * @param xMessageBuffer The handle of the message buffer in which to reserve
+ * space.
+ *
+ * @param xMaxBytes The length of the longest message that will be written.
+ *
+ * @param pxSegments Used to return the reserved space, which may wrap around
+ * the end of the storage area.
+ *
+ * @param xTicksToWait The maximum amount of time to wait for space for a
+ * message of xMaxBytes bytes to become available.
+ *
+ * @return The number of bytes reserved for the message.
+ *
+ * \defgroup xMessageBufferReserve xMessageBufferReserve
+ * \ingroup MessageBufferManagement
+ */
+#define xMessageBufferReserve( xMessageBuffer, xMaxBytes, pxSegments, xTicksToWait ) \
+    xStreamBufferReserve( ( xMessageBuffer ), ( xMaxBytes ), ( pxSegments ), ( xTicksToWait ) )
+
+/**
+ * message_buffer.h
+ *
+ * @code{c}
+ * size_t xMessageBufferCommit( MessageBufferHandle_t xMessageBuffer,
+ *                              size_t xBytesWritten );
+ * @endcode
+ *
+ * Sends the xBytesWritten byte message written into space returned by
+ * xMessageBufferReserve().  See xStreamBufferCommit().
+ *
+ * @param xMessageBuffer The handle of the message buffer being written to.
+ *
+ * @param xBytesWritten The length of the message.
+ *
+ * @return The length of the message sent, or 0 if xBytesWritten was 0.
+ *
+ * \defgroup xMessageBufferCommit xMessageBufferCommit
+ * \ingroup MessageBufferManagement
+ */
+#define xMessageBufferCommit( xMessageBuffer, xBytesWritten ) \
+    xStreamBufferCommit( ( xMessageBuffer ), ( xBytesWritten ) )
+
+/**
+ * message_buffer.h
+ *
+ * @code{c}
+ * size_t xMessageBufferCommitFromISR( MessageBufferHandle_t xMessageBuffer,
+ *                                     size_t xBytesWritten,
+ *                                     BaseType_t * const pxHigherPriorityTaskWoken );
+ * @endcode
+ *
+ * A version of xMessageBufferCommit() that can be called from an interrupt
+ * service routine.  See xStreamBufferCommitFromISR().
+ *
+ * \defgroup xMessageBufferCommitFromISR xMessageBufferCommitFromISR
+ * \ingroup MessageBufferManagement
+ */
+#define xMessageBufferCommitFromISR( xMessageBuffer, xBytesWritten, pxHigherPriorityTaskWoken ) \
+    xStreamBufferCommitFromISR( ( xMessageBuffer ), ( xBytesWritten ), ( pxHigherPriorityTaskWoken ) )
+
 /**
  * message_buffer.h
  *
@@ -692,6 +903,80 @@ typedef StreamBufferHandle_t MessageBufferHandle_t;
 #define xMessageBufferReceiveFromISR( xMessageBuffer, pvRxData, xBufferLengthBytes, pxHigherPriorityTaskWoken ) \
     xStreamBufferReceiveFromISR( ( xMessageBuffer ), ( pvRxData ), ( xBufferLengthBytes ), ( pxHigherPriorityTaskWoken ) )
 
+/**
+ * message_buffer.h
+ *
+ * @code{c}
+ * size_t xMessageBufferPeekContiguous( MessageBufferHandle_t xMessageBuffer,
+ *                                      StreamBufferSegments_t * const pxSegments,
+ *                                      TickType_t xTicksToWait );
+ * @endcode
+ *
+ * Returns the next message in place, so the reader can process it without
+ * first copying it out.  The message stays in the message buffer until
+ * xMessageBufferConsume() or xMessageBufferConsumeFromISR() is called.  See
+ * xStreamBufferPeekContiguous().
+ *
+ * Messages cannot be peeked from an MPSC message buffer.
+ *
+ * @param xMessageBuffer The handle of the message buffer from which a message
+ * is to be peeked.
+ *
+ * @param pxSegments Used to return the message, which may wrap around the end
+ * of the storage area.
+ *
+ * @param xTicksToWait The maximum amount of time to wait for a message.
+ *
+ * @return The length of the message, or 0 if there is no message.
+ *
+ * \defgroup xMessageBufferPeekContiguous xMessageBufferPeekContiguous
+ * \ingroup MessageBufferManagement
+ */
+#define xMessageBufferPeekContiguous( xMessageBuffer, pxSegments, xTicksToWait ) \
+    xStreamBufferPeekContiguous( ( xMessageBuffer ), ( pxSegments ), ( xTicksToWait ) )
+
+/**
+ * message_buffer.h
+ *
+ * @code{c}
+ * size_t xMessageBufferConsume( MessageBufferHandle_t xMessageBuffer,
+ *                               size_t xBytesRead );
+ * @endcode
+ *
+ * Removes the message returned by xMessageBufferPeekContiguous().  See
+ * xStreamBufferConsume().
+ *
+ * @param xMessageBuffer The handle of the message buffer being read from.
+ *
+ * @param xBytesRead The length of the message, as returned by
+ * xMessageBufferPeekContiguous().
+ *
+ * @return The length of the message removed.
+ *
+ * \defgroup xMessageBufferConsume xMessageBufferConsume
+ * \ingroup MessageBufferManagement
+ */
+#define xMessageBufferConsume( xMessageBuffer, xBytesRead ) \
+    xStreamBufferConsume( ( xMessageBuffer ), ( xBytesRead ) )
+
+/**
+ * message_buffer.h
+ *
+ * @code{c}
+ * size_t xMessageBufferConsumeFromISR( MessageBufferHandle_t xMessageBuffer,
+ *                                      size_t xBytesRead,
+ *                                      BaseType_t * const pxHigherPriorityTaskWoken );
+ * @endcode
+ *
+ * A version of xMessageBufferConsume() that can be called from an interrupt
+ * service routine.  See xStreamBufferConsumeFromISR().
+ *
+ * \defgroup xMessageBufferConsumeFromISR xMessageBufferConsumeFromISR
+ * \ingroup MessageBufferManagement
+ */
+#define xMessageBufferConsumeFromISR( xMessageBuffer, xBytesRead, pxHigherPriorityTaskWoken ) \
+    xStreamBufferConsumeFromISR( ( xMessageBuffer ), ( xBytesRead ), ( pxHigherPriorityTaskWoken ) )
+
 /**
  * message_buffer.h
  *
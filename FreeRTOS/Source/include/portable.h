@@ -195,9 +195,48 @@ size_t xPortGetFreeHeapSize( void ) PRIVILEGED_FUNCTION;
 size_t xPortGetMinimumEverFreeHeapSize( void ) PRIVILEGED_FUNCTION;
 void xPortResetHeapMinimumEverFreeHeapSize( void ) PRIVILEGED_FUNCTION;
 
+/*
+ * Return the blocks held in a task's heap cache, and the cache itself, to the
+ * heap.  Called by the kernel when a task is deleted if configUSE_HEAP_CACHE is
+ * 1.  Only heap_4.c provides heap caches.
+ */
+void vPortFreeHeapCache( void * pvHeapCache ) PRIVILEGED_FUNCTION;
+
+#if ( configUSE_HEAP_REGIONS == 1 )
+
+/*
+ * Allocate a block from one of the heap regions selected by uxRegionMask, in
+ * which bit n selects the nth region passed to vPortDefineHeapRegions().  The
+ * selected regions are tried in the order they appear in that array, so the
+ * block comes from the first selected region that has space for it.  Only
+ * heap_5.c provides heap regions.
+ */
+    void * pvPortMallocRegion( size_t xWantedSize,
+                               UBaseType_t uxRegionMask ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns a HeapStats_t structure filled with information about the current
+ * state of the heap region with index uxRegion, where the first region passed
+ * to vPortDefineHeapRegions() has index 0.
+ */
+    void vPortGetHeapRegionStats( UBaseType_t uxRegion,
+                                  HeapStats_t * pxHeapStats ) PRIVILEGED_FUNCTION;
+
+/* Kernel objects are allocated from the regions selected by the
+ * configHEAP_REGIONS_FOR_ masks. */
+    #define pvPortMallocTCB( xSize )      pvPortMallocRegion( ( xSize ), configHEAP_REGIONS_FOR_TCBS )
+    #define pvPortMallocQueue( xSize )    pvPortMallocRegion( ( xSize ), configHEAP_REGIONS_FOR_QUEUES )
+#else
+    #define pvPortMallocTCB( xSize )      pvPortMalloc( xSize )
+    #define pvPortMallocQueue( xSize )    pvPortMalloc( xSize )
+#endif /* if ( configUSE_HEAP_REGIONS == 1 ) */
+
 #if ( configSTACK_ALLOCATION_FROM_SEPARATE_HEAP == 1 )
     void * pvPortMallocStack( size_t xSize ) PRIVILEGED_FUNCTION;
     void vPortFreeStack( void * pv ) PRIVILEGED_FUNCTION;
+#elif ( configUSE_HEAP_REGIONS == 1 )
+    #define pvPortMallocStack( xSize )    pvPortMallocRegion( ( xSize ), configHEAP_REGIONS_FOR_STACKS )
+    #define vPortFreeStack       vPortFree
 #else
     #define pvPortMallocStack    pvPortMalloc
     #define vPortFreeStack       vPortFree
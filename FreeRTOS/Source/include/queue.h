@@ -76,6 +76,7 @@ typedef struct QueueDefinition   * QueueSetMemberHandle_t;
 #define queueQUEUE_TYPE_BINARY_SEMAPHORE      ( ( uint8_t ) 3U )
 #define queueQUEUE_TYPE_RECURSIVE_MUTEX       ( ( uint8_t ) 4U )
 #define queueQUEUE_TYPE_SET                   ( ( uint8_t ) 5U )
+#define queueQUEUE_TYPE_SPSC                  ( ( uint8_t ) 6U )
 
 /**
  * queue. h
@@ -235,6 +236,266 @@ typedef struct QueueDefinition   * QueueSetMemberHandle_t;
     #define xQueueCreateStatic( uxQueueLength, uxItemSize, pucQueueStorage, pxQueueBuffer )    xQueueGenericCreateStatic( ( uxQueueLength ), ( uxItemSize ), ( pucQueueStorage ), ( pxQueueBuffer ), ( queueQUEUE_TYPE_BASE ) )
 #endif /* configSUPPORT_STATIC_ALLOCATION */
 
+/**
+ * queue. h
+ * @code{c}
+ * QueueHandle_t xQueueCreateSPSC(
+ *                            UBaseType_t uxQueueLength,
+ *                            UBaseType_t uxItemSize
+ *                        );
+ * @endcode
+ *
+ * Creates a new single producer single consumer queue instance, and returns a
+ * handle by which the new queue can be referenced.  xQueueCreateSPSCStatic()
+ * does the same without using any dynamic memory allocation, and takes the
+ * same parameters as xQueueCreateStatic().
+ *
+ * Only one task may ever send to the queue, and only one task may ever receive
+ * from it.  In return xQueueSend(), xQueueSendToBack() and xQueueReceive() do
+ * not enter a critical section unless the item cannot be sent or received
+ * straight away, or a task is blocked on the queue.  The sending and receiving
+ * tasks each update their own position in the queue, so neither position needs
+ * to be updated atomically.
+ *
+ * The queue cannot be used from an interrupt, and cannot be used with
+ * xQueueSendToFront(), xQueueOverwrite(), xQueuePeek() or queue sets.
+ *
+ * The configUSE_SPSC_QUEUES configuration constant must be set to 1 for
+ * xQueueCreateSPSC() and xQueueCreateSPSCStatic() to be available.
+ *
+ * @param uxQueueLength The maximum number of items that the queue can contain.
+ *
+ * @param uxItemSize The number of bytes each item in the queue will require.
+ * It must not be zero.
+ *
+ * @return If the queue is successfully created then a handle to the newly
+ * created queue is returned.  If the queue cannot be created then NULL is
+ * returned.
+ *
+ * Example usage:
+ * @code{c}
+ * void vATask( void *pvParameters )
+ * {
+ * QueueHandle_t xQueue;
+ *
+ *  // Create a queue capable of containing 64 uint32_t values that only
+ *  // this task sends to and only one other task receives from.
+ *  xQueue = xQueueCreateSPSC( 64, sizeof( uint32_t ) );
+ *  if( xQueue == NULL )
+ *  {
+ *      // Queue was not created and must not be used.
+ *  }
+ *
+ *  // ... Rest of task code.
+ * }
+ * @endcode
+ * \defgroup xQueueCreateSPSC xQueueCreateSPSC
+ * \ingroup QueueManagement
+ */
+#if ( configUSE_SPSC_QUEUES == 1 )
+    #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+        #define xQueueCreateSPSC( uxQueueLength, uxItemSize )    xQueueGenericCreate( ( uxQueueLength ), ( uxItemSize ), ( queueQUEUE_TYPE_SPSC ) )
+    #endif
+
+    #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+        #define xQueueCreateSPSCStatic( uxQueueLength, uxItemSize, pucQueueStorage, pxQueueBuffer )    xQueueGenericCreateStatic( ( uxQueueLength ), ( uxItemSize ), ( pucQueueStorage ), ( pxQueueBuffer ), ( queueQUEUE_TYPE_SPSC ) )
+    #endif
+#endif /* configUSE_SPSC_QUEUES */
+
+/**
+ * queue. h
+ * @code{c}
+ * QueueHandle_t xQueueCreateZeroCopy(
+ *                            UBaseType_t uxQueueLength,
+ *                            UBaseType_t uxNumberOfBuffers,
+ *                            size_t xBufferSize
+ *                        );
+ * @endcode
+ *
+ * Creates a new zero copy queue instance, and returns a handle by which the
+ * new queue can be referenced.
+ *
+ * A zero copy queue owns a pool of uxNumberOfBuffers buffers, each of
+ * xBufferSize bytes, that are allocated together with the queue.  A sending
+ * task takes a free buffer from the pool with pvQueueAcquireBuffer(), writes
+ * into it, and sends it with xQueueSendBuffer().  A receiving task takes the
+ * buffer from the queue with pvQueueReceiveBuffer(), reads from it, and returns
+ * it to the pool with vQueueReleaseBuffer().  Only a pointer to the buffer is
+ * copied into and out of the queue, and no memory is allocated or freed after
+ * the queue has been created.
+ *
+ * Each buffer records whether it is free, acquired, queued or received, and
+ * the task that owns it.  If configCHECK_ZERO_COPY_BUFFERS is set to 1 then
+ * configASSERT() checks every buffer passed to the queue came from its pool,
+ * is in a state in which the operation is valid, and is owned by the calling
+ * task - so a buffer that is released twice, or used after it was sent or
+ * released, is caught.
+ *
+ * Buffers must only be moved with the functions above.  xQueueReset() must
+ * not be used on a zero copy queue, as buffers in the queue would not be
+ * returned to the pool.  The queue can be added to a queue set, in which case
+ * the task that selects it receives the buffer with pvQueueReceiveBuffer().
+ *
+ * The configUSE_ZERO_COPY_QUEUES configuration constant must be set to 1 for
+ * xQueueCreateZeroCopy() to be available.
+ *
+ * @param uxQueueLength The maximum number of buffers that the queue can
+ * contain.
+ *
+ * @param uxNumberOfBuffers The number of buffers in the pool.
+ *
+ * @param xBufferSize The number of bytes in each buffer.  Each buffer is
+ * aligned to portBYTE_ALIGNMENT.
+ *
+ * @return If the queue is successfully created then a handle to the newly
+ * created queue is returned.  If the queue cannot be created then NULL is
+ * returned.
+ *
+ * Example usage:
+ * @code{c}
+ * QueueHandle_t xFrameQueue;
+ *
+ * void vSetup( void )
+ * {
+ *  // Create a queue that passes up to 8 frames of 1024 bytes between tasks,
+ *  // from a pool of 12 frames.
+ *  xFrameQueue = xQueueCreateZeroCopy( 8, 12, 1024 );
+ * }
+ *
+ * void vSendingTask( void *pvParameters )
+ * {
+ * uint8_t *pucFrame;
+ *
+ *  for( ;; )
+ *  {
+ *      pucFrame = pvQueueAcquireBuffer( xFrameQueue, portMAX_DELAY );
+ *      vFillFrame( pucFrame );
+ *      xQueueSendBuffer( xFrameQueue, pucFrame, portMAX_DELAY );
+ *
+ *      // pucFrame now belongs to the receiving task and must not be used.
+ *  }
+ * }
+ *
+ * void vReceivingTask( void *pvParameters )
+ * {
+ * uint8_t *pucFrame;
+ *
+ *  for( ;; )
+ *  {
+ *      pucFrame = pvQueueReceiveBuffer( xFrameQueue, portMAX_DELAY );
+ *      vProcessFrame( pucFrame );
+ *      vQueueReleaseBuffer( xFrameQueue, pucFrame );
+ *  }
+ * }
+ * @endcode
+ * \defgroup xQueueCreateZeroCopy xQueueCreateZeroCopy
+ * \ingroup QueueManagement
+ */
+#if ( ( configUSE_ZERO_COPY_QUEUES == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+    QueueHandle_t xQueueCreateZeroCopy( const UBaseType_t uxQueueLength,
+                                        const UBaseType_t uxNumberOfBuffers,
+                                        const size_t xBufferSize ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * queue. h
+ * @code{c}
+ * void * pvQueueAcquireBuffer( QueueHandle_t xQueue, TickType_t xTicksToWait );
+ * @endcode
+ *
+ * Takes a free buffer from the pool of a queue created with
+ * xQueueCreateZeroCopy().  The calling task owns the buffer until it passes
+ * the buffer to xQueueSendBuffer() or vQueueReleaseBuffer().
+ *
+ * @param xQueue The handle of the zero copy queue.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for a buffer to be released, should all the buffers be in use.
+ *
+ * @return A pointer to the buffer, or NULL if no buffer became free within
+ * the block time.
+ *
+ * \defgroup pvQueueAcquireBuffer pvQueueAcquireBuffer
+ * \ingroup QueueManagement
+ */
+
+/**
+ * queue. h
+ * @code{c}
+ * BaseType_t xQueueSendBuffer( QueueHandle_t xQueue, void * pvBuffer, TickType_t xTicksToWait );
+ * @endcode
+ *
+ * Posts a buffer to the back of a queue created with xQueueCreateZeroCopy().
+ * The buffer must have been acquired or received from the same queue by the
+ * calling task.  If the buffer is sent then it no longer belongs to the
+ * calling task.  If it is not sent then the calling task still owns it.
+ *
+ * @param xQueue The handle of the zero copy queue.
+ *
+ * @param pvBuffer The buffer to send.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for space to become available on the queue, should it already be
+ * full.
+ *
+ * @return pdTRUE if the buffer was sent, otherwise errQUEUE_FULL.
+ *
+ * \defgroup xQueueSendBuffer xQueueSendBuffer
+ * \ingroup QueueManagement
+ */
+
+/**
+ * queue. h
+ * @code{c}
+ * void * pvQueueReceiveBuffer( QueueHandle_t xQueue, TickType_t xTicksToWait );
+ * @endcode
+ *
+ * Receives a buffer from a queue created with xQueueCreateZeroCopy().  The
+ * calling task owns the buffer until it passes the buffer to
+ * vQueueReleaseBuffer() or xQueueSendBuffer().
+ *
+ * @param xQueue The handle of the zero copy queue.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for a buffer to be sent, should the queue be empty.
+ *
+ * @return A pointer to the buffer, or NULL if no buffer was received within
+ * the block time.
+ *
+ * \defgroup pvQueueReceiveBuffer pvQueueReceiveBuffer
+ * \ingroup QueueManagement
+ */
+
+/**
+ * queue. h
+ * @code{c}
+ * void vQueueReleaseBuffer( QueueHandle_t xQueue, void * pvBuffer );
+ * @endcode
+ *
+ * Returns a buffer to the pool of a queue created with xQueueCreateZeroCopy().
+ * The buffer must have been acquired or received from the same queue by the
+ * calling task, and must not be used again until it is acquired or received
+ * again.  The pool can hold every buffer, so this function never blocks.
+ *
+ * @param xQueue The handle of the zero copy queue.
+ *
+ * @param pvBuffer The buffer to release.
+ *
+ * \defgroup vQueueReleaseBuffer vQueueReleaseBuffer
+ * \ingroup QueueManagement
+ */
+#if ( configUSE_ZERO_COPY_QUEUES == 1 )
+    void * pvQueueAcquireBuffer( QueueHandle_t xQueue,
+                                 TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+    BaseType_t xQueueSendBuffer( QueueHandle_t xQueue,
+                                 void * pvBuffer,
+                                 TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+    void * pvQueueReceiveBuffer( QueueHandle_t xQueue,
+                                 TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+    void vQueueReleaseBuffer( QueueHandle_t xQueue,
+                              void * pvBuffer ) PRIVILEGED_FUNCTION;
+#endif /* configUSE_ZERO_COPY_QUEUES */
+
 /**
  * queue. h
  * @code{c}
@@ -914,6 +1175,115 @@ BaseType_t xQueueReceive( QueueHandle_t xQueue,
                           void * const pvBuffer,
                           TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
 
+/**
+ * queue. h
+ * @code{c}
+ * BaseType_t xQueueSendMultiple(
+ *                               QueueHandle_t xQueue,
+ *                               const void * const pvItemsToQueue,
+ *                               UBaseType_t uxItemCount,
+ *                               TickType_t xTicksToWait
+ *                           );
+ * @endcode
+ *
+ * Post uxItemCount items to the back of a queue in one call.  The items are
+ * copied into the queue with at most two calls to memcpy(), and the tasks
+ * waiting to receive from the queue are unblocked once for the whole batch,
+ * rather than once for each item.
+ *
+ * If there is not space for every item then as many items as fit are posted,
+ * and the calling task blocks for up to xTicksToWait ticks for space to post
+ * the rest.  Items are posted in order, so the items that were not posted are
+ * always the last items in the array.
+ *
+ * The queue cannot be a semaphore, a mutex or a single producer single
+ * consumer queue.
+ *
+ * @param xQueue The handle to the queue on which the items are to be posted.
+ *
+ * @param pvItemsToQueue A pointer to an array of uxItemCount items, each the
+ * size defined when the queue was created.
+ *
+ * @param uxItemCount The number of items in the array.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for space to become available on the queue, should it be full.
+ *
+ * @return The number of items posted, from 0 to uxItemCount.
+ *
+ * Example usage:
+ * @code{c}
+ * void vATask( void *pvParameters )
+ * {
+ * uint32_t ulSamples[ 16 ];
+ * BaseType_t xSent;
+ *
+ *  vReadSamples( ulSamples, 16 );
+ *
+ *  // Post all 16 samples, waiting up to 10 ticks for space.
+ *  xSent = xQueueSendMultiple( xQueue, ulSamples, 16, ( TickType_t ) 10 );
+ *
+ *  if( xSent < 16 )
+ *  {
+ *      // ulSamples[ xSent ] onwards were not posted.
+ *  }
+ * }
+ * @endcode
+ * \defgroup xQueueSendMultiple xQueueSendMultiple
+ * \ingroup QueueManagement
+ */
+BaseType_t xQueueSendMultiple( QueueHandle_t xQueue,
+                               const void * const pvItemsToQueue,
+                               const UBaseType_t uxItemCount,
+                               TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * @code{c}
+ * BaseType_t xQueueReceiveMultiple(
+ *                                  QueueHandle_t xQueue,
+ *                                  void * const pvBuffer,
+ *                                  UBaseType_t uxMaxItems,
+ *                                  TickType_t xTicksToWait
+ *                              );
+ * @endcode
+ *
+ * Receive up to uxMaxItems items from a queue in one call.  The items are
+ * copied out of the queue with at most two calls to memcpy(), and the tasks
+ * waiting to post to the queue are unblocked once for the whole batch, rather
+ * than once for each item.
+ *
+ * The calling task blocks for up to xTicksToWait ticks if the queue is empty.
+ * As soon as the queue holds any items, as many as are available, up to
+ * uxMaxItems, are received.
+ *
+ * The queue cannot be a semaphore, a mutex or a single producer single
+ * consumer queue.
+ *
+ * @param xQueue The handle to the queue from which the items are to be
+ * received.
+ *
+ * @param pvBuffer Pointer to the buffer into which the received items will be
+ * copied.  It must have space for uxMaxItems items.
+ *
+ * @param uxMaxItems The maximum number of items to receive.  Must be greater
+ * than zero.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for an item to receive should the queue be empty at the time of the
+ * call.
+ *
+ * @return The number of items received, which is 0 if the block time expired
+ * before any item was available.
+ *
+ * \defgroup xQueueReceiveMultiple xQueueReceiveMultiple
+ * \ingroup QueueManagement
+ */
+BaseType_t xQueueReceiveMultiple( QueueHandle_t xQueue,
+                                  void * const pvBuffer,
+                                  const UBaseType_t uxMaxItems,
+                                  TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
 /**
  * queue. h
  * @code{c}
@@ -1456,6 +1826,94 @@ BaseType_t xQueueReceiveFromISR( QueueHandle_t xQueue,
                                  void * const pvBuffer,
                                  BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
 
+/**
+ * queue. h
+ * @code{c}
+ * BaseType_t xQueueSendMultipleFromISR(
+ *                                      QueueHandle_t xQueue,
+ *                                      const void * const pvItemsToQueue,
+ *                                      UBaseType_t uxItemCount,
+ *                                      BaseType_t *pxHigherPriorityTaskWoken
+ *                                  );
+ * @endcode
+ *
+ * A version of xQueueSendMultiple() that can be used in an interrupt service
+ * routine.  As many of the items as there is space for are posted, in one
+ * critical section, and the function never blocks.
+ *
+ * @param xQueue The handle to the queue on which the items are to be posted.
+ *
+ * @param pvItemsToQueue A pointer to an array of uxItemCount items.
+ *
+ * @param uxItemCount The number of items in the array.
+ *
+ * @param pxHigherPriorityTaskWoken xQueueSendMultipleFromISR() will set
+ * *pxHigherPriorityTaskWoken to pdTRUE if posting the items caused a task to
+ * unblock, and the unblocked task has a priority higher than the currently
+ * running task.  If xQueueSendMultipleFromISR() sets this value to pdTRUE then
+ * a context switch should be requested before the interrupt is exited.
+ *
+ * @return The number of items posted, from 0 to uxItemCount.
+ *
+ * Example usage for a DMA completion interrupt:
+ * @code{c}
+ * void vDMACompleteISR( void )
+ * {
+ * BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+ *
+ *  // Post every sample the DMA transfer completed in one call, rather than
+ *  // one call for each sample.
+ *  xQueueSendMultipleFromISR( xSampleQueue, usDMABuffer, DMA_SAMPLES, &xHigherPriorityTaskWoken );
+ *
+ *  portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+ * }
+ * @endcode
+ * \defgroup xQueueSendMultipleFromISR xQueueSendMultipleFromISR
+ * \ingroup QueueManagement
+ */
+BaseType_t xQueueSendMultipleFromISR( QueueHandle_t xQueue,
+                                      const void * const pvItemsToQueue,
+                                      const UBaseType_t uxItemCount,
+                                      BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * @code{c}
+ * BaseType_t xQueueReceiveMultipleFromISR(
+ *                                         QueueHandle_t xQueue,
+ *                                         void * const pvBuffer,
+ *                                         UBaseType_t uxMaxItems,
+ *                                         BaseType_t *pxHigherPriorityTaskWoken
+ *                                     );
+ * @endcode
+ *
+ * A version of xQueueReceiveMultiple() that can be used in an interrupt
+ * service routine.  As many items as are available, up to uxMaxItems, are
+ * received in one critical section, and the function never blocks.
+ *
+ * @param xQueue The handle to the queue from which the items are to be
+ * received.
+ *
+ * @param pvBuffer Pointer to the buffer into which the received items will be
+ * copied.  It must have space for uxMaxItems items.
+ *
+ * @param uxMaxItems The maximum number of items to receive.
+ *
+ * @param pxHigherPriorityTaskWoken xQueueReceiveMultipleFromISR() will set
+ * *pxHigherPriorityTaskWoken to pdTRUE if receiving the items caused a task
+ * to unblock, and the unblocked task has a priority higher than the currently
+ * running task.
+ *
+ * @return The number of items received.
+ *
+ * \defgroup xQueueReceiveMultipleFromISR xQueueReceiveMultipleFromISR
+ * \ingroup QueueManagement
+ */
+BaseType_t xQueueReceiveMultipleFromISR( QueueHandle_t xQueue,
+                                         void * const pvBuffer,
+                                         const UBaseType_t uxMaxItems,
+                                         BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
 /*
  * Utilities to query queues that are safe to use from an ISR.  These utilities
  * should be used only from within an ISR, or within a critical section.
@@ -68,6 +68,7 @@
 #define sbTYPE_STREAM_BUFFER             ( ( BaseType_t ) 0 )
 #define sbTYPE_MESSAGE_BUFFER            ( ( BaseType_t ) 1 )
 #define sbTYPE_STREAM_BATCHING_BUFFER    ( ( BaseType_t ) 2 )
+#define sbTYPE_MPSC_MESSAGE_BUFFER       ( ( BaseType_t ) 3 )
 
 /**
  * Type by which stream buffers are referenced.  For example, a call to
@@ -85,6 +86,19 @@ typedef void (* StreamBufferCallbackFunction_t)( StreamBufferHandle_t xStreamBuf
                                                  BaseType_t xIsInsideISR,
                                                  BaseType_t * const pxHigherPriorityTaskWoken );
 
+/**
+ * Type used to describe a region of a stream buffer's storage area in place.
+ * The region wraps around the end of the storage area if pucSecond is not
+ * NULL, in which case it continues with the xSecondLength bytes at pucSecond.
+ */
+typedef struct StreamBufferSegments
+{
+    uint8_t * pucFirst;   /**< The start of the region, or NULL if the region is empty. */
+    size_t xFirstLength;  /**< The number of bytes at pucFirst. */
+    uint8_t * pucSecond;  /**< The part of the region that wrapped to the start of the storage area, or NULL. */
+    size_t xSecondLength; /**< The number of bytes at pucSecond. */
+} StreamBufferSegments_t;
+
 /**
  * stream_buffer.h
  *
@@ -698,6 +712,160 @@ size_t xStreamBufferSendFromISR( StreamBufferHandle_t xStreamBuffer,
                                  size_t xDataLengthBytes,
                                  BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
 
+/**
+ * stream_buffer.h
+ *
+ * @code{c}
+ * size_t xStreamBufferReserve( StreamBufferHandle_t xStreamBuffer,
+ *                              size_t xMaxBytes,
+ *                              StreamBufferSegments_t * const pxSegments,
+ *                              TickType_t xTicksToWait );
+ * @endcode
+ *
+ * Reserves free space in a stream buffer so the writer can write its data
+ * directly into the buffer's storage area, rather than copying it in with
+ * xStreamBufferSend().  The data is not visible to the reader until
+ * xStreamBufferCommit() or xStreamBufferCommitFromISR() is called.
+ *
+ * The reserved space may wrap around the end of the storage area, so it is
+ * returned as up to two segments in *pxSegments.  Bytes are written to
+ * pxSegments->pucFirst first, then to pxSegments->pucSecond.
+ *
+ * If the stream buffer is a message buffer the segments start after the
+ * space needed to store the length of the message, which is written by
+ * xStreamBufferCommit().
+ *
+ * As with xStreamBufferSend(), only one task or interrupt can write to a
+ * stream buffer at a time, and the writer must not call any other send
+ * function between reserving space and committing it.  Reserving space does
+ * not change the stream buffer, so a reservation that is not needed can be
+ * abandoned by committing zero bytes, or simply not committing.  Space cannot
+ * be reserved in an MPSC message buffer.
+ *
+ * xStreamBufferReserve() can be called from an interrupt service routine if
+ * xTicksToWait is 0.
+ *
+ * configUSE_STREAM_BUFFERS must be set to 1 in for FreeRTOSConfig.h for
+ * xStreamBufferReserve() to be available.
+ *
+ * @param xStreamBuffer The handle of the stream buffer in which to reserve
+ * space.
+ *
+ * @param xMaxBytes The maximum number of bytes to reserve.
+ *
+ * @param pxSegments Used to return the reserved space.  If no space is
+ * reserved both segments are NULL.
+ *
+ * @param xTicksToWait The maximum amount of time the task should remain in
+ * the Blocked state to wait for xMaxBytes bytes of space to become available,
+ * as for xStreamBufferSend().  If xTicksToWait is 0 the function returns
+ * immediately.
+ *
+ * @return The number of bytes reserved, which is the total length of the
+ * two segments.  This can be less than xMaxBytes if the call timed out before
+ * xMaxBytes bytes were free.
+ *
+ * Example use:
+ * @code{c}
+ * void vAFunction( StreamBufferHandle_t xStreamBuffer )
+ * {
+ * StreamBufferSegments_t xSegments;
+ * size_t xReserved;
+ *
+ *  // Reserve up to 64 bytes, waiting up to 100ms for them to be free.
+ *  xReserved = xStreamBufferReserve( xStreamBuffer, 64, &xSegments, pdMS_TO_TICKS( 100 ) );
+ *
+ *  if( xReserved > 0 )
+ *  {
+ *      // Generate data directly into the stream buffer.
+ *      vFillData( xSegments.pucFirst, xSegments.xFirstLength );
+ *
+ *      if( xSegments.pucSecond != NULL )
+ *      {
+ *          vFillData( xSegments.pucSecond, xSegments.xSecondLength );
+ *      }
+ *
+ *      // Make the data available to the reader.
+ *      xStreamBufferCommit( xStreamBuffer, xReserved );
+ *  }
+ * }
+ * @endcode
+ * \defgroup xStreamBufferReserve xStreamBufferReserve
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferReserve( StreamBufferHandle_t xStreamBuffer,
+                             size_t xMaxBytes,
+                             StreamBufferSegments_t * const pxSegments,
+                             TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+ * @code{c}
+ * size_t xStreamBufferCommit( StreamBufferHandle_t xStreamBuffer,
+ *                             size_t xBytesWritten );
+ * @endcode
+ *
+ * Makes bytes written into space returned by xStreamBufferReserve() available
+ * to the reader, unblocking the reader if the trigger level is reached, as
+ * xStreamBufferSend() does.  The bytes committed are the first xBytesWritten
+ * bytes of the reserved space.
+ *
+ * If the stream buffer is a message buffer then xBytesWritten bytes are
+ * committed as a single message.  Committing zero bytes does nothing.
+ *
+ * Use xStreamBufferCommit() to commit from a task, and
+ * xStreamBufferCommitFromISR() to commit from an interrupt service routine.
+ *
+ * configUSE_STREAM_BUFFERS must be set to 1 in for FreeRTOSConfig.h for
+ * xStreamBufferCommit() to be available.
+ *
+ * @param xStreamBuffer The handle of the stream buffer being written to.
+ *
+ * @param xBytesWritten The number of bytes written.  This must not be more
+ * than the number of bytes returned by the most recent call to
+ * xStreamBufferReserve().
+ *
+ * @return The number of bytes committed.
+ *
+ * \defgroup xStreamBufferCommit xStreamBufferCommit
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferCommit( StreamBufferHandle_t xStreamBuffer,
+                            size_t xBytesWritten ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+ * @code{c}
+ * size_t xStreamBufferCommitFromISR( StreamBufferHandle_t xStreamBuffer,
+ *                                    size_t xBytesWritten,
+ *                                    BaseType_t * const pxHigherPriorityTaskWoken );
+ * @endcode
+ *
+ * A version of xStreamBufferCommit() that can be called from an interrupt
+ * service routine.
+ *
+ * @param xStreamBuffer The handle of the stream buffer being written to.
+ *
+ * @param xBytesWritten The number of bytes written.  This must not be more
+ * than the number of bytes returned by the most recent call to
+ * xStreamBufferReserve().
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if committing the data
+ * unblocked a task that has a priority above the currently executing task, in
+ * which case a context switch should be requested before the interrupt is
+ * exited, as for xStreamBufferSendFromISR().
+ *
+ * @return The number of bytes committed.
+ *
+ * \defgroup xStreamBufferCommitFromISR xStreamBufferCommitFromISR
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferCommitFromISR( StreamBufferHandle_t xStreamBuffer,
+                                   size_t xBytesWritten,
+                                   BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
 /**
  * stream_buffer.h
  *
@@ -879,6 +1047,153 @@ size_t xStreamBufferReceiveFromISR( StreamBufferHandle_t xStreamBuffer,
                                     size_t xBufferLengthBytes,
                                     BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
 
+/**
+ * stream_buffer.h
+ *
+ * @code{c}
+ * size_t xStreamBufferPeekContiguous( StreamBufferHandle_t xStreamBuffer,
+ *                                     StreamBufferSegments_t * const pxSegments,
+ *                                     TickType_t xTicksToWait );
+ * @endcode
+ *
+ * Returns the data in a stream buffer in place, so the reader can process it
+ * without first copying it out with xStreamBufferReceive().  The data is not
+ * removed from the stream buffer until xStreamBufferConsume() or
+ * xStreamBufferConsumeFromISR() is called.
+ *
+ * The data may wrap around the end of the storage area, so it is returned as
+ * up to two segments in *pxSegments.  The data at pxSegments->pucFirst comes
+ * before the data at pxSegments->pucSecond.
+ *
+ * If the stream buffer is a stream buffer or a stream batching buffer all the
+ * bytes in the buffer are returned.  If the stream buffer is a message buffer
+ * only the next message is returned.  Data cannot be peeked from an MPSC
+ * message buffer.
+ *
+ * As with xStreamBufferReceive(), only one task or interrupt can read from a
+ * stream buffer at a time, and the reader must not call any other receive
+ * function between peeking data and consuming it.
+ *
+ * xStreamBufferPeekContiguous() can be called from an interrupt service
+ * routine if xTicksToWait is 0.
+ *
+ * configUSE_STREAM_BUFFERS must be set to 1 in for FreeRTOSConfig.h for
+ * xStreamBufferPeekContiguous() to be available.
+ *
+ * @param xStreamBuffer The handle of the stream buffer from which data is to
+ * be peeked.
+ *
+ * @param pxSegments Used to return the data.  If there is no data both
+ * segments are NULL.
+ *
+ * @param xTicksToWait The maximum amount of time the task should remain in
+ * the Blocked state to wait for data to become available, as for
+ * xStreamBufferReceive().  If xTicksToWait is 0 the function returns
+ * immediately.
+ *
+ * @return The number of bytes returned, which is the total length of the two
+ * segments.
+ *
+ * Example use:
+ * @code{c}
+ * void vAFunction( StreamBufferHandle_t xStreamBuffer )
+ * {
+ * StreamBufferSegments_t xSegments;
+ * size_t xAvailable;
+ *
+ *  // Wait up to 100ms for data.
+ *  xAvailable = xStreamBufferPeekContiguous( xStreamBuffer, &xSegments, pdMS_TO_TICKS( 100 ) );
+ *
+ *  if( xAvailable > 0 )
+ *  {
+ *      // Process the data where it is.
+ *      vProcessData( xSegments.pucFirst, xSegments.xFirstLength );
+ *
+ *      if( xSegments.pucSecond != NULL )
+ *      {
+ *          vProcessData( xSegments.pucSecond, xSegments.xSecondLength );
+ *      }
+ *
+ *      // Free the space the data occupied.
+ *      xStreamBufferConsume( xStreamBuffer, xAvailable );
+ *  }
+ * }
+ * @endcode
+ * \defgroup xStreamBufferPeekContiguous xStreamBufferPeekContiguous
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferPeekContiguous( StreamBufferHandle_t xStreamBuffer,
+                                    StreamBufferSegments_t * const pxSegments,
+                                    TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+ * @code{c}
+ * size_t xStreamBufferConsume( StreamBufferHandle_t xStreamBuffer,
+ *                              size_t xBytesRead );
+ * @endcode
+ *
+ * Removes data returned by xStreamBufferPeekContiguous() from a stream
+ * buffer, unblocking a task waiting for space, as xStreamBufferReceive() does.
+ * The bytes removed are the first xBytesRead bytes of the data returned.
+ *
+ * If the stream buffer is a message buffer the whole message is removed, so
+ * xBytesRead must be the length of the message.
+ *
+ * Use xStreamBufferConsume() to consume data from a task, and
+ * xStreamBufferConsumeFromISR() to consume data from an interrupt service
+ * routine.
+ *
+ * configUSE_STREAM_BUFFERS must be set to 1 in for FreeRTOSConfig.h for
+ * xStreamBufferConsume() to be available.
+ *
+ * @param xStreamBuffer The handle of the stream buffer being read from.
+ *
+ * @param xBytesRead The number of bytes read.  This must not be more than the
+ * number of bytes returned by the most recent call to
+ * xStreamBufferPeekContiguous().
+ *
+ * @return The number of bytes removed, not counting the length of a message.
+ *
+ * \defgroup xStreamBufferConsume xStreamBufferConsume
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferConsume( StreamBufferHandle_t xStreamBuffer,
+                             size_t xBytesRead ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+ * @code{c}
+ * size_t xStreamBufferConsumeFromISR( StreamBufferHandle_t xStreamBuffer,
+ *                                     size_t xBytesRead,
+ *                                     BaseType_t * const pxHigherPriorityTaskWoken );
+ * @endcode
+ *
+ * A version of xStreamBufferConsume() that can be called from an interrupt
+ * service routine.
+ *
+ * @param xStreamBuffer The handle of the stream buffer being read from.
+ *
+ * @param xBytesRead The number of bytes read.  This must not be more than the
+ * number of bytes returned by the most recent call to
+ * xStreamBufferPeekContiguous().
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if removing the data
+ * unblocked a task that has a priority above the currently executing task, in
+ * which case a context switch should be requested before the interrupt is
+ * exited, as for xStreamBufferReceiveFromISR().
+ *
+ * @return The number of bytes removed, not counting the length of a message.
+ *
+ * \defgroup xStreamBufferConsumeFromISR xStreamBufferConsumeFromISR
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferConsumeFromISR( StreamBufferHandle_t xStreamBuffer,
+                                    size_t xBytesRead,
+                                    BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
 /**
  * stream_buffer.h
  *
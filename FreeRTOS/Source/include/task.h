@@ -101,9 +101,11 @@ typedef const struct tskTaskControlBlock   * ConstTaskHandle_t;
  */
 typedef BaseType_t (* TaskHookFunction_t)( void * arg );
 
+/* The parameter of a task created at a priority owned by the EDF scheduler.
+ * The parameter of a task created at any other priority is not read by the
+ * kernel. */
 typedef struct pvParameter
 {
-    UBaseType_t uxWeight;
     TickType_t uxDeadLine;
 } pvParameter_t;
 
@@ -184,8 +186,32 @@ typedef struct xTASK_STATUS
     #if ( ( configUSE_CORE_AFFINITY == 1 ) && ( configNUMBER_OF_CORES > 1 ) )
         UBaseType_t uxCoreAffinityMask;           /* The core affinity mask for the task */
     #endif
+    #if ( configUSE_EDF_SCHEDULER == 1 )
+        UBaseType_t uxDeadlineMisses;             /* The number of activations of the task that have missed their deadline.  Only valid if configUSE_EDF_SCHEDULER is defined as 1 in FreeRTOSConfig.h. */
+        TickType_t xMaxLateness;                  /* The largest number of ticks by which an activation of the task has completed after its deadline.  Only valid if configUSE_EDF_SCHEDULER is defined as 1 in FreeRTOSConfig.h. */
+    #endif
 } TaskStatus_t;
 
+/* Used with the uxTaskGetDeadlineMissEvents() function to return the deadline
+ * misses recorded by the kernel. */
+typedef struct xDEADLINE_MISS_EVENT
+{
+    UBaseType_t uxEventNumber; /* Incremented for each miss, so a gap between consecutive events shows how many were overwritten before they were read. */
+    TaskHandle_t xHandle;      /* The handle of the task that missed its deadline. */
+    TickType_t xDeadline;      /* The absolute deadline that was missed. */
+    TickType_t xTickCount;     /* The tick count at which the miss was detected. */
+} DeadlineMissEvent_t;
+
+/* Used with the vTaskSetMLFQPolicy() function to set the priorities used as
+ * MLFQ levels, the time slice of each level and the priority boost period. */
+typedef struct xMLFQ_POLICY
+{
+    UBaseType_t uxHighestPriority;         /* The priority of the top MLFQ level. */
+    UBaseType_t uxNumberOfLevels;          /* The number of MLFQ levels, each one priority below the last. */
+    const TickType_t * pxLevelTimeSlices;  /* uxNumberOfLevels time slices in ticks, starting with the top level. */
+    TickType_t xBoostPeriod;               /* The number of ticks between priority boosts. */
+} MLFQPolicy_t;
+
 /* Possible return values for eTaskConfirmSleepModeStatus(). */
 typedef enum
 {
@@ -535,6 +561,196 @@ typedef enum
                                                UBaseType_t uxCoreAffinityMask ) PRIVILEGED_FUNCTION;
 #endif
 
+/**
+ * task. h
+ * @code{c}
+ * BaseType_t xTaskCreateMLFQ( TaskFunction_t pxTaskCode,
+ *                             const char * const pcName,
+ *                             const configSTACK_DEPTH_TYPE uxStackDepth,
+ *                             void *pvParameters,
+ *                             TaskHandle_t *pxCreatedTask );
+ *
+ * TaskHandle_t xTaskCreateMLFQStatic( TaskFunction_t pxTaskCode,
+ *                                     const char * const pcName,
+ *                                     const configSTACK_DEPTH_TYPE uxStackDepth,
+ *                                     void *pvParameters,
+ *                                     StackType_t *puxStackBuffer,
+ *                                     StaticTask_t *pxTaskBuffer );
+ * @endcode
+ *
+ * Only available when configUSE_MLFQ_SCHEDULER is set to 1.
+ *
+ * Create a task that is scheduled by the multi-level feedback queue (MLFQ)
+ * scheduler, and add it to the list of tasks that are ready to run.  The
+ * parameters and return values are the same as those of xTaskCreate() and
+ * xTaskCreateStatic(), except that there is no priority parameter.
+ *
+ * The task starts on the top MLFQ level, which is priority
+ * configMLFQ_HIGHEST_PRIORITY (configMAX_PRIORITIES - 1 by default).  Each time
+ * the task uses up the time allowed on a level it is moved to the level below,
+ * until it reaches priority configMLFQ_LOWEST_PRIORITY (1 by default), and all
+ * MLFQ tasks are moved back to the top level every configMLFQ_LOOP_TIME_SLICE
+ * ticks.  The levels, their time slices and the boost period can be changed at
+ * run time by calling vTaskSetMLFQPolicy().
+ *
+ * If configMLFQ_USE_RUN_TIME_ACCOUNTING is set to 1 then the time used by a
+ * task is measured with the run time statistics counter each time the task is
+ * switched out, so a task that blocks or yields before each tick interrupt is
+ * still charged for the time it uses.  Otherwise a task is charged one tick for
+ * each tick interrupt that occurs while it is running.
+ *
+ * Tasks created by other functions keep the priority they are created with,
+ * even if that priority is within the range used by the MLFQ levels.
+ *
+ * \defgroup xTaskCreateMLFQ xTaskCreateMLFQ
+ * \ingroup Tasks
+ */
+#if ( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configUSE_MLFQ_SCHEDULER == 1 ) )
+    BaseType_t xTaskCreateMLFQ( TaskFunction_t pxTaskCode,
+                                const char * const pcName,
+                                const configSTACK_DEPTH_TYPE uxStackDepth,
+                                void * const pvParameters,
+                                TaskHandle_t * const pxCreatedTask ) PRIVILEGED_FUNCTION;
+#endif
+
+#if ( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configUSE_MLFQ_SCHEDULER == 1 ) )
+    TaskHandle_t xTaskCreateMLFQStatic( TaskFunction_t pxTaskCode,
+                                        const char * const pcName,
+                                        const configSTACK_DEPTH_TYPE uxStackDepth,
+                                        void * const pvParameters,
+                                        StackType_t * const puxStackBuffer,
+                                        StaticTask_t * const pxTaskBuffer ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * task. h
+ * @code{c}
+ * void vTaskSetMLFQPolicy( const MLFQPolicy_t * const pxPolicy );
+ * @endcode
+ *
+ * Only available when configUSE_MLFQ_SCHEDULER is set to 1.
+ *
+ * Change the priorities used as MLFQ levels, the time slice of each level and
+ * the period of the priority boost.  The MLFQ levels are the
+ * pxPolicy->uxNumberOfLevels priorities from pxPolicy->uxHighestPriority
+ * downwards, which must all be above the idle priority.  Priorities above the
+ * band remain available to tasks created with xTaskCreate(), which are never
+ * preempted by an MLFQ task.
+ *
+ * pxPolicy->pxLevelTimeSlices points to one time slice, in ticks, per level,
+ * starting with the top level.  The time slices are copied, so the array does
+ * not need to persist after the call.  pxPolicy->xBoostPeriod is the number of
+ * ticks between priority boosts.
+ *
+ * Changing the policy starts a priority boost, so every MLFQ task is moved to
+ * the top level of the new band and starts a new time slice.  Before the first
+ * call the MLFQ levels are the priorities configMLFQ_LOWEST_PRIORITY to
+ * configMLFQ_HIGHEST_PRIORITY, each level's time slice is
+ * configMLFQ_UNIT_TIME_SLICE ticks longer than the level above, starting with
+ * configMLFQ_UNIT_TIME_SLICE ticks at the top level, and the boost period is
+ * configMLFQ_LOOP_TIME_SLICE.  The band must not overlap the priorities owned
+ * by the EDF or weighted round robin schedulers, if they are also in use.
+ *
+ * @param pxPolicy The new policy.
+ *
+ * Example usage:
+ * @code{c}
+ * // Use priorities 2 to 5 as MLFQ levels, leaving priority 6 for a task
+ * // that must not be delayed by MLFQ tasks.
+ * static const TickType_t xTimeSlices[] = { 2, 4, 8, 16 };
+ *
+ * void vAFunction( void )
+ * {
+ * MLFQPolicy_t xPolicy;
+ *
+ *   xPolicy.uxHighestPriority = 5;
+ *   xPolicy.uxNumberOfLevels = 4;
+ *   xPolicy.pxLevelTimeSlices = xTimeSlices;
+ *   xPolicy.xBoostPeriod = pdMS_TO_TICKS( 500 );
+ *
+ *   vTaskSetMLFQPolicy( &xPolicy );
+ * }
+ * @endcode
+ * \defgroup vTaskSetMLFQPolicy vTaskSetMLFQPolicy
+ * \ingroup Tasks
+ */
+#if ( configUSE_MLFQ_SCHEDULER == 1 )
+    void vTaskSetMLFQPolicy( const MLFQPolicy_t * const pxPolicy ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * task. h
+ * @code{c}
+ * void vTaskSetWeight( TaskHandle_t xTask, UBaseType_t uxWeight );
+ * @endcode
+ *
+ * Only available when configUSE_WEIGHTED_ROUND_ROBIN is set to 1.
+ *
+ * Set the weight of a task.  Tasks of the same priority share the processor in
+ * proportion to their weights, so a task with a weight of 2 receives twice the
+ * processor time of a task with a weight of 1 while both are ready.  Tasks are
+ * created with a weight of 1.  The weight is only used while the priority of
+ * the task is between configWRR_LOWEST_PRIORITY and configWRR_HIGHEST_PRIORITY,
+ * which by default are the lowest and highest priorities.
+ *
+ * Each task has a virtual run time, which is advanced at every tick the task
+ * runs for by an amount inversely proportional to its weight.  The task with
+ * the smallest virtual run time is selected from the ready tasks of the
+ * highest priority, and runs for configSLICE_INTERVAL ticks before the
+ * selection is made again.  The virtual run times of tasks of the same
+ * priority that remain ready therefore never differ by more than the virtual
+ * run time of one configSLICE_INTERVAL at the lowest weight.  A task that
+ * becomes ready is given at least the smallest virtual run time of its
+ * priority, so it gains no credit for the time it was not ready.
+ *
+ * @param xTask Handle to the task whose weight is being set.  Passing a NULL
+ * handle results in the weight of the calling task being set.
+ *
+ * @param uxWeight The weight, from 1 to configWRR_MAX_WEIGHT.
+ *
+ * Example usage:
+ * @code{c}
+ * void vAFunction( void )
+ * {
+ * TaskHandle_t xHandle;
+ *
+ *   // Create two tasks at the same priority, and give the first twice the
+ *   // processor time of the second.
+ *   xTaskCreate( vTaskCode, "Large", STACK_SIZE, NULL, tskIDLE_PRIORITY + 1, &xHandle );
+ *   vTaskSetWeight( xHandle, 2 );
+ *   xTaskCreate( vTaskCode, "Small", STACK_SIZE, NULL, tskIDLE_PRIORITY + 1, NULL );
+ * }
+ * @endcode
+ * \defgroup vTaskSetWeight vTaskSetWeight
+ * \ingroup TaskCtrl
+ */
+#if ( configUSE_WEIGHTED_ROUND_ROBIN == 1 )
+    void vTaskSetWeight( TaskHandle_t xTask,
+                         UBaseType_t uxWeight ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * task. h
+ * @code{c}
+ * UBaseType_t uxTaskGetWeight( const TaskHandle_t xTask );
+ * @endcode
+ *
+ * Only available when configUSE_WEIGHTED_ROUND_ROBIN is set to 1.
+ *
+ * Obtain the weight of any task.
+ *
+ * @param xTask Handle of the task to be queried.  Passing a NULL handle results
+ * in the weight of the calling task being returned.
+ *
+ * @return The weight of xTask, as set by vTaskSetWeight().
+ *
+ * \defgroup uxTaskGetWeight uxTaskGetWeight
+ * \ingroup TaskCtrl
+ */
+#if ( configUSE_WEIGHTED_ROUND_ROBIN == 1 )
+    UBaseType_t uxTaskGetWeight( const TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
+#endif
+
 /**
  * task. h
  * @code{c}
@@ -2462,6 +2678,99 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery ) PRIVILEGED_FUNCTION;
     configRUN_TIME_COUNTER_TYPE ulTaskGetRunTimePercent( const TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
 #endif
 
+/**
+ * task. h
+ * @code{c}
+ * UBaseType_t uxTaskGetDeadlineStats( TaskHandle_t xTask, TickType_t * const pxMaxLateness );
+ * @endcode
+ *
+ * configUSE_EDF_SCHEDULER must be defined as 1 for this function to be
+ * available.
+ *
+ * The tick interrupt counts a deadline miss against a task the first time it
+ * finds the task running after its absolute deadline.  A task whose deadline
+ * passed without the tick interrupt finding it running, for example because it
+ * was kept ready by other tasks and then ran for less than a tick, has the
+ * miss counted when it next blocks.  The lateness of the activation is also
+ * recorded when the task next blocks.  Recording a miss costs a few
+ * instructions and does not perform any I/O from the tick interrupt.
+ *
+ * @param xTask Handle of the task being queried.  Passing NULL queries the
+ * calling task.
+ *
+ * @param pxMaxLateness If not NULL, set to the largest number of ticks by
+ * which an activation of the task has completed after its deadline.
+ *
+ * @return The number of activations of the task that have missed their
+ * deadline.
+ *
+ * \defgroup uxTaskGetDeadlineStats uxTaskGetDeadlineStats
+ * \ingroup TaskUtils
+ */
+#if ( configUSE_EDF_SCHEDULER == 1 )
+    UBaseType_t uxTaskGetDeadlineStats( TaskHandle_t xTask,
+                                        TickType_t * const pxMaxLateness ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * task. h
+ * @code{c}
+ * UBaseType_t uxTaskGetDeadlineMissEvents( DeadlineMissEvent_t * const pxEventArray, const UBaseType_t uxArraySize, UBaseType_t * const puxNextEvent );
+ * @endcode
+ *
+ * configUSE_EDF_SCHEDULER must be defined as 1, and
+ * configDEADLINE_MISS_EVENT_BUFFER_LENGTH must be greater than 0, for this
+ * function to be available.
+ *
+ * The kernel keeps the last configDEADLINE_MISS_EVENT_BUFFER_LENGTH deadline
+ * misses in a ring that is written by the tick interrupt, or by a task that
+ * blocks after missing its deadline, one writer at a time.
+ * uxTaskGetDeadlineMissEvents() copies the events that have been recorded
+ * since the event numbered *puxNextEvent, oldest first.  It does not disable
+ * interrupts or suspend the scheduler, and may be called by more than one
+ * reader as each reader keeps its own position.
+ *
+ * @param pxEventArray Array into which the events are copied.
+ *
+ * @param uxArraySize The number of events pxEventArray can hold.
+ *
+ * @param puxNextEvent The number of the first event to read.  Set this to 0
+ * before the first call.  It is updated to the number of the next event to
+ * read.  If the events requested have already been overwritten then the oldest
+ * events still held are returned instead.
+ *
+ * @return The number of events copied into pxEventArray.
+ *
+ * Example usage:
+ * @code{c}
+ * void vMonitorTask( void * pvParameters )
+ * {
+ * DeadlineMissEvent_t xEvents[ 8 ];
+ * UBaseType_t uxNext = 0, uxCount, ux;
+ *
+ *   for( ;; )
+ *   {
+ *       uxCount = uxTaskGetDeadlineMissEvents( xEvents, 8, &uxNext );
+ *
+ *       for( ux = 0; ux < uxCount; ux++ )
+ *       {
+ *           // Log xEvents[ ux ] here.
+ *       }
+ *
+ *       vTaskDelay( pdMS_TO_TICKS( 1000 ) );
+ *   }
+ * }
+ * @endcode
+ *
+ * \defgroup uxTaskGetDeadlineMissEvents uxTaskGetDeadlineMissEvents
+ * \ingroup TaskUtils
+ */
+#if ( ( configUSE_EDF_SCHEDULER == 1 ) && ( configDEADLINE_MISS_EVENT_BUFFER_LENGTH > 0 ) )
+    UBaseType_t uxTaskGetDeadlineMissEvents( DeadlineMissEvent_t * const pxEventArray,
+                                             const UBaseType_t uxArraySize,
+                                             UBaseType_t * const puxNextEvent ) PRIVILEGED_FUNCTION;
+#endif
+
 /**
  * task. h
  * @code{c}
@@ -3687,6 +3996,15 @@ void vTaskPriorityDisinheritAfterTimeout( TaskHandle_t const pxMutexHolder,
  */
 TaskHandle_t pvTaskIncrementMutexHeldCount( void ) PRIVILEGED_FUNCTION;
 
+/*
+ * For internal use only.  Return the location in the calling task's TCB that
+ * heap_4.c holds the task's heap cache in, or NULL if the scheduler has not
+ * been started.
+ */
+#if ( configUSE_HEAP_CACHE == 1 )
+    void ** ppvTaskGetHeapCache( void ) PRIVILEGED_FUNCTION;
+#endif
+
 /*
  * For internal use only.  Same as vTaskSetTimeOutState(), but without a critical
  * section.
@@ -3775,7 +4093,7 @@ void vTaskInternalSetTimeOutState( TimeOut_t * const pxTimeOut ) PRIVILEGED_FUNC
 
 #endif /* #if ( ( portUSING_MPU_WRAPPERS == 1 ) && ( configUSE_MPU_WRAPPERS_V1 == 0 ) && ( configENABLE_ACCESS_CONTROL_LIST == 1 ) ) */
 
-	unsigned long task_ADD_DEADLINE( void * );
+	TickType_t task_ADD_DEADLINE( void * pxTCB );
 
 /* *INDENT-OFF* */
 #ifdef __cplusplus
@@ -663,6 +663,12 @@ TaskHandle_t xTimerGetTimerDaemonTaskHandle( void ) PRIVILEGED_FUNCTION;
  * service/daemon task priority is set by the configTIMER_TASK_PRIORITY
  * configuration constant.
  *
+ * When a timer callback function calls a timer API function while the timer
+ * command queue is empty, the timer service/daemon task can carry out the
+ * command without sending it through the queue.  A timer deleted from a timer
+ * callback function can therefore already be deleted, and its memory freed,
+ * when xTimerDelete() returns.
+ *
  * Example usage:
  *
  * See the xTimerChangePeriod() API function example usage scenario.
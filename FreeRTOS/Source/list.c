@@ -77,6 +77,13 @@ void vListInitialise( List_t * const pxList )
 
     pxList->uxNumberOfItems = ( UBaseType_t ) 0U;
 
+    #if ( listUSE_DEADLINE_HEAP == 1 )
+    {
+        /* A NULL root marks the list as not (yet) holding a deadline heap. */
+        pxList->pxHeapRoot = NULL;
+    }
+    #endif
+
     /* Write known values into the list if
      * configUSE_LIST_DATA_INTEGRITY_CHECK_BYTES is set to 1. */
     listSET_LIST_INTEGRITY_CHECK_1_VALUE( pxList );
@@ -222,6 +229,8 @@ UBaseType_t uxListRemove( ListItem_t * const pxItemToRemove )
 
     traceENTER_uxListRemove( pxItemToRemove );
 
+    listREMOVE_DEADLINE_HEAP_ITEM( pxList, pxItemToRemove );
+
     pxItemToRemove->pxNext->pxPrevious = pxItemToRemove->pxPrevious;
     pxItemToRemove->pxPrevious->pxNext = pxItemToRemove->pxNext;
 
@@ -247,38 +256,186 @@ UBaseType_t uxListRemove( ListItem_t * const pxItemToRemove )
 }
 /*-----------------------------------------------------------*/
 
+#if ( listUSE_DEADLINE_HEAP == 1 )
 
-/******************* For EDF Scheduling *******************/
-void vListInsertOverFlow( List_t * const pxList, ListItem_t * const pxNewListItem )
-{
-volatile ListItem_t *pxIterator;
-TickType_t xValueOfInsertion;
-
-	/* Insert the new list item into the list, sorted in ulListItem order. */
-	xValueOfInsertion = pxNewListItem->xItemValue;
-
-	if( xValueOfInsertion == portMAX_DELAY )
-	{
-		pxIterator = pxList->xListEnd.pxPrevious;
-	}
-	else
-	{
-		for( pxIterator = ( ListItem_t * ) &( pxList->xListEnd ); ( ( pxIterator->pxNext->xItemValue <= xValueOfInsertion ) || ( pxIterator->pxNext->xItemValue > 0xF0000000 && pxIterator->pxNext->xItemValue != 0xFFFFFFFF )); pxIterator = pxIterator->pxNext )
-		{
-			/* There is nothing to do here, we are just iterating to the
-			wanted insertion position. */
-		}
-	}
-
-	pxNewListItem->pxNext = pxIterator->pxNext;
-	pxNewListItem->pxNext->pxPrevious = ( volatile ListItem_t * ) pxNewListItem;
-	pxNewListItem->pxPrevious = pxIterator;
-	pxIterator->pxNext = ( volatile ListItem_t * ) pxNewListItem;
-
-	/* Remember which list the item is in.  This allows fast removal of the
-	item later. */
-	pxNewListItem->pxContainer = ( void * ) pxList;
-
-	( pxList->uxNumberOfItems )++;
-}
-/*-----------------------------------------------------------*/
\ No newline at end of file
+/*
+ * Link two heap roots together, making the root with the later deadline the
+ * leftmost child of the root with the earlier deadline.  If the deadlines are
+ * equal pxFirst remains the root, so items that were inserted first are
+ * returned first.  Returns the resultant root.
+ */
+    static ListItem_t * prvDeadlineHeapLink( ListItem_t * pxFirst,
+                                             ListItem_t * pxSecond ) PRIVILEGED_FUNCTION;
+
+/*
+ * Combine a chain of sibling subtrees into a single heap using the standard
+ * two pass pairing heap merge, without recursion so stack usage is bounded.
+ * Returns the root of the combined heap, or NULL if the chain is empty.
+ */
+    static ListItem_t * prvDeadlineHeapMergePairs( ListItem_t * pxFirstSibling ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+    static ListItem_t * prvDeadlineHeapLink( ListItem_t * pxFirst,
+                                             ListItem_t * pxSecond )
+    {
+        ListItem_t * pxParent;
+        ListItem_t * pxChild;
+
+        if( listDEADLINE_PRECEDES( pxSecond->xItemValue, pxFirst->xItemValue ) != pdFALSE )
+        {
+            pxParent = pxSecond;
+            pxChild = pxFirst;
+        }
+        else
+        {
+            pxParent = pxFirst;
+            pxChild = pxSecond;
+        }
+
+        pxChild->pxHeapSibling = pxParent->pxHeapChild;
+
+        if( pxParent->pxHeapChild != NULL )
+        {
+            pxParent->pxHeapChild->pxHeapPrevious = pxChild;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        pxChild->pxHeapPrevious = pxParent;
+        pxParent->pxHeapChild = pxChild;
+        pxParent->pxHeapSibling = NULL;
+        pxParent->pxHeapPrevious = NULL;
+
+        return pxParent;
+    }
+/*-----------------------------------------------------------*/
+
+    static ListItem_t * prvDeadlineHeapMergePairs( ListItem_t * pxFirstSibling )
+    {
+        ListItem_t * pxPairs = NULL;
+        ListItem_t * pxRoot = NULL;
+        ListItem_t * pxFirst;
+        ListItem_t * pxSecond;
+
+        /* First pass - link the siblings together in pairs from left to right,
+         * pushing each resultant subtree onto a stack that is threaded through
+         * the sibling pointers. */
+        while( pxFirstSibling != NULL )
+        {
+            pxFirst = pxFirstSibling;
+            pxSecond = pxFirst->pxHeapSibling;
+
+            if( pxSecond != NULL )
+            {
+                pxFirstSibling = pxSecond->pxHeapSibling;
+                pxFirst = prvDeadlineHeapLink( pxFirst, pxSecond );
+            }
+            else
+            {
+                pxFirstSibling = NULL;
+            }
+
+            pxFirst->pxHeapSibling = pxPairs;
+            pxPairs = pxFirst;
+        }
+
+        /* Second pass - link the subtrees from right to left, which is the
+         * order in which they come off the stack. */
+        while( pxPairs != NULL )
+        {
+            pxFirst = pxPairs;
+            pxPairs = pxPairs->pxHeapSibling;
+            pxFirst->pxHeapSibling = NULL;
+
+            if( pxRoot == NULL )
+            {
+                pxRoot = pxFirst;
+                pxRoot->pxHeapPrevious = NULL;
+            }
+            else
+            {
+                pxRoot = prvDeadlineHeapLink( pxRoot, pxFirst );
+            }
+        }
+
+        return pxRoot;
+    }
+/*-----------------------------------------------------------*/
+
+    void vListInsertDeadline( List_t * const pxList,
+                              ListItem_t * const pxNewListItem )
+    {
+        /* The item is linked into the list itself without sorting, so the list
+         * length, emptiness and membership tests behave exactly as they do for
+         * any other list. */
+        listINSERT_END( pxList, pxNewListItem );
+
+        pxNewListItem->pxHeapChild = NULL;
+        pxNewListItem->pxHeapSibling = NULL;
+        pxNewListItem->pxHeapPrevious = NULL;
+
+        if( pxList->pxHeapRoot == NULL )
+        {
+            pxList->pxHeapRoot = pxNewListItem;
+        }
+        else
+        {
+            pxList->pxHeapRoot = prvDeadlineHeapLink( pxList->pxHeapRoot, pxNewListItem );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    void vListRemoveDeadline( List_t * const pxList,
+                              ListItem_t * const pxItemToRemove )
+    {
+        ListItem_t * pxSubtree;
+
+        if( pxItemToRemove == pxList->pxHeapRoot )
+        {
+            pxList->pxHeapRoot = prvDeadlineHeapMergePairs( pxItemToRemove->pxHeapChild );
+        }
+        else
+        {
+            /* Detach the item, along with its children, from its parent or
+             * from its previous sibling. */
+            if( pxItemToRemove->pxHeapPrevious->pxHeapChild == pxItemToRemove )
+            {
+                pxItemToRemove->pxHeapPrevious->pxHeapChild = pxItemToRemove->pxHeapSibling;
+            }
+            else
+            {
+                pxItemToRemove->pxHeapPrevious->pxHeapSibling = pxItemToRemove->pxHeapSibling;
+            }
+
+            if( pxItemToRemove->pxHeapSibling != NULL )
+            {
+                pxItemToRemove->pxHeapSibling->pxHeapPrevious = pxItemToRemove->pxHeapPrevious;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            /* Then merge the children of the item back into the heap. */
+            pxSubtree = prvDeadlineHeapMergePairs( pxItemToRemove->pxHeapChild );
+
+            if( pxSubtree != NULL )
+            {
+                pxList->pxHeapRoot = prvDeadlineHeapLink( pxList->pxHeapRoot, pxSubtree );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+
+        pxItemToRemove->pxHeapChild = NULL;
+        pxItemToRemove->pxHeapSibling = NULL;
+        pxItemToRemove->pxHeapPrevious = NULL;
+    }
+
+#endif /* listUSE_DEADLINE_HEAP == 1 */
+/*-----------------------------------------------------------*/
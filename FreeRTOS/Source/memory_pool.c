@@ -0,0 +1,716 @@
+/*
+ * FreeRTOS Kernel <DEVELOPMENT BRANCH>
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/* Standard includes. */
+#include <stdlib.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers. That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "memory_pool.h"
+
+/* The MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
+ * for the header files above, but not in this file, in order to generate the
+ * correct privileged Vs unprivileged linkage and placement. */
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* This entire source file will be skipped if the application is not configured
+ * to include memory pool functionality. This #if is closed at the very bottom
+ * of this file. If you want to include memory pools then ensure
+ * configUSE_MEMORY_POOLS is set to 1 in FreeRTOSConfig.h. */
+#if ( configUSE_MEMORY_POOLS == 1 )
+
+/* Constants used with the cLock member of Pool_t. */
+    #define poolUNLOCKED             ( ( int8_t ) -1 )
+    #define poolLOCKED_UNMODIFIED    ( ( int8_t ) 0 )
+    #define poolINT8_MAX             ( ( int8_t ) 127 )
+
+/* Max value that fits in a size_t type. */
+    #define poolSIZE_MAX             ( ~( ( size_t ) 0 ) )
+
+    #if ( configUSE_PREEMPTION == 0 )
+
+/* If the cooperative scheduler is being used then a yield should not be
+ * performed just because a higher priority task has been woken. */
+        #define poolYIELD_IF_USING_PREEMPTION()
+    #else
+        #if ( configNUMBER_OF_CORES == 1 )
+            #define poolYIELD_IF_USING_PREEMPTION()    portYIELD_WITHIN_API()
+        #else /* #if ( configNUMBER_OF_CORES == 1 ) */
+            #define poolYIELD_IF_USING_PREEMPTION()    vTaskYieldWithinAPI()
+        #endif /* #if ( configNUMBER_OF_CORES == 1 ) */
+    #endif
+
+    typedef struct PoolDefinition
+    {
+        void * pvFirstFreeBlock;           /**< The first free block, or NULL if there are none.  The first bytes of each free block point to the next. */
+        uint8_t * pucStorage;              /**< The first block in the pool. */
+        size_t xBlockSize;                 /**< The size of each block, as returned by poolBLOCK_SIZE(). */
+        UBaseType_t uxNumberOfBlocks;      /**< The number of blocks in the pool. */
+        volatile UBaseType_t uxFreeBlocks; /**< The number of blocks that are free. */
+        List_t xTasksWaitingToAllocate;    /**< Tasks blocked waiting for a block to be freed, in priority order. */
+        volatile int8_t cLock;             /**< The number of blocks freed by interrupts while the pool was locked, or poolUNLOCKED if the pool is not locked. */
+
+        #if ( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+            uint8_t ucStaticallyAllocated; /**< Set to pdTRUE if the pool is statically allocated to ensure no attempt is made to free the memory. */
+        #endif
+    } Pool_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Macro to mark a pool as locked.  Locking a pool prevents an ISR from
+ * accessing the list of tasks waiting for a block.
+ */
+    #define prvLockPool( pxPool )                          \
+    taskENTER_CRITICAL();                                  \
+    {                                                      \
+        if( ( pxPool )->cLock == poolUNLOCKED )            \
+        {                                                  \
+            ( pxPool )->cLock = poolLOCKED_UNMODIFIED;     \
+        }                                                  \
+    }                                                      \
+    taskEXIT_CRITICAL()
+
+/*
+ * Macro to increment the cLock member of a pool.  It is capped at the number
+ * of tasks in the system as we cannot unblock more tasks than the number of
+ * tasks in the system.
+ */
+    #define prvIncrementPoolLock( pxPool, cLock )                              \
+    do {                                                                       \
+        const UBaseType_t uxNumberOfTasks = uxTaskGetNumberOfTasks();          \
+        if( ( UBaseType_t ) ( cLock ) < uxNumberOfTasks )                      \
+        {                                                                      \
+            configASSERT( ( cLock ) != poolINT8_MAX );                         \
+            ( pxPool )->cLock = ( int8_t ) ( ( cLock ) + ( int8_t ) 1 );       \
+        }                                                                      \
+    } while( 0 )
+
+/*
+ * Set up a new pool, linking every block into the list of free blocks.
+ */
+    static void prvInitialisePool( Pool_t * pxPool,
+                                   UBaseType_t uxNumberOfBlocks,
+                                   size_t xBlockSize,
+                                   uint8_t * pucPoolStorage ) PRIVILEGED_FUNCTION;
+
+/*
+ * Unlink the first free block, or link pvBlock back in as the first free
+ * block.  Must be called from a critical section.  prvTakeBlock() must only be
+ * called when the pool holds a free block.
+ */
+    static void * prvTakeBlock( Pool_t * const pxPool ) PRIVILEGED_FUNCTION;
+    static void prvReturnBlock( Pool_t * const pxPool,
+                                void * pvBlock ) PRIVILEGED_FUNCTION;
+
+/*
+ * Unlocks a pool locked by a call to prvLockPool, unblocking a waiting task
+ * for each block freed by an interrupt while the pool was locked.  Must be
+ * called with the scheduler suspended.
+ */
+    static void prvUnlockPool( Pool_t * const pxPool ) PRIVILEGED_FUNCTION;
+
+/*
+ * Uses a critical section to determine if the pool has no free blocks.
+ */
+    static BaseType_t prvIsPoolEmpty( const Pool_t * pxPool ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+    #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+        PoolHandle_t xPoolCreateStatic( UBaseType_t uxNumberOfBlocks,
+                                        size_t xBlockSize,
+                                        uint8_t * pucPoolStorage,
+                                        StaticPool_t * pxPoolBuffer )
+        {
+            Pool_t * pxPool = NULL;
+
+            traceENTER_xPoolCreateStatic( uxNumberOfBlocks, xBlockSize, pucPoolStorage, pxPoolBuffer );
+
+            configASSERT( uxNumberOfBlocks > ( UBaseType_t ) 0 );
+            configASSERT( xBlockSize > ( size_t ) 0 );
+            configASSERT( pucPoolStorage );
+            configASSERT( pxPoolBuffer );
+            configASSERT( ( ( ( portPOINTER_SIZE_TYPE ) pucPoolStorage ) & ( ( portPOINTER_SIZE_TYPE ) portBYTE_ALIGNMENT_MASK ) ) == 0U );
+
+            #if ( configASSERT_DEFINED == 1 )
+            {
+                /* Sanity check that the size of the structure used to declare a
+                 * variable of type StaticPool_t equals the size of the real pool
+                 * structure. */
+                volatile size_t xSize = sizeof( StaticPool_t );
+                configASSERT( xSize == sizeof( Pool_t ) );
+            }
+            #endif /* configASSERT_DEFINED */
+
+            if( ( pucPoolStorage != NULL ) && ( pxPoolBuffer != NULL ) && ( uxNumberOfBlocks > ( UBaseType_t ) 0 ) )
+            {
+                /* The user has provided a statically allocated pool - use it. */
+                /* MISRA Ref 11.3.1 [Misaligned access] */
+                /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-113 */
+                /* coverity[misra_c_2012_rule_11_3_violation] */
+                pxPool = ( Pool_t * ) pxPoolBuffer;
+
+                prvInitialisePool( pxPool, uxNumberOfBlocks, xBlockSize, pucPoolStorage );
+
+                #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+                {
+                    /* Both static and dynamic allocation can be used, so note
+                     * that this pool was created statically in case the pool is
+                     * later deleted. */
+                    pxPool->ucStaticallyAllocated = pdTRUE;
+                }
+                #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+
+                tracePOOL_CREATE( pxPool );
+            }
+            else
+            {
+                tracePOOL_CREATE_FAILED();
+            }
+
+            traceRETURN_xPoolCreateStatic( pxPool );
+
+            return pxPool;
+        }
+
+    #endif /* configSUPPORT_STATIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+    #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+        PoolHandle_t xPoolCreate( UBaseType_t uxNumberOfBlocks,
+                                  size_t xBlockSize )
+        {
+            Pool_t * pxPool = NULL;
+            size_t xPoolStructSize, xStorageSize;
+
+            traceENTER_xPoolCreate( uxNumberOfBlocks, xBlockSize );
+
+            configASSERT( uxNumberOfBlocks > ( UBaseType_t ) 0 );
+            configASSERT( xBlockSize > ( size_t ) 0 );
+
+            /* The blocks follow the pool structure in the same allocation, so
+             * they start on an aligned boundary. */
+            xPoolStructSize = poolBLOCK_SIZE( sizeof( Pool_t ) );
+            xBlockSize = poolBLOCK_SIZE( xBlockSize );
+
+            /* Check the size of the allocation does not overflow. */
+            if( ( uxNumberOfBlocks > ( UBaseType_t ) 0 ) &&
+                ( ( size_t ) uxNumberOfBlocks <= ( ( poolSIZE_MAX - xPoolStructSize ) / xBlockSize ) ) )
+            {
+                xStorageSize = ( size_t ) uxNumberOfBlocks * xBlockSize;
+
+                /* MISRA Ref 11.5.1 [Malloc memory assignment] */
+                /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+                /* coverity[misra_c_2012_rule_11_5_violation] */
+                pxPool = ( Pool_t * ) pvPortMalloc( xPoolStructSize + xStorageSize );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            if( pxPool != NULL )
+            {
+                prvInitialisePool( pxPool, uxNumberOfBlocks, xBlockSize, ( ( uint8_t * ) pxPool ) + xPoolStructSize );
+
+                #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+                {
+                    /* Both static and dynamic allocation can be used, so note
+                     * this pool was allocated dynamically in case the pool is
+                     * later deleted. */
+                    pxPool->ucStaticallyAllocated = pdFALSE;
+                }
+                #endif /* configSUPPORT_STATIC_ALLOCATION */
+
+                tracePOOL_CREATE( pxPool );
+            }
+            else
+            {
+                tracePOOL_CREATE_FAILED();
+            }
+
+            traceRETURN_xPoolCreate( pxPool );
+
+            return pxPool;
+        }
+
+    #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+    void vPoolDelete( PoolHandle_t xPool )
+    {
+        Pool_t * pxPool = xPool;
+
+        traceENTER_vPoolDelete( xPool );
+
+        configASSERT( pxPool );
+
+        /* No task may be waiting for a block from a pool that is deleted. */
+        configASSERT( listLIST_IS_EMPTY( &( pxPool->xTasksWaitingToAllocate ) ) != pdFALSE );
+
+        tracePOOL_DELETE( pxPool );
+
+        #if ( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) )
+        {
+            /* The pool can only have been allocated dynamically - free it
+             * again. */
+            vPortFree( pxPool );
+        }
+        #elif ( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
+        {
+            /* The pool could have been allocated statically or dynamically, so
+             * check before attempting to free the memory. */
+            if( pxPool->ucStaticallyAllocated == ( uint8_t ) pdFALSE )
+            {
+                vPortFree( pxPool );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+
+        traceRETURN_vPoolDelete();
+    }
+/*-----------------------------------------------------------*/
+
+    void * pvPoolAlloc( PoolHandle_t xPool,
+                        TickType_t xTicksToWait )
+    {
+        BaseType_t xEntryTimeSet = pdFALSE;
+        TimeOut_t xTimeOut;
+        Pool_t * const pxPool = xPool;
+        void * pvBlock;
+
+        traceENTER_pvPoolAlloc( xPool, xTicksToWait );
+
+        configASSERT( pxPool );
+
+        /* Cannot block if the scheduler is suspended. */
+        #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+        {
+            configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+        }
+        #endif
+
+        for( ; ; )
+        {
+            taskENTER_CRITICAL();
+            {
+                /* Is there a free block now?  To be running the calling task
+                 * must be the highest priority task wanting a block. */
+                if( pxPool->uxFreeBlocks > ( UBaseType_t ) 0 )
+                {
+                    pvBlock = prvTakeBlock( pxPool );
+                    tracePOOL_ALLOC( pxPool, pvBlock );
+
+                    taskEXIT_CRITICAL();
+
+                    traceRETURN_pvPoolAlloc( pvBlock );
+
+                    return pvBlock;
+                }
+                else
+                {
+                    if( xTicksToWait == ( TickType_t ) 0 )
+                    {
+                        /* The pool was empty and no block time is specified (or
+                         * the block time has expired) so leave now. */
+                        taskEXIT_CRITICAL();
+
+                        tracePOOL_ALLOC_FAILED( pxPool );
+                        traceRETURN_pvPoolAlloc( NULL );
+
+                        return NULL;
+                    }
+                    else if( xEntryTimeSet == pdFALSE )
+                    {
+                        /* The pool was empty and a block time was specified so
+                         * configure the timeout structure. */
+                        vTaskInternalSetTimeOutState( &xTimeOut );
+                        xEntryTimeSet = pdTRUE;
+                    }
+                    else
+                    {
+                        /* Entry time was already set. */
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+            }
+            taskEXIT_CRITICAL();
+
+            /* Interrupts and other tasks can allocate and free blocks now the
+             * critical section has been exited. */
+
+            vTaskSuspendAll();
+            prvLockPool( pxPool );
+
+            /* Update the timeout state to see if it has expired yet. */
+            if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+            {
+                /* The timeout has not expired.  If the pool is still empty
+                 * place the task on the list of tasks waiting for a block. */
+                if( prvIsPoolEmpty( pxPool ) != pdFALSE )
+                {
+                    traceBLOCKING_ON_POOL_ALLOC( pxPool );
+                    vTaskPlaceOnEventList( &( pxPool->xTasksWaitingToAllocate ), xTicksToWait );
+                    prvUnlockPool( pxPool );
+
+                    if( xTaskResumeAll() == pdFALSE )
+                    {
+                        taskYIELD_WITHIN_API();
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    /* A block was freed.  Loop back to try and take it. */
+                    prvUnlockPool( pxPool );
+                    ( void ) xTaskResumeAll();
+                }
+            }
+            else
+            {
+                /* Timed out.  If there is no free block exit, otherwise loop
+                 * back and attempt to take it. */
+                prvUnlockPool( pxPool );
+                ( void ) xTaskResumeAll();
+
+                if( prvIsPoolEmpty( pxPool ) != pdFALSE )
+                {
+                    tracePOOL_ALLOC_FAILED( pxPool );
+                    traceRETURN_pvPoolAlloc( NULL );
+
+                    return NULL;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    void * pvPoolAllocFromISR( PoolHandle_t xPool )
+    {
+        Pool_t * const pxPool = xPool;
+        void * pvBlock = NULL;
+        UBaseType_t uxSavedInterruptStatus;
+
+        traceENTER_pvPoolAllocFromISR( xPool );
+
+        configASSERT( pxPool );
+
+        /* See the comments in xQueueReceiveFromISR() on interrupt priorities. */
+        portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+        /* MISRA Ref 4.7.1 [Return value shall be checked] */
+        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#dir-47 */
+        /* coverity[misra_c_2012_directive_4_7_violation] */
+        uxSavedInterruptStatus = ( UBaseType_t ) taskENTER_CRITICAL_FROM_ISR();
+        {
+            /* Cannot block in an ISR, so check there is a free block. */
+            if( pxPool->uxFreeBlocks > ( UBaseType_t ) 0 )
+            {
+                pvBlock = prvTakeBlock( pxPool );
+                tracePOOL_ALLOC( pxPool, pvBlock );
+            }
+            else
+            {
+                tracePOOL_ALLOC_FAILED( pxPool );
+            }
+        }
+        taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+        traceRETURN_pvPoolAllocFromISR( pvBlock );
+
+        return pvBlock;
+    }
+/*-----------------------------------------------------------*/
+
+    void vPoolFree( PoolHandle_t xPool,
+                    void * pvBlock )
+    {
+        Pool_t * const pxPool = xPool;
+
+        traceENTER_vPoolFree( xPool, pvBlock );
+
+        configASSERT( pxPool );
+
+        taskENTER_CRITICAL();
+        {
+            prvReturnBlock( pxPool, pvBlock );
+            tracePOOL_FREE( pxPool, pvBlock );
+
+            /* There is now a free block, so unblock the highest priority task
+             * waiting for one, if any.  It takes the block when it runs. */
+            if( listLIST_IS_EMPTY( &( pxPool->xTasksWaitingToAllocate ) ) == pdFALSE )
+            {
+                if( xTaskRemoveFromEventList( &( pxPool->xTasksWaitingToAllocate ) ) != pdFALSE )
+                {
+                    poolYIELD_IF_USING_PREEMPTION();
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        traceRETURN_vPoolFree();
+    }
+/*-----------------------------------------------------------*/
+
+    void vPoolFreeFromISR( PoolHandle_t xPool,
+                           void * pvBlock,
+                           BaseType_t * const pxHigherPriorityTaskWoken )
+    {
+        Pool_t * const pxPool = xPool;
+        UBaseType_t uxSavedInterruptStatus;
+
+        traceENTER_vPoolFreeFromISR( xPool, pvBlock, pxHigherPriorityTaskWoken );
+
+        configASSERT( pxPool );
+
+        /* See the comments in xQueueReceiveFromISR() on interrupt priorities. */
+        portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+        /* MISRA Ref 4.7.1 [Return value shall be checked] */
+        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#dir-47 */
+        /* coverity[misra_c_2012_directive_4_7_violation] */
+        uxSavedInterruptStatus = ( UBaseType_t ) taskENTER_CRITICAL_FROM_ISR();
+        {
+            const int8_t cLock = pxPool->cLock;
+
+            prvReturnBlock( pxPool, pvBlock );
+            tracePOOL_FREE( pxPool, pvBlock );
+
+            /* If the pool is locked the list of waiting tasks will not be
+             * modified.  Instead update the lock count so the task that unlocks
+             * the pool will know that a block was freed while it was locked. */
+            if( cLock == poolUNLOCKED )
+            {
+                if( listLIST_IS_EMPTY( &( pxPool->xTasksWaitingToAllocate ) ) == pdFALSE )
+                {
+                    if( xTaskRemoveFromEventList( &( pxPool->xTasksWaitingToAllocate ) ) != pdFALSE )
+                    {
+                        /* The task waiting has a higher priority than us so
+                         * force a context switch. */
+                        if( pxHigherPriorityTaskWoken != NULL )
+                        {
+                            *pxHigherPriorityTaskWoken = pdTRUE;
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                prvIncrementPoolLock( pxPool, cLock );
+            }
+        }
+        taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+        traceRETURN_vPoolFreeFromISR();
+    }
+/*-----------------------------------------------------------*/
+
+    UBaseType_t uxPoolGetFreeBlocks( PoolHandle_t xPool )
+    {
+        const Pool_t * const pxPool = xPool;
+        UBaseType_t uxFreeBlocks;
+
+        traceENTER_uxPoolGetFreeBlocks( xPool );
+
+        configASSERT( pxPool );
+
+        uxFreeBlocks = pxPool->uxFreeBlocks;
+
+        traceRETURN_uxPoolGetFreeBlocks( uxFreeBlocks );
+
+        return uxFreeBlocks;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvInitialisePool( Pool_t * pxPool,
+                                   UBaseType_t uxNumberOfBlocks,
+                                   size_t xBlockSize,
+                                   uint8_t * pucPoolStorage )
+    {
+        UBaseType_t uxBlock;
+        uint8_t * pucBlock = pucPoolStorage;
+
+        pxPool->pucStorage = pucPoolStorage;
+        pxPool->xBlockSize = poolBLOCK_SIZE( xBlockSize );
+        pxPool->uxNumberOfBlocks = uxNumberOfBlocks;
+        pxPool->uxFreeBlocks = uxNumberOfBlocks;
+        pxPool->cLock = poolUNLOCKED;
+        vListInitialise( &( pxPool->xTasksWaitingToAllocate ) );
+
+        /* Link every block, in address order, into the list of free blocks. */
+        pxPool->pvFirstFreeBlock = pucPoolStorage;
+
+        for( uxBlock = ( UBaseType_t ) 1; uxBlock < uxNumberOfBlocks; uxBlock++ )
+        {
+            *( ( void ** ) pucBlock ) = pucBlock + pxPool->xBlockSize;
+            pucBlock += pxPool->xBlockSize;
+        }
+
+        *( ( void ** ) pucBlock ) = NULL;
+    }
+/*-----------------------------------------------------------*/
+
+    static void * prvTakeBlock( Pool_t * const pxPool )
+    {
+        void * pvBlock = pxPool->pvFirstFreeBlock;
+
+        configASSERT( pvBlock != NULL );
+
+        pxPool->pvFirstFreeBlock = *( ( void ** ) pvBlock );
+        pxPool->uxFreeBlocks = ( UBaseType_t ) ( pxPool->uxFreeBlocks - ( UBaseType_t ) 1 );
+
+        return pvBlock;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvReturnBlock( Pool_t * const pxPool,
+                                void * pvBlock )
+    {
+        const uint8_t * pucBlock = ( const uint8_t * ) pvBlock;
+
+        /* The block must be one of the pool's blocks, and the pool cannot hold
+         * more free blocks than it has. */
+        configASSERT( ( pucBlock >= pxPool->pucStorage ) &&
+                      ( ( size_t ) ( pucBlock - pxPool->pucStorage ) < ( ( size_t ) pxPool->uxNumberOfBlocks * pxPool->xBlockSize ) ) );
+        configASSERT( ( ( size_t ) ( pucBlock - pxPool->pucStorage ) % pxPool->xBlockSize ) == 0U );
+        configASSERT( pxPool->uxFreeBlocks < pxPool->uxNumberOfBlocks );
+        ( void ) pucBlock;
+
+        *( ( void ** ) pvBlock ) = pxPool->pvFirstFreeBlock;
+        pxPool->pvFirstFreeBlock = pvBlock;
+        pxPool->uxFreeBlocks = ( UBaseType_t ) ( pxPool->uxFreeBlocks + ( UBaseType_t ) 1 );
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvUnlockPool( Pool_t * const pxPool )
+    {
+        /* THIS FUNCTION MUST BE CALLED WITH THE SCHEDULER SUSPENDED. */
+
+        /* The lock count contains the number of blocks freed by interrupts
+         * while the pool was locked.  When a pool is locked blocks can be
+         * freed, but the list of waiting tasks cannot be updated. */
+        taskENTER_CRITICAL();
+        {
+            int8_t cLock = pxPool->cLock;
+
+            while( cLock > poolLOCKED_UNMODIFIED )
+            {
+                /* Tasks that are removed from the event list will get added to
+                 * the pending ready list as the scheduler is still suspended. */
+                if( listLIST_IS_EMPTY( &( pxPool->xTasksWaitingToAllocate ) ) == pdFALSE )
+                {
+                    if( xTaskRemoveFromEventList( &( pxPool->xTasksWaitingToAllocate ) ) != pdFALSE )
+                    {
+                        /* The task waiting has a higher priority so record that
+                         * a context switch is required. */
+                        vTaskMissedYield();
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    break;
+                }
+
+                --cLock;
+            }
+
+            pxPool->cLock = poolUNLOCKED;
+        }
+        taskEXIT_CRITICAL();
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvIsPoolEmpty( const Pool_t * pxPool )
+    {
+        BaseType_t xReturn;
+
+        taskENTER_CRITICAL();
+        {
+            if( pxPool->uxFreeBlocks == ( UBaseType_t ) 0 )
+            {
+                xReturn = pdTRUE;
+            }
+            else
+            {
+                xReturn = pdFALSE;
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/* This entire source file will be skipped if the application is not configured
+ * to include memory pool functionality. If you want to include memory pools
+ * then ensure configUSE_MEMORY_POOLS is set to 1 in FreeRTOSConfig.h. */
+#endif /* configUSE_MEMORY_POOLS == 1 */
@@ -31,6 +31,16 @@
  * (coalescences) adjacent memory blocks as they are freed, and in so doing
  * limits memory fragmentation.
  *
+ * If configUSE_HEAP_CACHE is 1 then small blocks freed by a task are held in a
+ * cache belonging to that task, and blocks allocated by the task are taken from
+ * the cache, so neither needs the scheduler to be suspended.  Blocks move
+ * between the caches and the heap a batch at a time.  Blocks held in caches
+ * are not marked as allocated, so freeing one of them again is caught, but the
+ * heap statistics count them as allocated.  xNumberOfSuccessfulAllocations and
+ * xNumberOfSuccessfulFrees in the HeapStats_t structure then count blocks
+ * leaving and returning to the heap rather than calls to pvPortMalloc() and
+ * vPortFree().
+ *
  * See heap_1.c, heap_2.c and heap_3.c for alternative implementations, and the
  * memory management pages of https://www.FreeRTOS.org for more information.
  */
@@ -44,6 +54,7 @@
 
 #include "FreeRTOS.h"
 #include "task.h"
+#include "heap_profiler.h"
 
 #undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
 
@@ -135,6 +146,45 @@ typedef struct A_BLOCK_LINK
     configASSERT( ( ( uint8_t * ) ( pxBlock ) >= &( ucHeap[ 0 ] ) ) && \
                   ( ( uint8_t * ) ( pxBlock ) <= &( ucHeap[ configTOTAL_HEAP_SIZE - 1 ] ) ) )
 
+#if ( configUSE_HEAP_CACHE == 1 )
+
+    #if ( portBYTE_ALIGNMENT > 32 )
+        #error Heap caches require portBYTE_ALIGNMENT to be no more than 32
+    #endif
+
+/* Blocks of up to heapCACHE_LARGEST_BLOCK_SIZE bytes, including the BlockLink_t
+ * structure, are rounded up to a multiple of heapCACHE_CLASS_SPACING bytes when
+ * they are allocated.  Blocks of each size are cached separately. */
+    #define heapCACHE_NUMBER_OF_CLASSES      ( ( UBaseType_t ) 4U )
+    #define heapCACHE_CLASS_SPACING          ( ( size_t ) 32U )
+    #define heapCACHE_LARGEST_BLOCK_SIZE     ( heapCACHE_CLASS_SPACING * ( size_t ) heapCACHE_NUMBER_OF_CLASSES )
+
+/* The class of a block that is being allocated, and the size of the blocks in
+ * that class. */
+    #define heapCACHE_CLASS_TO_ALLOCATE( xBlockSize )    ( ( UBaseType_t ) ( ( ( xBlockSize ) - 1U ) / heapCACHE_CLASS_SPACING ) )
+    #define heapCACHE_CLASS_BLOCK_SIZE( uxClass )        ( ( ( size_t ) ( uxClass ) + 1U ) * heapCACHE_CLASS_SPACING )
+
+/* Blocks that were not split when they were allocated can be larger than the
+ * size of their class, so a block that is being freed goes in the largest class
+ * it can hold the blocks of. */
+    #define heapCACHE_BLOCK_IS_CACHEABLE( xBlockSize )   ( ( ( xBlockSize ) >= heapCACHE_CLASS_SPACING ) && ( ( xBlockSize ) < ( heapCACHE_LARGEST_BLOCK_SIZE + heapCACHE_CLASS_SPACING ) ) )
+    #define heapCACHE_CLASS_TO_FREE( xBlockSize )        ( ( UBaseType_t ) ( ( ( xBlockSize ) / heapCACHE_CLASS_SPACING ) - 1U ) )
+
+/* The number of blocks moved between a cache and the heap at a time. */
+    #define heapCACHE_BATCH_SIZE    ( ( UBaseType_t ) ( configHEAP_CACHE_DEPTH / 2 ) )
+
+/* The cache of a task, which is itself allocated from the heap.  Cached blocks
+ * are not marked as allocated, so vPortFree() can tell a block that is already
+ * cached from one the application owns, and are linked through their
+ * pxNextFreeBlock members. */
+    typedef struct HEAP_CACHE
+    {
+        BlockLink_t * pxFirstBlock[ heapCACHE_NUMBER_OF_CLASSES ]; /**< The first block held in each class, stored as a protected pointer. */
+        uint8_t ucNumberOfBlocks[ heapCACHE_NUMBER_OF_CLASSES ];    /**< The number of blocks held in each class. */
+    } HeapCache_t;
+
+#endif /* configUSE_HEAP_CACHE */
+
 /*-----------------------------------------------------------*/
 
 /*
@@ -151,6 +201,51 @@ static void prvInsertBlockIntoFreeList( BlockLink_t * pxBlockToInsert ) PRIVILEG
  */
 static void prvHeapInit( void ) PRIVILEGED_FUNCTION;
 
+/*
+ * Takes a block of at least xWantedSize bytes, which includes the BlockLink_t
+ * structure, out of the list of free blocks and marks it as allocated.  Returns
+ * NULL if there is no block large enough.  Must be called with the scheduler
+ * suspended.
+ */
+static BlockLink_t * prvAllocateBlock( size_t xWantedSize ) PRIVILEGED_FUNCTION;
+
+#if ( configUSE_HEAP_CACHE == 1 )
+
+/*
+ * Returns the calling task's heap cache, creating it the first time the task
+ * needs it.  Returns NULL if the scheduler has not been started or there is
+ * not enough heap to create the cache.
+ */
+    static HeapCache_t * prvGetCache( void ) PRIVILEGED_FUNCTION;
+
+/*
+ * Push a block onto, or pop a block off, class uxClass of a cache belonging to
+ * the calling task.  prvTakeBlockFromCache() returns NULL if the class is
+ * empty.
+ */
+    static void prvAddBlockToCache( HeapCache_t * pxCache,
+                                    UBaseType_t uxClass,
+                                    BlockLink_t * pxBlock ) PRIVILEGED_FUNCTION;
+    static BlockLink_t * prvTakeBlockFromCache( HeapCache_t * pxCache,
+                                                UBaseType_t uxClass ) PRIVILEGED_FUNCTION;
+
+/*
+ * Places a block that is being freed in the calling task's heap cache, first
+ * returning a batch of blocks to the heap if its class is full.  Returns pdFALSE
+ * if the block cannot be cached, in which case the caller must return it to the
+ * heap.
+ */
+    static BaseType_t prvGiveBlockToCache( BlockLink_t * pxBlock ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns a NULL terminated chain of blocks that are not marked as allocated,
+ * linked through their pxNextFreeBlock members, to the heap with the scheduler
+ * suspended once.
+ */
+    static void prvFreeBlockChain( BlockLink_t * pxFirstBlock ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_HEAP_CACHE */
+
 /*-----------------------------------------------------------*/
 
 /* The size of the structure placed at the beginning of each allocated memory
@@ -172,13 +267,18 @@ PRIVILEGED_DATA static size_t xNumberOfSuccessfulFrees = ( size_t ) 0U;
 
 void * pvPortMalloc( size_t xWantedSize )
 {
-    BlockLink_t * pxBlock;
-    BlockLink_t * pxPreviousBlock;
-    BlockLink_t * pxNewBlockLink;
+    BlockLink_t * pxBlock = NULL;
     void * pvReturn = NULL;
     size_t xAdditionalRequiredSize;
     size_t xAllocatedBlockSize = 0;
 
+    #if ( configUSE_HEAP_CACHE == 1 )
+        HeapCache_t * pxCache = NULL;
+        BlockLink_t * pxSpareBlock;
+        UBaseType_t uxClass = 0U;
+        UBaseType_t uxSpareBlocks;
+    #endif
+
     if( xWantedSize > 0 )
     {
         /* The wanted size must be increased so it can contain a BlockLink_t
@@ -218,120 +318,126 @@ void * pvPortMalloc( size_t xWantedSize )
         mtCOVERAGE_TEST_MARKER();
     }
 
-    vTaskSuspendAll();
+    #if ( configUSE_HEAP_CACHE == 1 )
     {
-        /* If this is the first call to malloc then the heap will require
-         * initialisation to setup the list of free blocks. */
-        if( pxEnd == NULL )
+        /* Small blocks are rounded up to the size of their class so they can
+         * be cached, and are taken from the calling task's cache, without
+         * suspending the scheduler, if it holds one. */
+        if( ( xWantedSize > 0 ) && ( xWantedSize <= heapCACHE_LARGEST_BLOCK_SIZE ) )
         {
-            prvHeapInit();
+            uxClass = heapCACHE_CLASS_TO_ALLOCATE( xWantedSize );
+            xWantedSize = heapCACHE_CLASS_BLOCK_SIZE( uxClass );
+            pxCache = prvGetCache();
+
+            if( pxCache != NULL )
+            {
+                pxBlock = prvTakeBlockFromCache( pxCache, uxClass );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
         }
         else
         {
             mtCOVERAGE_TEST_MARKER();
         }
 
-        /* Check the block size we are trying to allocate is not so large that the
-         * top bit is set.  The top bit of the block size member of the BlockLink_t
-         * structure is used to determine who owns the block - the application or
-         * the kernel, so it must be free. */
-        if( heapBLOCK_SIZE_IS_VALID( xWantedSize ) != 0 )
+        if( pxBlock != NULL )
         {
-            if( ( xWantedSize > 0 ) && ( xWantedSize <= xFreeBytesRemaining ) )
-            {
-                /* Traverse the list from the start (lowest address) block until
-                 * one of adequate size is found. */
-                pxPreviousBlock = &xStart;
-                pxBlock = heapPROTECT_BLOCK_POINTER( xStart.pxNextFreeBlock );
-                heapVALIDATE_BLOCK_POINTER( pxBlock );
-
-                while( ( pxBlock->xBlockSize < xWantedSize ) && ( pxBlock->pxNextFreeBlock != heapPROTECT_BLOCK_POINTER( NULL ) ) )
-                {
-                    pxPreviousBlock = pxBlock;
-                    pxBlock = heapPROTECT_BLOCK_POINTER( pxBlock->pxNextFreeBlock );
-                    heapVALIDATE_BLOCK_POINTER( pxBlock );
-                }
-
-                /* If the end marker was reached then a block of adequate size
-                 * was not found. */
-                if( pxBlock != pxEnd )
-                {
-                    /* Return the memory space pointed to - jumping over the
-                     * BlockLink_t structure at its start. */
-                    pvReturn = ( void * ) ( ( ( uint8_t * ) heapPROTECT_BLOCK_POINTER( pxPreviousBlock->pxNextFreeBlock ) ) + xHeapStructSize );
-                    heapVALIDATE_BLOCK_POINTER( pvReturn );
-
-                    /* This block is being returned for use so must be taken out
-                     * of the list of free blocks. */
-                    pxPreviousBlock->pxNextFreeBlock = pxBlock->pxNextFreeBlock;
+            pvReturn = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xHeapStructSize );
+            traceMALLOC( pvReturn, ( pxBlock->xBlockSize & ~heapBLOCK_ALLOCATED_BITMASK ) );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    #endif /* configUSE_HEAP_CACHE */
 
-                    /* If the block is larger than required it can be split into
-                     * two. */
-                    configASSERT( heapSUBTRACT_WILL_UNDERFLOW( pxBlock->xBlockSize, xWantedSize ) == 0 );
+    if( pxBlock == NULL )
+    {
+        vTaskSuspendAll();
+        {
+            /* If this is the first call to malloc then the heap will require
+             * initialisation to setup the list of free blocks. */
+            if( pxEnd == NULL )
+            {
+                prvHeapInit();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
 
-                    if( ( pxBlock->xBlockSize - xWantedSize ) > heapMINIMUM_BLOCK_SIZE )
-                    {
-                        /* This block is to be split into two.  Create a new
-                         * block following the number of bytes requested. The void
-                         * cast is used to prevent byte alignment warnings from the
-                         * compiler. */
-                        pxNewBlockLink = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xWantedSize );
-                        configASSERT( ( ( ( size_t ) pxNewBlockLink ) & portBYTE_ALIGNMENT_MASK ) == 0 );
-
-                        /* Calculate the sizes of two blocks split from the
-                         * single block. */
-                        pxNewBlockLink->xBlockSize = pxBlock->xBlockSize - xWantedSize;
-                        pxBlock->xBlockSize = xWantedSize;
-
-                        /* Insert the new block into the list of free blocks. */
-                        pxNewBlockLink->pxNextFreeBlock = pxPreviousBlock->pxNextFreeBlock;
-                        pxPreviousBlock->pxNextFreeBlock = heapPROTECT_BLOCK_POINTER( pxNewBlockLink );
-                    }
-                    else
-                    {
-                        mtCOVERAGE_TEST_MARKER();
-                    }
+            pxBlock = prvAllocateBlock( xWantedSize );
 
-                    xFreeBytesRemaining -= pxBlock->xBlockSize;
+            if( pxBlock != NULL )
+            {
+                /* Return the memory space pointed to - jumping over the
+                 * BlockLink_t structure at its start. */
+                pvReturn = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xHeapStructSize );
+                xAllocatedBlockSize = pxBlock->xBlockSize & ~heapBLOCK_ALLOCATED_BITMASK;
 
-                    if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+                #if ( configUSE_HEAP_CACHE == 1 )
+                {
+                    /* The calling task's cache held no blocks of this size, so
+                     * refill it with the rest of a batch while the scheduler is
+                     * suspended anyway. */
+                    if( pxCache != NULL )
                     {
-                        xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+                        pxSpareBlock = pxBlock;
+
+                        for( uxSpareBlocks = 1U; ( uxSpareBlocks < heapCACHE_BATCH_SIZE ) && ( pxSpareBlock != NULL ); uxSpareBlocks++ )
+                        {
+                            pxSpareBlock = prvAllocateBlock( xWantedSize );
+
+                            if( pxSpareBlock != NULL )
+                            {
+                                prvAddBlockToCache( pxCache, uxClass, pxSpareBlock );
+                            }
+                            else
+                            {
+                                mtCOVERAGE_TEST_MARKER();
+                            }
+                        }
                     }
                     else
                     {
                         mtCOVERAGE_TEST_MARKER();
                     }
-
-                    xAllocatedBlockSize = pxBlock->xBlockSize;
-
-                    /* The block is being returned - it is allocated and owned
-                     * by the application and has no "next" block. */
-                    heapALLOCATE_BLOCK( pxBlock );
-                    pxBlock->pxNextFreeBlock = heapPROTECT_BLOCK_POINTER( NULL );
-                    xNumberOfSuccessfulAllocations++;
-                }
-                else
-                {
-                    mtCOVERAGE_TEST_MARKER();
                 }
+                #endif /* configUSE_HEAP_CACHE */
             }
             else
             {
                 mtCOVERAGE_TEST_MARKER();
             }
+
+            traceMALLOC( pvReturn, xAllocatedBlockSize );
+
+            /* Prevent compiler warnings when trace macros are not used. */
+            ( void ) xAllocatedBlockSize;
+        }
+        ( void ) xTaskResumeAll();
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    #if ( configUSE_HEAP_PROFILER == 1 )
+    {
+        if( pvReturn != NULL )
+        {
+            vPortHeapProfilerRecordAlloc( pvReturn, ( pxBlock->xBlockSize & ~heapBLOCK_ALLOCATED_BITMASK ), portGET_RETURN_ADDRESS() );
         }
         else
         {
             mtCOVERAGE_TEST_MARKER();
         }
-
-        traceMALLOC( pvReturn, xAllocatedBlockSize );
-
-        /* Prevent compiler warnings when trace macros are not used. */
-        ( void ) xAllocatedBlockSize;
     }
-    ( void ) xTaskResumeAll();
+    #endif /* if ( configUSE_HEAP_PROFILER == 1 ) */
 
     #if ( configUSE_MALLOC_FAILED_HOOK == 1 )
     {
@@ -355,6 +461,7 @@ void vPortFree( void * pv )
 {
     uint8_t * puc = ( uint8_t * ) pv;
     BlockLink_t * pxLink;
+    BaseType_t xCached = pdFALSE;
 
     if( pv != NULL )
     {
@@ -365,6 +472,9 @@ void vPortFree( void * pv )
         /* This casting is to keep the compiler from issuing warnings. */
         pxLink = ( void * ) puc;
 
+        /* A block that is in the free list, or in a heap cache, is not
+         * marked as allocated, so these also catch a block being freed
+         * twice. */
         heapVALIDATE_BLOCK_POINTER( pxLink );
         configASSERT( heapBLOCK_IS_ALLOCATED( pxLink ) != 0 );
         configASSERT( pxLink->pxNextFreeBlock == heapPROTECT_BLOCK_POINTER( NULL ) );
@@ -373,29 +483,59 @@ void vPortFree( void * pv )
         {
             if( pxLink->pxNextFreeBlock == heapPROTECT_BLOCK_POINTER( NULL ) )
             {
-                /* The block is being returned to the heap - it is no longer
-                 * allocated. */
-                heapFREE_BLOCK( pxLink );
-                #if ( configHEAP_CLEAR_MEMORY_ON_FREE == 1 )
+                #if ( configUSE_HEAP_PROFILER == 1 )
+                {
+                    vPortHeapProfilerRecordFree( pv, ( pxLink->xBlockSize & ~heapBLOCK_ALLOCATED_BITMASK ) );
+                }
+                #endif
+
+                #if ( configUSE_HEAP_CACHE == 1 )
                 {
-                    /* Check for underflow as this can occur if xBlockSize is
-                     * overwritten in a heap block. */
-                    if( heapSUBTRACT_WILL_UNDERFLOW( pxLink->xBlockSize, xHeapStructSize ) == 0 )
+                    /* Small blocks go to the calling task's cache without
+                     * suspending the scheduler. */
+                    xCached = prvGiveBlockToCache( pxLink );
+
+                    if( xCached != pdFALSE )
                     {
-                        ( void ) memset( puc + xHeapStructSize, 0, pxLink->xBlockSize - xHeapStructSize );
+                        traceFREE( pv, ( pxLink->xBlockSize & ~heapBLOCK_ALLOCATED_BITMASK ) );
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
                     }
                 }
                 #endif
 
-                vTaskSuspendAll();
+                if( xCached == pdFALSE )
                 {
-                    /* Add this block to the list of free blocks. */
-                    xFreeBytesRemaining += pxLink->xBlockSize;
-                    traceFREE( pv, pxLink->xBlockSize );
-                    prvInsertBlockIntoFreeList( ( ( BlockLink_t * ) pxLink ) );
-                    xNumberOfSuccessfulFrees++;
+                    /* The block is being returned to the heap - it is no longer
+                     * allocated. */
+                    heapFREE_BLOCK( pxLink );
+                    #if ( configHEAP_CLEAR_MEMORY_ON_FREE == 1 )
+                    {
+                        /* Check for underflow as this can occur if xBlockSize is
+                         * overwritten in a heap block. */
+                        if( heapSUBTRACT_WILL_UNDERFLOW( pxLink->xBlockSize, xHeapStructSize ) == 0 )
+                        {
+                            ( void ) memset( puc + xHeapStructSize, 0, pxLink->xBlockSize - xHeapStructSize );
+                        }
+                    }
+                    #endif
+
+                    vTaskSuspendAll();
+                    {
+                        /* Add this block to the list of free blocks. */
+                        xFreeBytesRemaining += pxLink->xBlockSize;
+                        traceFREE( pv, pxLink->xBlockSize );
+                        prvInsertBlockIntoFreeList( ( ( BlockLink_t * ) pxLink ) );
+                        xNumberOfSuccessfulFrees++;
+                    }
+                    ( void ) xTaskResumeAll();
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
                 }
-                ( void ) xTaskResumeAll();
             }
             else
             {
@@ -569,6 +709,386 @@ static void prvInsertBlockIntoFreeList( BlockLink_t * pxBlockToInsert ) /* PRIVI
 }
 /*-----------------------------------------------------------*/
 
+static BlockLink_t * prvAllocateBlock( size_t xWantedSize ) /* PRIVILEGED_FUNCTION */
+{
+    BlockLink_t * pxBlock;
+    BlockLink_t * pxPreviousBlock;
+    BlockLink_t * pxNewBlockLink;
+    BlockLink_t * pxReturn = NULL;
+
+    /* Check the block size we are trying to allocate is not so large that the
+     * top bit is set.  The top bit of the block size member of the BlockLink_t
+     * structure is used to determine who owns the block - the application or
+     * the kernel, so it must be free. */
+    if( heapBLOCK_SIZE_IS_VALID( xWantedSize ) != 0 )
+    {
+        if( ( xWantedSize > 0 ) && ( xWantedSize <= xFreeBytesRemaining ) )
+        {
+            /* Traverse the list from the start (lowest address) block until
+             * one of adequate size is found. */
+            pxPreviousBlock = &xStart;
+            pxBlock = heapPROTECT_BLOCK_POINTER( xStart.pxNextFreeBlock );
+            heapVALIDATE_BLOCK_POINTER( pxBlock );
+
+            while( ( pxBlock->xBlockSize < xWantedSize ) && ( pxBlock->pxNextFreeBlock != heapPROTECT_BLOCK_POINTER( NULL ) ) )
+            {
+                pxPreviousBlock = pxBlock;
+                pxBlock = heapPROTECT_BLOCK_POINTER( pxBlock->pxNextFreeBlock );
+                heapVALIDATE_BLOCK_POINTER( pxBlock );
+            }
+
+            /* If the end marker was reached then a block of adequate size
+             * was not found. */
+            if( pxBlock != pxEnd )
+            {
+                /* This block is being returned for use so must be taken out
+                 * of the list of free blocks. */
+                pxPreviousBlock->pxNextFreeBlock = pxBlock->pxNextFreeBlock;
+
+                /* If the block is larger than required it can be split into
+                 * two. */
+                configASSERT( heapSUBTRACT_WILL_UNDERFLOW( pxBlock->xBlockSize, xWantedSize ) == 0 );
+
+                if( ( pxBlock->xBlockSize - xWantedSize ) > heapMINIMUM_BLOCK_SIZE )
+                {
+                    /* This block is to be split into two.  Create a new
+                     * block following the number of bytes requested. The void
+                     * cast is used to prevent byte alignment warnings from the
+                     * compiler. */
+                    pxNewBlockLink = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xWantedSize );
+                    configASSERT( ( ( ( size_t ) pxNewBlockLink ) & portBYTE_ALIGNMENT_MASK ) == 0 );
+
+                    /* Calculate the sizes of two blocks split from the
+                     * single block. */
+                    pxNewBlockLink->xBlockSize = pxBlock->xBlockSize - xWantedSize;
+                    pxBlock->xBlockSize = xWantedSize;
+
+                    /* Insert the new block into the list of free blocks. */
+                    pxNewBlockLink->pxNextFreeBlock = pxPreviousBlock->pxNextFreeBlock;
+                    pxPreviousBlock->pxNextFreeBlock = heapPROTECT_BLOCK_POINTER( pxNewBlockLink );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                xFreeBytesRemaining -= pxBlock->xBlockSize;
+
+                if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+                {
+                    xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                /* The block is being returned - it is allocated and owned
+                 * by the application and has no "next" block. */
+                heapALLOCATE_BLOCK( pxBlock );
+                pxBlock->pxNextFreeBlock = heapPROTECT_BLOCK_POINTER( NULL );
+                xNumberOfSuccessfulAllocations++;
+                pxReturn = pxBlock;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    return pxReturn;
+}
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_HEAP_CACHE == 1 )
+
+    static HeapCache_t * prvGetCache( void ) /* PRIVILEGED_FUNCTION */
+    {
+        void ** ppvHeapCache;
+        HeapCache_t * pxCache = NULL;
+        BlockLink_t * pxBlock;
+        UBaseType_t uxClass;
+        size_t xCacheBlockSize;
+
+        ppvHeapCache = ppvTaskGetHeapCache();
+
+        if( ppvHeapCache != NULL )
+        {
+            pxCache = ( HeapCache_t * ) *ppvHeapCache;
+
+            if( pxCache == NULL )
+            {
+                /* This is the first time the task has needed its cache. */
+                xCacheBlockSize = ( sizeof( HeapCache_t ) + xHeapStructSize + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+                vTaskSuspendAll();
+                {
+                    if( pxEnd == NULL )
+                    {
+                        prvHeapInit();
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    pxBlock = prvAllocateBlock( xCacheBlockSize );
+                }
+                ( void ) xTaskResumeAll();
+
+                if( pxBlock != NULL )
+                {
+                    pxCache = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xHeapStructSize );
+
+                    for( uxClass = 0U; uxClass < heapCACHE_NUMBER_OF_CLASSES; uxClass++ )
+                    {
+                        pxCache->pxFirstBlock[ uxClass ] = heapPROTECT_BLOCK_POINTER( NULL );
+                        pxCache->ucNumberOfBlocks[ uxClass ] = 0U;
+                    }
+
+                    *ppvHeapCache = pxCache;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return pxCache;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvAddBlockToCache( HeapCache_t * pxCache,
+                                    UBaseType_t uxClass,
+                                    BlockLink_t * pxBlock ) /* PRIVILEGED_FUNCTION */
+    {
+        UBaseType_t uxSavedInterruptStatus;
+
+        /* The block belongs to the cache now, not to the application. */
+        configASSERT( heapBLOCK_IS_ALLOCATED( pxBlock ) != 0 );
+        heapFREE_BLOCK( pxBlock );
+
+        /* Only the task that owns the cache accesses it, so it is enough to
+         * stop the task being switched out, and so deleted, part way through
+         * updating it.  Interrupts are only masked on this core. */
+        uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+        {
+            pxBlock->pxNextFreeBlock = pxCache->pxFirstBlock[ uxClass ];
+            pxCache->pxFirstBlock[ uxClass ] = heapPROTECT_BLOCK_POINTER( pxBlock );
+            ( pxCache->ucNumberOfBlocks[ uxClass ] )++;
+        }
+        portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+    }
+/*-----------------------------------------------------------*/
+
+    static BlockLink_t * prvTakeBlockFromCache( HeapCache_t * pxCache,
+                                                UBaseType_t uxClass ) /* PRIVILEGED_FUNCTION */
+    {
+        BlockLink_t * pxBlock = NULL;
+        UBaseType_t uxSavedInterruptStatus;
+
+        /* See the comment in prvAddBlockToCache(). */
+        uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+        {
+            if( pxCache->ucNumberOfBlocks[ uxClass ] > 0U )
+            {
+                pxBlock = heapPROTECT_BLOCK_POINTER( pxCache->pxFirstBlock[ uxClass ] );
+                heapVALIDATE_BLOCK_POINTER( pxBlock );
+                pxCache->pxFirstBlock[ uxClass ] = pxBlock->pxNextFreeBlock;
+                ( pxCache->ucNumberOfBlocks[ uxClass ] )--;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+        if( pxBlock != NULL )
+        {
+            /* The block is being returned - it is allocated and has no "next"
+             * block. */
+            configASSERT( heapBLOCK_IS_ALLOCATED( pxBlock ) == 0 );
+            heapALLOCATE_BLOCK( pxBlock );
+            pxBlock->pxNextFreeBlock = heapPROTECT_BLOCK_POINTER( NULL );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return pxBlock;
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvGiveBlockToCache( BlockLink_t * pxBlock ) /* PRIVILEGED_FUNCTION */
+    {
+        HeapCache_t * pxCache;
+        BlockLink_t * pxFirstFlushedBlock = NULL;
+        BlockLink_t * pxLastFlushedBlock;
+        UBaseType_t uxClass, uxBlock, uxSavedInterruptStatus;
+        size_t xBlockSize = pxBlock->xBlockSize & ~heapBLOCK_ALLOCATED_BITMASK;
+        BaseType_t xReturn = pdFALSE;
+
+        if( heapCACHE_BLOCK_IS_CACHEABLE( xBlockSize ) )
+        {
+            pxCache = prvGetCache();
+
+            if( pxCache != NULL )
+            {
+                uxClass = heapCACHE_CLASS_TO_FREE( xBlockSize );
+
+                if( pxCache->ucNumberOfBlocks[ uxClass ] >= ( uint8_t ) configHEAP_CACHE_DEPTH )
+                {
+                    /* The class is full, so unlink a batch of its blocks to
+                     * return to the heap. */
+                    uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+                    {
+                        pxFirstFlushedBlock = heapPROTECT_BLOCK_POINTER( pxCache->pxFirstBlock[ uxClass ] );
+                        pxLastFlushedBlock = pxFirstFlushedBlock;
+
+                        for( uxBlock = 1U; uxBlock < heapCACHE_BATCH_SIZE; uxBlock++ )
+                        {
+                            heapVALIDATE_BLOCK_POINTER( pxLastFlushedBlock );
+                            pxLastFlushedBlock = heapPROTECT_BLOCK_POINTER( pxLastFlushedBlock->pxNextFreeBlock );
+                        }
+
+                        heapVALIDATE_BLOCK_POINTER( pxLastFlushedBlock );
+                        pxCache->pxFirstBlock[ uxClass ] = pxLastFlushedBlock->pxNextFreeBlock;
+                        pxLastFlushedBlock->pxNextFreeBlock = heapPROTECT_BLOCK_POINTER( NULL );
+                        pxCache->ucNumberOfBlocks[ uxClass ] -= ( uint8_t ) heapCACHE_BATCH_SIZE;
+                    }
+                    portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+                    prvFreeBlockChain( pxFirstFlushedBlock );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                #if ( configHEAP_CLEAR_MEMORY_ON_FREE == 1 )
+                {
+                    /* Cached blocks are cleared too, so freed memory never
+                     * holds stale data. */
+                    ( void ) memset( ( ( uint8_t * ) pxBlock ) + xHeapStructSize, 0, xBlockSize - xHeapStructSize );
+                }
+                #endif
+
+                prvAddBlockToCache( pxCache, uxClass, pxBlock );
+                xReturn = pdTRUE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvFreeBlockChain( BlockLink_t * pxFirstBlock ) /* PRIVILEGED_FUNCTION */
+    {
+        BlockLink_t * pxBlock;
+        BlockLink_t * pxNextBlock;
+
+        /* Clear the blocks if required before the scheduler is suspended, as
+         * vPortFree() does. */
+        for( pxBlock = pxFirstBlock; pxBlock != NULL; pxBlock = heapPROTECT_BLOCK_POINTER( pxBlock->pxNextFreeBlock ) )
+        {
+            heapVALIDATE_BLOCK_POINTER( pxBlock );
+            configASSERT( heapBLOCK_IS_ALLOCATED( pxBlock ) == 0 );
+
+            #if ( configHEAP_CLEAR_MEMORY_ON_FREE == 1 )
+            {
+                if( heapSUBTRACT_WILL_UNDERFLOW( pxBlock->xBlockSize, xHeapStructSize ) == 0 )
+                {
+                    ( void ) memset( ( ( uint8_t * ) pxBlock ) + xHeapStructSize, 0, pxBlock->xBlockSize - xHeapStructSize );
+                }
+            }
+            #endif
+        }
+
+        vTaskSuspendAll();
+        {
+            pxBlock = pxFirstBlock;
+
+            while( pxBlock != NULL )
+            {
+                /* Read the link before prvInsertBlockIntoFreeList() overwrites
+                 * it. */
+                pxNextBlock = heapPROTECT_BLOCK_POINTER( pxBlock->pxNextFreeBlock );
+                xFreeBytesRemaining += pxBlock->xBlockSize;
+                prvInsertBlockIntoFreeList( pxBlock );
+                xNumberOfSuccessfulFrees++;
+                pxBlock = pxNextBlock;
+            }
+        }
+        ( void ) xTaskResumeAll();
+    }
+/*-----------------------------------------------------------*/
+
+    void vPortFreeHeapCache( void * pvHeapCache )
+    {
+        HeapCache_t * pxCache = ( HeapCache_t * ) pvHeapCache;
+        BlockLink_t * pxCacheBlock;
+        UBaseType_t uxClass;
+
+        /* The task that owned the cache has been deleted, so nothing else can
+         * be using it. */
+        if( pxCache != NULL )
+        {
+            for( uxClass = 0U; uxClass < heapCACHE_NUMBER_OF_CLASSES; uxClass++ )
+            {
+                if( pxCache->ucNumberOfBlocks[ uxClass ] > 0U )
+                {
+                    prvFreeBlockChain( heapPROTECT_BLOCK_POINTER( pxCache->pxFirstBlock[ uxClass ] ) );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+
+            /* The cache itself is a block of one. */
+            pxCacheBlock = ( void * ) ( ( ( uint8_t * ) pxCache ) - xHeapStructSize );
+            heapVALIDATE_BLOCK_POINTER( pxCacheBlock );
+            configASSERT( heapBLOCK_IS_ALLOCATED( pxCacheBlock ) != 0 );
+            heapFREE_BLOCK( pxCacheBlock );
+            prvFreeBlockChain( pxCacheBlock );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_HEAP_CACHE */
+
 void vPortGetHeapStats( HeapStats_t * pxHeapStats )
 {
     BlockLink_t * pxBlock;
@@ -634,5 +1154,9 @@ void vPortHeapResetState( void )
     xMinimumEverFreeBytesRemaining = ( size_t ) 0U;
     xNumberOfSuccessfulAllocations = ( size_t ) 0U;
     xNumberOfSuccessfulFrees = ( size_t ) 0U;
+
+    #if ( configUSE_HEAP_PROFILER == 1 )
+        vPortHeapProfilerResetState();
+    #endif /* #if ( configUSE_HEAP_PROFILER == 1 ) */
 }
 /*-----------------------------------------------------------*/
@@ -67,6 +67,19 @@
  *
  * Note 0x80000000 is the lower address so appears in the array first.
  *
+ * If configUSE_HEAP_REGIONS is 1 each region keeps its own free list and its
+ * own statistics, and pvPortMallocRegion() allocates from the regions selected
+ * by a mask, in which bit n selects the nth region in the array.  So in the
+ * example above pvPortMallocRegion( xSize, 0x01 ) only allocates from the
+ * region at 0x80000000, which could be fast internal RAM, and
+ * pvPortMallocRegion( xSize, 0x02 ) only from the region at 0x90000000, which
+ * could be slow external RAM.  pvPortMalloc() allocates from any region,
+ * trying the regions in the order they appear in the array.  Task control
+ * blocks, stacks and queues are allocated from the regions selected by
+ * configHEAP_REGIONS_FOR_TCBS, configHEAP_REGIONS_FOR_STACKS and
+ * configHEAP_REGIONS_FOR_QUEUES.  vPortGetHeapRegionStats() returns the
+ * statistics of one region.
+ *
  */
 #include <stdlib.h>
 #include <string.h>
@@ -78,6 +91,7 @@
 
 #include "FreeRTOS.h"
 #include "task.h"
+#include "heap_profiler.h"
 
 #undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
 
@@ -117,6 +131,9 @@
 #define heapALLOCATE_BLOCK( pxBlock )            ( ( pxBlock->xBlockSize ) |= heapBLOCK_ALLOCATED_BITMASK )
 #define heapFREE_BLOCK( pxBlock )                ( ( pxBlock->xBlockSize ) &= ~heapBLOCK_ALLOCATED_BITMASK )
 
+/* The region mask used by pvPortMalloc(), which selects every region. */
+#define heapALL_REGIONS    ( ~( ( UBaseType_t ) 0U ) )
+
 /* Setting configENABLE_HEAP_PROTECTOR to 1 enables heap block pointers
  * protection using an application supplied canary value to catch heap
  * corruption should a heap buffer overflow occur.
@@ -161,15 +178,63 @@ typedef struct A_BLOCK_LINK
     size_t xBlockSize;                     /**< The size of the free block. */
 } BlockLink_t;
 
+#if ( configUSE_HEAP_REGIONS == 1 )
+
+/* The state of each region passed to vPortDefineHeapRegions().  The free blocks
+ * of a region are the blocks between the region's head and its end marker in
+ * the list of free blocks, so each region has its own free list that can be
+ * searched without walking the free blocks of the other regions. */
+    typedef struct HeapRegionState
+    {
+        BlockLink_t * pxHead;                  /**< xStart for the first region, otherwise the end marker of the previous region. */
+        BlockLink_t * pxEnd;                   /**< The end marker of the region. */
+        size_t xFreeBytesRemaining;            /**< The number of free bytes in the region. */
+        size_t xMinimumEverFreeBytesRemaining; /**< The lowest value xFreeBytesRemaining has had. */
+        size_t xNumberOfSuccessfulAllocations; /**< The number of blocks allocated from the region. */
+        size_t xNumberOfSuccessfulFrees;       /**< The number of blocks freed to the region. */
+    } HeapRegionState_t;
+
+#endif /* configUSE_HEAP_REGIONS */
+
 /*-----------------------------------------------------------*/
 
 /*
  * Inserts a block of memory that is being freed into the correct position in
- * the list of free memory blocks.  The block being freed will be merged with
+ * the list of free memory blocks, searching from pxHead, which is xStart or
+ * the head of the block's region.  The block being freed will be merged with
  * the block in front it and/or the block behind it if the memory blocks are
- * adjacent to each other.
+ * adjacent to each other, but never with the end marker pxRegionEnd.
+ */
+static void prvInsertBlockIntoFreeList( BlockLink_t * pxHead,
+                                        BlockLink_t * pxRegionEnd,
+                                        BlockLink_t * pxBlockToInsert ) PRIVILEGED_FUNCTION;
+
+/*
+ * Removes the first free block of at least xWantedSize bytes that follows
+ * pxPreviousBlock and comes before the end marker pxRegionEnd from the list of
+ * free blocks, splitting it if it is larger than needed.  Returns NULL if there
+ * is no such block.  Must be called with the scheduler suspended.
+ */
+static BlockLink_t * prvAllocateBlock( BlockLink_t * pxPreviousBlock,
+                                       const BlockLink_t * pxRegionEnd,
+                                       size_t xWantedSize ) PRIVILEGED_FUNCTION;
+
+/*
+ * The implementation of pvPortMalloc() and pvPortMallocRegion().  pvCallSite
+ * is the address they return to, which is recorded by the heap profiler.
+ */
+static void * prvHeapMalloc( size_t xWantedSize,
+                             UBaseType_t uxRegionMask,
+                             void * pvCallSite ) PRIVILEGED_FUNCTION;
+
+#if ( configUSE_HEAP_REGIONS == 1 )
+
+/*
+ * Returns the state of the region that contains pxBlock.
  */
-static void prvInsertBlockIntoFreeList( BlockLink_t * pxBlockToInsert ) PRIVILEGED_FUNCTION;
+    static HeapRegionState_t * prvGetRegion( const BlockLink_t * pxBlock ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_HEAP_REGIONS */
 void vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions ) PRIVILEGED_FUNCTION;
 
 #if ( configENABLE_HEAP_PROTECTOR == 1 )
@@ -199,6 +264,14 @@ PRIVILEGED_DATA static size_t xMinimumEverFreeBytesRemaining = ( size_t ) 0U;
 PRIVILEGED_DATA static size_t xNumberOfSuccessfulAllocations = ( size_t ) 0U;
 PRIVILEGED_DATA static size_t xNumberOfSuccessfulFrees = ( size_t ) 0U;
 
+#if ( configUSE_HEAP_REGIONS == 1 )
+
+/* The regions passed to vPortDefineHeapRegions(), in address order. */
+    PRIVILEGED_DATA static HeapRegionState_t xRegions[ configHEAP_MAX_REGIONS ];
+    PRIVILEGED_DATA static BaseType_t xNumberOfRegions = 0;
+
+#endif /* configUSE_HEAP_REGIONS */
+
 #if ( configENABLE_HEAP_PROTECTOR == 1 )
 
 /* Canary value for protecting internal heap pointers. */
@@ -214,13 +287,35 @@ PRIVILEGED_DATA static size_t xNumberOfSuccessfulFrees = ( size_t ) 0U;
 
 void * pvPortMalloc( size_t xWantedSize )
 {
-    BlockLink_t * pxBlock;
-    BlockLink_t * pxPreviousBlock;
-    BlockLink_t * pxNewBlockLink;
+    return prvHeapMalloc( xWantedSize, heapALL_REGIONS, portGET_RETURN_ADDRESS() );
+}
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_HEAP_REGIONS == 1 )
+
+    void * pvPortMallocRegion( size_t xWantedSize,
+                               UBaseType_t uxRegionMask )
+    {
+        return prvHeapMalloc( xWantedSize, uxRegionMask, portGET_RETURN_ADDRESS() );
+    }
+
+#endif /* configUSE_HEAP_REGIONS */
+/*-----------------------------------------------------------*/
+
+static void * prvHeapMalloc( size_t xWantedSize,
+                             UBaseType_t uxRegionMask,
+                             void * pvCallSite ) /* PRIVILEGED_FUNCTION */
+{
+    BlockLink_t * pxBlock = NULL;
     void * pvReturn = NULL;
     size_t xAdditionalRequiredSize;
     size_t xAllocatedBlockSize = 0;
 
+    #if ( configUSE_HEAP_REGIONS == 1 )
+        HeapRegionState_t * pxRegion = NULL;
+        BaseType_t xRegion;
+    #endif
+
     /* The heap must be initialised before the first call to
      * pvPortMalloc(). */
     configASSERT( pxEnd );
@@ -274,58 +369,58 @@ void * pvPortMalloc( size_t xWantedSize )
         {
             if( ( xWantedSize > 0 ) && ( xWantedSize <= xFreeBytesRemaining ) )
             {
-                /* Traverse the list from the start (lowest address) block until
-                 * one of adequate size is found. */
-                pxPreviousBlock = &xStart;
-                pxBlock = heapPROTECT_BLOCK_POINTER( xStart.pxNextFreeBlock );
-                heapVALIDATE_BLOCK_POINTER( pxBlock );
-
-                while( ( pxBlock->xBlockSize < xWantedSize ) && ( pxBlock->pxNextFreeBlock != heapPROTECT_BLOCK_POINTER( NULL ) ) )
-                {
-                    pxPreviousBlock = pxBlock;
-                    pxBlock = heapPROTECT_BLOCK_POINTER( pxBlock->pxNextFreeBlock );
-                    heapVALIDATE_BLOCK_POINTER( pxBlock );
-                }
-
-                /* If the end marker was reached then a block of adequate size
-                 * was not found. */
-                if( pxBlock != pxEnd )
+                #if ( configUSE_HEAP_REGIONS == 1 )
                 {
-                    /* Return the memory space pointed to - jumping over the
-                     * BlockLink_t structure at its start. */
-                    pvReturn = ( void * ) ( ( ( uint8_t * ) heapPROTECT_BLOCK_POINTER( pxPreviousBlock->pxNextFreeBlock ) ) + xHeapStructSize );
-                    heapVALIDATE_BLOCK_POINTER( pvReturn );
-
-                    /* This block is being returned for use so must be taken out
-                     * of the list of free blocks. */
-                    pxPreviousBlock->pxNextFreeBlock = pxBlock->pxNextFreeBlock;
-
-                    /* If the block is larger than required it can be split into
-                     * two. */
-                    configASSERT( heapSUBTRACT_WILL_UNDERFLOW( pxBlock->xBlockSize, xWantedSize ) == 0 );
+                    /* Search the free list of each selected region, in address
+                     * order, skipping regions that are too full. */
+                    for( xRegion = 0; ( xRegion < xNumberOfRegions ) && ( pxBlock == NULL ); xRegion++ )
+                    {
+                        pxRegion = &( xRegions[ xRegion ] );
+
+                        if( ( ( uxRegionMask & ( ( UBaseType_t ) 1U << xRegion ) ) != 0U ) &&
+                            ( xWantedSize <= pxRegion->xFreeBytesRemaining ) )
+                        {
+                            pxBlock = prvAllocateBlock( pxRegion->pxHead, pxRegion->pxEnd, xWantedSize );
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+                    }
 
-                    if( ( pxBlock->xBlockSize - xWantedSize ) > heapMINIMUM_BLOCK_SIZE )
+                    if( pxBlock != NULL )
                     {
-                        /* This block is to be split into two.  Create a new
-                         * block following the number of bytes requested. The void
-                         * cast is used to prevent byte alignment warnings from the
-                         * compiler. */
-                        pxNewBlockLink = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xWantedSize );
-                        configASSERT( ( ( ( size_t ) pxNewBlockLink ) & portBYTE_ALIGNMENT_MASK ) == 0 );
-
-                        /* Calculate the sizes of two blocks split from the
-                         * single block. */
-                        pxNewBlockLink->xBlockSize = pxBlock->xBlockSize - xWantedSize;
-                        pxBlock->xBlockSize = xWantedSize;
-
-                        /* Insert the new block into the list of free blocks. */
-                        pxNewBlockLink->pxNextFreeBlock = pxPreviousBlock->pxNextFreeBlock;
-                        pxPreviousBlock->pxNextFreeBlock = heapPROTECT_BLOCK_POINTER( pxNewBlockLink );
+                        pxRegion->xFreeBytesRemaining -= pxBlock->xBlockSize;
+
+                        if( pxRegion->xFreeBytesRemaining < pxRegion->xMinimumEverFreeBytesRemaining )
+                        {
+                            pxRegion->xMinimumEverFreeBytesRemaining = pxRegion->xFreeBytesRemaining;
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+
+                        pxRegion->xNumberOfSuccessfulAllocations++;
                     }
                     else
                     {
                         mtCOVERAGE_TEST_MARKER();
                     }
+                }
+                #else /* if ( configUSE_HEAP_REGIONS == 1 ) */
+                {
+                    ( void ) uxRegionMask;
+                    pxBlock = prvAllocateBlock( &xStart, pxEnd, xWantedSize );
+                }
+                #endif /* if ( configUSE_HEAP_REGIONS == 1 ) */
+
+                if( pxBlock != NULL )
+                {
+                    /* Return the memory space pointed to - jumping over the
+                     * BlockLink_t structure at its start. */
+                    pvReturn = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xHeapStructSize );
+                    heapVALIDATE_BLOCK_POINTER( pvReturn );
 
                     xFreeBytesRemaining -= pxBlock->xBlockSize;
 
@@ -368,6 +463,23 @@ void * pvPortMalloc( size_t xWantedSize )
     }
     ( void ) xTaskResumeAll();
 
+    #if ( configUSE_HEAP_PROFILER == 1 )
+    {
+        if( pvReturn != NULL )
+        {
+            vPortHeapProfilerRecordAlloc( pvReturn, xAllocatedBlockSize, pvCallSite );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    #else
+    {
+        ( void ) pvCallSite;
+    }
+    #endif /* if ( configUSE_HEAP_PROFILER == 1 ) */
+
     #if ( configUSE_MALLOC_FAILED_HOOK == 1 )
     {
         if( pvReturn == NULL )
@@ -386,11 +498,76 @@ void * pvPortMalloc( size_t xWantedSize )
 }
 /*-----------------------------------------------------------*/
 
+static BlockLink_t * prvAllocateBlock( BlockLink_t * pxPreviousBlock,
+                                       const BlockLink_t * pxRegionEnd,
+                                       size_t xWantedSize ) /* PRIVILEGED_FUNCTION */
+{
+    BlockLink_t * pxBlock;
+    BlockLink_t * pxNewBlockLink;
+
+    /* Traverse the list from the start (lowest address) block until one of
+     * adequate size is found. */
+    pxBlock = heapPROTECT_BLOCK_POINTER( pxPreviousBlock->pxNextFreeBlock );
+    heapVALIDATE_BLOCK_POINTER( pxBlock );
+
+    while( ( pxBlock->xBlockSize < xWantedSize ) && ( pxBlock != pxRegionEnd ) )
+    {
+        pxPreviousBlock = pxBlock;
+        pxBlock = heapPROTECT_BLOCK_POINTER( pxBlock->pxNextFreeBlock );
+        heapVALIDATE_BLOCK_POINTER( pxBlock );
+    }
+
+    /* If the end marker was reached then a block of adequate size was not
+     * found. */
+    if( pxBlock != pxRegionEnd )
+    {
+        /* This block is being returned for use so must be taken out of the
+         * list of free blocks. */
+        pxPreviousBlock->pxNextFreeBlock = pxBlock->pxNextFreeBlock;
+
+        /* If the block is larger than required it can be split into two. */
+        configASSERT( heapSUBTRACT_WILL_UNDERFLOW( pxBlock->xBlockSize, xWantedSize ) == 0 );
+
+        if( ( pxBlock->xBlockSize - xWantedSize ) > heapMINIMUM_BLOCK_SIZE )
+        {
+            /* This block is to be split into two.  Create a new block
+             * following the number of bytes requested. The void cast is used
+             * to prevent byte alignment warnings from the compiler. */
+            pxNewBlockLink = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xWantedSize );
+            configASSERT( ( ( ( size_t ) pxNewBlockLink ) & portBYTE_ALIGNMENT_MASK ) == 0 );
+
+            /* Calculate the sizes of two blocks split from the single
+             * block. */
+            pxNewBlockLink->xBlockSize = pxBlock->xBlockSize - xWantedSize;
+            pxBlock->xBlockSize = xWantedSize;
+
+            /* Insert the new block into the list of free blocks. */
+            pxNewBlockLink->pxNextFreeBlock = pxPreviousBlock->pxNextFreeBlock;
+            pxPreviousBlock->pxNextFreeBlock = heapPROTECT_BLOCK_POINTER( pxNewBlockLink );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    else
+    {
+        pxBlock = NULL;
+    }
+
+    return pxBlock;
+}
+/*-----------------------------------------------------------*/
+
 void vPortFree( void * pv )
 {
     uint8_t * puc = ( uint8_t * ) pv;
     BlockLink_t * pxLink;
 
+    #if ( configUSE_HEAP_REGIONS == 1 )
+        HeapRegionState_t * pxRegion;
+    #endif
+
     if( pv != NULL )
     {
         /* The memory being freed will have an BlockLink_t structure immediately
@@ -408,6 +585,12 @@ void vPortFree( void * pv )
         {
             if( pxLink->pxNextFreeBlock == heapPROTECT_BLOCK_POINTER( NULL ) )
             {
+                #if ( configUSE_HEAP_PROFILER == 1 )
+                {
+                    vPortHeapProfilerRecordFree( pv, ( pxLink->xBlockSize & ~heapBLOCK_ALLOCATED_BITMASK ) );
+                }
+                #endif
+
                 /* The block is being returned to the heap - it is no longer
                  * allocated. */
                 heapFREE_BLOCK( pxLink );
@@ -427,7 +610,22 @@ void vPortFree( void * pv )
                     /* Add this block to the list of free blocks. */
                     xFreeBytesRemaining += pxLink->xBlockSize;
                     traceFREE( pv, pxLink->xBlockSize );
-                    prvInsertBlockIntoFreeList( ( ( BlockLink_t * ) pxLink ) );
+
+                    #if ( configUSE_HEAP_REGIONS == 1 )
+                    {
+                        /* Only the free list of the block's own region needs
+                         * to be searched. */
+                        pxRegion = prvGetRegion( pxLink );
+                        pxRegion->xFreeBytesRemaining += pxLink->xBlockSize;
+                        pxRegion->xNumberOfSuccessfulFrees++;
+                        prvInsertBlockIntoFreeList( pxRegion->pxHead, pxRegion->pxEnd, ( ( BlockLink_t * ) pxLink ) );
+                    }
+                    #else
+                    {
+                        prvInsertBlockIntoFreeList( &xStart, pxEnd, ( ( BlockLink_t * ) pxLink ) );
+                    }
+                    #endif
+
                     xNumberOfSuccessfulFrees++;
                 }
                 ( void ) xTaskResumeAll();
@@ -482,14 +680,16 @@ void * pvPortCalloc( size_t xNum,
 }
 /*-----------------------------------------------------------*/
 
-static void prvInsertBlockIntoFreeList( BlockLink_t * pxBlockToInsert ) /* PRIVILEGED_FUNCTION */
+static void prvInsertBlockIntoFreeList( BlockLink_t * pxHead,
+                                        BlockLink_t * pxRegionEnd,
+                                        BlockLink_t * pxBlockToInsert ) /* PRIVILEGED_FUNCTION */
 {
     BlockLink_t * pxIterator;
     uint8_t * puc;
 
     /* Iterate through the list until a block is found that has a higher address
      * than the block being inserted. */
-    for( pxIterator = &xStart; heapPROTECT_BLOCK_POINTER( pxIterator->pxNextFreeBlock ) < pxBlockToInsert; pxIterator = heapPROTECT_BLOCK_POINTER( pxIterator->pxNextFreeBlock ) )
+    for( pxIterator = pxHead; heapPROTECT_BLOCK_POINTER( pxIterator->pxNextFreeBlock ) < pxBlockToInsert; pxIterator = heapPROTECT_BLOCK_POINTER( pxIterator->pxNextFreeBlock ) )
     {
         /* Nothing to do here, just iterate to the right position. */
     }
@@ -519,7 +719,7 @@ static void prvInsertBlockIntoFreeList( BlockLink_t * pxBlockToInsert ) /* PRIVI
 
     if( ( puc + pxBlockToInsert->xBlockSize ) == ( uint8_t * ) heapPROTECT_BLOCK_POINTER( pxIterator->pxNextFreeBlock ) )
     {
-        if( heapPROTECT_BLOCK_POINTER( pxIterator->pxNextFreeBlock ) != pxEnd )
+        if( heapPROTECT_BLOCK_POINTER( pxIterator->pxNextFreeBlock ) != pxRegionEnd )
         {
             /* Form one big block from the two blocks. */
             pxBlockToInsert->xBlockSize += heapPROTECT_BLOCK_POINTER( pxIterator->pxNextFreeBlock )->xBlockSize;
@@ -527,7 +727,7 @@ static void prvInsertBlockIntoFreeList( BlockLink_t * pxBlockToInsert ) /* PRIVI
         }
         else
         {
-            pxBlockToInsert->pxNextFreeBlock = heapPROTECT_BLOCK_POINTER( pxEnd );
+            pxBlockToInsert->pxNextFreeBlock = heapPROTECT_BLOCK_POINTER( pxRegionEnd );
         }
     }
     else
@@ -646,6 +846,21 @@ void vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions ) /* PRIVI
 
         xTotalHeapSize += pxFirstFreeBlockInRegion->xBlockSize;
 
+        #if ( configUSE_HEAP_REGIONS == 1 )
+        {
+            /* The free list of the region follows xStart, or the end marker of
+             * the previous region, and stops at the region's own end marker. */
+            configASSERT( xDefinedRegions < configHEAP_MAX_REGIONS );
+
+            xRegions[ xDefinedRegions ].pxHead = ( pxPreviousFreeBlock != NULL ) ? pxPreviousFreeBlock : &xStart;
+            xRegions[ xDefinedRegions ].pxEnd = pxEnd;
+            xRegions[ xDefinedRegions ].xFreeBytesRemaining = pxFirstFreeBlockInRegion->xBlockSize;
+            xRegions[ xDefinedRegions ].xMinimumEverFreeBytesRemaining = pxFirstFreeBlockInRegion->xBlockSize;
+            xRegions[ xDefinedRegions ].xNumberOfSuccessfulAllocations = ( size_t ) 0U;
+            xRegions[ xDefinedRegions ].xNumberOfSuccessfulFrees = ( size_t ) 0U;
+        }
+        #endif /* configUSE_HEAP_REGIONS */
+
         #if ( configENABLE_HEAP_PROTECTOR == 1 )
         {
             if( ( pucHeapHighAddress == NULL ) ||
@@ -664,6 +879,12 @@ void vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions ) /* PRIVI
     xMinimumEverFreeBytesRemaining = xTotalHeapSize;
     xFreeBytesRemaining = xTotalHeapSize;
 
+    #if ( configUSE_HEAP_REGIONS == 1 )
+    {
+        xNumberOfRegions = xDefinedRegions;
+    }
+    #endif
+
     /* Check something was actually defined before it is accessed. */
     configASSERT( xTotalHeapSize );
 }
@@ -727,6 +948,89 @@ void vPortGetHeapStats( HeapStats_t * pxHeapStats )
 }
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_HEAP_REGIONS == 1 )
+
+    void vPortGetHeapRegionStats( UBaseType_t uxRegion,
+                                  HeapStats_t * pxHeapStats )
+    {
+        BlockLink_t * pxBlock;
+        HeapRegionState_t * pxRegion;
+        size_t xBlocks = 0, xMaxSize = 0, xMinSize = portMAX_DELAY; /* portMAX_DELAY used as a portable way of getting the maximum value. */
+
+        configASSERT( uxRegion < ( UBaseType_t ) xNumberOfRegions );
+
+        ( void ) memset( pxHeapStats, 0x00, sizeof( HeapStats_t ) );
+
+        if( uxRegion < ( UBaseType_t ) xNumberOfRegions )
+        {
+            pxRegion = &( xRegions[ uxRegion ] );
+
+            vTaskSuspendAll();
+            {
+                /* Only the blocks between the region's head and its end
+                 * marker belong to the region. */
+                pxBlock = heapPROTECT_BLOCK_POINTER( pxRegion->pxHead->pxNextFreeBlock );
+
+                while( pxBlock != pxRegion->pxEnd )
+                {
+                    xBlocks++;
+
+                    if( pxBlock->xBlockSize > xMaxSize )
+                    {
+                        xMaxSize = pxBlock->xBlockSize;
+                    }
+
+                    if( pxBlock->xBlockSize < xMinSize )
+                    {
+                        xMinSize = pxBlock->xBlockSize;
+                    }
+
+                    pxBlock = heapPROTECT_BLOCK_POINTER( pxBlock->pxNextFreeBlock );
+                }
+            }
+            ( void ) xTaskResumeAll();
+
+            pxHeapStats->xSizeOfLargestFreeBlockInBytes = xMaxSize;
+            pxHeapStats->xSizeOfSmallestFreeBlockInBytes = xMinSize;
+            pxHeapStats->xNumberOfFreeBlocks = xBlocks;
+
+            taskENTER_CRITICAL();
+            {
+                pxHeapStats->xAvailableHeapSpaceInBytes = pxRegion->xFreeBytesRemaining;
+                pxHeapStats->xNumberOfSuccessfulAllocations = pxRegion->xNumberOfSuccessfulAllocations;
+                pxHeapStats->xNumberOfSuccessfulFrees = pxRegion->xNumberOfSuccessfulFrees;
+                pxHeapStats->xMinimumEverFreeBytesRemaining = pxRegion->xMinimumEverFreeBytesRemaining;
+            }
+            taskEXIT_CRITICAL();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+#endif /* configUSE_HEAP_REGIONS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_HEAP_REGIONS == 1 )
+
+    static HeapRegionState_t * prvGetRegion( const BlockLink_t * pxBlock ) /* PRIVILEGED_FUNCTION */
+    {
+        BaseType_t xRegion = 0;
+
+        /* The regions are in address order, so the block is in the first
+         * region whose end marker is above it. */
+        while( ( xRegion < ( xNumberOfRegions - 1 ) ) && ( pxBlock > xRegions[ xRegion ].pxEnd ) )
+        {
+            xRegion++;
+        }
+
+        return &( xRegions[ xRegion ] );
+    }
+
+#endif /* configUSE_HEAP_REGIONS */
+/*-----------------------------------------------------------*/
+
 /*
  * Reset the state in this file. This state is normally initialized at start up.
  * This function must be called by the application before restarting the
@@ -741,6 +1045,14 @@ void vPortHeapResetState( void )
     xNumberOfSuccessfulAllocations = ( size_t ) 0U;
     xNumberOfSuccessfulFrees = ( size_t ) 0U;
 
+    #if ( configUSE_HEAP_REGIONS == 1 )
+        xNumberOfRegions = 0;
+    #endif /* #if ( configUSE_HEAP_REGIONS == 1 ) */
+
+    #if ( configUSE_HEAP_PROFILER == 1 )
+        vPortHeapProfilerResetState();
+    #endif /* #if ( configUSE_HEAP_PROFILER == 1 ) */
+
     #if ( configENABLE_HEAP_PROTECTOR == 1 )
         pucHeapHighAddress = NULL;
         pucHeapLowAddress = NULL;
@@ -0,0 +1,1005 @@
+/*
+ * FreeRTOS Kernel <DEVELOPMENT BRANCH>
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * A sample implementation of pvPortMalloc() and vPortFree() that allocates and
+ * frees memory in a time that does not depend on the number of free blocks,
+ * and combines (coalescences) adjacent memory blocks as they are freed.
+ *
+ * heap_4.c keeps all the free blocks in a single list, so finding a block that
+ * is large enough, and finding where a freed block goes, both take longer the
+ * more fragmented the heap becomes.  This file instead keeps the free blocks
+ * in segregated lists, as the Two-Level Segregated Fit (TLSF) allocator does.
+ * Each power of two range of block sizes is split into
+ * heapSECOND_LEVEL_INDEX_COUNT lists of equal size ranges, and a bitmap records
+ * which lists are not empty, so the smallest list that holds only blocks of at
+ * least the wanted size is found with a couple of bit operations.  Each block
+ * also records the block that precedes it in memory, so a freed block is
+ * merged with the blocks either side of it without searching.
+ *
+ * The cost is the list heads and bitmaps, about 1KB on a 32-bit processor, and
+ * allocations that may find a block larger than they need in a list above the
+ * one a best fit search would have used.
+ *
+ * See heap_1.c, heap_2.c, heap_3.c, heap_4.c and heap_5.c for alternative
+ * implementations, and the memory management pages of https://www.FreeRTOS.org
+ * for more information.
+ */
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers.  That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+    #error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
+#endif
+
+#ifndef configHEAP_CLEAR_MEMORY_ON_FREE
+    #define configHEAP_CLEAR_MEMORY_ON_FREE    0
+#endif
+
+/* Block sizes must not get too small.  A free block must be able to hold a
+ * whole BlockLink_t structure. */
+#define heapMINIMUM_BLOCK_SIZE    ( ( size_t ) ( ( sizeof( BlockLink_t ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) ) )
+
+/* Assumes 8bit bytes! */
+#define heapBITS_PER_BYTE         ( ( size_t ) 8 )
+
+/* Max value that fits in a size_t type. */
+#define heapSIZE_MAX              ( ~( ( size_t ) 0 ) )
+
+/* Check if multiplying a and b will result in overflow. */
+#define heapMULTIPLY_WILL_OVERFLOW( a, b )     ( ( ( a ) > 0 ) && ( ( b ) > ( heapSIZE_MAX / ( a ) ) ) )
+
+/* Check if adding a and b will result in overflow. */
+#define heapADD_WILL_OVERFLOW( a, b )          ( ( a ) > ( heapSIZE_MAX - ( b ) ) )
+
+/* Check if the subtraction operation ( a - b ) will result in underflow. */
+#define heapSUBTRACT_WILL_UNDERFLOW( a, b )    ( ( a ) < ( b ) )
+
+/* MSB of the xBlockSize member of an BlockLink_t structure is used to track
+ * the allocation status of a block.  When MSB of the xBlockSize member of
+ * an BlockLink_t structure is set then the block belongs to the application.
+ * When the bit is free the block is still part of the free heap space. */
+#define heapBLOCK_ALLOCATED_BITMASK    ( ( ( size_t ) 1 ) << ( ( sizeof( size_t ) * heapBITS_PER_BYTE ) - 1 ) )
+#define heapBLOCK_SIZE_IS_VALID( xBlockSize )    ( ( ( xBlockSize ) & heapBLOCK_ALLOCATED_BITMASK ) == 0 )
+#define heapBLOCK_IS_ALLOCATED( pxBlock )        ( ( ( pxBlock->xBlockSize ) & heapBLOCK_ALLOCATED_BITMASK ) != 0 )
+#define heapALLOCATE_BLOCK( pxBlock )            ( ( pxBlock->xBlockSize ) |= heapBLOCK_ALLOCATED_BITMASK )
+#define heapFREE_BLOCK( pxBlock )                ( ( pxBlock->xBlockSize ) &= ~heapBLOCK_ALLOCATED_BITMASK )
+#define heapBLOCK_SIZE( pxBlock )                ( ( pxBlock->xBlockSize ) & ~heapBLOCK_ALLOCATED_BITMASK )
+
+/* The block that follows pxBlock in memory.  The void cast is used to prevent
+ * byte alignment warnings from the compiler. */
+#define heapNEXT_PHYSICAL_BLOCK( pxBlock )       ( ( BlockLink_t * ) ( void * ) ( ( ( uint8_t * ) ( pxBlock ) ) + heapBLOCK_SIZE( pxBlock ) ) )
+
+/* Each power of two range of block sizes (the first level) is split into
+ * heapSECOND_LEVEL_INDEX_COUNT free lists (the second level), so a list never
+ * holds blocks whose sizes differ by more than about an eighth. */
+#define heapSECOND_LEVEL_INDEX_COUNT_LOG2    ( ( UBaseType_t ) 3U )
+#define heapSECOND_LEVEL_INDEX_COUNT         ( ( UBaseType_t ) 1U << heapSECOND_LEVEL_INDEX_COUNT_LOG2 )
+
+/* Blocks smaller than heapSMALL_BLOCK_SIZE are all held in the first first
+ * level range, in lists that are heapSMALL_BLOCK_STEP bytes apart. */
+#define heapFIRST_LEVEL_INDEX_SHIFT          ( heapSECOND_LEVEL_INDEX_COUNT_LOG2 + ( UBaseType_t ) 3U )
+#define heapSMALL_BLOCK_SIZE                 ( ( size_t ) 1 << heapFIRST_LEVEL_INDEX_SHIFT )
+#define heapSMALL_BLOCK_STEP                 ( heapSMALL_BLOCK_SIZE / ( size_t ) heapSECOND_LEVEL_INDEX_COUNT )
+
+/* Enough first level ranges to hold a block of any size, limited to the 32
+ * ranges the first level bitmap can record. */
+#define heapSIZE_BITS                        ( ( UBaseType_t ) ( sizeof( size_t ) * heapBITS_PER_BYTE ) )
+#define heapFIRST_LEVEL_INDEX_COUNT                                                                     \
+    ( ( ( heapSIZE_BITS - heapFIRST_LEVEL_INDEX_SHIFT ) + ( UBaseType_t ) 1U ) > ( UBaseType_t ) 32U ? \
+      ( UBaseType_t ) 32U : ( ( heapSIZE_BITS - heapFIRST_LEVEL_INDEX_SHIFT ) + ( UBaseType_t ) 1U ) )
+
+/*-----------------------------------------------------------*/
+
+/* Allocate the memory for the heap. */
+#if ( configAPPLICATION_ALLOCATED_HEAP == 1 )
+
+/* The application writer has already defined the array used for the RTOS
+ * heap - probably so it can be placed in a special segment or address. */
+    extern uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+#else
+    PRIVILEGED_DATA static uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+#endif /* configAPPLICATION_ALLOCATED_HEAP */
+
+/* Define the structure placed at the start of each block.  Only the first two
+ * members are kept while a block is allocated, the free list links occupy the
+ * start of the memory returned to the application. */
+typedef struct A_BLOCK_LINK
+{
+    struct A_BLOCK_LINK * pxPreviousPhysicalBlock; /**< The block immediately before this one in memory, or NULL for the first block. */
+    size_t xBlockSize;                             /**< The size of the block, including this structure. */
+    struct A_BLOCK_LINK * pxNextFreeBlock;         /**< The next block in the same free list.  Only valid while the block is free. */
+    struct A_BLOCK_LINK * pxPreviousFreeBlock;     /**< The previous block in the same free list.  Only valid while the block is free. */
+} BlockLink_t;
+
+/* Setting configENABLE_HEAP_PROTECTOR to 1 enables heap block pointers
+ * protection using an application supplied canary value to catch heap
+ * corruption should a heap buffer overflow occur.
+ */
+#if ( configENABLE_HEAP_PROTECTOR == 1 )
+
+/**
+ * @brief Application provided function to get a random value to be used as canary.
+ *
+ * @param pxHeapCanary [out] Output parameter to return the canary value.
+ */
+    extern void vApplicationGetRandomHeapCanary( portPOINTER_SIZE_TYPE * pxHeapCanary );
+
+/* Canary value for protecting internal heap pointers. */
+    PRIVILEGED_DATA static portPOINTER_SIZE_TYPE xHeapCanary;
+
+/* Macro to load/store BlockLink_t pointers to memory. By XORing the
+ * pointers with a random canary value, heap overflows will result
+ * in randomly unpredictable pointer values which will be caught by
+ * heapVALIDATE_BLOCK_POINTER assert. */
+    #define heapPROTECT_BLOCK_POINTER( pxBlock )    ( ( BlockLink_t * ) ( ( ( portPOINTER_SIZE_TYPE ) ( pxBlock ) ) ^ xHeapCanary ) )
+#else
+
+    #define heapPROTECT_BLOCK_POINTER( pxBlock )    ( pxBlock )
+
+#endif /* configENABLE_HEAP_PROTECTOR */
+
+/* Assert that a heap block pointer is within the heap bounds. */
+#define heapVALIDATE_BLOCK_POINTER( pxBlock )                          \
+    configASSERT( ( ( uint8_t * ) ( pxBlock ) >= &( ucHeap[ 0 ] ) ) && \
+                  ( ( uint8_t * ) ( pxBlock ) <= &( ucHeap[ configTOTAL_HEAP_SIZE - 1 ] ) ) )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Merges a block of memory that is being freed with the blocks immediately
+ * before and after it in memory if they are also free, then adds the result
+ * to the free list for its size.
+ */
+static void prvInsertBlockIntoFreeList( BlockLink_t * pxBlockToInsert ) PRIVILEGED_FUNCTION;
+
+/*
+ * Adds a free block to the head of the free list for its size, and marks that
+ * list as not empty in the bitmaps.
+ */
+static void prvAddBlockToFreeList( BlockLink_t * pxBlock ) PRIVILEGED_FUNCTION;
+
+/*
+ * Removes a free block from the free list for its size, and marks that list as
+ * empty in the bitmaps if it was the last block in the list.
+ */
+static void prvRemoveBlockFromFreeList( BlockLink_t * pxBlock ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns the first block of the smallest non-empty free list that only holds
+ * blocks of at least xWantedSize bytes, failing that the first block of the
+ * list xWantedSize falls in if it is large enough, or otherwise NULL.
+ */
+static BlockLink_t * prvFindSuitableBlock( size_t xWantedSize ) PRIVILEGED_FUNCTION;
+
+/*
+ * Sets *puxFirstLevel and *puxSecondLevel to the indexes of the free list that
+ * holds blocks of xBlockSize bytes.
+ */
+static void prvGetFreeListIndexes( size_t xBlockSize,
+                                   UBaseType_t * puxFirstLevel,
+                                   UBaseType_t * puxSecondLevel ) PRIVILEGED_FUNCTION;
+
+/*
+ * Return the position of the most significant set bit of a non-zero xValue,
+ * and of the least significant set bit of a non-zero ulValue.  Both take the
+ * same time whatever the value.
+ */
+static UBaseType_t prvHighestSetBit( size_t xValue ) PRIVILEGED_FUNCTION;
+static UBaseType_t prvLowestSetBit( uint32_t ulValue ) PRIVILEGED_FUNCTION;
+
+/*
+ * Called automatically to setup the required heap structures the first time
+ * pvPortMalloc() is called.
+ */
+static void prvHeapInit( void ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+/* The size of the structure placed at the beginning of each allocated memory
+ * block must by correctly byte aligned.  Only the members that come before the
+ * free list links are kept while the block is allocated. */
+static const size_t xHeapStructSize = ( offsetof( BlockLink_t, pxNextFreeBlock ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+/* The free lists, and the bitmaps recording which of them are not empty.  Bit
+ * n of uxFirstLevelBitmap is set if any bit of ulSecondLevelBitmap[ n ] is set,
+ * and bit m of ulSecondLevelBitmap[ n ] is set if pxFreeLists[ n ][ m ] is not
+ * empty. */
+PRIVILEGED_DATA static BlockLink_t * pxFreeLists[ heapFIRST_LEVEL_INDEX_COUNT ][ heapSECOND_LEVEL_INDEX_COUNT ];
+PRIVILEGED_DATA static uint32_t ulFirstLevelBitmap = 0U;
+PRIVILEGED_DATA static uint32_t ulSecondLevelBitmap[ heapFIRST_LEVEL_INDEX_COUNT ];
+
+/* Marks the end of the heap.  It is a block of size zero that is always
+ * allocated, so blocks are never merged past it. */
+PRIVILEGED_DATA static BlockLink_t * pxEnd = NULL;
+
+/* Keeps track of the number of calls to allocate and free memory as well as the
+ * number of free bytes remaining, but says nothing about fragmentation. */
+PRIVILEGED_DATA static size_t xFreeBytesRemaining = ( size_t ) 0U;
+PRIVILEGED_DATA static size_t xMinimumEverFreeBytesRemaining = ( size_t ) 0U;
+PRIVILEGED_DATA static size_t xNumberOfSuccessfulAllocations = ( size_t ) 0U;
+PRIVILEGED_DATA static size_t xNumberOfSuccessfulFrees = ( size_t ) 0U;
+
+/*-----------------------------------------------------------*/
+
+void * pvPortMalloc( size_t xWantedSize )
+{
+    BlockLink_t * pxBlock;
+    BlockLink_t * pxNewBlockLink;
+    void * pvReturn = NULL;
+    size_t xAdditionalRequiredSize;
+    size_t xAllocatedBlockSize = 0;
+
+    if( xWantedSize > 0 )
+    {
+        /* The wanted size must be increased so it can contain a BlockLink_t
+         * structure in addition to the requested amount of bytes. */
+        if( heapADD_WILL_OVERFLOW( xWantedSize, xHeapStructSize ) == 0 )
+        {
+            xWantedSize += xHeapStructSize;
+
+            /* Ensure that blocks are always aligned to the required number
+             * of bytes. */
+            if( ( xWantedSize & portBYTE_ALIGNMENT_MASK ) != 0x00 )
+            {
+                /* Byte alignment required. */
+                xAdditionalRequiredSize = portBYTE_ALIGNMENT - ( xWantedSize & portBYTE_ALIGNMENT_MASK );
+
+                if( heapADD_WILL_OVERFLOW( xWantedSize, xAdditionalRequiredSize ) == 0 )
+                {
+                    xWantedSize += xAdditionalRequiredSize;
+                }
+                else
+                {
+                    xWantedSize = 0;
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            /* The block must be able to hold the free list links once it is
+             * freed again. */
+            if( ( xWantedSize > 0 ) && ( xWantedSize < heapMINIMUM_BLOCK_SIZE ) )
+            {
+                xWantedSize = heapMINIMUM_BLOCK_SIZE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            xWantedSize = 0;
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    vTaskSuspendAll();
+    {
+        /* If this is the first call to malloc then the heap will require
+         * initialisation to setup the free lists. */
+        if( pxEnd == NULL )
+        {
+            prvHeapInit();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        /* Check the block size we are trying to allocate is not so large that the
+         * top bit is set.  The top bit of the block size member of the BlockLink_t
+         * structure is used to determine who owns the block - the application or
+         * the kernel, so it must be free. */
+        if( heapBLOCK_SIZE_IS_VALID( xWantedSize ) != 0 )
+        {
+            if( ( xWantedSize > 0 ) && ( xWantedSize <= xFreeBytesRemaining ) )
+            {
+                pxBlock = prvFindSuitableBlock( xWantedSize );
+
+                if( pxBlock != NULL )
+                {
+                    heapVALIDATE_BLOCK_POINTER( pxBlock );
+
+                    /* This block is being returned for use so must be taken out
+                     * of its free list. */
+                    prvRemoveBlockFromFreeList( pxBlock );
+
+                    /* If the block is larger than required it can be split into
+                     * two. */
+                    configASSERT( heapSUBTRACT_WILL_UNDERFLOW( pxBlock->xBlockSize, xWantedSize ) == 0 );
+
+                    if( ( pxBlock->xBlockSize - xWantedSize ) >= heapMINIMUM_BLOCK_SIZE )
+                    {
+                        /* This block is to be split into two.  Create a new
+                         * block following the number of bytes requested. The void
+                         * cast is used to prevent byte alignment warnings from the
+                         * compiler. */
+                        pxNewBlockLink = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xWantedSize );
+                        configASSERT( ( ( ( size_t ) pxNewBlockLink ) & portBYTE_ALIGNMENT_MASK ) == 0 );
+
+                        /* Calculate the sizes of two blocks split from the
+                         * single block. */
+                        pxNewBlockLink->xBlockSize = pxBlock->xBlockSize - xWantedSize;
+                        pxBlock->xBlockSize = xWantedSize;
+
+                        /* The new block sits between this block and the block
+                         * that followed it.  The block after it cannot be free,
+                         * as it would already have been merged with pxBlock, so
+                         * the new block goes straight into a free list. */
+                        pxNewBlockLink->pxPreviousPhysicalBlock = heapPROTECT_BLOCK_POINTER( pxBlock );
+                        heapNEXT_PHYSICAL_BLOCK( pxNewBlockLink )->pxPreviousPhysicalBlock = heapPROTECT_BLOCK_POINTER( pxNewBlockLink );
+                        prvAddBlockToFreeList( pxNewBlockLink );
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    xFreeBytesRemaining -= pxBlock->xBlockSize;
+
+                    if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+                    {
+                        xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    xAllocatedBlockSize = pxBlock->xBlockSize;
+
+                    /* The block is being returned - it is allocated and owned
+                     * by the application.  Return the memory space pointed to -
+                     * jumping over the BlockLink_t members at its start. */
+                    heapALLOCATE_BLOCK( pxBlock );
+                    pvReturn = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xHeapStructSize );
+                    xNumberOfSuccessfulAllocations++;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        traceMALLOC( pvReturn, xAllocatedBlockSize );
+
+        /* Prevent compiler warnings when trace macros are not used. */
+        ( void ) xAllocatedBlockSize;
+    }
+    ( void ) xTaskResumeAll();
+
+    #if ( configUSE_MALLOC_FAILED_HOOK == 1 )
+    {
+        if( pvReturn == NULL )
+        {
+            vApplicationMallocFailedHook();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    #endif /* if ( configUSE_MALLOC_FAILED_HOOK == 1 ) */
+
+    configASSERT( ( ( ( size_t ) pvReturn ) & ( size_t ) portBYTE_ALIGNMENT_MASK ) == 0 );
+    return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortFree( void * pv )
+{
+    uint8_t * puc = ( uint8_t * ) pv;
+    BlockLink_t * pxLink;
+
+    if( pv != NULL )
+    {
+        /* The memory being freed will have the BlockLink_t members that are
+         * kept while a block is allocated immediately before it. */
+        puc -= xHeapStructSize;
+
+        /* This casting is to keep the compiler from issuing warnings. */
+        pxLink = ( void * ) puc;
+
+        heapVALIDATE_BLOCK_POINTER( pxLink );
+        configASSERT( heapBLOCK_IS_ALLOCATED( pxLink ) != 0 );
+
+        if( heapBLOCK_IS_ALLOCATED( pxLink ) != 0 )
+        {
+            /* The block that follows an allocated block never changes, and
+             * must record this block as the one before it. */
+            heapVALIDATE_BLOCK_POINTER( heapNEXT_PHYSICAL_BLOCK( pxLink ) );
+            configASSERT( heapNEXT_PHYSICAL_BLOCK( pxLink )->pxPreviousPhysicalBlock == heapPROTECT_BLOCK_POINTER( pxLink ) );
+
+            if( heapNEXT_PHYSICAL_BLOCK( pxLink )->pxPreviousPhysicalBlock == heapPROTECT_BLOCK_POINTER( pxLink ) )
+            {
+                /* The block is being returned to the heap - it is no longer
+                 * allocated. */
+                heapFREE_BLOCK( pxLink );
+                #if ( configHEAP_CLEAR_MEMORY_ON_FREE == 1 )
+                {
+                    /* Check for underflow as this can occur if xBlockSize is
+                     * overwritten in a heap block. */
+                    if( heapSUBTRACT_WILL_UNDERFLOW( pxLink->xBlockSize, xHeapStructSize ) == 0 )
+                    {
+                        ( void ) memset( puc + xHeapStructSize, 0, pxLink->xBlockSize - xHeapStructSize );
+                    }
+                }
+                #endif
+
+                vTaskSuspendAll();
+                {
+                    /* Add this block to the free lists. */
+                    xFreeBytesRemaining += pxLink->xBlockSize;
+                    traceFREE( pv, pxLink->xBlockSize );
+                    prvInsertBlockIntoFreeList( ( ( BlockLink_t * ) pxLink ) );
+                    xNumberOfSuccessfulFrees++;
+                }
+                ( void ) xTaskResumeAll();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetFreeHeapSize( void )
+{
+    return xFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetMinimumEverFreeHeapSize( void )
+{
+    return xMinimumEverFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+void xPortResetHeapMinimumEverFreeHeapSize( void )
+{
+    xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+void vPortInitialiseBlocks( void )
+{
+    /* This just exists to keep the linker quiet. */
+}
+/*-----------------------------------------------------------*/
+
+void * pvPortCalloc( size_t xNum,
+                     size_t xSize )
+{
+    void * pv = NULL;
+
+    if( heapMULTIPLY_WILL_OVERFLOW( xNum, xSize ) == 0 )
+    {
+        pv = pvPortMalloc( xNum * xSize );
+
+        if( pv != NULL )
+        {
+            ( void ) memset( pv, 0, xNum * xSize );
+        }
+    }
+
+    return pv;
+}
+/*-----------------------------------------------------------*/
+
+static void prvHeapInit( void ) /* PRIVILEGED_FUNCTION */
+{
+    BlockLink_t * pxFirstFreeBlock;
+    portPOINTER_SIZE_TYPE uxStartAddress, uxEndAddress;
+    size_t xTotalHeapSize = configTOTAL_HEAP_SIZE;
+    UBaseType_t uxFirstLevel, uxSecondLevel;
+
+    /* Ensure the heap starts on a correctly aligned boundary. */
+    uxStartAddress = ( portPOINTER_SIZE_TYPE ) ucHeap;
+
+    if( ( uxStartAddress & portBYTE_ALIGNMENT_MASK ) != 0 )
+    {
+        uxStartAddress += ( portBYTE_ALIGNMENT - 1 );
+        uxStartAddress &= ~( ( portPOINTER_SIZE_TYPE ) portBYTE_ALIGNMENT_MASK );
+        xTotalHeapSize -= ( size_t ) ( uxStartAddress - ( portPOINTER_SIZE_TYPE ) ucHeap );
+    }
+
+    #if ( configENABLE_HEAP_PROTECTOR == 1 )
+    {
+        vApplicationGetRandomHeapCanary( &( xHeapCanary ) );
+    }
+    #endif
+
+    /* All the free lists start empty. */
+    for( uxFirstLevel = 0; uxFirstLevel < heapFIRST_LEVEL_INDEX_COUNT; uxFirstLevel++ )
+    {
+        for( uxSecondLevel = 0; uxSecondLevel < heapSECOND_LEVEL_INDEX_COUNT; uxSecondLevel++ )
+        {
+            pxFreeLists[ uxFirstLevel ][ uxSecondLevel ] = heapPROTECT_BLOCK_POINTER( NULL );
+        }
+
+        ulSecondLevelBitmap[ uxFirstLevel ] = 0U;
+    }
+
+    ulFirstLevelBitmap = 0U;
+
+    /* pxEnd is used to mark the end of the heap space.  Only the members kept
+     * while a block is allocated are written, so it needs no more than
+     * xHeapStructSize bytes. */
+    uxEndAddress = uxStartAddress + ( portPOINTER_SIZE_TYPE ) xTotalHeapSize;
+    uxEndAddress -= ( portPOINTER_SIZE_TYPE ) xHeapStructSize;
+    uxEndAddress &= ~( ( portPOINTER_SIZE_TYPE ) portBYTE_ALIGNMENT_MASK );
+    pxEnd = ( BlockLink_t * ) uxEndAddress;
+    pxEnd->xBlockSize = 0;
+    heapALLOCATE_BLOCK( pxEnd );
+
+    /* To start with there is a single free block that is sized to take up the
+     * entire heap space, minus the space taken by pxEnd. */
+    pxFirstFreeBlock = ( BlockLink_t * ) uxStartAddress;
+    pxFirstFreeBlock->xBlockSize = ( size_t ) ( uxEndAddress - ( portPOINTER_SIZE_TYPE ) pxFirstFreeBlock );
+    pxFirstFreeBlock->pxPreviousPhysicalBlock = heapPROTECT_BLOCK_POINTER( NULL );
+    pxEnd->pxPreviousPhysicalBlock = heapPROTECT_BLOCK_POINTER( pxFirstFreeBlock );
+    prvAddBlockToFreeList( pxFirstFreeBlock );
+
+    /* Only one block exists - and it covers the entire usable heap space. */
+    xMinimumEverFreeBytesRemaining = pxFirstFreeBlock->xBlockSize;
+    xFreeBytesRemaining = pxFirstFreeBlock->xBlockSize;
+}
+/*-----------------------------------------------------------*/
+
+static void prvInsertBlockIntoFreeList( BlockLink_t * pxBlockToInsert ) /* PRIVILEGED_FUNCTION */
+{
+    BlockLink_t * pxNextBlock;
+    BlockLink_t * pxPreviousBlock;
+
+    /* Is the block after the block being inserted free?  pxEnd is always
+     * allocated, so this never looks past the end of the heap. */
+    pxNextBlock = heapNEXT_PHYSICAL_BLOCK( pxBlockToInsert );
+    heapVALIDATE_BLOCK_POINTER( pxNextBlock );
+
+    if( heapBLOCK_IS_ALLOCATED( pxNextBlock ) == 0 )
+    {
+        /* Form one big block from the two blocks. */
+        prvRemoveBlockFromFreeList( pxNextBlock );
+        pxBlockToInsert->xBlockSize += pxNextBlock->xBlockSize;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    /* Is the block before the block being inserted free? */
+    pxPreviousBlock = heapPROTECT_BLOCK_POINTER( pxBlockToInsert->pxPreviousPhysicalBlock );
+
+    if( pxPreviousBlock != NULL )
+    {
+        heapVALIDATE_BLOCK_POINTER( pxPreviousBlock );
+
+        if( heapBLOCK_IS_ALLOCATED( pxPreviousBlock ) == 0 )
+        {
+            prvRemoveBlockFromFreeList( pxPreviousBlock );
+            pxPreviousBlock->xBlockSize += pxBlockToInsert->xBlockSize;
+            pxBlockToInsert = pxPreviousBlock;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    /* The block after the merged block must now record it as the block that
+     * precedes it. */
+    heapNEXT_PHYSICAL_BLOCK( pxBlockToInsert )->pxPreviousPhysicalBlock = heapPROTECT_BLOCK_POINTER( pxBlockToInsert );
+
+    prvAddBlockToFreeList( pxBlockToInsert );
+}
+/*-----------------------------------------------------------*/
+
+static void prvAddBlockToFreeList( BlockLink_t * pxBlock ) /* PRIVILEGED_FUNCTION */
+{
+    BlockLink_t * pxFirstBlock;
+    UBaseType_t uxFirstLevel, uxSecondLevel;
+
+    prvGetFreeListIndexes( pxBlock->xBlockSize, &uxFirstLevel, &uxSecondLevel );
+
+    pxFirstBlock = heapPROTECT_BLOCK_POINTER( pxFreeLists[ uxFirstLevel ][ uxSecondLevel ] );
+
+    pxBlock->pxNextFreeBlock = heapPROTECT_BLOCK_POINTER( pxFirstBlock );
+    pxBlock->pxPreviousFreeBlock = heapPROTECT_BLOCK_POINTER( NULL );
+
+    if( pxFirstBlock != NULL )
+    {
+        heapVALIDATE_BLOCK_POINTER( pxFirstBlock );
+        pxFirstBlock->pxPreviousFreeBlock = heapPROTECT_BLOCK_POINTER( pxBlock );
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    pxFreeLists[ uxFirstLevel ][ uxSecondLevel ] = heapPROTECT_BLOCK_POINTER( pxBlock );
+    ulFirstLevelBitmap |= ( uint32_t ) 1U << uxFirstLevel;
+    ulSecondLevelBitmap[ uxFirstLevel ] |= ( uint32_t ) 1U << uxSecondLevel;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRemoveBlockFromFreeList( BlockLink_t * pxBlock ) /* PRIVILEGED_FUNCTION */
+{
+    BlockLink_t * pxNextBlock;
+    BlockLink_t * pxPreviousBlock;
+    UBaseType_t uxFirstLevel, uxSecondLevel;
+
+    prvGetFreeListIndexes( pxBlock->xBlockSize, &uxFirstLevel, &uxSecondLevel );
+
+    pxNextBlock = heapPROTECT_BLOCK_POINTER( pxBlock->pxNextFreeBlock );
+    pxPreviousBlock = heapPROTECT_BLOCK_POINTER( pxBlock->pxPreviousFreeBlock );
+
+    if( pxNextBlock != NULL )
+    {
+        heapVALIDATE_BLOCK_POINTER( pxNextBlock );
+        pxNextBlock->pxPreviousFreeBlock = heapPROTECT_BLOCK_POINTER( pxPreviousBlock );
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    if( pxPreviousBlock != NULL )
+    {
+        heapVALIDATE_BLOCK_POINTER( pxPreviousBlock );
+        pxPreviousBlock->pxNextFreeBlock = heapPROTECT_BLOCK_POINTER( pxNextBlock );
+    }
+    else
+    {
+        /* The block was at the head of its list. */
+        configASSERT( pxFreeLists[ uxFirstLevel ][ uxSecondLevel ] == heapPROTECT_BLOCK_POINTER( pxBlock ) );
+        pxFreeLists[ uxFirstLevel ][ uxSecondLevel ] = heapPROTECT_BLOCK_POINTER( pxNextBlock );
+
+        if( pxNextBlock == NULL )
+        {
+            ulSecondLevelBitmap[ uxFirstLevel ] &= ~( ( uint32_t ) 1U << uxSecondLevel );
+
+            if( ulSecondLevelBitmap[ uxFirstLevel ] == 0U )
+            {
+                ulFirstLevelBitmap &= ~( ( uint32_t ) 1U << uxFirstLevel );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static BlockLink_t * prvFindSuitableBlock( size_t xWantedSize ) /* PRIVILEGED_FUNCTION */
+{
+    BlockLink_t * pxBlock = NULL;
+    UBaseType_t uxFirstLevel, uxSecondLevel;
+    size_t xRoundUp;
+    uint32_t ulBitmap;
+
+    /* Round the wanted size up to the start of the next free list, so every
+     * block in the list found is large enough and only the first need be
+     * looked at. */
+    if( xWantedSize < heapSMALL_BLOCK_SIZE )
+    {
+        xRoundUp = heapSMALL_BLOCK_STEP - ( size_t ) 1;
+    }
+    else
+    {
+        xRoundUp = ( ( size_t ) 1 << ( prvHighestSetBit( xWantedSize ) - heapSECOND_LEVEL_INDEX_COUNT_LOG2 ) ) - ( size_t ) 1;
+    }
+
+    if( heapADD_WILL_OVERFLOW( xWantedSize, xRoundUp ) == 0 )
+    {
+        prvGetFreeListIndexes( xWantedSize + xRoundUp, &uxFirstLevel, &uxSecondLevel );
+
+        if( uxFirstLevel < heapFIRST_LEVEL_INDEX_COUNT )
+        {
+            /* Look for a non-empty list at or above uxSecondLevel in the same
+             * power of two range first. */
+            ulBitmap = ulSecondLevelBitmap[ uxFirstLevel ] & ( ~( uint32_t ) 0U << uxSecondLevel );
+
+            if( ulBitmap == 0U )
+            {
+                /* Otherwise use the first non-empty list in the smallest
+                 * larger range that has one. */
+                if( ( uxFirstLevel + ( UBaseType_t ) 1U ) < ( UBaseType_t ) 32U )
+                {
+                    ulBitmap = ulFirstLevelBitmap & ( ~( uint32_t ) 0U << ( uxFirstLevel + ( UBaseType_t ) 1U ) );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                if( ulBitmap != 0U )
+                {
+                    uxFirstLevel = prvLowestSetBit( ulBitmap );
+                    ulBitmap = ulSecondLevelBitmap[ uxFirstLevel ];
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            if( ulBitmap != 0U )
+            {
+                uxSecondLevel = prvLowestSetBit( ulBitmap );
+                pxBlock = heapPROTECT_BLOCK_POINTER( pxFreeLists[ uxFirstLevel ][ uxSecondLevel ] );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    /* No list holds only blocks that are large enough, but the list the wanted
+     * size itself falls in may still hold one that is.  Only the first block
+     * of that list is looked at, so the time taken stays bounded. */
+    if( pxBlock == NULL )
+    {
+        prvGetFreeListIndexes( xWantedSize, &uxFirstLevel, &uxSecondLevel );
+
+        if( uxFirstLevel < heapFIRST_LEVEL_INDEX_COUNT )
+        {
+            pxBlock = heapPROTECT_BLOCK_POINTER( pxFreeLists[ uxFirstLevel ][ uxSecondLevel ] );
+
+            if( ( pxBlock != NULL ) && ( pxBlock->xBlockSize < xWantedSize ) )
+            {
+                pxBlock = NULL;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    return pxBlock;
+}
+/*-----------------------------------------------------------*/
+
+static void prvGetFreeListIndexes( size_t xBlockSize,
+                                   UBaseType_t * puxFirstLevel,
+                                   UBaseType_t * puxSecondLevel ) /* PRIVILEGED_FUNCTION */
+{
+    UBaseType_t uxHighestBit;
+
+    if( xBlockSize < heapSMALL_BLOCK_SIZE )
+    {
+        /* Small blocks are held in evenly spaced lists in the first range. */
+        *puxFirstLevel = ( UBaseType_t ) 0U;
+        *puxSecondLevel = ( UBaseType_t ) ( xBlockSize / heapSMALL_BLOCK_STEP );
+    }
+    else
+    {
+        /* The first level is the power of two range, and the second level is
+         * given by the bits that follow the most significant set bit. */
+        uxHighestBit = prvHighestSetBit( xBlockSize );
+        *puxFirstLevel = uxHighestBit - ( heapFIRST_LEVEL_INDEX_SHIFT - ( UBaseType_t ) 1U );
+        *puxSecondLevel = ( UBaseType_t ) ( xBlockSize >> ( uxHighestBit - heapSECOND_LEVEL_INDEX_COUNT_LOG2 ) ) ^ heapSECOND_LEVEL_INDEX_COUNT;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvHighestSetBit( size_t xValue ) /* PRIVILEGED_FUNCTION */
+{
+    static const uint8_t ucBitPositions[ 32 ] =
+    {
+        0U,  9U,  1U,  10U, 13U, 21U, 2U,  29U, 11U, 14U, 16U, 18U, 22U, 25U, 3U, 30U,
+        8U,  12U, 20U, 28U, 15U, 17U, 24U, 7U,  19U, 27U, 23U, 6U,  26U, 5U,  4U, 31U
+    };
+    UBaseType_t uxBase = ( UBaseType_t ) 0U;
+    uint32_t ulValue;
+
+    /* Look at the upper half of a 64-bit size_t if any of it is set.  The
+     * shift is done in two steps so it is still defined when size_t only has
+     * 32 bits. */
+    if( ( ( xValue >> 16 ) >> 16 ) != ( size_t ) 0U )
+    {
+        xValue = ( xValue >> 16 ) >> 16;
+        uxBase = ( UBaseType_t ) 32U;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    /* Set every bit below the most significant set bit, then use a de Bruijn
+     * sequence to map the result to the bit's position. */
+    ulValue = ( uint32_t ) xValue;
+    ulValue |= ulValue >> 1;
+    ulValue |= ulValue >> 2;
+    ulValue |= ulValue >> 4;
+    ulValue |= ulValue >> 8;
+    ulValue |= ulValue >> 16;
+
+    return uxBase + ( UBaseType_t ) ucBitPositions[ ( uint32_t ) ( ulValue * 0x07C4ACDDUL ) >> 27 ];
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvLowestSetBit( uint32_t ulValue ) /* PRIVILEGED_FUNCTION */
+{
+    static const uint8_t ucBitPositions[ 32 ] =
+    {
+        0U,  1U,  28U, 2U,  29U, 14U, 24U, 3U, 30U, 22U, 20U, 15U, 25U, 17U, 4U,  8U,
+        31U, 27U, 13U, 23U, 21U, 19U, 16U, 7U, 26U, 12U, 18U, 6U,  11U, 5U,  10U, 9U
+    };
+
+    /* Isolate the least significant set bit, then use a de Bruijn sequence to
+     * map it to its position. */
+    ulValue &= ( ~ulValue ) + 1U;
+
+    return ( UBaseType_t ) ucBitPositions[ ( uint32_t ) ( ulValue * 0x077CB531UL ) >> 27 ];
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetHeapStats( HeapStats_t * pxHeapStats )
+{
+    BlockLink_t * pxBlock;
+    UBaseType_t uxFirstLevel, uxSecondLevel;
+    size_t xBlocks = 0, xMaxSize = 0, xMinSize = portMAX_DELAY; /* portMAX_DELAY used as a portable way of getting the maximum value. */
+
+    vTaskSuspendAll();
+    {
+        /* Every list is empty if the heap has not been initialised.  The heap
+         * is initialised automatically when the first allocation is made. */
+        for( uxFirstLevel = 0; uxFirstLevel < heapFIRST_LEVEL_INDEX_COUNT; uxFirstLevel++ )
+        {
+            if( ( ulFirstLevelBitmap & ( ( uint32_t ) 1U << uxFirstLevel ) ) != 0U )
+            {
+                for( uxSecondLevel = 0; uxSecondLevel < heapSECOND_LEVEL_INDEX_COUNT; uxSecondLevel++ )
+                {
+                    if( ( ulSecondLevelBitmap[ uxFirstLevel ] & ( ( uint32_t ) 1U << uxSecondLevel ) ) != 0U )
+                    {
+                        pxBlock = heapPROTECT_BLOCK_POINTER( pxFreeLists[ uxFirstLevel ][ uxSecondLevel ] );
+
+                        while( pxBlock != NULL )
+                        {
+                            heapVALIDATE_BLOCK_POINTER( pxBlock );
+
+                            /* Increment the number of blocks and record the
+                             * largest and smallest blocks seen so far. */
+                            xBlocks++;
+
+                            if( pxBlock->xBlockSize > xMaxSize )
+                            {
+                                xMaxSize = pxBlock->xBlockSize;
+                            }
+
+                            if( pxBlock->xBlockSize < xMinSize )
+                            {
+                                xMinSize = pxBlock->xBlockSize;
+                            }
+
+                            pxBlock = heapPROTECT_BLOCK_POINTER( pxBlock->pxNextFreeBlock );
+                        }
+                    }
+                }
+            }
+        }
+    }
+    ( void ) xTaskResumeAll();
+
+    pxHeapStats->xSizeOfLargestFreeBlockInBytes = xMaxSize;
+    pxHeapStats->xSizeOfSmallestFreeBlockInBytes = xMinSize;
+    pxHeapStats->xNumberOfFreeBlocks = xBlocks;
+
+    taskENTER_CRITICAL();
+    {
+        pxHeapStats->xAvailableHeapSpaceInBytes = xFreeBytesRemaining;
+        pxHeapStats->xNumberOfSuccessfulAllocations = xNumberOfSuccessfulAllocations;
+        pxHeapStats->xNumberOfSuccessfulFrees = xNumberOfSuccessfulFrees;
+        pxHeapStats->xMinimumEverFreeBytesRemaining = xMinimumEverFreeBytesRemaining;
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Reset the state in this file. This state is normally initialized at start up.
+ * This function must be called by the application before restarting the
+ * scheduler.
+ */
+void vPortHeapResetState( void )
+{
+    pxEnd = NULL;
+
+    ulFirstLevelBitmap = 0U;
+    ( void ) memset( ulSecondLevelBitmap, 0, sizeof( ulSecondLevelBitmap ) );
+
+    xFreeBytesRemaining = ( size_t ) 0U;
+    xMinimumEverFreeBytesRemaining = ( size_t ) 0U;
+    xNumberOfSuccessfulAllocations = ( size_t ) 0U;
+    xNumberOfSuccessfulFrees = ( size_t ) 0U;
+}
+/*-----------------------------------------------------------*/
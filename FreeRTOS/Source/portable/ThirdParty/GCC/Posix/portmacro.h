@@ -140,6 +140,14 @@ extern void vPortCancelThread( void * pxTaskToDelete );
  */
 #define portMEMORY_BARRIER()                        __asm volatile ( "" ::: "memory" )
 
+/*
+ * Masking interrupts from an ISR is a no-op in this port, so a compare-and-swap
+ * built from a critical section would not be atomic with respect to the tick
+ * signal.  Use the compiler's atomic builtin instead.
+ */
+#define portCOMPARE_AND_SWAP_SIZE( pxDestination, xExchange, xComparand ) \
+    ( __sync_bool_compare_and_swap( ( pxDestination ), ( xComparand ), ( xExchange ) ) ? pdTRUE : pdFALSE )
+
 extern uint32_t ulPortGetRunTime( void );
 #define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()    /* no-op */
 #define portGET_RUN_TIME_COUNTER_VALUE()            ulPortGetRunTime()
@@ -133,12 +133,73 @@ typedef struct QueueDefinition /* The old naming convention is used to prevent b
         UBaseType_t uxQueueNumber;
         uint8_t ucQueueType;
     #endif
+
+    #if ( configUSE_SPSC_QUEUES == 1 )
+        volatile UBaseType_t uxItemsSent;     /**< The number of items the sending task has placed in a single producer single consumer queue.  Only written by the sending task. */
+        volatile UBaseType_t uxItemsReceived; /**< The number of items the receiving task has removed from a single producer single consumer queue.  Only written by the receiving task. */
+        uint8_t ucIsSPSC;                     /**< Set to pdTRUE if the queue was created by xQueueCreateSPSC(), in which case uxMessagesWaiting is not used. */
+    #endif
+
+    #if ( configUSE_ZERO_COPY_QUEUES == 1 )
+        struct QueueDefinition * pxBufferPool; /**< The queue of free buffers if the queue was created by xQueueCreateZeroCopy(), otherwise NULL. */
+        int8_t * pcBufferStorage;              /**< Points to the header of the first buffer in the pool. */
+        size_t xBufferStride;                  /**< The distance between the headers of consecutive buffers in the pool. */
+    #endif
 } xQUEUE;
 
 /* The old xQUEUE name is maintained above then typedefed to the new Queue_t
  * name below to enable the use of older kernel aware debuggers. */
 typedef xQUEUE Queue_t;
 
+/* The number of items in a queue.  A single producer single consumer queue
+ * counts the items sent and the items received separately so each count only
+ * has one writer, and the difference is the number of items in the queue. */
+#if ( configUSE_SPSC_QUEUES == 1 )
+    #define queueMESSAGES_WAITING( pxQueue )                                                                              \
+    ( ( ( pxQueue )->ucIsSPSC != ( uint8_t ) pdFALSE ) ?                                                                  \
+      ( UBaseType_t ) ( ( pxQueue )->uxItemsSent - ( pxQueue )->uxItemsReceived ) : ( pxQueue )->uxMessagesWaiting )
+    #define queueASSERT_NOT_SPSC( pxQueue )    configASSERT( ( pxQueue )->ucIsSPSC == ( uint8_t ) pdFALSE )
+#else
+    #define queueMESSAGES_WAITING( pxQueue )    ( ( pxQueue )->uxMessagesWaiting )
+    #define queueASSERT_NOT_SPSC( pxQueue )
+#endif
+
+#if ( configUSE_ZERO_COPY_QUEUES == 1 )
+
+/* Each buffer in the pool of a zero copy queue is preceded by a header that
+ * records the state of the buffer and the task that owns it.  The header is
+ * only written by the task that owns the buffer, or by the task that created
+ * the pool, so it is not protected by a critical section. */
+    typedef struct QueueBufferHeader
+    {
+        TaskHandle_t xOwner; /**< The task that acquired or received the buffer, or NULL if the buffer is free or in the queue. */
+        uint8_t ucState;     /**< One of the queueBUFFER_ state bits below. */
+    } QueueBufferHeader_t;
+
+/* The states of a buffer.  Each state is a separate bit so the states in
+ * which an operation is valid can be checked with a single mask. */
+    #define queueBUFFER_FREE        ( ( uint8_t ) 0x01U )
+    #define queueBUFFER_ACQUIRED    ( ( uint8_t ) 0x02U )
+    #define queueBUFFER_QUEUED      ( ( uint8_t ) 0x04U )
+    #define queueBUFFER_RECEIVED    ( ( uint8_t ) 0x08U )
+
+/* The buffer handed to the application starts after the header, at an
+ * address that meets the alignment requirements of the port. */
+    #define queueBUFFER_HEADER_SIZE                                                    \
+    ( ( sizeof( QueueBufferHeader_t ) + ( size_t ) portBYTE_ALIGNMENT_MASK ) & \
+      ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) )
+
+/* The largest size of each part of the allocation made by
+ * xQueueCreateZeroCopy(). */
+    #define queueZERO_COPY_MAX_PART_SIZE    ( SIZE_MAX / ( size_t ) 4U )
+
+    #if ( configCHECK_ZERO_COPY_BUFFERS == 1 )
+        #define queueCHECK_BUFFER( pxQueue, pxHeader, ucValidStates )    prvCheckBuffer( ( pxQueue ), ( pxHeader ), ( ucValidStates ) )
+    #else
+        #define queueCHECK_BUFFER( pxQueue, pxHeader, ucValidStates )
+    #endif
+#endif /* configUSE_ZERO_COPY_QUEUES */
+
 /*-----------------------------------------------------------*/
 
 /*
@@ -210,6 +271,66 @@ static BaseType_t prvCopyDataToQueue( Queue_t * const pxQueue,
 static void prvCopyDataFromQueue( Queue_t * const pxQueue,
                                   void * const pvBuffer ) PRIVILEGED_FUNCTION;
 
+/*
+ * Copy uxItemCount items into or out of a queue, with at most two calls to
+ * memcpy() as the items can only wrap around the end of the storage area
+ * once.  The caller must have checked there is space for, or there are,
+ * uxItemCount items.
+ */
+static void prvCopyItemsToQueue( Queue_t * const pxQueue,
+                                 const uint8_t * pucItems,
+                                 const UBaseType_t uxItemCount ) PRIVILEGED_FUNCTION;
+static void prvCopyItemsFromQueue( Queue_t * const pxQueue,
+                                   uint8_t * pucBuffer,
+                                   const UBaseType_t uxItemCount ) PRIVILEGED_FUNCTION;
+
+/*
+ * Unblock up to one waiting task for each of uxItemCount items added to or
+ * removed from a queue.  Must be called from a critical section while the
+ * queue is not locked.  Returns pdTRUE if an unblocked task has a priority
+ * above that of the calling task.
+ */
+static BaseType_t prvUnblockReceivers( Queue_t * const pxQueue,
+                                       const UBaseType_t uxItemCount ) PRIVILEGED_FUNCTION;
+static BaseType_t prvUnblockSenders( Queue_t * const pxQueue,
+                                     const UBaseType_t uxItemCount ) PRIVILEGED_FUNCTION;
+
+#if ( configUSE_SPSC_QUEUES == 1 )
+
+/*
+ * Send to and receive from a single producer single consumer queue.  An item
+ * that can be sent or received straight away is copied without entering a
+ * critical section, and the calling task only falls back to the event lists
+ * when it has to block, or when the other task is blocked on the queue.
+ */
+    static BaseType_t prvSPSCSend( Queue_t * const pxQueue,
+                                   const void * const pvItemToQueue,
+                                   TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+    static BaseType_t prvSPSCReceive( Queue_t * const pxQueue,
+                                      void * const pvBuffer,
+                                      TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+#endif
+
+#if ( configUSE_ZERO_COPY_QUEUES == 1 )
+
+/*
+ * Returns the header of a buffer from the pool of a zero copy queue.
+ */
+    static QueueBufferHeader_t * prvGetBufferHeader( void * pvBuffer ) PRIVILEGED_FUNCTION;
+#endif
+
+#if ( ( configUSE_ZERO_COPY_QUEUES == 1 ) && ( configCHECK_ZERO_COPY_BUFFERS == 1 ) )
+
+/*
+ * Asserts that pxHeader is the header of one of the buffers in the pool of
+ * pxQueue, that the buffer is in one of the states in ucValidStates, and that
+ * a buffer that is owned by a task is owned by the calling task.
+ */
+    static void prvCheckBuffer( const Queue_t * const pxQueue,
+                                const QueueBufferHeader_t * const pxHeader,
+                                uint8_t ucValidStates ) PRIVILEGED_FUNCTION;
+#endif
+
 #if ( configUSE_QUEUE_SETS == 1 )
 
 /*
@@ -320,6 +441,14 @@ BaseType_t xQueueGenericReset( QueueHandle_t xQueue,
             pxQueue->u.xQueue.pcTail = pxQueue->pcHead + ( pxQueue->uxLength * pxQueue->uxItemSize );
             pxQueue->uxMessagesWaiting = ( UBaseType_t ) 0U;
             pxQueue->pcWriteTo = pxQueue->pcHead;
+
+            #if ( configUSE_SPSC_QUEUES == 1 )
+            {
+                pxQueue->uxItemsSent = ( UBaseType_t ) 0U;
+                pxQueue->uxItemsReceived = ( UBaseType_t ) 0U;
+            }
+            #endif /* configUSE_SPSC_QUEUES */
+
             pxQueue->u.xQueue.pcReadFrom = pxQueue->pcHead + ( ( pxQueue->uxLength - 1U ) * pxQueue->uxItemSize );
             pxQueue->cRxLock = queueUNLOCKED;
             pxQueue->cTxLock = queueUNLOCKED;
@@ -524,7 +653,7 @@ BaseType_t xQueueGenericReset( QueueHandle_t xQueue,
             /* MISRA Ref 11.5.1 [Malloc memory assignment] */
             /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
             /* coverity[misra_c_2012_rule_11_5_violation] */
-            pxNewQueue = ( Queue_t * ) pvPortMalloc( sizeof( Queue_t ) + xQueueSizeInBytes );
+            pxNewQueue = ( Queue_t * ) pvPortMallocQueue( sizeof( Queue_t ) + xQueueSizeInBytes );
 
             if( pxNewQueue != NULL )
             {
@@ -606,6 +735,32 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength,
     }
     #endif /* configUSE_QUEUE_SETS */
 
+    #if ( configUSE_ZERO_COPY_QUEUES == 1 )
+    {
+        /* xQueueCreateZeroCopy() attaches the pool after the queue has been
+         * initialised. */
+        pxNewQueue->pxBufferPool = NULL;
+        pxNewQueue->pcBufferStorage = NULL;
+        pxNewQueue->xBufferStride = ( size_t ) 0U;
+    }
+    #endif /* configUSE_ZERO_COPY_QUEUES */
+
+    #if ( configUSE_SPSC_QUEUES == 1 )
+    {
+        if( ucQueueType == queueQUEUE_TYPE_SPSC )
+        {
+            /* The items are copied in and out of the storage area, so a
+             * single producer single consumer queue cannot be a semaphore. */
+            configASSERT( uxItemSize != ( UBaseType_t ) 0 );
+            pxNewQueue->ucIsSPSC = ( uint8_t ) pdTRUE;
+        }
+        else
+        {
+            pxNewQueue->ucIsSPSC = ( uint8_t ) pdFALSE;
+        }
+    }
+    #endif /* configUSE_SPSC_QUEUES */
+
     traceQUEUE_CREATE( pxNewQueue );
 }
 /*-----------------------------------------------------------*/
@@ -957,6 +1112,29 @@ BaseType_t xQueueGenericSend( QueueHandle_t xQueue,
     }
     #endif
 
+    #if ( configUSE_SPSC_QUEUES == 1 )
+    {
+        if( pxQueue->ucIsSPSC != ( uint8_t ) pdFALSE )
+        {
+            BaseType_t xReturn;
+
+            /* Items can only be added to the back of a single producer single
+             * consumer queue, as the receiving task owns the front. */
+            configASSERT( xCopyPosition == queueSEND_TO_BACK );
+
+            xReturn = prvSPSCSend( pxQueue, pvItemToQueue, xTicksToWait );
+
+            traceRETURN_xQueueGenericSend( xReturn );
+
+            return xReturn;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    #endif /* configUSE_SPSC_QUEUES */
+
     for( ; ; )
     {
         taskENTER_CRITICAL();
@@ -1169,6 +1347,7 @@ BaseType_t xQueueGenericSendFromISR( QueueHandle_t xQueue,
     configASSERT( pxQueue );
     configASSERT( !( ( pvItemToQueue == NULL ) && ( pxQueue->uxItemSize != ( UBaseType_t ) 0U ) ) );
     configASSERT( !( ( xCopyPosition == queueOVERWRITE ) && ( pxQueue->uxLength != 1 ) ) );
+    queueASSERT_NOT_SPSC( pxQueue );
 
     /* RTOS ports that support interrupt nesting have the concept of a maximum
      * system call (or maximum API call) interrupt priority.  Interrupts that are
@@ -1327,6 +1506,223 @@ BaseType_t xQueueGenericSendFromISR( QueueHandle_t xQueue,
 }
 /*-----------------------------------------------------------*/
 
+BaseType_t xQueueSendMultiple( QueueHandle_t xQueue,
+                               const void * const pvItemsToQueue,
+                               const UBaseType_t uxItemCount,
+                               TickType_t xTicksToWait )
+{
+    BaseType_t xEntryTimeSet = pdFALSE;
+    BaseType_t xFinished = pdFALSE;
+    TimeOut_t xTimeOut;
+    UBaseType_t uxItemsSent = ( UBaseType_t ) 0;
+    UBaseType_t uxItemsToCopy;
+    Queue_t * const pxQueue = xQueue;
+    const uint8_t * const pucItems = ( const uint8_t * ) pvItemsToQueue;
+
+    traceENTER_xQueueSendMultiple( xQueue, pvItemsToQueue, uxItemCount, xTicksToWait );
+
+    configASSERT( pxQueue );
+    configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+    configASSERT( !( ( pvItemsToQueue == NULL ) && ( uxItemCount != ( UBaseType_t ) 0U ) ) );
+    queueASSERT_NOT_SPSC( pxQueue );
+    #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+    {
+        configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+    }
+    #endif
+
+    while( xFinished == pdFALSE )
+    {
+        taskENTER_CRITICAL();
+        {
+            /* Copy as many of the remaining items as there is space for, then
+             * unblock the tasks the new items can satisfy in one pass. */
+            uxItemsToCopy = pxQueue->uxLength - pxQueue->uxMessagesWaiting;
+
+            if( uxItemsToCopy > ( uxItemCount - uxItemsSent ) )
+            {
+                uxItemsToCopy = uxItemCount - uxItemsSent;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            if( uxItemsToCopy > ( UBaseType_t ) 0 )
+            {
+                traceQUEUE_SEND( pxQueue );
+
+                prvCopyItemsToQueue( pxQueue, &( pucItems[ ( size_t ) uxItemsSent * ( size_t ) pxQueue->uxItemSize ] ), uxItemsToCopy );
+                uxItemsSent += uxItemsToCopy;
+
+                if( prvUnblockReceivers( pxQueue, uxItemsToCopy ) != pdFALSE )
+                {
+                    /* A task with a priority higher than ours was unblocked,
+                     * so yield.  As in xQueueGenericSend(), it is ok to do this
+                     * from within the critical section. */
+                    queueYIELD_IF_USING_PREEMPTION();
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            if( ( uxItemsSent == uxItemCount ) || ( xTicksToWait == ( TickType_t ) 0 ) )
+            {
+                /* Either every item was sent, or the queue is full and no
+                 * block time is specified (or the block time has expired). */
+                xFinished = pdTRUE;
+            }
+            else if( xEntryTimeSet == pdFALSE )
+            {
+                vTaskInternalSetTimeOutState( &xTimeOut );
+                xEntryTimeSet = pdTRUE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        if( xFinished == pdFALSE )
+        {
+            vTaskSuspendAll();
+            prvLockQueue( pxQueue );
+
+            if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+            {
+                if( prvIsQueueFull( pxQueue ) != pdFALSE )
+                {
+                    traceBLOCKING_ON_QUEUE_SEND( pxQueue );
+                    vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToSend ), xTicksToWait );
+                    prvUnlockQueue( pxQueue );
+
+                    if( xTaskResumeAll() == pdFALSE )
+                    {
+                        taskYIELD_WITHIN_API();
+                    }
+                }
+                else
+                {
+                    /* Try again. */
+                    prvUnlockQueue( pxQueue );
+                    ( void ) xTaskResumeAll();
+                }
+            }
+            else
+            {
+                /* The timeout has expired.  Make one last attempt, without
+                 * blocking, to send the items that remain. */
+                prvUnlockQueue( pxQueue );
+                ( void ) xTaskResumeAll();
+                xTicksToWait = ( TickType_t ) 0;
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+    if( uxItemsSent < uxItemCount )
+    {
+        traceQUEUE_SEND_FAILED( pxQueue );
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    traceRETURN_xQueueSendMultiple( ( BaseType_t ) uxItemsSent );
+
+    return ( BaseType_t ) uxItemsSent;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xQueueSendMultipleFromISR( QueueHandle_t xQueue,
+                                      const void * const pvItemsToQueue,
+                                      const UBaseType_t uxItemCount,
+                                      BaseType_t * const pxHigherPriorityTaskWoken )
+{
+    UBaseType_t uxItemsToCopy;
+    UBaseType_t uxItem;
+    UBaseType_t uxSavedInterruptStatus;
+    Queue_t * const pxQueue = xQueue;
+
+    traceENTER_xQueueSendMultipleFromISR( xQueue, pvItemsToQueue, uxItemCount, pxHigherPriorityTaskWoken );
+
+    configASSERT( pxQueue );
+    configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+    configASSERT( !( ( pvItemsToQueue == NULL ) && ( uxItemCount != ( UBaseType_t ) 0U ) ) );
+    queueASSERT_NOT_SPSC( pxQueue );
+
+    /* See the comment in xQueueGenericSendFromISR(). */
+    portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+    /* MISRA Ref 4.7.1 [Return value shall be checked] */
+    /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#dir-47 */
+    /* coverity[misra_c_2012_directive_4_7_violation] */
+    uxSavedInterruptStatus = ( UBaseType_t ) taskENTER_CRITICAL_FROM_ISR();
+    {
+        uxItemsToCopy = pxQueue->uxLength - pxQueue->uxMessagesWaiting;
+
+        if( uxItemsToCopy > uxItemCount )
+        {
+            uxItemsToCopy = uxItemCount;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if( uxItemsToCopy > ( UBaseType_t ) 0 )
+        {
+            traceQUEUE_SEND_FROM_ISR( pxQueue );
+
+            prvCopyItemsToQueue( pxQueue, ( const uint8_t * ) pvItemsToQueue, uxItemsToCopy );
+
+            /* The event list is not altered if the queue is locked.  This will
+             * be done when the queue is unlocked later, once for each item. */
+            if( pxQueue->cTxLock == queueUNLOCKED )
+            {
+                if( ( prvUnblockReceivers( pxQueue, uxItemsToCopy ) != pdFALSE ) && ( pxHigherPriorityTaskWoken != NULL ) )
+                {
+                    *pxHigherPriorityTaskWoken = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                for( uxItem = ( UBaseType_t ) 0; uxItem < uxItemsToCopy; uxItem++ )
+                {
+                    const int8_t cTxLock = pxQueue->cTxLock;
+
+                    prvIncrementQueueTxLock( pxQueue, cTxLock );
+                }
+            }
+        }
+        else
+        {
+            traceQUEUE_SEND_FROM_ISR_FAILED( pxQueue );
+        }
+    }
+    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+    traceRETURN_xQueueSendMultipleFromISR( ( BaseType_t ) uxItemsToCopy );
+
+    return ( BaseType_t ) uxItemsToCopy;
+}
+/*-----------------------------------------------------------*/
+
 BaseType_t xQueueGiveFromISR( QueueHandle_t xQueue,
                               BaseType_t * const pxHigherPriorityTaskWoken )
 {
@@ -1524,6 +1920,25 @@ BaseType_t xQueueReceive( QueueHandle_t xQueue,
     }
     #endif
 
+    #if ( configUSE_SPSC_QUEUES == 1 )
+    {
+        if( pxQueue->ucIsSPSC != ( uint8_t ) pdFALSE )
+        {
+            BaseType_t xReturn;
+
+            xReturn = prvSPSCReceive( pxQueue, pvBuffer, xTicksToWait );
+
+            traceRETURN_xQueueReceive( xReturn );
+
+            return xReturn;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    #endif /* configUSE_SPSC_QUEUES */
+
     for( ; ; )
     {
         taskENTER_CRITICAL();
@@ -1893,6 +2308,10 @@ BaseType_t xQueuePeek( QueueHandle_t xQueue,
      * is zero (so no data is copied into the buffer. */
     configASSERT( !( ( ( pvBuffer ) == NULL ) && ( ( pxQueue )->uxItemSize != ( UBaseType_t ) 0U ) ) );
 
+    /* Peeking would leave the item in place for the receiving task, which owns
+     * the front of a single producer single consumer queue. */
+    queueASSERT_NOT_SPSC( pxQueue );
+
     /* Cannot block if the scheduler is suspended. */
     #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
     {
@@ -2045,6 +2464,7 @@ BaseType_t xQueueReceiveFromISR( QueueHandle_t xQueue,
 
     configASSERT( pxQueue );
     configASSERT( !( ( pvBuffer == NULL ) && ( pxQueue->uxItemSize != ( UBaseType_t ) 0U ) ) );
+    queueASSERT_NOT_SPSC( pxQueue );
 
     /* RTOS ports that support interrupt nesting have the concept of a maximum
      * system call (or maximum API call) interrupt priority.  Interrupts that are
@@ -2133,50 +2553,251 @@ BaseType_t xQueueReceiveFromISR( QueueHandle_t xQueue,
 }
 /*-----------------------------------------------------------*/
 
-BaseType_t xQueuePeekFromISR( QueueHandle_t xQueue,
-                              void * const pvBuffer )
+BaseType_t xQueueReceiveMultiple( QueueHandle_t xQueue,
+                                  void * const pvBuffer,
+                                  const UBaseType_t uxMaxItems,
+                                  TickType_t xTicksToWait )
 {
-    BaseType_t xReturn;
-    UBaseType_t uxSavedInterruptStatus;
-    int8_t * pcOriginalReadPosition;
+    BaseType_t xEntryTimeSet = pdFALSE;
+    BaseType_t xFinished = pdFALSE;
+    TimeOut_t xTimeOut;
+    UBaseType_t uxItemsReceived = ( UBaseType_t ) 0;
     Queue_t * const pxQueue = xQueue;
 
-    traceENTER_xQueuePeekFromISR( xQueue, pvBuffer );
+    traceENTER_xQueueReceiveMultiple( xQueue, pvBuffer, uxMaxItems, xTicksToWait );
 
     configASSERT( pxQueue );
-    configASSERT( !( ( pvBuffer == NULL ) && ( pxQueue->uxItemSize != ( UBaseType_t ) 0U ) ) );
-    configASSERT( pxQueue->uxItemSize != 0 ); /* Can't peek a semaphore. */
-
-    /* RTOS ports that support interrupt nesting have the concept of a maximum
-     * system call (or maximum API call) interrupt priority.  Interrupts that are
-     * above the maximum system call priority are kept permanently enabled, even
-     * when the RTOS kernel is in a critical section, but cannot make any calls to
-     * FreeRTOS API functions.  If configASSERT() is defined in FreeRTOSConfig.h
-     * then portASSERT_IF_INTERRUPT_PRIORITY_INVALID() will result in an assertion
-     * failure if a FreeRTOS API function is called from an interrupt that has been
-     * assigned a priority above the configured maximum system call priority.
-     * Only FreeRTOS functions that end in FromISR can be called from interrupts
-     * that have been assigned a priority at or (logically) below the maximum
-     * system call interrupt priority.  FreeRTOS maintains a separate interrupt
-     * safe API to ensure interrupt entry is as fast and as simple as possible.
-     * More information (albeit Cortex-M specific) is provided on the following
-     * link: https://www.FreeRTOS.org/RTOS-Cortex-M3-M4.html */
-    portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+    configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+    configASSERT( pvBuffer );
+    configASSERT( uxMaxItems != ( UBaseType_t ) 0U );
+    queueASSERT_NOT_SPSC( pxQueue );
+    #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+    {
+        configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+    }
+    #endif
 
-    /* MISRA Ref 4.7.1 [Return value shall be checked] */
-    /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#dir-47 */
-    /* coverity[misra_c_2012_directive_4_7_violation] */
-    uxSavedInterruptStatus = ( UBaseType_t ) taskENTER_CRITICAL_FROM_ISR();
+    while( xFinished == pdFALSE )
     {
-        /* Cannot block in an ISR, so check there is data available. */
-        if( pxQueue->uxMessagesWaiting > ( UBaseType_t ) 0 )
+        taskENTER_CRITICAL();
         {
-            traceQUEUE_PEEK_FROM_ISR( pxQueue );
+            if( pxQueue->uxMessagesWaiting > ( UBaseType_t ) 0 )
+            {
+                /* Take every item that is available, up to uxMaxItems, then
+                 * unblock the tasks the freed space can satisfy in one pass. */
+                uxItemsReceived = pxQueue->uxMessagesWaiting;
 
-            /* Remember the read position so it can be reset as nothing is
-             * actually being removed from the queue. */
-            pcOriginalReadPosition = pxQueue->u.xQueue.pcReadFrom;
-            prvCopyDataFromQueue( pxQueue, pvBuffer );
+                if( uxItemsReceived > uxMaxItems )
+                {
+                    uxItemsReceived = uxMaxItems;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                prvCopyItemsFromQueue( pxQueue, ( uint8_t * ) pvBuffer, uxItemsReceived );
+                traceQUEUE_RECEIVE( pxQueue );
+
+                if( prvUnblockSenders( pxQueue, uxItemsReceived ) != pdFALSE )
+                {
+                    queueYIELD_IF_USING_PREEMPTION();
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                xFinished = pdTRUE;
+            }
+            else if( xTicksToWait == ( TickType_t ) 0 )
+            {
+                /* The queue is empty and no block time is specified (or the
+                 * block time has expired). */
+                traceQUEUE_RECEIVE_FAILED( pxQueue );
+                xFinished = pdTRUE;
+            }
+            else if( xEntryTimeSet == pdFALSE )
+            {
+                vTaskInternalSetTimeOutState( &xTimeOut );
+                xEntryTimeSet = pdTRUE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        if( xFinished == pdFALSE )
+        {
+            vTaskSuspendAll();
+            prvLockQueue( pxQueue );
+
+            if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+            {
+                if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
+                {
+                    traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue );
+                    vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToReceive ), xTicksToWait );
+                    prvUnlockQueue( pxQueue );
+
+                    if( xTaskResumeAll() == pdFALSE )
+                    {
+                        taskYIELD_WITHIN_API();
+                    }
+                }
+                else
+                {
+                    /* Try again. */
+                    prvUnlockQueue( pxQueue );
+                    ( void ) xTaskResumeAll();
+                }
+            }
+            else
+            {
+                /* The timeout has expired.  Make one last attempt to receive
+                 * without blocking, as xQueueReceive() does. */
+                prvUnlockQueue( pxQueue );
+                ( void ) xTaskResumeAll();
+                xTicksToWait = ( TickType_t ) 0;
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+    traceRETURN_xQueueReceiveMultiple( ( BaseType_t ) uxItemsReceived );
+
+    return ( BaseType_t ) uxItemsReceived;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xQueueReceiveMultipleFromISR( QueueHandle_t xQueue,
+                                         void * const pvBuffer,
+                                         const UBaseType_t uxMaxItems,
+                                         BaseType_t * const pxHigherPriorityTaskWoken )
+{
+    UBaseType_t uxItemsReceived;
+    UBaseType_t uxItem;
+    UBaseType_t uxSavedInterruptStatus;
+    Queue_t * const pxQueue = xQueue;
+
+    traceENTER_xQueueReceiveMultipleFromISR( xQueue, pvBuffer, uxMaxItems, pxHigherPriorityTaskWoken );
+
+    configASSERT( pxQueue );
+    configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+    configASSERT( pvBuffer );
+    queueASSERT_NOT_SPSC( pxQueue );
+
+    /* See the comment in xQueueGenericSendFromISR(). */
+    portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+    /* MISRA Ref 4.7.1 [Return value shall be checked] */
+    /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#dir-47 */
+    /* coverity[misra_c_2012_directive_4_7_violation] */
+    uxSavedInterruptStatus = ( UBaseType_t ) taskENTER_CRITICAL_FROM_ISR();
+    {
+        uxItemsReceived = pxQueue->uxMessagesWaiting;
+
+        if( uxItemsReceived > uxMaxItems )
+        {
+            uxItemsReceived = uxMaxItems;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if( uxItemsReceived > ( UBaseType_t ) 0 )
+        {
+            traceQUEUE_RECEIVE_FROM_ISR( pxQueue );
+
+            prvCopyItemsFromQueue( pxQueue, ( uint8_t * ) pvBuffer, uxItemsReceived );
+
+            /* The event list is not altered if the queue is locked.  This will
+             * be done when the queue is unlocked later, once for each item. */
+            if( pxQueue->cRxLock == queueUNLOCKED )
+            {
+                if( ( prvUnblockSenders( pxQueue, uxItemsReceived ) != pdFALSE ) && ( pxHigherPriorityTaskWoken != NULL ) )
+                {
+                    *pxHigherPriorityTaskWoken = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                for( uxItem = ( UBaseType_t ) 0; uxItem < uxItemsReceived; uxItem++ )
+                {
+                    const int8_t cRxLock = pxQueue->cRxLock;
+
+                    prvIncrementQueueRxLock( pxQueue, cRxLock );
+                }
+            }
+        }
+        else
+        {
+            traceQUEUE_RECEIVE_FROM_ISR_FAILED( pxQueue );
+        }
+    }
+    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+    traceRETURN_xQueueReceiveMultipleFromISR( ( BaseType_t ) uxItemsReceived );
+
+    return ( BaseType_t ) uxItemsReceived;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xQueuePeekFromISR( QueueHandle_t xQueue,
+                              void * const pvBuffer )
+{
+    BaseType_t xReturn;
+    UBaseType_t uxSavedInterruptStatus;
+    int8_t * pcOriginalReadPosition;
+    Queue_t * const pxQueue = xQueue;
+
+    traceENTER_xQueuePeekFromISR( xQueue, pvBuffer );
+
+    configASSERT( pxQueue );
+    configASSERT( !( ( pvBuffer == NULL ) && ( pxQueue->uxItemSize != ( UBaseType_t ) 0U ) ) );
+    configASSERT( pxQueue->uxItemSize != 0 ); /* Can't peek a semaphore. */
+    queueASSERT_NOT_SPSC( pxQueue );
+
+    /* RTOS ports that support interrupt nesting have the concept of a maximum
+     * system call (or maximum API call) interrupt priority.  Interrupts that are
+     * above the maximum system call priority are kept permanently enabled, even
+     * when the RTOS kernel is in a critical section, but cannot make any calls to
+     * FreeRTOS API functions.  If configASSERT() is defined in FreeRTOSConfig.h
+     * then portASSERT_IF_INTERRUPT_PRIORITY_INVALID() will result in an assertion
+     * failure if a FreeRTOS API function is called from an interrupt that has been
+     * assigned a priority above the configured maximum system call priority.
+     * Only FreeRTOS functions that end in FromISR can be called from interrupts
+     * that have been assigned a priority at or (logically) below the maximum
+     * system call interrupt priority.  FreeRTOS maintains a separate interrupt
+     * safe API to ensure interrupt entry is as fast and as simple as possible.
+     * More information (albeit Cortex-M specific) is provided on the following
+     * link: https://www.FreeRTOS.org/RTOS-Cortex-M3-M4.html */
+    portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+    /* MISRA Ref 4.7.1 [Return value shall be checked] */
+    /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#dir-47 */
+    /* coverity[misra_c_2012_directive_4_7_violation] */
+    uxSavedInterruptStatus = ( UBaseType_t ) taskENTER_CRITICAL_FROM_ISR();
+    {
+        /* Cannot block in an ISR, so check there is data available. */
+        if( pxQueue->uxMessagesWaiting > ( UBaseType_t ) 0 )
+        {
+            traceQUEUE_PEEK_FROM_ISR( pxQueue );
+
+            /* Remember the read position so it can be reset as nothing is
+             * actually being removed from the queue. */
+            pcOriginalReadPosition = pxQueue->u.xQueue.pcReadFrom;
+            prvCopyDataFromQueue( pxQueue, pvBuffer );
             pxQueue->u.xQueue.pcReadFrom = pcOriginalReadPosition;
 
             xReturn = pdPASS;
@@ -2205,7 +2826,7 @@ UBaseType_t uxQueueMessagesWaiting( const QueueHandle_t xQueue )
 
     portBASE_TYPE_ENTER_CRITICAL();
     {
-        uxReturn = ( ( Queue_t * ) xQueue )->uxMessagesWaiting;
+        uxReturn = queueMESSAGES_WAITING( ( Queue_t * ) xQueue );
     }
     portBASE_TYPE_EXIT_CRITICAL();
 
@@ -2226,7 +2847,7 @@ UBaseType_t uxQueueSpacesAvailable( const QueueHandle_t xQueue )
 
     portBASE_TYPE_ENTER_CRITICAL();
     {
-        uxReturn = ( UBaseType_t ) ( pxQueue->uxLength - pxQueue->uxMessagesWaiting );
+        uxReturn = ( UBaseType_t ) ( pxQueue->uxLength - queueMESSAGES_WAITING( pxQueue ) );
     }
     portBASE_TYPE_EXIT_CRITICAL();
 
@@ -2244,7 +2865,7 @@ UBaseType_t uxQueueMessagesWaitingFromISR( const QueueHandle_t xQueue )
     traceENTER_uxQueueMessagesWaitingFromISR( xQueue );
 
     configASSERT( pxQueue );
-    uxReturn = pxQueue->uxMessagesWaiting;
+    uxReturn = queueMESSAGES_WAITING( pxQueue );
 
     traceRETURN_uxQueueMessagesWaitingFromISR( uxReturn );
 
@@ -2492,6 +3113,673 @@ static void prvCopyDataFromQueue( Queue_t * const pxQueue,
 }
 /*-----------------------------------------------------------*/
 
+static void prvCopyItemsToQueue( Queue_t * const pxQueue,
+                                 const uint8_t * pucItems,
+                                 const UBaseType_t uxItemCount )
+{
+    const size_t xBytes = ( size_t ) uxItemCount * ( size_t ) pxQueue->uxItemSize;
+    const size_t xBytesToTail = ( size_t ) ( pxQueue->u.xQueue.pcTail - pxQueue->pcWriteTo );
+
+    /* The items are contiguous in the storage area unless they run past the
+     * tail, in which case the remainder is copied to the head. */
+    if( xBytes < xBytesToTail )
+    {
+        ( void ) memcpy( ( void * ) pxQueue->pcWriteTo, ( const void * ) pucItems, xBytes );
+        pxQueue->pcWriteTo += xBytes;
+    }
+    else
+    {
+        ( void ) memcpy( ( void * ) pxQueue->pcWriteTo, ( const void * ) pucItems, xBytesToTail );
+        ( void ) memcpy( ( void * ) pxQueue->pcHead, ( const void * ) &( pucItems[ xBytesToTail ] ), xBytes - xBytesToTail );
+        pxQueue->pcWriteTo = pxQueue->pcHead + ( xBytes - xBytesToTail );
+    }
+
+    pxQueue->uxMessagesWaiting += uxItemCount;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCopyItemsFromQueue( Queue_t * const pxQueue,
+                                   uint8_t * pucBuffer,
+                                   const UBaseType_t uxItemCount )
+{
+    const size_t xBytes = ( size_t ) uxItemCount * ( size_t ) pxQueue->uxItemSize;
+    int8_t * pcReadFrom = pxQueue->u.xQueue.pcReadFrom + pxQueue->uxItemSize;
+    size_t xBytesToTail;
+
+    /* pcReadFrom points to the last item read, so the first item to read is
+     * the one after it. */
+    if( pcReadFrom >= pxQueue->u.xQueue.pcTail )
+    {
+        pcReadFrom = pxQueue->pcHead;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    xBytesToTail = ( size_t ) ( pxQueue->u.xQueue.pcTail - pcReadFrom );
+
+    if( xBytes <= xBytesToTail )
+    {
+        ( void ) memcpy( ( void * ) pucBuffer, ( void * ) pcReadFrom, xBytes );
+        pxQueue->u.xQueue.pcReadFrom = pcReadFrom + ( xBytes - pxQueue->uxItemSize );
+    }
+    else
+    {
+        ( void ) memcpy( ( void * ) pucBuffer, ( void * ) pcReadFrom, xBytesToTail );
+        ( void ) memcpy( ( void * ) &( pucBuffer[ xBytesToTail ] ), ( void * ) pxQueue->pcHead, xBytes - xBytesToTail );
+        pxQueue->u.xQueue.pcReadFrom = pxQueue->pcHead + ( ( xBytes - xBytesToTail ) - pxQueue->uxItemSize );
+    }
+
+    pxQueue->uxMessagesWaiting -= uxItemCount;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvUnblockReceivers( Queue_t * const pxQueue,
+                                       const UBaseType_t uxItemCount )
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    BaseType_t xIsSetMember = pdFALSE;
+    UBaseType_t uxItem;
+
+    #if ( configUSE_QUEUE_SETS == 1 )
+    {
+        if( pxQueue->pxQueueSetContainer != NULL )
+        {
+            /* The queue set holds one handle for each item in the queue, and
+             * it is the queue set that tasks block on. */
+            for( uxItem = ( UBaseType_t ) 0; uxItem < uxItemCount; uxItem++ )
+            {
+                if( prvNotifyQueueSetContainer( pxQueue ) != pdFALSE )
+                {
+                    xHigherPriorityTaskWoken = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+
+            xIsSetMember = pdTRUE;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    #endif /* configUSE_QUEUE_SETS */
+
+    if( xIsSetMember == pdFALSE )
+    {
+        /* Each item can satisfy one waiting task, so unblock up to one task
+         * for each item, stopping early when no more tasks are waiting. */
+        for( uxItem = ( UBaseType_t ) 0; ( uxItem < uxItemCount ) && ( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE ); uxItem++ )
+        {
+            if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
+            {
+                xHigherPriorityTaskWoken = pdTRUE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    return xHigherPriorityTaskWoken;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvUnblockSenders( Queue_t * const pxQueue,
+                                     const UBaseType_t uxItemCount )
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    UBaseType_t uxItem;
+
+    /* Each item removed makes space for one waiting task, so unblock up to
+     * one task for each item, stopping early when no more tasks are waiting. */
+    for( uxItem = ( UBaseType_t ) 0; ( uxItem < uxItemCount ) && ( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) == pdFALSE ); uxItem++ )
+    {
+        if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
+        {
+            xHigherPriorityTaskWoken = pdTRUE;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+    return xHigherPriorityTaskWoken;
+}
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_SPSC_QUEUES == 1 )
+
+    static BaseType_t prvSPSCSend( Queue_t * const pxQueue,
+                                   const void * const pvItemToQueue,
+                                   TickType_t xTicksToWait )
+    {
+        BaseType_t xReturn = errQUEUE_FULL;
+        BaseType_t xEntryTimeSet = pdFALSE;
+        BaseType_t xFinished = pdFALSE;
+        TimeOut_t xTimeOut;
+
+        while( xFinished == pdFALSE )
+        {
+            /* Only this task writes uxItemsSent and pcWriteTo, and the
+             * receiving task only ever makes more space, so if there is space
+             * now it is still there once the item has been copied. */
+            if( queueMESSAGES_WAITING( pxQueue ) < pxQueue->uxLength )
+            {
+                traceQUEUE_SEND( pxQueue );
+
+                ( void ) memcpy( ( void * ) pxQueue->pcWriteTo, pvItemToQueue, ( size_t ) pxQueue->uxItemSize );
+                pxQueue->pcWriteTo += pxQueue->uxItemSize;
+
+                if( pxQueue->pcWriteTo >= pxQueue->u.xQueue.pcTail )
+                {
+                    pxQueue->pcWriteTo = pxQueue->pcHead;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                /* The item must be in the queue before the receiving task can
+                 * see the count that includes it. */
+                portMEMORY_BARRIER();
+                pxQueue->uxItemsSent = ( UBaseType_t ) ( pxQueue->uxItemsSent + ( UBaseType_t ) 1 );
+                portMEMORY_BARRIER();
+
+                /* The receiving task checks the queue is empty and blocks with
+                 * the scheduler suspended, so it is either already on the
+                 * event list or will see the item. */
+                if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
+                {
+                    taskENTER_CRITICAL();
+                    {
+                        /* The receiving task can have timed out since the list
+                         * was checked. */
+                        if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
+                        {
+                            if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
+                            {
+                                queueYIELD_IF_USING_PREEMPTION();
+                            }
+                            else
+                            {
+                                mtCOVERAGE_TEST_MARKER();
+                            }
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+                    }
+                    taskEXIT_CRITICAL();
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                xReturn = pdPASS;
+                xFinished = pdTRUE;
+            }
+            else if( xTicksToWait == ( TickType_t ) 0 )
+            {
+                /* The queue was full and no block time is specified (or the
+                 * block time has expired) so leave now. */
+                traceQUEUE_SEND_FAILED( pxQueue );
+                xFinished = pdTRUE;
+            }
+            else
+            {
+                /* The queue cannot be used from an interrupt, so suspending
+                 * the scheduler is enough to stop the receiving task making
+                 * space between the check below and this task blocking, and
+                 * the queue does not need to be locked. */
+                vTaskSuspendAll();
+
+                if( xEntryTimeSet == pdFALSE )
+                {
+                    vTaskInternalSetTimeOutState( &xTimeOut );
+                    xEntryTimeSet = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                /* A timeout leaves xTicksToWait at zero, so the next pass
+                 * either sends the item or fails. */
+                if( ( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE ) &&
+                    ( prvIsQueueFull( pxQueue ) != pdFALSE ) )
+                {
+                    traceBLOCKING_ON_QUEUE_SEND( pxQueue );
+                    vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToSend ), xTicksToWait );
+
+                    if( xTaskResumeAll() == pdFALSE )
+                    {
+                        taskYIELD_WITHIN_API();
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    ( void ) xTaskResumeAll();
+                }
+            }
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvSPSCReceive( Queue_t * const pxQueue,
+                                      void * const pvBuffer,
+                                      TickType_t xTicksToWait )
+    {
+        BaseType_t xReturn = errQUEUE_EMPTY;
+        BaseType_t xEntryTimeSet = pdFALSE;
+        BaseType_t xFinished = pdFALSE;
+        TimeOut_t xTimeOut;
+
+        while( xFinished == pdFALSE )
+        {
+            /* Only this task writes uxItemsReceived and pcReadFrom, and the
+             * sending task only ever adds items, so if there is an item now it
+             * is still there once it has been copied. */
+            if( queueMESSAGES_WAITING( pxQueue ) > ( UBaseType_t ) 0 )
+            {
+                prvCopyDataFromQueue( pxQueue, pvBuffer );
+                traceQUEUE_RECEIVE( pxQueue );
+
+                /* The item must be copied out before the sending task can see
+                 * the space it leaves. */
+                portMEMORY_BARRIER();
+                pxQueue->uxItemsReceived = ( UBaseType_t ) ( pxQueue->uxItemsReceived + ( UBaseType_t ) 1 );
+                portMEMORY_BARRIER();
+
+                /* The sending task checks the queue is full and blocks with
+                 * the scheduler suspended, so it is either already on the
+                 * event list or will see the space. */
+                if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) == pdFALSE )
+                {
+                    taskENTER_CRITICAL();
+                    {
+                        /* The sending task can have timed out since the list
+                         * was checked. */
+                        if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) == pdFALSE )
+                        {
+                            if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
+                            {
+                                queueYIELD_IF_USING_PREEMPTION();
+                            }
+                            else
+                            {
+                                mtCOVERAGE_TEST_MARKER();
+                            }
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+                    }
+                    taskEXIT_CRITICAL();
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                xReturn = pdPASS;
+                xFinished = pdTRUE;
+            }
+            else if( xTicksToWait == ( TickType_t ) 0 )
+            {
+                /* The queue was empty and no block time is specified (or the
+                 * block time has expired) so leave now. */
+                traceQUEUE_RECEIVE_FAILED( pxQueue );
+                xFinished = pdTRUE;
+            }
+            else
+            {
+                /* As in prvSPSCSend(), suspending the scheduler is enough to
+                 * stop the sending task adding an item between the check below
+                 * and this task blocking. */
+                vTaskSuspendAll();
+
+                if( xEntryTimeSet == pdFALSE )
+                {
+                    vTaskInternalSetTimeOutState( &xTimeOut );
+                    xEntryTimeSet = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                if( ( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE ) &&
+                    ( prvIsQueueEmpty( pxQueue ) != pdFALSE ) )
+                {
+                    traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue );
+                    vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToReceive ), xTicksToWait );
+
+                    if( xTaskResumeAll() == pdFALSE )
+                    {
+                        taskYIELD_WITHIN_API();
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    ( void ) xTaskResumeAll();
+                }
+            }
+        }
+
+        return xReturn;
+    }
+
+#endif /* configUSE_SPSC_QUEUES */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_ZERO_COPY_QUEUES == 1 )
+
+    static QueueBufferHeader_t * prvGetBufferHeader( void * pvBuffer )
+    {
+        /* MISRA Ref 11.5.5 [Void pointer assignment] */
+        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+        /* coverity[misra_c_2012_rule_11_5_violation] */
+        uint8_t * pucHeader = ( ( uint8_t * ) pvBuffer ) - queueBUFFER_HEADER_SIZE;
+
+        /* MISRA Ref 11.3.2 [Zero copy buffer header] */
+        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-113 */
+        /* coverity[misra_c_2012_rule_11_3_violation] */
+        return ( QueueBufferHeader_t * ) pucHeader;
+    }
+/*-----------------------------------------------------------*/
+
+    #if ( configCHECK_ZERO_COPY_BUFFERS == 1 )
+
+        static void prvCheckBuffer( const Queue_t * const pxQueue,
+                                    const QueueBufferHeader_t * const pxHeader,
+                                    uint8_t ucValidStates )
+        {
+            const portPOINTER_SIZE_TYPE uxFirstHeader = ( portPOINTER_SIZE_TYPE ) pxQueue->pcBufferStorage;
+            const portPOINTER_SIZE_TYPE uxHeader = ( portPOINTER_SIZE_TYPE ) pxHeader;
+
+            /* The buffer must have come from the pool of this queue, so its
+             * header must be one of the headers in the pool. */
+            configASSERT( pxQueue->pxBufferPool != NULL );
+            configASSERT( uxHeader >= uxFirstHeader );
+            configASSERT( ( ( uxHeader - uxFirstHeader ) % pxQueue->xBufferStride ) == 0U );
+            configASSERT( ( ( uxHeader - uxFirstHeader ) / pxQueue->xBufferStride ) < pxQueue->pxBufferPool->uxLength );
+
+            configASSERT( ( pxHeader->ucState & ucValidStates ) != 0U );
+
+            /* Only the task that acquired or received a buffer can send or
+             * release it. */
+            if( ( pxHeader->ucState & ( queueBUFFER_ACQUIRED | queueBUFFER_RECEIVED ) ) != 0U )
+            {
+                configASSERT( pxHeader->xOwner == xTaskGetCurrentTaskHandle() );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+
+    #endif /* configCHECK_ZERO_COPY_BUFFERS */
+/*-----------------------------------------------------------*/
+
+    #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+        QueueHandle_t xQueueCreateZeroCopy( const UBaseType_t uxQueueLength,
+                                            const UBaseType_t uxNumberOfBuffers,
+                                            const size_t xBufferSize )
+        {
+            Queue_t * pxNewQueue = NULL;
+            Queue_t * pxBufferPool;
+            size_t xStride, xBuffersOffset, xBuffersSize, xQueueSizeInBytes, xPoolSizeInBytes;
+            uint8_t * pucBuffers;
+            uint8_t * pucQueueStorage;
+            uint8_t * pucPoolStorage;
+            void * pvBuffer;
+            UBaseType_t uxBuffer;
+
+            traceENTER_xQueueCreateZeroCopy( uxQueueLength, uxNumberOfBuffers, xBufferSize );
+
+            /* Each part of the allocation is limited to a quarter of the address
+             * space, so adding the parts together cannot overflow.  The stride
+             * is larger than a pointer, so limiting the size of the buffers
+             * also limits the size of the storage area of the pool. */
+            if( ( uxQueueLength > ( UBaseType_t ) 0 ) &&
+                ( uxNumberOfBuffers > ( UBaseType_t ) 0 ) &&
+                ( xBufferSize > ( size_t ) 0 ) &&
+                ( xBufferSize <= queueZERO_COPY_MAX_PART_SIZE ) &&
+                ( ( queueZERO_COPY_MAX_PART_SIZE / sizeof( void * ) ) >= uxQueueLength ) &&
+                ( ( queueZERO_COPY_MAX_PART_SIZE / ( ( xBufferSize + queueBUFFER_HEADER_SIZE + ( size_t ) portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) ) ) >= uxNumberOfBuffers ) )
+            {
+                /* The buffers are rounded up so every header is aligned, and
+                 * follow the queue and the pool, which are rounded up in the
+                 * same way.  The storage areas of the queue and the pool, which
+                 * hold pointers to buffers, come last. */
+                xStride = ( xBufferSize + queueBUFFER_HEADER_SIZE + ( size_t ) portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+                xBuffersOffset = ( ( 2U * sizeof( Queue_t ) ) + ( size_t ) portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+                xBuffersSize = ( size_t ) uxNumberOfBuffers * xStride;
+                xQueueSizeInBytes = ( size_t ) uxQueueLength * sizeof( void * );
+                xPoolSizeInBytes = ( size_t ) uxNumberOfBuffers * sizeof( void * );
+
+                /* MISRA Ref 11.5.1 [Malloc memory assignment] */
+                /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+                /* coverity[misra_c_2012_rule_11_5_violation] */
+                pxNewQueue = ( Queue_t * ) pvPortMallocQueue( xBuffersOffset + xBuffersSize + xQueueSizeInBytes + xPoolSizeInBytes );
+
+                if( pxNewQueue != NULL )
+                {
+                    pxBufferPool = &( pxNewQueue[ 1 ] );
+                    pucBuffers = ( ( uint8_t * ) pxNewQueue ) + xBuffersOffset;
+                    pucQueueStorage = pucBuffers + xBuffersSize;
+                    pucPoolStorage = pucQueueStorage + xQueueSizeInBytes;
+
+                    #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+                    {
+                        /* The pool is part of the same allocation as the
+                         * queue, so it is freed when the queue is deleted and
+                         * must never be freed on its own. */
+                        pxNewQueue->ucStaticallyAllocated = pdFALSE;
+                        pxBufferPool->ucStaticallyAllocated = pdTRUE;
+                    }
+                    #endif /* configSUPPORT_STATIC_ALLOCATION */
+
+                    prvInitialiseNewQueue( uxQueueLength, ( UBaseType_t ) sizeof( void * ), pucQueueStorage, queueQUEUE_TYPE_BASE, pxNewQueue );
+                    prvInitialiseNewQueue( uxNumberOfBuffers, ( UBaseType_t ) sizeof( void * ), pucPoolStorage, queueQUEUE_TYPE_BASE, pxBufferPool );
+
+                    pxNewQueue->pxBufferPool = pxBufferPool;
+                    pxNewQueue->pcBufferStorage = ( int8_t * ) pucBuffers;
+                    pxNewQueue->xBufferStride = xStride;
+
+                    /* Place every buffer in the pool.  The pool can hold every
+                     * buffer, and no other task can use the queue yet, so the
+                     * pointers are copied in directly. */
+                    for( uxBuffer = ( UBaseType_t ) 0; uxBuffer < uxNumberOfBuffers; uxBuffer++ )
+                    {
+                        pvBuffer = ( void * ) ( pucBuffers + ( ( size_t ) uxBuffer * xStride ) + queueBUFFER_HEADER_SIZE );
+                        prvGetBufferHeader( pvBuffer )->xOwner = NULL;
+                        prvGetBufferHeader( pvBuffer )->ucState = queueBUFFER_FREE;
+                        ( void ) prvCopyDataToQueue( pxBufferPool, &pvBuffer, queueSEND_TO_BACK );
+                    }
+                }
+                else
+                {
+                    traceQUEUE_CREATE_FAILED( queueQUEUE_TYPE_BASE );
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                configASSERT( pxNewQueue );
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            traceRETURN_xQueueCreateZeroCopy( pxNewQueue );
+
+            return pxNewQueue;
+        }
+
+    #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+    void * pvQueueAcquireBuffer( QueueHandle_t xQueue,
+                                 TickType_t xTicksToWait )
+    {
+        Queue_t * const pxQueue = xQueue;
+        void * pvBuffer = NULL;
+        QueueBufferHeader_t * pxHeader;
+
+        traceENTER_pvQueueAcquireBuffer( xQueue, xTicksToWait );
+
+        configASSERT( pxQueue );
+        configASSERT( pxQueue->pxBufferPool != NULL );
+
+        if( xQueueReceive( pxQueue->pxBufferPool, &pvBuffer, xTicksToWait ) == pdPASS )
+        {
+            pxHeader = prvGetBufferHeader( pvBuffer );
+            queueCHECK_BUFFER( pxQueue, pxHeader, queueBUFFER_FREE );
+            pxHeader->xOwner = xTaskGetCurrentTaskHandle();
+            pxHeader->ucState = queueBUFFER_ACQUIRED;
+        }
+        else
+        {
+            /* All the buffers were in use for the whole block time. */
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        traceRETURN_pvQueueAcquireBuffer( pvBuffer );
+
+        return pvBuffer;
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xQueueSendBuffer( QueueHandle_t xQueue,
+                                 void * pvBuffer,
+                                 TickType_t xTicksToWait )
+    {
+        Queue_t * const pxQueue = xQueue;
+        QueueBufferHeader_t * pxHeader;
+        TaskHandle_t xOwner;
+        uint8_t ucState;
+        BaseType_t xReturn;
+
+        traceENTER_xQueueSendBuffer( xQueue, pvBuffer, xTicksToWait );
+
+        configASSERT( pxQueue );
+        configASSERT( pxQueue->pxBufferPool != NULL );
+        configASSERT( pvBuffer );
+
+        pxHeader = prvGetBufferHeader( pvBuffer );
+        queueCHECK_BUFFER( pxQueue, pxHeader, ( uint8_t ) ( queueBUFFER_ACQUIRED | queueBUFFER_RECEIVED ) );
+
+        /* The receiving task can take the buffer as soon as it is in the
+         * queue, so the buffer is given up before it is sent, and taken back
+         * if it could not be sent. */
+        xOwner = pxHeader->xOwner;
+        ucState = pxHeader->ucState;
+        pxHeader->xOwner = NULL;
+        pxHeader->ucState = queueBUFFER_QUEUED;
+
+        xReturn = xQueueGenericSend( pxQueue, &pvBuffer, xTicksToWait, queueSEND_TO_BACK );
+
+        if( xReturn != pdPASS )
+        {
+            pxHeader->xOwner = xOwner;
+            pxHeader->ucState = ucState;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        traceRETURN_xQueueSendBuffer( xReturn );
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    void * pvQueueReceiveBuffer( QueueHandle_t xQueue,
+                                 TickType_t xTicksToWait )
+    {
+        Queue_t * const pxQueue = xQueue;
+        void * pvBuffer = NULL;
+        QueueBufferHeader_t * pxHeader;
+
+        traceENTER_pvQueueReceiveBuffer( xQueue, xTicksToWait );
+
+        configASSERT( pxQueue );
+        configASSERT( pxQueue->pxBufferPool != NULL );
+
+        if( xQueueReceive( pxQueue, &pvBuffer, xTicksToWait ) == pdPASS )
+        {
+            pxHeader = prvGetBufferHeader( pvBuffer );
+            queueCHECK_BUFFER( pxQueue, pxHeader, queueBUFFER_QUEUED );
+            pxHeader->xOwner = xTaskGetCurrentTaskHandle();
+            pxHeader->ucState = queueBUFFER_RECEIVED;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        traceRETURN_pvQueueReceiveBuffer( pvBuffer );
+
+        return pvBuffer;
+    }
+/*-----------------------------------------------------------*/
+
+    void vQueueReleaseBuffer( QueueHandle_t xQueue,
+                              void * pvBuffer )
+    {
+        Queue_t * const pxQueue = xQueue;
+        QueueBufferHeader_t * pxHeader;
+        BaseType_t xReturn;
+
+        traceENTER_vQueueReleaseBuffer( xQueue, pvBuffer );
+
+        configASSERT( pxQueue );
+        configASSERT( pxQueue->pxBufferPool != NULL );
+        configASSERT( pvBuffer );
+
+        pxHeader = prvGetBufferHeader( pvBuffer );
+        queueCHECK_BUFFER( pxQueue, pxHeader, ( uint8_t ) ( queueBUFFER_ACQUIRED | queueBUFFER_RECEIVED ) );
+
+        pxHeader->xOwner = NULL;
+        pxHeader->ucState = queueBUFFER_FREE;
+
+        /* The pool can hold every buffer, so there is always space to return
+         * one without blocking. */
+        xReturn = xQueueGenericSend( pxQueue->pxBufferPool, &pvBuffer, ( TickType_t ) 0, queueSEND_TO_BACK );
+        configASSERT( xReturn == pdPASS );
+        ( void ) xReturn;
+
+        traceRETURN_vQueueReleaseBuffer();
+    }
+
+#endif /* configUSE_ZERO_COPY_QUEUES */
+/*-----------------------------------------------------------*/
+
 static void prvUnlockQueue( Queue_t * const pxQueue )
 {
     /* THIS FUNCTION MUST BE CALLED WITH THE SCHEDULER SUSPENDED. */
@@ -2618,7 +3906,7 @@ static BaseType_t prvIsQueueEmpty( const Queue_t * pxQueue )
 
     taskENTER_CRITICAL();
     {
-        if( pxQueue->uxMessagesWaiting == ( UBaseType_t ) 0 )
+        if( queueMESSAGES_WAITING( pxQueue ) == ( UBaseType_t ) 0 )
         {
             xReturn = pdTRUE;
         }
@@ -2642,7 +3930,7 @@ BaseType_t xQueueIsQueueEmptyFromISR( const QueueHandle_t xQueue )
 
     configASSERT( pxQueue );
 
-    if( pxQueue->uxMessagesWaiting == ( UBaseType_t ) 0 )
+    if( queueMESSAGES_WAITING( pxQueue ) == ( UBaseType_t ) 0 )
     {
         xReturn = pdTRUE;
     }
@@ -2663,7 +3951,7 @@ static BaseType_t prvIsQueueFull( const Queue_t * pxQueue )
 
     taskENTER_CRITICAL();
     {
-        if( pxQueue->uxMessagesWaiting == pxQueue->uxLength )
+        if( queueMESSAGES_WAITING( pxQueue ) == pxQueue->uxLength )
         {
             xReturn = pdTRUE;
         }
@@ -2687,7 +3975,7 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
 
     configASSERT( pxQueue );
 
-    if( pxQueue->uxMessagesWaiting == pxQueue->uxLength )
+    if( queueMESSAGES_WAITING( pxQueue ) == pxQueue->uxLength )
     {
         xReturn = pdTRUE;
     }
@@ -3199,6 +4487,8 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
 
         traceENTER_xQueueAddToSet( xQueueOrSemaphore, xQueueSet );
 
+        queueASSERT_NOT_SPSC( ( Queue_t * ) xQueueOrSemaphore );
+
         taskENTER_CRITICAL();
         {
             if( ( ( Queue_t * ) xQueueOrSemaphore )->pxQueueSetContainer != NULL )
@@ -39,6 +39,12 @@
 #include "task.h"
 #include "stream_buffer.h"
 
+/* MPSC message buffers fall back to the critical section used by atomic.h on
+ * ports that do not provide portCOMPARE_AND_SWAP_SIZE(). */
+#if ( ( configUSE_MPSC_MESSAGE_BUFFERS == 1 ) && !defined( portCOMPARE_AND_SWAP_SIZE ) )
+    #include "atomic.h"
+#endif
+
 /* The MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
  * for the header files above, but not in this file, in order to generate the
  * correct privileged Vs unprivileged linkage and placement. */
@@ -225,6 +231,37 @@
     #define sbFLAGS_IS_MESSAGE_BUFFER          ( ( uint8_t ) 1 ) /* Set if the stream buffer was created as a message buffer, in which case it holds discrete messages rather than a stream. */
     #define sbFLAGS_IS_STATICALLY_ALLOCATED    ( ( uint8_t ) 2 ) /* Set if the stream buffer was created using statically allocated memory. */
     #define sbFLAGS_IS_BATCHING_BUFFER         ( ( uint8_t ) 4 ) /* Set if the stream buffer was created as a batching buffer, meaning the receiver task will only unblock when the trigger level exceededs. */
+    #define sbFLAGS_IS_MPSC_BUFFER             ( ( uint8_t ) 8 ) /* Set if the message buffer was created as an MPSC message buffer, in which case writers reserve space with a compare-and-swap on xHead. */
+
+    #if ( configUSE_MPSC_MESSAGE_BUFFERS == 1 )
+
+/* Each message in an MPSC message buffer starts with a size_t header that
+ * holds the message length, and is padded so the next header is also size_t
+ * aligned.  A header can therefore never wrap around the end of the buffer, and
+ * is always read and written with a single access. */
+        #define sbMPSC_HEADER_BYTES        ( sizeof( size_t ) )
+        #define sbMPSC_ROUND_UP( x )       ( ( ( x ) + ( sbMPSC_HEADER_BYTES - ( size_t ) 1 ) ) & ~( sbMPSC_HEADER_BYTES - ( size_t ) 1 ) )
+
+/* Set in a header by the writer once the whole message has been written.  Free
+ * space in an MPSC message buffer always reads as zero, so a header that has
+ * been reserved but not yet written does not have this bit set. */
+        #define sbMPSC_MESSAGE_COMMITTED    ( ( size_t ) 1 << ( ( sizeof( size_t ) * ( size_t ) 8 ) - ( size_t ) 1 ) )
+
+/* The xHead of an MPSC message buffer holds the write index in its low
+ * sbMPSC_INDEX_BITS bits, and above them counts the laps the write index has
+ * made around the buffer.  A writer whose compare-and-swap finds xHead
+ * unchanged therefore knows no other writer reserved space in between, even if
+ * the others went all the way around the buffer and back to the same index. */
+        #define sbMPSC_INDEX_BITS           ( ( sizeof( size_t ) * ( size_t ) 8 ) / ( size_t ) 2 )
+        #define sbMPSC_LAP                  ( ( size_t ) 1 << sbMPSC_INDEX_BITS )
+        #define sbMPSC_INDEX_MASK           ( sbMPSC_LAP - ( size_t ) 1 )
+
+        #define sbHEAD_INDEX( pxStreamBuffer )                                                    \
+    ( ( ( ( pxStreamBuffer )->ucFlags & sbFLAGS_IS_MPSC_BUFFER ) != ( uint8_t ) 0 ) ?             \
+      ( ( pxStreamBuffer )->xHead & sbMPSC_INDEX_MASK ) : ( pxStreamBuffer )->xHead )
+    #else
+        #define sbHEAD_INDEX( pxStreamBuffer )    ( ( pxStreamBuffer )->xHead )
+    #endif /* configUSE_MPSC_MESSAGE_BUFFERS */
 
 /*-----------------------------------------------------------*/
 
@@ -232,7 +269,7 @@
 typedef struct StreamBufferDef_t
 {
     volatile size_t xTail;                       /* Index to the next item to read within the buffer. */
-    volatile size_t xHead;                       /* Index to the next item to write within the buffer. */
+    volatile size_t xHead;                       /* Index to the next item to write within the buffer.  Use sbHEAD_INDEX() to read it, as in an MPSC message buffer it also counts laps of the buffer. */
     size_t xLength;                              /* The length of the buffer pointed to by pucBuffer. */
     size_t xTriggerLevelBytes;                   /* The number of bytes that must be in the stream buffer before a task that is waiting for data is unblocked. */
     volatile TaskHandle_t xTaskWaitingToReceive; /* Holds the handle of a task waiting for data, or NULL if no tasks are waiting. */
@@ -314,6 +351,82 @@ static size_t prvReadBytesFromBuffer( StreamBuffer_t * pxStreamBuffer,
                                       size_t xCount,
                                       size_t xTail ) PRIVILEGED_FUNCTION;
 
+/*
+ * Moves xHead past xBytesWritten bytes that the writer has written in place
+ * into space returned by xStreamBufferReserve().  For a message buffer the
+ * length of the message is written first, into the space that
+ * xStreamBufferReserve() left for it.  Returns the number of bytes committed.
+ */
+static size_t prvCommitReservedBytes( StreamBuffer_t * const pxStreamBuffer,
+                                      size_t xBytesWritten ) PRIVILEGED_FUNCTION;
+
+/*
+ * Moves xTail past xBytesRead bytes that the reader has read in place from
+ * the segments returned by xStreamBufferPeekContiguous().  For a message
+ * buffer the whole of the next message, and its length, are removed.  Returns
+ * the number of bytes consumed, not counting the length of a message.
+ */
+static size_t prvConsumePeekedBytes( StreamBuffer_t * const pxStreamBuffer,
+                                     size_t xBytesRead ) PRIVILEGED_FUNCTION;
+
+/*
+ * Describes the xCount bytes starting at index xStart of the buffer's data
+ * storage area as up to two segments, the second of which is only used if the
+ * bytes wrap around the end of the storage area.
+ */
+static void prvGetSegments( const StreamBuffer_t * const pxStreamBuffer,
+                            size_t xStart,
+                            size_t xCount,
+                            StreamBufferSegments_t * const pxSegments ) PRIVILEGED_FUNCTION;
+
+/*
+ * The number of bytes the reader can read.  This is the same as
+ * prvBytesInBuffer() except for MPSC message buffers, where it is the size of
+ * the message at xTail if, and only if, its writer has committed it.
+ */
+static size_t prvBytesAvailableToRead( const StreamBuffer_t * const pxStreamBuffer ) PRIVILEGED_FUNCTION;
+
+#if ( configUSE_MPSC_MESSAGE_BUFFERS == 1 )
+
+/*
+ * Reserves space for a message in an MPSC message buffer by advancing xHead
+ * and its lap count with a compare-and-swap, copies the message into the
+ * reserved space, then commits it by writing its header.  Any number of tasks
+ * and interrupts can call this at the same time.  Returns xDataLengthBytes, or
+ * 0 if there was not enough space.
+ */
+    static size_t prvWriteMPSCMessageToBuffer( StreamBuffer_t * const pxStreamBuffer,
+                                               const void * pvTxData,
+                                               size_t xDataLengthBytes ) PRIVILEGED_FUNCTION;
+
+/*
+ * Reads the message at xTail of an MPSC message buffer if its writer has
+ * committed it, then clears the space the message occupied and moves xTail
+ * past it.  Messages committed out of order are left in the buffer until every
+ * message before them has been committed.  Returns the length of the message
+ * read, or 0 if there was no committed message or it did not fit in
+ * xBufferLengthBytes.
+ */
+    static size_t prvReadMPSCMessageFromBuffer( StreamBuffer_t * const pxStreamBuffer,
+                                                void * pvRxData,
+                                                size_t xBufferLengthBytes ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns the header of the message at xTail of an MPSC message buffer, or 0
+ * if no message has been reserved there yet.
+ */
+    static size_t prvReadMPSCHeader( const StreamBuffer_t * const pxStreamBuffer ) PRIVILEGED_FUNCTION;
+
+/*
+ * Sets *pxDestination to xExchange if it holds xComparand, as a single atomic
+ * operation.  Returns pdTRUE if the value was swapped.
+ */
+    static BaseType_t prvCompareAndSwapIndex( volatile size_t * pxDestination,
+                                              size_t xExchange,
+                                              size_t xComparand ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_MPSC_MESSAGE_BUFFERS */
+
 /*
  * Called by both pxStreamBufferCreate() and pxStreamBufferCreateStatic() to
  * initialise the members of the newly created stream buffer structure.
@@ -349,6 +462,25 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
             ucFlags = sbFLAGS_IS_MESSAGE_BUFFER;
             configASSERT( xBufferSizeBytes > sbBYTES_TO_STORE_MESSAGE_LENGTH );
         }
+
+        #if ( configUSE_MPSC_MESSAGE_BUFFERS == 1 )
+            else if( xStreamBufferType == sbTYPE_MPSC_MESSAGE_BUFFER )
+            {
+                /* Is an MPSC message buffer but not statically allocated.  The
+                 * write index must fit in the low half of xHead once the size
+                 * has been rounded up below. */
+                ucFlags = sbFLAGS_IS_MESSAGE_BUFFER | sbFLAGS_IS_MPSC_BUFFER;
+                configASSERT( xBufferSizeBytes > sbMPSC_HEADER_BYTES );
+                configASSERT( xBufferSizeBytes <= ( sbMPSC_INDEX_MASK - ( sbMPSC_HEADER_BYTES * ( size_t ) 2 ) ) );
+
+                /* Messages are padded to whole headers, so the write index can
+                 * only move in steps of sbMPSC_HEADER_BYTES.  Round the size up
+                 * to a whole number of headers, then reserve a whole header
+                 * rather than the single byte added below to tell a full buffer
+                 * from an empty one. */
+                xBufferSizeBytes = sbMPSC_ROUND_UP( xBufferSizeBytes ) + sbMPSC_HEADER_BYTES - ( size_t ) 1;
+            }
+        #endif /* configUSE_MPSC_MESSAGE_BUFFERS */
         else if( xStreamBufferType == sbTYPE_STREAM_BATCHING_BUFFER )
         {
             /* Is a batching buffer but not statically allocated. */
@@ -463,6 +595,22 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
             ucFlags = sbFLAGS_IS_MESSAGE_BUFFER | sbFLAGS_IS_STATICALLY_ALLOCATED;
             configASSERT( xBufferSizeBytes > sbBYTES_TO_STORE_MESSAGE_LENGTH );
         }
+
+        #if ( configUSE_MPSC_MESSAGE_BUFFERS == 1 )
+            else if( xStreamBufferType == sbTYPE_MPSC_MESSAGE_BUFFER )
+            {
+                /* Statically allocated MPSC message buffer.  Message headers
+                 * are accessed as size_t values, so the storage area must be
+                 * size_t aligned and a whole number of headers long, with room
+                 * for at least one header and one header's worth of data in
+                 * addition to the header that is always kept free. */
+                ucFlags = sbFLAGS_IS_MESSAGE_BUFFER | sbFLAGS_IS_MPSC_BUFFER | sbFLAGS_IS_STATICALLY_ALLOCATED;
+                configASSERT( xBufferSizeBytes >= ( sbMPSC_HEADER_BYTES * ( size_t ) 3 ) );
+                configASSERT( xBufferSizeBytes <= sbMPSC_INDEX_MASK );
+                configASSERT( ( xBufferSizeBytes & ( sbMPSC_HEADER_BYTES - ( size_t ) 1 ) ) == ( size_t ) 0 );
+                configASSERT( ( ( ( portPOINTER_SIZE_TYPE ) pucStreamBufferStorageArea ) & ( ( portPOINTER_SIZE_TYPE ) sbMPSC_HEADER_BYTES - ( portPOINTER_SIZE_TYPE ) 1 ) ) == ( portPOINTER_SIZE_TYPE ) 0 );
+            }
+        #endif /* configUSE_MPSC_MESSAGE_BUFFERS */
         else if( xStreamBufferType == sbTYPE_STREAM_BATCHING_BUFFER )
         {
             /* Statically allocated batching buffer. */
@@ -768,7 +916,7 @@ size_t xStreamBufferSpacesAvailable( StreamBufferHandle_t xStreamBuffer )
     {
         xOriginalTail = pxStreamBuffer->xTail;
         xSpace = pxStreamBuffer->xLength + pxStreamBuffer->xTail;
-        xSpace -= pxStreamBuffer->xHead;
+        xSpace -= sbHEAD_INDEX( pxStreamBuffer );
     } while( xOriginalTail != pxStreamBuffer->xTail );
 
     xSpace -= ( size_t ) 1;
@@ -821,6 +969,14 @@ size_t xStreamBufferSend( StreamBufferHandle_t xStreamBuffer,
     configASSERT( pvTxData );
     configASSERT( pxStreamBuffer );
 
+    #if ( configUSE_MPSC_MESSAGE_BUFFERS == 1 )
+    {
+        /* Only one task can wait for space in a message buffer, so writers to
+         * an MPSC message buffer must not block. */
+        configASSERT( ( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MPSC_BUFFER ) == ( uint8_t ) 0 ) || ( xTicksToWait == ( TickType_t ) 0 ) );
+    }
+    #endif
+
     /* The maximum amount of space a stream buffer will ever report is its length
      * minus 1. */
     xMaxReportedSpace = pxStreamBuffer->xLength - ( size_t ) 1;
@@ -912,14 +1068,23 @@ size_t xStreamBufferSend( StreamBufferHandle_t xStreamBuffer,
         mtCOVERAGE_TEST_MARKER();
     }
 
-    xReturn = prvWriteMessageToBuffer( pxStreamBuffer, pvTxData, xDataLengthBytes, xSpace, xRequiredSpace );
+    #if ( configUSE_MPSC_MESSAGE_BUFFERS == 1 )
+        if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MPSC_BUFFER ) != ( uint8_t ) 0 )
+        {
+            xReturn = prvWriteMPSCMessageToBuffer( pxStreamBuffer, pvTxData, xDataLengthBytes );
+        }
+        else
+    #endif /* configUSE_MPSC_MESSAGE_BUFFERS */
+    {
+        xReturn = prvWriteMessageToBuffer( pxStreamBuffer, pvTxData, xDataLengthBytes, xSpace, xRequiredSpace );
+    }
 
     if( xReturn > ( size_t ) 0 )
     {
         traceSTREAM_BUFFER_SEND( xStreamBuffer, xReturn );
 
         /* Was a task waiting for the data? */
-        if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
+        if( prvBytesAvailableToRead( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
         {
             prvSEND_COMPLETED( pxStreamBuffer );
         }
@@ -967,8 +1132,195 @@ size_t xStreamBufferSendFromISR( StreamBufferHandle_t xStreamBuffer,
         mtCOVERAGE_TEST_MARKER();
     }
 
+    #if ( configUSE_MPSC_MESSAGE_BUFFERS == 1 )
+        if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MPSC_BUFFER ) != ( uint8_t ) 0 )
+        {
+            xReturn = prvWriteMPSCMessageToBuffer( pxStreamBuffer, pvTxData, xDataLengthBytes );
+        }
+        else
+    #endif /* configUSE_MPSC_MESSAGE_BUFFERS */
+    {
+        xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
+        xReturn = prvWriteMessageToBuffer( pxStreamBuffer, pvTxData, xDataLengthBytes, xSpace, xRequiredSpace );
+    }
+
+    if( xReturn > ( size_t ) 0 )
+    {
+        /* Was a task waiting for the data? */
+        if( prvBytesAvailableToRead( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
+        {
+            /* MISRA Ref 4.7.1 [Return value shall be checked] */
+            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#dir-47 */
+            /* coverity[misra_c_2012_directive_4_7_violation] */
+            prvSEND_COMPLETE_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    traceSTREAM_BUFFER_SEND_FROM_ISR( xStreamBuffer, xReturn );
+    traceRETURN_xStreamBufferSendFromISR( xReturn );
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferReserve( StreamBufferHandle_t xStreamBuffer,
+                             size_t xMaxBytes,
+                             StreamBufferSegments_t * const pxSegments,
+                             TickType_t xTicksToWait )
+{
+    StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+    size_t xReturn, xSpace, xStart;
+    size_t xBytesToStoreMessageLength, xRequiredSpace;
+    TimeOut_t xTimeOut;
+
+    traceENTER_xStreamBufferReserve( xStreamBuffer, xMaxBytes, pxSegments, xTicksToWait );
+
+    configASSERT( pxStreamBuffer );
+    configASSERT( pxSegments );
+
+    /* Writers to an MPSC message buffer reserve space for themselves. */
+    configASSERT( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MPSC_BUFFER ) == ( uint8_t ) 0 );
+
+    /* Space reserved in a message buffer starts after the bytes that will
+     * hold the length of the message once it is committed. */
+    if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+    {
+        xBytesToStoreMessageLength = sbBYTES_TO_STORE_MESSAGE_LENGTH;
+    }
+    else
+    {
+        xBytesToStoreMessageLength = 0;
+    }
+
+    /* Wait for space for the largest amount that could ever be reserved, as
+     * xStreamBufferSend() does. */
+    xRequiredSpace = configMIN( xMaxBytes, ( pxStreamBuffer->xLength - ( size_t ) 1 ) - xBytesToStoreMessageLength );
+    xRequiredSpace += xBytesToStoreMessageLength;
+
+    if( xTicksToWait != ( TickType_t ) 0 )
+    {
+        vTaskSetTimeOutState( &xTimeOut );
+
+        do
+        {
+            taskENTER_CRITICAL();
+            {
+                xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
+
+                if( xSpace < xRequiredSpace )
+                {
+                    /* Clear notification state as going to wait for space. */
+                    ( void ) xTaskNotifyStateClearIndexed( NULL, pxStreamBuffer->uxNotificationIndex );
+
+                    /* Should only be one writer. */
+                    configASSERT( pxStreamBuffer->xTaskWaitingToSend == NULL );
+                    pxStreamBuffer->xTaskWaitingToSend = xTaskGetCurrentTaskHandle();
+                }
+                else
+                {
+                    taskEXIT_CRITICAL();
+                    break;
+                }
+            }
+            taskEXIT_CRITICAL();
+
+            traceBLOCKING_ON_STREAM_BUFFER_SEND( xStreamBuffer );
+            ( void ) xTaskNotifyWaitIndexed( pxStreamBuffer->uxNotificationIndex, ( uint32_t ) 0, ( uint32_t ) 0, NULL, xTicksToWait );
+            pxStreamBuffer->xTaskWaitingToSend = NULL;
+        } while( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE );
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
     xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
-    xReturn = prvWriteMessageToBuffer( pxStreamBuffer, pvTxData, xDataLengthBytes, xSpace, xRequiredSpace );
+
+    if( xSpace > xBytesToStoreMessageLength )
+    {
+        xReturn = configMIN( xSpace - xBytesToStoreMessageLength, xMaxBytes );
+    }
+    else
+    {
+        xReturn = 0;
+    }
+
+    xStart = pxStreamBuffer->xHead + xBytesToStoreMessageLength;
+
+    if( xStart >= pxStreamBuffer->xLength )
+    {
+        xStart -= pxStreamBuffer->xLength;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    prvGetSegments( pxStreamBuffer, xStart, xReturn, pxSegments );
+
+    traceRETURN_xStreamBufferReserve( xReturn );
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferCommit( StreamBufferHandle_t xStreamBuffer,
+                            size_t xBytesWritten )
+{
+    StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+    size_t xReturn;
+
+    traceENTER_xStreamBufferCommit( xStreamBuffer, xBytesWritten );
+
+    configASSERT( pxStreamBuffer );
+
+    xReturn = prvCommitReservedBytes( pxStreamBuffer, xBytesWritten );
+
+    if( xReturn > ( size_t ) 0 )
+    {
+        traceSTREAM_BUFFER_SEND( xStreamBuffer, xReturn );
+
+        /* Was a task waiting for the data? */
+        if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
+        {
+            prvSEND_COMPLETED( pxStreamBuffer );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    traceRETURN_xStreamBufferCommit( xReturn );
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferCommitFromISR( StreamBufferHandle_t xStreamBuffer,
+                                   size_t xBytesWritten,
+                                   BaseType_t * const pxHigherPriorityTaskWoken )
+{
+    StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+    size_t xReturn;
+
+    traceENTER_xStreamBufferCommitFromISR( xStreamBuffer, xBytesWritten, pxHigherPriorityTaskWoken );
+
+    configASSERT( pxStreamBuffer );
+
+    xReturn = prvCommitReservedBytes( pxStreamBuffer, xBytesWritten );
 
     if( xReturn > ( size_t ) 0 )
     {
@@ -991,7 +1343,7 @@ size_t xStreamBufferSendFromISR( StreamBufferHandle_t xStreamBuffer,
     }
 
     traceSTREAM_BUFFER_SEND_FROM_ISR( xStreamBuffer, xReturn );
-    traceRETURN_xStreamBufferSendFromISR( xReturn );
+    traceRETURN_xStreamBufferCommitFromISR( xReturn );
 
     return xReturn;
 }
@@ -1068,6 +1420,13 @@ size_t xStreamBufferReceive( StreamBufferHandle_t xStreamBuffer,
      * bytes.  Discrete messages include an additional
      * sbBYTES_TO_STORE_MESSAGE_LENGTH bytes that hold the length of the
      * message. */
+    #if ( configUSE_MPSC_MESSAGE_BUFFERS == 1 )
+        if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MPSC_BUFFER ) != ( uint8_t ) 0 )
+        {
+            xBytesToStoreMessageLength = sbMPSC_HEADER_BYTES;
+        }
+        else
+    #endif /* configUSE_MPSC_MESSAGE_BUFFERS */
     if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
     {
         xBytesToStoreMessageLength = sbBYTES_TO_STORE_MESSAGE_LENGTH;
@@ -1089,7 +1448,7 @@ size_t xStreamBufferReceive( StreamBufferHandle_t xStreamBuffer,
          * performed atomically. */
         taskENTER_CRITICAL();
         {
-            xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+            xBytesAvailable = prvBytesAvailableToRead( pxStreamBuffer );
 
             /* If this function was invoked by a message buffer read then
              * xBytesToStoreMessageLength holds the number of bytes used to hold
@@ -1122,7 +1481,7 @@ size_t xStreamBufferReceive( StreamBufferHandle_t xStreamBuffer,
             pxStreamBuffer->xTaskWaitingToReceive = NULL;
 
             /* Recheck the data available after blocking. */
-            xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+            xBytesAvailable = prvBytesAvailableToRead( pxStreamBuffer );
         }
         else
         {
@@ -1131,7 +1490,7 @@ size_t xStreamBufferReceive( StreamBufferHandle_t xStreamBuffer,
     }
     else
     {
-        xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+        xBytesAvailable = prvBytesAvailableToRead( pxStreamBuffer );
     }
 
     /* Whether receiving a discrete message (where xBytesToStoreMessageLength
@@ -1141,7 +1500,16 @@ size_t xStreamBufferReceive( StreamBufferHandle_t xStreamBuffer,
      * read bytes from the buffer. */
     if( xBytesAvailable > xBytesToStoreMessageLength )
     {
-        xReceivedLength = prvReadMessageFromBuffer( pxStreamBuffer, pvRxData, xBufferLengthBytes, xBytesAvailable );
+        #if ( configUSE_MPSC_MESSAGE_BUFFERS == 1 )
+            if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MPSC_BUFFER ) != ( uint8_t ) 0 )
+            {
+                xReceivedLength = prvReadMPSCMessageFromBuffer( pxStreamBuffer, pvRxData, xBufferLengthBytes );
+            }
+            else
+        #endif /* configUSE_MPSC_MESSAGE_BUFFERS */
+        {
+            xReceivedLength = prvReadMessageFromBuffer( pxStreamBuffer, pvRxData, xBufferLengthBytes, xBytesAvailable );
+        }
 
         /* Was a task waiting for space in the buffer? */
         if( xReceivedLength != ( size_t ) 0 )
@@ -1172,11 +1540,32 @@ size_t xStreamBufferNextMessageLengthBytes( StreamBufferHandle_t xStreamBuffer )
     size_t xReturn, xBytesAvailable;
     configMESSAGE_BUFFER_LENGTH_TYPE xTempReturn;
 
+    #if ( configUSE_MPSC_MESSAGE_BUFFERS == 1 )
+        size_t xHeader;
+    #endif
+
     traceENTER_xStreamBufferNextMessageLengthBytes( xStreamBuffer );
 
     configASSERT( pxStreamBuffer );
 
     /* Ensure the stream buffer is being used as a message buffer. */
+    #if ( configUSE_MPSC_MESSAGE_BUFFERS == 1 )
+        if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MPSC_BUFFER ) != ( uint8_t ) 0 )
+        {
+            /* The next message only counts once its writer has committed it. */
+            xHeader = prvReadMPSCHeader( pxStreamBuffer );
+
+            if( ( xHeader & sbMPSC_MESSAGE_COMMITTED ) != ( size_t ) 0 )
+            {
+                xReturn = xHeader & ~sbMPSC_MESSAGE_COMMITTED;
+            }
+            else
+            {
+                xReturn = 0;
+            }
+        }
+        else
+    #endif /* configUSE_MPSC_MESSAGE_BUFFERS */
     if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
     {
         xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
@@ -1228,6 +1617,13 @@ size_t xStreamBufferReceiveFromISR( StreamBufferHandle_t xStreamBuffer,
      * bytes.  Discrete messages include an additional
      * sbBYTES_TO_STORE_MESSAGE_LENGTH bytes that hold the length of the
      * message. */
+    #if ( configUSE_MPSC_MESSAGE_BUFFERS == 1 )
+        if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MPSC_BUFFER ) != ( uint8_t ) 0 )
+        {
+            xBytesToStoreMessageLength = sbMPSC_HEADER_BYTES;
+        }
+        else
+    #endif /* configUSE_MPSC_MESSAGE_BUFFERS */
     if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
     {
         xBytesToStoreMessageLength = sbBYTES_TO_STORE_MESSAGE_LENGTH;
@@ -1237,7 +1633,7 @@ size_t xStreamBufferReceiveFromISR( StreamBufferHandle_t xStreamBuffer,
         xBytesToStoreMessageLength = 0;
     }
 
-    xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+    xBytesAvailable = prvBytesAvailableToRead( pxStreamBuffer );
 
     /* Whether receiving a discrete message (where xBytesToStoreMessageLength
      * holds the number of bytes used to store the message length) or a stream of
@@ -1246,7 +1642,16 @@ size_t xStreamBufferReceiveFromISR( StreamBufferHandle_t xStreamBuffer,
      * read bytes from the buffer. */
     if( xBytesAvailable > xBytesToStoreMessageLength )
     {
-        xReceivedLength = prvReadMessageFromBuffer( pxStreamBuffer, pvRxData, xBufferLengthBytes, xBytesAvailable );
+        #if ( configUSE_MPSC_MESSAGE_BUFFERS == 1 )
+            if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MPSC_BUFFER ) != ( uint8_t ) 0 )
+            {
+                xReceivedLength = prvReadMPSCMessageFromBuffer( pxStreamBuffer, pvRxData, xBufferLengthBytes );
+            }
+            else
+        #endif /* configUSE_MPSC_MESSAGE_BUFFERS */
+        {
+            xReceivedLength = prvReadMessageFromBuffer( pxStreamBuffer, pvRxData, xBufferLengthBytes, xBytesAvailable );
+        }
 
         /* Was a task waiting for space in the buffer? */
         if( xReceivedLength != ( size_t ) 0 )
@@ -1273,28 +1678,189 @@ size_t xStreamBufferReceiveFromISR( StreamBufferHandle_t xStreamBuffer,
 }
 /*-----------------------------------------------------------*/
 
-static size_t prvReadMessageFromBuffer( StreamBuffer_t * pxStreamBuffer,
-                                        void * pvRxData,
-                                        size_t xBufferLengthBytes,
-                                        size_t xBytesAvailable )
+size_t xStreamBufferPeekContiguous( StreamBufferHandle_t xStreamBuffer,
+                                    StreamBufferSegments_t * const pxSegments,
+                                    TickType_t xTicksToWait )
 {
-    size_t xCount, xNextMessageLength;
+    StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+    size_t xReturn = 0, xBytesAvailable, xBytesToStoreMessageLength, xStart;
     configMESSAGE_BUFFER_LENGTH_TYPE xTempNextMessageLength;
-    size_t xNextTail = pxStreamBuffer->xTail;
 
+    traceENTER_xStreamBufferPeekContiguous( xStreamBuffer, pxSegments, xTicksToWait );
+
+    configASSERT( pxStreamBuffer );
+    configASSERT( pxSegments );
+    configASSERT( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MPSC_BUFFER ) == ( uint8_t ) 0 );
+
+    /* As in xStreamBufferReceive(), xBytesToStoreMessageLength is the number
+     * of bytes that must be exceeded before there is anything to read. */
     if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
     {
-        /* A discrete message is being received.  First receive the length
-         * of the message. */
-        xNextTail = prvReadBytesFromBuffer( pxStreamBuffer, ( uint8_t * ) &xTempNextMessageLength, sbBYTES_TO_STORE_MESSAGE_LENGTH, xNextTail );
-        xNextMessageLength = ( size_t ) xTempNextMessageLength;
-
-        /* Reduce the number of bytes available by the number of bytes just
-         * read out. */
-        xBytesAvailable -= sbBYTES_TO_STORE_MESSAGE_LENGTH;
+        xBytesToStoreMessageLength = sbBYTES_TO_STORE_MESSAGE_LENGTH;
+    }
+    else if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_BATCHING_BUFFER ) != ( uint8_t ) 0 )
+    {
+        xBytesToStoreMessageLength = pxStreamBuffer->xTriggerLevelBytes;
+    }
+    else
+    {
+        xBytesToStoreMessageLength = 0;
+    }
 
-        /* Check there is enough space in the buffer provided by the
-         * user. */
+    if( xTicksToWait != ( TickType_t ) 0 )
+    {
+        /* Checking if there is data and clearing the notification state must be
+         * performed atomically. */
+        taskENTER_CRITICAL();
+        {
+            xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+
+            if( xBytesAvailable <= xBytesToStoreMessageLength )
+            {
+                /* Clear notification state as going to wait for data. */
+                ( void ) xTaskNotifyStateClearIndexed( NULL, pxStreamBuffer->uxNotificationIndex );
+
+                /* Should only be one reader. */
+                configASSERT( pxStreamBuffer->xTaskWaitingToReceive == NULL );
+                pxStreamBuffer->xTaskWaitingToReceive = xTaskGetCurrentTaskHandle();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        if( xBytesAvailable <= xBytesToStoreMessageLength )
+        {
+            /* Wait for data to be available. */
+            traceBLOCKING_ON_STREAM_BUFFER_RECEIVE( xStreamBuffer );
+            ( void ) xTaskNotifyWaitIndexed( pxStreamBuffer->uxNotificationIndex, ( uint32_t ) 0, ( uint32_t ) 0, NULL, xTicksToWait );
+            pxStreamBuffer->xTaskWaitingToReceive = NULL;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+    xStart = pxStreamBuffer->xTail;
+
+    if( xBytesAvailable > xBytesToStoreMessageLength )
+    {
+        if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+        {
+            /* Only expose the next message, which starts after its length. */
+            xStart = prvReadBytesFromBuffer( pxStreamBuffer, ( uint8_t * ) &xTempNextMessageLength, sbBYTES_TO_STORE_MESSAGE_LENGTH, xStart );
+            xReturn = ( size_t ) xTempNextMessageLength;
+        }
+        else
+        {
+            xReturn = xBytesAvailable;
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    prvGetSegments( pxStreamBuffer, xStart, xReturn, pxSegments );
+
+    traceRETURN_xStreamBufferPeekContiguous( xReturn );
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferConsume( StreamBufferHandle_t xStreamBuffer,
+                             size_t xBytesRead )
+{
+    StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+    size_t xReturn;
+
+    traceENTER_xStreamBufferConsume( xStreamBuffer, xBytesRead );
+
+    configASSERT( pxStreamBuffer );
+
+    xReturn = prvConsumePeekedBytes( pxStreamBuffer, xBytesRead );
+
+    /* Was a task waiting for space in the buffer? */
+    if( xReturn != ( size_t ) 0 )
+    {
+        traceSTREAM_BUFFER_RECEIVE( xStreamBuffer, xReturn );
+        prvRECEIVE_COMPLETED( pxStreamBuffer );
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    traceRETURN_xStreamBufferConsume( xReturn );
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferConsumeFromISR( StreamBufferHandle_t xStreamBuffer,
+                                    size_t xBytesRead,
+                                    BaseType_t * const pxHigherPriorityTaskWoken )
+{
+    StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+    size_t xReturn;
+
+    traceENTER_xStreamBufferConsumeFromISR( xStreamBuffer, xBytesRead, pxHigherPriorityTaskWoken );
+
+    configASSERT( pxStreamBuffer );
+
+    xReturn = prvConsumePeekedBytes( pxStreamBuffer, xBytesRead );
+
+    /* Was a task waiting for space in the buffer? */
+    if( xReturn != ( size_t ) 0 )
+    {
+        /* MISRA Ref 4.7.1 [Return value shall be checked] */
+        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#dir-47 */
+        /* coverity[misra_c_2012_directive_4_7_violation] */
+        prvRECEIVE_COMPLETED_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    traceSTREAM_BUFFER_RECEIVE_FROM_ISR( xStreamBuffer, xReturn );
+    traceRETURN_xStreamBufferConsumeFromISR( xReturn );
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvReadMessageFromBuffer( StreamBuffer_t * pxStreamBuffer,
+                                        void * pvRxData,
+                                        size_t xBufferLengthBytes,
+                                        size_t xBytesAvailable )
+{
+    size_t xCount, xNextMessageLength;
+    configMESSAGE_BUFFER_LENGTH_TYPE xTempNextMessageLength;
+    size_t xNextTail = pxStreamBuffer->xTail;
+
+    if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+    {
+        /* A discrete message is being received.  First receive the length
+         * of the message. */
+        xNextTail = prvReadBytesFromBuffer( pxStreamBuffer, ( uint8_t * ) &xTempNextMessageLength, sbBYTES_TO_STORE_MESSAGE_LENGTH, xNextTail );
+        xNextMessageLength = ( size_t ) xTempNextMessageLength;
+
+        /* Reduce the number of bytes available by the number of bytes just
+         * read out. */
+        xBytesAvailable -= sbBYTES_TO_STORE_MESSAGE_LENGTH;
+
+        /* Check there is enough space in the buffer provided by the
+         * user. */
         if( xNextMessageLength > xBufferLengthBytes )
         {
             /* The user has provided insufficient space to read the message. */
@@ -1341,7 +1907,7 @@ BaseType_t xStreamBufferIsEmpty( StreamBufferHandle_t xStreamBuffer )
     /* True if no bytes are available. */
     xTail = pxStreamBuffer->xTail;
 
-    if( pxStreamBuffer->xHead == xTail )
+    if( sbHEAD_INDEX( pxStreamBuffer ) == xTail )
     {
         xReturn = pdTRUE;
     }
@@ -1370,6 +1936,15 @@ BaseType_t xStreamBufferIsFull( StreamBufferHandle_t xStreamBuffer )
      * buffers, which store discrete messages, and stream buffers, which store a
      * continuous stream of bytes.  Discrete messages include an additional
      * sbBYTES_TO_STORE_MESSAGE_LENGTH bytes that hold the length of the message. */
+    #if ( configUSE_MPSC_MESSAGE_BUFFERS == 1 )
+        if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MPSC_BUFFER ) != ( uint8_t ) 0 )
+        {
+            /* The smallest message in an MPSC message buffer takes a header
+             * and a header's worth of padded data. */
+            xBytesToStoreMessageLength = ( sbMPSC_HEADER_BYTES * ( size_t ) 2 ) - ( size_t ) 1;
+        }
+        else
+    #endif /* configUSE_MPSC_MESSAGE_BUFFERS */
     if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
     {
         xBytesToStoreMessageLength = sbBYTES_TO_STORE_MESSAGE_LENGTH;
@@ -1568,7 +2143,7 @@ static size_t prvBytesInBuffer( const StreamBuffer_t * const pxStreamBuffer )
     /* Returns the distance between xTail and xHead. */
     size_t xCount;
 
-    xCount = pxStreamBuffer->xLength + pxStreamBuffer->xHead;
+    xCount = pxStreamBuffer->xLength + sbHEAD_INDEX( pxStreamBuffer );
     xCount -= pxStreamBuffer->xTail;
 
     if( xCount >= pxStreamBuffer->xLength )
@@ -1584,6 +2159,456 @@ static size_t prvBytesInBuffer( const StreamBuffer_t * const pxStreamBuffer )
 }
 /*-----------------------------------------------------------*/
 
+static size_t prvCommitReservedBytes( StreamBuffer_t * const pxStreamBuffer,
+                                      size_t xBytesWritten )
+{
+    size_t xSpace, xNextHead = pxStreamBuffer->xHead;
+    configMESSAGE_BUFFER_LENGTH_TYPE xMessageLength;
+
+    configASSERT( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MPSC_BUFFER ) == ( uint8_t ) 0 );
+
+    xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
+
+    if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+    {
+        /* The bytes written must have been reserved, so there must be space
+         * for them and for their length. */
+        configASSERT( ( xSpace > sbBYTES_TO_STORE_MESSAGE_LENGTH ) && ( xBytesWritten <= ( xSpace - sbBYTES_TO_STORE_MESSAGE_LENGTH ) ) );
+
+        xMessageLength = ( configMESSAGE_BUFFER_LENGTH_TYPE ) xBytesWritten;
+        configASSERT( ( size_t ) xMessageLength == xBytesWritten );
+
+        if( ( xBytesWritten != ( size_t ) 0 ) &&
+            ( xSpace > sbBYTES_TO_STORE_MESSAGE_LENGTH ) &&
+            ( xBytesWritten <= ( xSpace - sbBYTES_TO_STORE_MESSAGE_LENGTH ) ) )
+        {
+            /* The message itself is already in place, after the space left
+             * for its length. */
+            xNextHead = prvWriteBytesToBuffer( pxStreamBuffer, ( const uint8_t * ) &( xMessageLength ), sbBYTES_TO_STORE_MESSAGE_LENGTH, xNextHead );
+        }
+        else
+        {
+            xBytesWritten = 0;
+        }
+    }
+    else
+    {
+        configASSERT( xBytesWritten <= xSpace );
+        xBytesWritten = configMIN( xBytesWritten, xSpace );
+    }
+
+    if( xBytesWritten != ( size_t ) 0 )
+    {
+        xNextHead += xBytesWritten;
+
+        if( xNextHead >= pxStreamBuffer->xLength )
+        {
+            xNextHead -= pxStreamBuffer->xLength;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        pxStreamBuffer->xHead = xNextHead;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    return xBytesWritten;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvConsumePeekedBytes( StreamBuffer_t * const pxStreamBuffer,
+                                     size_t xBytesRead )
+{
+    size_t xBytesAvailable, xNextTail = pxStreamBuffer->xTail;
+    configMESSAGE_BUFFER_LENGTH_TYPE xTempNextMessageLength;
+
+    configASSERT( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MPSC_BUFFER ) == ( uint8_t ) 0 );
+
+    xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+
+    if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+    {
+        if( ( xBytesRead != ( size_t ) 0 ) && ( xBytesAvailable > sbBYTES_TO_STORE_MESSAGE_LENGTH ) )
+        {
+            /* A message is consumed whole, along with its length. */
+            xNextTail = prvReadBytesFromBuffer( pxStreamBuffer, ( uint8_t * ) &xTempNextMessageLength, sbBYTES_TO_STORE_MESSAGE_LENGTH, xNextTail );
+            configASSERT( xBytesRead == ( size_t ) xTempNextMessageLength );
+            xBytesRead = ( size_t ) xTempNextMessageLength;
+        }
+        else
+        {
+            xBytesRead = 0;
+        }
+    }
+    else
+    {
+        configASSERT( xBytesRead <= xBytesAvailable );
+        xBytesRead = configMIN( xBytesRead, xBytesAvailable );
+    }
+
+    if( xBytesRead != ( size_t ) 0 )
+    {
+        xNextTail += xBytesRead;
+
+        if( xNextTail >= pxStreamBuffer->xLength )
+        {
+            xNextTail -= pxStreamBuffer->xLength;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        pxStreamBuffer->xTail = xNextTail;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    return xBytesRead;
+}
+/*-----------------------------------------------------------*/
+
+static void prvGetSegments( const StreamBuffer_t * const pxStreamBuffer,
+                            size_t xStart,
+                            size_t xCount,
+                            StreamBufferSegments_t * const pxSegments )
+{
+    size_t xFirstLength;
+
+    /* The bytes run from xStart to the end of the buffer, then continue from
+     * the start of the buffer. */
+    xFirstLength = configMIN( pxStreamBuffer->xLength - xStart, xCount );
+
+    if( xFirstLength != ( size_t ) 0 )
+    {
+        pxSegments->pucFirst = &( pxStreamBuffer->pucBuffer[ xStart ] );
+    }
+    else
+    {
+        pxSegments->pucFirst = NULL;
+    }
+
+    pxSegments->xFirstLength = xFirstLength;
+
+    if( xCount > xFirstLength )
+    {
+        pxSegments->pucSecond = pxStreamBuffer->pucBuffer;
+        pxSegments->xSecondLength = xCount - xFirstLength;
+    }
+    else
+    {
+        pxSegments->pucSecond = NULL;
+        pxSegments->xSecondLength = 0;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvBytesAvailableToRead( const StreamBuffer_t * const pxStreamBuffer )
+{
+    size_t xCount;
+
+    #if ( configUSE_MPSC_MESSAGE_BUFFERS == 1 )
+        size_t xHeader;
+
+        if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MPSC_BUFFER ) != ( uint8_t ) 0 )
+        {
+            /* Messages reserved after the one at xTail cannot be read before
+             * it, even if they have already been committed. */
+            xHeader = prvReadMPSCHeader( pxStreamBuffer );
+
+            if( ( xHeader & sbMPSC_MESSAGE_COMMITTED ) != ( size_t ) 0 )
+            {
+                xCount = sbMPSC_HEADER_BYTES + ( xHeader & ~sbMPSC_MESSAGE_COMMITTED );
+            }
+            else
+            {
+                xCount = 0;
+            }
+        }
+        else
+    #endif /* configUSE_MPSC_MESSAGE_BUFFERS */
+    {
+        xCount = prvBytesInBuffer( pxStreamBuffer );
+    }
+
+    return xCount;
+}
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_MPSC_MESSAGE_BUFFERS == 1 )
+
+    static size_t prvWriteMPSCMessageToBuffer( StreamBuffer_t * const pxStreamBuffer,
+                                               const void * pvTxData,
+                                               size_t xDataLengthBytes )
+    {
+        size_t xHead = 0, xHeadIndex = 0, xNextHead, xSpace, xRecordLength = 0;
+        size_t xReturn = 0;
+        BaseType_t xFinished = pdFALSE;
+        volatile size_t * pxHeader;
+
+        configASSERT( xDataLengthBytes > ( size_t ) 0 );
+
+        /* A message longer than the buffer could never fit, and checking for
+         * that first also stops the padded length from overflowing. */
+        if( xDataLengthBytes < pxStreamBuffer->xLength )
+        {
+            xRecordLength = sbMPSC_HEADER_BYTES + sbMPSC_ROUND_UP( xDataLengthBytes );
+        }
+        else
+        {
+            xFinished = pdTRUE;
+        }
+
+        while( xFinished == pdFALSE )
+        {
+            /* xTail is read after xHead.  The compare-and-swap below only
+             * succeeds if no space was reserved after xHead was read, and the
+             * reader can only move xTail towards xHead, so a stale xTail can
+             * only make the free space look smaller than it is. */
+            xHead = pxStreamBuffer->xHead;
+            xHeadIndex = xHead & sbMPSC_INDEX_MASK;
+            xSpace = pxStreamBuffer->xLength + pxStreamBuffer->xTail;
+            xSpace -= xHeadIndex;
+            xSpace -= ( size_t ) 1;
+
+            if( xSpace >= pxStreamBuffer->xLength )
+            {
+                xSpace -= pxStreamBuffer->xLength;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            if( xSpace < xRecordLength )
+            {
+                /* Not enough space, so do not write the message. */
+                xFinished = pdTRUE;
+            }
+            else
+            {
+                xNextHead = xHead + xRecordLength;
+
+                if( ( xHeadIndex + xRecordLength ) >= pxStreamBuffer->xLength )
+                {
+                    /* Wrapping around the end of the buffer starts a new lap. */
+                    xNextHead += sbMPSC_LAP - pxStreamBuffer->xLength;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                traceSTREAM_BUFFER_MPSC_CLAIM( pxStreamBuffer );
+
+                /* Claim the space between xHead and xNextHead.  If another
+                 * writer moved xHead first then try again from where it left
+                 * xHead. */
+                if( prvCompareAndSwapIndex( &( pxStreamBuffer->xHead ), xNextHead, xHead ) != pdFALSE )
+                {
+                    xReturn = xDataLengthBytes;
+                    xFinished = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+        }
+
+        if( xReturn != ( size_t ) 0 )
+        {
+            xNextHead = xHeadIndex + sbMPSC_HEADER_BYTES;
+
+            if( xNextHead >= pxStreamBuffer->xLength )
+            {
+                xNextHead -= pxStreamBuffer->xLength;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            /* MISRA Ref 11.5.5 [Void pointer assignment] */
+            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+            /* coverity[misra_c_2012_rule_11_5_violation] */
+            ( void ) prvWriteBytesToBuffer( pxStreamBuffer, ( const uint8_t * ) pvTxData, xDataLengthBytes, xNextHead );
+
+            /* The whole message must be in the buffer before the header says
+             * it has been committed. */
+            portMEMORY_BARRIER();
+
+            /* MISRA Ref 11.3.3 [Misaligned access] */
+            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-113 */
+            /* coverity[misra_c_2012_rule_11_3_violation] */
+            pxHeader = ( volatile size_t * ) &( pxStreamBuffer->pucBuffer[ xHeadIndex ] );
+            *pxHeader = xDataLengthBytes | sbMPSC_MESSAGE_COMMITTED;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xReturn;
+    }
+
+#endif /* configUSE_MPSC_MESSAGE_BUFFERS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_MPSC_MESSAGE_BUFFERS == 1 )
+
+    static size_t prvReadMPSCMessageFromBuffer( StreamBuffer_t * const pxStreamBuffer,
+                                                void * pvRxData,
+                                                size_t xBufferLengthBytes )
+    {
+        const size_t xTail = pxStreamBuffer->xTail;
+        size_t xHeader, xCount = 0, xDataStart, xNextTail, xFirstLength;
+        volatile size_t * pxHeader;
+
+        /* MISRA Ref 11.3.3 [Misaligned access] */
+        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-113 */
+        /* coverity[misra_c_2012_rule_11_3_violation] */
+        pxHeader = ( volatile size_t * ) &( pxStreamBuffer->pucBuffer[ xTail ] );
+        xHeader = *pxHeader;
+
+        if( ( xHeader & sbMPSC_MESSAGE_COMMITTED ) != ( size_t ) 0 )
+        {
+            /* The message must not be read before its header. */
+            portMEMORY_BARRIER();
+
+            xCount = xHeader & ~sbMPSC_MESSAGE_COMMITTED;
+
+            if( xCount <= xBufferLengthBytes )
+            {
+                xDataStart = xTail + sbMPSC_HEADER_BYTES;
+
+                if( xDataStart >= pxStreamBuffer->xLength )
+                {
+                    xDataStart -= pxStreamBuffer->xLength;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                /* MISRA Ref 11.5.5 [Void pointer assignment] */
+                /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+                /* coverity[misra_c_2012_rule_11_5_violation] */
+                ( void ) prvReadBytesFromBuffer( pxStreamBuffer, ( uint8_t * ) pvRxData, xCount, xDataStart );
+
+                /* Writers rely on free space reading as zero, so clear the
+                 * message and its header before giving the space back.  The
+                 * padding after the message was never written so is still
+                 * zero. */
+                xFirstLength = configMIN( pxStreamBuffer->xLength - xDataStart, xCount );
+                ( void ) memset( ( void * ) &( pxStreamBuffer->pucBuffer[ xDataStart ] ), 0x00, xFirstLength );
+
+                if( xCount > xFirstLength )
+                {
+                    ( void ) memset( ( void * ) pxStreamBuffer->pucBuffer, 0x00, xCount - xFirstLength );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                *pxHeader = ( size_t ) 0;
+
+                xNextTail = xTail + sbMPSC_HEADER_BYTES + sbMPSC_ROUND_UP( xCount );
+
+                if( xNextTail >= pxStreamBuffer->xLength )
+                {
+                    xNextTail -= pxStreamBuffer->xLength;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                /* The space must be clear before a writer can reserve it. */
+                portMEMORY_BARRIER();
+                pxStreamBuffer->xTail = xNextTail;
+            }
+            else
+            {
+                /* The user has provided insufficient space to read the
+                 * message. */
+                xCount = 0;
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xCount;
+    }
+
+#endif /* configUSE_MPSC_MESSAGE_BUFFERS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_MPSC_MESSAGE_BUFFERS == 1 )
+
+    static size_t prvReadMPSCHeader( const StreamBuffer_t * const pxStreamBuffer )
+    {
+        const volatile size_t * pxHeader;
+
+        /* MISRA Ref 11.3.3 [Misaligned access] */
+        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-113 */
+        /* coverity[misra_c_2012_rule_11_3_violation] */
+        pxHeader = ( const volatile size_t * ) &( pxStreamBuffer->pucBuffer[ pxStreamBuffer->xTail ] );
+
+        return *pxHeader;
+    }
+
+#endif /* configUSE_MPSC_MESSAGE_BUFFERS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_MPSC_MESSAGE_BUFFERS == 1 )
+
+    static BaseType_t prvCompareAndSwapIndex( volatile size_t * pxDestination,
+                                              size_t xExchange,
+                                              size_t xComparand )
+    {
+        BaseType_t xReturn;
+
+        #ifdef portCOMPARE_AND_SWAP_SIZE
+        {
+            xReturn = portCOMPARE_AND_SWAP_SIZE( pxDestination, xExchange, xComparand );
+        }
+        #else
+        {
+            /* Fall back to the same critical section atomic.h uses, which is
+             * safe to enter from both tasks and interrupts. */
+            ATOMIC_ENTER_CRITICAL();
+            {
+                if( *pxDestination == xComparand )
+                {
+                    *pxDestination = xExchange;
+                    xReturn = pdTRUE;
+                }
+                else
+                {
+                    xReturn = pdFALSE;
+                }
+            }
+            ATOMIC_EXIT_CRITICAL();
+        }
+        #endif /* portCOMPARE_AND_SWAP_SIZE */
+
+        return xReturn;
+    }
+
+#endif /* configUSE_MPSC_MESSAGE_BUFFERS */
+/*-----------------------------------------------------------*/
+
 static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
                                           uint8_t * const pucBuffer,
                                           size_t xBufferSizeBytes,
@@ -1605,6 +2630,22 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
     }
     #endif
 
+    #if ( configUSE_MPSC_MESSAGE_BUFFERS == 1 )
+    {
+        /* The reader of an MPSC message buffer relies on free space reading as
+         * zero, so it never mistakes a header that has been reserved but not
+         * yet written for a committed message. */
+        if( ( ucFlags & sbFLAGS_IS_MPSC_BUFFER ) != ( uint8_t ) 0 )
+        {
+            ( void ) memset( ( void * ) pucBuffer, 0x00, xBufferSizeBytes );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    #endif /* configUSE_MPSC_MESSAGE_BUFFERS */
+
     ( void ) memset( ( void * ) pxStreamBuffer, 0x00, sizeof( StreamBuffer_t ) );
     pxStreamBuffer->pucBuffer = pucBuffer;
     pxStreamBuffer->xLength = xBufferSizeBytes;
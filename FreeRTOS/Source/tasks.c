@@ -42,9 +42,13 @@
 #include "timers.h"
 #include "stack_macros.h"
 
-#define __DEBUG__ 1
+/* Set configKERNEL_DEBUG_PRINT to 0 in FreeRTOSConfig.h to compile the kernel
+ * debug messages out, for example when measuring scheduler overhead. */
+#ifndef configKERNEL_DEBUG_PRINT
+    #define configKERNEL_DEBUG_PRINT    1
+#endif
 
-#if __DEBUG__   // 一个宏，用于控制是否打印调试信息，打印方式同printf, 允许接受多个参数
+#if ( configKERNEL_DEBUG_PRINT == 1 )   // 一个宏，用于控制是否打印调试信息，打印方式同printf, 允许接受多个参数
     #define DEBUG_PRINT( x, ... )    printf( x, ##__VA_ARGS__ ) 
 #else
     #define DEBUG_PRINT( x, ... )  do {} while( 0 )
@@ -93,25 +97,13 @@
         portYIELD_WITHIN_API();                                  \
     } while( 0 )
 
-        #if ( configUSE_EDF_SCHEDULER == 0 )
-        #define taskYIELD_ANY_CORE_IF_USING_PREEMPTION( pxTCB ) \
-    do {                                                        \
-        if( pxCurrentTCB->uxPriority < ( pxTCB )->uxPriority )  \
-        {                                                       \
-            printf("PREEEMPTION happends! From %s to %s\n", pxCurrentTCB->pcTaskName, ( pxTCB )->pcTaskName); \
-            portYIELD_WITHIN_API();                             \
-        }                                                       \
-        else                                                    \
-        {                                                       \
-            mtCOVERAGE_TEST_MARKER();                           \
-        }                                                       \
-    } while( 0 )
-        #else
+/* Yield for the task if the running task would not be selected ahead of it.
+ * The scheduling class of the task decides between tasks of equal priority. */
         #define taskYIELD_ANY_CORE_IF_USING_PREEMPTION( pxTCB ) \
     do {                                                        \
-        if( pxCurrentTCB->uxAbsDeadline < ( pxTCB )->uxAbsDeadline )  \
+        if( taskCLASS_PREEMPTS( pxTCB ) != pdFALSE )            \
         {                                                       \
-            printf("PREEEMPTION happends! From %s to %s\n", pxCurrentTCB->pcTaskName, ( pxTCB )->pcTaskName); \
+            DEBUG_PRINT("PREEEMPTION happends! From %s to %s\n", pxCurrentTCB->pcTaskName, ( pxTCB )->pcTaskName); \
             portYIELD_WITHIN_API();                             \
         }                                                       \
         else                                                    \
@@ -119,7 +111,6 @@
             mtCOVERAGE_TEST_MARKER();                           \
         }                                                       \
     } while( 0 )
-        #endif
 
     #else /* if ( configNUMBER_OF_CORES == 1 ) */
 
@@ -181,7 +172,35 @@
     #define configIDLE_TASK_NAME    "IDLE"
 #endif
 
-#if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 )
+/* The MLFQ scheduler moves tasks between ready lists whenever it demotes or
+ * boosts them, so it always keeps the ready priorities in a bitmap and selects
+ * the highest ready priority in constant time, even if the port does not
+ * provide an optimised task selection method. */
+#if ( ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 1 ) || ( configUSE_MLFQ_SCHEDULER == 1 ) )
+    #define taskUSE_READY_PRIORITY_BITMAP    1
+#else
+    #define taskUSE_READY_PRIORITY_BITMAP    0
+#endif
+
+#if ( ( taskUSE_READY_PRIORITY_BITMAP == 1 ) && ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 ) )
+
+/* Generic versions of the port macros used with a ready priority bitmap.  Bit
+ * n of uxReadyPriorities is set while the ready list of priority n is not
+ * empty, so configMAX_PRIORITIES must not exceed the number of bits in a
+ * UBaseType_t. */
+    #define portRECORD_READY_PRIORITY( uxPriority, uxReadyPriorities )    ( uxReadyPriorities ) |= ( ( ( UBaseType_t ) 1U ) << ( uxPriority ) )
+    #define portRESET_READY_PRIORITY( uxPriority, uxReadyPriorities )     ( uxReadyPriorities ) &= ~( ( ( UBaseType_t ) 1U ) << ( uxPriority ) )
+
+    #if defined( __GNUC__ )
+        #define portGET_HIGHEST_PRIORITY( uxTopPriority, uxReadyPriorities ) \
+    uxTopPriority = ( UBaseType_t ) ( ( ( sizeof( unsigned long ) * 8U ) - 1U ) - ( UBaseType_t ) __builtin_clzl( ( unsigned long ) ( uxReadyPriorities ) ) )
+    #else
+        #define portGET_HIGHEST_PRIORITY( uxTopPriority, uxReadyPriorities )    uxTopPriority = prvGetHighestReadyPriority( uxReadyPriorities )
+    #endif
+
+#endif /* if ( ( taskUSE_READY_PRIORITY_BITMAP == 1 ) && ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 ) ) */
+
+#if ( taskUSE_READY_PRIORITY_BITMAP == 0 )
 
 /* If configUSE_PORT_OPTIMISED_TASK_SELECTION is 0 then task selection is
  * performed in a generic way that is not optimised to any particular
@@ -211,10 +230,9 @@
             --uxTopPriority;                                                             \
         }                                                                                \
                                                                                          \
-        /* listGET_OWNER_OF_NEXT_ENTRY indexes through the list, so the tasks of \
-         * the  same priority get an equal share of the processor time. */                    \
-        listGET_OWNER_OF_NEXT_ENTRY( pxCurrentTCB, &( pxReadyTasksLists[ uxTopPriority ] ) ); \
-        uxTopReadyPriority = uxTopPriority;                                                   \
+        /* The scheduling class of the priority selects one of its tasks. */            \
+        taskCLASS_PICK_NEXT( pxCurrentTCB, uxTopPriority );                              \
+        uxTopReadyPriority = uxTopPriority;                                              \
     } while( 0 ) /* taskSELECT_HIGHEST_PRIORITY_TASK */
     #else /* if ( configNUMBER_OF_CORES == 1 ) */
 
@@ -230,11 +248,13 @@
     #define taskRESET_READY_PRIORITY( uxPriority )
     #define portRESET_READY_PRIORITY( uxPriority, uxTopReadyPriority )
 
-#else /* configUSE_PORT_OPTIMISED_TASK_SELECTION */
+#else /* taskUSE_READY_PRIORITY_BITMAP */
 
 /* If configUSE_PORT_OPTIMISED_TASK_SELECTION is 1 then task selection is
  * performed in a way that is tailored to the particular microcontroller
- * architecture being used. */
+ * architecture being used.  The MLFQ scheduler also selects tasks this way,
+ * using the generic bitmap macros above if the port does not provide its
+ * own. */
 
 /* A port optimised version is provided.  Call the port defined macros. */
     #define taskRECORD_READY_PRIORITY( uxPriority )    portRECORD_READY_PRIORITY( ( uxPriority ), uxTopReadyPriority )
@@ -248,7 +268,7 @@
         /* Find the highest priority list that contains ready tasks. */                         \
         portGET_HIGHEST_PRIORITY( uxTopPriority, uxTopReadyPriority );                          \
         configASSERT( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ uxTopPriority ] ) ) > 0 ); \
-        listGET_OWNER_OF_NEXT_ENTRY( pxCurrentTCB, &( pxReadyTasksLists[ uxTopPriority ] ) );   \
+        taskCLASS_PICK_NEXT( pxCurrentTCB, uxTopPriority );                                     \
     } while( 0 )
 
 /*-----------------------------------------------------------*/
@@ -264,13 +284,15 @@
         }                                                                                              \
     } while( 0 )
 
-#endif /* configUSE_PORT_OPTIMISED_TASK_SELECTION */
+#endif /* taskUSE_READY_PRIORITY_BITMAP */
 
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_TIMER_WHEEL_DELAY == 0 )
+
 /* pxDelayedTaskList and pxOverflowDelayedTaskList are switched when the tick
  * count overflows. */
-#define taskSWITCH_DELAYED_LISTS()                                                \
+    #define taskSWITCH_DELAYED_LISTS()                                                \
     do {                                                                          \
         List_t * pxTemp;                                                          \
                                                                                   \
@@ -284,6 +306,31 @@
         prvResetNextTaskUnblockTime();                                            \
     } while( 0 )
 
+#else /* configUSE_TIMER_WHEEL_DELAY */
+
+/* The timing wheel is indexed by the tick count modulo the span of each level,
+ * so it needs nothing moving when the tick count overflows.  Only wake times
+ * that had not overflowed were considered when xNextTaskUnblockTime was last
+ * set though, so look at the wheel again on the tick that overflows. */
+    #define taskSWITCH_DELAYED_LISTS()                                \
+    do {                                                          \
+        xNumOfOverflows = ( BaseType_t ) ( xNumOfOverflows + 1 ); \
+        xNextTaskUnblockTime = ( TickType_t ) 0U;                 \
+    } while( 0 )
+
+/* Each level of the timing wheel has taskWHEEL_SLOTS slots, one bit of a
+ * uint32_t occupancy map each. */
+    #define taskWHEEL_SLOT_BITS    5U
+    #define taskWHEEL_SLOTS        ( ( UBaseType_t ) 1U << taskWHEEL_SLOT_BITS )
+    #define taskWHEEL_SLOT_MASK    ( taskWHEEL_SLOTS - 1U )
+
+/* True if pxList is one of the slots of the timing wheel. */
+    #define taskLIST_IS_DELAY_WHEEL_SLOT( pxList )                    \
+    ( ( ( pxList ) >= &( xDelayWheel[ 0 ][ 0 ] ) ) &&                 \
+      ( ( pxList ) <= &( xDelayWheel[ configTIMER_WHEEL_DELAY_LEVELS - 1 ][ taskWHEEL_SLOTS - 1U ] ) ) )
+
+#endif /* configUSE_TIMER_WHEEL_DELAY */
+
 /*-----------------------------------------------------------*/
 
 void printAllTasks()
@@ -318,33 +365,377 @@ void printAllTasks()
 }
 
 
+/*-----------------------------------------------------------*/
+
 /*
- * Place the task represented by pxTCB into the appropriate ready list for
- * the task.  It is inserted at the end of the list.
+ * Scheduling classes.
+ *
+ * Every task is scheduled by one scheduling class.  The EDF and weighted round
+ * robin classes own the priorities of their bands, configEDF_LOWEST_PRIORITY
+ * to configEDF_HIGHEST_PRIORITY and configWRR_LOWEST_PRIORITY to
+ * configWRR_HIGHEST_PRIORITY.  The MLFQ class owns the tasks created by
+ * xTaskCreateMLFQ(), which it moves between the priorities of the MLFQ band.
+ * Every other task is scheduled by fixed priority, and the tasks of the same
+ * priority are selected in turn.
+ *
+ * The rest of the kernel only uses the classes through these hooks:
+ *
+ * taskCLASS_ENQUEUE( pxTCB ) adds a task to the ready list of its priority.
+ *
+ * taskCLASS_DEQUEUE( pxTCB, xTickNow ) is called when a task blocks or is
+ * suspended.  The task is removed from its ready list by uxListRemove(), which
+ * also removes it from the deadline heap of the list if it is in one.
+ *
+ * taskCLASS_PICK_NEXT( pxTCB, uxPriority ) selects the next task to run from
+ * the ready list of uxPriority.
+ *
+ * taskCLASS_TICK( pxTCB, xTickNow, xYield ) charges the running task for a
+ * tick, and sets xYield to pdTRUE if the task must now give way.
+ *
+ * taskCLASS_SWITCH_OUT( pxTCB ) is called as the running task is switched out.
+ *
+ * taskCLASS_PREEMPTS( pxTCB ) evaluates to pdTRUE if pxTCB would be selected
+ * to run ahead of the running task.
+ *
+ * The hooks of a class that is not enabled are empty and its band test is the
+ * constant pdFALSE, so the compiler removes every reference to the class.  A
+ * band that holds every priority is the constant pdTRUE.
  */
-#if ( configUSE_EDF_SCHEDULER == 0 )
-    #define prvAddTaskToReadyList( pxTCB )                                                                     \
-    do {                                                                                                   \
-        traceMOVED_TASK_TO_READY_STATE( pxTCB );                                                           \
-        taskRECORD_READY_PRIORITY( ( pxTCB )->uxPriority );                                                \
-        listINSERT_END( &( pxReadyTasksLists[ ( pxTCB )->uxPriority ] ), &( ( pxTCB )->xStateListItem ) ); \
-        tracePOST_MOVED_TASK_TO_READY_STATE( pxTCB );                                                      \
+
+#if ( configUSE_EDF_SCHEDULER == 1 )
+
+    #if ( ( configEDF_LOWEST_PRIORITY == 0 ) && ( configEDF_HIGHEST_PRIORITY == ( configMAX_PRIORITIES - 1 ) ) )
+        #define taskEDF_OWNS( uxPriority )    pdTRUE
+    #else
+        #define taskEDF_OWNS( uxPriority )    ( ( ( UBaseType_t ) ( ( uxPriority ) - ( UBaseType_t ) configEDF_LOWEST_PRIORITY ) <= ( ( UBaseType_t ) configEDF_HIGHEST_PRIORITY - ( UBaseType_t ) configEDF_LOWEST_PRIORITY ) ) ? pdTRUE : pdFALSE )
+    #endif
+
+/* The absolute deadline of the task is stored in the item value of its state
+ * list item, and the ready list orders its tasks by that value in a deadline
+ * heap, so adding a task costs O(1) however many tasks are ready. */
+    #define taskEDF_ENQUEUE( pxTCB, pxList )                                                    \
+    do {                                                                                    \
+        listSET_LIST_ITEM_VALUE( &( ( pxTCB )->xStateListItem ), task_ADD_DEADLINE( pxTCB ) ); \
+        vListInsertDeadline( ( pxList ), &( ( pxTCB )->xStateListItem ) );                  \
     } while( 0 )
-#endif
 
+/* Blocking ends the current activation of the task. */
+    #define taskEDF_DEQUEUE( pxTCB, xTickNow )    prvEndDeadlineActivation( ( pxTCB ), ( xTickNow ) )
+
+/* The task with the earliest deadline is selected. */
+    #define taskEDF_PICK_NEXT( pxTCB, pxList )    ( pxTCB ) = listGET_OWNER_OF_DEADLINE_HEAD( pxList )
+
+/* The deadline has passed once it precedes the tick count, which remains
+ * correct when either value has wrapped.  A task of the same priority with an
+ * earlier deadline is selected ahead of the running task anyway, so the task is
+ * not time sliced. */
+    #define taskEDF_TICK( pxTCB, xTickNow, xYield )                                                   \
+    do {                                                                                          \
+        if( ( ( pxTCB )->xIsMissDDL == pdFALSE ) &&                                               \
+            ( ( pxTCB )->uxDeadLine != ( TickType_t ) 0U ) &&                                     \
+            ( listDEADLINE_PRECEDES( ( pxTCB )->uxAbsDeadline, ( xTickNow ) ) != pdFALSE ) )      \
+        {                                                                                         \
+            ( xYield ) = pdTRUE;                                                                  \
+            ( pxTCB )->xIsMissDDL = pdTRUE;                                                       \
+            prvRecordDeadlineMiss( ( pxTCB ), ( xTickNow ) );                                     \
+        }                                                                                         \
+        else                                                                                      \
+        {                                                                                         \
+            mtCOVERAGE_TEST_MARKER();                                                             \
+        }                                                                                         \
+    } while( 0 )
 
+/* Deadlines are compared by their difference, which is the same as comparing
+ * the signed number of ticks each task has left relative to xTickCount, so the
+ * result is correct when the tick count wraps. */
+    #define taskEDF_PRECEDES( pxTCB, pxOtherTCB )    listDEADLINE_PRECEDES( ( pxTCB )->uxAbsDeadline, ( pxOtherTCB )->uxAbsDeadline )
 
-//To use EDF scheduler
-#if ( configUSE_EDF_SCHEDULER == 1 )
-    #define prvAddTaskToReadyList( pxTCB )	                                                                \
-    do {                                                                                                   \
-        traceMOVED_TASK_TO_READY_STATE( pxTCB );                                                           \
-        taskRECORD_READY_PRIORITY( ( pxTCB )->uxPriority );                                                \
-        listEDF_INSERT_END( &( pxReadyTasksLists[ ( pxTCB )->uxPriority ] ), &( ( pxTCB )->xStateListItem ) ); \
-        tracePOST_MOVED_TASK_TO_READY_STATE( pxTCB );                                                      \
+#else /* if ( configUSE_EDF_SCHEDULER == 1 ) */
+
+    #define taskEDF_OWNS( uxPriority )    pdFALSE
+    #define taskEDF_ENQUEUE( pxTCB, pxList )
+    #define taskEDF_DEQUEUE( pxTCB, xTickNow )
+    #define taskEDF_PICK_NEXT( pxTCB, pxList )
+    #define taskEDF_TICK( pxTCB, xTickNow, xYield )
+    #define taskEDF_PRECEDES( pxTCB, pxOtherTCB )    pdFALSE
+
+#endif /* if ( configUSE_EDF_SCHEDULER == 1 ) */
+
+#if ( configUSE_WEIGHTED_ROUND_ROBIN == 1 )
+
+    #if ( ( configWRR_LOWEST_PRIORITY == 0 ) && ( configWRR_HIGHEST_PRIORITY == ( configMAX_PRIORITIES - 1 ) ) )
+        #define taskWRR_OWNS( uxPriority )    pdTRUE
+    #else
+        #define taskWRR_OWNS( uxPriority )    ( ( ( UBaseType_t ) ( ( uxPriority ) - ( UBaseType_t ) configWRR_LOWEST_PRIORITY ) <= ( ( UBaseType_t ) configWRR_HIGHEST_PRIORITY - ( UBaseType_t ) configWRR_LOWEST_PRIORITY ) ) ? pdTRUE : pdFALSE )
+    #endif
+
+/* The ready list orders its tasks by their virtual run time, which
+ * prvWRRJoinReadyList() places in the item value of the state list item. */
+    #define taskWRR_ENQUEUE( pxTCB, pxList )                                   \
+    do {                                                                   \
+        prvWRRJoinReadyList( pxTCB );                                      \
+        vListInsertDeadline( ( pxList ), &( ( pxTCB )->xStateListItem ) ); \
+    } while( 0 )
+
+/* The task with the smallest virtual run time is selected. */
+    #define taskWRR_PICK_NEXT( pxTCB, pxList )    ( pxTCB ) = listGET_OWNER_OF_DEADLINE_HEAD( pxList )
+
+/* Charge the running task for the tick.  Its position in the ready list is
+ * only updated when it is switched out, so the tick interrupt does not walk the
+ * heap.  If no other task is waiting for the processor at the end of the time
+ * slice then the task's virtual run time is the virtual time of its priority. */
+    #define taskWRR_TICK( pxTCB, xYield )                                                               \
+    do {                                                                                            \
+        ( pxTCB )->xWRRVirtualRuntime += ( pxTCB )->xWRRStride;                                     \
+        ( pxTCB )->uxRemainingTicks -= 1U;                                                          \
+                                                                                                    \
+        if( ( pxTCB )->uxRemainingTicks == ( UBaseType_t ) 0U )                                     \
+        {                                                                                           \
+            ( pxTCB )->uxRemainingTicks = configSLICE_INTERVAL;                                     \
+                                                                                                    \
+            if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ ( pxTCB )->uxPriority ] ) ) > 1U )   \
+            {                                                                                       \
+                ( xYield ) = pdTRUE;                                                                \
+            }                                                                                       \
+            else                                                                                    \
+            {                                                                                       \
+                xWRRVirtualTime[ ( pxTCB )->uxPriority ] = ( pxTCB )->xWRRVirtualRuntime;           \
+            }                                                                                       \
+        }                                                                                           \
+        else                                                                                        \
+        {                                                                                           \
+            mtCOVERAGE_TEST_MARKER();                                                               \
+        }                                                                                           \
+    } while( 0 )
+
+    #define taskWRR_SWITCH_OUT( pxTCB )    prvWRRSwitchOut( pxTCB )
+
+/* The virtual run time a task is charged for each tick it runs for is
+ * taskWRR_STRIDE_SCALE divided by its weight. */
+    #define taskWRR_STRIDE_SCALE    ( ( TickType_t ) configWRR_MAX_WEIGHT * ( TickType_t ) 256U )
+
+/* A task that remains ready is never further ahead of the virtual time of its
+ * priority than one time slice at the lowest weight, plus the time slice by
+ * which the virtual time can lag the ready task furthest behind.  A task that
+ * appears to be further ahead than that can only have been away from the ready
+ * list while the virtual time wrapped. */
+    #define taskWRR_MAX_LEAD        ( ( TickType_t ) 2U * configSLICE_INTERVAL * taskWRR_STRIDE_SCALE )
+
+#else /* if ( configUSE_WEIGHTED_ROUND_ROBIN == 1 ) */
+
+    #define taskWRR_OWNS( uxPriority )    pdFALSE
+    #define taskWRR_ENQUEUE( pxTCB, pxList )
+    #define taskWRR_PICK_NEXT( pxTCB, pxList )
+    #define taskWRR_TICK( pxTCB, xYield )
+    #define taskWRR_SWITCH_OUT( pxTCB )
+
+#endif /* if ( configUSE_WEIGHTED_ROUND_ROBIN == 1 ) */
+
+/*
+ * A priority boost only moves the tasks that are in the ready lists when it
+ * happens.  A task that was blocked or suspended at the time has an out of date
+ * boost generation, and is boosted when it is next added to a ready list.
+ */
+#if ( configUSE_MLFQ_SCHEDULER == 1 )
+
+    #define taskMLFQ_OWNS( pxTCB )    ( ( pxTCB )->xIsMLFQTask )
+
+/* The number of ticks a task may run for on an MLFQ level before it is moved
+ * to the level below. */
+    #define taskMLFQ_LEVEL_TICKS( uxLevel )    ( xMLFQLevelTicks[ ( uxLevel ) ] )
+
+    #define taskMLFQ_APPLY_MISSED_BOOST( pxTCB )                              \
+    do {                                                                  \
+        if( ( pxTCB )->uxBoostGeneration != uxMLFQBoostGeneration )       \
+        {                                                                 \
+            prvMLFQBoostTask( pxTCB );                                    \
+        }                                                                 \
+    } while( 0 )
+
+/* A ready MLFQ task is also in the MLFQ list of its priority, which holds only
+ * MLFQ tasks, so a boost does not have to search a ready list for them. */
+    #define taskMLFQ_ENQUEUE( pxTCB )                                                                \
+    do {                                                                                             \
+        if( ( pxTCB )->xIsMLFQTask != pdFALSE )                                                      \
+        {                                                                                            \
+            taskMLFQ_DEQUEUE( pxTCB );                                                               \
+            listINSERT_END( &( xMLFQReadyLists[ ( pxTCB )->uxPriority ] ), &( ( pxTCB )->xMLFQListItem ) ); \
+        }                                                                                            \
+        else                                                                                         \
+        {                                                                                            \
+            mtCOVERAGE_TEST_MARKER();                                                                \
+        }                                                                                            \
+    } while( 0 )
+
+    #define taskMLFQ_DEQUEUE( pxTCB )                                                \
+    do {                                                                             \
+        if( listLIST_ITEM_CONTAINER( &( ( pxTCB )->xMLFQListItem ) ) != NULL )       \
+        {                                                                            \
+            ( void ) uxListRemove( &( ( pxTCB )->xMLFQListItem ) );                  \
+        }                                                                            \
+        else                                                                         \
+        {                                                                            \
+            mtCOVERAGE_TEST_MARKER();                                                \
+        }                                                                            \
+    } while( 0 )
+
+    #if ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) )
+        #define taskMLFQ_TICK( pxTCB, xYield )                    \
+    do {                                                          \
+        if( prvMLFQTimeSliceUsed( pxTCB ) != pdFALSE )            \
+        {                                                         \
+            ( xYield ) = pdTRUE;                                  \
+            moveTaskToLowerQueue( pxTCB );                        \
+        }                                                         \
+        else                                                      \
+        {                                                         \
+            mtCOVERAGE_TEST_MARKER();                             \
+        }                                                         \
+    } while( 0 )
+    #else
+        #define taskMLFQ_TICK( pxTCB, xYield )
+    #endif
+
+#else /* if ( configUSE_MLFQ_SCHEDULER == 1 ) */
+
+    #define taskMLFQ_OWNS( pxTCB )    pdFALSE
+    #define taskMLFQ_APPLY_MISSED_BOOST( pxTCB )
+    #define taskMLFQ_ENQUEUE( pxTCB )
+    #define taskMLFQ_DEQUEUE( pxTCB )
+    #define taskMLFQ_TICK( pxTCB, xYield )
+
+#endif /* if ( configUSE_MLFQ_SCHEDULER == 1 ) */
+
+/* Tasks of equal priority to the running task share processing time (time
+ * slice) if preemption is on, and the application writer has not explicitly
+ * turned time slicing off. */
+#if ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) )
+    #define taskFIXED_TICK( pxTCB, xYield )                                                         \
+    do {                                                                                        \
+        if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ ( pxTCB )->uxPriority ] ) ) > 1U )   \
+        {                                                                                       \
+            ( xYield ) = pdTRUE;                                                                \
+        }                                                                                       \
+        else                                                                                    \
+        {                                                                                       \
+            mtCOVERAGE_TEST_MARKER();                                                           \
+        }                                                                                       \
     } while( 0 )
+#else
+    #define taskFIXED_TICK( pxTCB, xYield )
 #endif
 
+/* The tasks of the fixed priority and MLFQ classes are inserted at the end of
+ * the list. */
+#define taskCLASS_ENQUEUE( pxTCB )                                                                     \
+    do {                                                                                               \
+        List_t * const pxClassList = &( pxReadyTasksLists[ ( pxTCB )->uxPriority ] );                  \
+                                                                                                       \
+        taskRECORD_READY_PRIORITY( ( pxTCB )->uxPriority );                                            \
+        taskMLFQ_ENQUEUE( pxTCB );                                                                     \
+                                                                                                       \
+        if( taskEDF_OWNS( ( pxTCB )->uxPriority ) != pdFALSE )                                         \
+        {                                                                                              \
+            taskEDF_ENQUEUE( ( pxTCB ), pxClassList );                                                 \
+        }                                                                                              \
+        else if( taskWRR_OWNS( ( pxTCB )->uxPriority ) != pdFALSE )                                    \
+        {                                                                                              \
+            taskWRR_ENQUEUE( ( pxTCB ), pxClassList );                                                 \
+        }                                                                                              \
+        else                                                                                           \
+        {                                                                                              \
+            listINSERT_END( pxClassList, &( ( pxTCB )->xStateListItem ) );                             \
+        }                                                                                              \
+    } while( 0 )
+
+#define taskCLASS_DEQUEUE( pxTCB, xTickNow )                   \
+    do {                                                       \
+        taskMLFQ_DEQUEUE( pxTCB );                             \
+                                                               \
+        if( taskEDF_OWNS( ( pxTCB )->uxPriority ) != pdFALSE ) \
+        {                                                      \
+            taskEDF_DEQUEUE( ( pxTCB ), ( xTickNow ) );        \
+        }                                                      \
+        else                                                   \
+        {                                                      \
+            mtCOVERAGE_TEST_MARKER();                          \
+        }                                                      \
+    } while( 0 )
+
+/* listGET_OWNER_OF_NEXT_ENTRY indexes through the list, so the tasks of the
+ * same priority get an equal share of the processor time. */
+#define taskCLASS_PICK_NEXT( pxTCB, uxPriority )                            \
+    do {                                                                    \
+        List_t * const pxClassList = &( pxReadyTasksLists[ ( uxPriority ) ] ); \
+                                                                            \
+        if( taskEDF_OWNS( uxPriority ) != pdFALSE )                         \
+        {                                                                   \
+            taskEDF_PICK_NEXT( ( pxTCB ), pxClassList );                    \
+        }                                                                   \
+        else if( taskWRR_OWNS( uxPriority ) != pdFALSE )                    \
+        {                                                                   \
+            taskWRR_PICK_NEXT( ( pxTCB ), pxClassList );                    \
+        }                                                                   \
+        else                                                                \
+        {                                                                   \
+            listGET_OWNER_OF_NEXT_ENTRY( ( pxTCB ), pxClassList );          \
+        }                                                                   \
+    } while( 0 )
+
+#define taskCLASS_TICK( pxTCB, xTickNow, xYield )                     \
+    do {                                                              \
+        if( taskEDF_OWNS( ( pxTCB )->uxPriority ) != pdFALSE )        \
+        {                                                             \
+            taskEDF_TICK( ( pxTCB ), ( xTickNow ), ( xYield ) );      \
+        }                                                             \
+        else if( taskWRR_OWNS( ( pxTCB )->uxPriority ) != pdFALSE )   \
+        {                                                             \
+            taskWRR_TICK( ( pxTCB ), ( xYield ) );                    \
+        }                                                             \
+        else if( taskMLFQ_OWNS( pxTCB ) != pdFALSE )                  \
+        {                                                             \
+            taskMLFQ_TICK( ( pxTCB ), ( xYield ) );                   \
+        }                                                             \
+        else                                                          \
+        {                                                             \
+            taskFIXED_TICK( ( pxTCB ), ( xYield ) );                  \
+        }                                                             \
+    } while( 0 )
+
+#define taskCLASS_SWITCH_OUT( pxTCB )                          \
+    do {                                                       \
+        if( taskWRR_OWNS( ( pxTCB )->uxPriority ) != pdFALSE ) \
+        {                                                      \
+            taskWRR_SWITCH_OUT( pxTCB );                       \
+        }                                                      \
+        else                                                   \
+        {                                                      \
+            mtCOVERAGE_TEST_MARKER();                          \
+        }                                                      \
+    } while( 0 )
+
+/* Priority is always considered first.  Of two tasks of the same priority only
+ * the EDF class ever prefers the task that is not running. */
+#define taskCLASS_PREEMPTS( pxTCB )                                                      \
+    ( ( ( ( pxTCB )->uxPriority > pxCurrentTCB->uxPriority ) ||                          \
+        ( ( ( pxTCB )->uxPriority == pxCurrentTCB->uxPriority ) &&                       \
+          ( taskEDF_OWNS( ( pxTCB )->uxPriority ) != pdFALSE ) &&                        \
+          ( taskEDF_PRECEDES( ( pxTCB ), pxCurrentTCB ) != pdFALSE ) ) ) ? pdTRUE : pdFALSE )
+
+/*
+ * Place the task represented by pxTCB into the appropriate ready list for
+ * the task.  A task that missed an MLFQ priority boost while it was not ready
+ * is moved to the top MLFQ level first, so it is added to the list of its new
+ * priority.
+ */
+#define prvAddTaskToReadyList( pxTCB )               \
+    do {                                             \
+        traceMOVED_TASK_TO_READY_STATE( pxTCB );     \
+        taskMLFQ_APPLY_MISSED_BOOST( pxTCB );        \
+        taskCLASS_ENQUEUE( pxTCB );                  \
+        tracePOST_MOVED_TASK_TO_READY_STATE( pxTCB ); \
+    } while( 0 )
+
 
 /*-----------------------------------------------------------*/
  
@@ -452,14 +843,30 @@ typedef struct tskTaskControlBlock       /* The old naming convention is used to
     TickType_t uxAbsDeadline;                    /**< The absolute deadline of the task. */
     BaseType_t xIsMissDDL;                        /**< The flag to indicate whether the task misses the deadline. */
 
+    #if ( configUSE_EDF_SCHEDULER == 1 )
+        UBaseType_t uxDeadlineMisses;               /**< The number of activations of the task that missed their deadline. */
+        TickType_t xMaxLateness;                    /**< The largest number of ticks by which an activation completed after its deadline. */
+    #endif
+
     #if (configUSE_WEIGHTED_ROUND_ROBIN == 1)
         UBaseType_t uxWeight;                       /**< The weight of the task. */
+        TickType_t xWRRStride;                      /**< The virtual run time the task is charged for each tick it runs for. */
+        TickType_t xWRRVirtualRuntime;              /**< The virtual run time of the task, which orders the ready list of its priority. */
     #endif
 
     #if (configUSE_WEIGHTED_ROUND_ROBIN == 1 || configUSE_MLFQ_SCHEDULER == 1)
         UBaseType_t uxRemainingTicks;               /**< The remaining ticks of the task. */
     #endif
 
+    #if ( configUSE_MLFQ_SCHEDULER == 1 )
+        UBaseType_t uxBoostGeneration;              /**< The last MLFQ priority boost applied to the task. */
+        BaseType_t xIsMLFQTask;                     /**< pdTRUE if the task was created by xTaskCreateMLFQ(), so its level is managed by the MLFQ scheduler. */
+        ListItem_t xMLFQListItem;                   /**< Used to place a ready MLFQ task in the MLFQ list of its priority. */
+        #if ( configMLFQ_USE_RUN_TIME_ACCOUNTING == 1 )
+            configRUN_TIME_COUNTER_TYPE ulMLFQRunTimeUsed; /**< The run time the task has used since it was placed on its current MLFQ level. */
+        #endif
+    #endif
+
     #if ( configNUMBER_OF_CORES > 1 )
         volatile BaseType_t xTaskRunState;      /**< Used to identify the core the task is running on, if the task is running. Otherwise, identifies the task's state - not running or yielding. */
         UBaseType_t uxTaskAttributes;           /**< Task's attributes - currently used to identify the idle tasks. */
@@ -522,6 +929,10 @@ typedef struct tskTaskControlBlock       /* The old naming convention is used to
     #if ( configUSE_POSIX_ERRNO == 1 )
         int iTaskErrno;
     #endif
+
+    #if ( configUSE_HEAP_CACHE == 1 )
+        void * pvHeapCache; /**< The task's cache of small blocks, owned by heap_4.c.  NULL until the task first calls pvPortMalloc() or vPortFree(). */
+    #endif
 } tskTCB;
 
 /* The old tskTCB name is maintained above then typedefed to the new TCB_t name
@@ -546,10 +957,15 @@ typedef tskTCB TCB_t;
  * doing so breaks some kernel aware debuggers and debuggers that rely on removing
  * the static qualifier. */
 PRIVILEGED_DATA static List_t pxReadyTasksLists[ configMAX_PRIORITIES ]; /**< Prioritised ready tasks. */
-PRIVILEGED_DATA static List_t xDelayedTaskList1;                         /**< Delayed tasks. */
-PRIVILEGED_DATA static List_t xDelayedTaskList2;                         /**< Delayed tasks (two lists are used - one for delays that have overflowed the current tick count. */
-PRIVILEGED_DATA static List_t * volatile pxDelayedTaskList;              /**< Points to the delayed task list currently being used. */
-PRIVILEGED_DATA static List_t * volatile pxOverflowDelayedTaskList;      /**< Points to the delayed task list currently being used to hold tasks that have overflowed the current tick count. */
+#if ( configUSE_TIMER_WHEEL_DELAY == 0 )
+    PRIVILEGED_DATA static List_t xDelayedTaskList1;                     /**< Delayed tasks. */
+    PRIVILEGED_DATA static List_t xDelayedTaskList2;                     /**< Delayed tasks (two lists are used - one for delays that have overflowed the current tick count. */
+    PRIVILEGED_DATA static List_t * volatile pxDelayedTaskList;          /**< Points to the delayed task list currently being used. */
+    PRIVILEGED_DATA static List_t * volatile pxOverflowDelayedTaskList;  /**< Points to the delayed task list currently being used to hold tasks that have overflowed the current tick count. */
+#else
+    PRIVILEGED_DATA static List_t xDelayWheel[ configTIMER_WHEEL_DELAY_LEVELS ][ taskWHEEL_SLOTS ]; /**< Delayed tasks, by the slot their wake time falls in at each level. */
+    PRIVILEGED_DATA static uint32_t ulDelayWheelOccupied[ configTIMER_WHEEL_DELAY_LEVELS ];         /**< A bit per slot that may hold a task.  Bits are cleared lazily, when the slot is next serviced. */
+#endif
 PRIVILEGED_DATA static List_t xPendingReadyList;                         /**< Tasks that have been readied while the scheduler was suspended.  They will be moved to the ready list when the scheduler is resumed. */
 
 #if ( INCLUDE_vTaskDelete == 1 )
@@ -583,6 +999,46 @@ PRIVILEGED_DATA static UBaseType_t uxTaskNumber = ( UBaseType_t ) 0U;
 PRIVILEGED_DATA static volatile TickType_t xNextTaskUnblockTime = ( TickType_t ) 0U; /* Initialised to portMAX_DELAY before the scheduler starts. */
 PRIVILEGED_DATA static TaskHandle_t xIdleTaskHandles[ configNUMBER_OF_CORES ];       /**< Holds the handles of the idle tasks.  The idle tasks are created automatically when the scheduler is started. */
 PRIVILEGED_DATA static volatile UBaseType_t uxMLFQCount = ( UBaseType_t ) 0U;
+
+#if ( configUSE_MLFQ_SCHEDULER == 1 )
+
+/* Each priority boost increments uxMLFQBoostGeneration.  The tasks that were
+ * ready when the boost happened are moved to the top level a few at a time by
+ * the following ticks, for as long as xMLFQBoostPending remains set. */
+    PRIVILEGED_DATA static volatile UBaseType_t uxMLFQBoostGeneration = ( UBaseType_t ) 0U;
+    PRIVILEGED_DATA static volatile BaseType_t xMLFQBoostPending = pdFALSE;
+
+/* The ready MLFQ tasks of each priority, in the order they were made ready.
+ * Other tasks can share the ready lists of the MLFQ levels, so the boost takes
+ * the tasks it moves from these lists instead. */
+    PRIVILEGED_DATA static List_t xMLFQReadyLists[ configMAX_PRIORITIES ];
+
+/* The MLFQ policy.  The levels are the priorities from uxMLFQLowestPriority to
+ * uxMLFQHighestPriority inclusive.  xMLFQLevelTicks holds the time slice of
+ * every priority, so a task that has been moved outside the band still has a
+ * valid time slice.  The default policy is applied when the first task is
+ * created, unless vTaskSetMLFQPolicy() has already been called. */
+    PRIVILEGED_DATA static UBaseType_t uxMLFQHighestPriority = ( UBaseType_t ) configMLFQ_HIGHEST_PRIORITY;
+    PRIVILEGED_DATA static UBaseType_t uxMLFQLowestPriority = ( UBaseType_t ) configMLFQ_LOWEST_PRIORITY;
+    PRIVILEGED_DATA static TickType_t xMLFQBoostPeriod = ( TickType_t ) configMLFQ_LOOP_TIME_SLICE;
+    PRIVILEGED_DATA static TickType_t xMLFQLevelTicks[ configMAX_PRIORITIES ];
+    PRIVILEGED_DATA static BaseType_t xMLFQPolicyApplied = pdFALSE;
+
+/* The run time counter value up to which the running task has been charged for
+ * the time it has used on its MLFQ level. */
+    #if ( configMLFQ_USE_RUN_TIME_ACCOUNTING == 1 )
+        PRIVILEGED_DATA static configRUN_TIME_COUNTER_TYPE ulMLFQChargedUpTo = 0U;
+    #endif
+#endif
+
+#if ( configUSE_WEIGHTED_ROUND_ROBIN == 1 )
+
+/* The virtual time of each priority, which is the smallest virtual run time of
+ * the ready tasks of that priority the last time it was measured.  It never
+ * decreases, and a task that becomes ready starts no further behind it. */
+    PRIVILEGED_DATA static TickType_t xWRRVirtualTime[ configMAX_PRIORITIES ];
+#endif
+
 /* Improve support for OpenOCD. The kernel tracks Ready tasks via priority lists.
  * For tracking the state of remote threads, OpenOCD uses uxTopUsedPriority
  * to determine the number of priority lists to read back from the remote target. */
@@ -602,6 +1058,22 @@ static const volatile UBaseType_t uxTopUsedPriority = configMAX_PRIORITIES - 1U;
  * from either an ISR or a task. */
 PRIVILEGED_DATA static volatile UBaseType_t uxSchedulerSuspended = ( UBaseType_t ) 0U;
 
+#if ( ( configUSE_EDF_SCHEDULER == 1 ) && ( configDEADLINE_MISS_EVENT_BUFFER_LENGTH > 0 ) )
+
+    #if ( ( configDEADLINE_MISS_EVENT_BUFFER_LENGTH & ( configDEADLINE_MISS_EVENT_BUFFER_LENGTH - 1 ) ) != 0 )
+        #error configDEADLINE_MISS_EVENT_BUFFER_LENGTH must be a power of two.
+    #endif
+
+/* Ring of the most recent deadline misses.  It is written by the tick interrupt,
+ * and by a task ending a late activation from a critical section, so there is
+ * one writer at a time.  The writer fills the slot of event number
+ * uxDeadlineMissEventCount and only then increments uxDeadlineMissEventCount,
+ * so readers never need to lock. */
+PRIVILEGED_DATA static DeadlineMissEvent_t xDeadlineMissEvents[ configDEADLINE_MISS_EVENT_BUFFER_LENGTH ];
+PRIVILEGED_DATA static volatile UBaseType_t uxDeadlineMissEventCount = ( UBaseType_t ) 0U;
+
+#endif
+
 #if ( configGENERATE_RUN_TIME_STATS == 1 )
 
 /* Do not move these variables to function scope as doing so prevents the
@@ -663,6 +1135,14 @@ static BaseType_t prvCreateIdleTasks( void );
  */
 static void prvInitialiseTaskLists( void ) PRIVILEGED_FUNCTION;
 
+/*
+ * Returns the most significant bit set in a ready priority bitmap, for
+ * compilers that do not provide a count leading zeros builtin.
+ */
+#if ( ( taskUSE_READY_PRIORITY_BITMAP == 1 ) && ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 ) && !defined( __GNUC__ ) )
+    static UBaseType_t prvGetHighestReadyPriority( UBaseType_t uxReadyPriorities ) PRIVILEGED_FUNCTION;
+#endif
+
 /*
  * The idle task, which as all tasks is implemented as a never ending loop.
  * The idle task is automatically created and added to the ready lists upon
@@ -711,6 +1191,70 @@ static void prvCheckTasksWaitingTermination( void ) PRIVILEGED_FUNCTION;
 static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
                                             const BaseType_t xCanBlockIndefinitely ) PRIVILEGED_FUNCTION;
 
+/*
+ * Called from the tick interrupt when the running task passes its deadline, or
+ * when a task ends an activation after its deadline without the tick interrupt
+ * having seen it.  Counts the miss against the task and adds it to the miss
+ * event ring.
+ */
+#if ( configUSE_EDF_SCHEDULER == 1 )
+
+    static void prvRecordDeadlineMiss( TCB_t * const pxTCB,
+                                       const TickType_t xTickNow ) PRIVILEGED_FUNCTION;
+
+/*
+ * Called when a task blocks or is suspended, which ends its current
+ * activation.  If the activation missed its deadline then this is when its
+ * lateness is known.
+ */
+    static void prvEndDeadlineActivation( TCB_t * const pxTCB,
+                                          const TickType_t xTickNow ) PRIVILEGED_FUNCTION;
+
+#endif
+
+/*
+ * Weighted round robin.  prvWRRJoinReadyList() sets the item value of a task
+ * that is being added to a ready list to its virtual run time, first moving
+ * the virtual run time up to the virtual time of the task's priority if it is
+ * behind.  prvWRRSwitchOut() is called as the running task is switched out, and
+ * reorders the ready list if the task has been charged since it was inserted.
+ */
+#if ( configUSE_WEIGHTED_ROUND_ROBIN == 1 )
+
+    static void prvWRRJoinReadyList( TCB_t * const pxTCB ) PRIVILEGED_FUNCTION;
+
+    static void prvWRRSwitchOut( TCB_t * const pxTCB ) PRIVILEGED_FUNCTION;
+
+#endif
+
+/*
+ * MLFQ priority boost.  prvMLFQBoostTask() moves a task that is not in a ready
+ * list to the top level.  prvMLFQBoostStep() is called from the tick interrupt
+ * while a boost is pending, and boosts the first MLFQ task on each lower level,
+ * returning pdTRUE if any of those levels still contain MLFQ tasks.  Each step
+ * takes constant time per level, however many tasks are ready.
+ */
+#if ( configUSE_MLFQ_SCHEDULER == 1 )
+
+    static void prvMLFQBoostTask( TCB_t * const pxTCB ) PRIVILEGED_FUNCTION;
+
+    static BaseType_t prvMLFQBoostStep( void ) PRIVILEGED_FUNCTION;
+
+#endif
+
+/*
+ * Set the MLFQ band and fill in the time slice of every priority.  If
+ * pxLevelTimeSlices is NULL the default time slices are used.
+ */
+#if ( configUSE_MLFQ_SCHEDULER == 1 )
+
+    static void prvMLFQApplyPolicy( UBaseType_t uxHighestPriority,
+                                    UBaseType_t uxNumberOfLevels,
+                                    const TickType_t * pxLevelTimeSlices,
+                                    TickType_t xBoostPeriod ) PRIVILEGED_FUNCTION;
+
+#endif
+
 /*
  * Fills an TaskStatus_t structure with information on each task that is
  * referenced from the pxList list (which may be a ready list, a delayed list,
@@ -767,10 +1311,37 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
 
 /*
  * Set xNextTaskUnblockTime to the time at which the next Blocked state task
- * will exit the Blocked state.
+ * will exit the Blocked state.  When the timing wheel is used this is instead
+ * the next tick at which the wheel has a slot to service, which is never later
+ * than the time the next task must be unblocked.
  */
 static void prvResetNextTaskUnblockTime( void ) PRIVILEGED_FUNCTION;
 
+/*
+ * Move a task whose block time has expired from the Blocked state to the
+ * Ready state.  Returns pdTRUE if the running task should now be preempted.
+ */
+static BaseType_t prvUnblockTimedOutTask( TCB_t * const pxTCB ) PRIVILEGED_FUNCTION;
+
+#if ( configUSE_TIMER_WHEEL_DELAY == 1 )
+
+/*
+ * Place a task in the slot of the timing wheel that its wake time, the item
+ * value of its state list item, falls in when seen from xFromTime.
+ */
+    static void prvDelayWheelInsert( ListItem_t * const pxStateListItem,
+                                     const TickType_t xFromTime ) PRIVILEGED_FUNCTION;
+
+/*
+ * Service the timing wheel for the tick xConstTickCount:  move the tasks held
+ * in the slots of higher levels that have come round down the wheel, and
+ * unblock the tasks whose wake time is xConstTickCount.  Returns pdTRUE if a
+ * context switch is required.
+ */
+    static BaseType_t prvDelayWheelServiceTick( const TickType_t xConstTickCount ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_TIMER_WHEEL_DELAY */
+
 #if ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 )
 
 /*
@@ -1434,6 +2005,39 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
     }
 /*-----------------------------------------------------------*/
 
+    #if ( configUSE_MLFQ_SCHEDULER == 1 )
+        TaskHandle_t xTaskCreateMLFQStatic( TaskFunction_t pxTaskCode,
+                                            const char * const pcName,
+                                            const configSTACK_DEPTH_TYPE uxStackDepth,
+                                            void * const pvParameters,
+                                            StackType_t * const puxStackBuffer,
+                                            StaticTask_t * const pxTaskBuffer )
+        {
+            TaskHandle_t xReturn = NULL;
+            TCB_t * pxNewTCB;
+
+            traceENTER_xTaskCreateMLFQStatic( pxTaskCode, pcName, uxStackDepth, pvParameters, puxStackBuffer, pxTaskBuffer );
+
+            /* New MLFQ tasks start on the top level. */
+            pxNewTCB = prvCreateStaticTask( pxTaskCode, pcName, uxStackDepth, pvParameters, uxMLFQHighestPriority, puxStackBuffer, pxTaskBuffer, &xReturn );
+
+            if( pxNewTCB != NULL )
+            {
+                pxNewTCB->xIsMLFQTask = pdTRUE;
+                prvAddNewTaskToReadyList( pxNewTCB );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            traceRETURN_xTaskCreateMLFQStatic( xReturn );
+
+            return xReturn;
+        }
+    #endif /* configUSE_MLFQ_SCHEDULER */
+/*-----------------------------------------------------------*/
+
     #if ( ( configNUMBER_OF_CORES > 1 ) && ( configUSE_CORE_AFFINITY == 1 ) )
         TaskHandle_t xTaskCreateStaticAffinitySet( TaskFunction_t pxTaskCode,
                                                    const char * const pcName,
@@ -1601,7 +2205,7 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
             /* MISRA Ref 11.5.1 [Malloc memory assignment] */
             /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
             /* coverity[misra_c_2012_rule_11_5_violation] */
-            pxNewTCB = ( TCB_t * ) pvPortMalloc( sizeof( TCB_t ) );
+            pxNewTCB = ( TCB_t * ) pvPortMallocTCB( sizeof( TCB_t ) );
 
             if( pxNewTCB != NULL )
             {
@@ -1728,7 +2332,7 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
             /* MISRA Ref 11.5.1 [Malloc memory assignment] */
             /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
             /* coverity[misra_c_2012_rule_11_5_violation] */
-            pxNewTCB = ( TCB_t * ) pvPortMalloc( sizeof( TCB_t ) );
+            pxNewTCB = ( TCB_t * ) pvPortMallocTCB( sizeof( TCB_t ) );
 
             if( pxNewTCB != NULL )
             {
@@ -1766,7 +2370,7 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
                 /* MISRA Ref 11.5.1 [Malloc memory assignment] */
                 /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
                 /* coverity[misra_c_2012_rule_11_5_violation] */
-                pxNewTCB = ( TCB_t * ) pvPortMalloc( sizeof( TCB_t ) );
+                pxNewTCB = ( TCB_t * ) pvPortMallocTCB( sizeof( TCB_t ) );
 
                 if( pxNewTCB != NULL )
                 {
@@ -1843,6 +2447,39 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
     }
 /*-----------------------------------------------------------*/
 
+    #if ( configUSE_MLFQ_SCHEDULER == 1 )
+        BaseType_t xTaskCreateMLFQ( TaskFunction_t pxTaskCode,
+                                    const char * const pcName,
+                                    const configSTACK_DEPTH_TYPE uxStackDepth,
+                                    void * const pvParameters,
+                                    TaskHandle_t * const pxCreatedTask )
+        {
+            TCB_t * pxNewTCB;
+            BaseType_t xReturn;
+
+            traceENTER_xTaskCreateMLFQ( pxTaskCode, pcName, uxStackDepth, pvParameters, pxCreatedTask );
+
+            /* New MLFQ tasks start on the top level. */
+            pxNewTCB = prvCreateTask( pxTaskCode, pcName, uxStackDepth, pvParameters, uxMLFQHighestPriority, pxCreatedTask );
+
+            if( pxNewTCB != NULL )
+            {
+                pxNewTCB->xIsMLFQTask = pdTRUE;
+                prvAddNewTaskToReadyList( pxNewTCB );
+                xReturn = pdPASS;
+            }
+            else
+            {
+                xReturn = errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY;
+            }
+
+            traceRETURN_xTaskCreateMLFQ( xReturn );
+
+            return xReturn;
+        }
+    #endif /* configUSE_MLFQ_SCHEDULER */
+/*-----------------------------------------------------------*/
+
     #if ( ( configNUMBER_OF_CORES > 1 ) && ( configUSE_CORE_AFFINITY == 1 ) )
         BaseType_t xTaskCreateAffinitySet( TaskFunction_t pxTaskCode,
                                            const char * const pcName,
@@ -1991,18 +2628,7 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
         mtCOVERAGE_TEST_MARKER();
     }
 
-    #if ( configUSE_MLFQ_SCHEDULER == 1 )
-    {
-        // 只有task的name不是系统任务且优先级为0时，才将其优先级设置为configMAX_PRIORITIES
-        if( ( pcName != NULL ) && ( strcmp( pcName, "IDLE" ) != 0 ) && uxPriority == 0)
-        {
-            DEBUG_PRINT("task name: %s, priority: %d\n", pcName, uxPriority);
-            pxNewTCB->uxPriority = configMAX_PRIORITIES - 1;
-        }
-    }
-    #else   
-        pxNewTCB->uxPriority = uxPriority;
-    #endif
+    pxNewTCB->uxPriority = uxPriority;
     #if ( configUSE_MUTEXES == 1 )
     {
         pxNewTCB->uxBasePriority = uxPriority;
@@ -2105,37 +2731,90 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
 
     #if (configUSE_EDF_SCHEDULER == 1)
     {
-        // pvParameters = (pvParameter_t *)pvParameters;
-        pxNewTCB->uxDeadLine = ((pvParameter_t *)pvParameters)->uxDeadLine;
+        /* Kernel tasks, such as the idle and timer tasks, are created without
+         * parameters and therefore without a deadline.  The parameters of
+         * tasks outside the EDF band are not a pvParameter_t. */
+        if( ( pvParameters != NULL ) && ( taskEDF_OWNS( uxPriority ) != pdFALSE ) )
+        {
+            pxNewTCB->uxDeadLine = ((pvParameter_t *)pvParameters)->uxDeadLine;
+
+            /* Deadlines are compared by their difference, so a relative
+             * deadline must be less than half the range of TickType_t. */
+            configASSERT( pxNewTCB->uxDeadLine <= ( portMAX_DELAY >> 1 ) );
+        }
+        else
+        {
+            pxNewTCB->uxDeadLine = ( TickType_t ) 0U;
+        }
     }
     #endif
 
     #if (configUSE_WEIGHTED_ROUND_ROBIN == 1)
     {
-        // pvParameters = (pvParameter_t *)pvParameters;
-        pxNewTCB->uxWeight = ((pvParameter_t *)pvParameters)->uxWeight;
-        pxNewTCB->uxRemainingTicks = pxNewTCB->uxWeight * configSLICE_INTERVAL;
+        /* The weight can be changed by vTaskSetWeight().  The virtual run time
+         * is moved up to the virtual time of the task's priority when the task
+         * is added to the ready list. */
+        pxNewTCB->uxWeight = ( UBaseType_t ) 1U;
+        pxNewTCB->xWRRStride = taskWRR_STRIDE_SCALE;
+        pxNewTCB->xWRRVirtualRuntime = ( TickType_t ) 0U;
+        pxNewTCB->uxRemainingTicks = configSLICE_INTERVAL;
     }
     #endif
 
     #if (configUSE_MLFQ_SCHEDULER == 1)
     {
-        pxNewTCB->uxRemainingTicks = 1 * configMLFQ_UNIT_TIME_SLICE;
-    }
-    #endif
+        /* Tasks are only managed by the MLFQ scheduler if they are created by
+         * xTaskCreateMLFQ() or xTaskCreateMLFQStatic(), which set xIsMLFQTask
+         * after the task is initialised. */
+        pxNewTCB->xIsMLFQTask = pdFALSE;
+        vListInitialiseItem( &( pxNewTCB->xMLFQListItem ) );
+        listSET_LIST_ITEM_OWNER( &( pxNewTCB->xMLFQListItem ), pxNewTCB );
 
-    if( pxCreatedTask != NULL )
-    {
-        /* Pass the handle out in an anonymous way.  The handle can be used to
-         * change the created task's priority, delete the created task, etc.*/
-        *pxCreatedTask = ( TaskHandle_t ) pxNewTCB;
-    }
-    else
-    {
-        mtCOVERAGE_TEST_MARKER();
-    }
-}
-/*-----------------------------------------------------------*/
+        if( xMLFQPolicyApplied == pdFALSE )
+        {
+            prvMLFQApplyPolicy( configMLFQ_HIGHEST_PRIORITY,
+                                ( configMLFQ_HIGHEST_PRIORITY - configMLFQ_LOWEST_PRIORITY ) + 1,
+                                NULL,
+                                configMLFQ_LOOP_TIME_SLICE );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        /* The time slice of a task in the weighted round robin band was set
+         * above. */
+        if( taskWRR_OWNS( uxPriority ) == pdFALSE )
+        {
+            pxNewTCB->uxRemainingTicks = taskMLFQ_LEVEL_TICKS( uxPriority );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        pxNewTCB->uxBoostGeneration = uxMLFQBoostGeneration;
+
+        #if ( configMLFQ_USE_RUN_TIME_ACCOUNTING == 1 )
+        {
+            pxNewTCB->ulMLFQRunTimeUsed = 0U;
+        }
+        #endif
+    }
+    #endif
+
+    if( pxCreatedTask != NULL )
+    {
+        /* Pass the handle out in an anonymous way.  The handle can be used to
+         * change the created task's priority, delete the created task, etc.*/
+        *pxCreatedTask = ( TaskHandle_t ) pxNewTCB;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+}
+/*-----------------------------------------------------------*/
 
 #if ( configNUMBER_OF_CORES == 1 )
 
@@ -2330,6 +3009,8 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
             pxTCB = prvGetTCBFromHandle( xTaskToDelete );
 
             /* Remove task from the ready/delayed list. */
+            taskMLFQ_DEQUEUE( pxTCB );
+
             if( uxListRemove( &( pxTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
             {
                 taskRESET_READY_PRIORITY( pxTCB->uxPriority );
@@ -2535,7 +3216,6 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
             {
                 mtCOVERAGE_TEST_MARKER();
             }
-            pxCurrentTCB->xIsMissDDL = pdFALSE;
         }
         xAlreadyYielded = xTaskResumeAll();
 
@@ -2583,7 +3263,6 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
                  * This task cannot be in an event list as it is the currently
                  * executing task. */
                 prvAddCurrentTaskToDelayedList( xTicksToDelay, pdFALSE );
-                pxCurrentTCB->xIsMissDDL = pdFALSE;
             }
             xAlreadyYielded = xTaskResumeAll();
         }
@@ -2616,8 +3295,11 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
         eTaskState eReturn;
         List_t const * pxStateList;
         List_t const * pxEventList;
-        List_t const * pxDelayedList;
-        List_t const * pxOverflowedDelayedList;
+
+        #if ( configUSE_TIMER_WHEEL_DELAY == 0 )
+            List_t const * pxDelayedList;
+            List_t const * pxOverflowedDelayedList;
+        #endif
         const TCB_t * const pxTCB = xTask;
 
         traceENTER_eTaskGetState( xTask );
@@ -2637,8 +3319,13 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
             {
                 pxStateList = listLIST_ITEM_CONTAINER( &( pxTCB->xStateListItem ) );
                 pxEventList = listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) );
-                pxDelayedList = pxDelayedTaskList;
-                pxOverflowedDelayedList = pxOverflowDelayedTaskList;
+
+                #if ( configUSE_TIMER_WHEEL_DELAY == 0 )
+                {
+                    pxDelayedList = pxDelayedTaskList;
+                    pxOverflowedDelayedList = pxOverflowDelayedTaskList;
+                }
+                #endif
             }
             taskEXIT_CRITICAL();
 
@@ -2649,7 +3336,12 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
                  * item is currently placed on. */
                 eReturn = eReady;
             }
-            else if( ( pxStateList == pxDelayedList ) || ( pxStateList == pxOverflowedDelayedList ) )
+
+            #if ( configUSE_TIMER_WHEEL_DELAY == 0 )
+                else if( ( pxStateList == pxDelayedList ) || ( pxStateList == pxOverflowedDelayedList ) )
+            #else
+                else if( taskLIST_IS_DELAY_WHEEL_SLOT( pxStateList ) )
+            #endif
             {
                 /* The task being queried is referenced from one of the Blocked
                  * lists. */
@@ -3018,6 +3710,14 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
                 }
                 #endif /* if ( configUSE_MUTEXES == 1 ) */
 
+                #if ( configUSE_MLFQ_SCHEDULER == 1 )
+                {
+                    /* A level set by the application is not overridden by a
+                     * boost that happened before it was set. */
+                    pxTCB->uxBoostGeneration = uxMLFQBoostGeneration;
+                }
+                #endif
+
                 /* Only reset the event list item value if the value is not
                  * being used for anything else. */
                 if( ( listGET_LIST_ITEM_VALUE( &( pxTCB->xEventListItem ) ) & taskEVENT_LIST_ITEM_VALUE_IN_USE ) == ( ( TickType_t ) 0U ) )
@@ -3252,6 +3952,8 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
 
             traceTASK_SUSPEND( pxTCB );
 
+            taskCLASS_DEQUEUE( pxTCB, xTickCount );
+
             /* Remove task from the ready/delayed list and place in the
              * suspended list. */
             if( uxListRemove( &( pxTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
@@ -4043,7 +4745,7 @@ void vTaskSuspendAll( void )
          * configUSE_PREEMPTION is 0, so there may be tasks above the idle priority
          * task that are in the Ready state, even though the idle task is
          * running. */
-        #if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 )
+        #if ( taskUSE_READY_PRIORITY_BITMAP == 0 )
         {
             if( uxTopReadyPriority > tskIDLE_PRIORITY )
             {
@@ -4064,7 +4766,7 @@ void vTaskSuspendAll( void )
                 xHigherPriorityReadyTasks = pdTRUE;
             }
         }
-        #endif /* if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 ) */
+        #endif /* if ( taskUSE_READY_PRIORITY_BITMAP == 0 ) */
 
         if( pxCurrentTCB->uxPriority > tskIDLE_PRIORITY )
         {
@@ -4408,6 +5110,11 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery )
         UBaseType_t uxQueue = configMAX_PRIORITIES;
         TCB_t * pxTCB;
 
+        #if ( configUSE_TIMER_WHEEL_DELAY == 1 )
+            UBaseType_t uxLevel;
+            UBaseType_t uxSlot;
+        #endif
+
         traceENTER_xTaskGetHandle( pcNameToQuery );
 
         /* Task names will be truncated to configMAX_TASK_NAME_LEN - 1 bytes. */
@@ -4429,15 +5136,29 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery )
             } while( uxQueue > ( UBaseType_t ) tskIDLE_PRIORITY );
 
             /* Search the delayed lists. */
-            if( pxTCB == NULL )
+            #if ( configUSE_TIMER_WHEEL_DELAY == 0 )
             {
-                pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) pxDelayedTaskList, pcNameToQuery );
-            }
+                if( pxTCB == NULL )
+                {
+                    pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) pxDelayedTaskList, pcNameToQuery );
+                }
 
-            if( pxTCB == NULL )
+                if( pxTCB == NULL )
+                {
+                    pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) pxOverflowDelayedTaskList, pcNameToQuery );
+                }
+            }
+            #else /* configUSE_TIMER_WHEEL_DELAY */
             {
-                pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) pxOverflowDelayedTaskList, pcNameToQuery );
+                for( uxLevel = 0U; ( uxLevel < ( UBaseType_t ) configTIMER_WHEEL_DELAY_LEVELS ) && ( pxTCB == NULL ); uxLevel++ )
+                {
+                    for( uxSlot = 0U; ( uxSlot < taskWHEEL_SLOTS ) && ( pxTCB == NULL ); uxSlot++ )
+                    {
+                        pxTCB = prvSearchForNameWithinSingleList( &( xDelayWheel[ uxLevel ][ uxSlot ] ), pcNameToQuery );
+                    }
+                }
             }
+            #endif /* configUSE_TIMER_WHEEL_DELAY */
 
             #if ( INCLUDE_vTaskSuspend == 1 )
             {
@@ -4531,6 +5252,11 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery )
     {
         UBaseType_t uxTask = 0, uxQueue = configMAX_PRIORITIES;
 
+        #if ( configUSE_TIMER_WHEEL_DELAY == 1 )
+            UBaseType_t uxLevel;
+            UBaseType_t uxSlot;
+        #endif
+
         traceENTER_uxTaskGetSystemState( pxTaskStatusArray, uxArraySize, pulTotalRunTime );
 
         vTaskSuspendAll();
@@ -4548,8 +5274,22 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery )
 
                 /* Fill in an TaskStatus_t structure with information on each
                  * task in the Blocked state. */
-                uxTask = ( UBaseType_t ) ( uxTask + prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxDelayedTaskList, eBlocked ) );
-                uxTask = ( UBaseType_t ) ( uxTask + prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxOverflowDelayedTaskList, eBlocked ) );
+                #if ( configUSE_TIMER_WHEEL_DELAY == 0 )
+                {
+                    uxTask = ( UBaseType_t ) ( uxTask + prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxDelayedTaskList, eBlocked ) );
+                    uxTask = ( UBaseType_t ) ( uxTask + prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxOverflowDelayedTaskList, eBlocked ) );
+                }
+                #else
+                {
+                    for( uxLevel = 0U; uxLevel < ( UBaseType_t ) configTIMER_WHEEL_DELAY_LEVELS; uxLevel++ )
+                    {
+                        for( uxSlot = 0U; uxSlot < taskWHEEL_SLOTS; uxSlot++ )
+                        {
+                            uxTask = ( UBaseType_t ) ( uxTask + prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), &( xDelayWheel[ uxLevel ][ uxSlot ] ), eBlocked ) );
+                        }
+                    }
+                }
+                #endif /* configUSE_TIMER_WHEEL_DELAY */
 
                 #if ( INCLUDE_vTaskDelete == 1 )
                 {
@@ -4814,277 +5554,517 @@ BaseType_t xTaskCatchUpTicks( TickType_t xTicksToCatchUp )
 
 #if ( configUSE_MLFQ_SCHEDULER == 1 )
 
-    void static moveTaskToLowerQueue( TCB_t *pxTCB )
+    static void prvMLFQSetLevel( TCB_t * const pxTCB,
+                                 UBaseType_t uxNewLevel )
     {
-        UBaseType_t uxCurrentPriority = pxTCB->uxPriority;
-
-        if( uxCurrentPriority > 1U )
+        /* The base priority is changed too, unless the task has inherited its
+         * priority, so that disinheriting a mutex does not undo the change. */
+        #if ( configUSE_MUTEXES == 1 )
         {
-            UBaseType_t uxNewPriority = uxCurrentPriority - 1;
-            /* Remove the task from the current ready list. */
-            if( listLIST_ITEM_CONTAINER( &( pxTCB->xStateListItem ) ) != NULL )
+            if( pxTCB->uxBasePriority == pxTCB->uxPriority )
             {
-                DEBUG_PRINT("Task %s is removed from the current ready list\n", pxTCB->pcTaskName);
-                listREMOVE_ITEM( &( pxTCB->xStateListItem ) );
+                pxTCB->uxBasePriority = uxNewLevel;
             }
-
-            /* If current list is empty, update uxTopReadyPriority. */
-            if( listLIST_IS_EMPTY( &( pxReadyTasksLists[ uxCurrentPriority ] ) ) == pdTRUE )
+            else
             {
-                DEBUG_PRINT("Current priority queue is empty, set uxTopReadyPriority to %d\n", uxNewPriority);
-                uxTopReadyPriority = uxNewPriority;
+                mtCOVERAGE_TEST_MARKER();
             }
+        }
+        #endif
 
-            /* Place the task in the new ready list. */
-            DEBUG_PRINT("Task %s is added to the new ready list\n", pxTCB->pcTaskName);
-            pxTCB->uxPriority = uxNewPriority;
-            pxTCB->uxRemainingTicks = ( configMAX_PRIORITIES - uxNewPriority) * configMLFQ_UNIT_TIME_SLICE;
-            prvAddTaskToReadyList( pxTCB );
+        pxTCB->uxPriority = uxNewLevel;
 
+        /* Only reset the event list item value if the value is not being used
+         * for anything else. */
+        if( ( listGET_LIST_ITEM_VALUE( &( pxTCB->xEventListItem ) ) & taskEVENT_LIST_ITEM_VALUE_IN_USE ) == ( ( TickType_t ) 0U ) )
+        {
+            listSET_LIST_ITEM_VALUE( &( pxTCB->xEventListItem ), ( ( TickType_t ) configMAX_PRIORITIES - ( TickType_t ) uxNewLevel ) );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
         }
-        else {
-            // Task is already in the lowest priority queue
-            pxTCB->uxRemainingTicks = ( configMAX_PRIORITIES - 1) * configMLFQ_UNIT_TIME_SLICE;
+
+        /* The task starts a new time slice on its new level. */
+        pxTCB->uxRemainingTicks = taskMLFQ_LEVEL_TICKS( uxNewLevel );
+
+        #if ( configMLFQ_USE_RUN_TIME_ACCOUNTING == 1 )
+        {
+            pxTCB->ulMLFQRunTimeUsed = 0U;
         }
+        #endif
     }
+    /*-----------------------------------------------------------*/
 
-    void static ResetAllQueues()  // move all tasks to highest prio queues
+    static void moveTaskToLowerQueue( TCB_t *pxTCB )
     {
-        configASSERT(configMAX_PRIORITIES >= 3);
-        for( UBaseType_t i = 1; i < configMAX_PRIORITIES; i++ )
+        UBaseType_t uxCurrentPriority = pxTCB->uxPriority;
+        UBaseType_t uxCurrentLevel = uxCurrentPriority;
+        BaseType_t xIsReady;
+
+        /* A task that has inherited a priority from a mutex is on the level of
+         * its base priority. */
+        #if ( configUSE_MUTEXES == 1 )
         {
-            List_t *pxList = &( pxReadyTasksLists[ i ] );
-            while( listLIST_IS_EMPTY( pxList ) != pdTRUE )
-            {
-                TCB_t *pxTCB = listGET_OWNER_OF_HEAD_ENTRY( pxList );
-                listREMOVE_ITEM( &( pxTCB->xStateListItem ) );
-                portMEMORY_BARRIER();
-                pxTCB->uxPriority = configMAX_PRIORITIES - 1;
-                pxTCB->uxRemainingTicks =  1 * configMLFQ_UNIT_TIME_SLICE;
-                prvAddTaskToReadyList( pxTCB );
-            }
+            uxCurrentLevel = pxTCB->uxBasePriority;
         }
-    }
-#endif
+        #endif
 
-BaseType_t xJudgePriorityChange( TCB_t *pxTCB )
-{
-    BaseType_t xReturn = pdFALSE;
+        /* The task has now used a time slice since the last boost, so it is no
+         * longer owed that boost when it is next added to a ready list. */
+        pxTCB->uxBoostGeneration = uxMLFQBoostGeneration;
 
-    #if ( configUSE_EDF_SCHEDULER == 1 )
-    {
-        if( pxTCB->uxAbsDeadline < pxCurrentTCB->uxAbsDeadline )
+        if( ( xMLFQBoostPending != pdFALSE ) || ( uxCurrentLevel <= uxMLFQLowestPriority ) )
         {
-            xReturn = pdTRUE;
+            /* Demoting a task while a boost is still moving tasks up could
+             * place it behind tasks that are about to be boosted, so the task
+             * keeps its level until the boost completes.  A task on the lowest
+             * level has nowhere lower to go. */
+            prvMLFQSetLevel( pxTCB, uxCurrentPriority );
+        }
+        else if( uxCurrentLevel != uxCurrentPriority )
+        {
+            /* The task holds a mutex and has inherited a priority, which it
+             * must keep, so only its base priority is lowered.  The task stays
+             * where it is in the ready lists, and moves to the new level when
+             * xTaskPriorityDisinherit() restores its base priority.  Until then
+             * it starts a new time slice at its inherited priority. */
+            pxTCB->uxBasePriority = uxCurrentLevel - 1U;
+            prvMLFQSetLevel( pxTCB, uxCurrentPriority );
         }
         else
         {
-            mtCOVERAGE_TEST_MARKER();
+            UBaseType_t uxNewPriority = uxCurrentPriority - 1;
+
+            /* The task is only in a ready list if it is being demoted while
+             * it is ready.  When the time slice is charged as the task blocks
+             * only its level is changed, and it is added to the ready list of
+             * the new level when it is unblocked. */
+            xIsReady = listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ uxCurrentPriority ] ), &( pxTCB->xStateListItem ) );
+
+            /* Remove the task from the current ready list, clearing the level
+             * from the ready bitmap if that leaves the list empty.  Any other
+             * level that is still populated keeps its bit. */
+            if( xIsReady != pdFALSE )
+            {
+                if( uxListRemove( &( pxTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
+                {
+                    portRESET_READY_PRIORITY( uxCurrentPriority, uxTopReadyPriority );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            DEBUG_PRINT("Task %s is moved to MLFQ level %d\n", pxTCB->pcTaskName, ( int ) uxNewPriority);
+
+            prvMLFQSetLevel( pxTCB, uxNewPriority );
+
+            if( xIsReady != pdFALSE )
+            {
+                prvAddTaskToReadyList( pxTCB );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
         }
     }
-    #else
+    /*-----------------------------------------------------------*/
+
+    static void prvMLFQBoostTask( TCB_t * const pxTCB )
     {
-        if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+        /* Only tasks created by xTaskCreateMLFQ() are moved between levels. */
+        if( pxTCB->xIsMLFQTask != pdFALSE )
         {
-            xReturn = pdTRUE;
+            prvMLFQSetLevel( pxTCB, uxMLFQHighestPriority );
         }
         else
         {
             mtCOVERAGE_TEST_MARKER();
         }
+
+        pxTCB->uxBoostGeneration = uxMLFQBoostGeneration;
     }
-    #endif
-    if( xReturn == pdTRUE )
+    /*-----------------------------------------------------------*/
+
+    static BaseType_t prvMLFQBoostStep( void )
     {
-        printf("PREEEMPTION happends! From %s to %s\n", pxCurrentTCB->pcTaskName, ( pxTCB )->pcTaskName); 
-    }
+        BaseType_t xMoreToBoost = pdFALSE;
+        UBaseType_t uxLevel;
+        List_t * pxList;
+        TCB_t * pxTCB;
 
-    return xReturn;
-}
+        /* Move at most one task from each level below the top level, so the
+         * time spent in the tick interrupt depends on the number of levels and
+         * not on the number of ready tasks.  Tasks already at the top level stay
+         * where they are, otherwise they would be moved back onto the list
+         * being emptied. */
+        for( uxLevel = uxMLFQLowestPriority; uxLevel < uxMLFQHighestPriority; uxLevel++ )
+        {
+            pxList = &( xMLFQReadyLists[ uxLevel ] );
 
+            if( listLIST_IS_EMPTY( pxList ) == pdFALSE )
+            {
+                pxTCB = listGET_OWNER_OF_HEAD_ENTRY( pxList );
 
-BaseType_t xTaskIncrementTick( void )
-{
-    TCB_t * pxTCB;
-    TickType_t xItemValue;
-    BaseType_t xSwitchRequired = pdFALSE;
+                /* A task leaves the MLFQ list of its priority whenever it
+                 * leaves the ready list of that priority. */
+                configASSERT( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ uxLevel ] ), &( pxTCB->xStateListItem ) ) != pdFALSE );
 
-    traceENTER_xTaskIncrementTick();
+                if( uxListRemove( &( pxTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
+                {
+                    portRESET_READY_PRIORITY( uxLevel, uxTopReadyPriority );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
 
-    /* Called by the portable layer each time a tick interrupt occurs.
-     * Increments the tick then checks to see if the new tick value will cause any
-     * tasks to be unblocked. */
-    traceTASK_INCREMENT_TICK( xTickCount );
+                /* Adding the task to the ready list of the top level also moves
+                 * it to the MLFQ list of the top level. */
+                prvMLFQBoostTask( pxTCB );
+                prvAddTaskToReadyList( pxTCB );
 
-    /* Tick increment should occur on every kernel timer event. Core 0 has the
-     * responsibility to increment the tick, or increment the pended ticks if the
-     * scheduler is suspended.  If pended ticks is greater than zero, the core that
-     * calls xTaskResumeAll has the responsibility to increment the tick. */
-    if( uxSchedulerSuspended == ( UBaseType_t ) 0U )
+                if( listLIST_IS_EMPTY( pxList ) == pdFALSE )
+                {
+                    xMoreToBoost = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+
+        return xMoreToBoost;
+    }
+    /*-----------------------------------------------------------*/
+
+    static void prvMLFQApplyPolicy( UBaseType_t uxHighestPriority,
+                                    UBaseType_t uxNumberOfLevels,
+                                    const TickType_t * pxLevelTimeSlices,
+                                    TickType_t xBoostPeriod )
     {
-        /* Minor optimisation.  The tick count cannot change in this
-         * block. */
-        const TickType_t xConstTickCount = xTickCount + ( TickType_t ) 1;
+        UBaseType_t uxPriority;
+        UBaseType_t uxLevel;
 
-        /* Increment the RTOS tick, switching the delayed and overflowed
-         * delayed lists if it wraps to 0. */
-        xTickCount = xConstTickCount;
+        uxMLFQHighestPriority = uxHighestPriority;
+        uxMLFQLowestPriority = ( uxHighestPriority - uxNumberOfLevels ) + 1U;
+        xMLFQBoostPeriod = xBoostPeriod;
 
-        if( xConstTickCount == ( TickType_t ) 0U )
+        for( uxPriority = ( UBaseType_t ) 0U; uxPriority < ( UBaseType_t ) configMAX_PRIORITIES; uxPriority++ )
         {
-            taskSWITCH_DELAYED_LISTS();
-        }
-        else
-        {
-            mtCOVERAGE_TEST_MARKER();
-        }
+            /* Priorities outside the band use the time slice of the nearest
+             * level, as a task can be moved there by vTaskPrioritySet(). */
+            if( uxPriority > uxMLFQHighestPriority )
+            {
+                uxLevel = 0U;
+            }
+            else if( uxPriority < uxMLFQLowestPriority )
+            {
+                uxLevel = uxNumberOfLevels - 1U;
+            }
+            else
+            {
+                uxLevel = uxMLFQHighestPriority - uxPriority;
+            }
 
-        #if ( configUSE_MLFQ_SCHEDULER )
-        {
-            uxMLFQCount++;
+            if( pxLevelTimeSlices != NULL )
+            {
+                xMLFQLevelTicks[ uxPriority ] = pxLevelTimeSlices[ uxLevel ];
+            }
+            else
+            {
+                xMLFQLevelTicks[ uxPriority ] = ( ( TickType_t ) uxLevel + 1U ) * configMLFQ_UNIT_TIME_SLICE;
+            }
         }
-        #endif
 
-        // 判断任务的deadline是否到了
+        xMLFQPolicyApplied = pdTRUE;
+    }
+    /*-----------------------------------------------------------*/
+
+    void vTaskSetMLFQPolicy( const MLFQPolicy_t * const pxPolicy )
+    {
+        UBaseType_t uxLevel;
+        UBaseType_t uxPriority;
+        List_t * pxList;
+        TCB_t * pxTCB;
+
+        traceENTER_vTaskSetMLFQPolicy( pxPolicy );
+
+        configASSERT( pxPolicy != NULL );
+        configASSERT( pxPolicy->pxLevelTimeSlices != NULL );
+        configASSERT( pxPolicy->xBoostPeriod > ( TickType_t ) 0U );
+
+        /* The band must fit between the idle priority and configMAX_PRIORITIES. */
+        configASSERT( pxPolicy->uxHighestPriority < ( UBaseType_t ) configMAX_PRIORITIES );
+        configASSERT( pxPolicy->uxNumberOfLevels > ( UBaseType_t ) 0U );
+        configASSERT( pxPolicy->uxNumberOfLevels <= pxPolicy->uxHighestPriority );
+
+        for( uxLevel = ( UBaseType_t ) 0U; uxLevel < pxPolicy->uxNumberOfLevels; uxLevel++ )
         {
-            if ( xTickCount > pxCurrentTCB->uxAbsDeadline && pxCurrentTCB->xIsMissDDL == pdFALSE && pxCurrentTCB->uxDeadLine != 0 )
-            {
-                // 任务deadline到了，需要切换到idle task
-                xSwitchRequired = pdTRUE;
-                pxCurrentTCB->xIsMissDDL = pdTRUE;
-                printf("[Warning] Task %s missed deadline, current time is %d, DDL is %d, \n",  pxCurrentTCB->pcTaskName, xTickCount, pxCurrentTCB->uxAbsDeadline);
-            }
+            configASSERT( pxPolicy->pxLevelTimeSlices[ uxLevel ] > ( TickType_t ) 0U );
+
+            /* The levels must not be owned by another scheduling class. */
+            configASSERT( taskEDF_OWNS( pxPolicy->uxHighestPriority - uxLevel ) == pdFALSE );
+            configASSERT( taskWRR_OWNS( pxPolicy->uxHighestPriority - uxLevel ) == pdFALSE );
         }
 
-        /* See if this tick has made a timeout expire.  Tasks are stored in
-         * the  queue in the order of their wake time - meaning once one task
-         * has been found whose block time has not expired there is no need to
-         * look any further down the list. */
-        if( xConstTickCount >= xNextTaskUnblockTime )
+        taskENTER_CRITICAL();
         {
-            for( ; ; )
+            prvMLFQApplyPolicy( pxPolicy->uxHighestPriority,
+                                pxPolicy->uxNumberOfLevels,
+                                pxPolicy->pxLevelTimeSlices,
+                                pxPolicy->xBoostPeriod );
+
+            /* Nothing is in the ready lists until the first task is created. */
+            if( uxCurrentNumberOfTasks > ( UBaseType_t ) 0U )
             {
-                if( listLIST_IS_EMPTY( pxDelayedTaskList ) != pdFALSE )
-                {
-                    /* The delayed list is empty.  Set xNextTaskUnblockTime
-                     * to the maximum possible value so it is extremely
-                     * unlikely that the
-                     * if( xTickCount >= xNextTaskUnblockTime ) test will pass
-                     * next time through. */
-                    xNextTaskUnblockTime = portMAX_DELAY;
-                    break;
-                }
-                else
-                {
-                    /* The delayed list is not empty, get the value of the
-                     * item at the head of the delayed list.  This is the time
-                     * at which the task at the head of the delayed list must
-                     * be removed from the Blocked state. */
-                    /* MISRA Ref 11.5.3 [Void pointer assignment] */
-                    /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
-                    /* coverity[misra_c_2012_rule_11_5_violation] */
-                    pxTCB = listGET_OWNER_OF_HEAD_ENTRY( pxDelayedTaskList );
-                    xItemValue = listGET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ) );
+                /* Boost every MLFQ task onto the new top level.  Ready tasks
+                 * within the new band are moved by prvMLFQBoostStep() over the
+                 * following ticks, but those outside the band are moved now as
+                 * the boost would not find them. */
+                uxMLFQCount = ( UBaseType_t ) 0U;
+                uxMLFQBoostGeneration++;
+                xMLFQBoostPending = pdTRUE;
 
-                    if( xConstTickCount < xItemValue )
+                for( uxPriority = ( UBaseType_t ) tskIDLE_PRIORITY + 1U; uxPriority < ( UBaseType_t ) configMAX_PRIORITIES; uxPriority++ )
+                {
+                    if( ( uxPriority < uxMLFQLowestPriority ) || ( uxPriority > uxMLFQHighestPriority ) )
                     {
-                        /* It is not time to unblock this item yet, but the
-                         * item value is the time at which the task at the head
-                         * of the blocked list must be removed from the Blocked
-                         * state -  so record the item value in
-                         * xNextTaskUnblockTime. */
-                        xNextTaskUnblockTime = xItemValue;
-                        break;
-                    }
-                    else
-                    {
-                        mtCOVERAGE_TEST_MARKER();
-                    }
-
-                    /* It is time to remove the item from the Blocked state. */
-                    listREMOVE_ITEM( &( pxTCB->xStateListItem ) );
-
-                    /* Is the task waiting on an event also?  If so remove
-                     * it from the event list. */
-                    if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
-                    {
-                        listREMOVE_ITEM( &( pxTCB->xEventListItem ) );
-                    }
-                    else
-                    {
-                        mtCOVERAGE_TEST_MARKER();
-                    }
-
-                    /* Place the unblocked task into the appropriate ready
-                     * list. */
-                    prvAddTaskToReadyList( pxTCB );
+                        pxList = &( xMLFQReadyLists[ uxPriority ] );
 
-                    /* A task being unblocked cannot cause an immediate
-                     * context switch if preemption is turned off. */
-                    #if ( configUSE_PREEMPTION == 1 )
-                    {
-                        #if ( configNUMBER_OF_CORES == 1 )
-                        {
-                            /* Preemption is on, but a context switch should
-                             * only be performed if the unblocked task's
-                             * priority is higher than the currently executing
-                             * task.
-                             * The case of equal priority tasks sharing
-                             * processing time (which happens when both
-                             * preemption and time slicing are on) is
-                             * handled below.*/
-                            xSwitchRequired = xJudgePriorityChange( pxTCB );
-                        }
-                        #else /* #if( configNUMBER_OF_CORES == 1 ) */
+                        /* Each boosted task leaves this list for the MLFQ list
+                         * of the new top level. */
+                        while( listLIST_IS_EMPTY( pxList ) == pdFALSE )
                         {
-                            prvYieldForTask( pxTCB );
-                        }
-                        #endif /* #if( configNUMBER_OF_CORES == 1 ) */
-                    }
-                    #endif /* #if ( configUSE_PREEMPTION == 1 ) */
-                }
-            }
-        }
-
-        /* Tasks of equal priority to the currently running task will share
-         * processing time (time slice) if preemption is on, and the application
-         * writer has not explicitly turned time slicing off. */
-        #if ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) )
-        {
-            #if ( configNUMBER_OF_CORES == 1 )
-            {
-                #if ( configUSE_WEIGHTED_ROUND_ROBIN == 1 || configUSE_MLFQ_SCHEDULER == 1 )
-                {  
-                    if( pxCurrentTCB->uxPriority != tskIDLE_PRIORITY )
-                    {                        
-                            // DEBUG_PRINT("task name: %s, remaining ticks: %d\n", pxCurrentTCB->pcTaskName, pxCurrentTCB->uxRemainingTicks);
-                            pxCurrentTCB->uxRemainingTicks -= 1U;
+                            pxTCB = listGET_OWNER_OF_HEAD_ENTRY( pxList );
 
-                            if( pxCurrentTCB->uxRemainingTicks == ( TickType_t ) 0U )
+                            if( uxListRemove( &( pxTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
                             {
-                                xSwitchRequired = pdTRUE;
-                                #if ( configUSE_MLFQ_SCHEDULER == 1 )
-                                {
-                                    moveTaskToLowerQueue( pxCurrentTCB );
-                                }
-                                #else /* #if ( configUSE_MLFQ_SCHEDULER == 1 ) */
-                                {
-                                    pxCurrentTCB->uxRemainingTicks = pxCurrentTCB->uxWeight * configSLICE_INTERVAL;
-                                }
-                                #endif /* #if ( configUSE_MLFQ_SCHEDULER == 1 ) */
+                                portRESET_READY_PRIORITY( uxPriority, uxTopReadyPriority );
                             }
                             else
                             {
                                 mtCOVERAGE_TEST_MARKER();
                             }
+
+                            prvMLFQBoostTask( pxTCB );
+                            prvAddTaskToReadyList( pxTCB );
+                        }
                     }
                     else
                     {
                         mtCOVERAGE_TEST_MARKER();
                     }
                 }
-                #else
-                if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ pxCurrentTCB->uxPriority ] ) ) > 1U )
+
+                /* The running task may have been moved below a ready task. */
+                if( xSchedulerRunning != pdFALSE )
+                {
+                    taskYIELD_WITHIN_API();
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        traceRETURN_vTaskSetMLFQPolicy();
+    }
+    /*-----------------------------------------------------------*/
+
+    #if ( configMLFQ_USE_RUN_TIME_ACCOUNTING == 1 )
+
+        static BaseType_t prvMLFQChargeRunTime( TCB_t * const pxTCB,
+                                                const configRUN_TIME_COUNTER_TYPE ulNow )
+        {
+            /* Charge the time since the running task was last charged.  As
+             * with the run time statistics, the guard protects against run
+             * time counters that go backwards. */
+            if( ulNow > ulMLFQChargedUpTo )
+            {
+                pxTCB->ulMLFQRunTimeUsed += ( ulNow - ulMLFQChargedUpTo );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            ulMLFQChargedUpTo = ulNow;
+
+            return ( pxTCB->ulMLFQRunTimeUsed >= ( ( configRUN_TIME_COUNTER_TYPE ) taskMLFQ_LEVEL_TICKS( pxTCB->uxPriority ) * ( configRUN_TIME_COUNTER_TYPE ) configMLFQ_RUN_TIME_COUNTS_PER_TICK ) ) ? pdTRUE : pdFALSE;
+        }
+
+    #endif /* configMLFQ_USE_RUN_TIME_ACCOUNTING */
+    /*-----------------------------------------------------------*/
+
+    static BaseType_t prvMLFQTimeSliceUsed( TCB_t * const pxTCB )
+    {
+        BaseType_t xReturn;
+
+        #if ( configMLFQ_USE_RUN_TIME_ACCOUNTING == 1 )
+        {
+            configRUN_TIME_COUNTER_TYPE ulNow;
+
+            #ifdef portALT_GET_RUN_TIME_COUNTER_VALUE
+                portALT_GET_RUN_TIME_COUNTER_VALUE( ulNow );
+            #else
+                ulNow = portGET_RUN_TIME_COUNTER_VALUE();
+            #endif
+
+            xReturn = prvMLFQChargeRunTime( pxTCB, ulNow );
+        }
+        #else
+        {
+            /* Without the run time counter the task is charged a whole tick
+             * for each tick interrupt that occurs while it is running. */
+            pxTCB->uxRemainingTicks -= 1U;
+
+            xReturn = ( pxTCB->uxRemainingTicks == 0U ) ? pdTRUE : pdFALSE;
+        }
+        #endif
+
+        return xReturn;
+    }
+
+#endif /* configUSE_MLFQ_SCHEDULER */
+
+BaseType_t xJudgePriorityChange( TCB_t *pxTCB )
+{
+    BaseType_t xReturn = pdFALSE;
+
+    if( taskCLASS_PREEMPTS( pxTCB ) != pdFALSE )
+    {
+        xReturn = pdTRUE;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    if( xReturn == pdTRUE )
+    {
+        DEBUG_PRINT("PREEEMPTION happends! From %s to %s\n", pxCurrentTCB->pcTaskName, ( pxTCB )->pcTaskName);
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvUnblockTimedOutTask( TCB_t * const pxTCB )
+{
+    BaseType_t xSwitchRequired = pdFALSE;
+
+    listREMOVE_ITEM( &( pxTCB->xStateListItem ) );
+
+    /* Is the task waiting on an event also?  If so remove it from the event
+     * list. */
+    if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
+    {
+        listREMOVE_ITEM( &( pxTCB->xEventListItem ) );
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    /* Place the unblocked task into the appropriate ready list. */
+    prvAddTaskToReadyList( pxTCB );
+
+    /* A task being unblocked cannot cause an immediate context switch if
+     * preemption is turned off. */
+    #if ( configUSE_PREEMPTION == 1 )
+    {
+        #if ( configNUMBER_OF_CORES == 1 )
+        {
+            /* Preemption is on, but a context switch should only be performed
+             * if the unblocked task's priority is higher than the currently
+             * executing task.  The case of equal priority tasks sharing
+             * processing time (which happens when both preemption and time
+             * slicing are on) is handled by xTaskIncrementTick(). */
+            xSwitchRequired = xJudgePriorityChange( pxTCB );
+        }
+        #else /* #if( configNUMBER_OF_CORES == 1 ) */
+        {
+            prvYieldForTask( pxTCB );
+        }
+        #endif /* #if( configNUMBER_OF_CORES == 1 ) */
+    }
+    #endif /* #if ( configUSE_PREEMPTION == 1 ) */
+
+    return xSwitchRequired;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskIncrementTick( void )
+{
+    #if ( configUSE_TIMER_WHEEL_DELAY == 0 )
+        TCB_t * pxTCB;
+        TickType_t xItemValue;
+    #endif
+    BaseType_t xSwitchRequired = pdFALSE;
+
+    traceENTER_xTaskIncrementTick();
+
+    /* Called by the portable layer each time a tick interrupt occurs.
+     * Increments the tick then checks to see if the new tick value will cause any
+     * tasks to be unblocked. */
+    traceTASK_INCREMENT_TICK( xTickCount );
+
+    /* Tick increment should occur on every kernel timer event. Core 0 has the
+     * responsibility to increment the tick, or increment the pended ticks if the
+     * scheduler is suspended.  If pended ticks is greater than zero, the core that
+     * calls xTaskResumeAll has the responsibility to increment the tick. */
+    if( uxSchedulerSuspended == ( UBaseType_t ) 0U )
+    {
+        /* Minor optimisation.  The tick count cannot change in this
+         * block. */
+        const TickType_t xConstTickCount = xTickCount + ( TickType_t ) 1;
+
+        /* Increment the RTOS tick, switching the delayed and overflowed
+         * delayed lists if it wraps to 0. */
+        xTickCount = xConstTickCount;
+
+        if( xConstTickCount == ( TickType_t ) 0U )
+        {
+            taskSWITCH_DELAYED_LISTS();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        #if ( configUSE_MLFQ_SCHEDULER )
+        {
+            uxMLFQCount++;
+        }
+        #endif
+
+        #if ( configUSE_TIMER_WHEEL_DELAY == 1 )
+        {
+            /* See if this tick has made a timeout expire.  The wheel only
+             * needs servicing on the ticks at which one of its occupied slots
+             * comes round. */
+            if( xConstTickCount >= xNextTaskUnblockTime )
+            {
+                if( prvDelayWheelServiceTick( xConstTickCount ) != pdFALSE )
                 {
                     xSwitchRequired = pdTRUE;
                 }
@@ -5092,17 +6072,66 @@ BaseType_t xTaskIncrementTick( void )
                 {
                     mtCOVERAGE_TEST_MARKER();
                 }
-                #endif
             }
-            #else /* #if ( configNUMBER_OF_CORES == 1 ) */
+            else
             {
-                BaseType_t xCoreID;
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        #else /* configUSE_TIMER_WHEEL_DELAY */
 
-                for( xCoreID = 0; xCoreID < ( ( BaseType_t ) configNUMBER_OF_CORES ); xCoreID++ )
+        /* See if this tick has made a timeout expire.  Tasks are stored in
+         * the  queue in the order of their wake time - meaning once one task
+         * has been found whose block time has not expired there is no need to
+         * look any further down the list. */
+        if( xConstTickCount >= xNextTaskUnblockTime )
+        {
+            for( ; ; )
+            {
+                if( listLIST_IS_EMPTY( pxDelayedTaskList ) != pdFALSE )
+                {
+                    /* The delayed list is empty.  Set xNextTaskUnblockTime
+                     * to the maximum possible value so it is extremely
+                     * unlikely that the
+                     * if( xTickCount >= xNextTaskUnblockTime ) test will pass
+                     * next time through. */
+                    xNextTaskUnblockTime = portMAX_DELAY;
+                    break;
+                }
+                else
                 {
-                    if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ pxCurrentTCBs[ xCoreID ]->uxPriority ] ) ) > 1U )
+                    /* The delayed list is not empty, get the value of the
+                     * item at the head of the delayed list.  This is the time
+                     * at which the task at the head of the delayed list must
+                     * be removed from the Blocked state. */
+                    /* MISRA Ref 11.5.3 [Void pointer assignment] */
+                    /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+                    /* coverity[misra_c_2012_rule_11_5_violation] */
+                    pxTCB = listGET_OWNER_OF_HEAD_ENTRY( pxDelayedTaskList );
+                    xItemValue = listGET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ) );
+
+                    if( xConstTickCount < xItemValue )
+                    {
+                        /* It is not time to unblock this item yet, but the
+                         * item value is the time at which the task at the head
+                         * of the blocked list must be removed from the Blocked
+                         * state -  so record the item value in
+                         * xNextTaskUnblockTime. */
+                        xNextTaskUnblockTime = xItemValue;
+                        break;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    /* It is time to remove the item from the Blocked state.
+                     * More than one task can be unblocked by the same tick, so
+                     * a later task must not clear a switch requested by an
+                     * earlier one. */
+                    if( prvUnblockTimedOutTask( pxTCB ) != pdFALSE )
                     {
-                        xYieldPendings[ xCoreID ] = pdTRUE;
+                        xSwitchRequired = pdTRUE;
                     }
                     else
                     {
@@ -5110,9 +6139,34 @@ BaseType_t xTaskIncrementTick( void )
                     }
                 }
             }
-            #endif /* #if ( configNUMBER_OF_CORES == 1 ) */
         }
-        #endif /* #if ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) ) */
+        #endif /* configUSE_TIMER_WHEEL_DELAY */
+
+        /* Charge the running task for the tick.  Its scheduling class decides
+         * whether it must now give way, for example to share the processor
+         * with tasks of equal priority. */
+        #if ( configNUMBER_OF_CORES == 1 )
+        {
+            taskCLASS_TICK( pxCurrentTCB, xConstTickCount, xSwitchRequired );
+        }
+        #elif ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) )
+        {
+            /* Only the fixed priority class supports more than one core. */
+            BaseType_t xCoreID;
+
+            for( xCoreID = 0; xCoreID < ( ( BaseType_t ) configNUMBER_OF_CORES ); xCoreID++ )
+            {
+                if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ pxCurrentTCBs[ xCoreID ]->uxPriority ] ) ) > 1U )
+                {
+                    xYieldPendings[ xCoreID ] = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+        }
+        #endif /* #if ( configNUMBER_OF_CORES == 1 ) */
 
         #if ( configUSE_TICK_HOOK == 1 )
         {
@@ -5178,11 +6232,37 @@ BaseType_t xTaskIncrementTick( void )
 
         #if ( configUSE_MLFQ_SCHEDULER == 1 )
         {
-            if( uxMLFQCount >= configMLFQ_LOOP_TIME_SLICE )
+            if( uxMLFQCount >= xMLFQBoostPeriod )
             {
                 DEBUG_PRINT("MLFQ one loop finished\n");
                 uxMLFQCount = 0;
-                ResetAllQueues();
+
+                /* Start a boost.  Tasks that are not ready pick it up when they
+                 * are next added to a ready list, and the ready tasks are moved
+                 * up by prvMLFQBoostStep() over this and the following ticks. */
+                uxMLFQBoostGeneration++;
+                xMLFQBoostPending = pdTRUE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            if( xMLFQBoostPending != pdFALSE )
+            {
+                xMLFQBoostPending = prvMLFQBoostStep();
+
+                #if ( configUSE_PREEMPTION == 1 )
+                {
+                    /* A boosted task may now be on a higher level than the
+                     * running task. */
+                    xSwitchRequired = pdTRUE;
+                }
+                #endif
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
             }
         }
         #endif
@@ -5381,6 +6461,33 @@ BaseType_t xTaskIncrementTick( void )
             }
             #endif /* configGENERATE_RUN_TIME_STATS */
 
+            #if ( ( configUSE_MLFQ_SCHEDULER == 1 ) && ( configMLFQ_USE_RUN_TIME_ACCOUNTING == 1 ) )
+            {
+                /* Charge the task being switched out for the time it has run
+                 * since the last tick, so a task cannot avoid being demoted by
+                 * blocking or yielding before each tick interrupt.  This is done
+                 * before the next task is selected as the task is moved to a
+                 * lower ready list if its time slice is used up. */
+                if( pxCurrentTCB->xIsMLFQTask != pdFALSE )
+                {
+                    if( prvMLFQChargeRunTime( pxCurrentTCB, ulTotalRunTime[ 0 ] ) != pdFALSE )
+                    {
+                        moveTaskToLowerQueue( pxCurrentTCB );
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    ulMLFQChargedUpTo = ulTotalRunTime[ 0 ];
+                }
+            }
+            #endif
+
+            taskCLASS_SWITCH_OUT( pxCurrentTCB );
+
             /* Check for stack overflow, if configured. */
             taskCHECK_FOR_STACK_OVERFLOW();
 
@@ -6293,37 +7400,76 @@ static portTASK_FUNCTION( prvIdleTask, pvParameters )
 #endif /* portUSING_MPU_WRAPPERS */
 /*-----------------------------------------------------------*/
 
-#if (configUSE_MLFQ_SCHEDULER == 1)
-//TODO: 这个代码似乎不需要，slice和priority可以都存储在TCB中
-static void setReadyListPriority( void )
-{
-    UBaseType_t uxPriority;
+#if ( ( taskUSE_READY_PRIORITY_BITMAP == 1 ) && ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 ) && !defined( __GNUC__ ) )
 
-    for( uxPriority = ( UBaseType_t ) 1U; uxPriority < ( UBaseType_t ) configMAX_PRIORITIES; uxPriority++ )  // start from 1 to skip the idle task
+    static UBaseType_t prvGetHighestReadyPriority( UBaseType_t uxReadyPriorities )
     {
-        pxReadyTasksLists[ uxPriority ].uxPriority = uxPriority;
-        pxReadyTasksLists[ uxPriority ].uxTimeSlice = ( configMAX_PRIORITIES - uxPriority ) * configMLFQ_UNIT_TIME_SLICE;
+        UBaseType_t uxShift = ( UBaseType_t ) ( sizeof( UBaseType_t ) * 4U );
+        UBaseType_t uxTopPriority = 0U;
+
+        /* Binary search for the most significant set bit, so the number of
+         * steps depends only on the width of UBaseType_t. */
+        while( uxShift > 0U )
+        {
+            if( ( uxReadyPriorities >> uxShift ) != 0U )
+            {
+                uxReadyPriorities >>= uxShift;
+                uxTopPriority += uxShift;
+            }
+
+            uxShift >>= 1U;
+        }
+
+        return uxTopPriority;
     }
-}
 
 #endif
+/*-----------------------------------------------------------*/
 
 static void prvInitialiseTaskLists( void )
 {
     UBaseType_t uxPriority;
 
+    #if ( ( taskUSE_READY_PRIORITY_BITMAP == 1 ) && ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 ) )
+    {
+        /* Each priority needs a bit in the ready priority bitmap. */
+        configASSERT( configMAX_PRIORITIES <= ( sizeof( UBaseType_t ) * 8U ) );
+    }
+    #endif
+
     for( uxPriority = ( UBaseType_t ) 0U; uxPriority < ( UBaseType_t ) configMAX_PRIORITIES; uxPriority++ )
     {
         vListInitialise( &( pxReadyTasksLists[ uxPriority ] ) );
+
+        #if ( configUSE_MLFQ_SCHEDULER == 1 )
+        {
+            vListInitialise( &( xMLFQReadyLists[ uxPriority ] ) );
+        }
+        #endif
     }
-    #if (configUSE_MLFQ_SCHEDULER == 1)
+
+    #if ( configUSE_TIMER_WHEEL_DELAY == 0 )
     {
-        setReadyListPriority();
+        vListInitialise( &xDelayedTaskList1 );
+        vListInitialise( &xDelayedTaskList2 );
     }
-    #endif
+    #else
+    {
+        UBaseType_t uxLevel;
+        UBaseType_t uxSlot;
+
+        for( uxLevel = 0U; uxLevel < ( UBaseType_t ) configTIMER_WHEEL_DELAY_LEVELS; uxLevel++ )
+        {
+            for( uxSlot = 0U; uxSlot < taskWHEEL_SLOTS; uxSlot++ )
+            {
+                vListInitialise( &( xDelayWheel[ uxLevel ][ uxSlot ] ) );
+            }
+
+            ulDelayWheelOccupied[ uxLevel ] = 0U;
+        }
+    }
+    #endif /* configUSE_TIMER_WHEEL_DELAY */
 
-    vListInitialise( &xDelayedTaskList1 );
-    vListInitialise( &xDelayedTaskList2 );
     vListInitialise( &xPendingReadyList );
 
     #if ( INCLUDE_vTaskDelete == 1 )
@@ -6338,10 +7484,14 @@ static void prvInitialiseTaskLists( void )
     }
     #endif /* INCLUDE_vTaskSuspend */
 
-    /* Start with pxDelayedTaskList using list1 and the pxOverflowDelayedTaskList
-     * using list2. */
-    pxDelayedTaskList = &xDelayedTaskList1;
-    pxOverflowDelayedTaskList = &xDelayedTaskList2;
+    #if ( configUSE_TIMER_WHEEL_DELAY == 0 )
+    {
+        /* Start with pxDelayedTaskList using list1 and the
+         * pxOverflowDelayedTaskList using list2. */
+        pxDelayedTaskList = &xDelayedTaskList1;
+        pxOverflowDelayedTaskList = &xDelayedTaskList2;
+    }
+    #endif
 }
 /*-----------------------------------------------------------*/
 
@@ -6471,6 +7621,13 @@ static void prvCheckTasksWaitingTermination( void )
         }
         #endif
 
+        #if ( configUSE_EDF_SCHEDULER == 1 )
+        {
+            pxTaskStatus->uxDeadlineMisses = pxTCB->uxDeadlineMisses;
+            pxTaskStatus->xMaxLateness = pxTCB->xMaxLateness;
+        }
+        #endif
+
         /* Obtaining the task state is a little fiddly, so is only done if the
          * value of eState passed into this function is eInvalid - otherwise the
          * state is just set to whatever is passed in. */
@@ -6719,6 +7876,13 @@ static void prvCheckTasksWaitingTermination( void )
         }
         #endif
 
+        #if ( configUSE_HEAP_CACHE == 1 )
+        {
+            /* Return the blocks held in the task's heap cache to the heap. */
+            vPortFreeHeapCache( pxTCB->pvHeapCache );
+        }
+        #endif
+
         #if ( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) && ( portUSING_MPU_WRAPPERS == 0 ) )
         {
             /* The task can only have been allocated dynamically - free both
@@ -6758,25 +7922,106 @@ static void prvCheckTasksWaitingTermination( void )
 #endif /* INCLUDE_vTaskDelete */
 /*-----------------------------------------------------------*/
 
-static void prvResetNextTaskUnblockTime( void )
-{
-    if( listLIST_IS_EMPTY( pxDelayedTaskList ) != pdFALSE )
+#if ( configUSE_TIMER_WHEEL_DELAY == 0 )
+
+    static void prvResetNextTaskUnblockTime( void )
     {
-        /* The new current delayed list is empty.  Set xNextTaskUnblockTime to
-         * the maximum possible value so it is  extremely unlikely that the
-         * if( xTickCount >= xNextTaskUnblockTime ) test will pass until
-         * there is an item in the delayed list. */
-        xNextTaskUnblockTime = portMAX_DELAY;
+        if( listLIST_IS_EMPTY( pxDelayedTaskList ) != pdFALSE )
+        {
+            /* The new current delayed list is empty.  Set xNextTaskUnblockTime to
+             * the maximum possible value so it is  extremely unlikely that the
+             * if( xTickCount >= xNextTaskUnblockTime ) test will pass until
+             * there is an item in the delayed list. */
+            xNextTaskUnblockTime = portMAX_DELAY;
+        }
+        else
+        {
+            /* The new current delayed list is not empty, get the value of
+             * the item at the head of the delayed list.  This is the time at
+             * which the task at the head of the delayed list should be removed
+             * from the Blocked state. */
+            xNextTaskUnblockTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxDelayedTaskList );
+        }
     }
-    else
+
+#else /* configUSE_TIMER_WHEEL_DELAY */
+
+/* Returns how many slots after uxPosition the next occupied slot is, from 1
+ * to taskWHEEL_SLOTS, the latter being uxPosition itself a revolution later.
+ * ulOccupied must not be zero. */
+    static UBaseType_t prvDelayWheelSlotsToNext( const uint32_t ulOccupied,
+                                                 const UBaseType_t uxPosition )
     {
-        /* The new current delayed list is not empty, get the value of
-         * the item at the head of the delayed list.  This is the time at
-         * which the task at the head of the delayed list should be removed
-         * from the Blocked state. */
-        xNextTaskUnblockTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxDelayedTaskList );
+        /* Bit positions indexed by the top five bits of a power of two
+         * multiplied by a de Bruijn sequence, so finding the lowest set bit
+         * takes the same time on every port. */
+        static const uint8_t ucDeBruijnBitPosition[ 32 ] =
+        {
+            0U,  1U,  28U, 2U,  29U, 14U, 24U, 3U,  30U, 22U, 20U, 15U, 25U, 17U, 4U,  8U,
+            31U, 27U, 13U, 23U, 21U, 19U, 16U, 7U,  26U, 12U, 18U, 6U,  11U, 5U,  10U, 9U
+        };
+        const UBaseType_t uxFirst = ( uxPosition + 1U ) & taskWHEEL_SLOT_MASK;
+        uint32_t ulRotated = ulOccupied;
+        uint32_t ulLowest;
+
+        /* Rotate the map so bit 0 is the slot after uxPosition. */
+        if( uxFirst != 0U )
+        {
+            ulRotated = ( ulOccupied >> uxFirst ) | ( ulOccupied << ( taskWHEEL_SLOTS - uxFirst ) );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        ulLowest = ulRotated & ( ~ulRotated + 1U );
+
+        return ( UBaseType_t ) ucDeBruijnBitPosition[ ( uint32_t ) ( ulLowest * 0x077CB531UL ) >> 27 ] + 1U;
     }
-}
+
+    static void prvResetNextTaskUnblockTime( void )
+    {
+        const TickType_t xConstTickCount = xTickCount;
+        TickType_t xNextTime = portMAX_DELAY;
+        TickType_t xSlotTime;
+        UBaseType_t uxLevel;
+        UBaseType_t uxShift = 0U;
+        UBaseType_t uxPosition;
+
+        /* An occupied slot needs servicing when the tick count enters the
+         * range of ticks it spans, whether the tasks in it are then unblocked
+         * or moved down to a lower level.  The wheel is serviced at the first
+         * such tick of any level.  A time that overflows the tick count is
+         * ignored here as the wheel is looked at again when the tick count
+         * overflows. */
+        for( uxLevel = 0U; uxLevel < ( UBaseType_t ) configTIMER_WHEEL_DELAY_LEVELS; uxLevel++ )
+        {
+            if( ulDelayWheelOccupied[ uxLevel ] != 0U )
+            {
+                uxPosition = ( UBaseType_t ) ( xConstTickCount >> uxShift ) & taskWHEEL_SLOT_MASK;
+                xSlotTime = ( TickType_t ) ( ( ( xConstTickCount >> uxShift ) + ( TickType_t ) prvDelayWheelSlotsToNext( ulDelayWheelOccupied[ uxLevel ], uxPosition ) ) << uxShift );
+
+                if( ( xSlotTime > xConstTickCount ) && ( xSlotTime < xNextTime ) )
+                {
+                    xNextTime = xSlotTime;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            uxShift += taskWHEEL_SLOT_BITS;
+        }
+
+        xNextTaskUnblockTime = xNextTime;
+    }
+
+#endif /* configUSE_TIMER_WHEEL_DELAY */
 /*-----------------------------------------------------------*/
 
 #if ( ( INCLUDE_xTaskGetCurrentTaskHandle == 1 ) || ( configUSE_RECURSIVE_MUTEXES == 1 ) ) || ( configNUMBER_OF_CORES > 1 )
@@ -7914,6 +9159,33 @@ TickType_t uxTaskResetEventItemValue( void )
 #endif /* configUSE_MUTEXES */
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_HEAP_CACHE == 1 )
+
+    void ** ppvTaskGetHeapCache( void )
+    {
+        void ** ppvHeapCache = NULL;
+
+        traceENTER_ppvTaskGetHeapCache();
+
+        /* Blocks allocated or freed before the scheduler is started are not
+         * cached, as there is no calling task to hold them. */
+        if( xSchedulerRunning != pdFALSE )
+        {
+            ppvHeapCache = &( pxCurrentTCB->pvHeapCache );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        traceRETURN_ppvTaskGetHeapCache( ppvHeapCache );
+
+        return ppvHeapCache;
+    }
+
+#endif /* configUSE_HEAP_CACHE */
+/*-----------------------------------------------------------*/
+
 #if ( configUSE_TASK_NOTIFICATIONS == 1 )
 
     uint32_t ulTaskGenericNotifyTake( UBaseType_t uxIndexToWaitOn,
@@ -8754,8 +10026,11 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
 {
     TickType_t xTimeToWake;
     const TickType_t xConstTickCount = xTickCount;
-    List_t * const pxDelayedList = pxDelayedTaskList;
-    List_t * const pxOverflowDelayedList = pxOverflowDelayedTaskList;
+
+    #if ( configUSE_TIMER_WHEEL_DELAY == 0 )
+        List_t * const pxDelayedList = pxDelayedTaskList;
+        List_t * const pxOverflowDelayedList = pxOverflowDelayedTaskList;
+    #endif
 
     #if ( INCLUDE_xTaskAbortDelay == 1 )
     {
@@ -8766,6 +10041,8 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
     }
     #endif
 
+    taskCLASS_DEQUEUE( pxCurrentTCB, xConstTickCount );
+
     /* Remove the task from the ready list before adding it to the blocked list
      * as the same list item is used for both lists. */
     if( uxListRemove( &( pxCurrentTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
@@ -8798,23 +10075,75 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
             /* The list item will be inserted in wake time order. */
             listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xStateListItem ), xTimeToWake );
 
+            #if ( configUSE_TIMER_WHEEL_DELAY == 1 )
+            {
+                traceMOVED_TASK_TO_DELAYED_LIST();
+                prvDelayWheelInsert( &( pxCurrentTCB->xStateListItem ), xConstTickCount );
+            }
+            #else
+            {
+                if( xTimeToWake < xConstTickCount )
+                {
+                    /* Wake time has overflowed.  Place this item in the overflow
+                     * list. */
+                    traceMOVED_TASK_TO_OVERFLOW_DELAYED_LIST();
+                    vListInsert( pxOverflowDelayedList, &( pxCurrentTCB->xStateListItem ) );
+                }
+                else
+                {
+                    /* The wake time has not overflowed, so the current block list
+                     * is used. */
+                    traceMOVED_TASK_TO_DELAYED_LIST();
+                    vListInsert( pxDelayedList, &( pxCurrentTCB->xStateListItem ) );
+
+                    /* If the task entering the blocked state was placed at the
+                     * head of the list of blocked tasks then xNextTaskUnblockTime
+                     * needs to be updated too. */
+                    if( xTimeToWake < xNextTaskUnblockTime )
+                    {
+                        xNextTaskUnblockTime = xTimeToWake;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+            }
+            #endif /* configUSE_TIMER_WHEEL_DELAY */
+        }
+    }
+    #else /* INCLUDE_vTaskSuspend */
+    {
+        /* Calculate the time at which the task should be woken if the event
+         * does not occur.  This may overflow but this doesn't matter, the kernel
+         * will manage it correctly. */
+        xTimeToWake = xConstTickCount + xTicksToWait;
+
+        /* The list item will be inserted in wake time order. */
+        listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xStateListItem ), xTimeToWake );
+
+        #if ( configUSE_TIMER_WHEEL_DELAY == 1 )
+        {
+            traceMOVED_TASK_TO_DELAYED_LIST();
+            prvDelayWheelInsert( &( pxCurrentTCB->xStateListItem ), xConstTickCount );
+        }
+        #else
+        {
             if( xTimeToWake < xConstTickCount )
             {
-                /* Wake time has overflowed.  Place this item in the overflow
-                 * list. */
                 traceMOVED_TASK_TO_OVERFLOW_DELAYED_LIST();
+                /* Wake time has overflowed.  Place this item in the overflow list. */
                 vListInsert( pxOverflowDelayedList, &( pxCurrentTCB->xStateListItem ) );
             }
             else
             {
-                /* The wake time has not overflowed, so the current block list
-                 * is used. */
                 traceMOVED_TASK_TO_DELAYED_LIST();
+                /* The wake time has not overflowed, so the current block list is used. */
                 vListInsert( pxDelayedList, &( pxCurrentTCB->xStateListItem ) );
 
-                /* If the task entering the blocked state was placed at the
-                 * head of the list of blocked tasks then xNextTaskUnblockTime
-                 * needs to be updated too. */
+                /* If the task entering the blocked state was placed at the head of the
+                 * list of blocked tasks then xNextTaskUnblockTime needs to be updated
+                 * too. */
                 if( xTimeToWake < xNextTaskUnblockTime )
                 {
                     xNextTaskUnblockTime = xTimeToWake;
@@ -8825,47 +10154,182 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
                 }
             }
         }
-    }
-    #else /* INCLUDE_vTaskSuspend */
-    {
-        /* Calculate the time at which the task should be woken if the event
-         * does not occur.  This may overflow but this doesn't matter, the kernel
-         * will manage it correctly. */
-        xTimeToWake = xConstTickCount + xTicksToWait;
+        #endif /* configUSE_TIMER_WHEEL_DELAY */
+
+        /* Avoid compiler warning when INCLUDE_vTaskSuspend is not 1. */
+        ( void ) xCanBlockIndefinitely;
+    }
+    #endif /* INCLUDE_vTaskSuspend */
+}
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TIMER_WHEEL_DELAY == 1 )
+
+    static void prvDelayWheelInsert( ListItem_t * const pxStateListItem,
+                                     const TickType_t xFromTime )
+    {
+        TickType_t xDelta = listGET_LIST_ITEM_VALUE( pxStateListItem ) - xFromTime;
+        TickType_t xSlotTime;
+        UBaseType_t uxLevel = 0U;
+        UBaseType_t uxShift = 0U;
+        UBaseType_t uxSlot;
+
+        /* A task due at xFromTime itself is unblocked by the next tick, as it
+         * would be by the delayed lists. */
+        if( xDelta == ( TickType_t ) 0U )
+        {
+            xDelta = ( TickType_t ) 1U;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        /* Level n holds the tasks that are due in fewer than 32 slots of
+         * 32^n ticks, so a task is placed on the lowest level that reaches
+         * its wake time. */
+        while( ( uxLevel < ( ( UBaseType_t ) configTIMER_WHEEL_DELAY_LEVELS - 1U ) ) &&
+               ( ( xDelta >> uxShift ) >= ( TickType_t ) taskWHEEL_SLOTS ) )
+        {
+            uxLevel++;
+            uxShift += taskWHEEL_SLOT_BITS;
+        }
+
+        if( ( xDelta >> uxShift ) >= ( TickType_t ) taskWHEEL_SLOTS )
+        {
+            /* The wake time is beyond the reach of the wheel, so park the task
+             * in the furthest slot of the top level.  It is placed again,
+             * closer to its wake time, when that slot comes round. */
+            xDelta = ( TickType_t ) ( ( ( TickType_t ) taskWHEEL_SLOTS << uxShift ) - ( TickType_t ) 1U );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        xSlotTime = xFromTime + xDelta;
+        uxSlot = ( UBaseType_t ) ( xSlotTime >> uxShift ) & taskWHEEL_SLOT_MASK;
+
+        listINSERT_END( &( xDelayWheel[ uxLevel ][ uxSlot ] ), pxStateListItem );
+        ulDelayWheelOccupied[ uxLevel ] |= ( uint32_t ) 1U << uxSlot;
+
+        /* The slot is serviced at the first tick it spans.  That tick is never
+         * later than the wake time, and never earlier than the next tick. */
+        xSlotTime = ( TickType_t ) ( ( xSlotTime >> uxShift ) << uxShift );
+
+        if( ( xSlotTime > xTickCount ) && ( xSlotTime < xNextTaskUnblockTime ) )
+        {
+            xNextTaskUnblockTime = xSlotTime;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvDelayWheelServiceTick( const TickType_t xConstTickCount )
+    {
+        BaseType_t xSwitchRequired = pdFALSE;
+        BaseType_t xCascade = pdTRUE;
+        UBaseType_t uxLevel;
+        UBaseType_t uxShift = 0U;
+        UBaseType_t uxSlot;
+        List_t * pxSlot;
+        TCB_t * pxTCB;
+
+        /* When the bottom level wraps the current slot of the level above
+         * comes round, and so on up the wheel for as long as each level wraps
+         * too.  The tasks in a slot that comes round move down the wheel, or
+         * are unblocked if they are due on this tick. */
+        for( uxLevel = ( UBaseType_t ) 1U; ( uxLevel < ( UBaseType_t ) configTIMER_WHEEL_DELAY_LEVELS ) && ( xCascade != pdFALSE ); uxLevel++ )
+        {
+            uxShift += taskWHEEL_SLOT_BITS;
+
+            if( ( xConstTickCount & ( ( ( TickType_t ) 1U << uxShift ) - ( TickType_t ) 1U ) ) != ( TickType_t ) 0U )
+            {
+                xCascade = pdFALSE;
+            }
+            else
+            {
+                uxSlot = ( UBaseType_t ) ( xConstTickCount >> uxShift ) & taskWHEEL_SLOT_MASK;
+
+                if( ( ulDelayWheelOccupied[ uxLevel ] & ( ( uint32_t ) 1U << uxSlot ) ) != 0U )
+                {
+                    ulDelayWheelOccupied[ uxLevel ] &= ~( ( uint32_t ) 1U << uxSlot );
+                    pxSlot = &( xDelayWheel[ uxLevel ][ uxSlot ] );
+
+                    while( listLIST_IS_EMPTY( pxSlot ) == pdFALSE )
+                    {
+                        /* MISRA Ref 11.5.3 [Void pointer assignment] */
+                        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+                        /* coverity[misra_c_2012_rule_11_5_violation] */
+                        pxTCB = listGET_OWNER_OF_HEAD_ENTRY( pxSlot );
+
+                        if( listGET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ) ) == xConstTickCount )
+                        {
+                            if( prvUnblockTimedOutTask( pxTCB ) != pdFALSE )
+                            {
+                                xSwitchRequired = pdTRUE;
+                            }
+                            else
+                            {
+                                mtCOVERAGE_TEST_MARKER();
+                            }
+                        }
+                        else
+                        {
+                            /* The task is always placed on a lower level, or
+                             * on a different slot of the top level, so this
+                             * loop ends. */
+                            listREMOVE_ITEM( &( pxTCB->xStateListItem ) );
+                            prvDelayWheelInsert( &( pxTCB->xStateListItem ), xConstTickCount );
+                        }
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+        }
 
-        /* The list item will be inserted in wake time order. */
-        listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xStateListItem ), xTimeToWake );
+        /* Every task in the bottom level slot for this tick is due now. */
+        uxSlot = ( UBaseType_t ) xConstTickCount & taskWHEEL_SLOT_MASK;
 
-        if( xTimeToWake < xConstTickCount )
+        if( ( ulDelayWheelOccupied[ 0 ] & ( ( uint32_t ) 1U << uxSlot ) ) != 0U )
         {
-            traceMOVED_TASK_TO_OVERFLOW_DELAYED_LIST();
-            /* Wake time has overflowed.  Place this item in the overflow list. */
-            vListInsert( pxOverflowDelayedList, &( pxCurrentTCB->xStateListItem ) );
-        }
-        else
-        {
-            traceMOVED_TASK_TO_DELAYED_LIST();
-            /* The wake time has not overflowed, so the current block list is used. */
-            vListInsert( pxDelayedList, &( pxCurrentTCB->xStateListItem ) );
+            ulDelayWheelOccupied[ 0 ] &= ~( ( uint32_t ) 1U << uxSlot );
+            pxSlot = &( xDelayWheel[ 0 ][ uxSlot ] );
 
-            /* If the task entering the blocked state was placed at the head of the
-             * list of blocked tasks then xNextTaskUnblockTime needs to be updated
-             * too. */
-            if( xTimeToWake < xNextTaskUnblockTime )
+            while( listLIST_IS_EMPTY( pxSlot ) == pdFALSE )
             {
-                xNextTaskUnblockTime = xTimeToWake;
-            }
-            else
-            {
-                mtCOVERAGE_TEST_MARKER();
+                /* MISRA Ref 11.5.3 [Void pointer assignment] */
+                /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+                /* coverity[misra_c_2012_rule_11_5_violation] */
+                pxTCB = listGET_OWNER_OF_HEAD_ENTRY( pxSlot );
+
+                if( prvUnblockTimedOutTask( pxTCB ) != pdFALSE )
+                {
+                    xSwitchRequired = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
             }
         }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
 
-        /* Avoid compiler warning when INCLUDE_vTaskSuspend is not 1. */
-        ( void ) xCanBlockIndefinitely;
+        prvResetNextTaskUnblockTime();
+
+        return xSwitchRequired;
     }
-    #endif /* INCLUDE_vTaskSuspend */
-}
+
+#endif /* configUSE_TIMER_WHEEL_DELAY */
 /*-----------------------------------------------------------*/
 
 #if ( portUSING_MPU_WRAPPERS == 1 )
@@ -9029,6 +10493,35 @@ void vTaskResetState( void )
         }
     }
     #endif /* #if ( configGENERATE_RUN_TIME_STATS == 1 ) */
+
+    #if ( configUSE_MLFQ_SCHEDULER == 1 )
+    {
+        uxMLFQCount = ( UBaseType_t ) 0U;
+        uxMLFQBoostGeneration = ( UBaseType_t ) 0U;
+        xMLFQBoostPending = pdFALSE;
+        uxMLFQHighestPriority = ( UBaseType_t ) configMLFQ_HIGHEST_PRIORITY;
+        uxMLFQLowestPriority = ( UBaseType_t ) configMLFQ_LOWEST_PRIORITY;
+        xMLFQBoostPeriod = ( TickType_t ) configMLFQ_LOOP_TIME_SLICE;
+        xMLFQPolicyApplied = pdFALSE;
+
+        #if ( configMLFQ_USE_RUN_TIME_ACCOUNTING == 1 )
+        {
+            ulMLFQChargedUpTo = 0U;
+        }
+        #endif
+    }
+    #endif /* #if ( configUSE_MLFQ_SCHEDULER == 1 ) */
+
+    #if ( configUSE_WEIGHTED_ROUND_ROBIN == 1 )
+    {
+        UBaseType_t uxPriority;
+
+        for( uxPriority = ( UBaseType_t ) 0U; uxPriority < ( UBaseType_t ) configMAX_PRIORITIES; uxPriority++ )
+        {
+            xWRRVirtualTime[ uxPriority ] = ( TickType_t ) 0U;
+        }
+    }
+    #endif /* #if ( configUSE_WEIGHTED_ROUND_ROBIN == 1 ) */
 }
 /*-----------------------------------------------------------*/
 
@@ -9040,10 +10533,329 @@ void vTaskResetState( void )
 		tskTCB * TempTCB;
 		TempTCB = ( tskTCB * )pxTCB;
         TempTCB->uxAbsDeadline = TempTCB->uxDeadLine + xTickCount;
-        if(TempTCB->uxPriority > 0 && TempTCB->pcTaskName != "Tmr Svc\n")
-        {
-            printf("[EDF]: Task %s activate at tick: %d,  Deadline: %d, Absolute Deadline: %d \n", TempTCB->pcTaskName, xTickCount, TempTCB->uxDeadLine, TempTCB->uxAbsDeadline);
-        }
 	    return TempTCB->uxAbsDeadline;
 	}
-#endif	
+#endif
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_EDF_SCHEDULER == 1 )
+
+    static void prvRecordDeadlineMiss( TCB_t * const pxTCB,
+                                       const TickType_t xTickNow )
+    {
+        pxTCB->uxDeadlineMisses++;
+
+        traceTASK_MISSED_DEADLINE( pxTCB );
+
+        #if ( configDEADLINE_MISS_EVENT_BUFFER_LENGTH > 0 )
+        {
+            const UBaseType_t uxEventNumber = uxDeadlineMissEventCount;
+            DeadlineMissEvent_t * const pxEvent = &( xDeadlineMissEvents[ uxEventNumber & ( ( UBaseType_t ) configDEADLINE_MISS_EVENT_BUFFER_LENGTH - 1U ) ] );
+
+            pxEvent->uxEventNumber = uxEventNumber;
+            pxEvent->xHandle = pxTCB;
+            pxEvent->xDeadline = pxTCB->uxAbsDeadline;
+            pxEvent->xTickCount = xTickNow;
+
+            /* The event must be complete before a reader can see it. */
+            portMEMORY_BARRIER();
+            uxDeadlineMissEventCount = uxEventNumber + ( UBaseType_t ) 1U;
+        }
+        #else
+        {
+            ( void ) xTickNow;
+        }
+        #endif /* configDEADLINE_MISS_EVENT_BUFFER_LENGTH */
+    }
+
+#endif /* configUSE_EDF_SCHEDULER == 1 */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_EDF_SCHEDULER == 1 )
+
+    static void prvEndDeadlineActivation( TCB_t * const pxTCB,
+                                          const TickType_t xTickNow )
+    {
+        /* The tick interrupt only sees a deadline pass while the task is
+         * running, so a deadline that passed while the task was ready, and
+         * that the task then ran and blocked within one tick, is caught here. */
+        if( ( pxTCB->xIsMissDDL == pdFALSE ) &&
+            ( pxTCB->uxDeadLine != ( TickType_t ) 0U ) &&
+            ( listDEADLINE_PRECEDES( pxTCB->uxAbsDeadline, xTickNow ) != pdFALSE ) )
+        {
+            /* The tick interrupt also records misses, so the event ring is
+             * only written from a critical section. */
+            taskENTER_CRITICAL();
+            {
+                pxTCB->xIsMissDDL = pdTRUE;
+                prvRecordDeadlineMiss( pxTCB, xTickNow );
+            }
+            taskEXIT_CRITICAL();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if( pxTCB->xIsMissDDL != pdFALSE )
+        {
+            if( ( TickType_t ) ( xTickNow - pxTCB->uxAbsDeadline ) > pxTCB->xMaxLateness )
+            {
+                pxTCB->xMaxLateness = ( TickType_t ) ( xTickNow - pxTCB->uxAbsDeadline );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            pxTCB->xIsMissDDL = pdFALSE;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+#endif /* configUSE_EDF_SCHEDULER == 1 */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_EDF_SCHEDULER == 1 )
+
+    UBaseType_t uxTaskGetDeadlineStats( TaskHandle_t xTask,
+                                        TickType_t * const pxMaxLateness )
+    {
+        TCB_t * pxTCB;
+
+        traceENTER_uxTaskGetDeadlineStats( xTask, pxMaxLateness );
+
+        pxTCB = prvGetTCBFromHandle( xTask );
+
+        if( pxMaxLateness != NULL )
+        {
+            *pxMaxLateness = pxTCB->xMaxLateness;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        traceRETURN_uxTaskGetDeadlineStats( pxTCB->uxDeadlineMisses );
+
+        return pxTCB->uxDeadlineMisses;
+    }
+
+#endif /* configUSE_EDF_SCHEDULER == 1 */
+/*-----------------------------------------------------------*/
+
+#if ( ( configUSE_EDF_SCHEDULER == 1 ) && ( configDEADLINE_MISS_EVENT_BUFFER_LENGTH > 0 ) )
+
+    UBaseType_t uxTaskGetDeadlineMissEvents( DeadlineMissEvent_t * const pxEventArray,
+                                             const UBaseType_t uxArraySize,
+                                             UBaseType_t * const puxNextEvent )
+    {
+        const UBaseType_t uxBufferLength = ( UBaseType_t ) configDEADLINE_MISS_EVENT_BUFFER_LENGTH;
+        UBaseType_t uxNext, uxNewest, uxCopied, uxOverwritten, ux;
+
+        traceENTER_uxTaskGetDeadlineMissEvents( pxEventArray, uxArraySize, puxNextEvent );
+
+        configASSERT( puxNextEvent );
+        configASSERT( ( pxEventArray != NULL ) || ( uxArraySize == 0U ) );
+
+        uxNext = *puxNextEvent;
+        uxNewest = uxDeadlineMissEventCount;
+        portMEMORY_BARRIER();
+
+        /* Events older than the ring holds have already been overwritten.  The
+         * caller can see how many were lost from the event numbers. */
+        if( ( UBaseType_t ) ( uxNewest - uxNext ) > uxBufferLength )
+        {
+            uxNext = uxNewest - uxBufferLength;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        uxCopied = uxNewest - uxNext;
+
+        if( uxCopied > uxArraySize )
+        {
+            uxCopied = uxArraySize;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        for( ux = 0U; ux < uxCopied; ux++ )
+        {
+            pxEventArray[ ux ] = xDeadlineMissEvents[ ( uxNext + ux ) & ( uxBufferLength - 1U ) ];
+        }
+
+        /* The tick interrupt may have reused the oldest slots while they were
+         * being copied.  The slot of the event being written when the count was
+         * re-read may also be incomplete, so drop every event it could have
+         * replaced. */
+        portMEMORY_BARRIER();
+        uxNewest = uxDeadlineMissEventCount;
+
+        if( ( UBaseType_t ) ( uxNewest - uxNext ) >= uxBufferLength )
+        {
+            uxOverwritten = ( uxNewest - uxBufferLength + 1U ) - uxNext;
+
+            if( uxOverwritten > uxCopied )
+            {
+                uxOverwritten = uxCopied;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            for( ux = uxOverwritten; ux < uxCopied; ux++ )
+            {
+                pxEventArray[ ux - uxOverwritten ] = pxEventArray[ ux ];
+            }
+
+            uxCopied -= uxOverwritten;
+            uxNext += uxOverwritten;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        *puxNextEvent = uxNext + uxCopied;
+
+        traceRETURN_uxTaskGetDeadlineMissEvents( uxCopied );
+
+        return uxCopied;
+    }
+
+#endif /* ( configUSE_EDF_SCHEDULER == 1 ) && ( configDEADLINE_MISS_EVENT_BUFFER_LENGTH > 0 ) */	
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_WEIGHTED_ROUND_ROBIN == 1 )
+
+    static void prvWRRJoinReadyList( TCB_t * const pxTCB )
+    {
+        const TickType_t xVirtualTime = xWRRVirtualTime[ pxTCB->uxPriority ];
+
+        /* A task gains no credit for the time it was not ready, so a task that
+         * is behind the virtual time starts level with it.  That includes a
+         * task that appears to be too far ahead, as that can only happen if
+         * the virtual time wrapped while the task was not ready.  A task that
+         * is ahead keeps that debt. */
+        if( ( TickType_t ) ( pxTCB->xWRRVirtualRuntime - xVirtualTime ) > taskWRR_MAX_LEAD )
+        {
+            pxTCB->xWRRVirtualRuntime = xVirtualTime;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        listSET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ), pxTCB->xWRRVirtualRuntime );
+    }
+
+#endif /* configUSE_WEIGHTED_ROUND_ROBIN == 1 */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_WEIGHTED_ROUND_ROBIN == 1 )
+
+    static void prvWRRSwitchOut( TCB_t * const pxTCB )
+    {
+        List_t * const pxReadyList = &( pxReadyTasksLists[ pxTCB->uxPriority ] );
+        ListItem_t * const pxStateListItem = &( pxTCB->xStateListItem );
+        const TCB_t * pxNextTCB;
+
+        if( listIS_CONTAINED_WITHIN( pxReadyList, pxStateListItem ) != pdFALSE )
+        {
+            /* The task remains ready, so move it within the heap if it has
+             * been charged since it was inserted.  The list is not empty
+             * afterwards, so the ready priority is left recorded. */
+            if( listGET_LIST_ITEM_VALUE( pxStateListItem ) != pxTCB->xWRRVirtualRuntime )
+            {
+                ( void ) uxListRemove( pxStateListItem );
+                listSET_LIST_ITEM_VALUE( pxStateListItem, pxTCB->xWRRVirtualRuntime );
+                vListInsertDeadline( pxReadyList, pxStateListItem );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            /* The heap root now has the smallest virtual run time of the ready
+             * tasks of this priority. */
+            pxNextTCB = listGET_OWNER_OF_DEADLINE_HEAD( pxReadyList );
+
+            if( listDEADLINE_PRECEDES( xWRRVirtualTime[ pxTCB->uxPriority ], pxNextTCB->xWRRVirtualRuntime ) != pdFALSE )
+            {
+                xWRRVirtualTime[ pxTCB->uxPriority ] = pxNextTCB->xWRRVirtualRuntime;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            /* The task has blocked, been suspended or been deleted, so it
+             * starts a new time slice when it next runs. */
+            pxTCB->uxRemainingTicks = configSLICE_INTERVAL;
+        }
+    }
+
+#endif /* configUSE_WEIGHTED_ROUND_ROBIN == 1 */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_WEIGHTED_ROUND_ROBIN == 1 )
+
+    void vTaskSetWeight( TaskHandle_t xTask,
+                         UBaseType_t uxWeight )
+    {
+        TCB_t * pxTCB;
+
+        traceENTER_vTaskSetWeight( xTask, uxWeight );
+
+        configASSERT( ( uxWeight > ( UBaseType_t ) 0U ) && ( uxWeight <= ( UBaseType_t ) configWRR_MAX_WEIGHT ) );
+
+        taskENTER_CRITICAL();
+        {
+            /* If null is passed in here then it is the weight of the calling
+             * task that is being changed.  The new weight applies from the
+             * next tick, and time already charged is not recalculated. */
+            pxTCB = prvGetTCBFromHandle( xTask );
+            pxTCB->uxWeight = uxWeight;
+            pxTCB->xWRRStride = taskWRR_STRIDE_SCALE / ( TickType_t ) uxWeight;
+        }
+        taskEXIT_CRITICAL();
+
+        traceRETURN_vTaskSetWeight();
+    }
+
+#endif /* configUSE_WEIGHTED_ROUND_ROBIN == 1 */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_WEIGHTED_ROUND_ROBIN == 1 )
+
+    UBaseType_t uxTaskGetWeight( const TaskHandle_t xTask )
+    {
+        TCB_t const * pxTCB;
+        UBaseType_t uxReturn;
+
+        traceENTER_uxTaskGetWeight( xTask );
+
+        portBASE_TYPE_ENTER_CRITICAL();
+        {
+            pxTCB = prvGetTCBFromHandle( xTask );
+            uxReturn = pxTCB->uxWeight;
+        }
+        portBASE_TYPE_EXIT_CRITICAL();
+
+        traceRETURN_uxTaskGetWeight( uxReturn );
+
+        return uxReturn;
+    }
+
+#endif /* configUSE_WEIGHTED_ROUND_ROBIN == 1 */
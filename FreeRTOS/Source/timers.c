@@ -79,6 +79,15 @@
     #define tmrSTATUS_IS_STATICALLY_ALLOCATED    ( 0x02U )
     #define tmrSTATUS_IS_AUTORELOAD              ( 0x04U )
 
+    #if ( configUSE_TIMER_SERVICE_WHEEL == 1 )
+
+/* Each level of the timing wheel has tmrWHEEL_SLOTS slots, one bit of a
+ * uint32_t occupancy map each. */
+        #define tmrWHEEL_SLOT_BITS    5U
+        #define tmrWHEEL_SLOTS        ( ( UBaseType_t ) 1U << tmrWHEEL_SLOT_BITS )
+        #define tmrWHEEL_SLOT_MASK    ( tmrWHEEL_SLOTS - 1U )
+    #endif
+
 /* The definition of the timers themselves. */
     typedef struct tmrTimerControl                                               /* The old naming convention is used to prevent breaking kernel aware debuggers. */
     {
@@ -134,16 +143,39 @@
         } u;
     } DaemonTaskMessage_t;
 
+    #if ( configUSE_TIMER_SERVICE_WHEEL == 0 )
+
 /* The list in which active timers are stored.  Timers are referenced in expire
  * time order, with the nearest expiry time at the front of the list.  Only the
  * timer service task is allowed to access these lists.
  * xActiveTimerList1 and xActiveTimerList2 could be at function scope but that
  * breaks some kernel aware debuggers, and debuggers that reply on removing the
  * static qualifier. */
-    PRIVILEGED_DATA static List_t xActiveTimerList1;
-    PRIVILEGED_DATA static List_t xActiveTimerList2;
-    PRIVILEGED_DATA static List_t * pxCurrentTimerList;
-    PRIVILEGED_DATA static List_t * pxOverflowTimerList;
+        PRIVILEGED_DATA static List_t xActiveTimerList1;
+        PRIVILEGED_DATA static List_t xActiveTimerList2;
+        PRIVILEGED_DATA static List_t * pxCurrentTimerList;
+        PRIVILEGED_DATA static List_t * pxOverflowTimerList;
+
+    #else /* configUSE_TIMER_SERVICE_WHEEL */
+
+/* The timing wheel in which active timers are stored.  Level n holds the timers
+ * that expire within 32 slots of 32^n ticks of xTimerWheelTime, in the slot
+ * their expiry time falls in, and a set bit in ulTimerWheelOccupied marks a
+ * slot that may hold timers.  Bits are only cleared when the slot is next
+ * looked at, so removing a timer from its slot leaves the bit set.  Timers that
+ * have expired are moved to xExpiredTimerList before any of their callbacks
+ * are called.  Only the timer service task is allowed to access these. */
+        PRIVILEGED_DATA static List_t xTimerWheel[ configTIMER_SERVICE_WHEEL_LEVELS ][ tmrWHEEL_SLOTS ];
+        PRIVILEGED_DATA static uint32_t ulTimerWheelOccupied[ configTIMER_SERVICE_WHEEL_LEVELS ];
+        PRIVILEGED_DATA static TickType_t xTimerWheelTime = ( TickType_t ) 0U;
+        PRIVILEGED_DATA static List_t xExpiredTimerList;
+
+    #endif /* configUSE_TIMER_SERVICE_WHEEL */
+
+/* Set while the timer service task is calling a timer callback function at a
+ * point where a command the callback sends to the timer service task can be
+ * carried out straight away instead of being queued. */
+    PRIVILEGED_DATA static BaseType_t xCommandsCanBeApplied = pdFALSE;
 
 /* A queue that is used to send commands to the timer service task. */
     PRIVILEGED_DATA static QueueHandle_t xTimerQueue = NULL;
@@ -170,6 +202,20 @@
  */
     static void prvProcessReceivedCommands( void ) PRIVILEGED_FUNCTION;
 
+/*
+ * Carry out a timer command, either received on the timer queue or sent by a
+ * timer callback function while the timer queue is empty.
+ */
+    static void prvProcessTimerCommand( const DaemonTaskMessage_t * const pxMessage ) PRIVILEGED_FUNCTION;
+
+/*
+ * Call the callback function of pxTimer.  xCanApplyCommands is pdTRUE if
+ * nothing refers to the timer lists, or to pxTimer, once the callback returns,
+ * so timer commands sent by the callback can be carried out straight away.
+ */
+    static void prvCallTimerCallback( Timer_t * const pxTimer,
+                                      const BaseType_t xCanApplyCommands ) PRIVILEGED_FUNCTION;
+
 /*
  * Insert the timer into either xActiveTimerList1, or xActiveTimerList2,
  * depending on if the expire time causes a timer counter overflow.
@@ -189,17 +235,45 @@
                                 const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
 
 /*
- * An active timer has reached its expire time.  Reload the timer if it is an
- * auto-reload timer, then call its callback.
+ * An active timer has reached its expire time.  Remove it from the active
+ * timers, reload the timer if it is an auto-reload timer, then call its
+ * callback.
+ */
+    static void prvProcessExpiredTimer( Timer_t * const pxTimer,
+                                        const TickType_t xNextExpireTime,
+                                        const TickType_t xTimeNow,
+                                        const BaseType_t xCanApplyCommands ) PRIVILEGED_FUNCTION;
+
+/*
+ * Process every active timer that has reached its expire time by xTimeNow, so
+ * the timers that expire on the same tick are handled in one pass rather than
+ * one pass of the timer service task each.
  */
-    static void prvProcessExpiredTimer( const TickType_t xNextExpireTime,
-                                        const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
+    static void prvProcessExpiredTimers( const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
+
+    #if ( configUSE_TIMER_SERVICE_WHEEL == 0 )
 
 /*
  * The tick count has overflowed.  Switch the timer lists after ensuring the
  * current timer list does not still reference some timers.
  */
-    static void prvSwitchTimerLists( void ) PRIVILEGED_FUNCTION;
+        static void prvSwitchTimerLists( void ) PRIVILEGED_FUNCTION;
+
+    #else /* configUSE_TIMER_SERVICE_WHEEL */
+
+/*
+ * Place an active timer in the slot of the timing wheel that its expiry time
+ * falls in, relative to xTimerWheelTime.
+ */
+        static void prvTimerWheelInsert( Timer_t * const pxTimer ) PRIVILEGED_FUNCTION;
+
+/*
+ * Move the timers in the slots that come round at xSlotTime either to
+ * xExpiredTimerList, if they expire at xSlotTime, or down the wheel.
+ */
+        static void prvTimerWheelCollectExpired( const TickType_t xSlotTime ) PRIVILEGED_FUNCTION;
+
+    #endif /* configUSE_TIMER_SERVICE_WHEEL */
 
 /*
  * Obtain the current tick count, setting *pxTimerListsWereSwitched to pdTRUE
@@ -211,7 +285,9 @@
  * If the timer list contains any active timers then return the expire time of
  * the timer that will expire first and set *pxListWasEmpty to false.  If the
  * timer list does not contain any timers then return 0 and set *pxListWasEmpty
- * to pdTRUE.
+ * to pdTRUE.  When the timing wheel is used the time returned is the first
+ * tick of the earliest occupied slot, which is never later than the expire
+ * time of the first timer to expire.
  */
     static TickType_t prvGetNextExpireTime( BaseType_t * const pxListWasEmpty ) PRIVILEGED_FUNCTION;
 
@@ -473,6 +549,22 @@
 
             if( xCommandID < tmrFIRST_FROM_ISR_COMMAND )
             {
+                #if ( INCLUDE_xTaskGetCurrentTaskHandle == 1 )
+                    if( ( xTaskGetCurrentTaskHandle() == xTimerTaskHandle ) &&
+                        ( xCommandsCanBeApplied != pdFALSE ) &&
+                        ( uxQueueMessagesWaiting( xTimerQueue ) == ( UBaseType_t ) 0U ) )
+                    {
+                        /* A timer callback function is sending a command to the
+                         * timer service task that is calling it.  No earlier
+                         * command is waiting in the queue, so the command can be
+                         * carried out now without a trip through the queue, and
+                         * without the risk of blocking on a full queue. */
+                        prvProcessTimerCommand( &xMessage );
+                        xReturn = pdPASS;
+                    }
+                    else
+                #endif /* INCLUDE_xTaskGetCurrentTaskHandle */
+
                 if( xTaskGetSchedulerState() == taskSCHEDULER_RUNNING )
                 {
                     xReturn = xQueueSendToBack( xTimerQueue, &xMessage, xTicksToWait );
@@ -708,24 +800,32 @@
             /* Advance the expiry time. */
             xExpiredTime += pxTimer->xTimerPeriodInTicks;
 
-            /* Call the timer callback. */
-            traceTIMER_EXPIRED( pxTimer );
-            pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
+            /* Call the timer callback.  The timer is inserted again once the
+             * callback returns, so commands the callback sends are queued. */
+            prvCallTimerCallback( pxTimer, pdFALSE );
         }
     }
 /*-----------------------------------------------------------*/
 
-    static void prvProcessExpiredTimer( const TickType_t xNextExpireTime,
-                                        const TickType_t xTimeNow )
+    static void prvCallTimerCallback( Timer_t * const pxTimer,
+                                      const BaseType_t xCanApplyCommands )
     {
-        /* MISRA Ref 11.5.3 [Void pointer assignment] */
-        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
-        /* coverity[misra_c_2012_rule_11_5_violation] */
-        Timer_t * const pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxCurrentTimerList );
+        const BaseType_t xPreviousCanApplyCommands = xCommandsCanBeApplied;
+
+        traceTIMER_EXPIRED( pxTimer );
 
-        /* Remove the timer from the list of active timers.  A check has already
-         * been performed to ensure the list is not empty. */
+        xCommandsCanBeApplied = xCanApplyCommands;
+        pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
+        xCommandsCanBeApplied = xPreviousCanApplyCommands;
+    }
+/*-----------------------------------------------------------*/
 
+    static void prvProcessExpiredTimer( Timer_t * const pxTimer,
+                                        const TickType_t xNextExpireTime,
+                                        const TickType_t xTimeNow,
+                                        const BaseType_t xCanApplyCommands )
+    {
+        /* Remove the timer from the active timers. */
         ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
 
         /* If the timer is an auto-reload timer then calculate the next
@@ -740,11 +840,74 @@
         }
 
         /* Call the timer callback. */
-        traceTIMER_EXPIRED( pxTimer );
-        pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
+        prvCallTimerCallback( pxTimer, xCanApplyCommands );
     }
 /*-----------------------------------------------------------*/
 
+    #if ( configUSE_TIMER_SERVICE_WHEEL == 0 )
+
+        static void prvProcessExpiredTimers( const TickType_t xTimeNow )
+        {
+            List_t * const pxTimerList = pxCurrentTimerList;
+            Timer_t * pxTimer;
+
+            /* A callback that sends a command straight to this task can cause
+             * the tick count overflow to be noticed, in which case the timers
+             * left in this list have already been processed and the lists have
+             * been switched, so stop there.  A check has already been performed
+             * to ensure the head of the list has expired. */
+            while( ( pxCurrentTimerList == pxTimerList ) &&
+                   ( listLIST_IS_EMPTY( pxTimerList ) == pdFALSE ) &&
+                   ( listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxTimerList ) <= xTimeNow ) )
+            {
+                /* MISRA Ref 11.5.3 [Void pointer assignment] */
+                /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+                /* coverity[misra_c_2012_rule_11_5_violation] */
+                pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxTimerList );
+
+                prvProcessExpiredTimer( pxTimer, listGET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ) ), xTimeNow, pdTRUE );
+            }
+        }
+
+    #else /* configUSE_TIMER_SERVICE_WHEEL */
+
+        static void prvProcessExpiredTimers( const TickType_t xTimeNow )
+        {
+            const TickType_t xFromTime = xTimerWheelTime;
+            TickType_t xSlotTime;
+            BaseType_t xWheelWasEmpty;
+            Timer_t * pxTimer;
+
+            xSlotTime = prvGetNextExpireTime( &xWheelWasEmpty );
+
+            /* Times are compared by how far they are after the time the wheel
+             * had reached on entry, so the comparison holds when the tick count
+             * overflows.  The wheel only ever moves forward from there. */
+            while( ( xWheelWasEmpty == pdFALSE ) &&
+                   ( ( TickType_t ) ( xSlotTime - xFromTime ) <= ( TickType_t ) ( xTimeNow - xFromTime ) ) )
+            {
+                xTimerWheelTime = xSlotTime;
+                prvTimerWheelCollectExpired( xSlotTime );
+
+                /* Callbacks can stop or delete other timers that expired on
+                 * the same tick, which removes them from the list. */
+                while( listLIST_IS_EMPTY( &xExpiredTimerList ) == pdFALSE )
+                {
+                    /* MISRA Ref 11.5.3 [Void pointer assignment] */
+                    /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+                    /* coverity[misra_c_2012_rule_11_5_violation] */
+                    pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( &xExpiredTimerList );
+
+                    prvProcessExpiredTimer( pxTimer, xSlotTime, xTimeNow, pdTRUE );
+                }
+
+                xSlotTime = prvGetNextExpireTime( &xWheelWasEmpty );
+            }
+        }
+
+    #endif /* configUSE_TIMER_SERVICE_WHEEL */
+/*-----------------------------------------------------------*/
+
     static portTASK_FUNCTION( prvTimerTask, pvParameters )
     {
         TickType_t xNextExpireTime;
@@ -796,11 +959,18 @@
 
             if( xTimerListsWereSwitched == pdFALSE )
             {
-                /* The tick count has not overflowed, has the timer expired? */
-                if( ( xListWasEmpty == pdFALSE ) && ( xNextExpireTime <= xTimeNow ) )
+                /* The tick count has not overflowed, has the timer expired?  The
+                 * timing wheel compares times by how far they are after the time
+                 * it has reached, as it does not switch lists on an overflow. */
+                #if ( configUSE_TIMER_SERVICE_WHEEL == 0 )
+                    if( ( xListWasEmpty == pdFALSE ) && ( xNextExpireTime <= xTimeNow ) )
+                #else
+                    if( ( xListWasEmpty == pdFALSE ) &&
+                        ( ( TickType_t ) ( xNextExpireTime - xTimerWheelTime ) <= ( TickType_t ) ( xTimeNow - xTimerWheelTime ) ) )
+                #endif
                 {
                     ( void ) xTaskResumeAll();
-                    prvProcessExpiredTimer( xNextExpireTime, xTimeNow );
+                    prvProcessExpiredTimers( xTimeNow );
                 }
                 else
                 {
@@ -810,12 +980,24 @@
                      * received - whichever comes first.  The following line cannot
                      * be reached unless xNextExpireTime > xTimeNow, except in the
                      * case when the current timer list is empty. */
-                    if( xListWasEmpty != pdFALSE )
+                    #if ( configUSE_TIMER_SERVICE_WHEEL == 0 )
                     {
-                        /* The current timer list is empty - is the overflow list
-                         * also empty? */
-                        xListWasEmpty = listLIST_IS_EMPTY( pxOverflowTimerList );
+                        if( xListWasEmpty != pdFALSE )
+                        {
+                            /* The current timer list is empty - is the overflow list
+                             * also empty? */
+                            xListWasEmpty = listLIST_IS_EMPTY( pxOverflowTimerList );
+                        }
+                    }
+                    #else
+                    {
+                        /* No occupied slot comes round before xTimeNow, so the
+                         * wheel can move on to it.  This keeps the time the wheel
+                         * has reached close to the tick count while no timer
+                         * expires. */
+                        xTimerWheelTime = xTimeNow;
                     }
+                    #endif /* configUSE_TIMER_SERVICE_WHEEL */
 
                     vQueueWaitForMessageRestricted( xTimerQueue, ( xNextExpireTime - xTimeNow ), xListWasEmpty );
 
@@ -841,51 +1023,159 @@
     }
 /*-----------------------------------------------------------*/
 
-    static TickType_t prvGetNextExpireTime( BaseType_t * const pxListWasEmpty )
-    {
-        TickType_t xNextExpireTime;
+    #if ( configUSE_TIMER_SERVICE_WHEEL == 0 )
 
-        /* Timers are listed in expiry time order, with the head of the list
-         * referencing the task that will expire first.  Obtain the time at which
-         * the timer with the nearest expiry time will expire.  If there are no
-         * active timers then just set the next expire time to 0.  That will cause
-         * this task to unblock when the tick count overflows, at which point the
-         * timer lists will be switched and the next expiry time can be
-         * re-assessed.  */
-        *pxListWasEmpty = listLIST_IS_EMPTY( pxCurrentTimerList );
+        static TickType_t prvGetNextExpireTime( BaseType_t * const pxListWasEmpty )
+        {
+            TickType_t xNextExpireTime;
+
+            /* Timers are listed in expiry time order, with the head of the list
+             * referencing the task that will expire first.  Obtain the time at which
+             * the timer with the nearest expiry time will expire.  If there are no
+             * active timers then just set the next expire time to 0.  That will cause
+             * this task to unblock when the tick count overflows, at which point the
+             * timer lists will be switched and the next expiry time can be
+             * re-assessed.  */
+            *pxListWasEmpty = listLIST_IS_EMPTY( pxCurrentTimerList );
+
+            if( *pxListWasEmpty == pdFALSE )
+            {
+                xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentTimerList );
+            }
+            else
+            {
+                /* Ensure the task unblocks when the tick count rolls over. */
+                xNextExpireTime = ( TickType_t ) 0U;
+            }
+
+            return xNextExpireTime;
+        }
+
+    #else /* configUSE_TIMER_SERVICE_WHEEL */
 
-        if( *pxListWasEmpty == pdFALSE )
+/* Returns how many slots after uxPosition the next occupied slot is, from 1
+ * to tmrWHEEL_SLOTS, the latter being uxPosition itself a revolution later.
+ * ulOccupied must not be zero. */
+        static UBaseType_t prvTimerWheelSlotsToNext( const uint32_t ulOccupied,
+                                                     const UBaseType_t uxPosition )
         {
-            xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentTimerList );
+            /* Bit positions indexed by the top five bits of a power of two
+             * multiplied by a de Bruijn sequence, so finding the lowest set bit
+             * takes the same time on every port. */
+            static const uint8_t ucDeBruijnBitPosition[ 32 ] =
+            {
+                0U,  1U,  28U, 2U,  29U, 14U, 24U, 3U,  30U, 22U, 20U, 15U, 25U, 17U, 4U,  8U,
+                31U, 27U, 13U, 23U, 21U, 19U, 16U, 7U,  26U, 12U, 18U, 6U,  11U, 5U,  10U, 9U
+            };
+            const UBaseType_t uxFirst = ( uxPosition + 1U ) & tmrWHEEL_SLOT_MASK;
+            uint32_t ulRotated = ulOccupied;
+            uint32_t ulLowest;
+
+            /* Rotate the map so bit 0 is the slot after uxPosition. */
+            if( uxFirst != 0U )
+            {
+                ulRotated = ( ulOccupied >> uxFirst ) | ( ulOccupied << ( tmrWHEEL_SLOTS - uxFirst ) );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            ulLowest = ulRotated & ( ~ulRotated + 1U );
+
+            return ( UBaseType_t ) ucDeBruijnBitPosition[ ( uint32_t ) ( ulLowest * 0x077CB531UL ) >> 27 ] + 1U;
         }
-        else
+
+        static TickType_t prvGetNextExpireTime( BaseType_t * const pxListWasEmpty )
         {
-            /* Ensure the task unblocks when the tick count rolls over. */
-            xNextExpireTime = ( TickType_t ) 0U;
+            TickType_t xNextDelta = tmrMAX_TIME_BEFORE_OVERFLOW;
+            TickType_t xSlotDelta;
+            UBaseType_t uxLevel;
+            UBaseType_t uxShift = 0U;
+            UBaseType_t uxPosition;
+            UBaseType_t uxSlotsToNext;
+            UBaseType_t uxSlot;
+            BaseType_t xFound;
+
+            *pxListWasEmpty = pdTRUE;
+
+            /* An occupied slot needs servicing when the time the wheel has
+             * reached enters the range of ticks it spans, whether the timers in
+             * it then expire or move down to a lower level.  The earliest such
+             * tick of any level is returned.  Slots found to be empty are
+             * cleared from the occupancy maps on the way. */
+            for( uxLevel = 0U; uxLevel < ( UBaseType_t ) configTIMER_SERVICE_WHEEL_LEVELS; uxLevel++ )
+            {
+                uxPosition = ( UBaseType_t ) ( xTimerWheelTime >> uxShift ) & tmrWHEEL_SLOT_MASK;
+                xFound = pdFALSE;
+
+                while( ( ulTimerWheelOccupied[ uxLevel ] != 0U ) && ( xFound == pdFALSE ) )
+                {
+                    uxSlotsToNext = prvTimerWheelSlotsToNext( ulTimerWheelOccupied[ uxLevel ], uxPosition );
+                    uxSlot = ( uxPosition + uxSlotsToNext ) & tmrWHEEL_SLOT_MASK;
+
+                    if( listLIST_IS_EMPTY( &( xTimerWheel[ uxLevel ][ uxSlot ] ) ) != pdFALSE )
+                    {
+                        ulTimerWheelOccupied[ uxLevel ] &= ~( ( uint32_t ) 1U << uxSlot );
+                    }
+                    else
+                    {
+                        xSlotDelta = ( TickType_t ) ( ( ( TickType_t ) ( ( xTimerWheelTime >> uxShift ) + ( TickType_t ) uxSlotsToNext ) << uxShift ) - xTimerWheelTime );
+
+                        if( xSlotDelta < xNextDelta )
+                        {
+                            xNextDelta = xSlotDelta;
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+
+                        *pxListWasEmpty = pdFALSE;
+                        xFound = pdTRUE;
+                    }
+                }
+
+                uxShift += tmrWHEEL_SLOT_BITS;
+            }
+
+            return ( *pxListWasEmpty == pdFALSE ) ? ( TickType_t ) ( xTimerWheelTime + xNextDelta ) : ( TickType_t ) 0U;
         }
 
-        return xNextExpireTime;
-    }
+    #endif /* configUSE_TIMER_SERVICE_WHEEL */
 /*-----------------------------------------------------------*/
 
     static TickType_t prvSampleTimeNow( BaseType_t * const pxTimerListsWereSwitched )
     {
         TickType_t xTimeNow;
-        PRIVILEGED_DATA static TickType_t xLastTime = ( TickType_t ) 0U;
 
-        xTimeNow = xTaskGetTickCount();
-
-        if( xTimeNow < xLastTime )
+        #if ( configUSE_TIMER_SERVICE_WHEEL == 0 )
         {
-            prvSwitchTimerLists();
-            *pxTimerListsWereSwitched = pdTRUE;
+            PRIVILEGED_DATA static TickType_t xLastTime = ( TickType_t ) 0U;
+
+            xTimeNow = xTaskGetTickCount();
+
+            if( xTimeNow < xLastTime )
+            {
+                prvSwitchTimerLists();
+                *pxTimerListsWereSwitched = pdTRUE;
+            }
+            else
+            {
+                *pxTimerListsWereSwitched = pdFALSE;
+            }
+
+            xLastTime = xTimeNow;
         }
-        else
+        #else /* configUSE_TIMER_SERVICE_WHEEL */
         {
+            /* The timing wheel places timers by how far their expiry time is
+             * after the time the wheel has reached, so it does not need to know
+             * when the tick count overflows. */
+            xTimeNow = xTaskGetTickCount();
             *pxTimerListsWereSwitched = pdFALSE;
         }
-
-        xLastTime = xTimeNow;
+        #endif /* configUSE_TIMER_SERVICE_WHEEL */
 
         return xTimeNow;
     }
@@ -901,6 +1191,30 @@
         listSET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ), xNextExpiryTime );
         listSET_LIST_ITEM_OWNER( &( pxTimer->xTimerListItem ), pxTimer );
 
+        #if ( configUSE_TIMER_SERVICE_WHEEL == 1 )
+        {
+            /* While the wheel is empty the time it has reached can be moved on
+             * to the tick count, so a timer started after a long time without
+             * active timers is still placed close to the time it reached. */
+            UBaseType_t uxLevel;
+            uint32_t ulOccupied = 0U;
+
+            for( uxLevel = 0U; uxLevel < ( UBaseType_t ) configTIMER_SERVICE_WHEEL_LEVELS; uxLevel++ )
+            {
+                ulOccupied |= ulTimerWheelOccupied[ uxLevel ];
+            }
+
+            if( ulOccupied == 0U )
+            {
+                xTimerWheelTime = xTimeNow;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        #endif /* configUSE_TIMER_SERVICE_WHEEL */
+
         if( xNextExpiryTime <= xTimeNow )
         {
             /* Has the expiry time elapsed between the command to start/reset a
@@ -913,7 +1227,11 @@
             }
             else
             {
-                vListInsert( pxOverflowTimerList, &( pxTimer->xTimerListItem ) );
+                #if ( configUSE_TIMER_SERVICE_WHEEL == 0 )
+                    vListInsert( pxOverflowTimerList, &( pxTimer->xTimerListItem ) );
+                #else
+                    prvTimerWheelInsert( pxTimer );
+                #endif
             }
         }
         else
@@ -927,7 +1245,11 @@
             }
             else
             {
-                vListInsert( pxCurrentTimerList, &( pxTimer->xTimerListItem ) );
+                #if ( configUSE_TIMER_SERVICE_WHEEL == 0 )
+                    vListInsert( pxCurrentTimerList, &( pxTimer->xTimerListItem ) );
+                #else
+                    prvTimerWheelInsert( pxTimer );
+                #endif
             }
         }
 
@@ -938,9 +1260,6 @@
     static void prvProcessReceivedCommands( void )
     {
         DaemonTaskMessage_t xMessage = { 0 };
-        Timer_t * pxTimer;
-        BaseType_t xTimerListsWereSwitched;
-        TickType_t xTimeNow;
 
         while( xQueueReceive( xTimerQueue, &xMessage, tmrNO_DELAY ) != pdFAIL )
         {
@@ -970,142 +1289,266 @@
              * function calls. */
             if( xMessage.xMessageID >= ( BaseType_t ) 0 )
             {
-                /* The messages uses the xTimerParameters member to work on a
-                 * software timer. */
-                pxTimer = xMessage.u.xTimerParameters.pxTimer;
+                prvProcessTimerCommand( &xMessage );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvProcessTimerCommand( const DaemonTaskMessage_t * const pxMessage )
+    {
+        Timer_t * pxTimer;
+        BaseType_t xTimerListsWereSwitched;
+        TickType_t xTimeNow;
+        const TickType_t xMessageValue = pxMessage->u.xTimerParameters.xMessageValue;
+
+        /* The messages uses the xTimerParameters member to work on a
+         * software timer. */
+        pxTimer = pxMessage->u.xTimerParameters.pxTimer;
+
+        if( listIS_CONTAINED_WITHIN( NULL, &( pxTimer->xTimerListItem ) ) == pdFALSE )
+        {
+            /* The timer is in a list, remove it. */
+            ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        traceTIMER_COMMAND_RECEIVED( pxTimer, pxMessage->xMessageID, xMessageValue );
+
+        /* In this case the xTimerListsWereSwitched parameter is not used, but
+         *  it must be present in the function call.  prvSampleTimeNow() must be
+         *  called after the message is received from xTimerQueue so there is no
+         *  possibility of a higher priority task adding a message to the message
+         *  queue with a time that is ahead of the timer daemon task (because it
+         *  pre-empted the timer daemon task after the xTimeNow value was set). */
+        xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
 
-                if( listIS_CONTAINED_WITHIN( NULL, &( pxTimer->xTimerListItem ) ) == pdFALSE )
+        switch( pxMessage->xMessageID )
+        {
+            case tmrCOMMAND_START:
+            case tmrCOMMAND_START_FROM_ISR:
+            case tmrCOMMAND_RESET:
+            case tmrCOMMAND_RESET_FROM_ISR:
+                /* Start or restart a timer. */
+                pxTimer->ucStatus |= ( uint8_t ) tmrSTATUS_IS_ACTIVE;
+
+                if( prvInsertTimerInActiveList( pxTimer, xMessageValue + pxTimer->xTimerPeriodInTicks, xTimeNow, xMessageValue ) != pdFALSE )
                 {
-                    /* The timer is in a list, remove it. */
-                    ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+                    /* The timer expired before it was added to the active
+                     * timer list.  Process it now. */
+                    if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) != 0U )
+                    {
+                        prvReloadTimer( pxTimer, xMessageValue + pxTimer->xTimerPeriodInTicks, xTimeNow );
+                    }
+                    else
+                    {
+                        pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+                    }
+
+                    /* Call the timer callback.  Nothing refers to the timer once
+                     * the callback returns. */
+                    prvCallTimerCallback( pxTimer, pdTRUE );
                 }
                 else
                 {
                     mtCOVERAGE_TEST_MARKER();
                 }
 
-                traceTIMER_COMMAND_RECEIVED( pxTimer, xMessage.xMessageID, xMessage.u.xTimerParameters.xMessageValue );
+                break;
+
+            case tmrCOMMAND_STOP:
+            case tmrCOMMAND_STOP_FROM_ISR:
+                /* The timer has already been removed from the active list. */
+                pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+                break;
+
+            case tmrCOMMAND_CHANGE_PERIOD:
+            case tmrCOMMAND_CHANGE_PERIOD_FROM_ISR:
+                pxTimer->ucStatus |= ( uint8_t ) tmrSTATUS_IS_ACTIVE;
+                pxTimer->xTimerPeriodInTicks = xMessageValue;
+                configASSERT( ( pxTimer->xTimerPeriodInTicks > 0 ) );
+
+                /* The new period does not really have a reference, and can
+                 * be longer or shorter than the old one.  The command time is
+                 * therefore set to the current time, and as the period cannot
+                 * be zero the next expiry time can only be in the future,
+                 * meaning (unlike for the xTimerStart() case above) there is
+                 * no fail case that needs to be handled here. */
+                ( void ) prvInsertTimerInActiveList( pxTimer, ( xTimeNow + pxTimer->xTimerPeriodInTicks ), xTimeNow, xTimeNow );
+                break;
+
+            case tmrCOMMAND_DELETE:
+                #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+                {
+                    /* The timer has already been removed from the active list,
+                     * just free up the memory if the memory was dynamically
+                     * allocated. */
+                    if( ( pxTimer->ucStatus & tmrSTATUS_IS_STATICALLY_ALLOCATED ) == ( uint8_t ) 0 )
+                    {
+                        vPortFree( pxTimer );
+                    }
+                    else
+                    {
+                        pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+                    }
+                }
+                #else /* if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) */
+                {
+                    /* If dynamic allocation is not enabled, the memory
+                     * could not have been dynamically allocated. So there is
+                     * no need to free the memory - just mark the timer as
+                     * "not active". */
+                    pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+                }
+                #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+                break;
 
-                /* In this case the xTimerListsWereSwitched parameter is not used, but
-                 *  it must be present in the function call.  prvSampleTimeNow() must be
-                 *  called after the message is received from xTimerQueue so there is no
-                 *  possibility of a higher priority task adding a message to the message
-                 *  queue with a time that is ahead of the timer daemon task (because it
-                 *  pre-empted the timer daemon task after the xTimeNow value was set). */
-                xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
+            default:
+                /* Don't expect to get here. */
+                break;
+        }
+    }
+/*-----------------------------------------------------------*/
 
-                switch( xMessage.xMessageID )
-                {
-                    case tmrCOMMAND_START:
-                    case tmrCOMMAND_START_FROM_ISR:
-                    case tmrCOMMAND_RESET:
-                    case tmrCOMMAND_RESET_FROM_ISR:
-                        /* Start or restart a timer. */
-                        pxTimer->ucStatus |= ( uint8_t ) tmrSTATUS_IS_ACTIVE;
-
-                        if( prvInsertTimerInActiveList( pxTimer, xMessage.u.xTimerParameters.xMessageValue + pxTimer->xTimerPeriodInTicks, xTimeNow, xMessage.u.xTimerParameters.xMessageValue ) != pdFALSE )
-                        {
-                            /* The timer expired before it was added to the active
-                             * timer list.  Process it now. */
-                            if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) != 0U )
-                            {
-                                prvReloadTimer( pxTimer, xMessage.u.xTimerParameters.xMessageValue + pxTimer->xTimerPeriodInTicks, xTimeNow );
-                            }
-                            else
-                            {
-                                pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
-                            }
+    #if ( configUSE_TIMER_SERVICE_WHEEL == 0 )
 
-                            /* Call the timer callback. */
-                            traceTIMER_EXPIRED( pxTimer );
-                            pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
-                        }
-                        else
-                        {
-                            mtCOVERAGE_TEST_MARKER();
-                        }
+        static void prvSwitchTimerLists( void )
+        {
+            TickType_t xNextExpireTime;
+            List_t * pxTemp;
+
+            /* The tick count has overflowed.  The timer lists must be switched.
+             * If there are any timers still referenced from the current timer list
+             * then they must have expired and should be processed before the lists
+             * are switched. */
+            while( listLIST_IS_EMPTY( pxCurrentTimerList ) == pdFALSE )
+            {
+                xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentTimerList );
+
+                /* Process the expired timer.  For auto-reload timers, be careful to
+                 * process only expirations that occur on the current list.  Further
+                 * expirations must wait until after the lists are switched, so
+                 * commands sent by the callback are queued until then too. */
+                /* MISRA Ref 11.5.3 [Void pointer assignment] */
+                /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+                /* coverity[misra_c_2012_rule_11_5_violation] */
+                prvProcessExpiredTimer( ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxCurrentTimerList ), xNextExpireTime, tmrMAX_TIME_BEFORE_OVERFLOW, pdFALSE );
+            }
+
+            pxTemp = pxCurrentTimerList;
+            pxCurrentTimerList = pxOverflowTimerList;
+            pxOverflowTimerList = pxTemp;
+        }
 
-                        break;
+    #else /* configUSE_TIMER_SERVICE_WHEEL */
 
-                    case tmrCOMMAND_STOP:
-                    case tmrCOMMAND_STOP_FROM_ISR:
-                        /* The timer has already been removed from the active list. */
-                        pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
-                        break;
-
-                    case tmrCOMMAND_CHANGE_PERIOD:
-                    case tmrCOMMAND_CHANGE_PERIOD_FROM_ISR:
-                        pxTimer->ucStatus |= ( uint8_t ) tmrSTATUS_IS_ACTIVE;
-                        pxTimer->xTimerPeriodInTicks = xMessage.u.xTimerParameters.xMessageValue;
-                        configASSERT( ( pxTimer->xTimerPeriodInTicks > 0 ) );
-
-                        /* The new period does not really have a reference, and can
-                         * be longer or shorter than the old one.  The command time is
-                         * therefore set to the current time, and as the period cannot
-                         * be zero the next expiry time can only be in the future,
-                         * meaning (unlike for the xTimerStart() case above) there is
-                         * no fail case that needs to be handled here. */
-                        ( void ) prvInsertTimerInActiveList( pxTimer, ( xTimeNow + pxTimer->xTimerPeriodInTicks ), xTimeNow, xTimeNow );
-                        break;
-
-                    case tmrCOMMAND_DELETE:
-                        #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+        static void prvTimerWheelInsert( Timer_t * const pxTimer )
+        {
+            TickType_t xDelta = listGET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ) ) - xTimerWheelTime;
+            UBaseType_t uxLevel = 0U;
+            UBaseType_t uxShift = 0U;
+            UBaseType_t uxSlot;
+
+            /* A timer is never placed with an expiry time of xTimerWheelTime
+             * itself, as timers that expire then are moved straight to
+             * xExpiredTimerList.  Level n holds the timers that expire in fewer
+             * than 32 slots of 32^n ticks, so a timer is placed on the lowest
+             * level that reaches its expiry time. */
+            while( ( uxLevel < ( ( UBaseType_t ) configTIMER_SERVICE_WHEEL_LEVELS - 1U ) ) &&
+                   ( ( xDelta >> uxShift ) >= ( TickType_t ) tmrWHEEL_SLOTS ) )
+            {
+                uxLevel++;
+                uxShift += tmrWHEEL_SLOT_BITS;
+            }
+
+            if( ( xDelta >> uxShift ) >= ( TickType_t ) tmrWHEEL_SLOTS )
+            {
+                /* The expiry time is beyond the reach of the wheel, so park the
+                 * timer in the furthest slot of the top level.  It is placed
+                 * again, closer to its expiry time, when that slot comes round. */
+                xDelta = ( TickType_t ) ( ( ( TickType_t ) tmrWHEEL_SLOTS << uxShift ) - ( TickType_t ) 1U );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            uxSlot = ( UBaseType_t ) ( ( TickType_t ) ( xTimerWheelTime + xDelta ) >> uxShift ) & tmrWHEEL_SLOT_MASK;
+
+            vListInsertEnd( &( xTimerWheel[ uxLevel ][ uxSlot ] ), &( pxTimer->xTimerListItem ) );
+            ulTimerWheelOccupied[ uxLevel ] |= ( uint32_t ) 1U << uxSlot;
+        }
+    /*-----------------------------------------------------------*/
+
+        static void prvTimerWheelCollectExpired( const TickType_t xSlotTime )
+        {
+            BaseType_t xCascade = pdTRUE;
+            UBaseType_t uxLevel;
+            UBaseType_t uxShift = 0U;
+            UBaseType_t uxSlot;
+            List_t * pxSlot;
+            ListItem_t * pxItem;
+
+            /* The bottom level slot for xSlotTime comes round, and when the
+             * bottom level wraps the current slot of the level above comes round
+             * too, and so on up the wheel for as long as each level wraps.  Each
+             * timer in a slot that comes round either expires now or moves down
+             * the wheel, or round the top level if it was parked beyond the
+             * reach of the wheel. */
+            for( uxLevel = 0U; ( uxLevel < ( UBaseType_t ) configTIMER_SERVICE_WHEEL_LEVELS ) && ( xCascade != pdFALSE ); uxLevel++ )
+            {
+                if( ( xSlotTime & ( ( ( TickType_t ) 1U << uxShift ) - ( TickType_t ) 1U ) ) != ( TickType_t ) 0U )
+                {
+                    xCascade = pdFALSE;
+                }
+                else
+                {
+                    uxSlot = ( UBaseType_t ) ( xSlotTime >> uxShift ) & tmrWHEEL_SLOT_MASK;
+
+                    if( ( ulTimerWheelOccupied[ uxLevel ] & ( ( uint32_t ) 1U << uxSlot ) ) != 0U )
+                    {
+                        ulTimerWheelOccupied[ uxLevel ] &= ~( ( uint32_t ) 1U << uxSlot );
+                        pxSlot = &( xTimerWheel[ uxLevel ][ uxSlot ] );
+
+                        while( listLIST_IS_EMPTY( pxSlot ) == pdFALSE )
                         {
-                            /* The timer has already been removed from the active list,
-                             * just free up the memory if the memory was dynamically
-                             * allocated. */
-                            if( ( pxTimer->ucStatus & tmrSTATUS_IS_STATICALLY_ALLOCATED ) == ( uint8_t ) 0 )
+                            pxItem = listGET_HEAD_ENTRY( pxSlot );
+                            ( void ) uxListRemove( pxItem );
+
+                            if( listGET_LIST_ITEM_VALUE( pxItem ) == xSlotTime )
                             {
-                                vPortFree( pxTimer );
+                                vListInsertEnd( &xExpiredTimerList, pxItem );
                             }
                             else
                             {
-                                pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+                                /* The timer is always placed on a lower level, or
+                                 * on a different slot of the top level, so this
+                                 * loop ends. */
+                                /* MISRA Ref 11.5.3 [Void pointer assignment] */
+                                /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+                                /* coverity[misra_c_2012_rule_11_5_violation] */
+                                prvTimerWheelInsert( ( Timer_t * ) listGET_LIST_ITEM_OWNER( pxItem ) );
                             }
                         }
-                        #else /* if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) */
-                        {
-                            /* If dynamic allocation is not enabled, the memory
-                             * could not have been dynamically allocated. So there is
-                             * no need to free the memory - just mark the timer as
-                             * "not active". */
-                            pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
-                        }
-                        #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
-                        break;
-
-                    default:
-                        /* Don't expect to get here. */
-                        break;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
                 }
-            }
-        }
-    }
-/*-----------------------------------------------------------*/
-
-    static void prvSwitchTimerLists( void )
-    {
-        TickType_t xNextExpireTime;
-        List_t * pxTemp;
 
-        /* The tick count has overflowed.  The timer lists must be switched.
-         * If there are any timers still referenced from the current timer list
-         * then they must have expired and should be processed before the lists
-         * are switched. */
-        while( listLIST_IS_EMPTY( pxCurrentTimerList ) == pdFALSE )
-        {
-            xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentTimerList );
-
-            /* Process the expired timer.  For auto-reload timers, be careful to
-             * process only expirations that occur on the current list.  Further
-             * expirations must wait until after the lists are switched. */
-            prvProcessExpiredTimer( xNextExpireTime, tmrMAX_TIME_BEFORE_OVERFLOW );
+                uxShift += tmrWHEEL_SLOT_BITS;
+            }
         }
 
-        pxTemp = pxCurrentTimerList;
-        pxCurrentTimerList = pxOverflowTimerList;
-        pxOverflowTimerList = pxTemp;
-    }
+    #endif /* configUSE_TIMER_SERVICE_WHEEL */
 /*-----------------------------------------------------------*/
 
     static void prvCheckForValidListAndQueue( void )
@@ -1117,10 +1560,32 @@
         {
             if( xTimerQueue == NULL )
             {
-                vListInitialise( &xActiveTimerList1 );
-                vListInitialise( &xActiveTimerList2 );
-                pxCurrentTimerList = &xActiveTimerList1;
-                pxOverflowTimerList = &xActiveTimerList2;
+                #if ( configUSE_TIMER_SERVICE_WHEEL == 0 )
+                {
+                    vListInitialise( &xActiveTimerList1 );
+                    vListInitialise( &xActiveTimerList2 );
+                    pxCurrentTimerList = &xActiveTimerList1;
+                    pxOverflowTimerList = &xActiveTimerList2;
+                }
+                #else /* configUSE_TIMER_SERVICE_WHEEL */
+                {
+                    UBaseType_t uxLevel;
+                    UBaseType_t uxSlot;
+
+                    for( uxLevel = 0U; uxLevel < ( UBaseType_t ) configTIMER_SERVICE_WHEEL_LEVELS; uxLevel++ )
+                    {
+                        for( uxSlot = 0U; uxSlot < tmrWHEEL_SLOTS; uxSlot++ )
+                        {
+                            vListInitialise( &( xTimerWheel[ uxLevel ][ uxSlot ] ) );
+                        }
+
+                        ulTimerWheelOccupied[ uxLevel ] = 0U;
+                    }
+
+                    vListInitialise( &xExpiredTimerList );
+                    xTimerWheelTime = xTaskGetTickCount();
+                }
+                #endif /* configUSE_TIMER_SERVICE_WHEEL */
 
                 #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
                 {
@@ -1,123 +1,1297 @@
+/*
+ * mlfq.cpp - offline scheduler simulator.
+ *
+ * Replays a recorded task trace against the scheduling policies implemented by
+ * the kernel (MLFQ, EDF, weighted round robin and plain fixed priority) and
+ * reports response time, turnaround, fairness and deadline miss metrics, so
+ * parameters such as configMLFQ_UNIT_TIME_SLICE can be chosen on a host before
+ * an image is flashed.
+ *
+ * The clock is event driven: it jumps straight to the next arrival, wake up,
+ * burst completion, time slice expiry or MLFQ boost, so the cost of a run
+ * depends on the number of scheduling events rather than on the number of
+ * ticks simulated.
+ *
+ * --sweep replays one trace, or a set of generated workloads, under every
+ * combination of the parameter values given, running the simulations on all
+ * cores and writing one CSV row per run in a fixed order, for example:
+ *
+ *   mlfq --sweep --policy mlfq --mlfq-levels 2..8 --mlfq-unit 1,2,5,10 \
+ *        --mlfq-loop 50,100,200,500,1000 --workloads 32 --out sweep.csv
+ *
+ * Build:
+ *   g++ -O2 -std=c++17 -pthread -Wall -Wextra -o mlfq mlfq.cpp
+ *
+ * Usage:
+ *   mlfq [options] [trace]          (trace "-" reads stdin)
+ *
+ * With no trace a small built-in example is replayed.  Run "mlfq --help" for
+ * the options.
+ *
+ * Trace format, one task per line, everything after '#' is ignored:
+ *
+ *   name,arrival,bursts[,deadline[,weight[,priority]]]
+ *
+ * bursts is a ':' separated list that alternates CPU time and blocked time,
+ * starting and ending with CPU time, so "4:10:2" runs for 4 ticks, blocks for
+ * 10 ticks then runs for another 2.  Each CPU burst is one job.  deadline is
+ * relative to the activation of each job, 0 meaning the job has no deadline.
+ * weight (1 to 255, default 1) is only used by the wrr policy and priority
+ * (default 0) only by the fixed policy.  All times are in ticks.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iomanip>
 #include <iostream>
-#include <vector>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <stdexcept>
 #include <string>
-#include <algorithm>
+#include <thread>
+#include <tuple>
+#include <vector>
 
 using namespace std;
 
-class Process {
-public:
+using Time = int64_t;
+
+constexpr Time never = numeric_limits<Time>::max();
+constexpr size_t no_task = numeric_limits<size_t>::max();
+
+/* Mirrors configWRR_MAX_WEIGHT and taskWRR_STRIDE_SCALE in tasks.c. */
+constexpr uint32_t wrr_max_weight = 255;
+constexpr uint64_t wrr_stride_scale = uint64_t(wrr_max_weight) * 256;
+
+struct Task {
     string name;
-    int arrival_time;
-    int duration;
-    bool started;
+    Time arrival = 0;
+    vector<Time> bursts;    /* CPU, blocked, CPU, ... */
+    Time deadline = 0;
+    uint32_t weight = 1;
+    uint32_t priority = 0;
+};
 
-    Process(string n, int arrival, int burst)
-        : name(n), arrival_time(arrival), duration(burst), started(false) {}
+/* Kernel parameters, named after the FreeRTOSConfig.h settings they model. */
+struct Params {
+    uint32_t mlfq_levels = 4;       /* Priorities in the MLFQ band. */
+    Time mlfq_unit = 1;             /* configMLFQ_UNIT_TIME_SLICE. */
+    Time mlfq_loop = 10;            /* configMLFQ_LOOP_TIME_SLICE, 0 for no boost. */
+    vector<Time> mlfq_slices;       /* As passed to vTaskSetMLFQPolicy(), overrides mlfq_unit. */
+    Time wrr_slice = 1;             /* configSLICE_INTERVAL. */
+    Time rr_slice = 1;              /* Round robin slice between equal fixed priorities. */
 };
 
-// Define time slice for each queue
-vector<int> time_slices = { 1, 2, 4, 8 };  // Time slices for each queue (higher priority gets smaller time slice)
+/* Why a task is being added to the ready queues. */
+enum class Reason {
+    activated,      /* Arrived or woke up, so a new job starts. */
+    preempted,      /* Displaced by a task that became ready. */
+    expired         /* Used up its time slice. */
+};
 
-void log_queue(const vector<vector<Process>>& queue, int current_time) {
-    cout << "[current time: " << current_time << "]\n";
-    for (size_t i = 0; i < queue.size(); ++i) {
-        cout << "Queue " << i << ": ";
-        for (const auto& p : queue[i]) {
-            cout << "[name: " << p.name << ", duration: " << p.duration << "] ";
+/*
+ * FIFO of task indices linked through a next array shared by all the queues
+ * of a policy, so a task can only be on one queue at a time and a whole queue
+ * can be appended to another in constant time.
+ */
+class IndexQueue {
+public:
+    bool empty() const { return head_ == no_task; }
+
+    void push_back(size_t id, vector<size_t>& next)
+    {
+        next[id] = no_task;
+        if (head_ == no_task) {
+            head_ = id;
+        } else {
+            next[tail_] = id;
         }
-        cout << endl;
+        tail_ = id;
     }
-    cout << endl;
-}
 
-int mlfq_schedule(vector<vector<Process>>& queue, vector<Process>& completed_processes, int current_time, int reset_interval) {
-    // Select a process from the queue to execute
-    for (size_t i = 0; i < queue.size(); ++i) {
-        if (!queue[i].empty()) {
-            Process process = queue[i].front();
-            queue[i].erase(queue[i].begin());
-            
-            // Execute the process for the time slice based on the priority (queue index)
-            int time_slice = time_slices[i];
-            int time_to_run = min(time_slice, process.duration);
+    size_t pop_front(const vector<size_t>& next)
+    {
+        size_t id = head_;
+        head_ = next[id];
+        return id;
+    }
 
-            if (process.duration <= time_to_run) {
-                // Process completed
-                current_time += process.duration;
-                process.duration = 0;
-                completed_processes.push_back(process);
+    void splice_back(IndexQueue& other, vector<size_t>& next)
+    {
+        if (!other.empty()) {
+            if (head_ == no_task) {
+                head_ = other.head_;
             } else {
-                // Process executes for the time slice, then move to the next queue
-                current_time += time_to_run;
-                process.duration -= time_to_run;
+                next[tail_] = other.head_;
+            }
+            tail_ = other.tail_;
+            other.head_ = no_task;
+        }
+    }
+
+private:
+    size_t head_ = no_task;
+    size_t tail_ = no_task;
+};
+
+class Policy {
+public:
+    virtual ~Policy() = default;
+    virtual const char* name() const = 0;
+    virtual void reset(const vector<Task>& tasks) = 0;
+
+    /* Makes a task ready. */
+    virtual void enqueue(size_t id, Time now, Reason why) = 0;
+
+    /* Removes and returns the task to run next, or no_task if none is ready. */
+    virtual size_t pick() = 0;
+
+    /* Ticks the running task may use before its slice expires, or never. */
+    virtual Time quantum_left(size_t id) const = 0;
+
+    /* Charges ran ticks to the running task.  Returns true if its slice
+     * expired, in which case the task is requeued and the scheduler picks
+     * again. */
+    virtual bool charge(size_t id, Time ran) = 0;
+
+    /* True if a task that just became ready preempts the running task. */
+    virtual bool preempts(size_t woken, size_t running) const = 0;
+
+    /* Periodic policy work such as the MLFQ boost. */
+    virtual Time next_timer() const { return never; }
+    virtual void on_timer(Time) {}
+};
+
+/*
+ * Fixed priority with round robin between tasks of equal priority, as the
+ * stock kernel does with configUSE_PREEMPTION and configUSE_TIME_SLICING set.
+ * A preempted task goes to the back of its list as the kernel moves the list
+ * index on when it switches away from a task.
+ */
+class FixedPriority : public Policy {
+public:
+    explicit FixedPriority(Time slice) : slice_(slice) {}
+
+    const char* name() const override { return "fixed"; }
+
+    void reset(const vector<Task>& tasks) override
+    {
+        uint32_t highest = 0;
+        priority_.clear();
+        for (const auto& t : tasks) {
+            priority_.push_back(t.priority);
+            highest = max(highest, t.priority);
+        }
+        ready_.assign(size_t(highest) + 1, IndexQueue());
+        next_.assign(tasks.size(), no_task);
+        used_.assign(tasks.size(), 0);
+        top_ = 0;
+    }
+
+    void enqueue(size_t id, Time, Reason why) override
+    {
+        if (why != Reason::preempted) {
+            used_[id] = 0;
+        }
+        ready_[priority_[id]].push_back(id, next_);
+        top_ = max(top_, size_t(priority_[id]));
+    }
+
+    size_t pick() override
+    {
+        for (;;) {
+            if (!ready_[top_].empty()) {
+                return ready_[top_].pop_front(next_);
+            }
+            if (top_ == 0) {
+                return no_task;
+            }
+            --top_;
+        }
+    }
+
+    Time quantum_left(size_t id) const override { return slice_ - used_[id]; }
+
+    bool charge(size_t id, Time ran) override
+    {
+        used_[id] += ran;
+        return used_[id] >= slice_;
+    }
+
+    bool preempts(size_t woken, size_t running) const override
+    {
+        return priority_[woken] > priority_[running];
+    }
+
+private:
+    Time slice_;
+    vector<uint32_t> priority_;
+    vector<IndexQueue> ready_;
+    vector<size_t> next_;
+    vector<Time> used_;
+    size_t top_ = 0;
+};
+
+/*
+ * Multi level feedback queue.  Tasks start at the top level and drop one
+ * level each time they use up the slice of their level, which is
+ * ( level + 1 ) * configMLFQ_UNIT_TIME_SLICE unless explicit slices are
+ * given.  Usage is kept across blocking, so a task cannot hold its level by
+ * yielding just before its slice expires.  Every configMLFQ_LOOP_TIME_SLICE
+ * ticks all tasks go back to the top level; as in the kernel, tasks that are
+ * not ready pick the boost up lazily through a generation count.
+ */
+class Mlfq : public Policy {
+public:
+    explicit Mlfq(const Params& p) : loop_(p.mlfq_loop)
+    {
+        if (!p.mlfq_slices.empty()) {
+            level_ticks_ = p.mlfq_slices;
+        } else {
+            for (uint32_t level = 0; level < p.mlfq_levels; ++level) {
+                level_ticks_.push_back(Time(level + 1) * p.mlfq_unit);
+            }
+        }
+    }
+
+    const char* name() const override { return "mlfq"; }
+
+    void reset(const vector<Task>& tasks) override
+    {
+        ready_.assign(level_ticks_.size(), IndexQueue());
+        next_.assign(tasks.size(), no_task);
+        level_.assign(tasks.size(), 0);
+        used_.assign(tasks.size(), 0);
+        boost_generation_.assign(tasks.size(), 0);
+        generation_ = 0;
+        next_boost_ = (loop_ > 0) ? loop_ : never;
+        top_ = 0;
+    }
+
+    void enqueue(size_t id, Time, Reason) override
+    {
+        apply_boost(id);
+        ready_[level_[id]].push_back(id, next_);
+        top_ = min(top_, size_t(level_[id]));
+    }
+
+    size_t pick() override
+    {
+        for (; top_ < ready_.size(); ++top_) {
+            if (!ready_[top_].empty()) {
+                size_t id = ready_[top_].pop_front(next_);
+                apply_boost(id);
+                return id;
+            }
+        }
+        return no_task;
+    }
+
+    Time quantum_left(size_t id) const override
+    {
+        if (boost_generation_[id] != generation_) {
+            return level_ticks_[0];
+        }
+        return level_ticks_[level_[id]] - used_[id];
+    }
+
+    bool charge(size_t id, Time ran) override
+    {
+        bool expired = false;
+
+        apply_boost(id);
+        used_[id] += ran;
+        if (used_[id] >= level_ticks_[level_[id]]) {
+            if (level_[id] + 1 < level_ticks_.size()) {
+                ++level_[id];
+            }
+            used_[id] = 0;
+            expired = true;
+        }
+        return expired;
+    }
 
-                // Move the process to the next priority queue (lower priority)
-                if (i + 1 == queue.size()) {
-                    queue[i].push_back(process);  // Stay in the current queue if it's the lowest
+    bool preempts(size_t woken, size_t running) const override
+    {
+        uint32_t running_level = (boost_generation_[running] != generation_) ? 0 : level_[running];
+        return level_[woken] < running_level;
+    }
+
+    Time next_timer() const override { return next_boost_; }
+
+    void on_timer(Time now) override
+    {
+        /* Ready tasks keep their order, highest level first, and pick up the
+         * new generation when they are next picked. */
+        ++generation_;
+        for (size_t level = 1; level < ready_.size(); ++level) {
+            ready_[0].splice_back(ready_[level], next_);
+        }
+        top_ = 0;
+        next_boost_ = now + loop_;
+    }
+
+private:
+    void apply_boost(size_t id)
+    {
+        if (boost_generation_[id] != generation_) {
+            boost_generation_[id] = generation_;
+            level_[id] = 0;
+            used_[id] = 0;
+        }
+    }
+
+    Time loop_;
+    vector<Time> level_ticks_;
+    vector<IndexQueue> ready_;
+    vector<size_t> next_;
+    vector<uint32_t> level_;
+    vector<Time> used_;
+    vector<uint64_t> boost_generation_;
+    uint64_t generation_ = 0;
+    Time next_boost_ = never;
+    size_t top_ = 0;
+};
+
+/*
+ * Earliest deadline first.  A job's absolute deadline is its activation time
+ * plus the task's relative deadline, and a job with an earlier deadline
+ * preempts on wake.  Jobs without a deadline run only when no job with a
+ * deadline is ready.  Ties go to the job that became ready first.
+ */
+class Edf : public Policy {
+public:
+    const char* name() const override { return "edf"; }
+
+    void reset(const vector<Task>& tasks) override
+    {
+        relative_.clear();
+        for (const auto& t : tasks) {
+            relative_.push_back(t.deadline);
+        }
+        absolute_.assign(tasks.size(), never);
+        ready_ = decltype(ready_)();
+        sequence_ = 0;
+    }
+
+    void enqueue(size_t id, Time now, Reason why) override
+    {
+        if (why == Reason::activated) {
+            absolute_[id] = (relative_[id] > 0) ? now + relative_[id] : never;
+        }
+        ready_.emplace(absolute_[id], sequence_++, id);
+    }
+
+    size_t pick() override
+    {
+        size_t id = no_task;
+        if (!ready_.empty()) {
+            id = get<2>(ready_.top());
+            ready_.pop();
+        }
+        return id;
+    }
+
+    Time quantum_left(size_t) const override { return never; }
+    bool charge(size_t, Time) override { return false; }
+
+    bool preempts(size_t woken, size_t running) const override
+    {
+        return absolute_[woken] < absolute_[running];
+    }
+
+private:
+    using Entry = tuple<Time, uint64_t, size_t>;
+
+    vector<Time> relative_;
+    vector<Time> absolute_;
+    priority_queue<Entry, vector<Entry>, greater<Entry>> ready_;
+    uint64_t sequence_ = 0;
+};
+
+/*
+ * Weighted round robin by virtual run time.  Each tick a task runs adds its
+ * stride, wrr_stride_scale / weight, to its virtual run time and the ready
+ * task with the lowest virtual run time runs next.  A task that becomes ready
+ * behind the virtual time starts level with it, so it gains no credit for the
+ * time it was not ready.  A task yields when its configSLICE_INTERVAL slice
+ * expires and never preempts on wake.
+ */
+class Wrr : public Policy {
+public:
+    explicit Wrr(Time slice) : slice_(slice) {}
+
+    const char* name() const override { return "wrr"; }
+
+    void reset(const vector<Task>& tasks) override
+    {
+        stride_.clear();
+        for (const auto& t : tasks) {
+            stride_.push_back(wrr_stride_scale / t.weight);
+        }
+        runtime_.assign(tasks.size(), 0);
+        used_.assign(tasks.size(), 0);
+        ready_ = decltype(ready_)();
+        virtual_time_ = 0;
+        sequence_ = 0;
+    }
+
+    void enqueue(size_t id, Time, Reason why) override
+    {
+        if (why == Reason::activated) {
+            runtime_[id] = max(runtime_[id], virtual_time_);
+        }
+        if (why != Reason::preempted) {
+            used_[id] = 0;
+        }
+        ready_.emplace(runtime_[id], sequence_++, id);
+    }
+
+    size_t pick() override
+    {
+        size_t id = no_task;
+        if (!ready_.empty()) {
+            id = get<2>(ready_.top());
+            ready_.pop();
+            virtual_time_ = max(virtual_time_, runtime_[id]);
+        }
+        return id;
+    }
+
+    Time quantum_left(size_t id) const override { return slice_ - used_[id]; }
+
+    bool charge(size_t id, Time ran) override
+    {
+        runtime_[id] += uint64_t(ran) * stride_[id];
+        used_[id] += ran;
+        return used_[id] >= slice_;
+    }
+
+    bool preempts(size_t, size_t) const override { return false; }
+
+private:
+    using Entry = tuple<uint64_t, uint64_t, size_t>;
+
+    Time slice_;
+    vector<uint64_t> stride_;
+    vector<uint64_t> runtime_;
+    vector<Time> used_;
+    priority_queue<Entry, vector<Entry>, greater<Entry>> ready_;
+    uint64_t virtual_time_ = 0;
+    uint64_t sequence_ = 0;
+};
+
+struct TaskResult {
+    Time first_run = -1;
+    Time finish = -1;
+    Time cpu = 0;
+    Time blocked = 0;
+    uint32_t jobs = 0;
+    uint32_t missed = 0;
+    Time max_lateness = 0;
+};
+
+struct Summary {
+    string policy;
+    size_t tasks = 0;
+    uint64_t jobs = 0;
+    uint64_t missed = 0;
+    Time max_lateness = 0;
+    double response_mean = 0, turnaround_mean = 0;
+    Time response_p95 = 0, response_max = 0;
+    Time turnaround_p95 = 0, turnaround_max = 0;
+    double fairness = 0;
+    uint64_t switches = 0;
+    Time makespan = 0;
+    double utilisation = 0;
+};
+
+struct RunResult {
+    vector<TaskResult> tasks;
+    vector<Time> responses;     /* One per job: activation to first dispatch. */
+    uint64_t switches = 0;
+    Time makespan = 0;
+    Time busy = 0;
+};
+
+/* Per task progress through its bursts while a trace is replayed. */
+struct TaskState {
+    size_t burst = 0;
+    Time remaining = 0;
+    Time activation = 0;
+    bool dispatched = false;
+};
+
+static RunResult simulate(const vector<Task>& tasks, Policy& policy)
+{
+    using Event = tuple<Time, uint64_t, size_t>;
+    priority_queue<Event, vector<Event>, greater<Event>> events;
+    vector<TaskState> state(tasks.size());
+    RunResult r;
+    uint64_t sequence = 0;
+    size_t done = 0;
+    size_t running = no_task;
+    size_t last = no_task;
+    Time now = 0;
+
+    policy.reset(tasks);
+    r.tasks.assign(tasks.size(), TaskResult());
+    for (size_t id = 0; id < tasks.size(); ++id) {
+        state[id].remaining = tasks[id].bursts[0];
+        events.emplace(tasks[id].arrival, sequence++, id);
+    }
+
+    while (done < tasks.size()) {
+        Time run_end = never;
+        if (running != no_task) {
+            run_end = now + min(state[running].remaining, policy.quantum_left(running));
+        }
+
+        Time t = min({ events.empty() ? never : get<0>(events.top()), policy.next_timer(), run_end });
+        if (t == never) {
+            break;
+        }
+
+        /* Bring the running task up to date. */
+        if (running != no_task) {
+            Time ran = t - now;
+            TaskState& s = state[running];
+            TaskResult& res = r.tasks[running];
+            bool expired = policy.charge(running, ran);
+
+            s.remaining -= ran;
+            res.cpu += ran;
+            r.busy += ran;
+
+            if (s.remaining == 0) {
+                const Task& task = tasks[running];
+                ++res.jobs;
+                if (task.deadline > 0 && t > s.activation + task.deadline) {
+                    ++res.missed;
+                    res.max_lateness = max(res.max_lateness, t - (s.activation + task.deadline));
+                }
+                if (s.burst + 2 < task.bursts.size()) {
+                    Time block = task.bursts[s.burst + 1];
+                    res.blocked += block;
+                    s.burst += 2;
+                    s.remaining = task.bursts[s.burst];
+                    events.emplace(t + block, sequence++, running);
                 } else {
-                    queue[i + 1].push_back(process);  // Move to the next queue
+                    res.finish = t;
+                    ++done;
                 }
+                running = no_task;
+            } else if (expired) {
+                policy.enqueue(running, t, Reason::expired);
+                running = no_task;
             }
+        }
+        now = t;
 
-            // Re-insert all processes to the highest priority queue at the specified interval
-            if (current_time % reset_interval == 0) {
-                for (size_t j = 1; j < queue.size(); ++j) {
-                    for (auto& p : queue[j]) {
-                        queue[0].push_back(p);
-                    }
-                    queue[j].clear();
+        if (policy.next_timer() <= now) {
+            policy.on_timer(now);
+        }
+
+        while (!events.empty() && get<0>(events.top()) <= now) {
+            size_t id = get<2>(events.top());
+            events.pop();
+            state[id].activation = now;
+            state[id].dispatched = false;
+            policy.enqueue(id, now, Reason::activated);
+            if (running != no_task && policy.preempts(id, running)) {
+                policy.enqueue(running, now, Reason::preempted);
+                running = no_task;
+            }
+        }
+
+        if (running == no_task) {
+            running = policy.pick();
+            if (running != no_task) {
+                TaskState& s = state[running];
+                if (r.tasks[running].first_run < 0) {
+                    r.tasks[running].first_run = now;
+                }
+                if (!s.dispatched) {
+                    s.dispatched = true;
+                    r.responses.push_back(now - s.activation);
+                }
+                if (running != last) {
+                    ++r.switches;
+                    last = running;
                 }
-                cout << "Move all processes to the highest priority queue at time " << current_time << "\n";
             }
+        }
+    }
 
-            break;
+    r.makespan = now;
+    return r;
+}
+
+static Time percentile(vector<Time> v, double p)
+{
+    Time result = 0;
+    if (!v.empty()) {
+        size_t rank = size_t(ceil(p * double(v.size()))) - 1;
+        rank = min(rank, v.size() - 1);
+        nth_element(v.begin(), v.begin() + rank, v.end());
+        result = v[rank];
+    }
+    return result;
+}
+
+static double mean(const vector<Time>& v)
+{
+    double sum = 0;
+    for (Time x : v) {
+        sum += double(x);
+    }
+    return v.empty() ? 0.0 : sum / double(v.size());
+}
+
+static Summary summarise(const vector<Task>& tasks, const char* policy, const RunResult& r)
+{
+    Summary s;
+    vector<Time> turnaround;
+    double share_sum = 0, share_sq = 0;
+    size_t shares = 0;
+
+    s.policy = policy;
+    s.tasks = tasks.size();
+    for (size_t id = 0; id < tasks.size(); ++id) {
+        const TaskResult& t = r.tasks[id];
+        s.jobs += t.jobs;
+        s.missed += t.missed;
+        s.max_lateness = max(s.max_lateness, t.max_lateness);
+        if (t.finish >= 0) {
+            Time tat = t.finish - tasks[id].arrival;
+            Time runnable = tat - t.blocked;
+            turnaround.push_back(tat);
+
+            /* Jain's index over each task's share of the time it was ready,
+             * normalised by its weight. */
+            if (runnable > 0) {
+                double share = double(t.cpu) / double(runnable) / double(tasks[id].weight);
+                share_sum += share;
+                share_sq += share * share;
+                ++shares;
+            }
         }
     }
 
-    return current_time;
+    s.response_mean = mean(r.responses);
+    s.response_p95 = percentile(r.responses, 0.95);
+    s.response_max = r.responses.empty() ? 0 : *max_element(r.responses.begin(), r.responses.end());
+    s.turnaround_mean = mean(turnaround);
+    s.turnaround_p95 = percentile(turnaround, 0.95);
+    s.turnaround_max = turnaround.empty() ? 0 : *max_element(turnaround.begin(), turnaround.end());
+    s.fairness = (shares > 0 && share_sq > 0) ? (share_sum * share_sum) / (double(shares) * share_sq) : 1.0;
+    s.switches = r.switches;
+    s.makespan = r.makespan;
+    s.utilisation = (r.makespan > 0) ? double(r.busy) / double(r.makespan) : 0.0;
+    return s;
+}
+
+static string trim(const string& s)
+{
+    size_t b = s.find_first_not_of(" \t\r");
+    size_t e = s.find_last_not_of(" \t\r");
+    return (b == string::npos) ? string() : s.substr(b, e - b + 1);
+}
+
+static vector<string> split(const string& s, char sep)
+{
+    vector<string> fields;
+    string field;
+    istringstream in(s);
+    while (getline(in, field, sep)) {
+        fields.push_back(trim(field));
+    }
+    return fields;
+}
+
+static Time to_time(const string& s, const string& what)
+{
+    size_t used = 0;
+    long long v = 0;
+    try {
+        v = stoll(s, &used);
+    } catch (const exception&) {
+        used = 0;
+    }
+    if (used != s.size() || s.empty() || v < 0) {
+        throw runtime_error("bad " + what + " '" + s + "'");
+    }
+    return Time(v);
+}
+
+static vector<Task> parse_trace(istream& in)
+{
+    vector<Task> tasks;
+    string line;
+    size_t line_number = 0;
+
+    while (getline(in, line)) {
+        ++line_number;
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty()) {
+            continue;
+        }
+
+        vector<string> f = split(line, ',');
+        if (tasks.empty() && !f.empty() && f[0] == "name") {
+            continue;   /* Header row. */
+        }
+
+        try {
+            Task t;
+            if (f.size() < 3 || f.size() > 6) {
+                throw runtime_error("expected name,arrival,bursts[,deadline[,weight[,priority]]]");
+            }
+            t.name = f[0];
+            t.arrival = to_time(f[1], "arrival");
+            for (const string& b : split(f[2], ':')) {
+                t.bursts.push_back(to_time(b, "burst"));
+            }
+            if (t.bursts.size() % 2 == 0) {
+                throw runtime_error("bursts must start and end with CPU time");
+            }
+            for (size_t i = 0; i < t.bursts.size(); i += 2) {
+                if (t.bursts[i] == 0) {
+                    throw runtime_error("CPU bursts must be at least one tick");
+                }
+            }
+            if (f.size() > 3 && !f[3].empty()) {
+                t.deadline = to_time(f[3], "deadline");
+            }
+            if (f.size() > 4 && !f[4].empty()) {
+                Time w = to_time(f[4], "weight");
+                if (w < 1 || w > Time(wrr_max_weight)) {
+                    throw runtime_error("weight must be 1 to " + to_string(wrr_max_weight));
+                }
+                t.weight = uint32_t(w);
+            }
+            if (f.size() > 5 && !f[5].empty()) {
+                Time p = to_time(f[5], "priority");
+                if (p > 1023) {
+                    throw runtime_error("priority must be 0 to 1023");
+                }
+                t.priority = uint32_t(p);
+            }
+            tasks.push_back(move(t));
+        } catch (const runtime_error& e) {
+            throw runtime_error("line " + to_string(line_number) + ": " + e.what());
+        }
+    }
+    return tasks;
 }
 
-vector<Process> run(vector<Process>& processes, int queue_num = 4, int reset_interval = 10) {
-    vector<vector<Process>> queue(queue_num);
-    int current_time = 0;
-    vector<Process> completed_processes;
+/* The process set the original MLFQ example used. */
+static const char sample_trace[] =
+    "# name,arrival,bursts,deadline,weight,priority\n"
+    "P1,0,3\n"
+    "P2,1,6\n"
+    "P3,3,2\n"
+    "P4,5,7\n"
+    "P5,7,4\n"
+    "P6,8,1\n";
+
+/* Builds a random trace of interactive and batch tasks. */
+static vector<Task> generate_tasks(size_t count, uint32_t seed)
+{
+    mt19937 rng(seed);
+    uniform_int_distribution<int> kind(0, 3);
+    uniform_int_distribution<Time> arrival(0, Time(count) * 24);    /* About 70% load. */
+    vector<Task> tasks(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        Task& t = tasks[i];
+        bool batch = (kind(rng) == 0);
+        uniform_int_distribution<Time> cpu(1, batch ? 40 : 4);
+        uniform_int_distribution<Time> block(1, 30);
+        uniform_int_distribution<int> jobs(1, batch ? 2 : 8);
+        int n = jobs(rng);
 
-    while (true) {
-        for (auto& process : processes) {
-            if (!process.started && process.arrival_time <= current_time) {
-                queue[0].push_back(process);  // Add to highest priority queue
-                process.started = true;
+        t.name = (batch ? "B" : "I") + to_string(i);
+        t.arrival = arrival(rng);
+        for (int j = 0; j < n; ++j) {
+            t.bursts.push_back(cpu(rng));
+            if (j + 1 < n) {
+                t.bursts.push_back(block(rng));
             }
         }
+        t.deadline = batch ? 0 : 20;
+        t.weight = batch ? 1 : 4;
+        t.priority = batch ? 1 : 2;
+    }
+    return tasks;
+}
+
+static void write_trace(ostream& out, const vector<Task>& tasks)
+{
+    out << "# name,arrival,bursts,deadline,weight,priority\n";
+    for (const Task& t : tasks) {
+        out << t.name << ',' << t.arrival << ',';
+        for (size_t j = 0; j < t.bursts.size(); ++j) {
+            out << (j ? ":" : "") << t.bursts[j];
+        }
+        out << ',' << t.deadline << ',' << t.weight << ',' << t.priority << '\n';
+    }
+}
 
-        log_queue(queue, current_time);
+static unique_ptr<Policy> make_policy(const string& name, const Params& p)
+{
+    unique_ptr<Policy> policy;
+    if (name == "mlfq") {
+        policy = make_unique<Mlfq>(p);
+    } else if (name == "edf") {
+        policy = make_unique<Edf>();
+    } else if (name == "wrr") {
+        policy = make_unique<Wrr>(p.wrr_slice);
+    } else if (name == "fixed") {
+        policy = make_unique<FixedPriority>(p.rr_slice);
+    } else {
+        throw runtime_error("unknown policy '" + name + "'");
+    }
+    return policy;
+}
 
-        current_time = mlfq_schedule(queue, completed_processes, current_time, reset_interval);
+/* Every value to try for each parameter.  Outside --sweep each list holds a
+ * single value. */
+struct Space {
+    vector<Time> mlfq_levels = { 4 };
+    vector<Time> mlfq_unit = { 1 };
+    vector<Time> mlfq_loop = { 10 };
+    vector<vector<Time>> mlfq_slices;
+    vector<Time> wrr_slice = { 1 };
+    vector<Time> rr_slice = { 1 };
+};
 
-        // Check if all processes have completed
-        if (all_of(processes.begin(), processes.end(), [](const Process& p) { return p.duration == 0; })) {
-            break;
+struct Config {
+    string policy;
+    Params params;
+};
+
+/* Expands the space into one configuration per combination of the parameters
+ * each policy actually uses, in a fixed order. */
+static vector<Config> expand(const vector<string>& policies, const Space& space)
+{
+    vector<Config> configs;
+
+    for (const string& name : policies) {
+        Config c;
+        c.policy = name;
+        make_policy(name, c.params);    /* Rejects unknown names. */
+
+        if (name == "mlfq") {
+            vector<vector<Time>> shapes = space.mlfq_slices;
+            if (shapes.empty()) {
+                for (Time levels : space.mlfq_levels) {
+                    for (Time unit : space.mlfq_unit) {
+                        vector<Time> slices;
+                        for (Time level = 0; level < levels; ++level) {
+                            slices.push_back((level + 1) * unit);
+                        }
+                        shapes.push_back(slices);
+                    }
+                }
+            }
+            for (const vector<Time>& slices : shapes) {
+                for (Time loop : space.mlfq_loop) {
+                    c.params.mlfq_slices = slices;
+                    c.params.mlfq_levels = uint32_t(slices.size());
+                    c.params.mlfq_loop = loop;
+                    configs.push_back(c);
+                }
+            }
+        } else if (name == "wrr") {
+            for (Time slice : space.wrr_slice) {
+                c.params.wrr_slice = slice;
+                configs.push_back(c);
+            }
+        } else if (name == "fixed") {
+            for (Time slice : space.rr_slice) {
+                c.params.rr_slice = slice;
+                configs.push_back(c);
+            }
+        } else {
+            configs.push_back(c);
         }
     }
+    return configs;
+}
 
-    return completed_processes;
+/* Parses "1,2,8" or "1..4,8" (ranges inclusive). */
+static vector<Time> parse_list(const string& s, const string& what, Time minimum)
+{
+    vector<Time> values;
+
+    for (const string& item : split(s, ',')) {
+        size_t dots = item.find("..");
+        if (dots == string::npos) {
+            values.push_back(to_time(item, what));
+        } else {
+            Time lo = to_time(item.substr(0, dots), what);
+            Time hi = to_time(item.substr(dots + 2), what);
+            if (hi < lo || hi - lo > 100000) {
+                throw runtime_error("bad " + what + " range '" + item + "'");
+            }
+            for (Time v = lo; v <= hi; ++v) {
+                values.push_back(v);
+            }
+        }
+    }
+    if (values.empty()) {
+        throw runtime_error(what + " needs a value");
+    }
+    for (Time v : values) {
+        if (v < minimum) {
+            throw runtime_error(what + " must be at least " + to_string(minimum));
+        }
+    }
+    return values;
 }
 
-int main() {
-    vector<Process> processes = {
-        Process("P1", 0, 3),
-        Process("P2", 1, 6),
-        Process("P3", 3, 2),
-        Process("P4", 5, 7),
-        Process("P5", 7, 4),
-        Process("P6", 8, 1)     
+/* Runs fn( 0 ) to fn( count - 1 ) on a pool of threads that take the next
+ * index from a shared counter, so uneven runs balance themselves.  The first
+ * exception thrown by fn is rethrown once every thread has finished. */
+static void parallel_for(size_t count, unsigned threads, const function<void(size_t)>& fn)
+{
+    atomic<size_t> next_index(0);
+    exception_ptr failure;
+    mutex failure_mutex;
+    vector<thread> pool;
+
+    auto worker = [&]() {
+        for (size_t i = next_index++; i < count; i = next_index++) {
+            try {
+                fn(i);
+            } catch (...) {
+                lock_guard<mutex> lock(failure_mutex);
+                if (!failure) {
+                    failure = current_exception();
+                }
+            }
+        }
     };
-    vector<Process> completed_processes = run(processes);
 
-    for (const auto& process : completed_processes) {
-        cout << "Process " << process.name << " completed\n";
+    threads = unsigned(min<size_t>(max(threads, 1u), max<size_t>(count, 1)));
+    for (unsigned t = 1; t < threads; ++t) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (thread& t : pool) {
+        t.join();
+    }
+    if (failure) {
+        rethrow_exception(failure);
+    }
+}
+
+static const char summary_columns[] =
+    "tasks,jobs,response_mean,response_p95,response_max,"
+    "turnaround_mean,turnaround_p95,turnaround_max,fairness,"
+    "missed,miss_ratio,max_lateness,switches,makespan,utilisation";
+
+static void write_summary_csv(ostream& out, const Summary& s)
+{
+    double miss_ratio = s.jobs ? double(s.missed) / double(s.jobs) : 0.0;
+
+    out << s.tasks << ',' << s.jobs << ','
+        << fixed << setprecision(3)
+        << s.response_mean << ',' << s.response_p95 << ',' << s.response_max << ','
+        << s.turnaround_mean << ',' << s.turnaround_p95 << ',' << s.turnaround_max << ','
+        << setprecision(4) << s.fairness << ',' << s.missed << ',' << miss_ratio << ','
+        << s.max_lateness << ',' << s.switches << ',' << s.makespan << ','
+        << s.utilisation << '\n';
+}
+
+static void print_summary(ostream& out, const vector<Summary>& rows, bool csv)
+{
+    if (csv) {
+        out << "policy," << summary_columns << '\n';
+    } else {
+        out << left << setw(7) << "policy" << right
+            << setw(8) << "jobs" << setw(10) << "resp" << setw(8) << "p95" << setw(8) << "max"
+            << setw(10) << "tat" << setw(8) << "p95" << setw(8) << "max"
+            << setw(7) << "fair" << setw(8) << "missed" << setw(7) << "late"
+            << setw(9) << "switches" << setw(10) << "makespan" << setw(7) << "util" << '\n';
+    }
+
+    for (const Summary& s : rows) {
+        if (csv) {
+            out << s.policy << ',';
+            write_summary_csv(out, s);
+        } else {
+            out << left << setw(7) << s.policy << right << fixed << setprecision(2)
+                << setw(8) << s.jobs << setw(10) << s.response_mean
+                << setw(8) << s.response_p95 << setw(8) << s.response_max
+                << setw(10) << s.turnaround_mean << setw(8) << s.turnaround_p95
+                << setw(8) << s.turnaround_max << setprecision(3) << setw(7) << s.fairness
+                << setw(8) << s.missed << setw(7) << s.max_lateness << setw(9) << s.switches
+                << setw(10) << s.makespan << setw(7) << s.utilisation << '\n';
+        }
+    }
+}
+
+static void print_tasks(ostream& out, const vector<Task>& tasks, const char* policy, const RunResult& r)
+{
+    for (size_t id = 0; id < tasks.size(); ++id) {
+        const TaskResult& t = r.tasks[id];
+        out << policy << ',' << tasks[id].name << ',' << tasks[id].arrival << ','
+            << t.first_run << ',' << t.finish << ',' << (t.finish - tasks[id].arrival) << ','
+            << t.cpu << ',' << t.jobs << ',' << t.missed << ',' << t.max_lateness << '\n';
+    }
+}
+
+struct Workload {
+    string label;
+    vector<Task> tasks;
+};
+
+/*
+ * Replays every workload under every configuration in parallel and writes one
+ * CSV row per run.  Rows are collected by run index and written once all runs
+ * are done, so the file is identical whatever the thread count.  Columns that
+ * do not apply to a row's policy are left empty.
+ */
+static void run_sweep(ostream& out, const vector<Workload>& workloads,
+                      const vector<Config>& configs, unsigned threads)
+{
+    size_t runs = workloads.size() * configs.size();
+    vector<Summary> results(runs);
+
+    parallel_for(runs, threads, [&](size_t i) {
+        const Workload& w = workloads[i / configs.size()];
+        const Config& c = configs[i % configs.size()];
+        unique_ptr<Policy> policy = make_policy(c.policy, c.params);
+        results[i] = summarise(w.tasks, policy->name(), simulate(w.tasks, *policy));
+    });
+
+    out << "workload,policy,mlfq_slices,mlfq_loop,wrr_slice,rr_slice," << summary_columns << '\n';
+    for (size_t i = 0; i < runs; ++i) {
+        const Config& c = configs[i % configs.size()];
+        out << workloads[i / configs.size()].label << ',' << c.policy << ',';
+        if (c.policy == "mlfq") {
+            for (size_t level = 0; level < c.params.mlfq_slices.size(); ++level) {
+                out << (level ? ":" : "") << c.params.mlfq_slices[level];
+            }
+            out << ',' << c.params.mlfq_loop;
+        } else {
+            out << ',';
+        }
+        out << ',';
+        if (c.policy == "wrr") {
+            out << c.params.wrr_slice;
+        }
+        out << ',';
+        if (c.policy == "fixed") {
+            out << c.params.rr_slice;
+        }
+        out << ',';
+        write_summary_csv(out, results[i]);
+    }
+}
+
+static void usage(ostream& out)
+{
+    out << "usage: mlfq [options] [trace | -]\n"
+           "  --policy LIST        comma separated from mlfq,edf,wrr,fixed (default all)\n"
+           "  --mlfq-levels N      levels in the MLFQ band (default 4)\n"
+           "  --mlfq-unit T        configMLFQ_UNIT_TIME_SLICE (default 1)\n"
+           "  --mlfq-loop T        configMLFQ_LOOP_TIME_SLICE, 0 disables the boost (default 10)\n"
+           "  --mlfq-slices A:B:.. explicit per level slices, as vTaskSetMLFQPolicy()\n"
+           "  --wrr-slice T        configSLICE_INTERVAL for wrr (default 1)\n"
+           "  --rr-slice T         round robin slice for fixed (default 1)\n"
+           "  --csv                print the summary as CSV\n"
+           "  --per-task           also print policy,task,arrival,first_run,finish,turnaround,cpu,jobs,missed,max_lateness\n"
+           "  --out FILE           write results to FILE instead of stdout\n"
+           "  --generate N         write a random trace of N tasks to stdout and exit\n"
+           "  --seed S             seed for --generate and the first --workloads trace (default 1)\n"
+           "\n"
+           "sweep mode:\n"
+           "  --sweep              run every combination of the parameter values given and\n"
+           "                       write one CSV row per workload and combination; parameter\n"
+           "                       options then take lists such as 1,2,4 or 1..8, and\n"
+           "                       --mlfq-slices takes comma separated slice sets\n"
+           "  --workloads N        replay N generated traces, seeds S to S + N - 1\n"
+           "  --tasks N            tasks in each generated trace (default 1000)\n"
+           "  --threads N          worker threads (default: one per core)\n";
+}
+
+int main(int argc, char** argv)
+{
+    Space space;
+    vector<string> policies = { "mlfq", "edf", "wrr", "fixed" };
+    string trace_path;
+    string out_path;
+    bool csv = false;
+    bool per_task = false;
+    bool sweep = false;
+    size_t generate = 0;
+    size_t workload_count = 0;
+    size_t workload_tasks = 1000;
+    uint32_t seed = 1;
+    unsigned threads = max(thread::hardware_concurrency(), 1u);
+    int status = 0;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            string arg = argv[i];
+            auto value = [&]() -> string {
+                if (i + 1 >= argc) {
+                    throw runtime_error(arg + " needs a value");
+                }
+                return argv[++i];
+            };
+            auto positive = [&](const string& what) -> Time {
+                Time v = to_time(value(), what);
+                if (v == 0) {
+                    throw runtime_error(what + " must be at least 1");
+                }
+                return v;
+            };
+
+            if (arg == "--help" || arg == "-h") {
+                usage(cout);
+                return 0;
+            } else if (arg == "--policy") {
+                policies = split(value(), ',');
+            } else if (arg == "--mlfq-levels") {
+                space.mlfq_levels = parse_list(value(), arg, 1);
+            } else if (arg == "--mlfq-unit") {
+                space.mlfq_unit = parse_list(value(), arg, 1);
+            } else if (arg == "--mlfq-loop") {
+                space.mlfq_loop = parse_list(value(), arg, 0);
+            } else if (arg == "--mlfq-slices") {
+                space.mlfq_slices.clear();
+                for (const string& set : split(value(), ',')) {
+                    vector<Time> slices;
+                    for (const string& s : split(set, ':')) {
+                        Time slice = to_time(s, arg);
+                        if (slice == 0) {
+                            throw runtime_error(arg + " must be at least 1");
+                        }
+                        slices.push_back(slice);
+                    }
+                    space.mlfq_slices.push_back(slices);
+                }
+            } else if (arg == "--wrr-slice") {
+                space.wrr_slice = parse_list(value(), arg, 1);
+            } else if (arg == "--rr-slice") {
+                space.rr_slice = parse_list(value(), arg, 1);
+            } else if (arg == "--csv") {
+                csv = true;
+            } else if (arg == "--per-task") {
+                per_task = true;
+            } else if (arg == "--out") {
+                out_path = value();
+            } else if (arg == "--generate") {
+                generate = size_t(positive("--generate"));
+            } else if (arg == "--seed") {
+                seed = uint32_t(to_time(value(), "--seed"));
+            } else if (arg == "--sweep") {
+                sweep = true;
+            } else if (arg == "--workloads") {
+                workload_count = size_t(positive("--workloads"));
+            } else if (arg == "--tasks") {
+                workload_tasks = size_t(positive("--tasks"));
+            } else if (arg == "--threads") {
+                threads = unsigned(positive("--threads"));
+            } else if (arg.size() > 1 && arg[0] == '-' && arg != "-") {
+                throw runtime_error("unknown option " + arg);
+            } else {
+                trace_path = arg;
+            }
+        }
+
+        if (generate > 0) {
+            write_trace(cout, generate_tasks(generate, seed));
+            return 0;
+        }
+
+        vector<Config> configs = expand(policies, space);
+        if (!sweep && configs.size() != policies.size()) {
+            throw runtime_error("give --sweep to try more than one value of a parameter");
+        }
+
+        vector<Workload> workloads;
+        if (workload_count > 0) {
+            if (!sweep || !trace_path.empty()) {
+                throw runtime_error("--workloads needs --sweep and no trace");
+            }
+            workloads.resize(workload_count);
+            parallel_for(workload_count, threads, [&](size_t i) {
+                workloads[i].label = to_string(seed + i);
+                workloads[i].tasks = generate_tasks(workload_tasks, uint32_t(seed + i));
+            });
+        } else {
+            Workload w;
+            w.label = trace_path.empty() ? "sample" : trace_path;
+            if (trace_path.empty()) {
+                istringstream in(sample_trace);
+                w.tasks = parse_trace(in);
+            } else if (trace_path == "-") {
+                w.tasks = parse_trace(cin);
+            } else {
+                ifstream in(trace_path);
+                if (!in) {
+                    throw runtime_error("cannot open " + trace_path);
+                }
+                w.tasks = parse_trace(in);
+            }
+            if (w.tasks.empty()) {
+                throw runtime_error("the trace holds no tasks");
+            }
+            workloads.push_back(move(w));
+        }
+
+        ofstream file;
+        if (!out_path.empty()) {
+            file.open(out_path);
+            if (!file) {
+                throw runtime_error("cannot create " + out_path);
+            }
+        }
+        ostream& out = out_path.empty() ? cout : file;
+
+        if (sweep) {
+            run_sweep(out, workloads, configs, threads);
+        } else {
+            const vector<Task>& tasks = workloads[0].tasks;
+            vector<Summary> rows;
+            ostringstream detail;
+            for (const Config& c : configs) {
+                unique_ptr<Policy> policy = make_policy(c.policy, c.params);
+                RunResult r = simulate(tasks, *policy);
+                rows.push_back(summarise(tasks, policy->name(), r));
+                if (per_task) {
+                    print_tasks(detail, tasks, policy->name(), r);
+                }
+            }
+
+            print_summary(out, rows, csv);
+            if (per_task) {
+                out << "\npolicy,task,arrival,first_run,finish,turnaround,cpu,jobs,missed,max_lateness\n"
+                    << detail.str();
+            }
+        }
+
+        if (!out_path.empty() && !file.flush()) {
+            throw runtime_error("cannot write " + out_path);
+        }
+    } catch (const exception& e) {
+        cerr << "mlfq: " << e.what() << '\n';
+        status = 1;
     }
 
-    return 0;
+    return status;
 }